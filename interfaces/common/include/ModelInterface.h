@@ -519,6 +519,16 @@ public:
     template <typename ElementType>
     void UnregisterCallbacks();
 
+    // Computes the map directly from the caller's input buffer into the caller's output buffer, without copying.
+    // Only for maps whose input and output are of type ElementType (that is, maps without source or sink nodes).
+    template <typename ElementType>
+    void ComputeInto(const ElementType* inputBuffer, size_t inputLength, ElementType* outputBuffer, size_t outputLength);
+
+    // Computes the map's SparseLinearPredictorNode directly from the nonzero entries of a sparse input, without
+    // densifying it. Only for maps that contain a SparseLinearPredictorNode, and whose output is of the requested type.
+    double ComputeSparseDouble(const AutoDataVector& inputData);
+    float ComputeSparseFloat(const AutoDataVector& inputData);
+
 #ifndef SWIG
     CompiledMap() = default;
     CompiledMap(ell::model::IRCompiledMap map, ell::api::math::TensorShape inputShape, ell::api::math::TensorShape outputShape);
@@ -534,6 +544,9 @@ private:
     template <typename ElementType>
     ell::api::CallbackForwarder<ElementType, ElementType>& GetCallbackForwarder();
 
+    template <typename ElementType>
+    ElementType ComputeSparse(const AutoDataVector& inputData);
+
     std::shared_ptr<ell::model::IRCompiledMap> _map;
     ell::api::math::TensorShape _inputShape;
     ell::api::math::TensorShape _outputShape;
@@ -548,6 +561,7 @@ struct MapCompilerOptions
 {
     bool useBlas = true;
     bool profile = false;
+    bool fastMathFunctions = false; // use polynomial approximations of exp, log, tanh and sigmoid
 };
 
 //
@@ -137,6 +137,54 @@ import numpy as np
 }
 %enddef
 
+// Typemaps for passing contiguous buffers (e.g., numpy arrays of any shape) straight through to CompiledMap::ComputeInto
+%define TYPEMAP_MAP_BUFFERS(BUFFER_TYPE)
+%typemap(in) (const BUFFER_TYPE* inputBuffer, size_t inputLength)
+             (Py_buffer view_ = {})
+{
+    static const char* data_type = "BUFFER_TYPE";
+    int res = PyObject_GetBuffer($input, &view_, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT);
+    if (res < 0)
+    {
+        PyErr_Clear();
+        SWIG_exception_fail(res, "Cannot get a contiguous buffer to read from");
+    }
+    if (view_.format == nullptr || view_.format[0] != data_type[0])
+    {
+        PyBuffer_Release(&view_);
+        SWIG_exception_fail(SWIG_TypeError, "Expected an array of BUFFER_TYPE");
+    }
+    $1 = ($1_ltype) view_.buf;
+    $2 = ($2_ltype) (view_.len / view_.itemsize);
+}
+%typemap(freearg) (const BUFFER_TYPE* inputBuffer, size_t inputLength)
+{
+    PyBuffer_Release(&view_$argnum);
+}
+%typemap(in) (BUFFER_TYPE* outputBuffer, size_t outputLength)
+             (Py_buffer view_ = {})
+{
+    static const char* data_type = "BUFFER_TYPE";
+    int res = PyObject_GetBuffer($input, &view_, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE | PyBUF_FORMAT);
+    if (res < 0)
+    {
+        PyErr_Clear();
+        SWIG_exception_fail(res, "Cannot get a contiguous buffer to write to");
+    }
+    if (view_.format == nullptr || view_.format[0] != data_type[0])
+    {
+        PyBuffer_Release(&view_);
+        SWIG_exception_fail(SWIG_TypeError, "Expected an array of BUFFER_TYPE");
+    }
+    $1 = ($1_ltype) view_.buf;
+    $2 = ($2_ltype) (view_.len / view_.itemsize);
+}
+%typemap(freearg) (BUFFER_TYPE* outputBuffer, size_t outputLength)
+{
+    PyBuffer_Release(&view_$argnum);
+}
+%enddef
+
 %{
 
 template<typename VectorType>
@@ -257,5 +305,8 @@ def copy_from(self, a):
 
 // Intentionally undefined because numpy is python-specific
 
+%define TYPEMAP_MAP_BUFFERS(BUFFER_TYPE)
+%enddef
+
 #endif
 
@@ -20,6 +20,10 @@ WRAP_CALLABLE_AS_MAP_OUTPUT_CALLBACK(FloatCallbackBase, float)
 WRAP_CALLABLES_AS_COMPILED_MAP_CALLBACKS(DoubleCallbackBase, DoubleCallbackBase, double)
 WRAP_CALLABLES_AS_COMPILED_MAP_CALLBACKS(FloatCallbackBase, FloatCallbackBase, float)
 
+// Buffer arguments for zero-copy compute
+TYPEMAP_MAP_BUFFERS(double)
+TYPEMAP_MAP_BUFFERS(float)
+
 %include "ModelInterface.h"
 %include "macros.i"
 
@@ -30,6 +34,8 @@ WRAP_CALLABLES_AS_COMPILED_MAP_CALLBACKS(FloatCallbackBase, FloatCallbackBase, f
 %template(UnregisterCallbacksFloat) ELL_API::CompiledMap::UnregisterCallbacks<float>;
 %template(StepDouble) ELL_API::CompiledMap::Step<double>;
 %template(StepFloat) ELL_API::CompiledMap::Step<float>;
+%template(ComputeIntoDouble) ELL_API::CompiledMap::ComputeInto<double>;
+%template(ComputeIntoFloat) ELL_API::CompiledMap::ComputeInto<float>;
 
 %template(SetSinkCallbackDouble) ELL_API::Map::SetSinkCallback<double>;
 %template(SetSinkCallbackFloat) ELL_API::Map::SetSinkCallback<float>;
@@ -123,6 +123,31 @@ def CompiledMap_Compute(self, inputData: 'Vector', dtype: 'numpy.dtype') -> "std
 
 CompiledMap.Compute = CompiledMap_Compute
 
+# Zero-copy compute for maps without source or sink nodes: reads straight from inputData and
+# writes straight into outputData, which must be C-contiguous numpy arrays (of any shape) of the same dtype
+def CompiledMap_ComputeInto(self, inputData: 'numpy.ndarray', outputData: 'numpy.ndarray') -> None:
+    """
+    CompiledMap_ComputeInto(CompiledMap self, numpy.ndarray inputData, numpy.ndarray outputData)
+
+    Parameters
+    ----------
+    inputData: numpy.ndarray of numpy.float or numpy.float32, with the map's input size
+    outputData: numpy.ndarray of the same dtype, with the map's output size, to write the result into
+
+    """
+
+    if inputData.dtype != outputData.dtype:
+        raise TypeError("Input and output arrays must have the same dtype")
+
+    if inputData.dtype == np.float:
+        self.ComputeIntoDouble(inputData, outputData)
+    elif inputData.dtype == np.float32:
+        self.ComputeIntoFloat(inputData, outputData)
+    else:
+        raise TypeError("Invalid type, expected numpy.float or numpy.float32")
+
+CompiledMap.ComputeInto = CompiledMap_ComputeInto
+
 # Map.Compute, parameterized on numpy.dtype
 def Map_Compute(self, inputData: 'Vector<ElementType>', dtype: 'numpy.dtype') -> "std::vector< ElementType,std::allocator< ElementType > >":
     """
@@ -209,6 +234,7 @@ def Map_Compile(self, targetDevice: 'std::string const &', moduleName: 'std::str
 Map.Compile = Map_Compile
 
 del CompiledMap_Compute
+del CompiledMap_ComputeInto
 del Map_Compile
 del Map_Compute
 
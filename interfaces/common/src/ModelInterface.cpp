@@ -23,6 +23,7 @@
 // math
 #include "FilterBank.h"
 #include "DenseDataVector.h"
+#include "SparseDataVector.h"
 
 // model
 #include "InputNode.h"
@@ -48,6 +49,7 @@
 
 // stl
 #include <algorithm>
+#include <limits>
 
 //
 // Callback functions
@@ -1524,6 +1526,7 @@ CompiledMap Map::Compile(const std::string& targetDevice,
     settings.sinkFunctionName = sinkFunctionName;
     settings.compilerSettings.targetDevice.deviceName = targetDevice;
     settings.compilerSettings.useBlas = compilerSettings.useBlas;
+    settings.compilerSettings.mathFunctionAccuracy = compilerSettings.fastMathFunctions ? ell::emitters::MathFunctionAccuracy::fast : ell::emitters::MathFunctionAccuracy::precise;
     settings.optimizerSettings.fuseLinearFunctionNodes = optimizerSettings.fuseLinearFunctionNodes;
 
     ell::model::IRMapCompiler compiler(settings);
@@ -1586,6 +1589,44 @@ void CompiledMap::WriteSwigInterface(const std::string& filePath)
     }
 }
 
+double CompiledMap::ComputeSparseDouble(const AutoDataVector& inputData)
+{
+    return ComputeSparse<double>(inputData);
+}
+
+float CompiledMap::ComputeSparseFloat(const AutoDataVector& inputData)
+{
+    return ComputeSparse<float>(inputData);
+}
+
+template <typename ElementType>
+ElementType CompiledMap::ComputeSparse(const AutoDataVector& inputData)
+{
+    const ell::data::AutoDataVector& data = *(inputData._impl->_vector);
+    auto sparseData = data.CopyAs<ell::data::SparseDoubleDataVector>();
+    std::vector<int> indices;
+    std::vector<ElementType> values;
+    bool isBinary = true;
+    for (auto iterator = sparseData.GetIterator<ell::data::IterationPolicy::skipZeros>(); iterator.IsValid(); iterator.Next())
+    {
+        auto entry = iterator.Get();
+        if (entry.index > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            throw std::out_of_range("sparse input index " + std::to_string(entry.index) + " is too large for the compiled map");
+        }
+        indices.push_back(static_cast<int>(entry.index));
+        values.push_back(static_cast<ElementType>(entry.value));
+        isBinary = isBinary && entry.value == 1.0;
+    }
+
+    auto count = static_cast<int>(indices.size());
+    if (isBinary)
+    {
+        return _map->ComputeSparseBinary<ElementType>(indices.data(), count);
+    }
+    return _map->ComputeSparse<ElementType>(indices.data(), values.data(), count);
+}
+
 // Specializations with type-specific static forwarder instances
 template <>
 ell::api::CallbackForwarder<double, double>& CompiledMap::GetCallbackForwarder()
@@ -90,6 +90,17 @@ void CompiledMap::UnregisterCallbacks()
     GetCallbackForwarder<ElementType>().Clear();
 }
 
+template <typename ElementType>
+void CompiledMap::ComputeInto(const ElementType* inputBuffer, size_t inputLength, ElementType* outputBuffer, size_t outputLength)
+{
+    if (inputLength != _map->GetInputSize() || outputLength != _map->GetOutputSize())
+    {
+        throw std::invalid_argument("Buffer sizes don't match the map's input and output sizes");
+    }
+    _map->SetContext(this);
+    _map->ComputeInto(inputBuffer, outputBuffer);
+}
+
 template <typename ElementType>
 bool CompiledMap::InvokeSourceCallback(ElementType* input)
 {
@@ -9,11 +9,20 @@ def test():
     compiledMap = map.Compile("host", "protonn", "predict", dtype=np.float)
     compiledMap.WriteBitcode("protonnTestData.bc");
 
-    if os.path.isfile("protonnTestData.bc"):
-        return 0
+    if not os.path.isfile("protonnTestData.bc"):
+        print("### compiled_model_test failed to generate bitcode: protonnTestData.bc")
+        return 1
 
-    print("### compiled_model_test failed to generate bitcode: protonnTestData.bc")
-    return 1
+    # Zero-copy compute writes straight into the output array
+    inputData = np.arange(map.GetInputShape().Size(), dtype=np.float)
+    outputData = np.zeros(map.GetOutputShape().Size(), dtype=np.float)
+    compiledMap.ComputeInto(inputData, outputData)
+    expected = np.asarray(map.Compute(inputData, dtype=np.float))
+    if not np.allclose(outputData, expected):
+        print("### compiled_model_test ComputeInto output doesn't match the reference map")
+        return 1
+
+    return 0
 
 
 if __name__ == '__main__':
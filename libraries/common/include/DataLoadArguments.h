@@ -30,7 +30,7 @@ namespace common
 
         // not exposed on the command line
         size_t parsedDataDimension = 0;
-
+        bool isBinaryDataset = false; // detected from the header of the input data file
     };
 
     /// <summary> A version of DataLoadArguments that adds its members to the command line parser. </summary>
@@ -19,8 +19,10 @@
 
 
 // stl
+#include <cstddef>
 #include <string>
 #include <istream>
+#include <vector>
 
 namespace ell
 {
@@ -58,6 +60,14 @@ namespace common
     /// <returns> The dataset. </returns>
     data::AutoSupervisedDataset GetDataset(std::istream& stream);
 
+    /// <summary> Gets an AutoSupervisedDataset dataset from data load arguments. Binary dataset files are loaded
+    /// directly, and other files are parsed as text. </summary>
+    ///
+    /// <param name="dataLoadArguments"> The data load arguments. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(const DataLoadArguments& dataLoadArguments);
+
     /// <summary> Gets a dataset from data load arguments. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
@@ -78,6 +88,60 @@ namespace common
     template <typename ExampleType, typename MapType>
     auto TransformDataset(data::Dataset<ExampleType>& input, const MapType& map);
 
+    /// <summary>
+    /// Gets a new dataset by running an existing dataset through a map, in batches on several threads. Each thread runs its own
+    /// copy of the map. Maps whose input isn't float or double are run one example at a time on the calling thread.
+    /// </summary>
+    ///
+    /// <typeparam name="ExampleType"> Example type. </typeparam>
+    /// <param name="input"> Input dataset. </param>
+    /// <param name="map"> Map to run input dataset on. </param>
+    /// <param name="numThreads"> The number of threads that run the map. If zero, uses the number of hardware threads. </param>
+    /// <param name="batchSize"> The number of examples in each batch. </param>
+    ///
+    /// <returns> The transformed dataset. </returns>
+    template <typename ExampleType>
+    auto TransformDataset(data::Dataset<ExampleType>& input, const model::Map& map, size_t numThreads = 0, size_t batchSize = 256);
+
+    /// <summary> A batch of examples, stored as a dense row-major matrix of values and a list of metadata. </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the values. </typeparam>
+    /// <typeparam name="MetadataType"> The type of the example metadata. </typeparam>
+    template <typename ValueType, typename MetadataType>
+    struct DenseExampleBatch
+    {
+        /// <summary> Returns the number of examples in the batch. </summary>
+        size_t NumRows() const { return metadata.size(); }
+
+        /// <summary> Returns a pointer to the values of an example. </summary>
+        const ValueType* GetRow(size_t rowIndex) const { return values.data() + rowIndex * rowSize; }
+
+        /// <summary> Returns a pointer to the values of an example. </summary>
+        ValueType* GetRow(size_t rowIndex) { return values.data() + rowIndex * rowSize; }
+
+        size_t rowSize = 0;
+        std::vector<ValueType> values;
+        std::vector<MetadataType> metadata;
+    };
+
+    /// <summary>
+    /// Runs the examples of an example iterator through a map, in batches. A reader thread packs the examples into dense
+    /// batches of the map's input type, a set of worker threads each run their own copy of the map on them, and the output
+    /// batches are passed to a write function on the calling thread, in the order the examples were read.
+    /// </summary>
+    ///
+    /// <typeparam name="OutputValueType"> The value type of the output batches, float or double. </typeparam>
+    /// <param name="exampleIterator"> The example iterator. Only the reader thread touches it. </param>
+    /// <param name="map"> The map to run the examples through. Its input type must be float or double. </param>
+    /// <param name="writeFunction"> Function that consumes the output batches. The type signature should be of the form
+    /// `void writeFunction(const DenseExampleBatch<OutputValueType, MetadataType>& batch)`. </param>
+    /// <param name="numThreads"> The number of threads that run the map. If zero, uses the number of hardware threads. </param>
+    /// <param name="batchSize"> The number of examples in each batch. </param>
+    ///
+    /// <returns> The number of examples transformed. </returns>
+    template <typename OutputValueType, typename ExampleIteratorType, typename WriteFunctionType>
+    size_t TransformExamples(ExampleIteratorType& exampleIterator, const model::Map& map, WriteFunctionType&& writeFunction, size_t numThreads = 0, size_t batchSize = 256);
+
     /// <summary>
     /// The map is first compiled, then a new dataset is returned 
     /// by running an existing dataset through the compiled map.
@@ -88,10 +152,12 @@ namespace common
     /// <param name="input"> Input dataset. </param>
     /// <param name="map"> Map to run input dataset on. </param>
     /// <param name="useBlas"> Use BLAS in the emitted code to speed up linear algerbra operations. </param>
+    /// <param name="numThreads"> The number of threads that run the map, each with its own compiled copy. If zero, uses the number of hardware threads. </param>
+    /// <param name="batchSize"> The number of examples in each batch. </param>
     ///
     /// <returns> The transformed dataset. </returns>
     template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true);
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas = true, size_t numThreads = 1, size_t batchSize = 256);
 }
 }
 
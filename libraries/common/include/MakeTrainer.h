@@ -14,10 +14,12 @@
 
 // predictors
 #include "LinearPredictor.h"
+#include "MultiClassLinearPredictor.h"
 #include "ProtoNNPredictor.h"
 
 // trainers
 #include "ITrainer.h"
+#include "MultiClassSGDTrainer.h"
 #include "SGDTrainer.h"
 #include "SDCATrainer.h"
 
@@ -53,6 +55,14 @@ namespace common
     /// <returns> A unique_ptr to a stochastic gradient descent trainer. </returns>
     std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeSparseDataCenteredSGDTrainer(const LossFunctionArguments& lossFunctionArguments, math::RowVector<double> center, const trainers::SGDTrainerParameters& trainerParameters);
 
+    /// <summary> Makes a one-versus-rest multiclass stochastic gradient descent trainer. </summary>
+    ///
+    /// <param name="lossFunctionArguments"> loss arguments. </param>
+    /// <param name="trainerParameters"> trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a multiclass stochastic gradient descent trainer. </returns>
+    std::unique_ptr<trainers::ITrainer<predictors::MultiClassLinearPredictor<double>>> MakeMultiClassSGDTrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::SGDTrainerParameters& trainerParameters);
+
     /// <summary> Makes a stochastic dual coordinate ascent trainer. </summary>
     ///
     /// <param name="lossFunctionArguments"> loss arguments. </param>
@@ -30,6 +30,7 @@ namespace common
     struct MapCompilerArguments
     {
         using PreferredConvolutionMethod = model::PreferredConvolutionMethod;
+        using MathFunctionAccuracy = emitters::MathFunctionAccuracy;
 
         std::string compiledFunctionName; // defaults to output filename
         std::string compiledModuleName;
@@ -44,8 +45,11 @@ namespace common
         bool parallelize = true;
         bool useThreadPool = true;
         int maxThreads = 4;
+        int compileThreads = 1;
+        bool tieredCompilation = false;
         bool debug = false;
         PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::none; // known methods: none, unrolled, simple, diagonal, winograd
+        MathFunctionAccuracy mathFunctionAccuracy = MathFunctionAccuracy::precise; // known values: precise, fast
 
         // target machine options
         std::string target = ""; // known target names: host, mac, linux, windows, pi0, pi3, pi3_64, aarch64, ios
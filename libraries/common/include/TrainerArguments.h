@@ -42,6 +42,9 @@ namespace common
         /// <summary> Number of epochs. </summary>
         size_t numEpochs;
 
+        /// <summary> Number of threads to train with (0 means one per hardware thread). </summary>
+        size_t numThreads;
+
         /// <summary> Generate verbose output. </summary>
         bool verbose;
     };
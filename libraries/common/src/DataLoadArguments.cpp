@@ -9,6 +9,9 @@
 #include "DataLoadArguments.h"
 #include "DataLoaders.h"
 
+// data
+#include "MappedDataset.h"
+
 // utilities
 #include "Files.h"
 #include "CStringParser.h"
@@ -47,6 +50,7 @@ namespace common
         if (inputDataFilename != "")
         {
             isFileReadable = utilities::IsFileReadable(inputDataFilename);
+            isBinaryDataset = isFileReadable && data::IsBinaryDatasetFile(inputDataFilename);
         }
 
         // dataDimension
@@ -59,6 +63,13 @@ namespace common
                 return parseErrorMessages;
             }
 
+            // binary datasets record their dimension in the header
+            if (isBinaryDataset)
+            {
+                parsedDataDimension = data::MappedDataset(inputDataFilename).NumFeatures();
+                return parseErrorMessages;
+            }
+
             auto stream = utilities::OpenIfstream(inputDataFilename);
             auto exampleIterator = GetAutoSupervisedExampleIterator(stream);
             while (exampleIterator.IsValid())
@@ -9,10 +9,12 @@
 #include "DataLoaders.h"
 
 // utilities
+#include "Exception.h"
 #include "Files.h"
 
 // data
 #include "Dataset.h"
+#include "MappedDataset.h"
 #include "SequentialLineIterator.h"
 
 #include "SingleLineParsingExampleIterator.h"
@@ -21,6 +23,8 @@
 #include "GeneralizedSparseParsingIterator.h"
 
 // stl
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 
@@ -28,6 +32,62 @@ namespace ell
 {
 namespace common
 {
+    namespace detail
+    {
+        namespace
+        {
+            // the input row of the compiled map running on each thread; the callbacks can't be passed a context, so this
+            // is thread-local to let several compiled maps run at once
+            thread_local const double* g_doubleInputRow = nullptr;
+            thread_local const float* g_floatInputRow = nullptr;
+            thread_local size_t g_inputRowSize = 0;
+        }
+    }
+
+    // C functions called by compiled maps
+    extern "C"
+    {
+    bool InputCallback_Double(double* input)
+    {
+        std::copy(detail::g_doubleInputRow, detail::g_doubleInputRow + detail::g_inputRowSize, input);
+        return true;
+    }
+
+    bool InputCallback_Float(float* input)
+    {
+        std::copy(detail::g_floatInputRow, detail::g_floatInputRow + detail::g_inputRowSize, input);
+        return true;
+    }
+    }
+
+    namespace detail
+    {
+        ptrdiff_t GetInputCallbackAddress(model::Port::PortType inputType)
+        {
+            switch (inputType)
+            {
+            case model::Port::PortType::smallReal:
+                return reinterpret_cast<ptrdiff_t>(&InputCallback_Float);
+            case model::Port::PortType::real:
+                return reinterpret_cast<ptrdiff_t>(&InputCallback_Double);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected source input type for model. Should be double or float.");
+            }
+        }
+
+        void SetCallbackInputRow(const double* row, size_t size)
+        {
+            g_doubleInputRow = row;
+            g_inputRowSize = size;
+        }
+
+        void SetCallbackInputRow(const float* row, size_t size)
+        {
+            g_floatInputRow = row;
+            g_inputRowSize = size;
+        }
+    }
+
 
     data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream)
     {
@@ -44,6 +104,17 @@ namespace common
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
     }
 
+    data::AutoSupervisedDataset GetDataset(const DataLoadArguments& dataLoadArguments)
+    {
+        if (dataLoadArguments.isBinaryDataset)
+        {
+            return data::LoadBinaryDataset(dataLoadArguments.inputDataFilename);
+        }
+
+        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
+        return GetDataset(stream);
+    }
+
     data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream)
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
@@ -27,6 +27,13 @@ namespace common
             "aze",
             "Add an evaluation using the constant zero predictor",
             true);
+
+        parser.AddOption(
+            numThreads,
+            "evaluationThreads",
+            "et",
+            "The number of threads used for evaluation (0 = one per hardware thread)",
+            1);
     }
 }
 }
@@ -55,6 +55,18 @@ namespace common
                          "st",
                          "Use the sorting trainer instead of the histogram trainer",
                          false);
+
+        parser.AddOption(binnedTrainer,
+                         "binnedTrainer",
+                         "bt",
+                         "Use the binned histogram trainer, which quantizes each feature before training, instead of the histogram trainer",
+                         false);
+
+        parser.AddOption(maxBinsPerFeature,
+                         "maxBinsPerFeature",
+                         "mbpf",
+                         "The maximum number of bins each feature is quantized into by the binned histogram trainer (at most 65536)",
+                         255);
     }
 }
 }
@@ -28,6 +28,7 @@
 #include "CompiledActivationFunctions.h"
 #include "DelayNode.h"
 #include "DotProductNode.h"
+#include "DTWBankNode.h"
 #include "DTWDistanceNode.h"
 #include "ExtremalValueNode.h"
 #include "FFTNode.h"
@@ -41,14 +42,18 @@
 #include "MatrixVectorProductNode.h"
 #include "MovingAverageNode.h"
 #include "MovingVarianceNode.h"
+#include "MultiClassLinearPredictorNode.h"
 #include "MultiplexerNode.h"
 #include "NeuralNetworkPredictorNode.h"
+#include "ProtoNNKernelNode.h"
 #include "ProtoNNPredictorNode.h"
 #include "ReceptiveFieldMatrixNode.h"
+#include "RegionDetectionPostProcessingNode.h"
 #include "ReorderDataNode.h"
 #include "SimpleConvolutionNode.h"
 #include "SinkNode.h"
 #include "SourceNode.h"
+#include "SparseLinearPredictorNode.h"
 #include "UnaryOperationNode.h"
 #include "UnrolledConvolutionNode.h"
 #include "WinogradConvolutionNode.h"
@@ -156,6 +161,9 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::DotProductNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::DotProductNode<double>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::DTWBankNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::DTWBankNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::DTWDistanceNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::DTWDistanceNode<double>>();
 
@@ -197,17 +205,27 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<double>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::MultiClassLinearPredictorNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::MultiClassLinearPredictorNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<double>>();
 
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<double>>();
 
-        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode>();
+        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode<double>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNPredictorNode<double>>("ProtoNNPredictorNode"); // models saved before the node was templated
+        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNKernelNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::ProtoNNKernelNode<double>>();
 
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<double>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::RegionDetectionPostProcessingNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::RegionDetectionPostProcessingNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<double>>();
 
@@ -224,6 +242,9 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::SourceNode<float>>();
         context.GetTypeFactory().AddType<model::Node, nodes::SourceNode<double>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::SparseLinearPredictorNode<float>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::SparseLinearPredictorNode<double>>();
+
         context.GetTypeFactory().AddType<model::Node, nodes::SumNode<int>>();
         context.GetTypeFactory().AddType<model::Node, nodes::SumNode<int64_t>>();
         context.GetTypeFactory().AddType<model::Node, nodes::SumNode<float>>();
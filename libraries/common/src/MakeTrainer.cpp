@@ -19,6 +19,7 @@
 #include "CommandLineParser.h"
 
 // trainers
+#include "BinnedHistogramForestTrainer.h"
 #include "HistogramForestTrainer.h"
 #include "LogitBooster.h"
 #include "SortingForestTrainer.h"
@@ -98,6 +99,29 @@ namespace common
         }
     }
 
+    std::unique_ptr<trainers::ITrainer<predictors::MultiClassLinearPredictor<double>>> MakeMultiClassSGDTrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::SGDTrainerParameters& trainerParameters)
+    {
+        using LossFunctionEnum = common::LossFunctionArguments::LossFunction;
+
+        switch (lossFunctionArguments.lossFunction)
+        {
+        case LossFunctionEnum::squared:
+            return trainers::MakeMultiClassSGDTrainer(functions::SquaredLoss(), trainerParameters);
+
+        case LossFunctionEnum::log:
+            return trainers::MakeMultiClassSGDTrainer(functions::LogLoss(), trainerParameters);
+
+        case LossFunctionEnum::hinge:
+            return trainers::MakeMultiClassSGDTrainer(functions::HingeLoss(), trainerParameters);
+
+        case LossFunctionEnum::smoothHinge:
+            return trainers::MakeMultiClassSGDTrainer(functions::SmoothHingeLoss(), trainerParameters);
+
+        default:
+            throw utilities::CommandLineParserErrorException("chosen loss function is not supported by this trainer");
+        }
+    }
+
     std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeSDCATrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::SDCATrainerParameters& trainerParameters)
     {
         using LossFunctionEnum = common::LossFunctionArguments::LossFunction;
@@ -130,6 +154,10 @@ namespace common
                 {
                     return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
                 }
+                else if (trainerArguments.binnedTrainer)
+                {
+                    return trainers::MakeBinnedHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
+                }
                 else
                 {
                     return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), trainerArguments);
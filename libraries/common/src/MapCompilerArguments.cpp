@@ -69,6 +69,15 @@ namespace common
               { "none", PreferredConvolutionMethod::none } },
             "none");
 
+        parser.AddOption(
+            mathFunctionAccuracy,
+            "mathFunctions",
+            "",
+            "Implementation of exp, log, tanh and sigmoid: precise (C runtime library) or fast (inlined polynomial approximations)",
+            { { "precise", MathFunctionAccuracy::precise },
+              { "fast", MathFunctionAccuracy::fast } },
+            "precise");
+
         parser.AddOption(
             enableVectorization,
             "vectorize",
@@ -104,6 +113,20 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            compileThreads,
+            "compileThreads",
+            "",
+            "Number of threads to use when optimizing the model's IR (machine code is still generated on one thread)",
+            1);
+
+        parser.AddOption(
+            tieredCompilation,
+            "tieredCompilation",
+            "",
+            "When jitting, start with unoptimized code and swap in optimized code once a background thread has compiled it",
+            false);
+
         parser.AddOption(
             debug,
             "debug",
@@ -192,6 +215,9 @@ namespace common
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
         settings.compilerSettings.parallelize = parallelize;
         settings.compilerSettings.vectorWidth = vectorWidth;
+        settings.compilerSettings.compileThreads = compileThreads;
+        settings.compilerSettings.mathFunctionAccuracy = mathFunctionAccuracy;
+        settings.tieredCompilation = tieredCompilation;
         settings.optimizerSettings.fuseLinearFunctionNodes = fuseLinearOperations;
         settings.optimizerSettings.preferredConvolutionMethod = convolutionMethod;
         settings.profile = profile;
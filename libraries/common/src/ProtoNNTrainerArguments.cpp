@@ -67,6 +67,18 @@ namespace common
             "nInnerIter",
             "Number of inner iterations",
             1);
+
+        parser.AddOption(kMeansMiniBatchSize,
+            "kMeansMiniBatchSize",
+            "kmb",
+            "If nonzero, initialize the prototypes with mini-batch k-means over batches of this many points",
+            0);
+
+        parser.AddOption(kMeansParallelInitialization,
+            "kMeansParallelInitialization",
+            "kmpi",
+            "Seed the prototype k-means with the parallel k-means|| strategy instead of k-means++",
+            false);
     }
 }
 }
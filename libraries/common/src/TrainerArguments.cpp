@@ -21,6 +21,13 @@ namespace common
             "The number of training epochs to perform",
             1);
 
+        parser.AddOption(
+            numThreads,
+            "numThreads",
+            "nt",
+            "The number of threads to train with (0 = one per hardware thread)",
+            1);
+
         parser.AddOption(
             verbose,
             "verbose",
@@ -16,6 +16,17 @@
 // nodes
 #include "ClockNode.h" // for nodes::TimeTickType
 
+// utilities
+#include "OrderedBatchPipeline.h"
+#include "ThreadPool.h"
+
+// stl
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 namespace ell
 {
 namespace common
@@ -45,28 +56,14 @@ namespace common
 
     namespace detail
     {
-        // this ugly global goes away once callbacks support passing around a context
-        static std::vector<double> g_inputValues;
-    }
-
-    // C functions called by compiled maps
-    extern "C"
-    {
-    inline bool InputCallback_Double(double* input)
-    {
-        std::copy(detail::g_inputValues.begin(), detail::g_inputValues.end(), input);
-        return true;
-    }
+        // The input callbacks of compiled maps, and the per-thread input rows they read from, are defined in
+        // DataLoaders.cpp. Throws if the input type isn't double or float.
+        ptrdiff_t GetInputCallbackAddress(model::Port::PortType inputType);
 
-    inline bool InputCallback_Float(float* input)
-    {
-        std::transform(detail::g_inputValues.begin(), detail::g_inputValues.end(), input, [](double val){ return static_cast<float>(val); });
-        return true;
-    }
-    }
+        // Sets the input row that the input callback of a compiled map running on this thread reads from
+        void SetCallbackInputRow(const double* row, size_t size);
+        void SetCallbackInputRow(const float* row, size_t size);
 
-    namespace detail
-    {
         // Sets up the function address that the LLVM jit will call for the source function callback
         // Note that this only supports a single source node, but can be extended in the future
         // to support multiple source nodes (e.g. by switching the function on node id).
@@ -75,57 +72,219 @@ namespace common
         {
             const std::string defaultCallbackName("ELL_InputCallback");
             auto callback = module->getFunction(defaultCallbackName);
+            jitter.DefineFunction(callback, GetInputCallbackAddress(map.GetInputType()));
+        }
 
-            ptrdiff_t callbackAddress = 0;
-            switch (map.GetInputType())
+        // Computes the first output of a map from its current input, and copies it to `output`
+        template <typename MapType, typename OutputValueType>
+        void ComputeOutputRow(const MapType& map, OutputValueType* output)
+        {
+            switch (map.GetOutputType())
             {
             case model::Port::PortType::smallReal:
             {
-                callbackAddress = reinterpret_cast<ptrdiff_t>(&InputCallback_Float);
+                auto result = map.template ComputeOutput<float>(0);
+                std::copy(result.begin(), result.end(), output);
                 break;
             }
             case model::Port::PortType::real:
             {
-                callbackAddress = reinterpret_cast<ptrdiff_t>(&InputCallback_Double);
+                auto result = map.template ComputeOutput<double>(0);
+                std::copy(result.begin(), result.end(), output);
                 break;
             }
             default:
-                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected source input type for model. Should be double or float.");
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected output type for model. Should be double or float.");
             }
+        }
 
-            jitter.DefineFunction(callback, callbackAddress);
+        // Copies a data vector into a zeroed dense row, truncating it to the row size
+        template <typename DataVectorType>
+        void CopyToRow(const DataVectorType& dataVector, double* row, size_t size, std::vector<double>& /*scratch*/)
+        {
+            dataVector.AddTo(math::RowVectorReference<double>(row, size));
         }
 
         template <typename DataVectorType>
-        void SetCallbackInputValue(const DataVectorType& values)
+        void CopyToRow(const DataVectorType& dataVector, float* row, size_t size, std::vector<double>& scratch)
         {
-            g_inputValues = values.ToArray();
+            scratch.assign(size, 0.0);
+            dataVector.AddTo(math::RowVectorReference<double>(scratch.data(), size));
+            std::copy(scratch.begin(), scratch.end(), row);
+        }
+
+        // Runs examples through a row function in batches. `rowFunctionFactory` is called once per worker, and returns
+        // a function of the form `void rowFunction(const InputValueType* input, OutputValueType* output)`.
+        template <typename InputValueType, typename OutputValueType, typename ExampleIteratorType, typename RowFunctionFactoryType, typename WriteFunctionType>
+        size_t TransformExampleBatches(ExampleIteratorType& exampleIterator, size_t inputSize, size_t outputSize, RowFunctionFactoryType&& rowFunctionFactory, WriteFunctionType&& writeFunction, size_t numThreads, size_t batchSize)
+        {
+            using MetadataType = std::decay_t<decltype(exampleIterator.Get().GetMetadata())>;
+            using InputBatchType = DenseExampleBatch<InputValueType, MetadataType>;
+            using OutputBatchType = DenseExampleBatch<OutputValueType, MetadataType>;
+
+            if (batchSize == 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batch size must be positive.");
+            }
+
+            size_t numExamples = 0;
+            std::vector<double> scratch;
+            auto readBatch = [&](InputBatchType& batch) {
+                batch.rowSize = inputSize;
+                batch.values.reserve(batchSize * inputSize);
+                batch.metadata.reserve(batchSize);
+                while (batch.NumRows() < batchSize && exampleIterator.IsValid())
+                {
+                    auto&& example = exampleIterator.Get();
+                    batch.values.resize(batch.values.size() + inputSize);
+                    CopyToRow(example.GetDataVector(), batch.GetRow(batch.NumRows()), inputSize, scratch);
+                    batch.metadata.push_back(example.GetMetadata());
+                    exampleIterator.Next();
+                }
+                numExamples += batch.NumRows();
+                return batch.NumRows() > 0;
+            };
+
+            auto makeProcessFunction = [&](size_t) {
+                auto rowFunction = rowFunctionFactory();
+                return [rowFunction, outputSize](const InputBatchType& input, OutputBatchType& output) mutable {
+                    output.rowSize = outputSize;
+                    output.values.resize(input.NumRows() * outputSize);
+                    output.metadata = input.metadata;
+                    for (size_t rowIndex = 0; rowIndex < input.NumRows(); ++rowIndex)
+                    {
+                        rowFunction(input.GetRow(rowIndex), output.GetRow(rowIndex));
+                    }
+                };
+            };
+
+            utilities::OrderedBatchPipeline<InputBatchType, OutputBatchType> pipeline(numThreads);
+            pipeline.Run(readBatch, makeProcessFunction, writeFunction);
+            return numExamples;
+        }
+
+        template <typename InputValueType, typename OutputValueType, typename ExampleIteratorType, typename WriteFunctionType>
+        size_t TransformExamples(ExampleIteratorType& exampleIterator, const model::Map& map, WriteFunctionType&& writeFunction, size_t numThreads, size_t batchSize)
+        {
+            auto inputSize = map.GetInputSize();
+            auto makeRowFunction = [&map, inputSize]() {
+                // each worker runs its own copy of the map, because computing a map changes the state of its input nodes
+                auto workerMap = std::make_shared<model::Map>(map);
+                auto inputValues = std::make_shared<std::vector<InputValueType>>(inputSize);
+                return [workerMap, inputValues](const InputValueType* input, OutputValueType* output) {
+                    std::copy(input, input + inputValues->size(), inputValues->begin());
+                    workerMap->SetInputValue(0, *inputValues);
+                    ComputeOutputRow(*workerMap, output);
+                };
+            };
+
+            return TransformExampleBatches<InputValueType, OutputValueType>(exampleIterator, inputSize, map.GetOutputSize(), makeRowFunction, writeFunction, numThreads, batchSize);
+        }
+
+        template <typename ExampleType, typename MetadataType>
+        void AddExamples(data::Dataset<ExampleType>& dataset, const DenseExampleBatch<double, MetadataType>& batch)
+        {
+            for (size_t rowIndex = 0; rowIndex < batch.NumRows(); ++rowIndex)
+            {
+                auto row = batch.GetRow(rowIndex);
+                data::DoubleDataVector dataVector(std::vector<double>(row, row + batch.rowSize));
+                dataset.AddExample(ExampleType(std::move(dataVector), batch.metadata[rowIndex]));
+            }
         }
     }
 
+    template <typename OutputValueType, typename ExampleIteratorType, typename WriteFunctionType>
+    size_t TransformExamples(ExampleIteratorType& exampleIterator, const model::Map& map, WriteFunctionType&& writeFunction, size_t numThreads, size_t batchSize)
+    {
+        switch (map.GetInputType())
+        {
+        case model::Port::PortType::smallReal:
+            return detail::TransformExamples<float, OutputValueType>(exampleIterator, map, writeFunction, numThreads, batchSize);
+        case model::Port::PortType::real:
+            return detail::TransformExamples<double, OutputValueType>(exampleIterator, map, writeFunction, numThreads, batchSize);
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected source input type for model. Should be double or float.");
+        }
+    }
+
+    template <typename ExampleType>
+    auto TransformDataset(data::Dataset<ExampleType>& input, const model::Map& map, size_t numThreads, size_t batchSize)
+    {
+        auto inputType = map.GetInputType();
+        if (inputType != model::Port::PortType::smallReal && inputType != model::Port::PortType::real)
+        {
+            return TransformDataset<ExampleType, model::Map>(input, map);
+        }
+
+        data::Dataset<ExampleType> output;
+        auto exampleIterator = input.GetExampleIterator();
+        TransformExamples<double>(exampleIterator, map, [&output](const auto& batch) { detail::AddExamples(output, batch); }, numThreads, batchSize);
+        return output;
+    }
+
     template <typename ExampleType, typename MapType>
-    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas)
+    auto TransformDatasetWithCompiledMap(data::Dataset<ExampleType>& input, const MapType& map, bool useBlas, size_t numThreads, size_t batchSize)
     {
-        ell::model::MapCompilerOptions settings;
-        settings.compilerSettings.useBlas = useBlas;
+        auto inputSize = map.GetInputSize();
+        auto numWorkers = numThreads == 0 ? utilities::ThreadPool::GetDefaultNumThreads() : numThreads;
 
-        model::IRMapCompiler compiler(settings);
+        // Each worker gets its own compiled copy of the map, so that the compiled maps' state isn't shared between threads.
+        // The compilers are kept alive along with the compiled maps, since the jitted code refers to their modules.
+        struct WorkerMap
+        {
+            std::shared_ptr<model::IRMapCompiler> compiler;
+            std::shared_ptr<model::IRCompiledMap> compiledMap;
+        };
+        auto compile = [&map, useBlas]() {
+            ell::model::MapCompilerOptions settings;
+            settings.compilerSettings.useBlas = useBlas;
 
-        auto module = compiler.GetModule().GetLLVMModule();
-        auto compiledMap = compiler.Compile(map);
+            auto compiler = std::make_shared<model::IRMapCompiler>(settings);
+            auto module = compiler->GetModule().GetLLVMModule();
+            auto compiledMap = std::make_shared<model::IRCompiledMap>(compiler->Compile(map));
 
-        // Unlike reference maps, compiled maps receive the current time as the parameter input and
-        // values through the input callback.
-        detail::ResolveInputCallback(map, module, compiledMap.GetJitter());
+            // Unlike reference maps, compiled maps receive the current time as the parameter input and
+            // values through the input callback.
+            detail::ResolveInputCallback(map, module, compiledMap->GetJitter());
+            return WorkerMap{ compiler, compiledMap };
+        };
 
-        return input.template Transform<ExampleType>([&compiledMap](const ExampleType& example)
+        // The first compilation initializes LLVM's targets, which isn't safe to do from several threads at once. Each
+        // compiler has its own LLVM context, so the other copies are then compiled in parallel.
+        std::vector<WorkerMap> workerMaps(numWorkers);
+        workerMaps[0] = compile();
+        if (numWorkers > 1)
         {
-            compiledMap.SetInputValue(0, std::vector<nodes::TimeTickType>({ 0 /*currentTime*/ }));
-            detail::SetCallbackInputValue(example.GetDataVector());
-            auto transformedDataVector = compiledMap.template ComputeOutput<typename ExampleType::DataVectorType>(0);
-            return ExampleType(std::move(transformedDataVector), example.GetMetadata());
-        });
-    }
+            utilities::ThreadPool threadPool(numWorkers - 1);
+            threadPool.ParallelFor(numWorkers - 1, [&workerMaps, &compile](size_t index) { workerMaps[index + 1] = compile(); });
+        }
+
+        // The pipeline asks for the workers' row functions one at a time, on this thread
+        size_t nextWorker = 0;
+        auto makeRowFunction = [&workerMaps, &nextWorker, inputSize]() {
+            auto workerMap = workerMaps[nextWorker++];
+            return [workerMap, inputSize](const auto* input, auto* output) {
+                detail::SetCallbackInputRow(input, inputSize);
+                workerMap.compiledMap->SetInputValue(0, std::vector<nodes::TimeTickType>({ 0 /*currentTime*/ }));
+                detail::ComputeOutputRow(*workerMap.compiledMap, output);
+            };
+        };
 
+        data::Dataset<ExampleType> output;
+        auto exampleIterator = input.GetExampleIterator();
+        auto writeBatch = [&output](const auto& batch) { detail::AddExamples(output, batch); };
+        switch (map.GetInputType())
+        {
+        case model::Port::PortType::smallReal:
+            detail::TransformExampleBatches<float, double>(exampleIterator, inputSize, map.GetOutputSize(), makeRowFunction, writeBatch, numWorkers, batchSize);
+            break;
+        case model::Port::PortType::real:
+            detail::TransformExampleBatches<double, double>(exampleIterator, inputSize, map.GetOutputSize(), makeRowFunction, writeBatch, numWorkers, batchSize);
+            break;
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected source input type for model. Should be double or float.");
+        }
+        return output;
+    }
 }
 }
@@ -8,5 +8,6 @@
 namespace ell
 {
 void TestLoadDataset(const std::string& examplePath);
+void TestLoadBinaryDataset(const std::string& examplePath);
 void TestLoadMappedDataset(const std::string& examplePath);
 }
\ No newline at end of file
@@ -11,4 +11,5 @@ void TestLoadSampleModels();
 void TestLoadTreeModels();
 void TestLoadSavedModels(const std::string& examplePath);
 void TestSaveModels();
+void TestLoadUntemplatedProtoNNModel();
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 #include "LoadMap_test.h"
 
+// data
+#include "MappedDataset.h"
+
 // common
 #include "DataLoadArguments.h"
 #include "DataLoaders.h"
@@ -18,7 +21,10 @@
 #include "Files.h"
 
 // stl
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 namespace ell
 {
@@ -29,6 +35,28 @@ void TestLoadDataset(const std::string& examplePath)
     auto dataset = common::GetDataset(stream);
 }
 
+void TestLoadBinaryDataset(const std::string& examplePath)
+{
+    auto stream = utilities::OpenIfstream(utilities::JoinPaths(examplePath, { "data", "testData.txt" }));
+    auto textDataset = common::GetDataset(stream);
+
+    common::DataLoadArguments args;
+    args.inputDataFilename = "LoadBinaryDataset_test.elldata";
+    {
+        std::ofstream binaryStream(args.inputDataFilename, std::ios::binary);
+        auto exampleIterator = textDataset.GetExampleIterator();
+        data::WriteBinaryDataset(exampleIterator, binaryStream);
+    }
+    args.isBinaryDataset = data::IsBinaryDatasetFile(args.inputDataFilename);
+    auto binaryDataset = common::GetDataset(args);
+
+    std::stringstream ss1, ss2;
+    textDataset.Print(ss1);
+    binaryDataset.Print(ss2);
+    testing::ProcessTest("GetDataset from binary dataset file", args.isBinaryDataset && ss1.str() == ss2.str());
+    std::remove(args.inputDataFilename.c_str());
+}
+
 void TestLoadMappedDataset(const std::string& examplePath)
 {
     common::MapLoadArguments args;
@@ -6,17 +6,30 @@
 #include "LoadModel_test.h"
 
 // common
+#include "LoadModel.h"
 #include "LoadTestModels.h"
 #include "Files.h"
 
 // model
+#include "InputNode.h"
 #include "Model.h"
 
+// nodes
+#include "ProtoNNPredictorNode.h"
+
+// predictors
+#include "ProtoNNPredictor.h"
+
 // testing
 #include "testing.h"
 
 // stl
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
 
 namespace ell
 {
@@ -78,4 +91,69 @@ void TestSaveModels()
     auto newTree2 = common::LoadModel("tree_2." + ext);
     auto newTree3 = common::LoadModel("tree_3." + ext);
 }
+
+void TestLoadUntemplatedProtoNNModel()
+{
+    size_t dim = 5, projectedDim = 4, numPrototypes = 3, numLabels = 2;
+    predictors::ProtoNNPredictor predictor(dim, projectedDim, numPrototypes, numLabels, 0.3);
+    auto& W = predictor.GetProjectionMatrix();
+    for (size_t i = 0; i < projectedDim; ++i)
+    {
+        for (size_t j = 0; j < dim; ++j)
+        {
+            W(i, j) = std::sin(static_cast<double>(i * dim + j));
+        }
+    }
+    auto& B = predictor.GetPrototypes();
+    for (size_t i = 0; i < projectedDim; ++i)
+    {
+        for (size_t k = 0; k < numPrototypes; ++k)
+        {
+            B(i, k) = std::cos(static_cast<double>(i * numPrototypes + k));
+        }
+    }
+    auto& Z = predictor.GetLabelEmbeddings();
+    for (size_t l = 0; l < numLabels; ++l)
+    {
+        for (size_t k = 0; k < numPrototypes; ++k)
+        {
+            Z(l, k) = static_cast<double>(l + k) / 4;
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(dim);
+    auto predictorNode = model.AddNode<nodes::ProtoNNPredictorNode<double>>(inputNode->output, predictor);
+
+    // ProtoNNPredictorNode used to be a double-only class, archived with its plain name and the same fields
+    std::stringstream stream;
+    common::SaveModel(model, stream);
+    auto archive = stream.str();
+    const std::string typeName = nodes::ProtoNNPredictorNode<double>::GetTypeName();
+    const std::string untemplatedTypeName = "ProtoNNPredictorNode";
+    for (auto position = archive.find(typeName); position != std::string::npos; position = archive.find(typeName, position))
+    {
+        archive.replace(position, typeName.size(), untemplatedTypeName);
+    }
+
+    const std::string filename = "protonn_untemplated.model";
+    {
+        std::ofstream file(filename);
+        file << archive;
+    }
+    auto loadedModel = common::LoadModel(filename);
+    std::remove(filename.c_str());
+
+    auto loadedInputNode = dynamic_cast<model::InputNode<double>*>(loadedModel.GetNode(inputNode->GetId()));
+    auto loadedPredictorNode = dynamic_cast<nodes::ProtoNNPredictorNode<double>*>(loadedModel.GetNode(predictorNode->GetId()));
+    bool ok = archive.find(typeName) == std::string::npos && loadedInputNode != nullptr && loadedPredictorNode != nullptr;
+    if (ok)
+    {
+        std::vector<double> input = { 0.2, 0.5, 0.6, 0.8, 0.1 };
+        inputNode->SetInput(input);
+        loadedInputNode->SetInput(input);
+        ok = testing::IsEqual(model.ComputeOutput(predictorNode->output), loadedModel.ComputeOutput(loadedPredictorNode->output));
+    }
+    testing::ProcessTest("Loading a model with an untemplated ProtoNNPredictorNode", ok);
+}
 }
@@ -40,11 +40,13 @@ int main(int argc, char* argv[])
         TestLoadSavedModels(examplePath);
 
         TestSaveModels();
+        TestLoadUntemplatedProtoNNModel();
 
         TestLoadMapWithDefaultArgs(examplePath);
         TestLoadMapWithPorts(examplePath);
 
         TestLoadDataset(examplePath);
+        TestLoadBinaryDataset(examplePath);
         TestLoadMappedDataset(examplePath);
     }
     catch (const utilities::Exception& exception)
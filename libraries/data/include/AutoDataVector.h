@@ -166,8 +166,25 @@ namespace data
         void Print(std::ostream& os) const override;
 
     private:
-        // helper function used by ctors to choose the type of data vector to use
+        // statistics of the nonzero entries of a data vector, from which its representation is chosen
+        struct EntryStatistics
+        {
+            void Add(IndexValue entry);
+
+            size_t numNonZeros = 0;
+            size_t prefixLength = 0;
+            bool includesNonFloats = false;
+            bool includesNonShorts = false;
+            bool includesNonBytes = false;
+            bool includesNonBinary = false;
+        };
+
+        // helper functions used by ctors to choose the type of data vector to use
         void FindBestRepresentation(DefaultDataVectorType defaultDataVector);
+        void FindBestRepresentation(std::vector<IndexValue> entries);
+
+        template <typename SourceType>
+        void SetBestRepresentation(SourceType source, const EntryStatistics& statistics);
 
         template <typename DataVectorType, utilities::IsSame<DataVectorType, DefaultDataVectorType> Concept = true>
         void SetInternal(DefaultDataVectorType defaultDataVector)
@@ -179,6 +196,9 @@ namespace data
         template <typename DataVectorType, utilities::IsDifferent<DataVectorType, DefaultDataVectorType> Concept = true>
         void SetInternal(DefaultDataVectorType defaultDataVector);
 
+        template <typename DataVectorType>
+        void SetInternal(std::vector<IndexValue> entries);
+
         // members
         std::unique_ptr<IDataVector> _pInternal;
     };
@@ -31,6 +31,8 @@ namespace data
     template <typename ExampleType>
     class Dataset;
 
+    class MappedDataset;
+
     /// <summary> Polymorphic interface for datasets, enables dynamic_cast operations. </summary>
     struct DatasetBase
     {
@@ -61,6 +63,26 @@ namespace data
         /// <returns> Number of examples. </returns>
         size_t NumExamples() const { return _size; }
 
+        /// <summary> Returns the index of the first example of the interval, in the underlying dataset. </summary>
+        ///
+        /// <returns> Zero-based index of the first example. </returns>
+        size_t FromIndex() const { return _fromIndex; }
+
+        /// <summary> Returns the underlying dataset if it is a MappedDataset, which trainers can stream from rather
+        /// than copy into memory. </summary>
+        ///
+        /// <returns> Pointer to the MappedDataset, or nullptr if the underlying dataset is held in memory. </returns>
+        const MappedDataset* GetMappedDataset() const;
+
+        /// <summary> Returns the underlying dataset if it is held in memory with the given example type, which
+        /// trainers can read from in place rather than copy. </summary>
+        ///
+        /// <typeparam name="ExampleType"> Example type. </typeparam>
+        ///
+        /// <returns> Pointer to the Dataset, or nullptr if the underlying dataset has a different type. </returns>
+        template <typename ExampleType>
+        const Dataset<ExampleType>* GetInMemoryDataset() const;
+
     private:
         const DatasetBase* _pDataset;
         size_t _fromIndex;
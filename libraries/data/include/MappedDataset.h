@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+
+// utilities
+#include "MemoryMappedFile.h"
+
+// stl
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> The header at the beginning of a binary dataset file. The file holds the examples in columns:
+    /// the feature indices (uint32) and values (double) of all the nonzero entries, in compressed sparse row order,
+    /// followed by the weights (double), the labels (double) and the row offsets (uint64, one more than the number of
+    /// examples) of the examples. Each column starts at the offset recorded in the header, and the row offsets of
+    /// example i give the range of its entries. </summary>
+    struct BinaryDatasetHeader
+    {
+        char magic[8];
+        uint64_t version;
+        uint64_t numExamples;
+        uint64_t numFeatures;
+        uint64_t numEntries;
+        uint64_t indicesOffset;
+        uint64_t valuesOffset;
+        uint64_t weightsOffset;
+        uint64_t labelsOffset;
+        uint64_t rowOffsetsOffset;
+    };
+
+    /// <summary> Writes examples to a binary dataset file, one example at a time. Only the per-example columns are
+    /// kept in memory, so the dataset can be larger than the physical memory. </summary>
+    class BinaryDatasetWriter
+    {
+    public:
+        /// <summary> Constructs a writer that writes to a stream. The stream must be seekable, and opened in binary mode. </summary>
+        ///
+        /// <param name="stream"> The output stream. </param>
+        BinaryDatasetWriter(std::ostream& stream);
+
+        BinaryDatasetWriter(const BinaryDatasetWriter&) = delete;
+
+        ~BinaryDatasetWriter();
+
+        /// <summary> Appends an example to the dataset. </summary>
+        ///
+        /// <param name="example"> The example. </param>
+        void AddExample(const AutoSupervisedExample& example);
+
+        /// <summary> Writes the remaining columns and the header. Must be called once, after the last example. </summary>
+        void Finish();
+
+    private:
+        std::ostream& _stream;
+        std::FILE* _valuesFile; // the values are buffered in a temporary file, since they follow all the indices
+        std::vector<double> _weights;
+        std::vector<double> _labels;
+        std::vector<uint64_t> _rowOffsets;
+        uint64_t _numFeatures = 0;
+        bool _isFinished = false;
+    };
+
+    /// <summary> Writes the examples of an example iterator to a binary dataset file. </summary>
+    ///
+    /// <typeparam name="ExampleIteratorType"> The example iterator type. </typeparam>
+    /// <param name="exampleIterator"> The example iterator. </param>
+    /// <param name="stream"> The output stream, which must be seekable and opened in binary mode. </param>
+    ///
+    /// <returns> The number of examples written. </returns>
+    template <typename ExampleIteratorType>
+    size_t WriteBinaryDataset(ExampleIteratorType& exampleIterator, std::ostream& stream);
+
+    /// <summary> Checks whether a file is a binary dataset, by reading its first bytes. </summary>
+    ///
+    /// <param name="filepath"> The path of the file. </param>
+    ///
+    /// <returns> true if the file starts with the binary dataset header. </returns>
+    bool IsBinaryDatasetFile(const std::string& filepath);
+
+    /// <summary> Loads all of the examples of a binary dataset file into memory. The file is mapped and read in one
+    /// pass, and the examples are built directly from its columns, without parsing any text. </summary>
+    ///
+    /// <param name="filepath"> The path of the binary dataset file. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    AutoSupervisedDataset LoadBinaryDataset(const std::string& filepath);
+
+    /// <summary> A read-only dataset of supervised examples, stored in a binary dataset file that is mapped into
+    /// memory. The examples are decoded as they are accessed, and the OS reads the file on demand, so the dataset
+    /// can be much larger than the physical memory. Iterators ask the OS to read ahead the block of examples they
+    /// will visit next. </summary>
+    class MappedDataset : public DatasetBase
+    {
+    public:
+        /// <summary> The default number of consecutive examples in a block of a shuffled iteration. </summary>
+        static constexpr size_t defaultBlockSize = 4096;
+
+        /// <summary> An iterator over the examples of a MappedDataset, which visits blocks of consecutive examples
+        /// in a given order, and the examples of each block in an optionally random order. </summary>
+        template <typename IteratorExampleType>
+        class MappedDatasetExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary> Constructs an iterator. </summary>
+            ///
+            /// <param name="dataset"> The dataset. </param>
+            /// <param name="fromIndex"> Zero-based index of the first example of the range to iterate over. </param>
+            /// <param name="size"> The number of examples in the range. </param>
+            /// <param name="blockSize"> The number of consecutive examples in a block. </param>
+            /// <param name="blockOrder"> The order in which the blocks are visited, or empty to visit them in order. </param>
+            /// <param name="shuffleBlocks"> Whether to visit the examples of each block in a random order. </param>
+            /// <param name="seed"> The seed of the random order within the blocks. </param>
+            MappedDatasetExampleIterator(const MappedDataset& dataset, size_t fromIndex, size_t size, size_t blockSize, std::vector<size_t> blockOrder, bool shuffleBlocks, std::default_random_engine::result_type seed);
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            ///
+            /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+            bool IsValid() const override { return _blockPosition < _numBlocks; }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override;
+
+            /// <summary> Gets the current example pointer to by the iterator. </summary>
+            ///
+            /// <returns> The example. </returns>
+            IteratorExampleType Get() const override;
+
+        private:
+            size_t GetBlock(size_t blockPosition) const { return _blockOrder.empty() ? blockPosition : _blockOrder[blockPosition]; }
+            void EnterBlock();
+
+            const MappedDataset& _dataset;
+            size_t _fromIndex;
+            size_t _size;
+            size_t _blockSize;
+            size_t _numBlocks;
+            std::vector<size_t> _blockOrder;
+            bool _shuffleBlocks;
+            std::default_random_engine _random;
+
+            size_t _blockPosition = 0;
+            size_t _blockBegin = 0;
+            size_t _positionInBlock = 0;
+            std::vector<size_t> _orderInBlock;
+        };
+
+        /// <summary> Maps a binary dataset file into memory, and checks its header. </summary>
+        ///
+        /// <param name="filepath"> The path of the binary dataset file. </param>
+        MappedDataset(const std::string& filepath);
+
+        MappedDataset(MappedDataset&&) = default;
+
+        MappedDataset(const MappedDataset&) = delete;
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return static_cast<size_t>(_header.numExamples); }
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        ///
+        /// <returns> The maximal size of any example. </returns>
+        size_t NumFeatures() const { return static_cast<size_t>(_header.numFeatures); }
+
+        /// <summary> Returns the total number of nonzero entries in the examples. </summary>
+        ///
+        /// <returns> The number of nonzero entries. </returns>
+        size_t NumEntries() const { return static_cast<size_t>(_header.numEntries); }
+
+        /// <summary> Decodes an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        AutoSupervisedExample GetExample(size_t index) const;
+
+        /// <summary> Returns an iterator that traverses the examples in order. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an iterator that traverses the examples in a random order, which is the out-of-core
+        /// counterpart of iterating over a randomly permuted Dataset. The examples are split into blocks of
+        /// consecutive examples, the blocks are visited in a random order, and the examples of each block in a random
+        /// order, so that the file is read a block at a time. </summary>
+        ///
+        /// <param name="rng"> [in,out] The random number generator. </param>
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        /// <param name="blockSize"> The number of consecutive examples in a block. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetShuffledExampleIterator(std::default_random_engine& rng, size_t fromIndex = 0, size_t size = 0, size_t blockSize = defaultBlockSize) const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="firstExample"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, size); }
+
+        /// <summary> Tells the OS how the examples will be accessed, which affects how much of the file it reads ahead. </summary>
+        ///
+        /// <param name="accessPattern"> The access pattern. </param>
+        void SetAccessPattern(utilities::MemoryMappedFile::AccessPattern accessPattern) const { _file.SetAccessPattern(accessPattern); }
+
+        /// <summary> Asks the OS to start reading the entries of a range of examples into memory. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example of the range. </param>
+        /// <param name="size"> The number of examples in the range. </param>
+        void Prefetch(size_t fromIndex, size_t size) const;
+
+    private:
+        size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+
+        utilities::MemoryMappedFile _file;
+        BinaryDatasetHeader _header;
+        const uint32_t* _indices;
+        const double* _values;
+        const double* _weights;
+        const double* _labels;
+        const uint64_t* _rowOffsets;
+    };
+}
+}
+
+#include "../tcc/MappedDataset.tcc"
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PrefetchingExampleIterator.h (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Example.h"
+#include "ExampleIterator.h"
+
+// utilities
+#include "PrefetchingIterator.h"
+#include "StallStatistics.h"
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// An example iterator that reads, and optionally parses, examples on background threads, ahead of the consumer.
+    /// The examples are passed to the consumer through bounded lock-free queues, in their original order, so that the
+    /// I/O and parsing overlap with whatever the consumer does with the examples, such as training.
+    /// </summary>
+    ///
+    /// <typeparam name="ExampleType"> The example type. </typeparam>
+    template <typename ExampleType>
+    class PrefetchingExampleIterator : public IExampleIterator<ExampleType>
+    {
+    public:
+        /// <summary> The default number of examples that each queue holds. </summary>
+        static constexpr size_t defaultQueueDepth = 256;
+
+        /// <summary> Constructs an iterator that reads the examples of another example iterator on a background thread. </summary>
+        ///
+        /// <param name="exampleIterator"> The example iterator, which is only used by the background thread from now on. </param>
+        /// <param name="queueDepth"> The maximum number of examples read ahead. </param>
+        PrefetchingExampleIterator(ExampleIterator<ExampleType> exampleIterator, size_t queueDepth = defaultQueueDepth);
+
+        /// <summary> Constructs an iterator that reads text lines on a background thread, and parses them on a set of
+        /// parser threads. Lines that are empty or only hold a comment are skipped. </summary>
+        ///
+        /// <typeparam name="TextLineIteratorType"> TextLine iterator type. </typeparam>
+        /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+        /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+        /// <param name="textLineIterator"> The line iterator. The stream it reads must outlive this iterator. </param>
+        /// <param name="metadataParser"> The metadata parser. </param>
+        /// <param name="dataVectorParser"> The data vector parser. </param>
+        /// <param name="queueDepth"> The maximum number of lines or examples in each queue between the threads. </param>
+        /// <param name="numParserThreads"> The number of parser threads. If zero, the lines are parsed on the thread that reads them. </param>
+        template <typename TextLineIteratorType, typename MetadataParserType, typename DataVectorParserType>
+        PrefetchingExampleIterator(TextLineIteratorType textLineIterator, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t queueDepth, size_t numParserThreads);
+
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+        bool IsValid() const override { return _iterator.IsValid(); }
+
+        /// <summary> Proceeds to the Next iterate, waiting for it if it hasn't been read yet. </summary>
+        void Next() override { _iterator.Next(); }
+
+        /// <summary> Gets the current example. </summary>
+        ///
+        /// <returns> The example. </returns>
+        ExampleType Get() const override { return _iterator.Get(); }
+
+        /// <summary> Returns the time that the background threads and the consumer have spent waiting for each other so far. </summary>
+        ///
+        /// <returns> The stall statistics. </returns>
+        utilities::StallStatistics GetStallStatistics() const { return _iterator.GetStallStatistics(); }
+
+    private:
+        utilities::PrefetchingIterator<ExampleType> _iterator;
+    };
+
+    /// <summary> Helper function that wraps an example iterator in a PrefetchingExampleIterator. </summary>
+    ///
+    /// <typeparam name="ExampleType"> The example type. </typeparam>
+    /// <param name="exampleIterator"> The example iterator. </param>
+    /// <param name="queueDepth"> The maximum number of examples read ahead. </param>
+    ///
+    /// <returns> The prefetching example iterator. </returns>
+    template <typename ExampleType>
+    ExampleIterator<ExampleType> MakePrefetchingExampleIterator(ExampleIterator<ExampleType> exampleIterator, size_t queueDepth = PrefetchingExampleIterator<ExampleType>::defaultQueueDepth);
+
+    /// <summary> Helper function that creates a PrefetchingExampleIterator that parses text lines on a set of parser threads. </summary>
+    ///
+    /// <typeparam name="TextLineIteratorType"> Text line iterator type. </typeparam>
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> Data vector parser type. </typeparam>
+    /// <param name="textLineIterator"> The line iterator. </param>
+    /// <param name="metadataParser"> The metadata parser. </param>
+    /// <param name="dataVectorParser"> The data vector parser. </param>
+    /// <param name="queueDepth"> The maximum number of lines or examples in each queue between the threads. </param>
+    /// <param name="numParserThreads"> The number of parser threads. </param>
+    ///
+    /// <returns> The prefetching example iterator. </returns>
+    template <typename TextLineIteratorType, typename MetadataParserType, typename DataVectorParserType>
+    auto MakePrefetchingParsingExampleIterator(TextLineIteratorType textLineIterator, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t queueDepth, size_t numParserThreads);
+}
+}
+
+#include "../tcc/PrefetchingExampleIterator.tcc"
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Dataset.h"
+#include "MappedDataset.h"
 
 namespace ell
 {
@@ -16,5 +17,10 @@ namespace data
         : _pDataset(pDataset), _fromIndex(fromIndex), _size(size)
     {
     }
+
+    const MappedDataset* AnyDataset::GetMappedDataset() const
+    {
+        return dynamic_cast<const MappedDataset*>(_pDataset);
+    }
 }
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.cpp (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MappedDataset.h"
+#include "IndexValue.h"
+#include "SparseDataVector.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        const char binaryDatasetMagic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+        const uint64_t binaryDatasetVersion = 1;
+
+        template <typename ValueType>
+        void WriteArray(std::ostream& stream, const ValueType* data, size_t size)
+        {
+            stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size * sizeof(ValueType)));
+        }
+
+        // pads the stream with zeros up to a multiple of 8 bytes, so that the next column is aligned
+        uint64_t AlignStream(std::ostream& stream, uint64_t position)
+        {
+            const char zeros[8] = {};
+            auto padding = (8 - position % 8) % 8;
+            stream.write(zeros, static_cast<std::streamsize>(padding));
+            return position + padding;
+        }
+    }
+
+    //
+    // BinaryDatasetWriter
+    //
+    BinaryDatasetWriter::BinaryDatasetWriter(std::ostream& stream)
+        : _stream(stream), _valuesFile(std::tmpfile()), _rowOffsets(1, 0)
+    {
+        if (_valuesFile == nullptr)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Can't create a temporary file for the dataset values");
+        }
+
+        // the header is written again by Finish, when the sizes of the columns are known
+        BinaryDatasetHeader header = {};
+        WriteArray(_stream, &header, 1);
+    }
+
+    BinaryDatasetWriter::~BinaryDatasetWriter()
+    {
+        std::fclose(_valuesFile);
+    }
+
+    void BinaryDatasetWriter::AddExample(const AutoSupervisedExample& example)
+    {
+        if (_isFinished)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Can't add examples to a finished binary dataset");
+        }
+
+        auto sparseDataVector = example.GetDataVector().CopyAs<SparseDoubleDataVector>();
+        uint64_t numEntries = 0;
+        for (auto iterator = sparseDataVector.GetIterator<IterationPolicy::skipZeros>(); iterator.IsValid(); iterator.Next())
+        {
+            auto entry = iterator.Get();
+            if (entry.index > std::numeric_limits<uint32_t>::max())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Binary datasets only support feature indices less than 2^32");
+            }
+            auto index = static_cast<uint32_t>(entry.index);
+            WriteArray(_stream, &index, 1);
+            std::fwrite(&entry.value, sizeof(double), 1, _valuesFile);
+            ++numEntries;
+        }
+
+        _weights.push_back(example.GetMetadata().weight);
+        _labels.push_back(example.GetMetadata().label);
+        _rowOffsets.push_back(_rowOffsets.back() + numEntries);
+        _numFeatures = std::max(_numFeatures, static_cast<uint64_t>(sparseDataVector.PrefixLength()));
+    }
+
+    void BinaryDatasetWriter::Finish()
+    {
+        if (_isFinished)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Binary dataset is already finished");
+        }
+        _isFinished = true;
+
+        BinaryDatasetHeader header = {};
+        std::memcpy(header.magic, binaryDatasetMagic, sizeof(header.magic));
+        header.version = binaryDatasetVersion;
+        header.numExamples = _weights.size();
+        header.numFeatures = _numFeatures;
+        header.numEntries = _rowOffsets.back();
+        header.indicesOffset = sizeof(BinaryDatasetHeader);
+
+        // copy the values from the temporary file
+        header.valuesOffset = AlignStream(_stream, header.indicesOffset + header.numEntries * sizeof(uint32_t));
+        std::rewind(_valuesFile);
+        std::vector<char> buffer(1 << 16);
+        size_t numBytes = 0;
+        while ((numBytes = std::fread(buffer.data(), 1, buffer.size(), _valuesFile)) > 0)
+        {
+            _stream.write(buffer.data(), static_cast<std::streamsize>(numBytes));
+        }
+
+        header.weightsOffset = header.valuesOffset + header.numEntries * sizeof(double);
+        WriteArray(_stream, _weights.data(), _weights.size());
+        header.labelsOffset = header.weightsOffset + header.numExamples * sizeof(double);
+        WriteArray(_stream, _labels.data(), _labels.size());
+        header.rowOffsetsOffset = header.labelsOffset + header.numExamples * sizeof(double);
+        WriteArray(_stream, _rowOffsets.data(), _rowOffsets.size());
+
+        _stream.seekp(0);
+        WriteArray(_stream, &header, 1);
+        _stream.flush();
+        if (!_stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Error writing the binary dataset");
+        }
+    }
+
+    bool IsBinaryDatasetFile(const std::string& filepath)
+    {
+        std::ifstream stream(filepath, std::ios::binary);
+        char magic[sizeof(binaryDatasetMagic)] = {};
+        stream.read(magic, sizeof(magic));
+        return stream && std::memcmp(magic, binaryDatasetMagic, sizeof(magic)) == 0;
+    }
+
+    AutoSupervisedDataset LoadBinaryDataset(const std::string& filepath)
+    {
+        MappedDataset mappedDataset(filepath);
+        mappedDataset.SetAccessPattern(utilities::MemoryMappedFile::AccessPattern::sequential);
+
+        AutoSupervisedDataset dataset;
+        for (size_t index = 0; index < mappedDataset.NumExamples(); ++index)
+        {
+            dataset.AddExample(mappedDataset.GetExample(index));
+        }
+        return dataset;
+    }
+
+    //
+    // MappedDataset
+    //
+    constexpr size_t MappedDataset::defaultBlockSize;
+
+    MappedDataset::MappedDataset(const std::string& filepath)
+        : _file(filepath)
+    {
+        if (_file.Size() < sizeof(BinaryDatasetHeader))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::abruptEnd, filepath + " is too short to be a binary dataset");
+        }
+        std::memcpy(&_header, _file.GetData(), sizeof(BinaryDatasetHeader));
+        if (std::memcmp(_header.magic, binaryDatasetMagic, sizeof(binaryDatasetMagic)) != 0 || _header.version != binaryDatasetVersion)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, filepath + " is not a binary dataset, or has an unsupported version");
+        }
+
+        auto rowOffsetsEnd = _header.rowOffsetsOffset + (_header.numExamples + 1) * sizeof(uint64_t);
+        if (_header.valuesOffset % 8 != 0 || _header.weightsOffset % 8 != 0 || _header.labelsOffset % 8 != 0 || _header.rowOffsetsOffset % 8 != 0 || rowOffsetsEnd > _file.Size())
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, filepath + " has corrupt column offsets");
+        }
+
+        auto data = _file.GetData();
+        _indices = reinterpret_cast<const uint32_t*>(data + _header.indicesOffset);
+        _values = reinterpret_cast<const double*>(data + _header.valuesOffset);
+        _weights = reinterpret_cast<const double*>(data + _header.weightsOffset);
+        _labels = reinterpret_cast<const double*>(data + _header.labelsOffset);
+        _rowOffsets = reinterpret_cast<const uint64_t*>(data + _header.rowOffsetsOffset);
+        if (_rowOffsets[_header.numExamples] != _header.numEntries)
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, filepath + " has corrupt row offsets");
+        }
+    }
+
+    AutoSupervisedExample MappedDataset::GetExample(size_t index) const
+    {
+        if (index >= NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index exceeds the number of examples in the dataset");
+        }
+
+        auto begin = _rowOffsets[index];
+        auto end = _rowOffsets[index + 1];
+        std::vector<IndexValue> entries;
+        entries.reserve(end - begin);
+        for (auto entry = begin; entry < end; ++entry)
+        {
+            entries.push_back({ _indices[entry], _values[entry] });
+        }
+        return AutoSupervisedExample(AutoDataVector(std::move(entries)), WeightLabel{ _weights[index], _labels[index] });
+    }
+
+    void MappedDataset::Prefetch(size_t fromIndex, size_t size) const
+    {
+        if (size == 0 || fromIndex >= NumExamples())
+        {
+            return;
+        }
+        size = std::min(size, NumExamples() - fromIndex);
+
+        auto beginEntry = _rowOffsets[fromIndex];
+        auto numEntries = _rowOffsets[fromIndex + size] - beginEntry;
+        _file.Prefetch(static_cast<size_t>(_header.indicesOffset + beginEntry * sizeof(uint32_t)), static_cast<size_t>(numEntries * sizeof(uint32_t)));
+        _file.Prefetch(static_cast<size_t>(_header.valuesOffset + beginEntry * sizeof(double)), static_cast<size_t>(numEntries * sizeof(double)));
+    }
+
+    size_t MappedDataset::CorrectRangeSize(size_t fromIndex, size_t size) const
+    {
+        if (fromIndex > NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index exceeds the number of examples in the dataset");
+        }
+        if (size == 0 || fromIndex + size > NumExamples())
+        {
+            return NumExamples() - fromIndex;
+        }
+        return size;
+    }
+}
+}
@@ -48,8 +48,7 @@ namespace data
     template <typename DefaultDataVectorType>
     AutoDataVectorBase<DefaultDataVectorType>::AutoDataVectorBase(std::vector<IndexValue> vec)
     {
-        DefaultDataVectorType defaultDataVector(std::move(vec));
-        FindBestRepresentation(std::move(defaultDataVector));
+        FindBestRepresentation(std::move(vec));
     }
 
     template <typename DefaultDataVectorType>
@@ -124,71 +123,95 @@ namespace data
     }
 
     template <typename DefaultDataVectorType>
-    void AutoDataVectorBase<DefaultDataVectorType>::FindBestRepresentation(DefaultDataVectorType defaultDataVector)
+    void AutoDataVectorBase<DefaultDataVectorType>::EntryStatistics::Add(IndexValue entry)
     {
-        size_t numNonZeros = 0;
-        bool includesNonFloats = false;
-        bool includesNonShorts = false;
-        bool includesNonBytes = false;
-        bool includesNonBinary = false;
+        double value = entry.value;
 
+        ++numNonZeros;
+        prefixLength = entry.index + 1;
+        includesNonFloats |= DoesCastModifyValue<float>(value);
+        includesNonShorts |= DoesCastModifyValue<short>(value);
+        includesNonBytes |= DoesCastModifyValue<char>(value);
+        includesNonBinary |= (value != 1 && value != 0);
+    }
+
+    template <typename DefaultDataVectorType>
+    void AutoDataVectorBase<DefaultDataVectorType>::FindBestRepresentation(DefaultDataVectorType defaultDataVector)
+    {
+        EntryStatistics statistics;
         auto iter = GetIterator<DefaultDataVectorType, IterationPolicy::skipZeros>(defaultDataVector);
         while (iter.IsValid())
         {
-            double value = iter.Get().value;
+            statistics.Add(iter.Get());
+            iter.Next();
+        }
 
-            ++numNonZeros;
-            includesNonFloats |= DoesCastModifyValue<float>(value);
-            includesNonShorts |= DoesCastModifyValue<short>(value);
-            includesNonBytes |= DoesCastModifyValue<char>(value);
-            includesNonBinary |= (value != 1 && value != 0);
+        SetBestRepresentation(std::move(defaultDataVector), statistics);
+    }
 
-            iter.Next();
+    template <typename DefaultDataVectorType>
+    void AutoDataVectorBase<DefaultDataVectorType>::FindBestRepresentation(std::vector<IndexValue> entries)
+    {
+        // the entries are copied straight into the chosen type, without first expanding them into the default type
+        EntryStatistics statistics;
+        for (const auto& entry : entries)
+        {
+            if (entry.value != 0)
+            {
+                statistics.Add(entry);
+            }
         }
 
+        SetBestRepresentation(std::move(entries), statistics);
+    }
+
+    template <typename DefaultDataVectorType>
+    template <typename SourceType>
+    void AutoDataVectorBase<DefaultDataVectorType>::SetBestRepresentation(SourceType source, const EntryStatistics& statistics)
+    {
         // dense
-        if (numNonZeros > SPARSE_THRESHOLD * defaultDataVector.PrefixLength())
+        if (statistics.numNonZeros > SPARSE_THRESHOLD * statistics.prefixLength)
         {
-            if (includesNonFloats)
+            if (statistics.includesNonFloats)
             {
-                SetInternal<DoubleDataVector>(std::move(defaultDataVector));
+                SetInternal<DoubleDataVector>(std::move(source));
             }
-            else if (includesNonShorts)
+            else if (statistics.includesNonShorts)
             {
-                SetInternal<FloatDataVector>(std::move(defaultDataVector));
+                SetInternal<FloatDataVector>(std::move(source));
             }
-            else if (includesNonBytes)
+            else if (statistics.includesNonBytes)
             {
-                SetInternal<ShortDataVector>(std::move(defaultDataVector));
+                SetInternal<ShortDataVector>(std::move(source));
             }
             else
             {
-                SetInternal<ByteDataVector>(std::move(defaultDataVector));
+                SetInternal<ByteDataVector>(std::move(source));
             }
         }
 
         // sparse
         else
         {
-            if (includesNonFloats)
+            if (statistics.includesNonFloats)
             {
-                SetInternal<SparseDoubleDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseDoubleDataVector>(std::move(source));
             }
-            else if (includesNonShorts)
+            else if (statistics.includesNonShorts)
             {
-                SetInternal<SparseFloatDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseFloatDataVector>(std::move(source));
             }
-            else if (includesNonBytes)
+            else if (statistics.includesNonBytes)
             {
-                SetInternal<SparseShortDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseShortDataVector>(std::move(source));
             }
-            else if (includesNonBinary)
+            else if (statistics.includesNonBinary)
             {
-                SetInternal<SparseByteDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseByteDataVector>(std::move(source));
             }
             else
             {
-                SetInternal<SparseBinaryDataVector>(std::move(defaultDataVector));
+                SetInternal<SparseBinaryDataVector>(std::move(source));
             }
         }
     }
@@ -200,6 +223,13 @@ namespace data
         _pInternal = std::make_unique<DataVectorType>(GetIterator<DefaultDataVectorType, IterationPolicy::skipZeros>(defaultDataVector));
     }
 
+    template <typename DefaultDataVectorType>
+    template <typename DataVectorType>
+    void AutoDataVectorBase<DefaultDataVectorType>::SetInternal(std::vector<IndexValue> entries)
+    {
+        _pInternal = std::make_unique<DataVectorType>(std::move(entries));
+    }
+
     template <typename IndexValueParsingIterator>
     AutoDataVector AutoDataVectorParser<IndexValueParsingIterator>::Parse(TextLine& textLine)
     {
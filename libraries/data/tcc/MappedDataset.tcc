@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MappedDataset.tcc (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+namespace ell
+{
+namespace data
+{
+    template <typename ExampleIteratorType>
+    size_t WriteBinaryDataset(ExampleIteratorType& exampleIterator, std::ostream& stream)
+    {
+        BinaryDatasetWriter writer(stream);
+        size_t numExamples = 0;
+        while (exampleIterator.IsValid())
+        {
+            writer.AddExample(exampleIterator.Get());
+            exampleIterator.Next();
+            ++numExamples;
+        }
+        writer.Finish();
+        return numExamples;
+    }
+
+    template <typename IteratorExampleType>
+    MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::MappedDatasetExampleIterator(const MappedDataset& dataset, size_t fromIndex, size_t size, size_t blockSize, std::vector<size_t> blockOrder, bool shuffleBlocks, std::default_random_engine::result_type seed)
+        : _dataset(dataset), _fromIndex(fromIndex), _size(size), _blockSize(blockSize), _numBlocks((size + blockSize - 1) / blockSize), _blockOrder(std::move(blockOrder)), _shuffleBlocks(shuffleBlocks), _random(seed)
+    {
+        if (IsValid())
+        {
+            EnterBlock();
+        }
+    }
+
+    template <typename IteratorExampleType>
+    void MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::Next()
+    {
+        ++_positionInBlock;
+        if (_blockBegin + _positionInBlock == std::min(_blockBegin + _blockSize, _fromIndex + _size))
+        {
+            ++_blockPosition;
+            if (IsValid())
+            {
+                EnterBlock();
+            }
+        }
+    }
+
+    template <typename IteratorExampleType>
+    IteratorExampleType MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::Get() const
+    {
+        auto index = _blockBegin + (_shuffleBlocks ? _orderInBlock[_positionInBlock] : _positionInBlock);
+        return _dataset.GetExample(index).template CopyAs<IteratorExampleType>();
+    }
+
+    template <typename IteratorExampleType>
+    void MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::EnterBlock()
+    {
+        _blockBegin = _fromIndex + GetBlock(_blockPosition) * _blockSize;
+        _positionInBlock = 0;
+        auto blockSize = std::min(_blockSize, _fromIndex + _size - _blockBegin);
+        if (_shuffleBlocks)
+        {
+            _orderInBlock.resize(blockSize);
+            std::iota(_orderInBlock.begin(), _orderInBlock.end(), 0);
+            std::shuffle(_orderInBlock.begin(), _orderInBlock.end(), _random);
+        }
+
+        // have the OS read the next block while this one is being processed
+        if (_blockPosition + 1 < _numBlocks)
+        {
+            auto nextBlockBegin = _fromIndex + GetBlock(_blockPosition + 1) * _blockSize;
+            _dataset.Prefetch(nextBlockBegin, std::min(_blockSize, _fromIndex + _size - nextBlockBegin));
+        }
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> MappedDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        Prefetch(fromIndex, std::min(size, defaultBlockSize));
+        return ExampleIterator<IteratorExampleType>(std::make_unique<MappedDatasetExampleIterator<IteratorExampleType>>(*this, fromIndex, size, defaultBlockSize, std::vector<size_t>{}, false, 0));
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> MappedDataset::GetShuffledExampleIterator(std::default_random_engine& rng, size_t fromIndex, size_t size, size_t blockSize) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        if (blockSize == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Block size must be positive");
+        }
+
+        std::vector<size_t> blockOrder((size + blockSize - 1) / blockSize);
+        std::iota(blockOrder.begin(), blockOrder.end(), 0);
+        std::shuffle(blockOrder.begin(), blockOrder.end(), rng);
+        if (!blockOrder.empty())
+        {
+            auto firstBlockBegin = fromIndex + blockOrder[0] * blockSize;
+            Prefetch(firstBlockBegin, std::min(blockSize, fromIndex + size - firstBlockBegin));
+        }
+        return ExampleIterator<IteratorExampleType>(std::make_unique<MappedDatasetExampleIterator<IteratorExampleType>>(*this, fromIndex, size, blockSize, std::move(blockOrder), true, rng()));
+    }
+}
+}
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PrefetchingExampleIterator.tcc (data)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TextLine.h"
+
+// stl
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ell
+{
+namespace data
+{
+    namespace detail
+    {
+        // adapts a text line iterator to the IsValid/Next/Get interface, and skips the lines without content
+        template <typename TextLineIteratorType>
+        class ContentLineIterator
+        {
+        public:
+            ContentLineIterator(TextLineIteratorType textLineIterator)
+                : _textLineIterator(std::move(textLineIterator))
+            {
+                SkipLinesWithoutContent();
+            }
+
+            bool IsValid() const { return _textLineIterator.IsValid(); }
+
+            void Next()
+            {
+                _textLineIterator.Next();
+                SkipLinesWithoutContent();
+            }
+
+            TextLine Get() const { return _currentLine; }
+
+        private:
+            void SkipLinesWithoutContent()
+            {
+                while (_textLineIterator.IsValid())
+                {
+                    _currentLine = _textLineIterator.GetTextLine();
+                    _currentLine.TrimLeadingWhitespace();
+                    if (!_currentLine.IsEndOfContent())
+                    {
+                        return;
+                    }
+                    _textLineIterator.Next();
+                }
+            }
+
+            TextLineIteratorType _textLineIterator;
+            TextLine _currentLine;
+        };
+    }
+
+    template <typename ExampleType>
+    constexpr size_t PrefetchingExampleIterator<ExampleType>::defaultQueueDepth;
+
+    template <typename ExampleType>
+    PrefetchingExampleIterator<ExampleType>::PrefetchingExampleIterator(ExampleIterator<ExampleType> exampleIterator, size_t queueDepth)
+        : _iterator(std::move(exampleIterator), [](ExampleType example) { return example; }, queueDepth)
+    {
+    }
+
+    template <typename ExampleType>
+    template <typename TextLineIteratorType, typename MetadataParserType, typename DataVectorParserType>
+    PrefetchingExampleIterator<ExampleType>::PrefetchingExampleIterator(TextLineIteratorType textLineIterator, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t queueDepth, size_t numParserThreads)
+        : _iterator(detail::ContentLineIterator<TextLineIteratorType>(std::move(textLineIterator)),
+                    [metadataParser, dataVectorParser](TextLine line) mutable {
+                        auto metadata = metadataParser.Parse(line);
+                        auto dataVector = dataVectorParser.Parse(line);
+                        return ExampleType(std::move(dataVector), std::move(metadata));
+                    },
+                    queueDepth,
+                    numParserThreads)
+    {
+        static_assert(std::is_same<ExampleType, ParserExample<DataVectorParserType, MetadataParserType>>::value, "ExampleType must be the type of example the parsers produce");
+    }
+
+    template <typename ExampleType>
+    ExampleIterator<ExampleType> MakePrefetchingExampleIterator(ExampleIterator<ExampleType> exampleIterator, size_t queueDepth)
+    {
+        return ExampleIterator<ExampleType>(std::make_unique<PrefetchingExampleIterator<ExampleType>>(std::move(exampleIterator), queueDepth));
+    }
+
+    template <typename TextLineIteratorType, typename MetadataParserType, typename DataVectorParserType>
+    auto MakePrefetchingParsingExampleIterator(TextLineIteratorType textLineIterator, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t queueDepth, size_t numParserThreads)
+    {
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+        auto iterator = std::make_unique<PrefetchingExampleIterator<ExampleType>>(std::move(textLineIterator), std::move(metadataParser), std::move(dataVectorParser), queueDepth, numParserThreads);
+        return ExampleIterator<ExampleType>(std::move(iterator));
+    }
+}
+}
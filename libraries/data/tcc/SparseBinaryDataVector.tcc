@@ -122,11 +122,16 @@ namespace data
     {
         double value = 0.0;
 
-        auto iter = _indexList.GetIterator();
-        while (iter.IsValid())
+        // decode the indices a block at a time, rather than one by one through an iterator
+        size_t indices[IndexListType::blockSize];
+        auto numBlocks = _indexList.NumBlocks();
+        for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
         {
-            value += vector[iter.Get()];
-            iter.Next();
+            auto count = _indexList.DecodeBlock(blockIndex, indices);
+            for (size_t i = 0; i < count; ++i)
+            {
+                value += vector[indices[i]];
+            }
         }
 
         return value;
@@ -135,19 +140,23 @@ namespace data
     template <typename IndexListType>
     void SparseBinaryDataVectorBase<IndexListType>::AddTo(math::RowVectorReference<double> vector) const
     {
-        auto iter = _indexList.GetIterator();
         auto size = vector.Size();
 
-        while (iter.IsValid())
+        size_t indices[IndexListType::blockSize];
+        auto numBlocks = _indexList.NumBlocks();
+        for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
         {
-            auto index = iter.Get();
-            if (index >= size)
+            auto count = _indexList.DecodeBlock(blockIndex, indices);
+            for (size_t i = 0; i < count; ++i)
             {
-                return;
-            }
+                auto index = indices[i];
+                if (index >= size)
+                {
+                    return;
+                }
 
-            vector[index] += 1.0;
-            iter.Next();
+                vector[index] += 1.0;
+            }
         }
     }
 }
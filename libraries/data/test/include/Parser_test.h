@@ -12,4 +12,5 @@ namespace ell
     void DataVectorParseTest();
     void AutoDataVectorParseTest();
     void SingleFileParseTest();
+    void PrefetchingParseTest();
 }
\ No newline at end of file
@@ -207,6 +207,16 @@ void AutoDataVectorTest()
 
     data::AutoDataVector v9{ 0, 0, 0, 0, 0, 1, 0, 0, 0 };
     testing::ProcessTest("AutoDataVector ctor", v9.GetInternalType() == data::IDataVector::Type::SparseBinaryDataVector);
+
+    // index-value ctor chooses the same representation as the dense ctor, and ignores explicit zeros
+    data::AutoDataVector v10(std::vector<data::IndexValue>{ { 5, 1.2345678901 } });
+    testing::ProcessTest("AutoDataVector index-value ctor", v10.GetInternalType() == data::IDataVector::Type::SparseDoubleDataVector && v10.ToArray() == v5.ToArray());
+
+    data::AutoDataVector v11(std::vector<data::IndexValue>{ { 1, 20 }, { 2, 0 }, { 3, 40 } });
+    testing::ProcessTest("AutoDataVector index-value ctor", v11.GetInternalType() == data::IDataVector::Type::ByteDataVector && v11.PrefixLength() == 4);
+
+    data::AutoDataVector v12(std::vector<data::IndexValue>{ { 2, 1 }, { 9, 0 }, { 30, 1 } });
+    testing::ProcessTest("AutoDataVector index-value ctor", v12.GetInternalType() == data::IDataVector::Type::SparseBinaryDataVector && v12.PrefixLength() == 31);
 }
 
 void TransformedDataVectorTest()
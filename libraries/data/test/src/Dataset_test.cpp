@@ -8,12 +8,19 @@
 
 #include "Dataset_test.h"
 #include "Dataset.h"
+#include "MappedDataset.h"
 
 // testing
 #include "testing.h"
 
 // stl
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace ell
 {
@@ -66,4 +73,88 @@ void DatasetCastingTests()
     DatasetCastingTestDispatch<data::AutoSupervisedExample>();
     DatasetCastingTestDispatch<data::DenseSupervisedExample>();
 }
-}
\ No newline at end of file
+
+std::string ExampleToString(const data::AutoSupervisedExample& example)
+{
+    std::stringstream ss;
+    example.Print(ss);
+    return ss.str();
+}
+
+void MappedDatasetTest()
+{
+    // sparse examples, whose label is their index in the dataset
+    std::default_random_engine rng(1234);
+    std::uniform_real_distribution<double> valueDistribution(-1, 1);
+    data::AutoSupervisedDataset dataset;
+    for (size_t exampleIndex = 0; exampleIndex < 50; ++exampleIndex)
+    {
+        std::vector<data::IndexValue> entries;
+        for (size_t index = exampleIndex % 3; index < 100 + exampleIndex; index += 1 + (exampleIndex + index) % 11)
+        {
+            entries.push_back({ index, index % 4 == 0 ? 1.0 : valueDistribution(rng) });
+        }
+        dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::move(entries)), data::WeightLabel{ 1.0 + exampleIndex % 2, static_cast<double>(exampleIndex) }));
+    }
+
+    const std::string filename = "MappedDataset_test.bin";
+    {
+        std::ofstream stream(filename, std::ios::binary);
+        auto exampleIterator = dataset.GetExampleIterator();
+        data::WriteBinaryDataset(exampleIterator, stream);
+    }
+
+    {
+        data::MappedDataset mappedDataset(filename);
+        testing::ProcessTest("MappedDataset::NumExamples", testing::IsEqual(mappedDataset.NumExamples(), dataset.NumExamples()));
+        testing::ProcessTest("MappedDataset::NumFeatures", testing::IsEqual(mappedDataset.NumFeatures(), dataset.NumFeatures()));
+
+        bool isSame = true;
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            isSame = isSame && ExampleToString(mappedDataset.GetExample(index)) == ExampleToString(dataset.GetExample(index));
+        }
+        testing::ProcessTest("MappedDataset::GetExample", isSame);
+
+        std::stringstream ss1, ss2;
+        dataset.Print(ss1, 0, 10, 20);
+        data::AutoSupervisedDataset copiedDataset(mappedDataset.GetAnyDataset(10, 20));
+        copiedDataset.Print(ss2);
+        testing::ProcessTest("MappedDataset::GetAnyDataset", ss1.str() == ss2.str());
+
+        // a shuffled iteration over a range visits each of its examples once, and the examples of a block together
+        const size_t fromIndex = 5, size = 40, blockSize = 7;
+        std::vector<size_t> visitCounts(dataset.NumExamples());
+        bool isBlockwise = true;
+        size_t block = 0, remainingInBlock = 0;
+        for (auto exampleIterator = mappedDataset.GetShuffledExampleIterator(rng, fromIndex, size, blockSize); exampleIterator.IsValid(); exampleIterator.Next())
+        {
+            auto index = static_cast<size_t>(exampleIterator.Get().GetMetadata().label);
+            if (remainingInBlock == 0)
+            {
+                block = (index - fromIndex) / blockSize;
+                remainingInBlock = std::min(blockSize, fromIndex + size - (fromIndex + block * blockSize));
+            }
+            isBlockwise = isBlockwise && (index - fromIndex) / blockSize == block;
+            --remainingInBlock;
+            ++visitCounts[index];
+        }
+        bool isPermutation = true;
+        for (size_t index = 0; index < visitCounts.size(); ++index)
+        {
+            isPermutation = isPermutation && visitCounts[index] == (index >= fromIndex && index < fromIndex + size ? 1u : 0u);
+        }
+        testing::ProcessTest("MappedDataset::GetShuffledExampleIterator", isPermutation && isBlockwise);
+    }
+
+    {
+        testing::ProcessTest("IsBinaryDatasetFile", data::IsBinaryDatasetFile(filename));
+
+        std::stringstream ss1, ss2;
+        dataset.Print(ss1);
+        data::LoadBinaryDataset(filename).Print(ss2);
+        testing::ProcessTest("LoadBinaryDataset", ss1.str() == ss2.str());
+    }
+    std::remove(filename.c_str());
+}
+}
@@ -10,6 +10,7 @@
 
 // data
 #include "GeneralizedSparseParsingIterator.h"
+#include "PrefetchingExampleIterator.h"
 #include "TextLine.h"
 #include "SequentialLineIterator.h"
 #include "SingleLineParsingExampleIterator.h"
@@ -147,4 +148,53 @@ namespace ell
         testing::ProcessTest("SingleFileParse test2", dataset[1].GetMetadata().label == -1 && testing::IsEqual(dataset[1].GetDataVector().ToArray(), { 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 3 }));
         testing::ProcessTest("SingleFileParse test3", dataset[2].GetMetadata().label == 1 && testing::IsEqual(dataset[2].GetDataVector().ToArray(), { 2.7, 0, 0, 0, -0.3, 0, 0, 0, 0, 0, 3.14 }));
     }
+
+    void PrefetchingParseTest()
+    {
+        // enough lines to fill the queues, some of them without content
+        std::stringstream text;
+        for (size_t lineIndex = 0; lineIndex < 500; ++lineIndex)
+        {
+            text << (lineIndex % 2 == 0 ? 1 : -1) << "\t" << lineIndex % 13 << ":" << lineIndex << "\n";
+            if (lineIndex % 7 == 0)
+            {
+                text << "// comment\n\n";
+            }
+        }
+        auto string = text.str();
+
+        auto parse = [&string](size_t queueDepth, size_t numParserThreads) {
+            std::stringstream stream(string);
+            data::SequentialLineIterator textLineIterator(stream);
+            auto exampleIterator = data::MakePrefetchingParsingExampleIterator(std::move(textLineIterator), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), queueDepth, numParserThreads);
+            return data::MakeDataset(std::move(exampleIterator));
+        };
+
+        std::stringstream stream(string);
+        data::SequentialLineIterator textLineIterator(stream);
+        auto exampleIterator = data::MakeSingleLineParsingExampleIterator(std::move(textLineIterator), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>());
+        auto dataset = data::MakeDataset(std::move(exampleIterator));
+        std::stringstream expected;
+        dataset.Print(expected);
+
+        for (size_t numParserThreads : { 0, 1, 3 })
+        {
+            for (size_t queueDepth : { 1, 16 })
+            {
+                std::stringstream actual;
+                parse(queueDepth, numParserThreads).Print(actual);
+                testing::ProcessTest("PrefetchingParse with " + std::to_string(numParserThreads) + " parser threads and queue depth " + std::to_string(queueDepth), actual.str() == expected.str());
+            }
+        }
+
+        data::PrefetchingExampleIterator<data::AutoSupervisedExample> prefetchingIterator(dataset.GetExampleIterator(), 4);
+        std::stringstream actual;
+        data::MakeDataset(data::MakePrefetchingExampleIterator(dataset.GetExampleIterator(), 4)).Print(actual);
+        size_t numExamples = 0;
+        for (; prefetchingIterator.IsValid(); prefetchingIterator.Next())
+        {
+            ++numExamples;
+        }
+        testing::ProcessTest("PrefetchingExampleIterator", actual.str() == expected.str() && numExamples == dataset.NumExamples() && prefetchingIterator.GetStallStatistics().numItems == numExamples);
+    }
 }
\ No newline at end of file
@@ -27,9 +27,11 @@ int main()
     IteratorTests();
     ExampleCopyAsTests();
     DatasetCastingTests();
+    MappedDatasetTest();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
+    PrefetchingParseTest();
 
     if (testing::DidTestFail())
     {
@@ -22,6 +22,15 @@ namespace emitters
         atlas
     };
     
+    /// <summary> The implementation to use for transcendental functions (exp, log, tanh and sigmoid) in emitted code. </summary>
+    enum class MathFunctionAccuracy
+    {
+        /// <summary> Use the LLVM intrinsics and the C runtime library. </summary>
+        precise = 0,
+        /// <summary> Use inlined polynomial approximations, accurate to within a few units in the last place. </summary>
+        fast
+    };
+
     /// <summary> Standard compiler switches. </summary>
     struct CompilerOptions
     {
@@ -37,7 +46,9 @@ namespace emitters
         bool parallelize = false;
         bool useThreadPool = true;
         int maxThreads = 4;
+        int compileThreads = 1;
         bool debug = false;
+        MathFunctionAccuracy mathFunctionAccuracy = MathFunctionAccuracy::precise;
 
         TargetDevice targetDevice;
     };
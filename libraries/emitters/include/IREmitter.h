@@ -199,6 +199,10 @@ namespace emitters
         /// <returns> Pointer to an llvm::Value that represents the string literal. </returns>
         llvm::Value* Literal(const std::string& value);
 
+        /// <summary> Forget the string literals emitted so far, so they're emitted again when they're next used. Needed
+        /// when the global values of the module they were emitted into are replaced. </summary>
+        void ClearStringLiterals() { _stringLiterals.Clear(); }
+
         /// <summary> Emit a named string literal. </summary>
         ///
         /// <param name="name"> The literal name. </param>
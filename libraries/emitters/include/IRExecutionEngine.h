@@ -11,6 +11,12 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/CodeGen.h>
+
+// stl
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -37,7 +43,8 @@ namespace emitters
         ///
         /// <param name="pModule"> The module. </param>
         /// <param name="verify"> Indicates if the execution engine should run a verification pass before running the code. </param>
-        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false);
+        /// <param name="optimizationLevel"> The code generator optimization level to use when jitting. </param>
+        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false, llvm::CodeGenOpt::Level optimizationLevel = llvm::CodeGenOpt::Default);
 
         /// <summary> Destructor </summary>
         ~IRExecutionEngine();
@@ -69,6 +76,24 @@ namespace emitters
         /// <param name="address"> The address of the function being defined. </param>
         void DefineFunction(llvm::Function* func, uint64_t address);
 
+        /// <summary> Set the address of a function, given its mangled name. </summary>
+        ///
+        /// <param name="mangledName"> The mangled name of the function being defined. </param>
+        /// <param name="address"> The address of the function being defined. </param>
+        void DefineFunction(const std::string& mangledName, uint64_t address);
+
+        /// <summary> Get the functions that have been defined with `DefineFunction`, so they can be defined in another execution engine. </summary>
+        ///
+        /// <returns> The mangled name and address of each defined function. </returns>
+        const std::vector<std::pair<std::string, uint64_t>>& GetDefinedFunctions() const { return _definedFunctions; }
+
+        /// <summary> Return the address of a named global variable, JITTing code as needed. Returns 0 if not found. </summary>
+        ///
+        /// <param name="name"> Name of the requested global variable. </param>
+        ///
+        /// <returns> The address of the global variable. </returns>
+        uint64_t GetGlobalValueAddress(const std::string& name);
+
         /// <summary>
         /// Return a main function that takes no arguments - if one exists. Returns nullptr if not found.
         /// </summary>
@@ -92,6 +117,7 @@ namespace emitters
 
         std::unique_ptr<llvm::EngineBuilder> _pBuilder;
         std::unique_ptr<llvm::ExecutionEngine> _pEngine;
+        std::vector<std::pair<std::string, uint64_t>> _definedFunctions;
     };
 }
 }
@@ -134,6 +134,14 @@ namespace emitters
 
     template <typename ValueType>
     IRLocalScalar Tanh(IRLocalScalar a);
+
+    namespace impl
+    {
+        // The inlinable approximations used when the module's `mathFunctionAccuracy` option is `fast` (see IRMathFunctions.h)
+        bool UseFastMathFunctions(IRLocalScalar a);
+        IRLocalScalar FastSigmoid(IRLocalScalar a);
+        IRLocalScalar FastTanh(IRLocalScalar a);
+    }
 }
 }
 
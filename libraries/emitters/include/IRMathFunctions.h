@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMathFunctions.h (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// llvm
+#include <llvm/IR/Value.h>
+
+namespace ell
+{
+namespace emitters
+{
+    class IRFunctionEmitter;
+
+    //
+    // Polynomial approximations of transcendental functions, emitted as straight-line IR (no branches or calls to the C
+    // runtime library), so that they can be inlined and vectorized along with the code that uses them. Each function
+    // accepts a `float` or `double` value, or a vector of `float` or `double` values, and returns a value of the same type.
+    //
+    // The maximum errors below are relative to the exact result, measured over random arguments spanning the whole
+    // domain of the function.
+    //
+
+    /// <summary>
+    /// Emits a fast approximation of exp(x). The argument is reduced to x = n*ln(2) + r, |r| <= ln(2)/2, and e^r is
+    /// approximated with a degree-7 polynomial (`float`) or a (6,6) Pade approximant (`double`). The maximum relative
+    /// error is 1e-7 (`float`) and 3e-16 (`double`). Results that would be denormal are flushed to zero, results that
+    /// would overflow are infinity, and NaN returns NaN.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The argument. </param>
+    ///
+    /// <returns> The approximation of exp(x). </returns>
+    llvm::Value* EmitFastExp(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary>
+    /// Emits a fast approximation of log(x). The argument is split into x = 2^k * m, sqrt(2)/2 <= m < sqrt(2), and
+    /// log(m) is approximated with a polynomial in s = (m-1)/(m+1). The maximum relative error is 2e-7 (`float`) and
+    /// 2e-16 (`double`). Negative arguments and NaN return NaN, 0 returns -infinity and infinity returns infinity.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The argument. </param>
+    ///
+    /// <returns> The approximation of log(x). </returns>
+    llvm::Value* EmitFastLog(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary>
+    /// Emits a fast approximation of tanh(x). Small arguments (|x| < 0.625) use a polynomial (`float`) or rational
+    /// (`double`) approximation, and larger ones use 1 - 2/(exp(2|x|) + 1) with the fast exp. The maximum relative
+    /// error is 2e-7 (`float`) and 3e-16 (`double`).
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The argument. </param>
+    ///
+    /// <returns> The approximation of tanh(x). </returns>
+    llvm::Value* EmitFastTanh(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary>
+    /// Emits a fast approximation of the sigmoid function 1/(1 + exp(-x)), computed from a single fast exp of -|x|. The
+    /// maximum relative error is 2e-7 (`float`) and 4e-16 (`double`).
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The argument. </param>
+    ///
+    /// <returns> The approximation of sigmoid(x). </returns>
+    llvm::Value* EmitFastSigmoid(IRFunctionEmitter& function, llvm::Value* x);
+
+    /// <summary>
+    /// Emits the sigmoid function the same way `emitters::Sigmoid` does in precise mode: 1/(1 + exp(-x)) for positive
+    /// arguments and exp(x)/(1 + exp(x)) otherwise, using the exp intrinsic.
+    /// </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="x"> The argument. </param>
+    ///
+    /// <returns> sigmoid(x). </returns>
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x);
+}
+}
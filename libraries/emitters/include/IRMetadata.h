@@ -58,6 +58,12 @@ namespace emitters
     /// </remarks>
     static const std::string c_stepTimeFunctionTagName = "ell.fn.stepTime";
 
+    /// <summary> Indicates a global variable that holds runtime bookkeeping, such as thread pool or profiler data, rather than model state. </summary>
+    /// <remarks>
+    /// Set a global-level tag with an empty value.
+    /// </remarks>
+    static const std::string c_runtimeGlobalTagName = "ell.global.runtime";
+
     /// <summary> Gets tag to Indicate the names of a struct's fields. </summary>
     /// <remarks>
     /// Returns a module-level tag, with the type name encoded in the name and field names as the value.
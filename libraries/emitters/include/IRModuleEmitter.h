@@ -529,6 +529,18 @@ namespace emitters
         /// <param name="optimizer"> The optimizer. </param>
         void Optimize(IROptimizer& optimizer);
 
+        /// <summary>
+        /// Optimize this module with the standard passes, using the number of threads given by the `compileThreads` compiler option.
+        /// The module is split into that many partitions, which are optimized concurrently and then linked back together.
+        /// </summary>
+        ///
+        /// <remarks>
+        /// Functions in different partitions can't be inlined into each other, so this trades some code quality for compile time.
+        /// The functions and global variables of the module are replaced by their optimized versions, so pointers to them obtained
+        /// before the call are invalid afterwards, except for the ones the module emitter holds on to, which are updated.
+        /// </remarks>
+        void OptimizeInParallel();
+
         /// <summary>
         /// Get the target machine and arch for this module. The target machine aids the system in optimizations and
         /// Jitting etc.
@@ -617,6 +629,11 @@ namespace emitters
         /// <param name="nodeName"> The node name. </param>
         void IncludeInCallbackInterface(const std::string& functionName, const std::string& nodeName);
 
+        /// <summary> Tags a global variable as runtime bookkeeping (for instance, thread pool or profiler data) rather than model state. </summary>
+        ///
+        /// <param name="global"> The global variable. </param>
+        void IncludeInRuntimeGlobals(llvm::GlobalVariable* global);
+
         //
         // Module initialization / finalization
         //
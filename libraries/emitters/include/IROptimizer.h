@@ -10,6 +10,7 @@
 // llvm
 #include <llvm/IR/Function.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Target/TargetMachine.h>
 
 namespace ell
 {
@@ -25,7 +26,14 @@ namespace emitters
         ///
         /// <param name="module"> The module. </param>
         IROptimizer(IRModuleEmitter& module);
-        
+
+        /// <summary> Function optimizer for functions in a bare LLVM module. </summary>
+        ///
+        /// <param name="module"> The module. </param>
+        /// <param name="targetMachine"> The target machine to optimize for, or `nullptr` to skip target-specific passes. </param>
+        IROptimizer(llvm::Module& module, llvm::TargetMachine* targetMachine);
+
+
         /// <summary> Add common optimizations to the optimizer pipeline. </summary>
         void AddStandardPasses();
 
@@ -38,7 +46,7 @@ namespace emitters
         void OptimizeModule(llvm::Module* pModule);
 
     private:
-        IRModuleEmitter& _module;
+        llvm::TargetMachine* _targetMachine;
         llvm::legacy::PassManager _modulePasses;
         llvm::legacy::FunctionPassManager _functionPasses;
     };
@@ -17,6 +17,7 @@
 #include <llvm/IR/Value.h>
 
 // stl
+#include <functional>
 #include <string>
 #include <unordered_set>
 
@@ -148,6 +149,10 @@ namespace emitters
         void EmitGetRegionProfilingInfoFunction();
         void EmitResetRegionProfilingInfoFunction();
         
+        // Updates the cached functions and globals after the module's global values have been replaced
+        friend IRModuleEmitter;
+        void RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap);
+
         // Lower-level codegen
         // CreateRegion returns the index of the new region
         IRLocalScalar CreateRegion(IRFunctionEmitter& function);
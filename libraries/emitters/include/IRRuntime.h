@@ -19,6 +19,9 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+// stl
+#include <functional>
+
 namespace ell
 {
 namespace emitters
@@ -81,12 +84,22 @@ namespace emitters
         template <typename ValueType>
         llvm::Function* GetTanhFunction();
 
+        /// <summary> Get the sigmoid function </summary>
+        ///
+        /// <returns> An LLVM function pointer to the function. </returns>
+        template <typename ValueType>
+        llvm::Function* GetSigmoidFunction();
+
+        // The exp, log, tanh and sigmoid functions return inlinable polynomial approximations when the module's
+        // `mathFunctionAccuracy` compiler option is `fast` (see IRMathFunctions.h)
+
         // emitter types
         llvm::Function* GetSqrtFunction(VariableType argType);
         llvm::Function* GetAbsFunction(VariableType argType);
         llvm::Function* GetExpFunction(VariableType argType);
         llvm::Function* GetLogFunction(VariableType argType);
         llvm::Function* GetTanhFunction(VariableType argType);
+        llvm::Function* GetSigmoidFunction(VariableType argType);
         llvm::Function* GetSinFunction(VariableType argType);
         llvm::Function* GetCosFunction(VariableType argType);
 
@@ -95,6 +108,8 @@ namespace emitters
         llvm::Function* GetAbsFunction(llvm::Type* argType);
         llvm::Function* GetExpFunction(llvm::Type* argType);
         llvm::Function* GetLogFunction(llvm::Type* argType);
+        llvm::Function* GetTanhFunction(llvm::Type* argType);
+        llvm::Function* GetSigmoidFunction(llvm::Type* argType);
         llvm::Function* GetSinFunction(llvm::Type* argType);
         llvm::Function* GetCosFunction(llvm::Type* argType);
 
@@ -149,6 +164,9 @@ namespace emitters
 
         llvm::Type* GetIntType(); // returns LLVM type for native `int`
 
+        // Updates the cached functions after the module's global values have been replaced
+        void RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap);
+
         std::string GetNamespacePrefix() const;
 
         //
@@ -162,6 +180,8 @@ namespace emitters
         // math
         llvm::Function* GetDotProductIntFunction();
         llvm::Function* GetDotProductFloatFunction();
+        bool UseFastMathFunctions(llvm::Type* argType) const;
+        llvm::Function* GetEmittedMathFunction(const std::string& name, llvm::Type* argType, llvm::Value* (*emitBody)(IRFunctionEmitter&, llvm::Value*));
 
         // Matrix math (BLAS or native)
         llvm::Function* GetSGEMVFunction(bool useBlas);
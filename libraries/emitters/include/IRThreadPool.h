@@ -17,6 +17,7 @@
 #include <llvm/IR/Value.h>
 
 // stl
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -106,6 +107,7 @@ namespace emitters
         friend class IRThreadPoolTaskQueue;
         IRThreadPoolTaskArray(IRThreadPoolTaskQueue& taskQueue);
         void Initialize(IRFunctionEmitter& function);
+        void RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap);
         void SetTasks(IRFunctionEmitter& function, llvm::Function* taskFunction, const std::vector<std::vector<llvm::Value*>>& taskArgs);
         llvm::StructType* GetTaskArrayDataType(IRModuleEmitter& module);
         llvm::Value* GetTaskFunctionPointer(IRFunctionEmitter& function);
@@ -165,6 +167,7 @@ namespace emitters
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
         void Initialize(IRFunctionEmitter& function); // initializes the task array
+        void RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap);
         llvm::Value* GetDataStruct() { return _queueData; }
         llvm::Value* DecrementCountField(IRFunctionEmitter& function, llvm::Value* fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module);
@@ -228,7 +231,9 @@ namespace emitters
         void ShutDown(IRFunctionEmitter& function);
 
     private:
+        friend class IRModuleEmitter;
         void Initialize(); // Allocates threads and adds global initializer and finalizer functions
+        void RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap); // Updates the cached globals after the module's global values have been replaced
         bool IsInitialized();
         void AddGlobalInitializer();
         void AddGlobalFinalizer();
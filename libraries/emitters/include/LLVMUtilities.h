@@ -10,9 +10,15 @@
 #include "EmitterTypes.h"
 
 // llvm
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+// stl
+#include <memory>
+#include <string>
+
 namespace ell
 {
 namespace emitters
@@ -74,6 +80,25 @@ namespace emitters
     /// <returns> The TypedComparison for comparing values of the given type. </returns>
     emitters::TypedComparison GetComparison(LLVMType type, BinaryPredicateType operation);
 
+    //
+    // Moving modules between contexts
+    //
+
+    /// <summary> Serialize a module to a string of bitcode. </summary>
+    ///
+    /// <param name="module"> The module to serialize. </param>
+    ///
+    /// <returns> The module's bitcode. </returns>
+    std::string WriteBitcodeToString(const llvm::Module& module);
+
+    /// <summary> Load a module from a string of bitcode into the given context. </summary>
+    ///
+    /// <param name="bitcode"> The bitcode to load, as returned by `WriteBitcodeToString`. </param>
+    /// <param name="context"> The context that will own the loaded module. </param>
+    ///
+    /// <returns> The loaded module. </returns>
+    std::unique_ptr<llvm::Module> ReadBitcodeFromString(const std::string& bitcode, llvm::LLVMContext& context);
+
     // TODO:
     // template <typename... ArgTypes>
     // std::vector<LLVMType> GetLLVMTypes(ArgTypes... args);
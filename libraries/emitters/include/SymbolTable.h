@@ -10,6 +10,7 @@
 #include "EmitterException.h"
 
 // stl
+#include <iterator>
 #include <unordered_map>
 
 namespace ell
@@ -66,6 +67,12 @@ namespace emitters
         /// <summary> Erase all of the entires from the symbol table. </summary>
         void Clear();
 
+        /// <summary> Replace the value of each symbol. Symbols whose new value is the default value are removed. </summary>
+        ///
+        /// <param name="getNewValue"> A function that takes the current value of a symbol and returns its new value. </param>
+        template <typename FunctionType>
+        void UpdateValues(FunctionType&& getNewValue);
+
     private:
         std::unordered_map<std::string, ValueType> _map;
     };
@@ -10,10 +10,13 @@
 #include "IRModuleEmitter.h"
 
 // llvm
+#include <llvm/IR/Mangler.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
 
 // stl
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace ell
@@ -31,21 +34,20 @@ namespace emitters
     {
     }
 
-    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify)
+    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify, llvm::CodeGenOpt::Level optimizationLevel)
     {
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmPrinter();
 
         _pBuilder = std::make_unique<llvm::EngineBuilder>(std::move(pModule));
-        _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(verify).setUseOrcMCJITReplacement(false);
+        _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(verify).setOptLevel(optimizationLevel).setUseOrcMCJITReplacement(false);
 
-        static bool installed = false;
-        if (!installed)
-        {
-            installed = true;
+        // Engines may be created on more than one thread (e.g., for tiered compilation)
+        static std::once_flag installed;
+        std::call_once(installed, []() {
             llvm::remove_fatal_error_handler();
             llvm::install_fatal_error_handler(&FatalErrorHandler, nullptr);
-        }
+        });
     }
 
     IRExecutionEngine::~IRExecutionEngine()
@@ -92,7 +94,23 @@ namespace emitters
     void IRExecutionEngine::DefineFunction(llvm::Function* func, uint64_t address)
     {
         EnsureEngine();
-        _pEngine->addGlobalMapping(func, (void*)address);
+        std::string mangledName;
+        llvm::raw_string_ostream mangledNameStream(mangledName);
+        llvm::Mangler::getNameWithPrefix(mangledNameStream, func->getName(), _pEngine->getDataLayout());
+        DefineFunction(mangledNameStream.str(), address);
+    }
+
+    void IRExecutionEngine::DefineFunction(const std::string& mangledName, uint64_t address)
+    {
+        EnsureEngine();
+        _pEngine->addGlobalMapping(mangledName, address);
+        _definedFunctions.emplace_back(mangledName, address);
+    }
+
+    uint64_t IRExecutionEngine::GetGlobalValueAddress(const std::string& name)
+    {
+        EnsureEngine();
+        return _pEngine->getGlobalValueAddress(name);
     }
 
     DynamicFunction IRExecutionEngine::GetMain()
@@ -362,5 +362,25 @@ namespace emitters
         return { a.function, a.function.Call(f, { a }) };
     }
 
+    namespace impl
+    {
+        bool UseFastMathFunctions(IRLocalScalar a)
+        {
+            auto elementType = a.value->getType()->getScalarType();
+            return a.function.GetModule().GetCompilerOptions().mathFunctionAccuracy == MathFunctionAccuracy::fast && (elementType->isFloatTy() || elementType->isDoubleTy());
+        }
+
+        IRLocalScalar FastSigmoid(IRLocalScalar a)
+        {
+            auto f = a.function.GetModule().GetRuntime().GetSigmoidFunction((a.value)->getType());
+            return { a.function, a.function.Call(f, { a }) };
+        }
+
+        IRLocalScalar FastTanh(IRLocalScalar a)
+        {
+            auto f = a.function.GetModule().GetRuntime().GetTanhFunction((a.value)->getType());
+            return { a.function, a.function.Call(f, { a }) };
+        }
+    }
 }
 }
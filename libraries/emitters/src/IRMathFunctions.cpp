@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRMathFunctions.cpp (emitters)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRMathFunctions.h"
+#include "EmitterException.h"
+#include "IRFunctionEmitter.h"
+#include "IRModuleEmitter.h"
+
+// llvm
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+
+// stl
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        // The coefficients are from Cephes (exp, tanh) and fdlibm (log).
+
+        // exp: e^r = 1 + r + r^2 * P(r), |r| <= ln(2)/2
+        const std::initializer_list<double> expFloatCoefficients = { 1.9875691500E-4, 1.3981999507E-3, 8.3334519073E-3, 4.1665795894E-2, 1.6666665459E-1, 5.0000001201E-1 };
+
+        // exp: e^r = 1 + 2r*P(r^2) / (Q(r^2) - r*P(r^2)), |r| <= ln(2)/2
+        const std::initializer_list<double> expDoubleP = { 1.26177193074810590878E-4, 3.02994407707441961300E-2, 9.99999999999999999910E-1 };
+        const std::initializer_list<double> expDoubleQ = { 3.00198505138664455042E-6, 2.52448340349684104192E-3, 2.27265548208155028766E-1, 2.00000000000000000009E0 };
+
+        // log: log(1+f) = 2s + s*R(s^2), s = f/(2+f)
+        const std::initializer_list<double> logFloatCoefficients = { 0.24279078841, 0.28498786688, 0.40000972152, 0.66666662693 };
+        const std::initializer_list<double> logDoubleCoefficients = { 1.479819860511658591e-01, 1.531383769920937332e-01, 1.818357216161805012e-01, 2.222219843214978396e-01, 2.857142874366239149e-01, 3.999999999940941908e-01, 6.666666666666735130e-01 };
+
+        // tanh: tanh(x) = x + x^3 * P(x^2) (float) or x + x^3 * P(x^2) / Q(x^2) (double), |x| < 0.625
+        const std::initializer_list<double> tanhFloatCoefficients = { -5.70498872745E-3, 2.06390887954E-2, -5.37397155531E-2, 1.33314422036E-1, -3.33332819422E-1 };
+        const std::initializer_list<double> tanhDoubleP = { -9.64399179425052238628E-1, -9.92877231001918586564E1, -1.61468768441708447952E3 };
+        const std::initializer_list<double> tanhDoubleQ = { 1.0, 1.12811678491632931402E2, 2.23548839060100448583E3, 4.84406305325125486048E3 };
+
+        const double log2e = 1.44269504088896341;
+        const double ln2Hi = 6.93147180369123816490e-01;
+        const double ln2Lo = 1.90821492927058770002e-10;
+        const double sqrt2 = 1.41421356237309504880;
+        const double tanhSmallLimit = 0.625;
+
+        // Emits scalar or vector code for one floating-point type. All the constants are splatted to the type of the
+        // argument, so the same code works for scalars and vectors.
+        class MathFunctionEmitter
+        {
+        public:
+            MathFunctionEmitter(IRFunctionEmitter& function, llvm::Type* type) :
+                _function(function),
+                _builder(function.GetEmitter().GetIRBuilder()),
+                _type(type)
+            {
+                auto elementType = type->getScalarType();
+                if (!elementType->isFloatTy() && !elementType->isDoubleTy())
+                {
+                    throw EmitterException(EmitterError::valueTypeNotSupported, "Math functions require float or double arguments");
+                }
+
+                _isDouble = elementType->isDoubleTy();
+                _numMantissaBits = _isDouble ? 52 : 23;
+                _exponentBias = _isDouble ? 1023 : 127;
+                _exponentMask = _isDouble ? 0x7ff : 0xff;
+
+                auto intElementType = llvm::Type::getIntNTy(function.GetLLVMContext(), _isDouble ? 64 : 32);
+                _intType = type->isVectorTy() ? llvm::VectorType::get(intElementType, type->getVectorNumElements()) : intElementType;
+            }
+
+            bool IsDouble() const { return _isDouble; }
+
+            llvm::IRBuilder<>& Builder() { return _builder; }
+
+            llvm::Value* Constant(double value) { return llvm::ConstantFP::get(_type, value); }
+            llvm::Value* IntConstant(int64_t value) { return llvm::ConstantInt::get(_intType, static_cast<uint64_t>(value), true); }
+            llvm::Value* Infinity(bool negative = false) { return llvm::ConstantFP::getInfinity(_type, negative); }
+            llvm::Value* NaN() { return llvm::ConstantFP::getNaN(_type); }
+
+            llvm::Value* Add(llvm::Value* a, llvm::Value* b) { return _builder.CreateFAdd(a, b); }
+            llvm::Value* Subtract(llvm::Value* a, llvm::Value* b) { return _builder.CreateFSub(a, b); }
+            llvm::Value* Multiply(llvm::Value* a, llvm::Value* b) { return _builder.CreateFMul(a, b); }
+            llvm::Value* Divide(llvm::Value* a, llvm::Value* b) { return _builder.CreateFDiv(a, b); }
+            llvm::Value* Negate(llvm::Value* a) { return _builder.CreateFNeg(a); }
+            llvm::Value* Select(llvm::Value* condition, llvm::Value* a, llvm::Value* b) { return _builder.CreateSelect(condition, a, b); }
+
+            llvm::Value* Abs(llvm::Value* a) { return CallIntrinsic(llvm::Intrinsic::fabs, a); }
+            llvm::Value* Floor(llvm::Value* a) { return CallIntrinsic(llvm::Intrinsic::floor, a); }
+            llvm::Value* Exp(llvm::Value* a) { return CallIntrinsic(llvm::Intrinsic::exp, a); }
+
+            // Evaluates the polynomial with the given coefficients (highest degree first) using Horner's rule
+            llvm::Value* Polynomial(llvm::Value* x, std::initializer_list<double> coefficients)
+            {
+                auto it = coefficients.begin();
+                llvm::Value* result = Constant(*it++);
+                for (; it != coefficients.end(); ++it)
+                {
+                    result = Add(Multiply(result, x), Constant(*it));
+                }
+                return result;
+            }
+
+            // Returns 2^n for an integer-valued floating-point n in the range of normal exponents
+            llvm::Value* Pow2(llvm::Value* n)
+            {
+                auto biased = _builder.CreateAdd(_builder.CreateFPToSI(n, _intType), IntConstant(_exponentBias));
+                return _builder.CreateBitCast(_builder.CreateShl(biased, IntConstant(_numMantissaBits)), _type);
+            }
+
+            // Splits x into its unbiased exponent (as an integer) and its mantissa, scaled to [1, 2). x must be positive
+            // and normal.
+            void Decompose(llvm::Value* x, llvm::Value*& exponent, llvm::Value*& mantissa)
+            {
+                auto bits = _builder.CreateBitCast(x, _intType);
+                auto biasedExponent = _builder.CreateAnd(_builder.CreateLShr(bits, IntConstant(_numMantissaBits)), IntConstant(_exponentMask));
+                exponent = _builder.CreateSub(biasedExponent, IntConstant(_exponentBias));
+
+                auto mantissaBits = _builder.CreateAnd(bits, IntConstant((int64_t(1) << _numMantissaBits) - 1));
+                auto oneExponent = IntConstant(int64_t(_exponentBias) << _numMantissaBits);
+                mantissa = _builder.CreateBitCast(_builder.CreateOr(mantissaBits, oneExponent), _type);
+            }
+
+            llvm::Value* ToFloat(llvm::Value* i) { return _builder.CreateSIToFP(i, _type); }
+
+        private:
+            llvm::Value* CallIntrinsic(llvm::Intrinsic::ID id, llvm::Value* a)
+            {
+                auto intrinsic = _function.GetModule().GetIntrinsic(id, { _type });
+                return _builder.CreateCall(intrinsic, { a });
+            }
+
+            IRFunctionEmitter& _function;
+            llvm::IRBuilder<>& _builder;
+            llvm::Type* _type;
+            llvm::Type* _intType;
+            bool _isDouble;
+            int _numMantissaBits;
+            int _exponentBias;
+            int _exponentMask;
+        };
+
+        llvm::Value* EmitExp(MathFunctionEmitter& m, llvm::Value* x)
+        {
+            auto& b = m.Builder();
+
+            // The range where exp(x) is a normal number. The upper bound is the largest argument whose exp is finite.
+            // NaN is replaced by 0 until the end, so that it doesn't reach the conversion to an integer.
+            const double minArgument = m.IsDouble() ? -708.39641853226408 : -87.3365478515625;
+            const double maxArgument = m.IsDouble() ? 709.782712893383973096 : 88.72283172607421875;
+            auto isNaN = b.CreateFCmpUNO(x, x);
+            auto tooSmall = b.CreateFCmpOLT(x, m.Constant(minArgument));
+            auto tooBig = b.CreateFCmpOGT(x, m.Constant(maxArgument));
+            auto clamped = m.Select(tooSmall, m.Constant(minArgument), m.Select(tooBig, m.Constant(maxArgument), x));
+            clamped = m.Select(isNaN, m.Constant(0.0), clamped);
+
+            // x = n*ln(2) + r. ln(2) is split into a high part with trailing zero bits and a low part (Cody-Waite), so
+            // that n*ln2Hi is exact.
+            const double expLn2Hi = m.IsDouble() ? 6.93145751953125E-1 : 0.693359375;
+            const double expLn2Lo = m.IsDouble() ? 1.42860682030941723212E-6 : -2.12194440E-4;
+            auto n = m.Floor(m.Add(m.Multiply(clamped, m.Constant(log2e)), m.Constant(0.5)));
+            auto r = m.Subtract(m.Subtract(clamped, m.Multiply(n, m.Constant(expLn2Hi))), m.Multiply(n, m.Constant(expLn2Lo)));
+
+            llvm::Value* expR = nullptr;
+            if (m.IsDouble())
+            {
+                auto rr = m.Multiply(r, r);
+                auto p = m.Multiply(r, m.Polynomial(rr, expDoubleP));
+                auto q = m.Polynomial(rr, expDoubleQ);
+                expR = m.Add(m.Constant(1.0), m.Multiply(m.Constant(2.0), m.Divide(p, m.Subtract(q, p))));
+            }
+            else
+            {
+                auto p = m.Polynomial(r, expFloatCoefficients);
+                expR = m.Add(m.Add(m.Multiply(p, m.Multiply(r, r)), r), m.Constant(1.0));
+            }
+
+            // n can be one past the largest exponent near the upper bound, so 2^n is applied in two halves
+            auto halfN = m.Floor(m.Multiply(n, m.Constant(0.5)));
+            auto result = m.Multiply(m.Multiply(expR, m.Pow2(halfN)), m.Pow2(m.Subtract(n, halfN)));
+            result = m.Select(tooBig, m.Infinity(), result);
+            result = m.Select(tooSmall, m.Constant(0.0), result);
+            return m.Select(isNaN, x, result);
+        }
+
+        llvm::Value* EmitLog(MathFunctionEmitter& m, llvm::Value* x)
+        {
+            auto& b = m.Builder();
+
+            // scale denormal arguments up into the normal range
+            const double smallestNormal = m.IsDouble() ? 2.2250738585072014e-308 : 1.17549435e-38;
+            const int denormalShift = m.IsDouble() ? 54 : 25;
+            auto isDenormal = b.CreateFCmpOLT(x, m.Constant(smallestNormal));
+            auto scaled = m.Select(isDenormal, m.Multiply(x, m.Constant(static_cast<double>(int64_t(1) << denormalShift))), x);
+
+            llvm::Value* exponent = nullptr;
+            llvm::Value* mantissa = nullptr;
+            m.Decompose(scaled, exponent, mantissa);
+
+            // x = 2^k * (1+f), sqrt(2)/2 <= 1+f < sqrt(2)
+            auto isBig = b.CreateFCmpOGT(mantissa, m.Constant(sqrt2));
+            mantissa = m.Select(isBig, m.Multiply(mantissa, m.Constant(0.5)), mantissa);
+            auto k = m.ToFloat(exponent);
+            k = m.Add(k, m.Select(isBig, m.Constant(1.0), m.Constant(0.0)));
+            k = m.Subtract(k, m.Select(isDenormal, m.Constant(denormalShift), m.Constant(0.0)));
+
+            auto f = m.Subtract(mantissa, m.Constant(1.0));
+            auto s = m.Divide(f, m.Add(m.Constant(2.0), f));
+            auto z = m.Multiply(s, s);
+            auto R = m.Multiply(z, m.Polynomial(z, m.IsDouble() ? logDoubleCoefficients : logFloatCoefficients));
+            auto halfFSquared = m.Multiply(m.Constant(0.5), m.Multiply(f, f));
+
+            // log(x) = k*ln(2) + f - (hfsq - s*(hfsq+R)), with the terms ordered to keep the rounding error small
+            auto correction = m.Add(m.Multiply(s, m.Add(halfFSquared, R)), m.Multiply(k, m.Constant(ln2Lo)));
+            auto result = m.Subtract(m.Multiply(k, m.Constant(ln2Hi)), m.Subtract(m.Subtract(halfFSquared, correction), f));
+
+            result = m.Select(b.CreateFCmpOEQ(x, m.Infinity()), m.Infinity(), result);
+            result = m.Select(b.CreateFCmpOEQ(x, m.Constant(0.0)), m.Infinity(true), result);
+            return m.Select(b.CreateFCmpULT(x, m.Constant(0.0)), m.NaN(), result); // negative or NaN
+        }
+
+        llvm::Value* EmitTanh(MathFunctionEmitter& m, llvm::Value* x)
+        {
+            auto& b = m.Builder();
+
+            // small arguments: odd polynomial or rational approximation
+            auto z = m.Multiply(x, x);
+            llvm::Value* small = nullptr;
+            if (m.IsDouble())
+            {
+                auto ratio = m.Divide(m.Polynomial(z, tanhDoubleP), m.Polynomial(z, tanhDoubleQ));
+                small = m.Add(x, m.Multiply(m.Multiply(x, z), ratio));
+            }
+            else
+            {
+                small = m.Add(x, m.Multiply(m.Multiply(x, z), m.Polynomial(z, tanhFloatCoefficients)));
+            }
+
+            // large arguments: tanh(|x|) = 1 - 2/(exp(2|x|) + 1), which saturates to 1 when exp overflows
+            auto absX = m.Abs(x);
+            auto e = EmitExp(m, m.Add(absX, absX));
+            auto large = m.Subtract(m.Constant(1.0), m.Divide(m.Constant(2.0), m.Add(e, m.Constant(1.0))));
+            large = m.Select(b.CreateFCmpOLT(x, m.Constant(0.0)), m.Negate(large), large);
+
+            return m.Select(b.CreateFCmpOLT(absX, m.Constant(tanhSmallLimit)), small, large);
+        }
+
+        // sigmoid(x) = 1/(1+e^-x) for x >= 0, and e^x/(1+e^x) for x < 0, both computed from e = exp(-|x|)
+        llvm::Value* EmitSigmoid(MathFunctionEmitter& m, llvm::Value* x, std::function<llvm::Value*(llvm::Value*)> exp)
+        {
+            auto e = exp(m.Negate(m.Abs(x)));
+            auto s = m.Divide(m.Constant(1.0), m.Add(m.Constant(1.0), e));
+            return m.Select(m.Builder().CreateFCmpOGE(x, m.Constant(0.0)), s, m.Multiply(e, s));
+        }
+    }
+
+    llvm::Value* EmitFastExp(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        MathFunctionEmitter m(function, x->getType());
+        return EmitExp(m, x);
+    }
+
+    llvm::Value* EmitFastLog(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        MathFunctionEmitter m(function, x->getType());
+        return EmitLog(m, x);
+    }
+
+    llvm::Value* EmitFastTanh(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        MathFunctionEmitter m(function, x->getType());
+        return EmitTanh(m, x);
+    }
+
+    llvm::Value* EmitFastSigmoid(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        MathFunctionEmitter m(function, x->getType());
+        return EmitSigmoid(m, x, [&m](llvm::Value* a) { return EmitExp(m, a); });
+    }
+
+    llvm::Value* EmitSigmoid(IRFunctionEmitter& function, llvm::Value* x)
+    {
+        MathFunctionEmitter m(function, x->getType());
+        auto expInput = m.Exp(x);
+        auto one = m.Constant(1.0);
+        auto positive = m.Divide(one, m.Add(m.Exp(m.Negate(x)), one));
+        auto negative = m.Divide(expInput, m.Add(expInput, one));
+        return m.Select(m.Builder().CreateFCmpOGT(x, m.Constant(0.0)), positive, negative);
+    }
+}
+}
@@ -13,7 +13,9 @@
 #include "IRHeaderWriter.h"
 #include "IRLoader.h"
 #include "IRMetadata.h"
+#include "IROptimizer.h"
 #include "IRSwigInterfaceWriter.h"
+#include "LLVMUtilities.h"
 
 // utilities
 #include "Files.h"
@@ -25,6 +27,7 @@
 #include <llvm/Bitcode/ReaderWriter.h>
 #include <llvm/IR/TypeBuilder.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/TargetRegistry.h>
@@ -32,7 +35,15 @@
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/raw_os_ostream.h>
 #include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+
+// stl
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ell
 {
@@ -67,6 +78,31 @@ namespace emitters
         std::string c_armDataLayout = "e-m:e-p:32:32-i64:64-v128:64:128-a:0:32-n32-S64";
         std::string c_arm64DataLayout = "e-m:e-i64:64-i128:128-n32:64-S128"; // DragonBoard
         std::string c_iosDataLayout = "e-m:o-i64:64-i128:128-n32:64-S128";
+
+        // SplitModule copies module-level metadata into every partition, and leaves behind declarations of the
+        // special appending globals (like llvm.global_ctors) in the partitions that don't define them. Neither
+        // can be linked back together, so remove them.
+        void RemovePartitionDuplicates(llvm::Module& partition)
+        {
+            std::vector<llvm::NamedMDNode*> metadata;
+            for (auto& node : partition.named_metadata())
+            {
+                metadata.push_back(&node);
+            }
+            for (auto node : metadata)
+            {
+                partition.eraseNamedMetadata(node);
+            }
+
+            for (auto name : { "llvm.global_ctors", "llvm.global_dtors", "llvm.used", "llvm.compiler.used" })
+            {
+                auto global = partition.getNamedGlobal(name);
+                if (global != nullptr && global->isDeclaration() && global->use_empty())
+                {
+                    global->eraseFromParent();
+                }
+            }
+        }
     }
 
     //
@@ -246,6 +282,7 @@ namespace emitters
         // store context variable so the callbacks can find it later.
         auto context = function.GetFunctionArgument("context");        
         auto globalContext = GlobalPointer(GetModuleName() + "_context", emitters::VariableType::Byte);
+        IncludeInRuntimeGlobals(globalContext);
         function.Store(globalContext, context);
     }
 
@@ -943,6 +980,119 @@ namespace emitters
         }
     }
 
+    void IRModuleEmitter::OptimizeInParallel()
+    {
+        auto compilerOptions = GetCompilerOptions();
+        if (!compilerOptions.optimize)
+        {
+            return;
+        }
+
+        auto numPartitions = compilerOptions.compileThreads;
+        if (numPartitions < 2)
+        {
+            IROptimizer optimizer(*this);
+            optimizer.AddStandardPasses();
+            Optimize(optimizer);
+            return;
+        }
+
+        // LLVM objects can only be used concurrently if they belong to different contexts, so the
+        // partitions travel to and from the worker threads as bitcode
+        std::vector<std::string> partitions;
+        auto addPartition = [&partitions](std::unique_ptr<llvm::Module> partition) {
+            RemovePartitionDuplicates(*partition);
+            partitions.push_back(WriteBitcodeToString(*partition));
+        };
+        const bool preserveLocals = true;
+        llvm::SplitModule(std::unique_ptr<llvm::Module>(llvm::CloneModule(GetLLVMModule())), numPartitions, addPartition, preserveLocals);
+
+        // Each partition gets its own target machine, so the optimizer can use the target's cost model
+        std::vector<std::unique_ptr<llvm::TargetMachine>> targetMachines;
+        for (size_t index = 0; index < partitions.size(); ++index)
+        {
+            targetMachines.emplace_back(GetTargetMachine());
+        }
+
+        std::vector<std::future<std::string>> optimizedPartitions;
+        for (size_t index = 0; index < partitions.size(); ++index)
+        {
+            const auto& partition = partitions[index];
+            auto targetMachine = targetMachines[index].get();
+            optimizedPartitions.push_back(std::async(std::launch::async, [&partition, targetMachine]() {
+                llvm::LLVMContext context;
+                auto module = ReadBitcodeFromString(partition, context);
+                IROptimizer optimizer(*module, targetMachine);
+                optimizer.AddStandardPasses();
+                for (auto& function : *module)
+                {
+                    optimizer.OptimizeFunction(&function);
+                }
+                optimizer.OptimizeModule(module.get());
+                return WriteBitcodeToString(*module);
+            }));
+        }
+
+        // The optimized partitions are linked back into this module, so that its struct types, named metadata and
+        // declarations stay where they are. The linker collects the module's struct types when it's constructed,
+        // so it has to be constructed before the definitions that use them are removed.
+        auto module = GetLLVMModule();
+        std::unordered_map<const llvm::Value*, std::string> names;
+        for (const auto& global : module->global_values())
+        {
+            names[&global] = global.getName();
+        }
+        llvm::Linker linker(*module);
+
+        std::vector<llvm::GlobalValue*> definitions;
+        for (auto& function : module->functions())
+        {
+            if (!function.isDeclaration())
+            {
+                function.deleteBody();
+                definitions.push_back(&function);
+            }
+        }
+        for (auto& global : module->globals())
+        {
+            if (!global.isDeclaration())
+            {
+                global.setInitializer(nullptr);
+                definitions.push_back(&global);
+            }
+        }
+        for (auto definition : definitions)
+        {
+            definition->removeDeadConstantUsers();
+            definition->eraseFromParent();
+        }
+
+        for (auto& optimizedPartition : optimizedPartitions)
+        {
+            if (linker.linkInModule(ReadBitcodeFromString(optimizedPartition.get(), GetLLVMContext())))
+            {
+                throw EmitterException(EmitterError::unexpected, "Failed to link optimized module partitions");
+            }
+        }
+
+        // The linker replaces the declarations it finds definitions for, so look up everything the emitters
+        // hold on to by name
+        auto remap = [module, &names](llvm::Value* value) -> llvm::Value* {
+            auto it = names.find(value);
+            if (it == names.end() || it->second.empty())
+            {
+                return value;
+            }
+            return module->getNamedValue(it->second);
+        };
+        _literals.UpdateValues(remap);
+        _globals.UpdateValues(remap);
+        _emitter.ClearStringLiterals();
+        _runtime.RemapGlobalValues(remap);
+        _threadPool.RemapGlobalValues(remap);
+        _profiler.RemapGlobalValues(remap);
+    }
+
     //
     // Helpers, standard C Runtime functions, and debug support
     //
@@ -1058,6 +1208,12 @@ namespace emitters
         InsertFunctionMetadata(function, c_callbackFunctionTagName, { nodeName });
     }
 
+    void IRModuleEmitter::IncludeInRuntimeGlobals(llvm::GlobalVariable* global)
+    {
+        assert(global);
+        global->setMetadata(c_runtimeGlobalTagName, llvm::MDNode::get(_emitter.GetContext(), {}));
+    }
+
     //
     // Module initialization / finalization
     //
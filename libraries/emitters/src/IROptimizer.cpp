@@ -11,6 +11,7 @@
 #include "LLVMInclude.h"
 
 // llvm
+#include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
@@ -27,7 +28,12 @@ namespace emitters
     using namespace llvm;
 
     IROptimizer::IROptimizer(IRModuleEmitter& module)
-        : _module(module), _functionPasses(module.GetLLVMModule())
+        : IROptimizer(*module.GetLLVMModule(), module.GetTargetMachine())
+    {
+    }
+
+    IROptimizer::IROptimizer(llvm::Module& module, llvm::TargetMachine* targetMachine)
+        : _targetMachine(targetMachine), _functionPasses(&module)
     {
     }
 
@@ -35,22 +41,25 @@ namespace emitters
     {
         _functionPasses.add(llvm::createVerifierPass());
 
-        auto targetMachine = _module.GetTargetMachine();
+        auto targetMachine = _targetMachine;
         llvm::PassManagerBuilder builder;
         builder.OptLevel = 3;
         builder.SizeLevel = 0;
         builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel);
         builder.LoopVectorize = true;
         builder.SLPVectorize = true;
-        builder.populateFunctionPassManager(_functionPasses);
-        builder.populateModulePassManager(_modulePasses);
 
+        // The target's cost model drives the vectorizers and the unroller, so it has to be added before the passes that use it
         if (targetMachine)
         {
-            builder.addExtension(llvm::PassManagerBuilder::EP_EarlyAsPossible, [&](const llvm::PassManagerBuilder&, llvm::legacy::PassManagerBase& passManager) {
+            _functionPasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+            _modulePasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+            builder.addExtension(llvm::PassManagerBuilder::EP_EarlyAsPossible, [targetMachine](const llvm::PassManagerBuilder&, llvm::legacy::PassManagerBase& passManager) {
                 targetMachine->addEarlyAsPossiblePasses(passManager);
             });
         }
+        builder.populateFunctionPassManager(_functionPasses);
+        builder.populateModulePassManager(_modulePasses);
     }
 
     void IROptimizer::OptimizeFunction(llvm::Function* pFunction)
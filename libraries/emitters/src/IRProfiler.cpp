@@ -213,6 +213,13 @@ namespace emitters
         return function.LocalScalar<int>(index);
     }
 
+    void IRProfiler::RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap)
+    {
+        _getNumRegionsFunction = llvm::cast_or_null<llvm::Function>(remap(_getNumRegionsFunction));
+        _getRegionBufferFunction = llvm::cast_or_null<llvm::Function>(remap(_getRegionBufferFunction));
+        _profileRegionsArray = llvm::cast_or_null<llvm::GlobalVariable>(remap(_profileRegionsArray));
+    }
+
     void IRProfiler::CreateStructTypes()
     {
         assert(_profilingEnabled);
@@ -245,6 +252,7 @@ namespace emitters
     {
         assert(_profileRegionsArray == nullptr);
         _profileRegionsArray = _module->GlobalArray(GetNamespacePrefix() + "_profileprofileRegionsArray_" + std::to_string(_regionCount), _profileRegionType, _regionCount);
+        _module->IncludeInRuntimeGlobals(_profileRegionsArray);
     }
 
     void IRProfiler::ReallocateRegionData()
@@ -260,6 +268,7 @@ namespace emitters
                 _profileRegionsArray->removeFromParent();
             }
             _profileRegionsArray = profileRegionsArray;
+            _module->IncludeInRuntimeGlobals(_profileRegionsArray);
 
             // Each time profileRegionsArray is updated, rewrite the GetRegionBuffer function to return the new profileRegionsArray`
             FixUpGetRegionBufferFunction();
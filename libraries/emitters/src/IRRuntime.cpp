@@ -8,6 +8,7 @@
 
 #include "IRRuntime.h"
 #include "IRFunctionEmitter.h"
+#include "IRMathFunctions.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
 
@@ -183,6 +184,13 @@ namespace emitters
     {
     }
 
+    void IRRuntime::RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap)
+    {
+        _pDotProductFunctionFloat = llvm::cast_or_null<llvm::Function>(remap(_pDotProductFunctionFloat));
+        _pDotProductFunction = llvm::cast_or_null<llvm::Function>(remap(_pDotProductFunction));
+        _pGetCurrentTimeFunction = llvm::cast_or_null<llvm::Function>(remap(_pGetCurrentTimeFunction));
+    }
+
     llvm::Type* IRRuntime::GetIntType()
     {
         auto& context = _module.GetLLVMContext();
@@ -245,6 +253,40 @@ namespace emitters
         return function.GetFunction();
     }
 
+    bool IRRuntime::UseFastMathFunctions(llvm::Type* argType) const
+    {
+        auto elementType = argType->getScalarType();
+        return _module.GetCompilerOptions().mathFunctionAccuracy == MathFunctionAccuracy::fast && (elementType->isFloatTy() || elementType->isDoubleTy());
+    }
+
+    llvm::Function* IRRuntime::GetEmittedMathFunction(const std::string& name, llvm::Type* argType, llvm::Value* (*emitBody)(IRFunctionEmitter&, llvm::Value*))
+    {
+        auto elementType = argType->getScalarType();
+        auto functionName = GetNamespacePrefix() + "_" + name + (elementType->isDoubleTy() ? "Double" : "Float");
+        if (argType->isVectorTy())
+        {
+            functionName += std::to_string(argType->getVectorNumElements());
+        }
+
+        auto pFunction = _module.GetFunction(functionName);
+        if (pFunction != nullptr)
+        {
+            return pFunction;
+        }
+
+        // The functions are small and branch-free: inlining them lets the optimizer vectorize the loops that call them
+        auto function = _module.BeginFunction(functionName, argType, std::vector<llvm::Type*>{ argType });
+        auto x = &(*function.Arguments().begin());
+        function.Return(emitBody(function, x));
+        _module.EndFunction();
+
+        pFunction = function.GetFunction();
+        pFunction->addFnAttr(llvm::Attribute::AlwaysInline);
+        pFunction->addFnAttr(llvm::Attribute::ReadNone);
+        pFunction->addFnAttr(llvm::Attribute::NoUnwind);
+        return pFunction;
+    }
+
     llvm::Function* IRRuntime::ResolveCurrentTimeFunction(llvm::StructType* timespecType)
     {
         llvm::Function* function = nullptr;
@@ -422,12 +464,12 @@ namespace emitters
 
     llvm::Function* IRRuntime::GetExpFunction(VariableType argType)
     {
-        return _module.GetIntrinsic(llvm::Intrinsic::exp, { argType });
+        return GetExpFunction(_module.GetIREmitter().Type(argType));
     }
 
     llvm::Function* IRRuntime::GetLogFunction(VariableType argType)
     {
-        return _module.GetIntrinsic(llvm::Intrinsic::log, { argType });
+        return GetLogFunction(_module.GetIREmitter().Type(argType));
     }
 
     llvm::Function* IRRuntime::GetSinFunction(VariableType argType)
@@ -453,13 +495,23 @@ namespace emitters
         }
 
         auto& emitter = _module.GetIREmitter();
-        const char* funcName = argType == VariableType::Double ? "tanh" : "tanhf";
         auto valueType = emitter.Type(argType);
+        if (UseFastMathFunctions(valueType))
+        {
+            return GetEmittedMathFunction("FastTanh", valueType, &EmitFastTanh);
+        }
+
+        const char* funcName = argType == VariableType::Double ? "tanh" : "tanhf";
         auto tanhProto = llvm::FunctionType::get(valueType, { valueType }, false);
         _module.DeclareFunction(funcName, tanhProto);
         return _module.GetFunction(funcName);
     }
 
+    llvm::Function* IRRuntime::GetSigmoidFunction(VariableType argType)
+    {
+        return GetSigmoidFunction(_module.GetIREmitter().Type(argType));
+    }
+
     llvm::Function* IRRuntime::GetSqrtFunction(llvm::Type* argType)
     {
         return _module.GetIntrinsic(llvm::Intrinsic::sqrt, { argType });
@@ -472,14 +524,54 @@ namespace emitters
 
     llvm::Function* IRRuntime::GetExpFunction(llvm::Type* argType)
     {
+        if (UseFastMathFunctions(argType))
+        {
+            return GetEmittedMathFunction("FastExp", argType, &EmitFastExp);
+        }
         return _module.GetIntrinsic(llvm::Intrinsic::exp, { argType });
     }
 
     llvm::Function* IRRuntime::GetLogFunction(llvm::Type* argType)
     {
+        if (UseFastMathFunctions(argType))
+        {
+            return GetEmittedMathFunction("FastLog", argType, &EmitFastLog);
+        }
         return _module.GetIntrinsic(llvm::Intrinsic::log, { argType });
     }
 
+    llvm::Function* IRRuntime::GetTanhFunction(llvm::Type* argType)
+    {
+        if (UseFastMathFunctions(argType))
+        {
+            return GetEmittedMathFunction("FastTanh", argType, &EmitFastTanh);
+        }
+        if (argType->isFloatTy())
+        {
+            return GetTanhFunction(VariableType::Float);
+        }
+        if (argType->isDoubleTy())
+        {
+            return GetTanhFunction(VariableType::Double);
+        }
+        throw EmitterException(EmitterError::functionNotFound);
+    }
+
+    llvm::Function* IRRuntime::GetSigmoidFunction(llvm::Type* argType)
+    {
+        if (UseFastMathFunctions(argType))
+        {
+            return GetEmittedMathFunction("FastSigmoid", argType, &EmitFastSigmoid);
+        }
+
+        auto elementType = argType->getScalarType();
+        if (!elementType->isFloatTy() && !elementType->isDoubleTy())
+        {
+            throw EmitterException(EmitterError::functionNotFound);
+        }
+        return GetEmittedMathFunction("Sigmoid", argType, &EmitSigmoid);
+    }
+
     llvm::Function* IRRuntime::GetSinFunction(llvm::Type* argType)
     {
         return _module.GetIntrinsic(llvm::Intrinsic::sin, { argType });
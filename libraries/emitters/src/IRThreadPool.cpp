@@ -41,6 +41,7 @@ namespace emitters
 
         // Create global array to hold pthread objects
         _threads = _module.GlobalArray("taskThreads", pthreadType, _maxThreads);
+        _module.IncludeInRuntimeGlobals(_threads);
 
         AddGlobalInitializer();
         AddGlobalFinalizer();
@@ -54,6 +55,7 @@ namespace emitters
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
         auto isInitedVar = _module.Global(boolType, "isInitialized"); // initialized to false
+        _module.IncludeInRuntimeGlobals(isInitedVar);
 
         auto initThreadPoolFunction = _module.BeginFunction("initThreadPool", voidType);
         {
@@ -158,6 +160,12 @@ namespace emitters
         return _threads != nullptr;
     }
 
+    void IRThreadPool::RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap)
+    {
+        _threads = llvm::cast_or_null<llvm::GlobalVariable>(remap(_threads));
+        _taskQueue.RemapGlobalValues(remap);
+    }
+
     //
     // IRThreadPoolTaskQueue
     //
@@ -168,6 +176,12 @@ namespace emitters
         // Note: we can't initialize ourselves here, for ordering reasons.
     }
 
+    void IRThreadPoolTaskQueue::RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap)
+    {
+        _queueData = remap(_queueData);
+        _tasks.RemapGlobalValues(remap);
+    }
+
     void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function)
     {
         if (_queueData != nullptr)
@@ -182,7 +196,9 @@ namespace emitters
         auto taskQueueDataType = GetTaskQueueDataType(module);
 
         // Allocate a data struct
-        _queueData = module.Global(taskQueueDataType, "taskQueueData");
+        auto queueData = module.Global(taskQueueDataType, "taskQueueData");
+        module.IncludeInRuntimeGlobals(queueData);
+        _queueData = queueData;
 
         // Get pointers to the fields
         auto queueMutex = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::queueMutex));
@@ -458,6 +474,11 @@ namespace emitters
     {
     }
 
+    void IRThreadPoolTaskArray::RemapGlobalValues(const std::function<llvm::Value*(llvm::Value*)>& remap)
+    {
+        _taskArrayData = remap(_taskArrayData);
+    }
+
     void IRThreadPoolTaskArray::Initialize(IRFunctionEmitter& function)
     {
         assert(_taskArrayData == nullptr);
@@ -467,7 +488,9 @@ namespace emitters
         auto taskArrayDataType = GetTaskArrayDataType(module);
 
         // Allocate our data struct
-        _taskArrayData = module.Global(taskArrayDataType, "taskArrayData");
+        auto taskArrayData = module.Global(taskArrayDataType, "taskArrayData");
+        module.IncludeInRuntimeGlobals(taskArrayData);
+        _taskArrayData = taskArrayData;
     }
 
     llvm::StructType* IRThreadPoolTaskArray::GetTaskArrayDataType(IRModuleEmitter& module) // TODO: come up with a naming convention for "class" structs like this
@@ -8,9 +8,12 @@
 
 #include "LLVMUtilities.h"
 #include "EmitterException.h"
+#include "IREmitter.h"
 
 // llvm
+#include <llvm/Bitcode/ReaderWriter.h>
 #include <llvm/IR/Type.h>
+#include <llvm/Support/raw_ostream.h>
 
 namespace ell
 {
@@ -75,6 +78,28 @@ namespace emitters
         throw EmitterException(EmitterError::valueTypeNotSupported);
     }
 
+    //
+    // Moving modules between contexts
+    //
+    std::string WriteBitcodeToString(const llvm::Module& module)
+    {
+        std::string result;
+        llvm::raw_string_ostream stream(result);
+        llvm::WriteBitcodeToFile(&module, stream);
+        stream.flush();
+        return result;
+    }
+
+    std::unique_ptr<llvm::Module> ReadBitcodeFromString(const std::string& bitcode, llvm::LLVMContext& context)
+    {
+        auto module = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, "<bitcode>"), context);
+        if (!module)
+        {
+            throw LLVMException(module.getError());
+        }
+        return std::move(module.get());
+    }
+
     // TODO:
     // template <typename... ArgTypes>
     // std::vector<LLVMType> GetLLVMTypes(ArgTypes... args);
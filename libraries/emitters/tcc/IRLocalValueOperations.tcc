@@ -188,6 +188,11 @@ namespace emitters
     template <typename ValueType>
     IRLocalScalar Sigmoid(IRLocalScalar a)
     {
+        if (impl::UseFastMathFunctions(a))
+        {
+            return impl::FastSigmoid(a);
+        }
+
         auto& fn = a.function;
 
         auto expInput = Exp(a);
@@ -199,6 +204,11 @@ namespace emitters
     template <typename ValueType>
     IRLocalScalar Tanh(IRLocalScalar a)
     {
+        if (impl::UseFastMathFunctions(a))
+        {
+            return impl::FastTanh(a);
+        }
+
         // tanh(x) === (exp(x) - exp(-x)) / (exp(x) + exp(-x))
         //         = 2*sigmoid(2*x) - 1
         auto two = static_cast<ValueType>(2.0);
@@ -206,4 +216,3 @@ namespace emitters
     }
 }
 }
-
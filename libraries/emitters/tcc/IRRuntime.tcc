@@ -40,6 +40,12 @@ namespace emitters
         return GetTanhFunction(GetVariableType<ValueType>());
     }
 
+    template <typename ValueType>
+    llvm::Function* IRRuntime::GetSigmoidFunction()
+    {
+        return GetSigmoidFunction(GetVariableType<ValueType>());
+    }
+
     template <typename ValueType>
     llvm::Function* IRRuntime::GetSinFunction()
     {
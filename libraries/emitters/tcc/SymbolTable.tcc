@@ -76,5 +76,16 @@ namespace emitters
     {
         _map.clear();
     }
+
+    template <typename ValueType, ValueType DefaultValue>
+    template <typename FunctionType>
+    void SymbolTable<ValueType, DefaultValue>::UpdateValues(FunctionType&& getNewValue)
+    {
+        for (auto iter = _map.begin(); iter != _map.end();)
+        {
+            iter->second = getNewValue(iter->second);
+            iter = iter->second == DefaultValue ? _map.erase(iter) : std::next(iter);
+        }
+    }
 }
 }
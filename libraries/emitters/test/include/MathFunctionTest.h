@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathFunctionTest.h (emitters_test)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "CompilerOptions.h"
+#include "IRExecutionEngine.h"
+#include "IRModuleEmitter.h"
+
+// stl
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary> The math functions that have fast approximations in emitted code. </summary>
+enum class MathFunction
+{
+    exp,
+    log,
+    tanh,
+    sigmoid
+};
+
+/// <summary> Returns the name of a math function. </summary>
+std::string GetMathFunctionName(MathFunction mathFunction);
+
+/// <summary> Evaluates a math function with the C runtime library, in long double precision. </summary>
+long double EvaluateMathFunction(MathFunction mathFunction, long double x);
+
+/// <summary> Returns random arguments that cover the domain of a math function. </summary>
+template <typename ValueType>
+std::vector<ValueType> GetMathFunctionArguments(MathFunction mathFunction, size_t count);
+
+/// <summary> Returns the maximum relative error of the results of a math function, compared to the C runtime library. </summary>
+template <typename ValueType>
+double GetMaxRelativeError(MathFunction mathFunction, const std::vector<ValueType>& arguments, const std::vector<ValueType>& results);
+
+/// <summary> A jitted function that applies a math function to each element of an array. </summary>
+template <typename ValueType>
+class CompiledMathFunction
+{
+public:
+    /// <summary> Compiles the function with the given math function accuracy setting. </summary>
+    CompiledMathFunction(MathFunction mathFunction, ell::emitters::MathFunctionAccuracy accuracy);
+
+    /// <summary> Computes output[i] = f(input[i]) for i in [0, count). </summary>
+    void operator()(const ValueType* input, ValueType* output, int count) const { _function(input, output, count); }
+
+private:
+    using FunctionType = void (*)(const ValueType*, ValueType*, int);
+
+    std::unique_ptr<ell::emitters::IRModuleEmitter> _module; // owns the LLVM context, so it must outlive the execution engine
+    std::unique_ptr<ell::emitters::IRExecutionEngine> _executionEngine;
+    FunctionType _function = nullptr;
+};
+
+// Compare the precise and fast implementations of exp, log, tanh and sigmoid against the C runtime library
+void TestMathFunctionAccuracy();
+
+// Infinities, NaN, zero and denormals with the fast implementations
+void TestFastMathFunctionSpecialValues();
+
+// The fast exp near overflow and underflow, and for NaN and infinities, against the C runtime library
+void TestFastExpRange();
@@ -0,0 +1,19 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathFunctionTiming.h (emitters_test)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MathFunctionTest.h"
+
+// stl
+#include <cstddef>
+
+// Throughput and maximum relative error of a math function with the C runtime library and with the precise and fast
+// compiled implementations
+template <typename ValueType>
+void TimeMathFunction(MathFunction mathFunction, size_t count, size_t numIterations);
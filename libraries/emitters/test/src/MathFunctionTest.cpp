@@ -0,0 +1,327 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathFunctionTest.cpp (emitters_test)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MathFunctionTest.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRFunctionEmitter.h"
+#include "IRModuleEmitter.h"
+#include "IROptimizer.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+
+std::string GetMathFunctionName(MathFunction mathFunction)
+{
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        return "exp";
+    case MathFunction::log:
+        return "log";
+    case MathFunction::tanh:
+        return "tanh";
+    case MathFunction::sigmoid:
+        return "sigmoid";
+    }
+    return "";
+}
+
+long double EvaluateMathFunction(MathFunction mathFunction, long double x)
+{
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        return std::exp(x);
+    case MathFunction::log:
+        return std::log(x);
+    case MathFunction::tanh:
+        return std::tanh(x);
+    case MathFunction::sigmoid:
+        return 1 / (1 + std::exp(-x));
+    }
+    return 0;
+}
+
+template <typename ValueType>
+CompiledMathFunction<ValueType>::CompiledMathFunction(MathFunction mathFunction, MathFunctionAccuracy accuracy)
+{
+    CompilerOptions options;
+    options.mathFunctionAccuracy = accuracy;
+    _module = std::make_unique<IRModuleEmitter>("MathFunctionTest", options);
+    auto& module = *_module;
+
+    auto& runtime = module.GetRuntime();
+    llvm::Function* pMathFunction = nullptr;
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        pMathFunction = runtime.GetExpFunction<ValueType>();
+        break;
+    case MathFunction::log:
+        pMathFunction = runtime.GetLogFunction<ValueType>();
+        break;
+    case MathFunction::tanh:
+        pMathFunction = runtime.GetTanhFunction<ValueType>();
+        break;
+    case MathFunction::sigmoid:
+        pMathFunction = runtime.GetSigmoidFunction<ValueType>();
+        break;
+    }
+
+    const std::string functionName = "Apply_" + GetMathFunctionName(mathFunction);
+    auto pointerType = GetPointerType(GetVariableType<ValueType>());
+    NamedVariableTypeList args = { { "input", pointerType }, { "output", pointerType }, { "count", VariableType::Int32 } };
+    auto function = module.BeginFunction(functionName, VariableType::Void, args);
+    function.IncludeInHeader();
+    auto input = function.GetFunctionArgument("input");
+    auto output = function.GetFunctionArgument("output");
+    auto count = function.GetFunctionArgument("count");
+    function.For(count, [input, output, pMathFunction](IRFunctionEmitter& function, llvm::Value* i) {
+        function.SetValueAt(output, i, function.Call(pMathFunction, { function.ValueAt(input, i) }));
+    });
+    function.Return();
+    module.EndFunction();
+
+    IROptimizer optimizer(module);
+    module.Optimize(optimizer);
+
+    _executionEngine = std::make_unique<IRExecutionEngine>(std::move(module));
+    _function = reinterpret_cast<FunctionType>(_executionEngine->ResolveFunctionAddress(functionName));
+}
+
+template class CompiledMathFunction<float>;
+template class CompiledMathFunction<double>;
+
+template <typename ValueType>
+std::vector<ValueType> GetMathFunctionArguments(MathFunction mathFunction, size_t count)
+{
+    const bool isFloat = std::is_same<ValueType, float>::value;
+    double minValue = 0;
+    double maxValue = 0;
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        minValue = isFloat ? -87 : -708;
+        maxValue = isFloat ? 88 : 709;
+        break;
+    case MathFunction::log: // these are exponents
+        minValue = isFloat ? -87 : -708;
+        maxValue = isFloat ? 88 : 709;
+        break;
+    case MathFunction::tanh:
+        minValue = isFloat ? -10 : -20;
+        maxValue = -minValue;
+        break;
+    case MathFunction::sigmoid:
+        minValue = isFloat ? -80 : -700;
+        maxValue = -minValue;
+        break;
+    }
+
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<double> distribution(minValue, maxValue);
+    std::uniform_real_distribution<double> smallDistribution(-1, 1);
+    std::vector<ValueType> arguments(count);
+    for (size_t index = 0; index < count; ++index)
+    {
+        // half of the arguments are near zero (or near one, for log), where the relative error is the hardest to keep small
+        auto x = index % 2 == 0 ? distribution(engine) : smallDistribution(engine);
+        arguments[index] = static_cast<ValueType>(mathFunction == MathFunction::log ? std::exp(x) : x);
+    }
+    return arguments;
+}
+
+template <typename ValueType>
+double GetMaxRelativeError(MathFunction mathFunction, const std::vector<ValueType>& arguments, const std::vector<ValueType>& results)
+{
+    double maxError = 0;
+    for (size_t index = 0; index < arguments.size(); ++index)
+    {
+        auto expected = EvaluateMathFunction(mathFunction, arguments[index]);
+        if (expected != 0)
+        {
+            auto error = std::abs((static_cast<long double>(results[index]) - expected) / expected);
+            maxError = std::max(maxError, static_cast<double>(error));
+        }
+    }
+    return maxError;
+}
+
+template std::vector<float> GetMathFunctionArguments<float>(MathFunction, size_t);
+template std::vector<double> GetMathFunctionArguments<double>(MathFunction, size_t);
+template double GetMaxRelativeError(MathFunction, const std::vector<float>&, const std::vector<float>&);
+template double GetMaxRelativeError(MathFunction, const std::vector<double>&, const std::vector<double>&);
+
+namespace
+{
+// The documented maximum relative errors of the fast implementations (see IRMathFunctions.h), with some slack
+template <typename ValueType>
+double GetErrorTolerance(MathFunction mathFunction)
+{
+    const bool isFloat = std::is_same<ValueType, float>::value;
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        return 2 * (isFloat ? 1e-7 : 3e-16);
+    case MathFunction::log:
+        return 2 * (isFloat ? 2e-7 : 2e-16);
+    case MathFunction::tanh:
+        return 2 * (isFloat ? 2e-7 : 3e-16);
+    case MathFunction::sigmoid:
+        return 2 * (isFloat ? 2e-7 : 4e-16);
+    }
+    return 0;
+}
+
+template <typename ValueType>
+void TestMathFunctionAccuracy(MathFunction mathFunction, MathFunctionAccuracy accuracy)
+{
+    const size_t count = 100000;
+    auto arguments = GetMathFunctionArguments<ValueType>(mathFunction, count);
+    std::vector<ValueType> results(count);
+
+    CompiledMathFunction<ValueType> compiledFunction(mathFunction, accuracy);
+    compiledFunction(arguments.data(), results.data(), static_cast<int>(count));
+
+    auto maxError = GetMaxRelativeError(mathFunction, arguments, results);
+    auto accuracyName = accuracy == MathFunctionAccuracy::fast ? "fast" : "precise";
+    testing::ProcessTest("Testing " + std::string(accuracyName) + " " + GetMathFunctionName(mathFunction) + "<" + utilities::TypeName<ValueType>::GetName() + "> accuracy", maxError <= GetErrorTolerance<ValueType>(mathFunction));
+}
+
+template <typename ValueType>
+void TestFastMathFunctionSpecialValues()
+{
+    const auto infinity = std::numeric_limits<ValueType>::infinity();
+    const auto nan = std::numeric_limits<ValueType>::quiet_NaN();
+    const auto denormal = std::numeric_limits<ValueType>::denorm_min() * 3;
+    const auto fast = MathFunctionAccuracy::fast;
+
+    std::vector<ValueType> expArguments = { -infinity, -1000, 1000, infinity, 0 };
+    std::vector<ValueType> expResults(expArguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::exp, fast)(expArguments.data(), expResults.data(), static_cast<int>(expArguments.size()));
+
+    std::vector<ValueType> logArguments = { -1, 0, infinity, 1, nan, denormal };
+    std::vector<ValueType> logResults(logArguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::log, fast)(logArguments.data(), logResults.data(), static_cast<int>(logArguments.size()));
+
+    std::vector<ValueType> tanhArguments = { -infinity, 0, infinity };
+    std::vector<ValueType> tanhResults(tanhArguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::tanh, fast)(tanhArguments.data(), tanhResults.data(), static_cast<int>(tanhArguments.size()));
+
+    std::vector<ValueType> sigmoidArguments = { -infinity, 0, infinity };
+    std::vector<ValueType> sigmoidResults(sigmoidArguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::sigmoid, fast)(sigmoidArguments.data(), sigmoidResults.data(), static_cast<int>(sigmoidArguments.size()));
+
+    auto typeName = "<" + utilities::TypeName<ValueType>::GetName() + ">";
+    testing::ProcessTest("Testing fast exp" + typeName + " special values", expResults == std::vector<ValueType>{ 0, 0, infinity, infinity, 1 });
+    testing::ProcessTest("Testing fast log" + typeName + " special values",
+                         std::isnan(logResults[0]) && logResults[1] == -infinity && logResults[2] == infinity && logResults[3] == 0 && std::isnan(logResults[4]) &&
+                             std::abs(logResults[5] / std::log(static_cast<long double>(denormal)) - 1) <= GetErrorTolerance<ValueType>(MathFunction::log));
+    testing::ProcessTest("Testing fast tanh" + typeName + " special values", tanhResults == std::vector<ValueType>{ -1, 0, 1 });
+    testing::ProcessTest("Testing fast sigmoid" + typeName + " special values", sigmoidResults == std::vector<ValueType>{ 0, 0.5, 1 });
+}
+
+template <typename ValueType>
+void TestFastExpRange()
+{
+    const bool isFloat = std::is_same<ValueType, float>::value;
+    const auto infinity = std::numeric_limits<ValueType>::infinity();
+    const auto nan = std::numeric_limits<ValueType>::quiet_NaN();
+
+    // Arguments on both sides of the largest argument whose exp is finite, and of the smallest one whose exp is normal
+    const ValueType maxArgument = static_cast<ValueType>(std::log(static_cast<long double>(std::numeric_limits<ValueType>::max())));
+    const ValueType minArgument = static_cast<ValueType>(std::log(static_cast<long double>(std::numeric_limits<ValueType>::min())));
+    std::vector<ValueType> arguments;
+    for (auto bound : { maxArgument, minArgument })
+    {
+        auto x = bound;
+        for (int step = 0; step < 8; ++step)
+        {
+            x = std::nextafter(x, -infinity);
+        }
+        for (int step = 0; step < 16; ++step)
+        {
+            arguments.push_back(x);
+            x = std::nextafter(x, infinity);
+        }
+    }
+    for (auto x : { isFloat ? 88.3 : 709.0, isFloat ? 88.5 : 709.5, isFloat ? 88.7 : 709.7, isFloat ? -87.0 : -708.0 })
+    {
+        arguments.push_back(static_cast<ValueType>(x));
+    }
+
+    std::vector<ValueType> results(arguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::exp, MathFunctionAccuracy::fast)(arguments.data(), results.data(), static_cast<int>(arguments.size()));
+
+    bool ok = true;
+    for (size_t index = 0; index < arguments.size(); ++index)
+    {
+        auto expected = std::exp(static_cast<long double>(arguments[index]));
+        if (expected > std::numeric_limits<ValueType>::max())
+        {
+            ok &= results[index] == infinity;
+        }
+        else if (expected < std::numeric_limits<ValueType>::min())
+        {
+            // denormal results may be flushed to zero
+            ok &= results[index] >= 0 && results[index] < std::numeric_limits<ValueType>::min();
+        }
+        else
+        {
+            ok &= std::abs((results[index] - expected) / expected) <= GetErrorTolerance<ValueType>(MathFunction::exp);
+        }
+    }
+
+    std::vector<ValueType> specialArguments = { nan, -infinity, infinity };
+    std::vector<ValueType> specialResults(specialArguments.size());
+    CompiledMathFunction<ValueType>(MathFunction::exp, MathFunctionAccuracy::fast)(specialArguments.data(), specialResults.data(), static_cast<int>(specialArguments.size()));
+    ok &= std::isnan(specialResults[0]) && specialResults[1] == 0 && specialResults[2] == infinity;
+
+    testing::ProcessTest("Testing fast exp<" + utilities::TypeName<ValueType>::GetName() + "> near the ends of its range", ok);
+}
+}
+
+void TestMathFunctionAccuracy()
+{
+    for (auto mathFunction : { MathFunction::exp, MathFunction::log, MathFunction::tanh, MathFunction::sigmoid })
+    {
+        for (auto accuracy : { MathFunctionAccuracy::precise, MathFunctionAccuracy::fast })
+        {
+            TestMathFunctionAccuracy<float>(mathFunction, accuracy);
+            TestMathFunctionAccuracy<double>(mathFunction, accuracy);
+        }
+    }
+}
+
+void TestFastMathFunctionSpecialValues()
+{
+    TestFastMathFunctionSpecialValues<float>();
+    TestFastMathFunctionSpecialValues<double>();
+}
+
+void TestFastExpRange()
+{
+    TestFastExpRange<float>();
+    TestFastExpRange<double>();
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MathFunctionTiming.cpp (emitters_test)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MathFunctionTiming.h"
+
+// utilities
+#include "MillisecondTimer.h"
+#include "TypeName.h"
+
+// stl
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+template <typename ValueType>
+void ApplyRuntimeFunction(MathFunction mathFunction, const std::vector<ValueType>& arguments, std::vector<ValueType>& results)
+{
+    const auto count = arguments.size();
+    switch (mathFunction)
+    {
+    case MathFunction::exp:
+        for (size_t index = 0; index < count; ++index)
+        {
+            results[index] = std::exp(arguments[index]);
+        }
+        break;
+    case MathFunction::log:
+        for (size_t index = 0; index < count; ++index)
+        {
+            results[index] = std::log(arguments[index]);
+        }
+        break;
+    case MathFunction::tanh:
+        for (size_t index = 0; index < count; ++index)
+        {
+            results[index] = std::tanh(arguments[index]);
+        }
+        break;
+    case MathFunction::sigmoid:
+        for (size_t index = 0; index < count; ++index)
+        {
+            results[index] = 1 / (1 + std::exp(-arguments[index]));
+        }
+        break;
+    }
+}
+
+template <typename ValueType>
+void TimeCompiledFunction(const std::string& name, MathFunction mathFunction, emitters::MathFunctionAccuracy accuracy, const std::vector<ValueType>& arguments, size_t numIterations)
+{
+    CompiledMathFunction<ValueType> compiledFunction(mathFunction, accuracy);
+    std::vector<ValueType> results(arguments.size());
+
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        compiledFunction(arguments.data(), results.data(), static_cast<int>(arguments.size()));
+    }
+    auto duration = timer.Elapsed();
+
+    std::cout << "    " << name << ": " << duration << " ms, max relative error " << GetMaxRelativeError(mathFunction, arguments, results) << std::endl;
+}
+}
+
+template <typename ValueType>
+void TimeMathFunction(MathFunction mathFunction, size_t count, size_t numIterations)
+{
+    auto arguments = GetMathFunctionArguments<ValueType>(mathFunction, count);
+    std::vector<ValueType> results(count);
+
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        ApplyRuntimeFunction(mathFunction, arguments, results);
+    }
+    auto runtimeDuration = timer.Elapsed();
+
+    std::cout << "Time to compute " << GetMathFunctionName(mathFunction) << "<" << utilities::TypeName<ValueType>::GetName() << "> of " << count << " values, " << numIterations << " times:" << std::endl;
+    std::cout << "    C runtime library: " << runtimeDuration << " ms, max relative error " << GetMaxRelativeError(mathFunction, arguments, results) << std::endl;
+    TimeCompiledFunction("Compiled, precise", mathFunction, emitters::MathFunctionAccuracy::precise, arguments, numIterations);
+    TimeCompiledFunction("Compiled, fast", mathFunction, emitters::MathFunctionAccuracy::fast, arguments, numIterations);
+}
+
+template void TimeMathFunction<float>(MathFunction mathFunction, size_t count, size_t numIterations);
+template void TimeMathFunction<double>(MathFunction mathFunction, size_t count, size_t numIterations);
@@ -10,6 +10,7 @@
 #include "IREmitterTest.h"
 #include "IRFunctionTest.h"
 #include "IRProfilerTest.h"
+#include "MathFunctionTest.h"
 #include "PosixEmitterTest.h"
 #include "StdlibEmitterTest.h"
 
@@ -76,6 +77,13 @@ void TestStdlibEmitter()
     TestIRMallocFunction();
 }
 
+void TestMathFunctions()
+{
+    TestMathFunctionAccuracy();
+    TestFastMathFunctionSpecialValues();
+    TestFastExpRange();
+}
+
 int main()
 {
     TestIR();
@@ -83,6 +91,7 @@ int main()
     TestPosixEmitter();
     TestProfiler();
     TestStdlibEmitter();
+    TestMathFunctions();
 
     if (testing::DidTestFail())
     {
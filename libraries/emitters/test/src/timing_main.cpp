@@ -0,0 +1,26 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (emitters_test)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MathFunctionTiming.h"
+
+// testing
+#include "testing.h"
+
+using namespace ell;
+
+int main()
+{
+    for (auto mathFunction : { MathFunction::exp, MathFunction::log, MathFunction::tanh, MathFunction::sigmoid })
+    {
+        // void TimeMathFunction(MathFunction mathFunction, size_t count, size_t numIterations);
+        TimeMathFunction<float>(mathFunction, 1 << 16, 100);
+        TimeMathFunction<double>(mathFunction, 1 << 16, 100);
+    }
+
+    return testing::DidTestFail() ? 1 : 0;
+}
@@ -35,6 +35,11 @@ namespace evaluators
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
+        /// <summary> Adds the state of another aggregator to this one, as if this aggregator had seen its updates too. </summary>
+        ///
+        /// <param name="other"> The aggregator to merge into this one. </param>
+        void Merge(const AUCAggregator& other);
+
         /// <summary> Gets a header that describes the values of this aggregator. </summary>
         ///
         /// <returns> The header string vector. </returns>
@@ -12,6 +12,9 @@
 #include "Dataset.h"
 #include "Example.h"
 
+// utilities
+#include "ThreadPool.h"
+
 // stl
 #include <functional>
 #include <memory>
@@ -52,12 +55,17 @@ namespace evaluators
     {
         size_t evaluationFrequency;
         bool addZeroEvaluation;
+
+        /// <summary> The number of threads used to score the dataset. If more than 1, the dataset is split into shards that
+        /// are scored concurrently with private copies of the aggregators, which are then merged. 0 means one per hardware thread. </summary>
+        size_t numThreads = 1;
     };
 
     /// <summary> Implements an evaluator that holds a data set and a set of evaluation aggregators. </summary>
     ///
     /// <typeparam name="PredictorType"> The predictor type. </typeparam>
-    /// <typeparam name="AggregatorTypes"> The aggregator types. </typeparam>
+    /// <typeparam name="AggregatorTypes"> The aggregator types. For sharded evaluation, each aggregator must be copyable and
+    /// have a `Merge(const AggregatorType& other)` method that combines the state of another aggregator into it. </typeparam>
     template <typename PredictorType, typename... AggregatorTypes>
     class Evaluator : public IEvaluator<PredictorType>
     {
@@ -98,7 +106,10 @@ namespace evaluators
         void Print(std::ostream& os) const override;
 
     protected:
+        using AggregatorTupleType = std::tuple<AggregatorTypes...>;
+
         void EvaluateZero();
+        void EvaluateSharded(const PredictorType& predictor);
 
         template <size_t Index>
         using AggregatorType = typename std::tuple_element<Index, std::tuple<AggregatorTypes...>>::type;
@@ -134,15 +145,37 @@ namespace evaluators
             AggregatorT& _aggregator;
         };
 
+        template <typename AggregatorT>
+        class ElementMerger
+        {
+        public:
+            ElementMerger(AggregatorT& aggregator, const AggregatorT& other);
+
+            void operator()();
+
+        private:
+            AggregatorT& _aggregator;
+            const AggregatorT& _other;
+        };
+
         template <std::size_t Index>
-        auto GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+        auto GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
 
         template <std::size_t Index>
         auto GetElementResetFunction() -> ElementResetter<AggregatorType<Index>>;
 
+        template <std::size_t Index>
+        auto GetElementMergeFunction(AggregatorTupleType& aggregators, const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>;
+
         template <std::size_t... Sequence>
         void DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>);
 
+        template <std::size_t... Sequence>
+        void DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>);
+
+        template <std::size_t... Sequence>
+        void DispatchMerge(AggregatorTupleType& aggregators, const AggregatorTupleType& other, std::index_sequence<Sequence...>);
+
         template <std::size_t... Sequence>
         void Aggregate(std::index_sequence<Sequence...>);
 
@@ -156,8 +189,9 @@ namespace evaluators
         data::Dataset<ExampleType> _dataset;
         EvaluatorParameters _evaluatorParameters;
         size_t _evaluateCounter = 0;
-        typename std::tuple<AggregatorTypes...> _aggregatorTuple;
+        AggregatorTupleType _aggregatorTuple;
         std::vector<std::vector<std::vector<double>>> _values;
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
     };
 
     /// <summary> Makes an evaluator. </summary>
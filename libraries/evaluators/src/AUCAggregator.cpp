@@ -10,6 +10,7 @@
 
 // stl
 #include <algorithm>
+#include <iterator>
 
 namespace ell
 {
@@ -60,6 +61,18 @@ namespace evaluators
         _aggregates.resize(0);
     }
 
+    void AUCAggregator::Merge(const AUCAggregator& other)
+    {
+        // GetResult needs the aggregates sorted anyway, so sort both lists and merge them in linear time
+        std::sort(_aggregates.begin(), _aggregates.end());
+        std::sort(other._aggregates.begin(), other._aggregates.end());
+
+        std::vector<Aggregate> merged;
+        merged.reserve(_aggregates.size() + other._aggregates.size());
+        std::merge(_aggregates.begin(), _aggregates.end(), other._aggregates.begin(), other._aggregates.end(), std::back_inserter(merged));
+        _aggregates.swap(merged);
+    }
+
     bool AUCAggregator::Aggregate::operator<(const Aggregate& other) const
     {
         // order by prediction (ascending) and then by label (descending) - this will produce the most pessimistic AUC
@@ -59,6 +59,14 @@ namespace evaluators
         _sumFalseNegatives = 0.0;
     }
 
+    void BinaryErrorAggregator::Merge(const BinaryErrorAggregator& other)
+    {
+        _sumTruePositives += other._sumTruePositives;
+        _sumTrueNegatives += other._sumTrueNegatives;
+        _sumFalsePositives += other._sumFalsePositives;
+        _sumFalseNegatives += other._sumFalseNegatives;
+    }
+
     std::vector<std::string> BinaryErrorAggregator::GetValueNames() const
     {
         return { "ErrorRate", "Precision", "Recall", "F1-Score" };
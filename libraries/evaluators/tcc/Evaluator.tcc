@@ -11,6 +11,9 @@
 // utilities
 #include "FunctionUtils.h"
 
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace evaluators
@@ -21,6 +24,11 @@ namespace evaluators
     {
         static_assert(sizeof...(AggregatorTypes) > 0, "Evaluator must contains at least one aggregator");
 
+        if (_evaluatorParameters.numThreads != 1)
+        {
+            _threadPool = std::make_unique<utilities::ThreadPool>(_evaluatorParameters.numThreads);
+        }
+
         if (_evaluatorParameters.addZeroEvaluation)
         {
             EvaluateZero();
@@ -36,6 +44,12 @@ namespace evaluators
             return;
         }
 
+        if (_threadPool != nullptr)
+        {
+            EvaluateSharded(predictor);
+            return;
+        }
+
         auto iterator = _dataset.GetExampleReferenceIterator();
 
         while (iterator.IsValid())
@@ -52,6 +66,56 @@ namespace evaluators
         Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    void Evaluator<PredictorType, AggregatorTypes...>::EvaluateSharded(const PredictorType& predictor)
+    {
+        const auto numExamples = _dataset.NumExamples();
+        const auto numShards = std::min(_threadPool->NumThreads(), numExamples);
+
+        // Each shard starts from a copy of the (reset) aggregators and only touches its own copy
+        std::vector<AggregatorTupleType> shardAggregators(numShards, _aggregatorTuple);
+        _threadPool->ParallelFor(numShards, [&](size_t shardIndex) {
+            auto firstExample = numExamples * shardIndex / numShards;
+            auto endExample = numExamples * (shardIndex + 1) / numShards;
+            auto iterator = _dataset.GetExampleReferenceIterator(firstExample, endExample - firstExample);
+            auto& aggregators = shardAggregators[shardIndex];
+
+            while (iterator.IsValid())
+            {
+                const auto& example = iterator.Get();
+
+                double weight = example.GetMetadata().weight;
+                double label = example.GetMetadata().label;
+                double prediction = predictor.Predict(example.GetDataVector());
+
+                DispatchUpdate(aggregators, prediction, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+                iterator.Next();
+            }
+        });
+
+        // Merge pairs of shards in a fixed tree order, so the result doesn't depend on scheduling and
+        // expensive merges (like sorting AUC predictions) also run in parallel
+        for (size_t stride = 1; stride < numShards; stride *= 2)
+        {
+            auto numMerges = (numShards + 2 * stride - 1) / (2 * stride);
+            _threadPool->ParallelFor(numMerges, [&](size_t mergeIndex) {
+                auto target = 2 * stride * mergeIndex;
+                auto source = target + stride;
+                if (source < numShards)
+                {
+                    DispatchMerge(shardAggregators[target], shardAggregators[source], std::make_index_sequence<sizeof...(AggregatorTypes)>());
+                }
+            });
+        }
+
+        if (numShards > 0)
+        {
+            // shard 0 started as a copy of the reset aggregators and now holds everything
+            _aggregatorTuple = std::move(shardAggregators[0]);
+        }
+        Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     double Evaluator<PredictorType, AggregatorTypes...>::GetGoodness() const
     {
@@ -154,11 +218,25 @@ namespace evaluators
         _aggregator.Reset();
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::ElementMerger(AggregatorT& aggregator, const AggregatorT& other)
+        : _aggregator(aggregator), _other(other)
+    {
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    void Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::operator()()
+    {
+        _aggregator.Merge(_other);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t Index>
-    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
     {
-        return {std::get<Index>(_aggregatorTuple), params};
+        return {std::get<Index>(aggregators), params};
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -168,16 +246,38 @@ namespace evaluators
         return {std::get<Index>(_aggregatorTuple)};
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t Index>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementMergeFunction(AggregatorTupleType& aggregators, const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>
+    {
+        return {std::get<Index>(aggregators), std::get<Index>(other)};
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...> sequence)
+    {
+        DispatchUpdate(_aggregatorTuple, prediction, label, weight, sequence);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
-    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>)
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>)
     {
-        // Call (X.Update(), 0) for each X in _aggregatorTuple
+        // Call (X.Update(), 0) for each X in aggregators
         ElementUpdaterParameters params{ prediction, label, weight };
-        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(params)...);
+        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(aggregators, params)...);
         // [this, prediction, label, weight]() { std::get<Sequence>(_aggregatorTuple).Update(prediction, label, weight); }...); // GCC bug prevents compilation
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchMerge(AggregatorTupleType& aggregators, const AggregatorTupleType& other, std::index_sequence<Sequence...>)
+    {
+        // Call X.Merge(Y) for each X in aggregators and corresponding Y in other
+        utilities::InOrderFunctionEvaluator(GetElementMergeFunction<Sequence>(aggregators, other)...);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
     void Evaluator<PredictorType, AggregatorTypes...>::Aggregate(std::index_sequence<Sequence...>)
@@ -38,6 +38,13 @@ namespace evaluators
         _sumWeightedLosses = 0.0;
     }
 
+    template <typename LossFunctionType>
+    void LossAggregator<LossFunctionType>::Merge(const LossAggregator& other)
+    {
+        _sumWeights += other._sumWeights;
+        _sumWeightedLosses += other._sumWeightedLosses;
+    }
+
     template <typename LossFunctionType>
     std::vector<std::string> LossAggregator<LossFunctionType>::GetValueNames() const
     {
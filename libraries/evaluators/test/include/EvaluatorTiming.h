@@ -0,0 +1,15 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EvaluatorTiming.h (evaluators_timing)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+// Evaluating a linear predictor with error, AUC and loss aggregators, serially and sharded over a thread pool
+void TimeShardedEvaluator(size_t numExamples, size_t dimension, size_t numThreads, size_t numIterations);
@@ -7,7 +7,17 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+// data
+#include "Dataset.h"
+
+// stl
+#include <cstddef>
+
 namespace ell
 {
 void TestEvaluators();
+void TestShardedEvaluator();
+
+// A dataset of normally distributed examples, with the mean of every feature shifted toward the example's label
+data::DenseSupervisedDataset GetRandomDataset(size_t numExamples, size_t dimension);
 }
\ No newline at end of file
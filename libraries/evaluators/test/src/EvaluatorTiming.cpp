@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     EvaluatorTiming.cpp (evaluators_timing)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "EvaluatorTiming.h"
+#include "Evaluators_test.h"
+
+// evaluators
+#include "AUCAggregator.h"
+#include "BinaryErrorAggregator.h"
+#include "Evaluator.h"
+#include "LossAggregator.h"
+
+// functions
+#include "SquaredLoss.h"
+
+// predictors
+#include "LinearPredictor.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <iostream>
+#include <vector>
+
+using namespace ell;
+
+void TimeShardedEvaluator(size_t numExamples, size_t dimension, size_t numThreads, size_t numIterations)
+{
+    auto dataset = GetRandomDataset(numExamples, dimension);
+    predictors::LinearPredictor<double> predictor(math::ColumnVector<double>(std::vector<double>(dimension, 0.1)), 0.0);
+
+    using EvaluatorType = evaluators::Evaluator<predictors::LinearPredictor<double>, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, evaluators::LossAggregator<functions::SquaredLoss>>;
+    EvaluatorType serialEvaluator(dataset.GetAnyDataset(), { 1, false, 1 }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    EvaluatorType shardedEvaluator(dataset.GetAnyDataset(), { 1, false, numThreads }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        serialEvaluator.Evaluate(predictor);
+    }
+    auto serialDuration = timer.Elapsed();
+
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        shardedEvaluator.Evaluate(predictor);
+    }
+    auto shardedDuration = timer.Elapsed();
+
+    std::cout << "Evaluating " << numExamples << " examples of dimension " << dimension << ": serial " << static_cast<double>(serialDuration) / numIterations
+              << " ms, sharded over " << numThreads << " threads " << static_cast<double>(shardedDuration) / numIterations << " ms" << std::endl;
+}
@@ -27,6 +27,7 @@
 
 // stl
 #include <iostream>
+#include <random>
 
 namespace ell
 {
@@ -51,4 +52,50 @@ void TestEvaluators()
     std::cout << "Goodness: " << evaluator->GetGoodness() << std::endl;
     testing::ProcessTest("Evaluator sanity check", !testing::IsEqual(evaluator->GetGoodness(), 0.0, 1e-8));
 }
+
+data::DenseSupervisedDataset GetRandomDataset(size_t numExamples, size_t dimension)
+{
+    using ExampleType = data::DenseSupervisedDataset::DatasetExampleType;
+    std::default_random_engine engine(1234);
+    std::normal_distribution<double> normal(0, 1);
+    std::bernoulli_distribution coin(0.5);
+
+    data::DenseSupervisedDataset dataset;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        double label = coin(engine) ? 1.0 : -1.0;
+        std::vector<double> features(dimension);
+        for (auto& feature : features)
+        {
+            feature = normal(engine) + 0.25 * label;
+        }
+        dataset.AddExample(ExampleType{ std::move(features), data::WeightLabel{ 1.0, label } });
+    }
+    return dataset;
+}
+
+void TestShardedEvaluator()
+{
+    const size_t numExamples = 2000;
+    const size_t dimension = 50;
+    auto dataset = GetRandomDataset(numExamples, dimension);
+    predictors::LinearPredictor<double> predictor(math::ColumnVector<double>(std::vector<double>(dimension, 0.1)), 0.0);
+
+    using EvaluatorType = evaluators::Evaluator<predictors::LinearPredictor<double>, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, evaluators::LossAggregator<functions::SquaredLoss>>;
+    EvaluatorType serialEvaluator(dataset.GetAnyDataset(), { 1, false, 1 }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    EvaluatorType shardedEvaluator(dataset.GetAnyDataset(), { 1, false, 4 }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+
+    serialEvaluator.Evaluate(predictor);
+    shardedEvaluator.Evaluate(predictor);
+
+    // Shards are merged in order, so counts and sorted predictions match; sums of losses may differ by rounding
+    const auto& serialValues = serialEvaluator.GetValues().back();
+    const auto& shardedValues = shardedEvaluator.GetValues().back();
+    bool ok = serialValues.size() == shardedValues.size();
+    for (size_t i = 0; ok && i < serialValues.size(); ++i)
+    {
+        ok = testing::IsEqual(serialValues[i], shardedValues[i], 1e-9);
+    }
+    testing::ProcessTest("Sharded evaluator matches serial evaluator", ok);
+}
 }
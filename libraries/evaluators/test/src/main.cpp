@@ -27,6 +27,7 @@ int main()
     try
     {
         TestEvaluators();
+        TestShardedEvaluator();
     }
     catch (const utilities::Exception& exception)
     {
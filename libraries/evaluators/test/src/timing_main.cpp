@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (evaluators_timing)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "EvaluatorTiming.h"
+
+// testing
+#include "testing.h"
+
+using namespace ell;
+
+int main()
+{
+    // void TimeShardedEvaluator(size_t numExamples, size_t dimension, size_t numThreads, size_t numIterations);
+    TimeShardedEvaluator(20000, 50, 4, 5);
+    TimeShardedEvaluator(200000, 50, 4, 2);
+    TimeShardedEvaluator(200000, 50, 8, 2);
+
+    return testing::DidTestFail() ? 1 : 0;
+}
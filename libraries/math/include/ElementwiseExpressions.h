@@ -0,0 +1,461 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ElementwiseExpressions.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Matrix.h"
+#include "MatrixOperations.h"
+#include "Vector.h"
+#include "VectorOperations.h"
+
+// utilities
+#include "TypeTraits.h"
+
+// stl
+#include <type_traits>
+#include <utility>
+
+// Lazy elementwise expressions over vectors and matrices. An expression such as
+//
+//     vector += 0.5 * (a - b) + ElementwiseMultiply(c, d)
+//
+// builds a small tree of expression objects that refer to a, b, c, d and is evaluated in a single loop when it is
+// assigned to vector, without allocating any temporary vectors. The leaves of an expression are vector references,
+// matrix references, transformed vector references (such as 2.0 * vector), and scalars. An expression is evaluated
+// elementwise, so its output may also appear in the expression, as long as it is not transposed.
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The shape of an expression whose leaves are vectors with a given orientation. </summary>
+    template <VectorOrientation orientation>
+    struct VectorExpressionShape
+    {
+    };
+
+    /// <summary> The shape of an expression whose leaves are matrices. </summary>
+    struct MatrixExpressionShape
+    {
+    };
+
+    /// <summary> The shape of a scalar, which can be combined with any other shape. </summary>
+    struct ScalarExpressionShape
+    {
+    };
+
+    /// <summary> Base class of all expression types, used to identify them. </summary>
+    struct ElementwiseExpressionBase
+    {
+    };
+
+    /// <summary> An expression that refers to a vector. </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type. </typeparam>
+    /// <typeparam name="orientation"> Vector orientation. </typeparam>
+    template <typename ElementType, VectorOrientation orientation>
+    class VectorLeafExpression : public ElementwiseExpressionBase
+    {
+    public:
+        using ResultType = ElementType;
+        using ShapeType = VectorExpressionShape<orientation>;
+
+        /// <summary> Constructs an expression that refers to a vector. </summary>
+        ///
+        /// <param name="vector"> The vector. </param>
+        VectorLeafExpression(ConstVectorReference<ElementType, orientation> vector);
+
+        /// <summary> Gets the size of the vector. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets a vector element. </summary>
+        ///
+        /// <param name="index"> The element index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t index) const { return _pData[index * _increment]; }
+
+    private:
+        const ElementType* _pData;
+        size_t _size;
+        size_t _increment;
+    };
+
+    /// <summary> An expression that refers to a matrix. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    template <typename ElementType, MatrixLayout layout>
+    class MatrixLeafExpression : public ElementwiseExpressionBase
+    {
+    public:
+        using ResultType = ElementType;
+        using ShapeType = MatrixExpressionShape;
+
+        /// <summary> Constructs an expression that refers to a matrix. </summary>
+        ///
+        /// <param name="matrix"> The matrix. </param>
+        MatrixLeafExpression(ConstMatrixReference<ElementType, layout> matrix);
+
+        /// <summary> Gets the number of matrix rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of matrix columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets a matrix element. </summary>
+        ///
+        /// <param name="rowIndex"> The row index. </param>
+        /// <param name="columnIndex"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t rowIndex, size_t columnIndex) const { return _pData[rowIndex * _rowIncrement + columnIndex * _columnIncrement]; }
+
+    private:
+        const ElementType* _pData;
+        size_t _numRows;
+        size_t _numColumns;
+        size_t _rowIncrement;
+        size_t _columnIncrement;
+    };
+
+    /// <summary> An expression that has the same value at every index. </summary>
+    ///
+    /// <typeparam name="ElementType"> The scalar type. </typeparam>
+    template <typename ElementType>
+    class ScalarExpression : public ElementwiseExpressionBase
+    {
+    public:
+        using ResultType = ElementType;
+        using ShapeType = ScalarExpressionShape;
+
+        /// <summary> Constructs a scalar expression. </summary>
+        ///
+        /// <param name="value"> The scalar value. </param>
+        ScalarExpression(ElementType value) : _value(value) {}
+
+        /// <summary> Gets the scalar value, for any index. </summary>
+        ///
+        /// <returns> The scalar value. </returns>
+        template <typename... IndexTypes>
+        ElementType operator()(IndexTypes...) const { return _value; }
+
+    private:
+        ElementType _value;
+    };
+
+    /// <summary> An expression that applies a function to each element of another expression. </summary>
+    ///
+    /// <typeparam name="ExpressionType"> The expression type. </typeparam>
+    /// <typeparam name="FunctionType"> The function type. </typeparam>
+    template <typename ExpressionType, typename FunctionType>
+    class UnaryExpression : public ElementwiseExpressionBase
+    {
+    public:
+        using ResultType = typename ExpressionType::ResultType;
+        using ShapeType = typename ExpressionType::ShapeType;
+
+        /// <summary> Constructs a unary expression. </summary>
+        ///
+        /// <param name="expression"> The expression. </param>
+        /// <param name="function"> The function, which takes and returns a ResultType. </param>
+        UnaryExpression(ExpressionType expression, FunctionType function);
+
+        /// <summary> Gets the size of a vector expression. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _expression.Size(); }
+
+        /// <summary> Gets the number of rows of a matrix expression. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _expression.NumRows(); }
+
+        /// <summary> Gets the number of columns of a matrix expression. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _expression.NumColumns(); }
+
+        /// <summary> Evaluates the expression at an index. </summary>
+        ///
+        /// <param name="index"> The index, a vector index or a (row, column) pair. </param>
+        ///
+        /// <returns> The value of the expression. </returns>
+        template <typename... IndexTypes>
+        ResultType operator()(IndexTypes... index) const { return _function(_expression(index...)); }
+
+    private:
+        ExpressionType _expression;
+        FunctionType _function;
+    };
+
+    namespace ElementwiseExpressionsImpl
+    {
+        template <typename LeftShapeType, typename RightShapeType>
+        struct CommonShape
+        {
+            static_assert(std::is_same<LeftShapeType, RightShapeType>::value, "Elementwise expressions must combine vectors with the same orientation, or matrices");
+            using Type = LeftShapeType;
+        };
+
+        template <typename RightShapeType>
+        struct CommonShape<ScalarExpressionShape, RightShapeType>
+        {
+            using Type = RightShapeType;
+        };
+
+        template <typename LeftShapeType>
+        struct CommonShape<LeftShapeType, ScalarExpressionShape>
+        {
+            using Type = LeftShapeType;
+        };
+
+        template <>
+        struct CommonShape<ScalarExpressionShape, ScalarExpressionShape>
+        {
+            using Type = ScalarExpressionShape;
+        };
+
+        // selects the operand of a binary expression that determines its size, which is the right operand if the left
+        // operand is a scalar
+        template <typename LeftType, typename RightType>
+        const RightType& SelectShapeOperand(const LeftType& left, const RightType& right, std::true_type);
+
+        template <typename LeftType, typename RightType>
+        const LeftType& SelectShapeOperand(const LeftType& left, const RightType& right, std::false_type);
+    }
+
+    /// <summary> An expression that applies a binary operation to the elements of two other expressions. </summary>
+    ///
+    /// <typeparam name="LeftType"> The left expression type. </typeparam>
+    /// <typeparam name="RightType"> The right expression type. </typeparam>
+    /// <typeparam name="OperationType"> The operation type. </typeparam>
+    template <typename LeftType, typename RightType, typename OperationType>
+    class BinaryExpression : public ElementwiseExpressionBase
+    {
+    public:
+        using ResultType = typename LeftType::ResultType;
+        using ShapeType = typename ElementwiseExpressionsImpl::CommonShape<typename LeftType::ShapeType, typename RightType::ShapeType>::Type;
+
+        /// <summary> Constructs a binary expression. </summary>
+        ///
+        /// <param name="left"> The left expression. </param>
+        /// <param name="right"> The right expression, which has the same shape as the left expression. </param>
+        BinaryExpression(LeftType left, RightType right);
+
+        /// <summary> Gets the size of a vector expression. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return GetShapeOperand().Size(); }
+
+        /// <summary> Gets the number of rows of a matrix expression. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return GetShapeOperand().NumRows(); }
+
+        /// <summary> Gets the number of columns of a matrix expression. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return GetShapeOperand().NumColumns(); }
+
+        /// <summary> Evaluates the expression at an index. </summary>
+        ///
+        /// <param name="index"> The index, a vector index or a (row, column) pair. </param>
+        ///
+        /// <returns> The value of the expression. </returns>
+        template <typename... IndexTypes>
+        ResultType operator()(IndexTypes... index) const { return OperationType()(_left(index...), _right(index...)); }
+
+    private:
+        const auto& GetShapeOperand() const { return ElementwiseExpressionsImpl::SelectShapeOperand(_left, _right, std::is_same<typename LeftType::ShapeType, ScalarExpressionShape>()); }
+
+        LeftType _left;
+        RightType _right;
+    };
+
+    /// <summary> Elementwise operations used in binary expressions. </summary>
+    struct PlusOperation
+    {
+        template <typename ValueType>
+        ValueType operator()(ValueType a, ValueType b) const { return a + b; }
+    };
+
+    struct MinusOperation
+    {
+        template <typename ValueType>
+        ValueType operator()(ValueType a, ValueType b) const { return a - b; }
+    };
+
+    struct MultiplyOperation
+    {
+        template <typename ValueType>
+        ValueType operator()(ValueType a, ValueType b) const { return a * b; }
+    };
+
+    namespace ElementwiseExpressionsImpl
+    {
+        // converts the operands of the expression operators to expressions
+        template <typename ElementType, VectorOrientation orientation>
+        VectorLeafExpression<ElementType, orientation> ToExpression(ConstVectorReference<ElementType, orientation> vector);
+
+        template <typename ElementType, MatrixLayout layout>
+        MatrixLeafExpression<ElementType, layout> ToExpression(ConstMatrixReference<ElementType, layout> matrix);
+
+        template <typename ElementType, VectorOrientation orientation, typename TransformationType>
+        UnaryExpression<VectorLeafExpression<ElementType, orientation>, TransformationType> ToExpression(TransformedConstVectorReference<ElementType, orientation, TransformationType> transformedVector);
+
+        template <typename ExpressionType, std::enable_if_t<std::is_base_of<ElementwiseExpressionBase, ExpressionType>::value, bool> = true>
+        ExpressionType ToExpression(const ExpressionType& expression);
+
+        template <typename OperandType>
+        using ExpressionOf = decltype(ToExpression(std::declval<const OperandType&>()));
+
+        template <typename ElementType, VectorOrientation orientation>
+        std::true_type IsVectorReferenceHelper(const ConstVectorReference<ElementType, orientation>*);
+        std::false_type IsVectorReferenceHelper(...);
+
+        // vectors are excluded from the scalar multiplication operators below, since VectorOperations.h already
+        // defines scalar * vector
+        template <typename OperandType>
+        using IsNotVectorReference = std::enable_if_t<!decltype(IsVectorReferenceHelper(std::declval<OperandType*>()))::value, bool>;
+
+        template <typename ExpressionType>
+        using IsExpression = std::enable_if_t<std::is_base_of<ElementwiseExpressionBase, ExpressionType>::value, bool>;
+    }
+
+    /// <summary> Elementwise sum of two vectors, matrices, or expressions. </summary>
+    ///
+    /// <param name="left"> The left operand. </param>
+    /// <param name="right"> The right operand. </param>
+    ///
+    /// <returns> An expression that evaluates to left + right. </returns>
+    template <typename LeftType, typename RightType, typename LeftExpressionType = ElementwiseExpressionsImpl::ExpressionOf<LeftType>, typename RightExpressionType = ElementwiseExpressionsImpl::ExpressionOf<RightType>>
+    BinaryExpression<LeftExpressionType, RightExpressionType, PlusOperation> operator+(const LeftType& left, const RightType& right);
+
+    /// <summary> Adds a scalar to each element of a vector, matrix, or expression. </summary>
+    ///
+    /// <param name="left"> The left operand. </param>
+    /// <param name="scalar"> The scalar. </param>
+    ///
+    /// <returns> An expression that evaluates to left + scalar. </returns>
+    template <typename LeftType, typename ScalarType, utilities::IsFundamental<ScalarType> concept = true, typename LeftExpressionType = ElementwiseExpressionsImpl::ExpressionOf<LeftType>>
+    BinaryExpression<LeftExpressionType, ScalarExpression<typename LeftExpressionType::ResultType>, PlusOperation> operator+(const LeftType& left, ScalarType scalar);
+
+    /// <summary> Elementwise difference of two vectors, matrices, or expressions. </summary>
+    ///
+    /// <param name="left"> The left operand. </param>
+    /// <param name="right"> The right operand. </param>
+    ///
+    /// <returns> An expression that evaluates to left - right. </returns>
+    template <typename LeftType, typename RightType, typename LeftExpressionType = ElementwiseExpressionsImpl::ExpressionOf<LeftType>, typename RightExpressionType = ElementwiseExpressionsImpl::ExpressionOf<RightType>>
+    BinaryExpression<LeftExpressionType, RightExpressionType, MinusOperation> operator-(const LeftType& left, const RightType& right);
+
+    /// <summary> Subtracts a scalar from each element of a vector, matrix, or expression. </summary>
+    ///
+    /// <param name="left"> The left operand. </param>
+    /// <param name="scalar"> The scalar. </param>
+    ///
+    /// <returns> An expression that evaluates to left - scalar. </returns>
+    template <typename LeftType, typename ScalarType, utilities::IsFundamental<ScalarType> concept = true, typename LeftExpressionType = ElementwiseExpressionsImpl::ExpressionOf<LeftType>>
+    BinaryExpression<LeftExpressionType, ScalarExpression<typename LeftExpressionType::ResultType>, MinusOperation> operator-(const LeftType& left, ScalarType scalar);
+
+    /// <summary> Negates a vector, matrix, or expression. </summary>
+    ///
+    /// <param name="operand"> The operand. </param>
+    ///
+    /// <returns> An expression that evaluates to -operand. </returns>
+    template <typename OperandType, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator-(const OperandType& operand);
+
+    /// <summary> Multiplies a matrix or an expression by a scalar. </summary>
+    ///
+    /// <param name="scalar"> The scalar. </param>
+    /// <param name="operand"> The operand. </param>
+    ///
+    /// <returns> An expression that evaluates to scalar * operand. </returns>
+    template <typename ScalarType, typename OperandType, utilities::IsFundamental<ScalarType> concept = true, ElementwiseExpressionsImpl::IsNotVectorReference<OperandType> concept2 = true, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator*(ScalarType scalar, const OperandType& operand);
+
+    /// <summary> Multiplies a vector, matrix, or expression by a scalar. </summary>
+    ///
+    /// <param name="operand"> The operand. </param>
+    /// <param name="scalar"> The scalar. </param>
+    ///
+    /// <returns> An expression that evaluates to operand * scalar. </returns>
+    template <typename OperandType, typename ScalarType, utilities::IsFundamental<ScalarType> concept = true, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator*(const OperandType& operand, ScalarType scalar);
+
+    /// <summary> Elementwise product of two vectors, matrices, or expressions. </summary>
+    ///
+    /// <param name="left"> The left operand. </param>
+    /// <param name="right"> The right operand. </param>
+    ///
+    /// <returns> An expression that evaluates to the elementwise product of left and right. </returns>
+    template <typename LeftType, typename RightType, typename LeftExpressionType = ElementwiseExpressionsImpl::ExpressionOf<LeftType>, typename RightExpressionType = ElementwiseExpressionsImpl::ExpressionOf<RightType>>
+    BinaryExpression<LeftExpressionType, RightExpressionType, MultiplyOperation> ElementwiseMultiply(const LeftType& left, const RightType& right);
+
+    /// <summary> Applies a function to each element of a vector, matrix, or expression. </summary>
+    ///
+    /// <param name="operand"> The operand. </param>
+    /// <param name="function"> The function, which takes and returns an element. </param>
+    ///
+    /// <returns> An expression that evaluates to function(operand) elementwise. </returns>
+    template <typename OperandType, typename FunctionType, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    UnaryExpression<ExpressionType, FunctionType> ElementwiseTransform(const OperandType& operand, FunctionType function);
+
+    /// <summary> Evaluates an expression into a vector, output = expression. </summary>
+    ///
+    /// <param name="operand"> The expression, or a vector or transformed vector. </param>
+    /// <param name="output"> The output vector. </param>
+    template <typename OperandType, typename ElementType, VectorOrientation orientation, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    void Evaluate(const OperandType& operand, VectorReference<ElementType, orientation> output);
+
+    /// <summary> Evaluates an expression into a matrix, output = expression. </summary>
+    ///
+    /// <param name="operand"> The expression, or a matrix. </param>
+    /// <param name="output"> The output matrix. </param>
+    template <typename OperandType, typename ElementType, MatrixLayout layout, typename ExpressionType = ElementwiseExpressionsImpl::ExpressionOf<OperandType>>
+    void Evaluate(const OperandType& operand, MatrixReference<ElementType, layout> output);
+
+    /// <summary> Adds an expression to a vector. </summary>
+    ///
+    /// <param name="vector"> The vector being modified. </param>
+    /// <param name="expression"> The expression. </param>
+    template <typename ElementType, VectorOrientation orientation, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept = true>
+    void operator+=(VectorReference<ElementType, orientation> vector, const ExpressionType& expression);
+
+    /// <summary> Subtracts an expression from a vector. </summary>
+    ///
+    /// <param name="vector"> The vector being modified. </param>
+    /// <param name="expression"> The expression. </param>
+    template <typename ElementType, VectorOrientation orientation, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept = true>
+    void operator-=(VectorReference<ElementType, orientation> vector, const ExpressionType& expression);
+
+    /// <summary> Adds an expression to a matrix. </summary>
+    ///
+    /// <param name="matrix"> The matrix being modified. </param>
+    /// <param name="expression"> The expression. </param>
+    template <typename ElementType, MatrixLayout layout, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept = true>
+    void operator+=(MatrixReference<ElementType, layout> matrix, const ExpressionType& expression);
+
+    /// <summary> Subtracts an expression from a matrix. </summary>
+    ///
+    /// <param name="matrix"> The matrix being modified. </param>
+    /// <param name="expression"> The expression. </param>
+    template <typename ElementType, MatrixLayout layout, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept = true>
+    void operator-=(MatrixReference<ElementType, layout> matrix, const ExpressionType& expression);
+}
+}
+
+#include "../tcc/ElementwiseExpressions.tcc"
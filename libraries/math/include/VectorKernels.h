@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorKernels.h (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Kernels for contiguous (stride 1) float and double arrays. Each kernel uses explicit SIMD instructions and several
+    /// independent accumulators. The instruction set is chosen at runtime, based on the features of the CPU.
+    /// </summary>
+    namespace VectorKernels
+    {
+        /// <summary> Instruction sets that the kernels can be implemented with. </summary>
+        enum class InstructionSet
+        {
+            scalar,
+            sse2,
+            avx2,
+            avx512,
+            neon
+        };
+
+        /// <summary> Returns the instruction set that the kernels currently use. </summary>
+        ///
+        /// <returns> The instruction set. </returns>
+        InstructionSet GetInstructionSet();
+
+        /// <summary> Returns the best instruction set supported by both this build and the CPU. </summary>
+        ///
+        /// <returns> The instruction set. </returns>
+        InstructionSet GetBestSupportedInstructionSet();
+
+        /// <summary> Returns true if the kernels can use a given instruction set on this CPU. </summary>
+        ///
+        /// <param name="instructionSet"> The instruction set. </param>
+        ///
+        /// <returns> True if the instruction set is supported. </returns>
+        bool IsSupported(InstructionSet instructionSet);
+
+        /// <summary> Overrides the instruction set that the kernels use, for testing and benchmarking. Not thread safe. </summary>
+        ///
+        /// <param name="instructionSet"> The instruction set, which must be supported. </param>
+        void SetInstructionSet(InstructionSet instructionSet);
+
+        /// <summary> Returns the name of an instruction set. </summary>
+        ///
+        /// <param name="instructionSet"> The instruction set. </param>
+        ///
+        /// <returns> The name of the instruction set. </returns>
+        std::string GetInstructionSetName(InstructionSet instructionSet);
+
+        /// <summary> Computes the dot product of two arrays. </summary>
+        ///
+        /// <param name="size"> The array size. </param>
+        /// <param name="pA"> The first array. </param>
+        /// <param name="pB"> The second array. </param>
+        ///
+        /// <returns> The dot product. </returns>
+        float Dot(size_t size, const float* pA, const float* pB);
+        double Dot(size_t size, const double* pA, const double* pB);
+
+        /// <summary> Computes the sum of absolute values of an array. </summary>
+        ///
+        /// <param name="size"> The array size. </param>
+        /// <param name="pA"> The array. </param>
+        ///
+        /// <returns> The sum of absolute values. </returns>
+        float AbsSum(size_t size, const float* pA);
+        double AbsSum(size_t size, const double* pA);
+
+        /// <summary> Computes b = scalarA * a + scalarB * b. </summary>
+        ///
+        /// <param name="size"> The array size. </param>
+        /// <param name="scalarA"> The scalar that multiplies a. </param>
+        /// <param name="pA"> The array a. </param>
+        /// <param name="scalarB"> The scalar that multiplies b. </param>
+        /// <param name="pB"> The array b, which is updated. </param>
+        void ScaleAddUpdate(size_t size, float scalarA, const float* pA, float scalarB, float* pB);
+        void ScaleAddUpdate(size_t size, double scalarA, const double* pA, double scalarB, double* pB);
+
+        /// <summary> Computes a *= scalar. </summary>
+        ///
+        /// <param name="size"> The array size. </param>
+        /// <param name="scalar"> The scalar. </param>
+        /// <param name="pA"> The array, which is updated. </param>
+        void ScaleUpdate(size_t size, float scalar, float* pA);
+        void ScaleUpdate(size_t size, double scalar, double* pA);
+
+        /// <summary> True for the element types that have kernels. </summary>
+        template <typename ElementType>
+        using HasKernels = std::integral_constant<bool, std::is_same<ElementType, float>::value || std::is_same<ElementType, double>::value>;
+    }
+}
+}
@@ -124,7 +124,7 @@ namespace math
     struct ScaleFunction
     {
         ElementType _value;
-        ElementType operator()(ElementType x);
+        ElementType operator()(ElementType x) const;
     };
 
     /// <summary> Multiplication operator for scalar and vector. </summary>
@@ -0,0 +1,301 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorKernels.cpp (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VectorKernels.h"
+#include "../tcc/VectorKernels.tcc"
+
+// utilities
+#include "Exception.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VECTOR_KERNELS_X86 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VECTOR_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ell
+{
+namespace math
+{
+    namespace VectorKernels
+    {
+        namespace
+        {
+#if defined(VECTOR_KERNELS_X86)
+            // SSE2 is part of the x86-64 baseline, so it doesn't need a separate source file
+            struct Sse2FloatSimd
+            {
+                using ElementType = float;
+                using RegisterType = __m128;
+                static constexpr size_t width = 4;
+                static RegisterType Zero() { return _mm_setzero_ps(); }
+                static RegisterType Set(float value) { return _mm_set1_ps(value); }
+                static RegisterType Load(const float* p) { return _mm_loadu_ps(p); }
+                static void Store(float* p, RegisterType value) { _mm_storeu_ps(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm_add_ps(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm_mul_ps(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+                static RegisterType Abs(RegisterType a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static float Sum(RegisterType a)
+                {
+                    alignas(16) float values[4];
+                    _mm_store_ps(values, a);
+                    return (values[0] + values[1]) + (values[2] + values[3]);
+                }
+            };
+
+            struct Sse2DoubleSimd
+            {
+                using ElementType = double;
+                using RegisterType = __m128d;
+                static constexpr size_t width = 2;
+                static RegisterType Zero() { return _mm_setzero_pd(); }
+                static RegisterType Set(double value) { return _mm_set1_pd(value); }
+                static RegisterType Load(const double* p) { return _mm_loadu_pd(p); }
+                static void Store(double* p, RegisterType value) { _mm_storeu_pd(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm_add_pd(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm_mul_pd(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+                static RegisterType Abs(RegisterType a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+                static double Sum(RegisterType a)
+                {
+                    alignas(16) double values[2];
+                    _mm_store_pd(values, a);
+                    return values[0] + values[1];
+                }
+            };
+#endif
+
+#if defined(VECTOR_KERNELS_NEON)
+            struct NeonFloatSimd
+            {
+                using ElementType = float;
+                using RegisterType = float32x4_t;
+                static constexpr size_t width = 4;
+                static RegisterType Zero() { return vdupq_n_f32(0); }
+                static RegisterType Set(float value) { return vdupq_n_f32(value); }
+                static RegisterType Load(const float* p) { return vld1q_f32(p); }
+                static void Store(float* p, RegisterType value) { vst1q_f32(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return vaddq_f32(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return vmulq_f32(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return vmlaq_f32(c, a, b); }
+                static RegisterType Abs(RegisterType a) { return vabsq_f32(a); }
+                static float Sum(RegisterType a)
+                {
+                    float32x2_t pairs = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+                    return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+                }
+            };
+
+#if defined(__aarch64__)
+            struct NeonDoubleSimd
+            {
+                using ElementType = double;
+                using RegisterType = float64x2_t;
+                static constexpr size_t width = 2;
+                static RegisterType Zero() { return vdupq_n_f64(0); }
+                static RegisterType Set(double value) { return vdupq_n_f64(value); }
+                static RegisterType Load(const double* p) { return vld1q_f64(p); }
+                static void Store(double* p, RegisterType value) { vst1q_f64(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return vaddq_f64(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return vmulq_f64(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return vfmaq_f64(c, a, b); }
+                static RegisterType Abs(RegisterType a) { return vabsq_f64(a); }
+                static double Sum(RegisterType a) { return vaddvq_f64(a); }
+            };
+#else
+            // 32-bit ARM has no double-precision NEON instructions
+            using NeonDoubleSimd = ScalarSimd<double>;
+#endif
+#endif
+
+#if defined(VECTOR_KERNELS_X86) && defined(USE_AVX_KERNELS)
+            bool CpuSupportsAvx2()
+            {
+#if defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 1);
+                bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+                bool fma = (info[2] & (1 << 12)) != 0;
+                __cpuidex(info, 7, 0);
+                return osSavesYmm && fma && (info[1] & (1 << 5)) != 0;
+#else
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+            }
+
+            bool CpuSupportsAvx512()
+            {
+#if defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 1);
+                bool osSavesZmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0xe6) == 0xe6;
+                __cpuidex(info, 7, 0);
+                return osSavesZmm && (info[1] & (1 << 16)) != 0;
+#else
+                return __builtin_cpu_supports("avx512f");
+#endif
+            }
+#endif
+
+            struct Kernels
+            {
+                InstructionSet instructionSet;
+                KernelTable<float> floatKernels;
+                KernelTable<double> doubleKernels;
+            };
+
+            Kernels MakeKernels(InstructionSet instructionSet)
+            {
+                switch (instructionSet)
+                {
+                case InstructionSet::scalar:
+                    return { instructionSet, GetScalarFloatKernels(), GetScalarDoubleKernels() };
+                case InstructionSet::sse2:
+                    return { instructionSet, GetSse2FloatKernels(), GetSse2DoubleKernels() };
+                case InstructionSet::avx2:
+                    return { instructionSet, GetAvx2FloatKernels(), GetAvx2DoubleKernels() };
+                case InstructionSet::avx512:
+                    return { instructionSet, GetAvx512FloatKernels(), GetAvx512DoubleKernels() };
+                case InstructionSet::neon:
+                    return { instructionSet, GetNeonFloatKernels(), GetNeonDoubleKernels() };
+                }
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "unknown instruction set");
+            }
+
+            Kernels& GetKernels()
+            {
+                static Kernels kernels = MakeKernels(GetBestSupportedInstructionSet());
+                return kernels;
+            }
+        }
+
+        //
+        // Kernel tables for the instruction sets compiled into this file
+        //
+
+        KernelTable<float> GetScalarFloatKernels() { return MakeKernelTable<ScalarSimd<float>>(); }
+        KernelTable<double> GetScalarDoubleKernels() { return MakeKernelTable<ScalarSimd<double>>(); }
+
+#if defined(VECTOR_KERNELS_X86)
+        KernelTable<float> GetSse2FloatKernels() { return MakeKernelTable<Sse2FloatSimd>(); }
+        KernelTable<double> GetSse2DoubleKernels() { return MakeKernelTable<Sse2DoubleSimd>(); }
+#else
+        KernelTable<float> GetSse2FloatKernels() { return GetScalarFloatKernels(); }
+        KernelTable<double> GetSse2DoubleKernels() { return GetScalarDoubleKernels(); }
+#endif
+
+#if !defined(USE_AVX_KERNELS)
+        KernelTable<float> GetAvx2FloatKernels() { return GetSse2FloatKernels(); }
+        KernelTable<double> GetAvx2DoubleKernels() { return GetSse2DoubleKernels(); }
+        KernelTable<float> GetAvx512FloatKernels() { return GetSse2FloatKernels(); }
+        KernelTable<double> GetAvx512DoubleKernels() { return GetSse2DoubleKernels(); }
+#endif
+
+#if defined(VECTOR_KERNELS_NEON)
+        KernelTable<float> GetNeonFloatKernels() { return MakeKernelTable<NeonFloatSimd>(); }
+        KernelTable<double> GetNeonDoubleKernels() { return MakeKernelTable<NeonDoubleSimd>(); }
+#else
+        KernelTable<float> GetNeonFloatKernels() { return GetScalarFloatKernels(); }
+        KernelTable<double> GetNeonDoubleKernels() { return GetScalarDoubleKernels(); }
+#endif
+
+        //
+        // Dispatch
+        //
+
+        bool IsSupported(InstructionSet instructionSet)
+        {
+            switch (instructionSet)
+            {
+            case InstructionSet::scalar:
+                return true;
+#if defined(VECTOR_KERNELS_X86)
+            case InstructionSet::sse2:
+                return true;
+#if defined(USE_AVX_KERNELS)
+            case InstructionSet::avx2:
+                return CpuSupportsAvx2();
+            case InstructionSet::avx512:
+                return CpuSupportsAvx512();
+#endif
+#endif
+#if defined(VECTOR_KERNELS_NEON)
+            case InstructionSet::neon:
+                return true;
+#endif
+            default:
+                return false;
+            }
+        }
+
+        InstructionSet GetBestSupportedInstructionSet()
+        {
+            for (auto instructionSet : { InstructionSet::avx512, InstructionSet::avx2, InstructionSet::sse2, InstructionSet::neon })
+            {
+                if (IsSupported(instructionSet))
+                {
+                    return instructionSet;
+                }
+            }
+            return InstructionSet::scalar;
+        }
+
+        InstructionSet GetInstructionSet()
+        {
+            return GetKernels().instructionSet;
+        }
+
+        void SetInstructionSet(InstructionSet instructionSet)
+        {
+            if (!IsSupported(instructionSet))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "instruction set " + GetInstructionSetName(instructionSet) + " isn't supported");
+            }
+            GetKernels() = MakeKernels(instructionSet);
+        }
+
+        std::string GetInstructionSetName(InstructionSet instructionSet)
+        {
+            switch (instructionSet)
+            {
+            case InstructionSet::scalar:
+                return "scalar";
+            case InstructionSet::sse2:
+                return "SSE2";
+            case InstructionSet::avx2:
+                return "AVX2";
+            case InstructionSet::avx512:
+                return "AVX-512";
+            case InstructionSet::neon:
+                return "NEON";
+            }
+            return "unknown";
+        }
+
+        float Dot(size_t size, const float* pA, const float* pB) { return GetKernels().floatKernels.dot(size, pA, pB); }
+        double Dot(size_t size, const double* pA, const double* pB) { return GetKernels().doubleKernels.dot(size, pA, pB); }
+
+        float AbsSum(size_t size, const float* pA) { return GetKernels().floatKernels.absSum(size, pA); }
+        double AbsSum(size_t size, const double* pA) { return GetKernels().doubleKernels.absSum(size, pA); }
+
+        void ScaleAddUpdate(size_t size, float scalarA, const float* pA, float scalarB, float* pB) { GetKernels().floatKernels.scaleAddUpdate(size, scalarA, pA, scalarB, pB); }
+        void ScaleAddUpdate(size_t size, double scalarA, const double* pA, double scalarB, double* pB) { GetKernels().doubleKernels.scaleAddUpdate(size, scalarA, pA, scalarB, pB); }
+
+        void ScaleUpdate(size_t size, float scalar, float* pA) { GetKernels().floatKernels.scaleUpdate(size, scalar, pA); }
+        void ScaleUpdate(size_t size, double scalar, double* pA) { GetKernels().doubleKernels.scaleUpdate(size, scalar, pA); }
+    }
+}
+}
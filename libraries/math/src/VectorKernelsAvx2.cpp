@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorKernelsAvx2.cpp (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// This file is compiled with AVX2 and FMA code generation enabled. Its kernels are only called after checking that the CPU
+// supports those instructions.
+
+#include "../tcc/VectorKernels.tcc"
+
+#include <immintrin.h>
+
+namespace ell
+{
+namespace math
+{
+    namespace VectorKernels
+    {
+        namespace
+        {
+            struct Avx2FloatSimd
+            {
+                using ElementType = float;
+                using RegisterType = __m256;
+                static constexpr size_t width = 8;
+                static RegisterType Zero() { return _mm256_setzero_ps(); }
+                static RegisterType Set(float value) { return _mm256_set1_ps(value); }
+                static RegisterType Load(const float* p) { return _mm256_loadu_ps(p); }
+                static void Store(float* p, RegisterType value) { _mm256_storeu_ps(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm256_add_ps(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm256_mul_ps(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm256_fmadd_ps(a, b, c); }
+                static RegisterType Abs(RegisterType a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static float Sum(RegisterType a)
+                {
+                    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+                    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+                    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+                    return _mm_cvtss_f32(sum);
+                }
+            };
+
+            struct Avx2DoubleSimd
+            {
+                using ElementType = double;
+                using RegisterType = __m256d;
+                static constexpr size_t width = 4;
+                static RegisterType Zero() { return _mm256_setzero_pd(); }
+                static RegisterType Set(double value) { return _mm256_set1_pd(value); }
+                static RegisterType Load(const double* p) { return _mm256_loadu_pd(p); }
+                static void Store(double* p, RegisterType value) { _mm256_storeu_pd(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm256_add_pd(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm256_mul_pd(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm256_fmadd_pd(a, b, c); }
+                static RegisterType Abs(RegisterType a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+                static double Sum(RegisterType a)
+                {
+                    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+                    sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+                    return _mm_cvtsd_f64(sum);
+                }
+            };
+        }
+
+        KernelTable<float> GetAvx2FloatKernels() { return MakeKernelTable<Avx2FloatSimd>(); }
+        KernelTable<double> GetAvx2DoubleKernels() { return MakeKernelTable<Avx2DoubleSimd>(); }
+    }
+}
+}
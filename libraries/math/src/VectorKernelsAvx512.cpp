@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorKernelsAvx512.cpp (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// This file is compiled with AVX-512F code generation enabled. Its kernels are only called after checking that the CPU
+// supports those instructions.
+
+#include "../tcc/VectorKernels.tcc"
+
+#include <immintrin.h>
+
+namespace ell
+{
+namespace math
+{
+    namespace VectorKernels
+    {
+        namespace
+        {
+            struct Avx512FloatSimd
+            {
+                using ElementType = float;
+                using RegisterType = __m512;
+                static constexpr size_t width = 16;
+                static RegisterType Zero() { return _mm512_setzero_ps(); }
+                static RegisterType Set(float value) { return _mm512_set1_ps(value); }
+                static RegisterType Load(const float* p) { return _mm512_loadu_ps(p); }
+                static void Store(float* p, RegisterType value) { _mm512_storeu_ps(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm512_add_ps(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm512_mul_ps(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm512_fmadd_ps(a, b, c); }
+                static RegisterType Abs(RegisterType a) { return _mm512_abs_ps(a); }
+                static float Sum(RegisterType a)
+                {
+                    // _mm512_reduce_add_ps trips -Wuninitialized on some versions of GCC, so the halves are added by hand.
+                    // Extracting 32-bit lanes needs AVX-512DQ, so the upper half is extracted as doubles.
+                    __m256 upper = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1));
+                    __m256 half = _mm256_add_ps(_mm512_castps512_ps256(a), upper);
+                    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+                    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+                    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+                    return _mm_cvtss_f32(sum);
+                }
+            };
+
+            struct Avx512DoubleSimd
+            {
+                using ElementType = double;
+                using RegisterType = __m512d;
+                static constexpr size_t width = 8;
+                static RegisterType Zero() { return _mm512_setzero_pd(); }
+                static RegisterType Set(double value) { return _mm512_set1_pd(value); }
+                static RegisterType Load(const double* p) { return _mm512_loadu_pd(p); }
+                static void Store(double* p, RegisterType value) { _mm512_storeu_pd(p, value); }
+                static RegisterType Add(RegisterType a, RegisterType b) { return _mm512_add_pd(a, b); }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return _mm512_mul_pd(a, b); }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return _mm512_fmadd_pd(a, b, c); }
+                static RegisterType Abs(RegisterType a) { return _mm512_abs_pd(a); }
+                static double Sum(RegisterType a)
+                {
+                    __m256d half = _mm256_add_pd(_mm512_castpd512_pd256(a), _mm512_extractf64x4_pd(a, 1));
+                    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+                    sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+                    return _mm_cvtsd_f64(sum);
+                }
+            };
+        }
+
+        KernelTable<float> GetAvx512FloatKernels() { return MakeKernelTable<Avx512FloatSimd>(); }
+        KernelTable<double> GetAvx512DoubleKernels() { return MakeKernelTable<Avx512DoubleSimd>(); }
+    }
+}
+}
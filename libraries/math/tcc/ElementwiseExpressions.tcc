@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ElementwiseExpressions.tcc (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Debug.h"
+#include "Exception.h"
+#include "Unused.h"
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType, VectorOrientation orientation>
+    VectorLeafExpression<ElementType, orientation>::VectorLeafExpression(ConstVectorReference<ElementType, orientation> vector)
+        : _pData(vector.GetConstDataPointer()), _size(vector.Size()), _increment(vector.GetIncrement())
+    {
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    MatrixLeafExpression<ElementType, layout>::MatrixLeafExpression(ConstMatrixReference<ElementType, layout> matrix)
+        : _pData(matrix.GetConstDataPointer()), _numRows(matrix.NumRows()), _numColumns(matrix.NumColumns()), _rowIncrement(matrix.GetRowIncrement()), _columnIncrement(matrix.GetColumnIncrement())
+    {
+    }
+
+    template <typename ExpressionType, typename FunctionType>
+    UnaryExpression<ExpressionType, FunctionType>::UnaryExpression(ExpressionType expression, FunctionType function)
+        : _expression(std::move(expression)), _function(std::move(function))
+    {
+    }
+
+    namespace ElementwiseExpressionsImpl
+    {
+        template <typename LeftType, typename RightType>
+        const RightType& SelectShapeOperand(const LeftType& /*left*/, const RightType& right, std::true_type)
+        {
+            return right;
+        }
+
+        template <typename LeftType, typename RightType>
+        const LeftType& SelectShapeOperand(const LeftType& left, const RightType& /*right*/, std::false_type)
+        {
+            return left;
+        }
+
+        template <typename LeftType, typename RightType, typename LeftShapeType, typename RightShapeType>
+        void CheckSizes(const LeftType& /*left*/, const RightType& /*right*/, LeftShapeType, RightShapeType)
+        {
+            // one of the operands is a scalar
+        }
+
+        template <typename LeftType, typename RightType, VectorOrientation orientation>
+        void CheckSizes(const LeftType& left, const RightType& right, VectorExpressionShape<orientation>, VectorExpressionShape<orientation>)
+        {
+            DEBUG_CHECK_SIZES(left.Size() != right.Size(), "Incompatible vector sizes.");
+            UNUSED(left, right);
+        }
+
+        template <typename LeftType, typename RightType>
+        void CheckSizes(const LeftType& left, const RightType& right, MatrixExpressionShape, MatrixExpressionShape)
+        {
+            DEBUG_CHECK_SIZES(left.NumRows() != right.NumRows() || left.NumColumns() != right.NumColumns(), "Incompatible matrix sizes.");
+            UNUSED(left, right);
+        }
+    }
+
+    template <typename LeftType, typename RightType, typename OperationType>
+    BinaryExpression<LeftType, RightType, OperationType>::BinaryExpression(LeftType left, RightType right)
+        : _left(std::move(left)), _right(std::move(right))
+    {
+        ElementwiseExpressionsImpl::CheckSizes(_left, _right, typename LeftType::ShapeType(), typename RightType::ShapeType());
+    }
+
+    namespace ElementwiseExpressionsImpl
+    {
+        template <typename ElementType, VectorOrientation orientation>
+        VectorLeafExpression<ElementType, orientation> ToExpression(ConstVectorReference<ElementType, orientation> vector)
+        {
+            return { vector };
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        MatrixLeafExpression<ElementType, layout> ToExpression(ConstMatrixReference<ElementType, layout> matrix)
+        {
+            return { matrix };
+        }
+
+        template <typename ElementType, VectorOrientation orientation, typename TransformationType>
+        UnaryExpression<VectorLeafExpression<ElementType, orientation>, TransformationType> ToExpression(TransformedConstVectorReference<ElementType, orientation, TransformationType> transformedVector)
+        {
+            return { transformedVector.GetVector(), transformedVector.GetTransformation() };
+        }
+
+        template <typename ExpressionType, std::enable_if_t<std::is_base_of<ElementwiseExpressionBase, ExpressionType>::value, bool>>
+        ExpressionType ToExpression(const ExpressionType& expression)
+        {
+            return expression;
+        }
+
+        struct AssignUpdate
+        {
+            template <typename ElementType>
+            void operator()(ElementType& element, ElementType value) const { element = value; }
+        };
+
+        struct AddAssignUpdate
+        {
+            template <typename ElementType>
+            void operator()(ElementType& element, ElementType value) const { element += value; }
+        };
+
+        struct SubtractAssignUpdate
+        {
+            template <typename ElementType>
+            void operator()(ElementType& element, ElementType value) const { element -= value; }
+        };
+
+        template <typename ElementType, VectorOrientation orientation, typename ExpressionType, typename UpdateType>
+        void EvaluateUpdate(const ExpressionType& expression, VectorReference<ElementType, orientation> vector, UpdateType update)
+        {
+            static_assert(std::is_same<typename ExpressionType::ShapeType, VectorExpressionShape<orientation>>::value, "Expression does not match the vector orientation");
+            DEBUG_CHECK_SIZES(expression.Size() != vector.Size(), "Incompatible vector sizes.");
+
+            ElementType* pData = vector.GetDataPointer();
+            size_t size = vector.Size();
+            size_t increment = vector.GetIncrement();
+            if (increment == 1)
+            {
+                // the stride-1 loop is vectorized by the compiler when the expression allows it
+                for (size_t i = 0; i < size; ++i)
+                {
+                    update(pData[i], static_cast<ElementType>(expression(i)));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    update(pData[i * increment], static_cast<ElementType>(expression(i)));
+                }
+            }
+        }
+
+        template <typename ElementType, MatrixLayout layout, typename ExpressionType, typename UpdateType>
+        void EvaluateUpdate(const ExpressionType& expression, MatrixReference<ElementType, layout> matrix, UpdateType update)
+        {
+            static_assert(std::is_same<typename ExpressionType::ShapeType, MatrixExpressionShape>::value, "Expression is not a matrix expression");
+            DEBUG_CHECK_SIZES(expression.NumRows() != matrix.NumRows() || expression.NumColumns() != matrix.NumColumns(), "Incompatible matrix sizes.");
+
+            // traverse the matrix in memory order, one major vector at a time
+            for (size_t i = 0; i < matrix.GetMinorSize(); ++i)
+            {
+                ElementType* pData = matrix.GetMajorVector(i).GetDataPointer();
+                size_t size = matrix.GetMajorSize();
+                if (layout == MatrixLayout::columnMajor)
+                {
+                    for (size_t j = 0; j < size; ++j)
+                    {
+                        update(pData[j], static_cast<ElementType>(expression(j, i)));
+                    }
+                }
+                else
+                {
+                    for (size_t j = 0; j < size; ++j)
+                    {
+                        update(pData[j], static_cast<ElementType>(expression(i, j)));
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename LeftType, typename RightType, typename LeftExpressionType, typename RightExpressionType>
+    BinaryExpression<LeftExpressionType, RightExpressionType, PlusOperation> operator+(const LeftType& left, const RightType& right)
+    {
+        return { ElementwiseExpressionsImpl::ToExpression(left), ElementwiseExpressionsImpl::ToExpression(right) };
+    }
+
+    template <typename LeftType, typename ScalarType, utilities::IsFundamental<ScalarType> concept, typename LeftExpressionType>
+    BinaryExpression<LeftExpressionType, ScalarExpression<typename LeftExpressionType::ResultType>, PlusOperation> operator+(const LeftType& left, ScalarType scalar)
+    {
+        using ResultType = typename LeftExpressionType::ResultType;
+        return { ElementwiseExpressionsImpl::ToExpression(left), ScalarExpression<ResultType>(static_cast<ResultType>(scalar)) };
+    }
+
+    template <typename LeftType, typename RightType, typename LeftExpressionType, typename RightExpressionType>
+    BinaryExpression<LeftExpressionType, RightExpressionType, MinusOperation> operator-(const LeftType& left, const RightType& right)
+    {
+        return { ElementwiseExpressionsImpl::ToExpression(left), ElementwiseExpressionsImpl::ToExpression(right) };
+    }
+
+    template <typename LeftType, typename ScalarType, utilities::IsFundamental<ScalarType> concept, typename LeftExpressionType>
+    BinaryExpression<LeftExpressionType, ScalarExpression<typename LeftExpressionType::ResultType>, MinusOperation> operator-(const LeftType& left, ScalarType scalar)
+    {
+        using ResultType = typename LeftExpressionType::ResultType;
+        return { ElementwiseExpressionsImpl::ToExpression(left), ScalarExpression<ResultType>(static_cast<ResultType>(scalar)) };
+    }
+
+    template <typename OperandType, typename ExpressionType>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator-(const OperandType& operand)
+    {
+        using ResultType = typename ExpressionType::ResultType;
+        return { ScalarExpression<ResultType>(static_cast<ResultType>(-1)), ElementwiseExpressionsImpl::ToExpression(operand) };
+    }
+
+    template <typename ScalarType, typename OperandType, utilities::IsFundamental<ScalarType> concept, ElementwiseExpressionsImpl::IsNotVectorReference<OperandType> concept2, typename ExpressionType>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator*(ScalarType scalar, const OperandType& operand)
+    {
+        using ResultType = typename ExpressionType::ResultType;
+        return { ScalarExpression<ResultType>(static_cast<ResultType>(scalar)), ElementwiseExpressionsImpl::ToExpression(operand) };
+    }
+
+    template <typename OperandType, typename ScalarType, utilities::IsFundamental<ScalarType> concept, typename ExpressionType>
+    BinaryExpression<ScalarExpression<typename ExpressionType::ResultType>, ExpressionType, MultiplyOperation> operator*(const OperandType& operand, ScalarType scalar)
+    {
+        using ResultType = typename ExpressionType::ResultType;
+        return { ScalarExpression<ResultType>(static_cast<ResultType>(scalar)), ElementwiseExpressionsImpl::ToExpression(operand) };
+    }
+
+    template <typename LeftType, typename RightType, typename LeftExpressionType, typename RightExpressionType>
+    BinaryExpression<LeftExpressionType, RightExpressionType, MultiplyOperation> ElementwiseMultiply(const LeftType& left, const RightType& right)
+    {
+        return { ElementwiseExpressionsImpl::ToExpression(left), ElementwiseExpressionsImpl::ToExpression(right) };
+    }
+
+    template <typename OperandType, typename FunctionType, typename ExpressionType>
+    UnaryExpression<ExpressionType, FunctionType> ElementwiseTransform(const OperandType& operand, FunctionType function)
+    {
+        return { ElementwiseExpressionsImpl::ToExpression(operand), std::move(function) };
+    }
+
+    template <typename OperandType, typename ElementType, VectorOrientation orientation, typename ExpressionType>
+    void Evaluate(const OperandType& operand, VectorReference<ElementType, orientation> output)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(ElementwiseExpressionsImpl::ToExpression(operand), output, ElementwiseExpressionsImpl::AssignUpdate());
+    }
+
+    template <typename OperandType, typename ElementType, MatrixLayout layout, typename ExpressionType>
+    void Evaluate(const OperandType& operand, MatrixReference<ElementType, layout> output)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(ElementwiseExpressionsImpl::ToExpression(operand), output, ElementwiseExpressionsImpl::AssignUpdate());
+    }
+
+    template <typename ElementType, VectorOrientation orientation, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept>
+    void operator+=(VectorReference<ElementType, orientation> vector, const ExpressionType& expression)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(expression, vector, ElementwiseExpressionsImpl::AddAssignUpdate());
+    }
+
+    template <typename ElementType, VectorOrientation orientation, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept>
+    void operator-=(VectorReference<ElementType, orientation> vector, const ExpressionType& expression)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(expression, vector, ElementwiseExpressionsImpl::SubtractAssignUpdate());
+    }
+
+    template <typename ElementType, MatrixLayout layout, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept>
+    void operator+=(MatrixReference<ElementType, layout> matrix, const ExpressionType& expression)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(expression, matrix, ElementwiseExpressionsImpl::AddAssignUpdate());
+    }
+
+    template <typename ElementType, MatrixLayout layout, typename ExpressionType, ElementwiseExpressionsImpl::IsExpression<ExpressionType> concept>
+    void operator-=(MatrixReference<ElementType, layout> matrix, const ExpressionType& expression)
+    {
+        ElementwiseExpressionsImpl::EvaluateUpdate(expression, matrix, ElementwiseExpressionsImpl::SubtractAssignUpdate());
+    }
+}
+}
@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "VectorKernels.h"
+
 // utilities
 #include "Debug.h"
 #include "Exception.h"
@@ -40,6 +42,43 @@ namespace math
         std::swap(_increment, other._increment);
     }
 
+    namespace VectorImpl
+    {
+        template <typename ElementType>
+        ElementType ContiguousAbsSum(size_t size, const ElementType* pData, std::true_type)
+        {
+            return VectorKernels::AbsSum(size, pData);
+        }
+
+        template <typename ElementType>
+        ElementType ContiguousAbsSum(size_t size, const ElementType* pData, std::false_type)
+        {
+            ElementType result = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                result += std::abs(pData[i]);
+            }
+            return result;
+        }
+
+        template <typename ElementType>
+        ElementType ContiguousSquaredSum(size_t size, const ElementType* pData, std::true_type)
+        {
+            return VectorKernels::Dot(size, pData, pData);
+        }
+
+        template <typename ElementType>
+        ElementType ContiguousSquaredSum(size_t size, const ElementType* pData, std::false_type)
+        {
+            ElementType result = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                result += pData[i] * pData[i];
+            }
+            return result;
+        }
+    }
+
     template <typename ElementType>
     ElementType UnorientedConstVectorBase<ElementType>::Norm0() const
     {
@@ -49,6 +88,10 @@ namespace math
     template <typename ElementType>
     ElementType UnorientedConstVectorBase<ElementType>::Norm1() const
     {
+        if (_increment == 1)
+        {
+            return VectorImpl::ContiguousAbsSum(_size, GetConstDataPointer(), VectorKernels::HasKernels<ElementType>{});
+        }
         return Aggregate([](ElementType x) { return std::abs(x); });
     }
 
@@ -61,6 +104,10 @@ namespace math
     template <typename ElementType>
     ElementType UnorientedConstVectorBase<ElementType>::Norm2Squared() const
     {
+        if (_increment == 1)
+        {
+            return VectorImpl::ContiguousSquaredSum(_size, GetConstDataPointer(), VectorKernels::HasKernels<ElementType>{});
+        }
         return Aggregate([](ElementType x) { return x * x; });
     }
 
@@ -68,8 +115,27 @@ namespace math
     template <typename MapperType>
     ElementType UnorientedConstVectorBase<ElementType>::Aggregate(MapperType mapper) const
     {
-        ElementType result = 0;
         const ElementType* current = GetConstDataPointer();
+        if (_increment == 1)
+        {
+            // independent partial sums let the compiler pipeline (and vectorize) the mapper
+            ElementType sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= _size; i += 4)
+            {
+                sum0 += mapper(current[i]);
+                sum1 += mapper(current[i + 1]);
+                sum2 += mapper(current[i + 2]);
+                sum3 += mapper(current[i + 3]);
+            }
+            for (; i < _size; ++i)
+            {
+                sum0 += mapper(current[i]);
+            }
+            return (sum0 + sum1) + (sum2 + sum3);
+        }
+
+        ElementType result = 0;
         const ElementType* end = current + _size * _increment;
         while (current < end)
         {
@@ -255,6 +321,17 @@ namespace math
     void VectorReference<ElementType, orientation>::Transform(TransformationType transformation)
     {
         ElementType* pData = this->GetDataPointer();
+        if (this->GetIncrement() == 1)
+        {
+            // a unit-stride loop that the compiler can vectorize
+            const size_t size = this->Size();
+            for (size_t i = 0; i < size; ++i)
+            {
+                pData[i] = transformation(pData[i]);
+            }
+            return;
+        }
+
         const ElementType* pEnd = pData + this->Size() * this->GetIncrement();
         while (pData < pEnd)
         {
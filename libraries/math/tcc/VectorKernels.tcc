@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     VectorKernels.tcc (math)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// This file is included by the VectorKernels*.cpp source files, each of which is compiled for a different instruction
+// set. The kernel templates are in an anonymous namespace so that each source file gets its own copy of them.
+
+#include "VectorKernels.h"
+
+// stl
+#include <cmath>
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    namespace VectorKernels
+    {
+        /// <summary> A set of kernels for one element type, implemented with one instruction set. </summary>
+        template <typename ElementType>
+        struct KernelTable
+        {
+            ElementType (*dot)(size_t, const ElementType*, const ElementType*);
+            ElementType (*absSum)(size_t, const ElementType*);
+            void (*scaleAddUpdate)(size_t, ElementType, const ElementType*, ElementType, ElementType*);
+            void (*scaleUpdate)(size_t, ElementType, ElementType*);
+        };
+
+        // the kernel tables of each instruction set, defined in the source file compiled for that instruction set
+        KernelTable<float> GetScalarFloatKernels();
+        KernelTable<double> GetScalarDoubleKernels();
+        KernelTable<float> GetSse2FloatKernels();
+        KernelTable<double> GetSse2DoubleKernels();
+        KernelTable<float> GetAvx2FloatKernels();
+        KernelTable<double> GetAvx2DoubleKernels();
+        KernelTable<float> GetAvx512FloatKernels();
+        KernelTable<double> GetAvx512DoubleKernels();
+        KernelTable<float> GetNeonFloatKernels();
+        KernelTable<double> GetNeonDoubleKernels();
+
+        namespace
+        {
+            // A SimdType provides ElementType, RegisterType, width, and the static functions Zero, Set, Load, Store,
+            // Add, Multiply, MultiplyAdd (a * b + c), Abs, and Sum (horizontal sum of a register).
+
+            /// <summary> A "SIMD" type with one lane, used as the portable fallback. </summary>
+            template <typename T>
+            struct ScalarSimd
+            {
+                using ElementType = T;
+                using RegisterType = T;
+                static constexpr size_t width = 1;
+                static RegisterType Zero() { return 0; }
+                static RegisterType Set(T value) { return value; }
+                static RegisterType Load(const T* p) { return *p; }
+                static void Store(T* p, RegisterType value) { *p = value; }
+                static RegisterType Add(RegisterType a, RegisterType b) { return a + b; }
+                static RegisterType Multiply(RegisterType a, RegisterType b) { return a * b; }
+                static RegisterType MultiplyAdd(RegisterType a, RegisterType b, RegisterType c) { return a * b + c; }
+                static RegisterType Abs(RegisterType a) { return std::abs(a); }
+                static T Sum(RegisterType a) { return a; }
+            };
+
+            template <typename SimdType>
+            typename SimdType::ElementType DotKernel(size_t size, const typename SimdType::ElementType* pA, const typename SimdType::ElementType* pB)
+            {
+                using S = SimdType;
+                constexpr size_t width = S::width;
+
+                // four independent accumulators hide the latency of the add / multiply-add instructions
+                auto sum0 = S::Zero();
+                auto sum1 = S::Zero();
+                auto sum2 = S::Zero();
+                auto sum3 = S::Zero();
+                size_t i = 0;
+                for (; i + 4 * width <= size; i += 4 * width)
+                {
+                    sum0 = S::MultiplyAdd(S::Load(pA + i), S::Load(pB + i), sum0);
+                    sum1 = S::MultiplyAdd(S::Load(pA + i + width), S::Load(pB + i + width), sum1);
+                    sum2 = S::MultiplyAdd(S::Load(pA + i + 2 * width), S::Load(pB + i + 2 * width), sum2);
+                    sum3 = S::MultiplyAdd(S::Load(pA + i + 3 * width), S::Load(pB + i + 3 * width), sum3);
+                }
+                for (; i + width <= size; i += width)
+                {
+                    sum0 = S::MultiplyAdd(S::Load(pA + i), S::Load(pB + i), sum0);
+                }
+
+                auto result = S::Sum(S::Add(S::Add(sum0, sum1), S::Add(sum2, sum3)));
+                for (; i < size; ++i)
+                {
+                    result += pA[i] * pB[i];
+                }
+                return result;
+            }
+
+            template <typename SimdType>
+            typename SimdType::ElementType AbsSumKernel(size_t size, const typename SimdType::ElementType* pA)
+            {
+                using S = SimdType;
+                constexpr size_t width = S::width;
+
+                auto sum0 = S::Zero();
+                auto sum1 = S::Zero();
+                auto sum2 = S::Zero();
+                auto sum3 = S::Zero();
+                size_t i = 0;
+                for (; i + 4 * width <= size; i += 4 * width)
+                {
+                    sum0 = S::Add(S::Abs(S::Load(pA + i)), sum0);
+                    sum1 = S::Add(S::Abs(S::Load(pA + i + width)), sum1);
+                    sum2 = S::Add(S::Abs(S::Load(pA + i + 2 * width)), sum2);
+                    sum3 = S::Add(S::Abs(S::Load(pA + i + 3 * width)), sum3);
+                }
+                for (; i + width <= size; i += width)
+                {
+                    sum0 = S::Add(S::Abs(S::Load(pA + i)), sum0);
+                }
+
+                auto result = S::Sum(S::Add(S::Add(sum0, sum1), S::Add(sum2, sum3)));
+                for (; i < size; ++i)
+                {
+                    result += std::abs(pA[i]);
+                }
+                return result;
+            }
+
+            template <typename SimdType>
+            void ScaleAddUpdateKernel(size_t size, typename SimdType::ElementType scalarA, const typename SimdType::ElementType* pA, typename SimdType::ElementType scalarB, typename SimdType::ElementType* pB)
+            {
+                using S = SimdType;
+                constexpr size_t width = S::width;
+
+                auto a = S::Set(scalarA);
+                auto b = S::Set(scalarB);
+                size_t i = 0;
+                if (scalarB == 1)
+                {
+                    for (; i + width <= size; i += width)
+                    {
+                        S::Store(pB + i, S::MultiplyAdd(a, S::Load(pA + i), S::Load(pB + i)));
+                    }
+                    for (; i < size; ++i)
+                    {
+                        pB[i] += scalarA * pA[i];
+                    }
+                }
+                else
+                {
+                    for (; i + width <= size; i += width)
+                    {
+                        S::Store(pB + i, S::MultiplyAdd(a, S::Load(pA + i), S::Multiply(b, S::Load(pB + i))));
+                    }
+                    for (; i < size; ++i)
+                    {
+                        pB[i] = scalarA * pA[i] + scalarB * pB[i];
+                    }
+                }
+            }
+
+            template <typename SimdType>
+            void ScaleUpdateKernel(size_t size, typename SimdType::ElementType scalar, typename SimdType::ElementType* pA)
+            {
+                using S = SimdType;
+                constexpr size_t width = S::width;
+
+                auto s = S::Set(scalar);
+                size_t i = 0;
+                for (; i + width <= size; i += width)
+                {
+                    S::Store(pA + i, S::Multiply(s, S::Load(pA + i)));
+                }
+                for (; i < size; ++i)
+                {
+                    pA[i] *= scalar;
+                }
+            }
+
+            template <typename SimdType>
+            KernelTable<typename SimdType::ElementType> MakeKernelTable()
+            {
+                return { &DotKernel<SimdType>, &AbsSumKernel<SimdType>, &ScaleAddUpdateKernel<SimdType>, &ScaleUpdateKernel<SimdType> };
+            }
+        }
+    }
+}
+}
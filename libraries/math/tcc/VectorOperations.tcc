@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "VectorKernels.h"
+
 // utilities
 #include "Debug.h"
 #include "Exception.h"
@@ -82,7 +84,7 @@ namespace math
     }
 
     template <typename ElementType>
-    ElementType ScaleFunction<ElementType>::operator()(ElementType x)
+    ElementType ScaleFunction<ElementType>::operator()(ElementType x) const
     { 
         return x * _value; 
     }
@@ -526,9 +528,60 @@ namespace math
     //
     namespace Internal
     {
+        // contiguous float and double vectors go to the SIMD kernels
+        template <typename ElementType>
+        bool ContiguousDot(size_t size, const ElementType* pA, const ElementType* pB, ElementType& result, std::true_type)
+        {
+            result = VectorKernels::Dot(size, pA, pB);
+            return true;
+        }
+
+        template <typename ElementType>
+        bool ContiguousDot(size_t, const ElementType*, const ElementType*, ElementType&, std::false_type)
+        {
+            return false;
+        }
+
+        template <typename ElementType>
+        bool ContiguousScaleAddUpdate(size_t size, ElementType scalarA, const ElementType* pA, ElementType scalarB, ElementType* pB, std::true_type)
+        {
+            VectorKernels::ScaleAddUpdate(size, scalarA, pA, scalarB, pB);
+            return true;
+        }
+
+        template <typename ElementType>
+        bool ContiguousScaleAddUpdate(size_t, ElementType, const ElementType*, ElementType, ElementType*, std::false_type)
+        {
+            return false;
+        }
+
+        template <typename ElementType>
+        bool ContiguousScaleUpdate(size_t size, ElementType scalar, ElementType* pA, std::true_type)
+        {
+            VectorKernels::ScaleUpdate(size, scalar, pA);
+            return true;
+        }
+
+        template <typename ElementType>
+        bool ContiguousScaleUpdate(size_t, ElementType, ElementType*, std::false_type)
+        {
+            return false;
+        }
+
+        template <typename ElementType, VectorOrientation orientation>
+        bool TryContiguousScaleAddUpdate(ElementType scalarA, ConstVectorReference<ElementType, orientation> vectorA, ElementType scalarB, VectorReference<ElementType, orientation> vectorB)
+        {
+            return vectorA.GetIncrement() == 1 && vectorB.GetIncrement() == 1 && ContiguousScaleAddUpdate(vectorB.Size(), scalarA, vectorA.GetConstDataPointer(), scalarB, vectorB.GetDataPointer(), VectorKernels::HasKernels<ElementType>{});
+        }
+
         template <typename ElementType>
         void VectorOperations<ImplementationType::native>::InnerProduct(ConstRowVectorReference<ElementType> vectorA, ConstColumnVectorReference<ElementType> vectorB, ElementType& result)
         {
+            if (vectorA.GetIncrement() == 1 && vectorB.GetIncrement() == 1 && ContiguousDot(vectorA.Size(), vectorA.GetConstDataPointer(), vectorB.GetConstDataPointer(), result, VectorKernels::HasKernels<ElementType>{}))
+            {
+                return;
+            }
+
             const ElementType* pVectorAData = vectorA.GetConstDataPointer();
             const ElementType* pVectorBData = vectorB.GetConstDataPointer();
             const ElementType* pVectorAEnd = pVectorAData + vectorA.GetIncrement() * vectorA.Size();
@@ -630,6 +683,10 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleUpdate(ElementType scalar, VectorReference<ElementType, orientation> vector)
         {
+            if (vector.GetIncrement() == 1 && ContiguousScaleUpdate(vector.Size(), scalar, vector.GetDataPointer(), VectorKernels::HasKernels<ElementType>{}))
+            {
+                return;
+            }
             UnaryVectorUpdateImplementation(vector, [scalar](ElementType& v) { v *= scalar; });
         }
 
@@ -644,6 +701,10 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleAddUpdate(ElementType scalarA, ConstVectorReference<ElementType, orientation> vectorA, One, VectorReference<ElementType, orientation> vectorB)
         {
+            if (TryContiguousScaleAddUpdate(scalarA, vectorA, static_cast<ElementType>(1), vectorB))
+            {
+                return;
+            }
             BinaryVectorUpdateImplementation(vectorA, vectorB, [scalarA](ElementType a, ElementType& b) { b += scalarA * a; });
         }
 
@@ -658,6 +719,10 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleAddUpdate(One, ConstVectorReference<ElementType, orientation> vectorA, ElementType scalarB, VectorReference<ElementType, orientation> vectorB)
         {
+            if (TryContiguousScaleAddUpdate(static_cast<ElementType>(1), vectorA, scalarB, vectorB))
+            {
+                return;
+            }
             BinaryVectorUpdateImplementation(vectorA, vectorB, [scalarB](ElementType a, ElementType& b) { b = a + scalarB * b; });
         }
 
@@ -665,6 +730,10 @@ namespace math
         template <typename ElementType, VectorOrientation orientation>
         void VectorOperations<ImplementationType::native>::ScaleAddUpdate(ElementType scalarA, ConstVectorReference<ElementType, orientation> vectorA, ElementType scalarB, VectorReference<ElementType, orientation> vectorB)
         {
+            if (TryContiguousScaleAddUpdate(scalarA, vectorA, scalarB, vectorB))
+            {
+                return;
+            }
             BinaryVectorUpdateImplementation(vectorA, vectorB, [scalarA, scalarB](ElementType a, ElementType& b) { b = scalarA * a + scalarB * b; });
         }
 
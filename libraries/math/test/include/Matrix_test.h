@@ -185,6 +185,9 @@ void TestMatrixMatrixMultiplyScaleAddUpdate();
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixElementwiseMultiplySet();
 
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixElementwiseExpressions();
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixRowwiseCumulativeSumUpdate();
 
@@ -40,6 +40,12 @@ void TestVectorNorm2Squared();
 template <typename ElementType>
 void TestVectorToArray();
 
+template <typename ElementType>
+void TestVectorKernels();
+
+template <typename ElementType>
+void TestVectorElementwiseExpressions();
+
 // ConstVectorReference
 
 template <typename ElementType, math::VectorOrientation orientation>
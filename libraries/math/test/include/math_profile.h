@@ -20,6 +20,9 @@ void ProfileVectorScaleAdd(size_t size, size_t repetitions, std::string seed = "
 template <typename ElementType>
 void ProfileVectorInner(size_t size, size_t repetitions, std::string seed = "123ABC");
 
+template <typename ElementType>
+void ProfileVectorKernels(size_t size, size_t repetitions, std::string seed = "123ABC");
+
 template <typename ElementType, math::MatrixLayout layout>
 void ProfileVectorOuter(size_t size, size_t repetitions, std::string seed = "123ABC");
 
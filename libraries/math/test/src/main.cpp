@@ -104,6 +104,8 @@ void RunVectorTests()
     TestVectorNorm2<ElementType>();
     TestVectorNorm2Squared<ElementType>();
     TestVectorToArray<ElementType>();
+    TestVectorKernels<ElementType>();
+    TestVectorElementwiseExpressions<ElementType>();
 
     RunOrientedVectorTests<ElementType, math::VectorOrientation::row>();
     RunOrientedVectorTests<ElementType, math::VectorOrientation::column>();
@@ -193,6 +195,7 @@ void RunLayoutMatrixTests()
     TestMatrixRowwiseSum<ElementType, layout>();
     TestMatrixColumnwiseSum<ElementType, layout>();
     TestMatrixElementwiseMultiplySet<ElementType, layout>();
+    TestMatrixElementwiseExpressions<ElementType, layout>();
     TestMatrixRowwiseCumulativeSumUpdate<ElementType, layout>();
     TestMatrixColumnwiseCumulativeSumUpdate<ElementType, layout>();
     TestMatrixRowwiseConsecutiveDifferenceUpdate<ElementType, layout>();
@@ -26,6 +26,14 @@ void RunProfile()
     ProfileVectorInner<ElementType>(10000, 10 * repetitions);
     ProfileVectorInner<ElementType>(1000000, repetitions);
 
+    // sizes typical of linear and ProtoNN trainers
+    ProfileVectorKernels<ElementType>(16, 10000 * repetitions);
+    ProfileVectorKernels<ElementType>(64, 10000 * repetitions);
+    ProfileVectorKernels<ElementType>(256, 1000 * repetitions);
+    ProfileVectorKernels<ElementType>(1024, 1000 * repetitions);
+    ProfileVectorKernels<ElementType>(16384, 100 * repetitions);
+    ProfileVectorKernels<ElementType>(1000000, repetitions);
+
     constexpr auto column = math::MatrixLayout::columnMajor;
     constexpr auto row = math::MatrixLayout::rowMajor;
 
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "ElementwiseExpressions.h"
 #include "Matrix.h"
 
 template <typename ElementType, math::MatrixLayout layout>
@@ -1344,6 +1345,55 @@ void TestMatrixElementwiseMultiplySet()
     testing::ProcessTest("ElementwiseMultiplySet(Matrix, Matrix, Matrix)", C == R);
 }
 
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixElementwiseExpressions()
+{
+    math::Matrix<ElementType, layout> M{
+        { 1, 2, 0 },
+        { 0, 3, 7 }
+    };
+
+    math::Matrix<ElementType, math::TransposeMatrixLayout<layout>::value> N{
+        { -1, 1, -1 },
+        { 1, 1, 2 }
+    };
+
+    math::Matrix<ElementType, layout> T{
+        { 1, 2 },
+        { 3, 4 },
+        { 5, 6 }
+    };
+
+    math::Matrix<ElementType, layout> C(2, 3);
+    math::Evaluate(2 * M - math::ElementwiseMultiply(M, N) + 1, C);
+
+    math::RowMatrix<ElementType> R1{
+        { 4, 3, 1 },
+        { 1, 4, 1 }
+    };
+
+    testing::ProcessTest("Evaluate(Matrix expression, Matrix)", C == R1);
+
+    C += math::ElementwiseTransform(T.Transpose() - N, [](ElementType x) { return x * x; });
+
+    math::RowMatrix<ElementType> R2{
+        { 8, 7, 37 },
+        { 2, 13, 17 }
+    };
+
+    testing::ProcessTest("Matrix += Matrix expression", C == R2);
+
+    auto D = C.GetSubMatrix(0, 1, 2, 2);
+    D -= -D * 0.5;
+
+    math::RowMatrix<ElementType> R3{
+        { 8, static_cast<ElementType>(10.5), static_cast<ElementType>(55.5) },
+        { 2, static_cast<ElementType>(19.5), static_cast<ElementType>(25.5) }
+    };
+
+    testing::ProcessTest("Matrix -= Matrix expression", C == R3);
+}
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixRowwiseCumulativeSumUpdate()
 {
@@ -7,6 +7,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // math
+#include "ElementwiseExpressions.h"
+#include "VectorKernels.h"
 #include "VectorOperations.h"
 
 // testing
@@ -16,7 +18,9 @@
 #include "JsonArchiver.h"
 
 // stl
+#include <cmath>
 #include <sstream>
+#include <vector>
 
 template <typename ElementType>
 void TestVectorIndexer()
@@ -1016,3 +1020,111 @@ void TestVectorArchiver()
 
     testing::ProcessTest("VectorArchiver", Va == V);
 }
+
+template <typename ElementType>
+void TestVectorKernels()
+{
+    using namespace math::VectorKernels;
+
+    // compare each supported instruction set with a reference computed in double precision, on sizes that exercise
+    // the unrolled loop, the single-register loop, and the scalar tail
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-5 : 1.0e-12;
+    auto close = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * (1.0 + std::abs(b)); };
+    auto originalInstructionSet = GetInstructionSet();
+
+    for (auto instructionSet : { InstructionSet::scalar, InstructionSet::sse2, InstructionSet::avx2, InstructionSet::avx512, InstructionSet::neon })
+    {
+        if (!IsSupported(instructionSet))
+        {
+            continue;
+        }
+        SetInstructionSet(instructionSet);
+
+        bool dotOk = true;
+        bool absSumOk = true;
+        bool scaleAddUpdateOk = true;
+        bool scaleUpdateOk = true;
+        bool vectorOk = true;
+        for (size_t size : { 0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 64, 67, 100 })
+        {
+            std::vector<ElementType> a(size);
+            std::vector<ElementType> b(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                a[i] = static_cast<ElementType>(std::sin(1.0 + i));
+                b[i] = static_cast<ElementType>(std::cos(2.0 * i));
+            }
+
+            double dot = 0;
+            double absSum = 0;
+            double squaredSum = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                dot += static_cast<double>(a[i]) * b[i];
+                absSum += std::abs(static_cast<double>(a[i]));
+                squaredSum += static_cast<double>(a[i]) * a[i];
+            }
+            dotOk = dotOk && close(Dot(size, a.data(), b.data()), dot);
+            absSumOk = absSumOk && close(AbsSum(size, a.data()), absSum);
+
+            auto c = b;
+            ScaleAddUpdate(size, static_cast<ElementType>(2), a.data(), static_cast<ElementType>(0.5), c.data());
+            auto d = b;
+            ScaleAddUpdate(size, static_cast<ElementType>(-3), a.data(), static_cast<ElementType>(1), d.data());
+            auto e = a;
+            ScaleUpdate(size, static_cast<ElementType>(1.5), e.data());
+            for (size_t i = 0; i < size; ++i)
+            {
+                scaleAddUpdateOk = scaleAddUpdateOk && close(c[i], 2.0 * a[i] + 0.5 * b[i]) && close(d[i], -3.0 * a[i] + b[i]);
+                scaleUpdateOk = scaleUpdateOk && close(e[i], 1.5 * a[i]);
+            }
+
+            // the vector operations that take the contiguous fast path
+            math::RowVector<ElementType> v(a);
+            math::RowVector<ElementType> u(b);
+            math::ScaleAddUpdate(static_cast<ElementType>(2), v, math::One(), u);
+            vectorOk = vectorOk && close(v.Norm1(), absSum) && close(v.Norm2Squared(), squaredSum);
+            for (size_t i = 0; i < size; ++i)
+            {
+                vectorOk = vectorOk && close(u[i], 2.0 * a[i] + b[i]);
+            }
+        }
+
+        auto name = GetInstructionSetName(instructionSet);
+        testing::ProcessTest("VectorKernels::Dot (" + name + ")", dotOk);
+        testing::ProcessTest("VectorKernels::AbsSum (" + name + ")", absSumOk);
+        testing::ProcessTest("VectorKernels::ScaleAddUpdate (" + name + ")", scaleAddUpdateOk);
+        testing::ProcessTest("VectorKernels::ScaleUpdate (" + name + ")", scaleUpdateOk);
+        testing::ProcessTest("VectorKernels contiguous vector operations (" + name + ")", vectorOk);
+    }
+
+    SetInstructionSet(originalInstructionSet);
+}
+
+template <typename ElementType>
+void TestVectorElementwiseExpressions()
+{
+    math::RowVector<ElementType> u{ 1, 2, 3, 4, 5 };
+    math::RowVector<ElementType> v{ 5, 4, 3, 2, 1 };
+    math::RowVector<ElementType> w(5);
+
+    math::Evaluate(u + 2.0 * v, w);
+    bool ok1 = w == math::RowVector<ElementType>{ 11, 10, 9, 8, 7 };
+
+    w -= math::ElementwiseMultiply(u, v) - 1;
+    bool ok2 = w == math::RowVector<ElementType>{ 7, 3, 1, 1, 3 };
+
+    math::Evaluate(-u + 0.5 * (u + v), w);
+    bool ok3 = w == math::RowVector<ElementType>{ 2, 1, 0, -1, -2 };
+
+    testing::ProcessTest("Evaluate(Vector expression, Vector)", ok1 && ok3);
+    testing::ProcessTest("Vector -= Vector expression", ok2);
+
+    // strided output
+    math::RowMatrix<ElementType> A(5, 2);
+    A.GetColumn(0) += u.Transpose() * 2;
+    A.GetColumn(1) += math::Square(v.Transpose()) - 1;
+    math::RowMatrix<ElementType> R{ { 2, 24 }, { 4, 15 }, { 6, 8 }, { 8, 3 }, { 10, 0 } };
+
+    testing::ProcessTest("Vector += Vector expression", A == R);
+}
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Vector.h"
+#include "VectorKernels.h"
 #include "VectorOperations.h"
 #include "MatrixOperations.h"
 
@@ -110,6 +111,50 @@ void ProfileVectorInner(size_t size, size_t repetitions, std::string seed)
     PrintLine("Dot(" + vector + ", " + vector + ")", native, singleBlas, multiBlas);
 }
 
+template <typename ElementType>
+void ProfileVectorKernels(size_t size, size_t repetitions, std::string seed)
+{
+    using namespace math::VectorKernels;
+
+    auto engine = utilities::GetRandomEngine(seed);
+    std::uniform_real_distribution<ElementType> uniform(-1, 1);
+    auto generator = [&]() { return uniform(engine); };
+
+    math::RowVector<ElementType> u(size);
+    u.Generate(generator);
+    math::RowVector<ElementType> v(size);
+    v.Generate(generator);
+    volatile ElementType sink = 0;
+
+    // times each instruction set relative to the scalar kernels
+    auto originalInstructionSet = GetInstructionSet();
+    double scalarDot = 0;
+    double scalarAbsSum = 0;
+    double scalarScaleAdd = 0;
+    std::string type = std::string("<") + typeid(ElementType).name() + ">";
+    std::cout << "VectorKernels" << type << "[" << size << "]";
+    for (auto instructionSet : { InstructionSet::scalar, InstructionSet::sse2, InstructionSet::avx2, InstructionSet::avx512, InstructionSet::neon })
+    {
+        if (!IsSupported(instructionSet))
+        {
+            continue;
+        }
+        SetInstructionSet(instructionSet);
+        double dot = GetTime([&]() { sink = Dot(size, u.GetConstDataPointer(), v.GetConstDataPointer()); }, repetitions);
+        double absSum = GetTime([&]() { sink = AbsSum(size, u.GetConstDataPointer()); }, repetitions);
+        double scaleAdd = GetTime([&]() { ScaleAddUpdate(size, static_cast<ElementType>(1.0e-6), u.GetConstDataPointer(), static_cast<ElementType>(1), v.GetDataPointer()); }, repetitions);
+        if (instructionSet == InstructionSet::scalar)
+        {
+            scalarDot = dot;
+            scalarAbsSum = absSum;
+            scalarScaleAdd = scaleAdd;
+        }
+        std::cout << "\t" << GetInstructionSetName(instructionSet) << ":" << scalarDot / dot << "/" << scalarAbsSum / absSum << "/" << scalarScaleAdd / scaleAdd;
+    }
+    std::cout << "\t(speedup of Dot/AbsSum/ScaleAddUpdate)" << std::endl;
+    SetInstructionSet(originalInstructionSet);
+}
+
 template <typename ElementType, math::MatrixLayout layout>
 void ProfileVectorOuter(size_t size, size_t repetitions, std::string seed)
 {
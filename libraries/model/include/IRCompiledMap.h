@@ -24,20 +24,36 @@
 
 // utilities
 #include "ConformingVector.h"
+#include "MillisecondTimer.h"
 #include "TypeName.h"
 
+// llvm
+#include <llvm/IR/LLVMContext.h>
+
 // stl
+#include <atomic>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace ell
 {
 namespace model
 {
+    /// <summary> Wall-clock time, in milliseconds, spent producing each tier of jitted code when tiered compilation is enabled. </summary>
+    struct TieredCompilationTimings
+    {
+        double unoptimizedTierTime = 0; // time to jit the unoptimized code
+        double optimizedTierTime = 0; // time the background thread spent optimizing and jitting
+        double swapTime = -1; // time from the start of jitting until the optimized code was swapped in, or -1 if it hasn't been yet
+    };
+
     /// <summary> A map that can be compiled </summary>
     class IRCompiledMap : public CompiledMap
     {
@@ -101,7 +117,7 @@ namespace model
         /// <returns> Reference to an IRModuleEmitter. </returns>
         emitters::IRModuleEmitter& GetModule() { return *_module; }
 
-        /// <summary> Gets a reference to the underlying jitter. </summary>
+        /// <summary> Gets a reference to the underlying jitter. With tiered compilation, this is the jitter for whichever tier is active. </summary>
         ///
         /// <returns> The jitter. </returns>
         emitters::IRExecutionEngine& GetJitter();
@@ -179,12 +195,95 @@ namespace model
         /// <summary> Force jitting to finish so you can time execution without jit cost. </summary>
         void FinishJitting() const;
 
+        //
+        // Zero-copy compute
+        //
+
+        /// <summary>
+        /// Compute the map's output directly from caller-owned memory, with no intermediate copies of the input or output.
+        /// </summary>
+        ///
+        /// <typeparam name="InputType"> The input element type, which must match the map's input port type. </typeparam>
+        /// <typeparam name="OutputType"> The output element type, which must match the map's output port type. </typeparam>
+        /// <param name="input"> Pointer to the input values (at least `GetInputSize()` of them). </param>
+        /// <param name="output"> Pointer to the buffer the output is written to (at least `GetOutputSize()` elements). </param>
+        template <typename InputType, typename OutputType>
+        void ComputeInto(const InputType* input, OutputType* output) const;
+
+        /// <summary>
+        /// Bind caller-owned input and output buffers for use by `ComputeBound`. The buffers must stay valid until
+        /// they're rebound or the map is destroyed.
+        /// </summary>
+        ///
+        /// <typeparam name="InputType"> The input element type, which must match the map's input port type. </typeparam>
+        /// <typeparam name="OutputType"> The output element type, which must match the map's output port type. </typeparam>
+        /// <param name="input"> Pointer to the input values (at least `GetInputSize()` of them). </param>
+        /// <param name="output"> Pointer to the buffer the output is written to (at least `GetOutputSize()` elements). </param>
+        template <typename InputType, typename OutputType>
+        void BindBuffers(const InputType* input, OutputType* output);
+
+        /// <summary> Compute the map's output from the bound input buffer, writing it straight into the bound output buffer. </summary>
+        void ComputeBound() const;
+
+        //
+        // Sparse compute
+        //
+
+        /// <summary>
+        /// Compute the output of a `SparseLinearPredictorNode` in the map directly from the nonzero entries of a sparse
+        /// input, without densifying it. Throws if the map has no such node, or if its output isn't of type ValueType.
+        /// </summary>
+        ///
+        /// <typeparam name="ValueType"> The value type of the SparseLinearPredictorNode. </typeparam>
+        /// <param name="indices"> Pointer to the indices of the nonzero entries. </param>
+        /// <param name="values"> Pointer to the values of the nonzero entries. </param>
+        /// <param name="count"> The number of nonzero entries. </param>
+        ///
+        /// <returns> The predictor's output. </returns>
+        template <typename ValueType>
+        ValueType ComputeSparse(const int* indices, const ValueType* values, int count) const;
+
+        /// <summary>
+        /// Compute the output of a `SparseLinearPredictorNode` in the map directly from the indices of the nonzero
+        /// entries of a sparse input whose nonzero entries are all 1. Throws if the map has no such node, or if its output
+        /// isn't of type ValueType.
+        /// </summary>
+        ///
+        /// <typeparam name="ValueType"> The value type of the SparseLinearPredictorNode. </typeparam>
+        /// <param name="indices"> Pointer to the indices of the nonzero entries. </param>
+        /// <param name="count"> The number of nonzero entries. </param>
+        ///
+        /// <returns> The predictor's output. </returns>
+        template <typename ValueType>
+        ValueType ComputeSparseBinary(const int* indices, int count) const;
+
         /// <summary> Set a context object to use in the predict call </summary>
         void SetContext(void* context) { _context = context; }
 
         /// <summary> Get the context object to use in the predict call </summary>
         void* GetContext() const { return _context; }
 
+        //
+        // Tiered compilation support
+        //
+        // Note: the optimized code is swapped in at the start of a compute call, once it's ready. The state of the model
+        // (e.g., delay buffers) is copied over at that point, and functions defined in the jitter with `DefineFunction`
+        // (e.g., source and sink callbacks) are defined in the optimized code as well.
+        //
+
+        /// <summary> Indicates if the optimized code has been swapped in. Always true if tiered compilation is disabled. </summary>
+        ///
+        /// <returns> true if the map is running fully-optimized code. </returns>
+        bool IsOptimizedCodeActive() const;
+
+        /// <summary> Block until the background compilation has finished and the optimized code has been swapped in. </summary>
+        void WaitForOptimizedCode() const;
+
+        /// <summary> Get the timings for each tier of tiered compilation, and when the swap happened. </summary>
+        ///
+        /// <returns> The tiered compilation timings. </returns>
+        TieredCompilationTimings GetTieredCompilationTimings() const;
+
     protected:
         void WriteCode(const std::string& filePath, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
         void WriteCode(std::ostream& stream, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
@@ -207,9 +306,19 @@ namespace model
         IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule);
 
         void EnsureExecutionEngine() const;
+        void StartOptimizedCompilation() const;
+        void SwapInOptimizedCode() const;
+        emitters::IRExecutionEngine& GetActiveExecutionEngine() const;
         void SetComputeFunction() const;
         template <typename InputType>
         void SetComputeFunctionForInputType() const;
+        template <typename FunctionType>
+        FunctionType GetComputeFunctionPointer() const;
+        template <typename InputType, typename OutputType>
+        void VerifyBufferTypes() const;
+        template <typename ValueType>
+        void VerifySparseValueType() const;
+        uint64_t GetSparseComputeFunctionAddress(bool hasValues) const;
 
         template <typename InputType>
         using ComputeFunction = std::function<void(void*, const InputType*)>;
@@ -220,11 +329,43 @@ namespace model
         mutable std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
         bool _verifyJittedModule = false;
         void* _context = nullptr;
+        // takes the map rather than capturing it, so that it stays valid when the map is moved
+        std::function<void(const IRCompiledMap&)> _computeBoundFunction;
+
+        // The addresses of the sparse compute functions, and the execution engine they were resolved in
+        mutable std::mutex _sparseComputeMutex;
+        mutable const emitters::IRExecutionEngine* _sparseComputeEngine = nullptr;
+        mutable uint64_t _sparseComputeFunctionAddress = 0;
+        mutable uint64_t _sparseBinaryComputeFunctionAddress = 0;
+
+        // The compute functions call through this address, so that tiered compilation can swap in optimized code
+        mutable std::atomic<uint64_t> _computeFunctionAddress;
+
+        // Tiered compilation state. The optimized code lives in its own context, so it can be compiled concurrently
+        // with the unoptimized code running. `_optimizedCompilation` is declared last so that it's destroyed first,
+        // waiting for the background thread to finish.
+        mutable std::mutex _tieredCompilationMutex;
+        mutable utilities::MillisecondTimer _tieredCompilationTimer;
+        mutable TieredCompilationTimings _tieredCompilationTimings;
+        mutable std::unique_ptr<llvm::LLVMContext> _optimizedContext;
+        mutable std::unique_ptr<emitters::IRExecutionEngine> _optimizedExecutionEngine;
+        mutable bool _optimizedCompilationStarted = false;
+
+        // The optimized code waiting to be swapped in (along with the functions that were defined in the jitter when it
+        // was compiled), and the name and size of each global variable that holds model state
+        mutable std::unique_ptr<llvm::LLVMContext> _pendingContext;
+        mutable std::unique_ptr<emitters::IRExecutionEngine> _pendingExecutionEngine;
+        mutable uint64_t _pendingFunctionAddress = 0;
+        mutable std::vector<std::pair<std::string, uint64_t>> _pendingDefinedFunctions;
+        mutable std::atomic<bool> _optimizedCodeReady;
+        mutable std::vector<std::pair<std::string, size_t>> _modelState;
 
         // Only one of the entries in each of these tuples is active, depending on the input and output types of the map
         mutable bool _computeFunctionDefined;
         mutable std::tuple<ComputeFunction<bool>, ComputeFunction<int>, ComputeFunction<int64_t>, ComputeFunction<float>, ComputeFunction<double>> _computeInputFunction;
         mutable std::tuple<utilities::ConformingVector<bool>, utilities::ConformingVector<int>, utilities::ConformingVector<int64_t>, utilities::ConformingVector<float>, utilities::ConformingVector<double>> _cachedOutput;
+
+        mutable std::future<void> _optimizedCompilation;
     };
 }
 }
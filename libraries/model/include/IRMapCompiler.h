@@ -31,6 +31,15 @@ namespace emitters
 
 namespace model
 {
+    /// <summary> Wall-clock time, in milliseconds, spent in each phase of compiling a map. </summary>
+    struct MapCompilerPhaseTimings
+    {
+        double refineTime = 0;
+        double modelOptimizationTime = 0;
+        double codeEmissionTime = 0;
+        double irOptimizationTime = 0;
+    };
+
     /// <summary> Compiles ELL Models to LLVM IR </summary>
     class IRMapCompiler : public MapCompiler
     {
@@ -59,6 +68,16 @@ namespace model
         /// <summary> Get the optimizer used by this compiler. </summary>
         ModelOptimizer& GetOptimizer() { return _optimizer; }
 
+        /// <summary> Gets the time spent in each phase of the most recent call to `Compile`. </summary>
+        ///
+        /// <returns> The per-phase compile timings. </returns>
+        const MapCompilerPhaseTimings& GetPhaseTimings() const { return _phaseTimings; }
+
+        /// <summary> Gets the number of nodes removed by the model optimizer during the most recent call to `Compile`. </summary>
+        ///
+        /// <returns> The number of nodes folded into constants or eliminated as dead code. </returns>
+        size_t GetNumNodesEliminated() const { return _numNodesEliminated; }
+
         //
         // Routines useful to Node implementers
         //
@@ -188,6 +207,9 @@ namespace model
 
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        MapCompilerPhaseTimings _phaseTimings;
+        size_t _numNodesEliminated = 0;
     };
 }
 }
@@ -151,6 +151,12 @@ namespace model
         /// <param name="optimizer"> The optimizer to use for optimizing the model. </param>
         void Optimize(const ModelOptimizer& optimizer);
 
+        /// <summary> Optimizes the model wrapped by this map. </summary>
+        ///
+        /// <param name="optimizer"> The optimizer to use for optimizing the model. </param>
+        /// <param name="context"> The optimizer context to use, which holds statistics about the optimization afterwards. </param>
+        void Optimize(const ModelOptimizer& optimizer, ModelOptimizerContext& context);
+
         /// <summary> Transforms the model wrapped by this map by applying a transformation function to each node </summary>
         ///
         /// <param name="transformFunction"> The function to apply on each node </param>
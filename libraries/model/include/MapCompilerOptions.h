@@ -34,6 +34,7 @@ namespace model
         std::string sourceFunctionName;
         std::string sinkFunctionName;
         bool verifyJittedModule = false;
+        bool tieredCompilation = false; // jit unoptimized code first, and swap in optimized code compiled in the background
         
         // optimizations
         ModelOptimizerOptions optimizerSettings;
@@ -147,6 +147,19 @@ namespace model
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         virtual bool IsCompilable(const MapCompiler* compiler) const { return false; }
 
+        /// <summary>
+        /// Indicates if this node's outputs depend only on the current values of its inputs (that is, the node keeps no
+        /// state between calls to `Compute` and has no side effects). Such nodes can be evaluated at compile time when
+        /// their inputs are constant.
+        /// </summary>
+        virtual bool IsPure() const { return false; }
+
+        /// <summary>
+        /// Indicates if computing this node does something other than set its outputs, such as calling user code. Such nodes
+        /// are kept by optimizations even when nothing uses their outputs.
+        /// </summary>
+        virtual bool HasSideEffects() const { return false; }
+
         /// <summary> Makes a copy of this node into the model being constructed by the transformer </summary>
         ///
         /// <param name="transformer"> The `ModelTransformer` object currently creating a new model </param>
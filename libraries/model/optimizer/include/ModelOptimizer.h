@@ -65,8 +65,22 @@ namespace model
         /// <summary> Returns the input node from the new model corresponding to the given input node on the input model </summary>
         InputNodeBase* GetCorrespondingInputNode(const InputNodeBase* node);
 
+        /// <summary> Marks port elements on the input model as outputs that the optimized model must still compute </summary>
+        void AddOutputs(const PortElementsBase& elements);
+
+        /// <summary> Returns the port elements on the input model that were marked as outputs </summary>
+        const std::vector<PortElementsBase>& GetOutputs() const { return _outputs; }
+
+        /// <summary> Records that an optimization pass removed nodes from the model </summary>
+        void AddNodesEliminated(size_t numNodes) { _numNodesEliminated += numNodes; }
+
+        /// <summary> Returns the total number of nodes removed by the optimization passes </summary>
+        size_t GetNumNodesEliminated() const { return _numNodesEliminated; }
+
     private:
         ModelTransformer _transformer;
+        std::vector<PortElementsBase> _outputs;
+        size_t _numNodesEliminated = 0;
     };
 
     /// <summary>
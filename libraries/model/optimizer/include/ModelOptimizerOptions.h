@@ -26,6 +26,8 @@ namespace model
     {
         // individual optimization settings
         bool fuseLinearFunctionNodes = true;
+        bool foldConstantNodes = true;
+        bool optimizeReorderDataNodes = true;
 
         PreferredConvolutionMethod preferredConvolutionMethod = PreferredConvolutionMethod::none;
     };
@@ -73,6 +73,11 @@ namespace model
         return _transformer.GetCorrespondingInputNode(node);
     }
 
+    void ModelOptimizerContext::AddOutputs(const PortElementsBase& elements)
+    {
+        _outputs.push_back(elements);
+    }
+
     //
     // ModelOptimizer
     //
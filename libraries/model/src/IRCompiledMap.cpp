@@ -16,7 +16,9 @@
 #include "Port.h"
 
 // emitters
+#include "IRMetadata.h"
 #include "IROptimizer.h"
+#include "LLVMUtilities.h"
 
 // utilities
 #include "Exception.h"
@@ -26,20 +28,65 @@
 #include <llvm/Transforms/Utils/Cloning.h>
 
 // stl
+#include <cstring>
 #include <sstream>
 
 namespace ell
 {
 namespace model
 {
+    namespace
+    {
+        // Gives the global variables that hold the model's state external linkage, so that the optimizer keeps them and
+        // they can be found by name in each tier of jitted code. Returns the name and size of each of them. Runtime
+        // bookkeeping, such as the thread pool's queue, belongs to the tier that created it and isn't included.
+        std::vector<std::pair<std::string, size_t>> ExposeModelState(llvm::Module& module)
+        {
+            std::vector<std::pair<std::string, size_t>> state;
+            const auto& dataLayout = module.getDataLayout();
+            for (auto& global : module.globals())
+            {
+                if (global.isConstant() || global.isDeclaration() || global.getMetadata(emitters::c_runtimeGlobalTagName) != nullptr)
+                {
+                    continue;
+                }
+                if (!global.hasName())
+                {
+                    global.setName("modelState");
+                }
+                global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+                state.emplace_back(global.getName().str(), static_cast<size_t>(dataLayout.getTypeAllocSize(global.getValueType())));
+            }
+            return state;
+        }
+    }
+
     IRCompiledMap::IRCompiledMap(IRCompiledMap&& other)
-        : CompiledMap(std::move(other), other._functionName, other._compilerOptions), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _verifyJittedModule(other._verifyJittedModule), _computeFunctionDefined(false)
+        : CompiledMap(std::move(other), other._functionName, other._compilerOptions), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _verifyJittedModule(other._verifyJittedModule), _computeFunctionAddress(0), _optimizedCodeReady(false), _computeFunctionDefined(false)
     {
+        // The background compilation refers to `other`, so it has to finish before its results can be moved
+        if (other._optimizedCompilation.valid())
+        {
+            other._optimizedCompilation.wait();
+        }
+        _tieredCompilationTimer = other._tieredCompilationTimer;
+        _tieredCompilationTimings = other._tieredCompilationTimings;
+        _optimizedContext = std::move(other._optimizedContext);
+        _optimizedExecutionEngine = std::move(other._optimizedExecutionEngine);
+        _optimizedCompilationStarted = other._optimizedCompilationStarted;
+        _pendingContext = std::move(other._pendingContext);
+        _pendingExecutionEngine = std::move(other._pendingExecutionEngine);
+        _pendingFunctionAddress = other._pendingFunctionAddress;
+        _pendingDefinedFunctions = std::move(other._pendingDefinedFunctions);
+        _optimizedCodeReady = other._optimizedCodeReady.load();
+        _modelState = std::move(other._modelState);
+        _optimizedCompilation = std::move(other._optimizedCompilation);
+        _computeBoundFunction = std::move(other._computeBoundFunction);
     }
 
     // private constructor:
     IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule)
-        : CompiledMap(std::move(map), functionName, options), _module(std::move(module)), _verifyJittedModule(verifyJittedModule), _computeFunctionDefined(false)
+        : CompiledMap(std::move(map), functionName, options), _module(std::move(module)), _verifyJittedModule(verifyJittedModule), _computeFunctionAddress(0), _optimizedCodeReady(false), _computeFunctionDefined(false)
     {
         _moduleName = _module->GetModuleName();
     }
@@ -52,7 +99,13 @@ namespace model
     emitters::IRExecutionEngine& IRCompiledMap::GetJitter()
     {
         EnsureExecutionEngine();
-        return *_executionEngine;
+        return GetActiveExecutionEngine();
+    }
+
+    emitters::IRExecutionEngine& IRCompiledMap::GetActiveExecutionEngine() const
+    {
+        std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+        return _optimizedExecutionEngine ? *_optimizedExecutionEngine : *_executionEngine;
     }
 
     void IRCompiledMap::EnsureExecutionEngine() const
@@ -60,7 +113,16 @@ namespace model
         if (!_executionEngine)
         {
             auto moduleClone = std::unique_ptr<llvm::Module>(llvm::CloneModule(_module->GetLLVMModule()));
-            _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            if (_compilerOptions.tieredCompilation)
+            {
+                _tieredCompilationTimer.Start();
+                _modelState = ExposeModelState(*moduleClone);
+                _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule, llvm::CodeGenOpt::None);
+            }
+            else
+            {
+                _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            }
         }
     }
 
@@ -68,6 +130,146 @@ namespace model
     {
         EnsureExecutionEngine();
         SetComputeFunction();
+
+        // The background compilation is started only once the unoptimized compute function is in place, so the swap can't be overwritten
+        if (_compilerOptions.tieredCompilation && !_optimizedCompilationStarted)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+                _tieredCompilationTimings.unoptimizedTierTime = static_cast<double>(_tieredCompilationTimer.Elapsed());
+            }
+            StartOptimizedCompilation();
+        }
+        else if (_optimizedCodeReady.load(std::memory_order_acquire))
+        {
+            SwapInOptimizedCode();
+        }
+    }
+
+    void IRCompiledMap::StartOptimizedCompilation() const
+    {
+        _optimizedCompilationStarted = true;
+
+        // LLVM objects can only be used concurrently if they belong to different contexts, so the module
+        // is handed to the background thread as bitcode
+        auto bitcode = emitters::WriteBitcodeToString(*_module->GetLLVMModule());
+        auto optimize = _compilerOptions.compilerSettings.optimize;
+        auto definedFunctions = _executionEngine->GetDefinedFunctions();
+
+        // The optimizer uses the same target as the jitter, so it gets the target's CPU features and cost model
+        auto targetMachine = std::shared_ptr<llvm::TargetMachine>(_module->GetTargetMachine());
+        _optimizedCompilation = std::async(std::launch::async, [this, bitcode, optimize, definedFunctions, targetMachine]() {
+            utilities::MillisecondTimer timer;
+            auto context = std::make_unique<llvm::LLVMContext>();
+            auto module = emitters::ReadBitcodeFromString(bitcode, *context);
+            ExposeModelState(*module);
+            if (optimize)
+            {
+                emitters::IROptimizer optimizer(*module, targetMachine.get());
+                optimizer.AddStandardPasses();
+                for (auto& function : *module)
+                {
+                    optimizer.OptimizeFunction(&function);
+                }
+                optimizer.OptimizeModule(module.get());
+            }
+
+            auto engine = std::make_unique<emitters::IRExecutionEngine>(std::move(module), _verifyJittedModule, llvm::CodeGenOpt::Aggressive);
+            for (const auto& definedFunction : definedFunctions)
+            {
+                engine->DefineFunction(definedFunction.first, definedFunction.second);
+            }
+            auto functionAddress = engine->ResolveFunctionAddress(_functionName);
+            auto optimizedTierTime = static_cast<double>(timer.Elapsed());
+
+            // The code is swapped in by the next compute call, so that the model's state isn't copied while it's being updated
+            std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+            _pendingContext = std::move(context);
+            _pendingExecutionEngine = std::move(engine);
+            _pendingFunctionAddress = functionAddress;
+            _pendingDefinedFunctions = definedFunctions;
+            _tieredCompilationTimings.optimizedTierTime = optimizedTierTime;
+            _optimizedCodeReady.store(true, std::memory_order_release);
+        });
+    }
+
+    void IRCompiledMap::SwapInOptimizedCode() const
+    {
+        {
+            std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+            if (!_pendingExecutionEngine)
+            {
+                return;
+            }
+
+            _optimizedCodeReady.store(false, std::memory_order_release);
+            if (_executionEngine->GetDefinedFunctions() == _pendingDefinedFunctions)
+            {
+                // The optimized code picks up where the unoptimized code left off
+                for (const auto& state : _modelState)
+                {
+                    auto source = _executionEngine->GetGlobalValueAddress(state.first);
+                    auto destination = _pendingExecutionEngine->GetGlobalValueAddress(state.first);
+                    if (source == 0 || destination == 0)
+                    {
+                        throw emitters::EmitterException(emitters::EmitterError::unexpected, "Model state variable " + state.first + " not found in jitted code");
+                    }
+                    std::memcpy(reinterpret_cast<void*>(destination), reinterpret_cast<const void*>(source), state.second);
+                }
+
+                _optimizedContext = std::move(_pendingContext);
+                _optimizedExecutionEngine = std::move(_pendingExecutionEngine);
+                _computeFunctionAddress.store(_pendingFunctionAddress, std::memory_order_release);
+                _tieredCompilationTimings.swapTime = static_cast<double>(_tieredCompilationTimer.Elapsed());
+                return;
+            }
+
+            // Functions were defined in the jitter after the background compilation started, and the optimized code
+            // was linked without them, so it's thrown away (the engine before the context it belongs to)
+            _pendingExecutionEngine.reset();
+            _pendingContext.reset();
+        }
+
+        if (_optimizedCompilation.valid())
+        {
+            _optimizedCompilation.get();
+        }
+        StartOptimizedCompilation();
+    }
+
+    bool IRCompiledMap::IsOptimizedCodeActive() const
+    {
+        if (!_compilerOptions.tieredCompilation)
+        {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+        return _optimizedExecutionEngine != nullptr;
+    }
+
+    void IRCompiledMap::WaitForOptimizedCode() const
+    {
+        if (!_compilerOptions.tieredCompilation)
+        {
+            return;
+        }
+
+        FinishJitting();
+
+        // The optimized code is compiled again if functions were defined in the meantime, so this may take more than one round
+        while (!IsOptimizedCodeActive() && _optimizedCompilation.valid())
+        {
+            // rethrows any error from the background compilation
+            _optimizedCompilation.get();
+            SwapInOptimizedCode();
+        }
+    }
+
+    TieredCompilationTimings IRCompiledMap::GetTieredCompilationTimings() const
+    {
+        std::lock_guard<std::mutex> lock(_tieredCompilationMutex);
+        return _tieredCompilationTimings;
     }
 
     void IRCompiledMap::SetComputeFunction() const
@@ -99,6 +301,32 @@ namespace model
         }
     }
 
+    void IRCompiledMap::ComputeBound() const
+    {
+        if (!_computeBoundFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "No buffers bound to the compiled map");
+        }
+        _computeBoundFunction(*this);
+    }
+
+    uint64_t IRCompiledMap::GetSparseComputeFunctionAddress(bool hasValues) const
+    {
+        FinishJitting();
+        auto& engine = GetActiveExecutionEngine();
+
+        // Resolve the functions again when tiered compilation swaps in the optimized code. Their names match the ones
+        // that SparseLinearPredictorNode gives them.
+        std::lock_guard<std::mutex> lock(_sparseComputeMutex);
+        if (&engine != _sparseComputeEngine)
+        {
+            _sparseComputeFunctionAddress = engine.ResolveFunctionAddress(_moduleName + "_PredictSparse");
+            _sparseBinaryComputeFunctionAddress = engine.ResolveFunctionAddress(_moduleName + "_PredictSparseBinary");
+            _sparseComputeEngine = &engine;
+        }
+        return hasValues ? _sparseComputeFunctionAddress : _sparseBinaryComputeFunctionAddress;
+    }
+
     void IRCompiledMap::SetNodeInput(model::InputNode<bool>* node, const std::vector<bool>& inputValues) const
     {
         FinishJitting();
@@ -22,6 +22,7 @@
 
 // utils
 #include "Logger.h"
+#include "MillisecondTimer.h"
 
 // stl
 #include <tuple>
@@ -123,6 +124,10 @@ namespace model
         Log() << "Compile called for map" << EOL;
         EnsureValidMap(map);
 
+        _phaseTimings = {};
+        _numNodesEliminated = 0;
+        utilities::MillisecondTimer timer;
+
         //
         // Temporary special-purpose code to allow the "SetConvolutionMethod" optimization pass to work.
         // When refinement is an integrated part of optimization, then this special-case code will disappear.
@@ -130,21 +135,34 @@ namespace model
         Log() << "Refining the model..." << EOL;
         model::TransformContext noRefineConvNodesContext{ this, [this](const model::Node& node) { return IsConvolutionalLayerNode(node) || node.IsCompilable(this) ? model::NodeAction::compile : model::NodeAction::refine; } };
         map.Refine(noRefineConvNodesContext);
+        _phaseTimings.refineTime += timer.Elapsed();
 
         Log() << "Optimizing the model..." << EOL;
-        map.Optimize(_optimizer);
+        timer.Start();
+        ModelOptimizerContext optimizerContext;
+        map.Optimize(_optimizer, optimizerContext);
+        _numNodesEliminated += optimizerContext.GetNumNodesEliminated();
+        _phaseTimings.modelOptimizationTime += timer.Elapsed();
 
         Log() << "Refining the model again..." << EOL;
+        timer.Start();
         model::TransformContext refineContext{ this, [this](const model::Node& node) { return node.IsCompilable(this) ? model::NodeAction::compile : model::NodeAction::refine; } };
         map.Refine(refineContext);
+        _phaseTimings.refineTime += timer.Elapsed();
 
         Log() << "Optimizing the model again..." << EOL;
-        map.Optimize(_optimizer);
+        timer.Start();
+        ModelOptimizerContext secondOptimizerContext;
+        map.Optimize(_optimizer, secondOptimizerContext);
+        _numNodesEliminated += secondOptimizerContext.GetNumNodesEliminated();
+        _phaseTimings.modelOptimizationTime += timer.Elapsed();
+        Log() << "Optimization passes eliminated " << _numNodesEliminated << " nodes" << EOL;
 
         // Renaming callbacks based on map compiler parameters
         // Note: a more elegant solution is emit variables which get assigned to
         // function pointers at runtime (prior to computing the map).
         Log() << "Renaming callbacks..." << EOL;
+        timer.Start();
         map.RenameCallbacks(GetMapCompilerOptions().sourceFunctionName, GetMapCompilerOptions().sinkFunctionName);
 
         // Now the model ready for compiling
@@ -165,11 +183,15 @@ namespace model
 
         // Finish any profiling stuff we need to do and emit functions
         _profiler.EmitModelProfilerFunctions();
+        _phaseTimings.codeEmissionTime = timer.Elapsed();
 
         auto module = std::make_unique<emitters::IRModuleEmitter>(std::move(_moduleEmitter));
 
-        if (GetMapCompilerOptions().compilerSettings.optimize)
+        // In tiered mode, the compiled map optimizes its own copy of the module in the background
+        if (GetMapCompilerOptions().compilerSettings.optimize && !GetMapCompilerOptions().tieredCompilation)
         {
+            timer.Start();
+
             // Save callback declarations in case they get optimized away
             std::vector<std::tuple<std::string, llvm::FunctionType*, std::vector<std::string>>> savedCallbacks;
             auto callbacks = emitters::GetFunctionsWithTag(*module, emitters::c_callbackFunctionTagName);
@@ -178,9 +200,17 @@ namespace model
                 savedCallbacks.emplace_back(callbackInfo.function->getName(), callbackInfo.function->getFunctionType(), callbackInfo.values);
             }
 
-            emitters::IROptimizer optimizer(*module);
-            optimizer.AddStandardPasses();
-            module->Optimize(optimizer);
+            if (module->GetCompilerOptions().compileThreads > 1)
+            {
+                Log() << "Optimizing module on " << module->GetCompilerOptions().compileThreads << " threads..." << EOL;
+                module->OptimizeInParallel();
+            }
+            else
+            {
+                emitters::IROptimizer optimizer(*module);
+                optimizer.AddStandardPasses();
+                module->Optimize(optimizer);
+            }
 
             // Reinsert callback declarations after optimization
             for (const auto& savedCallback : savedCallbacks)
@@ -189,6 +219,7 @@ namespace model
                 module->DeclareFunction(functionName, std::get<1>(savedCallback));
                 module->IncludeInCallbackInterface(functionName, std::get<2>(savedCallback)[0]);
             }
+            _phaseTimings.irOptimizationTime = timer.Elapsed();
         }
 
         return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), std::move(module), GetMapCompilerOptions().verifyJittedModule);
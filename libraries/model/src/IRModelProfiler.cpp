@@ -290,6 +290,11 @@ namespace model
         // Note: We're grossly overallocating global array for types
         _nodeTypeInfoArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypeInfoArray", _nodeInfoType, numNodes);
         _nodeTypePerformanceCountersArray = _module->GlobalArray(GetNamespacePrefix() + "_NodeTypePerformanceCountersArray", _performanceCountersType, numNodes);
+
+        for (auto array : { _modelPerformanceCountersArray, _nodeInfoArray, _nodePerformanceCountersArray, _nodeTypeInfoArray, _nodeTypePerformanceCountersArray })
+        {
+            _module->IncludeInRuntimeGlobals(array);
+        }
     }
 
     std::string ModelProfiler::GetNamespacePrefix() const
@@ -403,6 +403,15 @@ namespace model
     void Map::Optimize(const ModelOptimizer& optimizer)
     {
         ModelOptimizerContext context;
+        Optimize(optimizer, context);
+    }
+
+    void Map::Optimize(const ModelOptimizer& optimizer, ModelOptimizerContext& context)
+    {
+        for (const auto& outputElements : _outputElements)
+        {
+            context.AddOutputs(outputElements);
+        }
         auto optimizedModel = optimizer.OptimizeModel(_model, context);
         FixTransformedIO(context);
         _model = std::move(optimizedModel);
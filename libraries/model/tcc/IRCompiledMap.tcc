@@ -17,7 +17,7 @@ namespace model
         {
             _computeFunctionDefined = true;
             auto outputSize = GetOutput(0).Size();
-            auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName);
+            _computeFunctionAddress = GetActiveExecutionEngine().ResolveFunctionAddress(_functionName);
             ComputeFunction<InputType> computeFunction;
             switch (GetOutput(0).GetPortType()) // Switch on output type
             {
@@ -27,16 +27,16 @@ namespace model
                 if (GetInput(0)->Size() == 1)
                 {
                     // scalar input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType, bool*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType, bool*)>();
                         fn(context, *input, (bool*)std::get<utilities::ConformingVector<bool>>(_cachedOutput).data());
                     };
                 }
                 else
                 {
                     // vector input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType*, bool*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType*, bool*)>();
                         fn(context, input, (bool*)std::get<utilities::ConformingVector<bool>>(_cachedOutput).data());
                     };
                 }
@@ -49,16 +49,16 @@ namespace model
                 if (GetInput(0)->Size() == 1)
                 {
                     // scalar input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType, int*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType, int*)>();
                         fn(context, *input, std::get<utilities::ConformingVector<int>>(_cachedOutput).data());
                     };
                 }
                 else
                 {
                     // vector input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType*, int*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType*, int*)>();
                         fn(context, input, std::get<utilities::ConformingVector<int>>(_cachedOutput).data());
                     };
                 }
@@ -71,16 +71,16 @@ namespace model
                 if (GetInput(0)->Size() == 1)
                 {
                     // scalar input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType, int64_t*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType, int64_t*)>();
                         fn(context, *input, std::get<utilities::ConformingVector<int64_t>>(_cachedOutput).data());
                     };
                 }
                 else
                 {
                     // vector input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType*, int64_t*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType*, int64_t*)>();
                         fn(context, input, std::get<utilities::ConformingVector<int64_t>>(_cachedOutput).data());
                     };
                 }
@@ -93,16 +93,16 @@ namespace model
                 if (GetInput(0)->Size() == 1)
                 {
                     // scalar input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType, float*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType, float*)>();
                         fn(context, *input, std::get<utilities::ConformingVector<float>>(_cachedOutput).data());
                     };
                 }
                 else
                 {
                     // vector input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType*, float*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType*, float*)>();
                         fn(context, input, std::get<utilities::ConformingVector<float>>(_cachedOutput).data());
                     };
                 }
@@ -115,16 +115,16 @@ namespace model
                 if (GetInput(0)->Size() == 1)
                 {
                     // scalar input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType, double*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType, double*)>();
                         fn(context, *input, std::get<utilities::ConformingVector<double>>(_cachedOutput).data());
                     };
                 }
                 else
                 {
                     // vector input
-                    auto fn = reinterpret_cast<void(*)(void*, const InputType*, double*)>(functionPointer);
-                    computeFunction = [this, fn](void* context, const InputType* input) {
+                    computeFunction = [this](void* context, const InputType* input) {
+                        auto fn = GetComputeFunctionPointer<void(*)(void*, const InputType*, double*)>();
                         fn(context, input, std::get<utilities::ConformingVector<double>>(_cachedOutput).data());
                     };
                 }
@@ -138,5 +138,75 @@ namespace model
             std::get<ComputeFunction<InputType>>(_computeInputFunction) = computeFunction;
         }
     }
+
+    template <typename FunctionType>
+    FunctionType IRCompiledMap::GetComputeFunctionPointer() const
+    {
+        return reinterpret_cast<FunctionType>(_computeFunctionAddress.load(std::memory_order_acquire));
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::VerifyBufferTypes() const
+    {
+        if (GetInput(0)->GetOutputPort().GetType() != model::Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != model::Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+    }
+
+    template <typename ValueType>
+    void IRCompiledMap::VerifySparseValueType() const
+    {
+        // the sparse functions return the value type of the SparseLinearPredictorNode, which is the map's output
+        if (GetOutput(0).GetPortType() != model::Port::GetPortType<ValueType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "ComputeSparse value type must match the map's output type");
+        }
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::ComputeInto(const InputType* input, OutputType* output) const
+    {
+        FinishJitting();
+        VerifyBufferTypes<InputType, OutputType>();
+
+        if (GetInput(0)->Size() == 1)
+        {
+            // scalar input
+            auto fn = GetComputeFunctionPointer<void (*)(void*, const InputType, OutputType*)>();
+            fn(GetContext(), *input, output);
+        }
+        else
+        {
+            // vector input
+            auto fn = GetComputeFunctionPointer<void (*)(void*, const InputType*, OutputType*)>();
+            fn(GetContext(), input, output);
+        }
+    }
+
+    template <typename ValueType>
+    ValueType IRCompiledMap::ComputeSparse(const int* indices, const ValueType* values, int count) const
+    {
+        VerifySparseValueType<ValueType>();
+        auto fn = reinterpret_cast<ValueType (*)(const int*, const ValueType*, int)>(GetSparseComputeFunctionAddress(true));
+        return fn(indices, values, count);
+    }
+
+    template <typename ValueType>
+    ValueType IRCompiledMap::ComputeSparseBinary(const int* indices, int count) const
+    {
+        VerifySparseValueType<ValueType>();
+        auto fn = reinterpret_cast<ValueType (*)(const int*, int)>(GetSparseComputeFunctionAddress(false));
+        return fn(indices, count);
+    }
+
+    template <typename InputType, typename OutputType>
+    void IRCompiledMap::BindBuffers(const InputType* input, OutputType* output)
+    {
+        VerifyBufferTypes<InputType, OutputType>();
+        _computeBoundFunction = [input, output](const IRCompiledMap& map) {
+            map.ComputeInto(input, output);
+        };
+    }
 }
 }
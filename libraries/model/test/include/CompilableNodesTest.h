@@ -89,6 +89,9 @@ void TestFusedLinearLayerNodes(size_t rows, size_t columns, size_t channels);
 void TestRecurrentNode();
 void TestGRUNode();
 void TestLSTMNode();
+void TestLSTMNodeSequence();
+void TestRecurrentLayerNodeWindow();
 void TestRegionDetectionNode();
+void TestRegionDetectionPostProcessingNode();
 
 #include "../tcc/CompilableNodesTest.tcc"
@@ -37,8 +37,18 @@ void TestForest();
 void TestForestMap();
 
 void TestSimpleMap(bool optimize);
+void TestParallelOptimizedMap();
+void TestTieredCompiledMap();
+void TestTieredCompiledMapWithState();
+void TestTieredCompiledMapWithCallbacks();
+void TestTieredCompiledMapWithThreadPool();
+void TestTieredCompiledMapWithLateCallback();
+void TestCompiledMapBoundBuffers();
 void TestSqEuclideanDistanceMap();
 void TestProtoNNPredictorMap();
+void TestProtoNNKernelNode();
+void TestSparseLinearPredictorNode();
+void TestMultiClassLinearPredictorNode();
 void TestMultiOutputMap();
 void TestMultiOutputMap2();
 void TestMultiSourceSinkMap();
@@ -59,10 +59,12 @@
 #include "ReceptiveFieldMatrixNode.h"
 #include "RecurrentLayerNode.h"
 #include "RegionDetectionLayerNode.h"
+#include "RegionDetectionPostProcessingNode.h"
 #include "ReorderDataNode.h"
 #include "SinkNode.h"
 #include "SoftmaxLayerNode.h"
 #include "SourceNode.h"
+#include "StackedGateWeights.h"
 #include "SumNode.h"
 #include "TypeCastNode.h"
 #include "UnaryOperationNode.h"
@@ -2953,6 +2955,217 @@ void TestLSTMNode()
     VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName());
 }
 
+void TestLSTMNodeSequence()
+{
+    using ElementType = double;
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+
+    VectorType inputBias = VectorType({ 0.747351, -0.112848, 0.0 });
+    VectorType forgetMeBias = VectorType({ 1.0, 1.0, 1.0 });
+    VectorType candidateBias = VectorType({ 0.733668, 0.000431956, 0.0 });
+    VectorType outputBias = VectorType({ 0.385433, 0.0, 0.0 });
+
+    MatrixType inputWeights(3, 7);
+    MatrixType forgetMeWeights(3, 7);
+    MatrixType candidateWeights(3, 7);
+    MatrixType outputWeights(3, 7);
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 7; ++j)
+        {
+            inputWeights(i, j) = iData[7 * i + j];
+            forgetMeWeights(i, j) = fData[7 * i + j];
+            candidateWeights(i, j) = cData[7 * i + j];
+            outputWeights(i, j) = oData[7 * i + j];
+        }
+    }
+
+    TensorType input(1, 1, 4);
+    Shape outputShape = { 1, 1, 3 };
+    LayerParameters parameters{ input, NoPadding(), outputShape, NoPadding() };
+    LSTMParameters<ElementType> lstmParams{ inputWeights, forgetMeWeights, candidateWeights, outputWeights, inputBias, forgetMeBias, candidateBias, outputBias };
+    LSTMLayer<ElementType, TanhActivation, SigmoidActivation> lstm(parameters, lstmParams);
+
+    // Two windows of 3 timesteps each, so the state carried between calls is tested as well
+    const size_t numTimesteps = 3;
+    const size_t numWindows = 2;
+    std::vector<std::vector<ElementType>> signal(numWindows, std::vector<ElementType>(numTimesteps * input.Size()));
+    std::vector<std::vector<ElementType>> expectedOutput(numWindows);
+    for (size_t window = 0; window < numWindows; ++window)
+    {
+        FillVector(signal[window], static_cast<ElementType>(window) - 1.0, 0.25);
+        for (size_t timestep = 0; timestep < numTimesteps; ++timestep)
+        {
+            for (size_t index = 0; index < input.Size(); ++index)
+            {
+                input(0, 0, index) = signal[window][timestep * input.Size() + index];
+            }
+            lstm.Compute();
+            auto output = lstm.GetOutput().ToArray();
+            expectedOutput[window].insert(expectedOutput[window].end(), output.begin(), output.end());
+        }
+    }
+
+    // Create model with a fused node that processes a whole window per call. Each timestep of its input is padded
+    // on both sides, and the padding is filled with garbage that the node must skip.
+    const size_t inputSize = input.Size();
+    const int padding = 1;
+    std::vector<math::ConstRowMatrixReference<ElementType>> gateWeights = { inputWeights, forgetMeWeights, candidateWeights, outputWeights };
+    std::vector<math::ConstColumnVectorReference<ElementType>> gateBiases = { inputBias, forgetMeBias, candidateBias, outputBias };
+    model::PortMemoryLayout inputLayout({ static_cast<int>(numTimesteps), static_cast<int>(inputSize) }, { 0, padding });
+    model::PortMemoryLayout outputLayout({ static_cast<int>(numTimesteps), 3 });
+
+    std::vector<std::vector<ElementType>> paddedSignal(numWindows, std::vector<ElementType>(inputLayout.GetMemorySize(), 100.0));
+    for (size_t window = 0; window < numWindows; ++window)
+    {
+        for (int timestep = 0; timestep < static_cast<int>(numTimesteps); ++timestep)
+        {
+            for (int index = 0; index < static_cast<int>(inputSize); ++index)
+            {
+                paddedSignal[window][inputLayout.GetEntryOffset({ timestep, index })] = signal[window][timestep * inputSize + index];
+            }
+        }
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputLayout.GetMemorySize());
+    auto inputWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(nodes::StackGateInputWeights(gateWeights, inputSize));
+    auto recurrentWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(nodes::StackGateRecurrentWeights(gateWeights, inputSize));
+    auto biasNode = model.AddNode<nodes::ConstantNode<ElementType>>(nodes::StackGateBiases(gateBiases));
+    auto computeNode = model.AddNode<nodes::LSTMNode<ElementType, TanhActivation, SigmoidActivation>>(inputNode->output, inputWeightsNode->output, recurrentWeightsNode->output, biasNode->output, inputLayout, outputLayout, numTimesteps);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    // Compile model
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.useBlas = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    bool ok = true;
+    for (size_t window = 0; window < numWindows; ++window)
+    {
+        map.SetInputValue(0, paddedSignal[window]);
+        auto computedResult = map.ComputeOutput<ElementType>(0);
+        compiledMap.SetInputValue(0, paddedSignal[window]);
+        auto compiledResult = compiledMap.ComputeOutput<ElementType>(0);
+        ok = ok && testing::IsEqual(computedResult, expectedOutput[window], 1e-6) && testing::IsEqual(compiledResult, expectedOutput[window], 1e-6);
+    }
+    testing::ProcessTest("Testing LSTMNode with a window of padded timesteps", ok);
+}
+
+template <typename LayerNodeType, typename FusedNodeType>
+void VerifyRecurrentLayerNodeWindow(const typename LayerNodeType::LayerType& layer, size_t numTimesteps)
+{
+    using ElementType = double;
+    const size_t inputSize = layer.GetInputShape().Size();
+    const size_t numWindows = 2;
+    std::vector<std::vector<ElementType>> signal(numWindows, std::vector<ElementType>(numTimesteps * inputSize));
+    for (size_t window = 0; window < numWindows; ++window)
+    {
+        FillVector(signal[window], static_cast<ElementType>(window) - 1.0, 0.25);
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(numTimesteps * inputSize);
+    auto computeNode = model.AddNode<LayerNodeType>(inputNode->output, layer, numTimesteps);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    // Refining the map replaces the layer node with the fused node, which then computes on the host
+    auto refinedMap = map;
+    refinedMap.Refine();
+
+    // The fused node must survive archiving
+    utilities::SerializationContext context;
+    common::RegisterNodeTypes(context);
+    context.GetTypeFactory().AddType<model::Node, FusedNodeType>();
+    std::stringstream strstream;
+    utilities::JsonArchiver archiver(strstream);
+    archiver << refinedMap;
+    utilities::JsonUnarchiver unarchiver(strstream, context);
+    model::Map unarchivedMap;
+    unarchiver >> unarchivedMap;
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.useBlas = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    bool ok = true;
+    for (const auto& input : signal)
+    {
+        map.SetInputValue(0, input);
+        auto expectedResult = map.ComputeOutput<ElementType>(0);
+        refinedMap.SetInputValue(0, input);
+        auto refinedResult = refinedMap.ComputeOutput<ElementType>(0);
+        unarchivedMap.SetInputValue(0, input);
+        auto unarchivedResult = unarchivedMap.ComputeOutput<ElementType>(0);
+        compiledMap.SetInputValue(0, input);
+        auto compiledResult = compiledMap.ComputeOutput<ElementType>(0);
+        ok = ok && expectedResult.size() == numTimesteps * layer.GetOutput().Size();
+        ok = ok && testing::IsEqual(refinedResult, expectedResult, 1e-6) && testing::IsEqual(unarchivedResult, expectedResult, 1e-6) && testing::IsEqual(compiledResult, expectedResult, 1e-6);
+    }
+    testing::ProcessTest("Testing " + computeNode->GetRuntimeTypeName() + " with a window of timesteps", ok);
+}
+
+void TestRecurrentLayerNodeWindow()
+{
+    using ElementType = double;
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+
+    MatrixType inputWeights(3, 7);
+    MatrixType forgetMeWeights(3, 7);
+    MatrixType candidateWeights(3, 7);
+    MatrixType outputWeights(3, 7);
+    MatrixType updateWeights(3, 7);
+    MatrixType resetWeights(3, 7);
+    MatrixType hiddenWeights(3, 7);
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 7; ++j)
+        {
+            inputWeights(i, j) = iData[7 * i + j];
+            forgetMeWeights(i, j) = fData[7 * i + j];
+            candidateWeights(i, j) = cData[7 * i + j];
+            outputWeights(i, j) = oData[7 * i + j];
+            updateWeights(i, j) = uData[7 * i + j];
+            resetWeights(i, j) = rData[7 * i + j];
+            hiddenWeights(i, j) = hData[7 * i + j];
+        }
+    }
+
+    TensorType input(1, 1, 4);
+    Shape outputShape = { 1, 1, 3 };
+    LayerParameters parameters{ input, NoPadding(), outputShape, NoPadding() };
+    const size_t numTimesteps = 3;
+
+    VectorType inputBias = VectorType({ 0.747351, -0.112848, 0.0 });
+    VectorType forgetMeBias = VectorType({ 1.0, 1.0, 1.0 });
+    VectorType candidateBias = VectorType({ 0.733668, 0.000431956, 0.0 });
+    VectorType outputBias = VectorType({ 0.385433, 0.0, 0.0 });
+    LSTMParameters<ElementType> lstmParams{ inputWeights, forgetMeWeights, candidateWeights, outputWeights, inputBias, forgetMeBias, candidateBias, outputBias };
+    LSTMLayer<ElementType, TanhActivation, SigmoidActivation> lstm(parameters, lstmParams);
+    VerifyRecurrentLayerNodeWindow<nodes::LSTMLayerNode<ElementType, TanhActivation, SigmoidActivation>, nodes::LSTMNode<ElementType, TanhActivation, SigmoidActivation>>(lstm, numTimesteps);
+
+    VectorType updateBias = VectorType({ 0.0, 0.0, 3.95111 });
+    VectorType resetBias = VectorType({ 0.0, 0.0, 0.0 });
+    VectorType hiddenBias = VectorType({ -0.0686757, 0.0, 0.281977 });
+    GRUParameters<ElementType> gruParams{ updateWeights, resetWeights, hiddenWeights, updateBias, resetBias, hiddenBias };
+    GRULayer<ElementType, TanhActivation, SigmoidActivation> gru(parameters, gruParams);
+    VerifyRecurrentLayerNodeWindow<nodes::GRULayerNode<ElementType, TanhActivation, SigmoidActivation>, nodes::GRUNode<ElementType, TanhActivation, SigmoidActivation>>(gru, numTimesteps);
+}
+
 void TestRegionDetectionNode()
 {
     using ElementType = double;
@@ -3041,3 +3254,50 @@ void TestRegionDetectionNode()
     std::vector<std::vector<ElementType>> signal = { input.ToArray() };
     VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName(), 1e-5);
 }
+
+void TestRegionDetectionPostProcessingNode()
+{
+    using ElementType = double;
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+    using TensorType = typename Layer<ElementType>::TensorType;
+
+    // The raw region tensor of tiny-yolo-voc on data/dog.jpg, as in TestRegionDetectionNode
+    // clang-format off
+    TensorType input =
+    {
+        #include "TestRegionDetectionNode_input.inc"
+    };
+    // clang-format on
+
+    // The anchors of tiny-yolo-voc
+    RegionDetectionParameters detectionParams{ 13, 13, 5, 20, 4 };
+    RegionDetectionPostProcessingParameters postProcessingParams;
+    postProcessingParams.confidenceThreshold = 0.2;
+    postProcessingParams.nmsThreshold = 0.4;
+    postProcessingParams.maxDetectionsPerClass = 8;
+    postProcessingParams.maxDetections = 16;
+    postProcessingParams.anchorScales = { 1.08, 1.19, 3.42, 4.41, 6.63, 11.38, 9.42, 5.11, 16.62, 10.52 };
+
+    auto inputValues = input.ToArray();
+    RegionDetectionPostProcessor<ElementType> postProcessor(detectionParams, postProcessingParams);
+    std::vector<ElementType> expectedOutput(postProcessor.GetOutputSize());
+    auto numDetections = postProcessor.Compute(inputValues.data(), expectedOutput.data());
+    testing::ProcessTest("Verifying region detections", numDetections > 0 && numDetections < 16);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+    auto postProcessingNode = model.AddNode<nodes::RegionDetectionPostProcessingNode<ElementType>>(inputNode->output, detectionParams, postProcessingParams);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", postProcessingNode->output } });
+
+    auto mapCopy = map;
+    mapCopy.SetInputValue(0, inputValues);
+    auto mapOutput = mapCopy.ComputeOutput<ElementType>(0);
+    testing::ProcessTest("RegionDetectionPostProcessingNode map output == expectedOutput", testing::IsEqual(mapOutput, expectedOutput, 1e-10));
+    testing::ProcessTest("RegionDetectionPostProcessingNode count", postProcessingNode->count.GetOutput(0) == static_cast<int>(numDetections));
+
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+    std::vector<std::vector<ElementType>> signal = { inputValues };
+    VerifyCompiledOutput(map, compiledMap, signal, postProcessingNode->GetRuntimeTypeName(), 1e-5);
+}
@@ -18,6 +18,8 @@
 
 // nodes
 #include "AccumulatorNode.h"
+#include "BinaryOperationNode.h"
+#include "BroadcastFunctionNode.h"
 #include "ClockNode.h"
 #include "ConstantNode.h"
 #include "DelayNode.h"
@@ -26,9 +28,12 @@
 #include "L2NormSquaredNode.h"
 #include "LinearPredictorNode.h"
 #include "MatrixVectorProductNode.h"
+#include "MultiClassLinearPredictorNode.h"
+#include "ProtoNNKernelNode.h"
 #include "ProtoNNPredictorNode.h"
 #include "SinkNode.h"
 #include "SourceNode.h"
+#include "SparseLinearPredictorNode.h"
 #include "SquaredEuclideanDistanceNode.h"
 #include "SumNode.h"
 
@@ -44,18 +49,24 @@
 
 // predictors
 #include "LinearPredictor.h"
+#include "MultiClassLinearPredictor.h"
 #include "ProtoNNPredictor.h"
 
 // utilities
+#include "Exception.h"
 #include "Logger.h"
 
 // testing
 #include "testing.h"
 
 // stl
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace ell;
@@ -139,6 +150,283 @@ void TestSimpleMap(bool optimize)
     VerifyCompiledOutput(map, compiledMap, signal, " map");
 }
 
+void TestParallelOptimizedMap()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto accumNode2 = model.AddNode<nodes::AccumulatorNode<double>>(accumNode->output);
+    auto delayNode = model.AddNode<nodes::DelayNode<double>>(accumNode2->output, 2);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<double>>(accumNode->output, delayNode->output, emitters::BinaryOperationType::add);
+    auto dotNode = model.AddNode<nodes::DotProductNode<double>>(sumNode->output, inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dotNode->output } });
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 } };
+
+    // the code optimized on several threads has to compute exactly what the code optimized on one thread computes
+    std::vector<std::vector<double>> singleThreadedOutput;
+    for (int compileThreads : { 1, 2, 4 })
+    {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.optimize = true;
+        settings.compilerSettings.compileThreads = compileThreads;
+        model::IRMapCompiler compiler(settings);
+        auto compiledMap = compiler.Compile(map);
+
+        auto name = " map optimized on " + std::to_string(compileThreads) + " threads";
+        testing::ProcessTest("Testing IsValid of" + name, testing::IsEqual(compiledMap.IsValid(), true));
+
+        std::vector<std::vector<double>> output;
+        for (const auto& input : signal)
+        {
+            compiledMap.SetInputValue(0, input);
+            output.push_back(compiledMap.ComputeOutput<double>(0));
+        }
+
+        if (compileThreads == 1)
+        {
+            singleThreadedOutput = output;
+            std::vector<std::vector<double>> computedOutput;
+            for (const auto& input : signal)
+            {
+                map.SetInputValue(0, input);
+                computedOutput.push_back(map.ComputeOutput<double>(0));
+            }
+            testing::ProcessTest("Testing output of" + name, testing::IsEqual(output, computedOutput, 1e-8));
+        }
+        else
+        {
+            testing::ProcessTest("Testing output of" + name + " matches the single-threaded output", output == singleThreadedOutput);
+        }
+    }
+}
+
+void TestTieredCompiledMap()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto productNode = model.AddNode<nodes::BinaryOperationNode<double>>(inputNode->output, inputNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<double>>(productNode->output, inputNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sumNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.tieredCompilation = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of tiered map", testing::IsEqual(compiledMap.IsValid(), true));
+
+    // compare output, first with whichever tier is active and then with the optimized code
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map");
+
+    compiledMap.WaitForOptimizedCode();
+    auto timings = compiledMap.GetTieredCompilationTimings();
+    testing::ProcessTest("Testing tiered map swapped in optimized code", compiledMap.IsOptimizedCodeActive() && timings.swapTime >= 0);
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map (optimized tier)");
+}
+
+void TestTieredCompiledMapWithState()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto accumulatorNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto delayNode = model.AddNode<nodes::DelayNode<double>>(accumulatorNode->output, 2);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", delayNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.tieredCompilation = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // the optimized code has to pick up the accumulated and delayed values where the unoptimized code left them
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map with state");
+
+    compiledMap.WaitForOptimizedCode();
+    testing::ProcessTest("Testing tiered map with state swapped in optimized code", compiledMap.IsOptimizedCodeActive());
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map with state (optimized tier)");
+}
+
+// Callbacks that aren't exported, so they have to be defined in the jitter, the way the language bindings do it
+namespace
+{
+const size_t c_tieredSourceSize = 3;
+size_t g_tieredSourceCallbackCount = 0;
+std::vector<double> g_tieredSinkOutput;
+
+bool TieredSourceCallback(void* context, double* input)
+{
+    std::fill(input, input + c_tieredSourceSize, 42.0);
+    ++g_tieredSourceCallbackCount;
+    return true;
+}
+
+void TieredSinkCallback(void* context, double* output)
+{
+    g_tieredSinkOutput.assign(output, output + c_tieredSourceSize);
+}
+}
+
+void TestTieredCompiledMapWithCallbacks()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<nodes::TimeTickType>>(2);
+    auto sourceNode = model.AddNode<nodes::SourceNode<double>>(inputNode->output, c_tieredSourceSize, "TieredSourceCallback", [](auto& input) {
+        input.assign(c_tieredSourceSize, 42.0);
+        return true;
+    });
+    auto conditionNode = model.AddNode<nodes::ConstantNode<bool>>(true);
+    auto sinkNode = model.AddNode<nodes::SinkNode<double>>(sourceNode->output, conditionNode->output, "TieredSinkCallback");
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sinkNode->output } });
+    model::MapCompilerOptions settings;
+    settings.moduleName = "TestTiered";
+    settings.compilerSettings.optimize = true;
+    settings.tieredCompilation = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    auto& jitter = compiledMap.GetJitter();
+    auto module = compiledMap.GetModule().GetLLVMModule();
+    jitter.DefineFunction(module->getFunction("TestTiered_TieredSourceCallback"), reinterpret_cast<uint64_t>(&TieredSourceCallback));
+    jitter.DefineFunction(module->getFunction("TestTiered_TieredSinkCallback"), reinterpret_cast<uint64_t>(&TieredSinkCallback));
+
+    g_tieredSourceCallbackCount = 0;
+    std::vector<std::vector<double>> signal = { { 5, 10 }, { 100, 200 }, { 456, 789 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map with callbacks");
+
+    compiledMap.WaitForOptimizedCode();
+    testing::ProcessTest("Testing tiered map with callbacks swapped in optimized code", compiledMap.IsOptimizedCodeActive());
+    g_tieredSinkOutput.clear();
+    VerifyCompiledOutput(map, compiledMap, signal, " tiered map with callbacks (optimized tier)");
+
+    // the callbacks are still the ones that were defined before the swap
+    testing::ProcessTest("Testing source callback of tiered map", testing::IsEqual(g_tieredSourceCallbackCount, 2 * signal.size()));
+    testing::ProcessTest("Testing sink callback of tiered map", testing::IsEqual(g_tieredSinkOutput, std::vector<double>(c_tieredSourceSize, 42.0)));
+}
+
+void TestTieredCompiledMapWithThreadPool()
+{
+    // big enough for the broadcast node to split its work into tasks
+    const int rows = 100;
+    const int columns = 100;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(rows * columns);
+    auto scaleNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 2.0 });
+    auto biasNode = model.AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 1.0 });
+    model::PortMemoryLayout layout({ rows, columns, 1 });
+    const size_t channelDimension = 2;
+    auto linearNode = model.AddNode<nodes::BroadcastLinearFunctionNode<double>>(inputNode->output, layout, scaleNode->output, biasNode->output, channelDimension, layout);
+    auto accumulatorNode = model.AddNode<nodes::AccumulatorNode<double>>(linearNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", accumulatorNode->output } });
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.compilerSettings.parallelize = true;
+    settings.compilerSettings.useThreadPool = true;
+    settings.tieredCompilation = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // only the accumulator's state is carried over, and the optimized code starts its own thread pool
+    auto computeExpectedOutputs = [](const std::vector<std::vector<double>>& signal) {
+        std::vector<std::vector<double>> outputs;
+        std::vector<double> sum(signal[0].size());
+        for (const auto& input : signal)
+        {
+            std::transform(input.begin(), input.end(), sum.begin(), sum.begin(), [](double x, double total) { return total + 2.0 * x + 1.0; });
+            outputs.push_back(sum);
+        }
+        return outputs;
+    };
+    std::vector<std::vector<double>> signal;
+    for (int index = 0; index < 8; ++index)
+    {
+        std::vector<double> input(rows * columns);
+        std::iota(input.begin(), input.end(), static_cast<double>(index));
+        signal.push_back(input);
+    }
+    auto expectedOutputs = computeExpectedOutputs(signal);
+
+    bool ok = true;
+    for (size_t index = 0; index < signal.size(); ++index)
+    {
+        if (index == signal.size() / 2)
+        {
+            compiledMap.WaitForOptimizedCode();
+            testing::ProcessTest("Testing tiered map with thread pool swapped in optimized code", compiledMap.IsOptimizedCodeActive());
+        }
+        compiledMap.SetInputValue(0, signal[index]);
+        ok = ok && testing::IsEqual(compiledMap.ComputeOutput<double>(0), expectedOutputs[index]);
+    }
+    testing::ProcessTest("Testing output of tiered map with thread pool", ok);
+}
+
+namespace
+{
+bool TieredLateSourceCallback(void* context, double* input)
+{
+    std::fill(input, input + c_tieredSourceSize, 7.0);
+    return true;
+}
+}
+
+void TestTieredCompiledMapWithLateCallback()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<nodes::TimeTickType>>(2);
+    auto sourceNode = model.AddNode<nodes::SourceNode<double>>(inputNode->output, c_tieredSourceSize, "TieredSourceCallback");
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sourceNode->output } });
+    model::MapCompilerOptions settings;
+    settings.moduleName = "TestTieredLate";
+    settings.compilerSettings.optimize = true;
+    settings.tieredCompilation = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    auto module = compiledMap.GetModule().GetLLVMModule();
+    auto callback = module->getFunction("TestTieredLate_TieredSourceCallback");
+    compiledMap.GetJitter().DefineFunction(callback, reinterpret_cast<uint64_t>(&TieredSourceCallback));
+
+    // the first compute starts the background compilation
+    std::vector<nodes::TimeTickType> input = { 5, 10 };
+    compiledMap.SetInputValue(0, input);
+    auto output = compiledMap.ComputeOutput<double>(0);
+    testing::ProcessTest("Testing tiered map before redefining the callback", testing::IsEqual(output, std::vector<double>(c_tieredSourceSize, 42.0)));
+
+    // a callback defined after that has to reach the optimized code
+    compiledMap.GetJitter().DefineFunction(callback, reinterpret_cast<uint64_t>(&TieredLateSourceCallback));
+    compiledMap.WaitForOptimizedCode();
+    testing::ProcessTest("Testing tiered map with a late callback swapped in optimized code", compiledMap.IsOptimizedCodeActive());
+    compiledMap.SetInputValue(0, input);
+    output = compiledMap.ComputeOutput<double>(0);
+    testing::ProcessTest("Testing tiered map after redefining the callback", testing::IsEqual(output, std::vector<double>(c_tieredSourceSize, 7.0)));
+}
+
+void TestCompiledMapBoundBuffers()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<double>>(inputNode->output, inputNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sumNode->output } });
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<double> input = { 1, 2, 3 };
+    std::vector<double> output(3);
+    compiledMap.ComputeInto(input.data(), output.data());
+    testing::ProcessTest("Testing compiled map ComputeInto", testing::IsEqual(output, std::vector<double>{ 2, 4, 6 }));
+
+    compiledMap.BindBuffers(input.data(), output.data());
+    input = { 4, 5, 6 };
+    compiledMap.ComputeBound();
+    testing::ProcessTest("Testing compiled map ComputeBound", testing::IsEqual(output, std::vector<double>{ 8, 10, 12 }));
+
+    // the binding moves with the map
+    auto movedMap = std::move(compiledMap);
+    input = { 7, 8, 9 };
+    movedMap.ComputeBound();
+    testing::ProcessTest("Testing compiled map ComputeBound after a move", testing::IsEqual(output, std::vector<double>{ 14, 16, 18 }));
+}
+
 void TestSqEuclideanDistanceMap()
 {
     model::Model model;
@@ -164,6 +452,55 @@ void TestSqEuclideanDistanceMap()
     VerifyCompiledOutput(map, compiledMap, signal, " map");
 }
 
+namespace
+{
+template <typename ValueType>
+void TestProtoNNPredictorMap(const predictors::ProtoNNPredictor& protonnPredictor, const std::vector<std::vector<double>>& features, const std::vector<std::vector<int>>& labels)
+{
+    const auto dim = protonnPredictor.GetDimension();
+    const ValueType epsilon = std::is_same<ValueType, float>::value ? static_cast<ValueType>(1e-4) : static_cast<ValueType>(1e-5);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dim);
+    auto protonnPredictorNode = model.AddNode<nodes::ProtoNNPredictorNode<ValueType>>(inputNode->output, protonnPredictor);
+    auto outputNode = model.AddNode<model::OutputNode<ValueType>>(protonnPredictorNode->output);
+    auto map = model::Map{ model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = false;
+    settings.compilerSettings.includeDiagnosticInfo = true;
+    settings.compilerSettings.inlineOperators = false;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of original map with " + protonnPredictorNode->GetRuntimeTypeName(), testing::IsEqual(compiledMap.IsValid(), true));
+
+    for (unsigned i = 0; i < features.size(); ++i)
+    {
+        std::vector<ValueType> input(features[i].size());
+        std::transform(features[i].begin(), features[i].end(), input.begin(), [](double d) { return static_cast<ValueType>(d / 255); });
+
+        const auto& label = labels[i];
+
+        IsEqual(input.size(), dim);
+
+        inputNode->SetInput(input);
+        auto computeOutput = model.ComputeOutput(outputNode->output);
+        testing::ProcessTest("one hot indices are incorrect for computed and actual label",
+                             IsEqual(std::max_element(label.begin(), label.end()) - label.begin(),
+                                     std::max_element(computeOutput.begin(), computeOutput.end()) - computeOutput.begin()));
+
+        map.SetInputValue(0, input);
+        auto refinedOutput = map.ComputeOutput<ValueType>(0);
+        testing::ProcessTest("computed and refined output vectors don't match", IsEqual(computeOutput, refinedOutput, epsilon));
+
+        compiledMap.SetInputValue(0, input);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+        testing::ProcessTest("refined and compiled output vectors don't match", IsEqual(refinedOutput, compiledOutput, epsilon));
+    }
+}
+}
+
 void TestProtoNNPredictorMap()
 {
     // the values of dim, gamma, and matrices come from the result of running protoNNTrainer with the following command line
@@ -203,44 +540,216 @@ void TestProtoNNPredictorMap()
     testing::IsEqual(protonnPredictor.GetNumPrototypes(), numPrototypes);
     testing::IsEqual(protonnPredictor.GetNumLabels(), numLabels);
 
+    TestProtoNNPredictorMap<double>(protonnPredictor, features, labels);
+    TestProtoNNPredictorMap<float>(protonnPredictor, features, labels);
+}
+
+namespace
+{
+template <typename ValueType>
+void TestProtoNNKernelNode(const predictors::ProtoNNPredictor& predictor, nodes::ProtoNNProjectionFormat projectionFormat, const std::vector<std::vector<double>>& signal)
+{
     model::Model model;
-    auto inputNode = model.AddNode<model::InputNode<double>>(dim);
-    auto protonnPredictorNode = model.AddNode<nodes::ProtoNNPredictorNode>(inputNode->output, protonnPredictor);
-    auto outputNode = model.AddNode<model::OutputNode<double>>(protonnPredictorNode->output);
-    auto map = model::Map{ model, { { "input", inputNode } }, { { "output", outputNode->output } } };
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(predictor.GetDimension());
+    auto kernelNode = model.AddNode<nodes::ProtoNNKernelNode<ValueType>>(inputNode->output, predictor, projectionFormat);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", kernelNode->output } });
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
 
-    model::MapCompilerOptions settings;
-    settings.compilerSettings.optimize = false;
-    settings.compilerSettings.includeDiagnosticInfo = true;
-    settings.compilerSettings.inlineOperators = false;
-    model::IRMapCompiler compiler(settings);
+    const double epsilon = std::is_same<ValueType, float>::value ? 1e-5 : 1e-10;
+    bool ok = true;
+    for (const auto& sample : signal)
+    {
+        auto expectedOutput = predictor.Predict(sample).ToArray();
+        std::vector<ValueType> input(sample.begin(), sample.end());
+
+        map.SetInputValue(0, input);
+        auto computedOutput = map.ComputeOutput<ValueType>(0);
+        compiledMap.SetInputValue(0, input);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+        ok = ok && testing::IsEqual(std::vector<double>(computedOutput.begin(), computedOutput.end()), expectedOutput, epsilon) && testing::IsEqual(computedOutput, compiledOutput, static_cast<ValueType>(epsilon));
+    }
+
+    auto formatName = kernelNode->IsProjectionSparse() ? " with sparse projection" : " with dense projection";
+    testing::ProcessTest("Testing compiled " + kernelNode->GetRuntimeTypeName() + formatName, ok);
+}
+}
+
+void TestProtoNNKernelNode()
+{
+    size_t dim = 12, projectedDim = 5, numPrototypes = 7, numLabels = 3;
+    double gamma = 0.6;
+    predictors::ProtoNNPredictor predictor(dim, projectedDim, numPrototypes, numLabels, gamma);
+
+    // A projection matrix with two out of three entries zero
+    auto& W = predictor.GetProjectionMatrix();
+    for (size_t i = 0; i < projectedDim; ++i)
+    {
+        for (size_t j = 0; j < dim; ++j)
+        {
+            W(i, j) = (i + j) % 3 == 0 ? std::sin(static_cast<double>(i * dim + j)) : 0.0;
+        }
+    }
+    auto& B = predictor.GetPrototypes();
+    for (size_t i = 0; i < projectedDim; ++i)
+    {
+        for (size_t k = 0; k < numPrototypes; ++k)
+        {
+            B(i, k) = 0.5 * std::cos(static_cast<double>(i * numPrototypes + k));
+        }
+    }
+    auto& Z = predictor.GetLabelEmbeddings();
+    for (size_t l = 0; l < numLabels; ++l)
+    {
+        for (size_t k = 0; k < numPrototypes; ++k)
+        {
+            Z(l, k) = static_cast<double>((l + 2 * k) % 5) / 5;
+        }
+    }
+
+    std::vector<std::vector<double>> signal(4, std::vector<double>(dim));
+    for (size_t index = 0; index < signal.size(); ++index)
+    {
+        for (size_t j = 0; j < dim; ++j)
+        {
+            signal[index][j] = std::sin(static_cast<double>(index + 1) * j);
+        }
+    }
+
+    for (auto projectionFormat : { nodes::ProtoNNProjectionFormat::automatic, nodes::ProtoNNProjectionFormat::dense })
+    {
+        TestProtoNNKernelNode<float>(predictor, projectionFormat, signal);
+        TestProtoNNKernelNode<double>(predictor, projectionFormat, signal);
+    }
+
+    // An all-zero projection is stored as a sparse matrix without any entries
+    W.Reset();
+    TestProtoNNKernelNode<float>(predictor, nodes::ProtoNNProjectionFormat::automatic, signal);
+    TestProtoNNKernelNode<double>(predictor, nodes::ProtoNNProjectionFormat::automatic, signal);
+}
+
+namespace
+{
+template <typename ValueType>
+void TestSparseLinearPredictorNode(const predictors::LinearPredictor<ValueType>& predictor)
+{
+    const auto dim = predictor.Size();
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dim);
+    auto predictorNode = model.AddNode<nodes::SparseLinearPredictorNode<ValueType>>(inputNode->output, predictor);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+    model::IRMapCompiler compiler;
     auto compiledMap = compiler.Compile(map);
 
-    testing::ProcessTest("Testing IsValid of original map", testing::IsEqual(compiledMap.IsValid(), true));
+    // A sparse input given as (index, value) pairs, in which the first and last indices are out of range and are ignored
+    std::vector<int> indices = { -1, 1, 4, 5, 9, static_cast<int>(dim) + 3 };
+    std::vector<ValueType> values = { 6, 0.5, -2, 1, 3, 7 };
+    std::vector<ValueType> denseInput(dim);
+    std::vector<ValueType> binaryInput(dim);
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (indices[i] >= 0 && indices[i] < static_cast<int>(dim))
+        {
+            denseInput[indices[i]] = values[i];
+            binaryInput[indices[i]] = 1;
+        }
+    }
+    auto count = static_cast<int>(indices.size());
+
+    const ValueType epsilon = std::is_same<ValueType, float>::value ? static_cast<ValueType>(1e-5) : static_cast<ValueType>(1e-10);
+    using DataVectorType = typename predictors::LinearPredictor<ValueType>::DataVectorType;
+    auto expectedOutput = predictor.Predict(DataVectorType(std::vector<double>(denseInput.begin(), denseInput.end())));
+    auto expectedBinaryOutput = predictor.Predict(DataVectorType(std::vector<double>(binaryInput.begin(), binaryInput.end())));
+
+    compiledMap.SetInputValue(0, denseInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+    auto sparseOutput = compiledMap.ComputeSparse<ValueType>(indices.data(), values.data(), count);
+    auto sparseBinaryOutput = compiledMap.ComputeSparseBinary<ValueType>(indices.data(), count);
+
+    // Asking for the other value type would call the sparse function with the wrong signature
+    using OtherValueType = std::conditional_t<std::is_same<ValueType, float>::value, double, float>;
+    bool typeMismatchThrows = false;
+    try
+    {
+        compiledMap.ComputeSparseBinary<OtherValueType>(indices.data(), count);
+    }
+    catch (const utilities::InputException&)
+    {
+        typeMismatchThrows = true;
+    }
 
-    for (unsigned i = 0; i < features.size(); ++i)
+    bool ok = testing::IsEqual(compiledOutput[0], expectedOutput, epsilon) && testing::IsEqual(sparseOutput, expectedOutput, epsilon) && testing::IsEqual(sparseBinaryOutput, expectedBinaryOutput, epsilon) && typeMismatchThrows;
+    testing::ProcessTest("Testing compiled " + predictorNode->GetRuntimeTypeName() + " with dense and sparse inputs", ok);
+}
+}
+
+void TestSparseLinearPredictorNode()
+{
+    const size_t dim = 10;
+    predictors::LinearPredictor<double> predictor(dim);
+    for (size_t i = 0; i < dim; ++i)
     {
-        auto& input = features[i];
-        std::transform(input.begin(), input.end(), input.begin(), [](double d) { return d / 255; });
+        predictor.GetWeights()[i] = std::sin(static_cast<double>(i));
+    }
+    predictor.GetBias() = 0.25;
 
-        const auto& label = labels[i];
+    TestSparseLinearPredictorNode<double>(predictor);
+    TestSparseLinearPredictorNode<float>(predictors::LinearPredictor<float>(predictor));
+}
 
-        IsEqual(input.size(), dim);
+namespace
+{
+template <typename ValueType>
+void TestMultiClassLinearPredictorNode(const predictors::MultiClassLinearPredictor<ValueType>& predictor)
+{
+    const auto dim = predictor.Size();
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dim);
+    auto predictorNode = model.AddNode<nodes::MultiClassLinearPredictorNode<ValueType>>(inputNode->output, predictor);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictorNode->output } });
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
 
-        inputNode->SetInput(input);
-        auto computeOutput = model.ComputeOutput(outputNode->output);
-        testing::ProcessTest("one hot indices are incorrect for computed and actual label",
-                             IsEqual(std::max_element(label.begin(), label.end()) - label.begin(),
-                                     std::max_element(computeOutput.begin(), computeOutput.end()) - computeOutput.begin()));
+    const ValueType epsilon = std::is_same<ValueType, float>::value ? static_cast<ValueType>(1e-5) : static_cast<ValueType>(1e-10);
+    bool ok = true;
+    for (size_t index = 0; index < 3; ++index)
+    {
+        std::vector<ValueType> input(dim);
+        for (size_t j = 0; j < dim; ++j)
+        {
+            input[j] = static_cast<ValueType>(std::cos(static_cast<double>((index + 1) * j)));
+        }
 
-        map.SetInputValue(0, input);
-        auto refinedOutput = map.ComputeOutput<double>(0);
-        testing::ProcessTest("computed and refined output vectors don't match", IsEqual(computeOutput, refinedOutput, 1e-5));
+        inputNode->SetInput(input);
+        auto computedOutput = model.ComputeOutput(predictorNode->output);
 
         compiledMap.SetInputValue(0, input);
-        auto compiledOutput = compiledMap.ComputeOutput<double>(0);
-        testing::ProcessTest("refined and compiled output vectors don't match", IsEqual(refinedOutput, compiledOutput, 1e-5));
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+        ok = ok && testing::IsEqual(computedOutput, compiledOutput, epsilon);
+    }
+    testing::ProcessTest("Testing compiled " + predictorNode->GetRuntimeTypeName() + " against computed output", ok);
+}
+}
+
+void TestMultiClassLinearPredictorNode()
+{
+    const size_t dim = 7;
+    const size_t numClasses = 4;
+    predictors::MultiClassLinearPredictor<double> predictor(dim, numClasses);
+    for (size_t i = 0; i < dim; ++i)
+    {
+        for (size_t k = 0; k < numClasses; ++k)
+        {
+            predictor.GetWeights()(i, k) = std::sin(static_cast<double>(i * numClasses + k));
+        }
     }
+    for (size_t k = 0; k < numClasses; ++k)
+    {
+        predictor.GetBias()[k] = 0.25 * static_cast<double>(k) - 0.5;
+    }
+
+    TestMultiClassLinearPredictorNode<double>(predictor);
+    TestMultiClassLinearPredictorNode<float>(predictors::MultiClassLinearPredictor<float>(predictor));
 }
 
 void TestMultiOutputMap()
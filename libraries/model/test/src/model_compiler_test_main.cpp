@@ -35,7 +35,14 @@ void TestIRCompiler()
     TestCompileIsEqual();
     TestSimpleMap(false);
     TestSimpleMap(true);
+    TestParallelOptimizedMap();
+    TestTieredCompiledMap();
+    TestTieredCompiledMapWithState();
+    TestTieredCompiledMapWithCallbacks();
+    TestTieredCompiledMapWithThreadPool();
+    TestTieredCompiledMapWithLateCallback();
     TestCompiledMapMove();
+    TestCompiledMapBoundBuffers();
     TestBinaryScalar();
     TestBinaryVector(true);
     TestBinaryVector(false);
@@ -195,13 +202,19 @@ void TestIRCompiler()
     // TestFullyConnectedLayerNode(1, 1); // Fully-connected layer nodes can't have padding (yet)
 
     TestProtoNNPredictorMap();
+    TestProtoNNKernelNode();
+    TestSparseLinearPredictorNode();
+    TestMultiClassLinearPredictorNode();
     TestMultiSourceSinkMap();
 
     TestRecurrentNode();
     TestGRUNode();
     TestLSTMNode();
+    TestLSTMNodeSequence();
+    TestRecurrentLayerNodeWindow();
 
     TestRegionDetectionNode();
+    TestRegionDetectionPostProcessingNode();
 
     TestMatrixVectorProductNodeCompile();
 
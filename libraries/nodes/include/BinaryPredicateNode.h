@@ -72,6 +72,8 @@ namespace nodes
         /// <returns> The predicate </returns>
         emitters::BinaryPredicateType GetPredicate() const { return _predicate; }
 
+        bool IsPure() const override { return true; }
+
     protected:
         void Compute() const override;
 
@@ -244,6 +244,8 @@ namespace nodes
         size_t GetBroadcastDimension() const { return _broadcastDimension; }
         size_t NumPrimaryInputDimensions() const { return _inputLayout.NumDimensions(); }
 
+        bool IsPure() const override { return true; }
+
     protected:
         BroadcastFunctionNode(const std::vector<model::InputPortBase*>& inputs, const std::vector<model::OutputPortBase*>& outputs);
 
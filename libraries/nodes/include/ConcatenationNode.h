@@ -74,6 +74,8 @@ namespace nodes
         /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
         void Copy(model::ModelTransformer& transformer) const override;
 
+        bool IsPure() const override { return true; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
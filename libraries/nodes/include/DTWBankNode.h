@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DTWBankNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> Optional constraints applied by the DTWBankNode while it matches its input against the prototypes </summary>
+    struct DTWBankParameters
+    {
+        /// <summary>
+        /// The width of the Sakoe-Chiba band: a sample may only be matched to a prototype entry whose position differs
+        /// from the sample's position in the match by at most this amount. 0 means no band constraint.
+        /// </summary>
+        size_t bandWidth = 0;
+
+        /// <summary>
+        /// Partial matches whose normalized distance exceeds this threshold are abandoned, and the rows of the dynamic
+        /// programming tables where every partial match has been abandoned skip their distance computations. 0 means
+        /// no early abandoning.
+        /// </summary>
+        double abandonThreshold = 0;
+    };
+
+    /// <summary>
+    /// A node that computes the dynamic time-warping distance between its input signal and each of a bank of
+    /// prototypes, as a set of DTWDistanceNodes would, but with all the prototypes and dynamic programming state stored
+    /// in one structure-of-arrays layout. Each incoming sample updates the same row of every prototype's dynamic programming
+    /// table at once, so the inner loops run over the prototypes and are vectorized in the compiled code.
+    /// </summary>
+    template <typename ValueType>
+    class DTWBankNode : public model::CompilableNode
+    {
+    public:
+        /// <summary> A prototype signal: one vector of sample values per time step. </summary>
+        using Prototype = std::vector<std::vector<ValueType>>;
+
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* argMinPortName = "argMin";
+
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        const model::OutputPort<int>& argMin = _argMin;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        DTWBankNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to compare to the prototypes </param>
+        /// <param name="prototypes"> The prototypes, which may have different lengths </param>
+        /// <param name="parameters"> The band and early abandoning constraints </param>
+        DTWBankNode(const model::PortElements<ValueType>& input, const std::vector<Prototype>& prototypes, const DTWBankParameters& parameters = {});
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("DTWBankNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` currently copying the model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        /// <summary> Gets the prototypes </summary>
+        ///
+        /// <returns> The prototypes </returns>
+        std::vector<Prototype> GetPrototypes() const;
+
+        /// <summary> Gets the band and early abandoning constraints </summary>
+        ///
+        /// <returns> The constraints </returns>
+        const DTWBankParameters& GetParameters() const { return _parameters; }
+
+    protected:
+        void Reset() const;
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        bool HasState() const override { return true; }
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void SetPrototypes(const std::vector<Prototype>& prototypes);
+        std::vector<ValueType> GetInitialDistances() const;
+
+        model::InputPort<ValueType> _input;
+        model::OutputPort<ValueType> _output;
+        model::OutputPort<int> _argMin;
+
+        DTWBankParameters _parameters;
+        size_t _numPrototypes = 0;
+        size_t _sampleDimension = 0;
+        size_t _maxPrototypeLength = 0;
+
+        // Entry j of row i of prototype k is at ((i * _sampleDimension) + j) * _numPrototypes + k; shorter prototypes are padded with zeros
+        std::vector<ValueType> _prototypeData;
+        std::vector<int> _prototypeLengths;
+        std::vector<ValueType> _prototypeVariances;
+        std::vector<ValueType> _abandonThresholds;
+
+        // Row i of the dynamic programming tables holds the entries of all the prototypes: entry (i, k) is at i * _numPrototypes + k
+        mutable std::vector<ValueType> _d;
+        mutable std::vector<int> _s;
+        mutable int _currentTime = 0;
+    };
+}
+}
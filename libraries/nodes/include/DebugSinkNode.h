@@ -78,6 +78,9 @@ namespace nodes
         /// <returns> The node label. </returns>
         virtual std::string GetLabel() const { return _label; }
 
+        /// <summary> Indicates that this node calls user code, so it's kept even when nothing uses its output. </summary>
+        bool HasSideEffects() const override { return true; }
+
     protected:
         bool ShouldCompileInline() const override;
         void Compute() const override;
@@ -72,6 +72,8 @@ namespace nodes
         /// <param name="transformer"> The `ModelTransformer` currently refining the model </param>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        bool IsPure() const override { return true; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
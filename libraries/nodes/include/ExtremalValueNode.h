@@ -72,6 +72,8 @@ namespace nodes
         /// <returns> A `TypedComparison` indicating the comarison type and data type for this node </returns>
         emitters::TypedComparison GetComparison() const;
 
+        bool IsPure() const override { return true; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
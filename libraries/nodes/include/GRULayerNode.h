@@ -21,6 +21,7 @@
 // stl
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace ell
 {
@@ -46,9 +47,15 @@ namespace nodes
 
         /// <summary> Constructor from a layer. </summary>
         ///
-        /// <param name="input"> </param>
-        /// <param name="layer"> The bias layer to wrap. </param>
-        GRULayerNode(const model::PortElements<ValueType>& input, const LayerType& layer);
+        /// <param name="input"> The input to the layer, with the data of each timestep one after the other. </param>
+        /// <param name="layer"> The GRU layer to wrap. </param>
+        /// <param name="numTimesteps"> The number of timesteps processed by each call. The output holds the output of the layer for each of them. </param>
+        GRULayerNode(const model::PortElements<ValueType>& input, const LayerType& layer, size_t numTimesteps = 1);
+
+        /// <summary> Gets the number of timesteps processed by each call. </summary>
+        ///
+        /// <returns> The number of timesteps. </returns>
+        size_t GetNumTimesteps() const { return _numTimesteps; }
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -66,31 +73,39 @@ namespace nodes
         bool IsCompilable(const model::MapCompiler* compiler) const override { return false; }
 
     protected:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        size_t _numTimesteps = 1;
     };
 
     //
     // Implementation: GRUNode
     //
+
+    /// <summary>
+    /// A fused GRU kernel. The weights of the three gates (update, reset, hidden) are stacked, so that the input projection of
+    /// all the gates is a single matrix product, and each timestep needs only the two recurrent matrix-vector products that
+    /// the reset gate forces. The node can process a window of several timesteps per call, in which case the input projection
+    /// of the whole window is computed up front as one matrix-matrix product.
+    /// </summary>
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     class GRUNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
         /// @{
-        static constexpr const char* updateWeightsPortName = "updateWeights";
-        static constexpr const char* resetWeightsPortName = "resetWeights";
-        static constexpr const char* hiddenWeightsPortName = "hiddenWeights";
-        static constexpr const char* updateBiasPortName = "updateBias";
-        static constexpr const char* resetBiasPortName = "resetBias";
-        static constexpr const char* hiddenBiasPortName = "hiddenBias";
+        static constexpr const char* inputWeightsPortName = "inputWeights";
+        static constexpr const char* recurrentWeightsPortName = "recurrentWeights";
+        static constexpr const char* biasPortName = "bias";
         const model::InputPort<ValueType>& input = _input;
-        const model::InputPort<ValueType>& updateWeights = _updateWeights;
-        const model::InputPort<ValueType>& resetWeights = _resetWeights;
-        const model::InputPort<ValueType>& hiddenWeights = _hiddenWeights;
-        const model::InputPort<ValueType>& updateBias = _updateBias;
-        const model::InputPort<ValueType>& resetBias = _resetBias;
-        const model::InputPort<ValueType>& hiddenBias = _hiddenBias;
+        const model::InputPort<ValueType>& inputWeights = _inputWeights;
+        const model::InputPort<ValueType>& recurrentWeights = _recurrentWeights;
+        const model::InputPort<ValueType>& bias = _bias;
         const model::OutputPort<ValueType>& output = _output;
         /// @}
 
@@ -99,24 +114,20 @@ namespace nodes
 
         /// <summary> Constructor. </summary>
         ///
-        /// <param name="input"> The ports to get input data from. </param>
-        /// <param name="updateWeights"> The update weights. </param>
-        /// <param name="resetWeights"> The reset weights. </param>
-        /// <param name="hiddenWeights"> The hidden weights. </param>
-        /// <param name="updateBias"> The update bias. </param>
-        /// <param name="resetBias"> The reset bias. </param>
-        /// <param name="hiddenBias"> The hidden bias. </param>
-        /// <param name="inputMemoryLayout"> The layout of the input data. </param>
-        /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="input"> The ports to get input data from, with the inputSize values of each timestep one after the other. </param>
+        /// <param name="inputWeights"> The stacked input weights of the gates, as a row-major inputSize x (3 * hiddenSize) matrix (see StackGateInputWeights). </param>
+        /// <param name="recurrentWeights"> The stacked recurrent weights of the gates, as a row-major (3 * hiddenSize) x hiddenSize matrix (see StackGateRecurrentWeights). </param>
+        /// <param name="bias"> The stacked biases of the gates. </param>
+        /// <param name="inputMemoryLayout"> The layout of the whole input, whose active region holds numTimesteps x inputSize values. </param>
+        /// <param name="outputMemoryLayout"> The layout of the whole output, which can't have padding. </param>
+        /// <param name="numTimesteps"> The number of timesteps processed by each call. The output holds the hidden state of each of them. </param>
         GRUNode(const model::PortElements<ValueType>& input,
-                       const model::PortElements<ValueType>& updateWeights,
-                       const model::PortElements<ValueType>& resetWeights,
-                       const model::PortElements<ValueType>& hiddenWeights,
-                       const model::PortElements<ValueType>& updateBias,
-                       const model::PortElements<ValueType>& resetBias,
-                       const model::PortElements<ValueType>& hiddenBias,
-                       const model::PortMemoryLayout& inputMemoryLayout,
-                       const model::PortMemoryLayout& outputMemoryLayout);
+                const model::PortElements<ValueType>& inputWeights,
+                const model::PortElements<ValueType>& recurrentWeights,
+                const model::PortElements<ValueType>& bias,
+                const model::PortMemoryLayout& inputMemoryLayout,
+                const model::PortMemoryLayout& outputMemoryLayout,
+                size_t numTimesteps = 1);
 
         /// <summary> Gets information about the input memory layout </summary>
         ///
@@ -128,6 +139,11 @@ namespace nodes
         /// <returns> The layout of the output data. </returns>
         const model::PortMemoryLayout& GetOutputMemoryLayout() const { return _outputMemoryLayout; }
 
+        /// <summary> Gets the number of timesteps processed by each call. </summary>
+        ///
+        /// <returns> The number of timesteps. </returns>
+        size_t GetNumTimesteps() const { return _numTimesteps; }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -142,36 +158,31 @@ namespace nodes
         void Copy(model::ModelTransformer& transformer) const override;
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
-        bool HasState() const override { return true; }
-
-        void WriteToArchive(utilities::Archiver& archiver) const override
-        {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
-        }
-
-        void ReadFromArchive(utilities::Unarchiver& archiver) override
-        {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
-        }
+        bool HasState() const override { return true; } // stored state: hidden state
+        utilities::ArchiveVersion GetArchiveVersion() const override;
+        bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
+        size_t GetHiddenSize() const { return _bias.Size() / 3; }
+        void VerifyLayouts() const;
+
         // Input
         model::InputPort<ValueType> _input;
-        model::InputPort<ValueType> _updateWeights;
-        model::InputPort<ValueType> _resetWeights;
-        model::InputPort<ValueType> _hiddenWeights;
-        model::InputPort<ValueType> _updateBias;
-        model::InputPort<ValueType> _resetBias;
-        model::InputPort<ValueType> _hiddenBias;
+        model::InputPort<ValueType> _inputWeights;
+        model::InputPort<ValueType> _recurrentWeights;
+        model::InputPort<ValueType> _bias;
 
         // Output
         model::OutputPort<ValueType> _output;
 
         model::PortMemoryLayout _inputMemoryLayout;
         model::PortMemoryLayout _outputMemoryLayout;
+        size_t _numTimesteps = 1;
 
-        template <typename ActivationType>
-        void ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength);
+        // State carried between calls to Compute
+        mutable std::vector<ValueType> _hiddenState;
     };
 }
 }
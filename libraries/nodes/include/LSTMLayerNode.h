@@ -21,6 +21,7 @@
 // stl
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace ell
 {
@@ -44,9 +45,15 @@ namespace nodes
 
         /// <summary> Constructor from a layer. </summary>
         ///
-        /// <param name="input"> </param>
-        /// <param name="layer"> The bias layer to wrap. </param>
-        LSTMLayerNode(const model::PortElements<ValueType>& input, const LayerType& layer);
+        /// <param name="input"> The input to the layer, with the data of each timestep one after the other. </param>
+        /// <param name="layer"> The LSTM layer to wrap. </param>
+        /// <param name="numTimesteps"> The number of timesteps processed by each call. The output holds the output of the layer for each of them. </param>
+        LSTMLayerNode(const model::PortElements<ValueType>& input, const LayerType& layer, size_t numTimesteps = 1);
+
+        /// <summary> Gets the number of timesteps processed by each call. </summary>
+        ///
+        /// <returns> The number of timesteps. </returns>
+        size_t GetNumTimesteps() const { return _numTimesteps; }
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -64,12 +71,26 @@ namespace nodes
         bool IsCompilable(const model::MapCompiler* compiler) const override { return false; }
 
     protected:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        size_t _numTimesteps = 1;
     };
 
     //
     // Implementation: LSTMNode
     //
+
+    /// <summary>
+    /// A fused LSTM kernel. The weights of the four gates (input, forget, candidate, output) are stacked, so that each timestep
+    /// needs a single matrix-vector product with the previous hidden state, and the activations and cell update are applied in
+    /// a single pass. The node can process a window of several timesteps per call: the input projection of the whole window is
+    /// then computed up front as one matrix-matrix product, which leaves only the recurrent product on the sequential path.
+    /// </summary>
     template<typename ValueType, template<typename> class ActivationFunctionType, template<typename> class RecurrentActivationFunctionType>
     class LSTMNode : public model::CompilableNode
     {
@@ -77,22 +98,12 @@ namespace nodes
         /// @name Input and Output Ports
         /// @{
         static constexpr const char* inputWeightsPortName = "inputWeights";
-        static constexpr const char* forgetMeWeightsPortName = "forgetMeWeights";
-        static constexpr const char* candidateWeightsPortName = "candidateWeights";
-        static constexpr const char* outputWeightsPortName = "outputWeights";
-        static constexpr const char* inputBiasPortName = "inputBias";
-        static constexpr const char* forgetMeBiasPortName = "forgetMeBias";
-        static constexpr const char* candidateBiasPortName = "candidateBias";
-        static constexpr const char* outputBiasPortName = "outputBias";
+        static constexpr const char* recurrentWeightsPortName = "recurrentWeights";
+        static constexpr const char* biasPortName = "bias";
         const model::InputPort<ValueType>& input = _input;
         const model::InputPort<ValueType>& inputWeights = _inputWeights;
-        const model::InputPort<ValueType>& forgetMeWeights = _forgetMeWeights;
-        const model::InputPort<ValueType>& candidateWeights = _candidateWeights;
-        const model::InputPort<ValueType>& outputWeights = _outputWeights;
-        const model::InputPort<ValueType>& inputBias = _inputBias;
-        const model::InputPort<ValueType>& forgetMeBias = _forgetMeBias;
-        const model::InputPort<ValueType>& candidateBias = _candidateBias;
-        const model::InputPort<ValueType>& outputBias = _outputBias;
+        const model::InputPort<ValueType>& recurrentWeights = _recurrentWeights;
+        const model::InputPort<ValueType>& bias = _bias;
         const model::OutputPort<ValueType>& output = _output;
         /// @}
 
@@ -101,28 +112,20 @@ namespace nodes
 
         /// <summary> Constructor. </summary>
         ///
-        /// <param name="input"> The ports to get input data from. </param>
-        /// <param name="inputWeights"> The weights to be applied to the input layer. </param>
-        /// <param name="forgetMeWeights"> The weights to be applied to the forgotten layer. </param>
-        /// <param name="candidateWeights"> The weights to be applied to the candidate layer. </param>
-        /// <param name="outputWeights"> The weights to be applied to the output layer. </param>
-        /// <param name="inputBias"> The bias to be applied to the input nodes. </param>
-        /// <param name="forgetMeBias"> The bias to be applied to the forgotten layer nodes. </param>
-        /// <param name="candidateBias"> The bias to be applied to the candidate nodes. </param>
-        /// <param name="outputBias"> The bias to be applied to the output nodes. </param>
-        /// <param name="inputMemoryLayout"> The layout of the input data. </param>
-        /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="input"> The ports to get input data from, with the inputSize values of each timestep one after the other. </param>
+        /// <param name="inputWeights"> The stacked input weights of the gates, as a row-major inputSize x (4 * hiddenSize) matrix (see StackGateInputWeights). </param>
+        /// <param name="recurrentWeights"> The stacked recurrent weights of the gates, as a row-major (4 * hiddenSize) x hiddenSize matrix (see StackGateRecurrentWeights). </param>
+        /// <param name="bias"> The stacked biases of the gates. </param>
+        /// <param name="inputMemoryLayout"> The layout of the whole input, whose active region holds numTimesteps x inputSize values. </param>
+        /// <param name="outputMemoryLayout"> The layout of the whole output, which can't have padding. </param>
+        /// <param name="numTimesteps"> The number of timesteps processed by each call. The output holds the hidden state of each of them. </param>
         LSTMNode(const model::PortElements<ValueType>& input,
-                        const model::PortElements<ValueType>& inputWeights,
-                        const model::PortElements<ValueType>& forgetMeWeights,
-                        const model::PortElements<ValueType>& candidateWeights,
-                        const model::PortElements<ValueType>& outputWeights,
-                        const model::PortElements<ValueType>& inputBias,
-                        const model::PortElements<ValueType>& forgetMeBias,
-                        const model::PortElements<ValueType>& candidateBias,
-                        const model::PortElements<ValueType>& outputBias,
-                        const model::PortMemoryLayout& inputMemoryLayout,
-                        const model::PortMemoryLayout& outputMemoryLayout);
+                 const model::PortElements<ValueType>& inputWeights,
+                 const model::PortElements<ValueType>& recurrentWeights,
+                 const model::PortElements<ValueType>& bias,
+                 const model::PortMemoryLayout& inputMemoryLayout,
+                 const model::PortMemoryLayout& outputMemoryLayout,
+                 size_t numTimesteps = 1);
 
         /// <summary> Gets information about the input memory layout </summary>
         const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
@@ -130,6 +133,9 @@ namespace nodes
         /// <summary> Gets information about the output memory layout </summary>
         const model::PortMemoryLayout& GetOutputMemoryLayout() const { return _outputMemoryLayout; }
 
+        /// <summary> Gets the number of timesteps processed by each call. </summary>
+        size_t GetNumTimesteps() const { return _numTimesteps; }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -144,44 +150,36 @@ namespace nodes
         void Copy(model::ModelTransformer& transformer) const override;
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
-        bool HasState() const override { return true; }
-
-        void WriteToArchive(utilities::Archiver& archiver) const override
-        {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
-        }
-
-        void ReadFromArchive(utilities::Unarchiver& archiver) override
-        {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
-        }
+        bool HasState() const override { return true; } // stored state: hidden state and cell state
+        utilities::ArchiveVersion GetArchiveVersion() const override;
+        bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
+        size_t GetHiddenSize() const { return _bias.Size() / 4; }
+        void VerifyLayouts() const;
+
         // Input
         model::InputPort<ValueType> _input;
 
         // Weights
         model::InputPort<ValueType> _inputWeights;
-        model::InputPort<ValueType> _forgetMeWeights;
-        model::InputPort<ValueType> _candidateWeights;
-        model::InputPort<ValueType> _outputWeights;
+        model::InputPort<ValueType> _recurrentWeights;
 
         // Biases
-        model::InputPort<ValueType> _inputBias;
-        model::InputPort<ValueType> _forgetMeBias;
-        model::InputPort<ValueType> _candidateBias;
-        model::InputPort<ValueType> _outputBias;
+        model::InputPort<ValueType> _bias;
 
         // Output
         model::OutputPort<ValueType> _output;
 
         model::PortMemoryLayout _inputMemoryLayout;
         model::PortMemoryLayout _outputMemoryLayout;
+        size_t _numTimesteps = 1;
 
-        void ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength);
-
-        template <typename ActivationType>
-        void ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength);
+        // State carried between calls to Compute
+        mutable std::vector<ValueType> _hiddenState;
+        mutable std::vector<ValueType> _cellState;
     };
 }
 }
@@ -63,6 +63,8 @@ namespace nodes
             /// <summary> Refines this node in the model being constructed by the transformer </summary>
             bool Refine(model::ModelTransformer& transformer) const override;
 
+            bool IsPure() const override { return true; }
+
         protected:
             void Compute() const override;
             void WriteToArchive(utilities::Archiver& archiver) const override;
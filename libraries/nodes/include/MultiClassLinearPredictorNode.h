@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassLinearPredictorNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Model.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+
+// predictors
+#include "MultiClassLinearPredictor.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> A node that represents a multiclass linear predictor, and outputs the score of each class. </summary>
+    template <typename ElementType>
+    class MultiClassLinearPredictorNode : public model::Node
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ElementType>& input = _input;
+        const model::OutputPort<ElementType>& output = _output;
+        /// @}
+
+        using MultiClassLinearPredictorType = typename predictors::MultiClassLinearPredictor<ElementType>;
+
+        /// <summary> Default Constructor </summary>
+        MultiClassLinearPredictorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to predict from </param>
+        /// <param name="predictor"> The multiclass linear predictor to use when making the prediction. </param>
+        MultiClassLinearPredictorNode(const model::PortElements<ElementType>& input, const MultiClassLinearPredictorType& predictor);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ElementType>("MultiClassLinearPredictorNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        /// <summary> Refines this node into a matrix-vector product with the weights, followed by the addition of the biases </summary>
+        bool Refine(model::ModelTransformer& transformer) const override;
+
+    protected:
+        void Compute() const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        // Inputs
+        model::InputPort<ElementType> _input;
+
+        // Output
+        model::OutputPort<ElementType> _output;
+
+        // Multiclass linear predictor
+        MultiClassLinearPredictorType _predictor;
+    };
+
+    /// <summary> Adds a multiclass linear predictor node to a model transformer. </summary>
+    ///
+    /// <typeparam name="ElementType"> The fundamental type used by this predictor. </typeparam>
+    /// <param name="input"> The input to the predictor. </param>
+    /// <param name="predictor"> The multiclass linear predictor. </param>
+    /// <param name="transformer"> [in,out] The model transformer. </param>
+    ///
+    /// <returns> The node added to the model. </returns>
+    template <typename ElementType>
+    MultiClassLinearPredictorNode<ElementType>* AddNodeToModelTransformer(const model::PortElements<ElementType>& input, const predictors::MultiClassLinearPredictor<ElementType>& predictor, model::ModelTransformer& transformer);
+}
+}
+
+#include "../tcc/MultiClassLinearPredictorNode.tcc"
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ProtoNNKernelNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// predictors
+#include "ProtoNNPredictor.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> How a ProtoNNKernelNode stores its projection matrix </summary>
+    enum class ProtoNNProjectionFormat
+    {
+        /// <summary> Sparse if at most half of the entries are nonzero, dense otherwise </summary>
+        automatic = 0,
+        /// <summary> All the entries, column by column </summary>
+        dense,
+        /// <summary> The nonzero entries only, in compressed sparse column format </summary>
+        sparse
+    };
+
+    /// <summary>
+    /// A node that computes the label scores of a ProtoNN predictor in one pass: it projects the input, and then, one
+    /// prototype at a time, computes the distance to the projected input, the RBF kernel value and the prototype's
+    /// contribution to the label scores. Unlike the model that `ProtoNNPredictorNode` used to refine into, the only
+    /// intermediate result it keeps is the (small) projected input, on the stack, instead of one buffer per step.
+    /// </summary>
+    template <typename ValueType>
+    class ProtoNNKernelNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        ProtoNNKernelNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The signal to predict from </param>
+        /// <param name="predictor"> The ProtoNN predictor, whose parameters are converted to `ValueType` </param>
+        /// <param name="projectionFormat"> How to store the projection matrix </param>
+        ProtoNNKernelNode(const model::PortElements<ValueType>& input, const predictors::ProtoNNPredictor& predictor, ProtoNNProjectionFormat projectionFormat = ProtoNNProjectionFormat::automatic);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("ProtoNNKernelNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` currently copying the model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        /// <summary> Gets the ProtoNN predictor </summary>
+        ///
+        /// <returns> The ProtoNN predictor </returns>
+        const predictors::ProtoNNPredictor& GetPredictor() const { return _predictor; }
+
+        /// <summary> Indicates if the projection matrix is stored in sparse format </summary>
+        ///
+        /// <returns> true if the projection matrix is sparse </returns>
+        bool IsProjectionSparse() const { return _isProjectionSparse; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void SetParameters();
+
+        model::InputPort<ValueType> _input;
+        model::OutputPort<ValueType> _output;
+
+        predictors::ProtoNNPredictor _predictor;
+        ProtoNNProjectionFormat _projectionFormat = ProtoNNProjectionFormat::automatic;
+
+        size_t _dimension = 0;
+        size_t _projectedDimension = 0;
+        size_t _numPrototypes = 0;
+        size_t _numLabels = 0;
+        ValueType _negativeGammaSquared = 0;
+
+        // The projection matrix, either dense (column-major) or in compressed sparse column format
+        bool _isProjectionSparse = false;
+        std::vector<ValueType> _projection;
+        std::vector<int> _projectionColumnStarts;
+        std::vector<int> _projectionRows;
+
+        // One column per prototype, so that each prototype's coordinates and label embeddings are contiguous
+        std::vector<ValueType> _prototypes;
+        std::vector<ValueType> _labelEmbeddings;
+    };
+}
+}
@@ -16,6 +16,9 @@
 // predictors
 #include "ProtoNNPredictor.h"
 
+// utilities
+#include "TypeName.h"
+
 // stl
 #include <string>
 
@@ -24,13 +27,16 @@ namespace ell
 namespace nodes
 {
     /// <summary> A node that represents a ProtoNN predictor. </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the input and the output. The predictor itself is always `double`. </typeparam>
+    template <typename ValueType>
     class ProtoNNPredictorNode : public model::Node
     {
     public:
         /// @name Input and Output Ports
         /// @{
-        const model::InputPort<double>& input = _input;
-        const model::OutputPort<double>& output = _output;
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
 
         /// @}
 
@@ -44,12 +50,12 @@ namespace nodes
         /// <param name="input"> The signal to predict from </param>
         /// <param name="outputSize">The size of the output vector</param>
         /// <param name="predictor"> The ProtoNN predictor to use when making the prediction. </param>
-        ProtoNNPredictorNode(const model::PortElements<double>& input, const ProtoNNPredictor& predictor);
+        ProtoNNPredictorNode(const model::PortElements<ValueType>& input, const ProtoNNPredictor& predictor);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
-        static std::string GetTypeName() { return "ProtoNNPredictorNode"; }
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("ProtoNNPredictorNode"); }
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -69,10 +75,10 @@ namespace nodes
 
     private:
         // Inputs
-        model::InputPort<double> _input;
+        model::InputPort<ValueType> _input;
 
         // Output scores
-        model::OutputPort<double> _output;
+        model::OutputPort<ValueType> _output;
 
         // ProtoNN predictor
         ProtoNNPredictor _predictor;
@@ -85,6 +91,7 @@ namespace nodes
     /// <param name="transformer"> [in,out] The model transformer. </param>
     ///
     /// <returns> The node added to the model. </returns>
-    ProtoNNPredictorNode* AddNodeToModelTransformer(const model::PortElements<double>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer);
+    template <typename ValueType>
+    ProtoNNPredictorNode<ValueType>* AddNodeToModelTransformer(const model::PortElements<ValueType>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer);
 }
 }
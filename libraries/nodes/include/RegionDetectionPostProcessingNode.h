@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessingNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// predictors
+#include "RegionDetectionLayer.h"
+#include "RegionDetectionPostProcessing.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that turns the raw region tensor of a YOLO-style network into a compact list of detections, inside the
+    /// compiled model: it decodes the boxes, drops the boxes whose confidence can't pass the threshold before decoding
+    /// their class scores, keeps the top-K boxes of each class, and runs non-maximum suppression on them. The input is
+    /// the input of the region detection layer, so this node takes the place of `RegionDetectionLayerNode` at the end
+    /// of the network, and only the list of detections needs to be copied out of the model. See
+    /// `predictors::neural::RegionDetectionPostProcessor` for the format of the list.
+    /// </summary>
+    template <typename ValueType>
+    class RegionDetectionPostProcessingNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* countPortName = "count";
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        const model::OutputPort<int>& count = _count;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        RegionDetectionPostProcessingNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The raw region tensor, in row, column, channel order and without padding. </param>
+        /// <param name="regionDetectionParams"> The parameters of the region detection layer. </param>
+        /// <param name="postProcessingParams"> The post-processing parameters. </param>
+        RegionDetectionPostProcessingNode(const model::PortElements<ValueType>& input, const predictors::neural::RegionDetectionParameters& regionDetectionParams, const predictors::neural::RegionDetectionPostProcessingParameters& postProcessingParams);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("RegionDetectionPostProcessingNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` currently copying the model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        /// <summary> Gets the parameters of the region detection layer </summary>
+        ///
+        /// <returns> The region detection parameters </returns>
+        const predictors::neural::RegionDetectionParameters& GetRegionDetectionParameters() const { return _regionDetectionParams; }
+
+        /// <summary> Gets the post-processing parameters </summary>
+        ///
+        /// <returns> The post-processing parameters </returns>
+        const predictors::neural::RegionDetectionPostProcessingParameters& GetPostProcessingParameters() const { return _postProcessingParams; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void SetOutputSizes();
+
+        model::InputPort<ValueType> _input;
+        model::OutputPort<ValueType> _output;
+        model::OutputPort<int> _count;
+
+        predictors::neural::RegionDetectionParameters _regionDetectionParams;
+        predictors::neural::RegionDetectionPostProcessingParameters _postProcessingParams;
+    };
+}
+}
@@ -74,6 +74,20 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        bool IsPure() const override { return true; }
+
+        /// <summary> Gets the memory layout of the input. </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets the memory layout of the output. </summary>
+        const model::PortMemoryLayout& GetOutputMemoryLayout() const { return _outputMemoryLayout; }
+
+        /// <summary> Gets the permutation applied to the dimensions: output dimension `i` is read from input dimension `order[i]`. </summary>
+        const std::vector<int>& GetDimensionOrder() const { return _outputDimensionOrder; }
+
+        /// <summary> Gets the value used to fill the output padding. </summary>
+        ValueType GetPaddingValue() const { return _paddingValue; }
+
     protected:
         model::Shape ReorderInputToOutputLocation(model::Shape inputLocation) const;
         model::Shape ReorderOutputToInputLocation(model::Shape outputLocation) const;
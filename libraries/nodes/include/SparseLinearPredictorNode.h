@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+#include "PortElements.h"
+
+// predictors
+#include "LinearPredictor.h"
+
+// utilities
+#include "TypeName.h"
+
+// stl
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that computes the output of a linear predictor, and whose compiled code can also compute it directly
+    /// from the nonzero entries of a sparse input, gathering only the weights it needs.
+    ///
+    /// In the map's regular predict function, the node takes a dense input, like a `LinearPredictorNode`. In addition,
+    /// compiling the node adds two functions to the module, which don't depend on the map's input:
+    ///
+    ///     ValueType <namespace>_PredictSparse(const int* indices, const ValueType* values, int count)
+    ///     ValueType <namespace>_PredictSparseBinary(const int* indices, int count)
+    ///
+    /// The first takes `count` (index, value) pairs, the second `count` indices whose values are all 1. Their cost is
+    /// proportional to `count`, not to the predictor's dimension. Indices that are negative or greater than or
+    /// equal to the dimension are ignored. `IRCompiledMap::ComputeSparse` calls these functions. A map can
+    /// contain at most one SparseLinearPredictorNode.
+    /// </summary>
+    template <typename ValueType>
+    class SparseLinearPredictorNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        using LinearPredictorType = typename predictors::LinearPredictor<ValueType>;
+
+        /// <summary> Default Constructor </summary>
+        SparseLinearPredictorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The dense input to the predictor </param>
+        /// <param name="predictor"> The linear predictor </param>
+        SparseLinearPredictorNode(const model::PortElements<ValueType>& input, const LinearPredictorType& predictor);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("SparseLinearPredictorNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+        /// <summary> Makes a copy of this node in the model being constructed by the transformer </summary>
+        ///
+        /// <param name="transformer"> The `ModelTransformer` currently copying the model </param>
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        /// <summary> Gets the linear predictor </summary>
+        ///
+        /// <returns> The linear predictor </returns>
+        const LinearPredictorType& GetPredictor() const { return _predictor; }
+
+        /// <summary> Gets the suffix of the name of the compiled function that takes (index, value) pairs </summary>
+        static std::string GetPredictSparseFunctionSuffix() { return "_PredictSparse"; }
+
+        /// <summary> Gets the suffix of the name of the compiled function that takes indices only </summary>
+        static std::string GetPredictSparseBinaryFunctionSuffix() { return "_PredictSparseBinary"; }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void EmitPredictSparseFunction(model::IRMapCompiler& compiler, emitters::IRModuleEmitter& module, llvm::GlobalVariable* pWeights, bool hasValues);
+
+        model::InputPort<ValueType> _input;
+        model::OutputPort<ValueType> _output;
+
+        LinearPredictorType _predictor;
+    };
+}
+}
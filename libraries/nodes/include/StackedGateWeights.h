@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StackedGateWeights.h (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "IRFunctionEmitter.h"
+
+// math
+#include "Matrix.h"
+#include "Vector.h"
+
+// model
+#include "PortMemoryLayout.h"
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    //
+    // Recurrent layers (LSTM, GRU) store one weight matrix per gate, of size hiddenSize x (inputSize + hiddenSize), which
+    // multiplies the concatenation [Xt, Ht-1]. The fused recurrent nodes split these into an input part and a recurrent
+    // part and stack all the gates together, so that each part is a single matrix product.
+    //
+
+    /// <summary> Stacks the input part of the gate weights of a recurrent layer. </summary>
+    ///
+    /// <param name="gateWeights"> The weights of each gate, as hiddenSize x (inputSize + hiddenSize) matrices. </param>
+    /// <param name="inputSize"> The size of the input of the layer. </param>
+    ///
+    /// <returns>
+    /// The input weights of all the gates, as a row-major inputSize x (numGates * hiddenSize) matrix W, so that the gates of
+    /// a row-major block of inputs X (one row per timestep) are X * W.
+    /// </returns>
+    template <typename ValueType>
+    std::vector<ValueType> StackGateInputWeights(const std::vector<math::ConstRowMatrixReference<ValueType>>& gateWeights, size_t inputSize);
+
+    /// <summary> Stacks the recurrent part of the gate weights of a recurrent layer. </summary>
+    ///
+    /// <param name="gateWeights"> The weights of each gate, as hiddenSize x (inputSize + hiddenSize) matrices. </param>
+    /// <param name="inputSize"> The size of the input of the layer. </param>
+    ///
+    /// <returns>
+    /// The recurrent weights of all the gates, as a row-major (numGates * hiddenSize) x hiddenSize matrix U, so that the
+    /// contribution of the previous hidden state to the gates is U * Ht-1.
+    /// </returns>
+    template <typename ValueType>
+    std::vector<ValueType> StackGateRecurrentWeights(const std::vector<math::ConstRowMatrixReference<ValueType>>& gateWeights, size_t inputSize);
+
+    /// <summary> Stacks the biases of the gates of a recurrent layer. </summary>
+    ///
+    /// <param name="gateBiases"> The bias of each gate. </param>
+    ///
+    /// <returns> The concatenation of the gate biases. </returns>
+    template <typename ValueType>
+    std::vector<ValueType> StackGateBiases(const std::vector<math::ConstColumnVectorReference<ValueType>>& gateBiases);
+
+    /// <summary> Gets the memory layout of a window of timesteps, stored one after the other. </summary>
+    ///
+    /// <param name="timestepLayout"> The memory layout of a single timestep. </param>
+    /// <param name="numTimesteps"> The number of timesteps in the window. </param>
+    ///
+    /// <returns> The layout of the window, with the timestep as its outermost dimension. </returns>
+    inline model::PortMemoryLayout GetWindowMemoryLayout(const model::PortMemoryLayout& timestepLayout, size_t numTimesteps);
+
+    /// <summary> Gathers the active entries of a (possibly padded) buffer, in logical order. </summary>
+    ///
+    /// <param name="data"> The buffer. </param>
+    /// <param name="layout"> The memory layout of the buffer. </param>
+    ///
+    /// <returns> The active entries of the buffer. </returns>
+    template <typename ValueType>
+    std::vector<ValueType> GetActiveEntries(const std::vector<ValueType>& data, const model::PortMemoryLayout& layout);
+
+    /// <summary> Emits code that gathers the active entries of a (possibly padded) buffer, in logical order. </summary>
+    ///
+    /// <param name="function"> The function being emitted. </param>
+    /// <param name="data"> The buffer. </param>
+    /// <param name="layout"> The memory layout of the buffer. </param>
+    ///
+    /// <returns> The buffer itself if the layout has no padding, otherwise a new buffer with the active entries. </returns>
+    template <typename ValueType>
+    llvm::Value* EmitActiveEntries(emitters::IRFunctionEmitter& function, llvm::Value* data, const model::PortMemoryLayout& layout);
+}
+}
+
+#include "../tcc/StackedGateWeights.tcc"
@@ -71,6 +71,8 @@ namespace nodes
         /// <returns> The operation </returns>
         emitters::UnaryOperationType GetOperation() const { return _operation; }
 
+        bool IsPure() const override { return true; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -0,0 +1,441 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DTWBankNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DTWBankNode.h"
+#include "DTWDistanceNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    DTWBankNode<ValueType>::DTWBankNode()
+        : CompilableNode({ &_input }, { &_output, &_argMin }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0), _argMin(this, argMinPortName, 1)
+    {
+    }
+
+    template <typename ValueType>
+    DTWBankNode<ValueType>::DTWBankNode(const model::PortElements<ValueType>& input, const std::vector<Prototype>& prototypes, const DTWBankParameters& parameters)
+        : CompilableNode({ &_input }, { &_output, &_argMin }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, prototypes.size()), _argMin(this, argMinPortName, 1), _parameters(parameters)
+    {
+        SetPrototypes(prototypes);
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::SetPrototypes(const std::vector<Prototype>& prototypes)
+    {
+        if (prototypes.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DTWBankNode needs at least one prototype");
+        }
+
+        _numPrototypes = prototypes.size();
+        _sampleDimension = _input.Size();
+        _maxPrototypeLength = 0;
+        for (const auto& prototype : prototypes)
+        {
+            if (prototype.empty())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DTWBankNode prototypes can't be empty");
+            }
+            for (const auto& entry : prototype)
+            {
+                if (entry.size() != _sampleDimension)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "DTWBankNode prototype entries must be the same size as the input");
+                }
+            }
+            _maxPrototypeLength = std::max(_maxPrototypeLength, prototype.size());
+        }
+
+        _prototypeData.assign(_maxPrototypeLength * _sampleDimension * _numPrototypes, 0);
+        _prototypeLengths.resize(_numPrototypes);
+        _prototypeVariances.resize(_numPrototypes);
+        _abandonThresholds.resize(_numPrototypes);
+        for (size_t k = 0; k < _numPrototypes; ++k)
+        {
+            const auto& prototype = prototypes[k];
+            for (size_t i = 0; i < prototype.size(); ++i)
+            {
+                for (size_t j = 0; j < _sampleDimension; ++j)
+                {
+                    _prototypeData[((i * _sampleDimension) + j) * _numPrototypes + k] = prototype[i][j];
+                }
+            }
+            _prototypeLengths[k] = static_cast<int>(prototype.size());
+            _prototypeVariances[k] = static_cast<ValueType>(DTWDistanceNodeImpl::Variance(prototype));
+
+            // The threshold applies to the normalized distance, so scale it by the variance to compare it to the raw distance
+            _abandonThresholds[k] = _parameters.abandonThreshold > 0 ? static_cast<ValueType>(_parameters.abandonThreshold * _prototypeVariances[k]) : std::numeric_limits<ValueType>::max();
+        }
+
+        _d.resize((_maxPrototypeLength + 1) * _numPrototypes);
+        _s.resize((_maxPrototypeLength + 1) * _numPrototypes);
+        Reset();
+    }
+
+    template <typename ValueType>
+    std::vector<typename DTWBankNode<ValueType>::Prototype> DTWBankNode<ValueType>::GetPrototypes() const
+    {
+        std::vector<Prototype> prototypes(_numPrototypes);
+        for (size_t k = 0; k < _numPrototypes; ++k)
+        {
+            prototypes[k].resize(_prototypeLengths[k], std::vector<ValueType>(_sampleDimension));
+            for (size_t i = 0; i < prototypes[k].size(); ++i)
+            {
+                for (size_t j = 0; j < _sampleDimension; ++j)
+                {
+                    prototypes[k][i][j] = _prototypeData[((i * _sampleDimension) + j) * _numPrototypes + k];
+                }
+            }
+        }
+        return prototypes;
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> DTWBankNode<ValueType>::GetInitialDistances() const
+    {
+        // Row 0 is the empty match, which costs nothing; the other entries are unreachable until the first sample arrives
+        std::vector<ValueType> result((_maxPrototypeLength + 1) * _numPrototypes, std::numeric_limits<ValueType>::max());
+        std::fill(result.begin(), result.begin() + _numPrototypes, static_cast<ValueType>(0));
+        return result;
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::Reset() const
+    {
+        _d = GetInitialDistances();
+        std::fill(_s.begin(), _s.end(), 0);
+        _currentTime = 0;
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::Compute() const
+    {
+        const auto maxValue = std::numeric_limits<ValueType>::max();
+        const auto numPrototypes = _numPrototypes;
+        const auto bandWidth = static_cast<int>(_parameters.bandWidth);
+        auto input = _input.GetValue();
+        auto t = ++_currentTime;
+
+        std::fill(_d.begin(), _d.begin() + numPrototypes, static_cast<ValueType>(0));
+        std::fill(_s.begin(), _s.begin() + numPrototypes, t);
+
+        // The previous sample's entries of the row above, i.e., the diagonal predecessors
+        std::vector<ValueType> diagonal(numPrototypes, 0);
+        std::vector<int> diagonalStart(numPrototypes, t);
+
+        std::vector<ValueType> best(numPrototypes);
+        std::vector<int> bestStart(numPrototypes);
+        std::vector<ValueType> cost(numPrototypes);
+        for (size_t i = 1; i <= _maxPrototypeLength; ++i)
+        {
+            auto d = _d.data() + i * numPrototypes;
+            auto s = _s.data() + i * numPrototypes;
+            auto dAbove = d - numPrototypes;
+            auto sAbove = s - numPrototypes;
+
+            bool isLive = false;
+            for (size_t k = 0; k < numPrototypes; ++k)
+            {
+                auto bestDist = dAbove[k];
+                auto start = sAbove[k];
+                if (d[k] < bestDist)
+                {
+                    bestDist = d[k];
+                    start = s[k];
+                }
+                if (diagonal[k] < bestDist)
+                {
+                    bestDist = diagonal[k];
+                    start = diagonalStart[k];
+                }
+                diagonal[k] = d[k];
+                diagonalStart[k] = s[k];
+                best[k] = bestDist;
+                bestStart[k] = start;
+                isLive = isLive || (bestDist < maxValue && static_cast<int>(i) <= _prototypeLengths[k]);
+            }
+
+            if (!isLive)
+            {
+                std::fill(d, d + numPrototypes, maxValue);
+                std::copy(bestStart.begin(), bestStart.end(), s);
+                continue;
+            }
+
+            std::fill(cost.begin(), cost.end(), static_cast<ValueType>(0));
+            for (size_t j = 0; j < _sampleDimension; ++j)
+            {
+                auto x = input[j];
+                auto prototypeValues = _prototypeData.data() + (((i - 1) * _sampleDimension) + j) * numPrototypes;
+                for (size_t k = 0; k < numPrototypes; ++k)
+                {
+                    cost[k] += std::abs(x - prototypeValues[k]);
+                }
+            }
+
+            for (size_t k = 0; k < numPrototypes; ++k)
+            {
+                auto dist = best[k] + cost[k];
+                auto bandOffset = (t - bestStart[k]) - static_cast<int>(i - 1);
+                bool isInBand = bandWidth == 0 || std::abs(bandOffset) <= bandWidth;
+                bool isValid = best[k] < maxValue && static_cast<int>(i) <= _prototypeLengths[k] && dist <= _abandonThresholds[k] && isInBand;
+                d[k] = isValid ? dist : maxValue;
+                s[k] = bestStart[k];
+            }
+        }
+
+        std::vector<ValueType> distances(numPrototypes);
+        int bestIndex = 0;
+        for (size_t k = 0; k < numPrototypes; ++k)
+        {
+            auto dist = _d[_prototypeLengths[k] * numPrototypes + k];
+            distances[k] = dist < maxValue ? dist / _prototypeVariances[k] : maxValue;
+            if (distances[k] < distances[bestIndex])
+            {
+                bestIndex = static_cast<int>(k);
+            }
+        }
+        _output.SetOutput(distances);
+        _argMin.SetOutput({ bestIndex });
+    };
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newInput = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<DTWBankNode<ValueType>>(newInput, GetPrototypes(), _parameters);
+        transformer.MapNodeOutput(output, newNode->output);
+        transformer.MapNodeOutput(argMin, newNode->argMin);
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        auto& module = function.GetModule();
+        const auto maxValue = std::numeric_limits<ValueType>::max();
+        const auto numPrototypes = static_cast<int>(_numPrototypes);
+        const auto sampleDimension = static_cast<int>(_sampleDimension);
+        const auto bandWidth = static_cast<int>(_parameters.bandWidth);
+        const auto stateIdentifier = GetInternalStateIdentifier();
+
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+        llvm::Value* pArgMin = compiler.EnsurePortEmitted(argMin);
+
+        // Constants
+        auto prototypes = function.LocalArray(module.ConstantArray("prototypes_"s + stateIdentifier, _prototypeData));
+        auto lengths = function.LocalArray(module.ConstantArray("prototypeLengths_"s + stateIdentifier, _prototypeLengths));
+        auto variances = function.LocalArray(module.ConstantArray("prototypeVariances_"s + stateIdentifier, _prototypeVariances));
+        auto thresholds = function.LocalArray(module.ConstantArray("abandonThresholds_"s + stateIdentifier, _abandonThresholds));
+
+        // Global state: the dynamic programming tables and the current time
+        auto d = function.LocalArray(module.GlobalArray("d_"s + stateIdentifier, GetInitialDistances()));
+        auto s = function.LocalArray(module.GlobalArray("s_"s + stateIdentifier, std::vector<int>(_s.size(), 0)));
+        llvm::GlobalVariable* currentTime = module.Global<int>("currentTime_"s + stateIdentifier, 0);
+
+        // Scratch space with one entry per prototype
+        auto diagonal = function.LocalArray(module.GlobalArray<ValueType>("diagonal_"s + stateIdentifier, _numPrototypes));
+        auto diagonalStart = function.LocalArray(module.GlobalArray<int>("diagonalStart_"s + stateIdentifier, _numPrototypes));
+        auto best = function.LocalArray(module.GlobalArray<ValueType>("best_"s + stateIdentifier, _numPrototypes));
+        auto bestStart = function.LocalArray(module.GlobalArray<int>("bestStart_"s + stateIdentifier, _numPrototypes));
+        auto cost = function.LocalArray(module.GlobalArray<ValueType>("cost_"s + stateIdentifier, _numPrototypes));
+
+        llvm::Value* isLiveVar = function.Variable(emitters::VariableType::Int32, "isLive");
+        llvm::Value* bestDistVar = function.Variable(emitters::GetVariableType<ValueType>(), "bestDist");
+        llvm::Value* bestIndexVar = function.Variable(emitters::VariableType::Int32, "bestIndex");
+
+        auto t = function.LocalScalar(function.Load(currentTime)) + 1;
+        function.Store(currentTime, t);
+
+        function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+            auto k = function.LocalScalar(kVar);
+            d[k] = function.Literal(static_cast<ValueType>(0));
+            s[k] = t;
+            diagonal[k] = function.Literal(static_cast<ValueType>(0));
+            diagonalStart[k] = t;
+        });
+
+        // All the loops over the prototypes below are branch-free, so that they're vectorized
+        function.For(_maxPrototypeLength, [&](emitters::IRFunctionEmitter& function, llvm::Value* iMinus1Var) {
+            auto iMinus1 = function.LocalScalar(iMinus1Var);
+            auto i = iMinus1 + 1;
+            auto rowOffset = i * numPrototypes;
+            auto rowAboveOffset = iMinus1 * numPrototypes;
+
+            function.StoreZero(isLiveVar);
+            function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                auto k = function.LocalScalar(kVar);
+                emitters::IRLocalScalar above = d[rowAboveOffset + k];
+                emitters::IRLocalScalar aboveStart = s[rowAboveOffset + k];
+                emitters::IRLocalScalar left = d[rowOffset + k];
+                emitters::IRLocalScalar leftStart = s[rowOffset + k];
+                emitters::IRLocalScalar diag = diagonal[k];
+                emitters::IRLocalScalar diagStart = diagonalStart[k];
+
+                auto useLeft = left < above;
+                auto bestDist = function.LocalScalar(function.Select(useLeft, left, above));
+                auto start = function.LocalScalar(function.Select(useLeft, leftStart, aboveStart));
+                auto useDiagonal = diag < bestDist;
+                bestDist = function.LocalScalar(function.Select(useDiagonal, diag, bestDist));
+                start = function.LocalScalar(function.Select(useDiagonal, diagStart, start));
+
+                diagonal[k] = left;
+                diagonalStart[k] = leftStart;
+                best[k] = bestDist;
+                bestStart[k] = start;
+
+                emitters::IRLocalScalar length = lengths[k];
+                auto isLaneLive = (bestDist < maxValue) && (i <= length);
+                function.Store(isLiveVar, function.Select(isLaneLive, function.Literal<int>(1), function.Load(isLiveVar)));
+            });
+
+            function.If(function.LocalScalar(function.Load(isLiveVar)) != 0, [&](emitters::IRFunctionEmitter& function) {
+                function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                    cost[function.LocalScalar(kVar)] = function.Literal(static_cast<ValueType>(0));
+                });
+
+                function.For(_sampleDimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* jVar) {
+                    auto j = function.LocalScalar(jVar);
+                    auto x = function.LocalScalar(sampleDimension == 1 ? pInput : function.ValueAt(pInput, j));
+                    auto prototypeOffset = ((iMinus1 * sampleDimension) + j) * numPrototypes;
+                    function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                        auto k = function.LocalScalar(kVar);
+                        emitters::IRLocalScalar prototypeValue = prototypes[prototypeOffset + k];
+                        emitters::IRLocalScalar laneCost = cost[k];
+                        cost[k] = laneCost + Abs(x - prototypeValue);
+                    });
+                });
+
+                function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                    auto k = function.LocalScalar(kVar);
+                    emitters::IRLocalScalar bestDist = best[k];
+                    emitters::IRLocalScalar start = bestStart[k];
+                    emitters::IRLocalScalar laneCost = cost[k];
+                    emitters::IRLocalScalar length = lengths[k];
+                    emitters::IRLocalScalar threshold = thresholds[k];
+                    auto dist = bestDist + laneCost;
+                    auto isValid = (bestDist < maxValue) && (i <= length) && (dist <= threshold);
+                    if (bandWidth > 0)
+                    {
+                        auto bandOffset = (t - start) - iMinus1;
+                        isValid = isValid && (bandOffset <= bandWidth) && (bandOffset >= -bandWidth);
+                    }
+                    d[rowOffset + k] = function.Select(isValid, dist, function.Literal(maxValue));
+                    s[rowOffset + k] = start;
+                });
+            })
+                .Else([&](emitters::IRFunctionEmitter& function) {
+                    function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                        auto k = function.LocalScalar(kVar);
+                        emitters::IRLocalScalar start = bestStart[k];
+                        d[rowOffset + k] = function.Literal(maxValue);
+                        s[rowOffset + k] = start;
+                    });
+                });
+        });
+
+        // Normalize the distances and find the closest prototype
+        function.Store(bestDistVar, function.Literal(maxValue));
+        function.StoreZero(bestIndexVar);
+        function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+            auto k = function.LocalScalar(kVar);
+            emitters::IRLocalScalar length = lengths[k];
+            emitters::IRLocalScalar dist = d[length * numPrototypes + k];
+            emitters::IRLocalScalar variance = variances[k];
+            auto normalizedDist = function.LocalScalar(function.Select(dist < maxValue, dist / variance, function.Literal(maxValue)));
+            if (numPrototypes == 1)
+            {
+                function.Store(pOutput, normalizedDist);
+            }
+            else
+            {
+                function.SetValueAt(pOutput, k, normalizedDist);
+            }
+
+            auto isBest = normalizedDist < function.LocalScalar(function.Load(bestDistVar));
+            function.Store(bestDistVar, function.Select(isBest, normalizedDist, function.Load(bestDistVar)));
+            function.Store(bestIndexVar, function.Select(isBest, k, function.Load(bestIndexVar)));
+        });
+        function.Store(pArgMin, function.Load(bestIndexVar));
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["bandWidth"] << _parameters.bandWidth;
+        archiver["abandonThreshold"] << _parameters.abandonThreshold;
+
+        // The prototypes are archived row by row, one after the other
+        std::vector<ValueType> prototypeData;
+        for (const auto& prototype : GetPrototypes())
+        {
+            for (const auto& entry : prototype)
+            {
+                prototypeData.insert(prototypeData.end(), entry.begin(), entry.end());
+            }
+        }
+        archiver["prototypeLengths"] << _prototypeLengths;
+        archiver["prototypes"] << prototypeData;
+    }
+
+    template <typename ValueType>
+    void DTWBankNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["bandWidth"] >> _parameters.bandWidth;
+        archiver["abandonThreshold"] >> _parameters.abandonThreshold;
+
+        std::vector<int> prototypeLengths;
+        std::vector<ValueType> prototypeData;
+        archiver["prototypeLengths"] >> prototypeLengths;
+        archiver["prototypes"] >> prototypeData;
+
+        const auto sampleDimension = _input.Size();
+        std::vector<Prototype> prototypes;
+        auto entryBegin = prototypeData.begin();
+        for (auto length : prototypeLengths)
+        {
+            Prototype prototype;
+            for (int i = 0; i < length; ++i)
+            {
+                prototype.emplace_back(entryBegin, entryBegin + sampleDimension);
+                entryBegin += sampleDimension;
+            }
+            prototypes.push_back(std::move(prototype));
+        }
+        SetPrototypes(prototypes);
+        _output.SetSize(_numPrototypes);
+    }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class DTWBankNode<float>;
+    template class DTWBankNode<double>;
+} // nodes
+} // ell
@@ -7,12 +7,11 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GRULayerNode.h"
-#include "BroadcastFunctionNode.h"
 #include "CompiledActivationFunctions.h"
 #include "ConstantNode.h"
 #include "HardSigmoidActivation.h"
-#include "MatrixVectorMultiplyNode.h"
 #include "SigmoidActivation.h"
+#include "StackedGateWeights.h"
 #include "TanhActivation.h"
 
 // utilities
@@ -23,8 +22,8 @@ namespace ell
 namespace nodes
 {
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRULayerNode(const model::PortElements<ValueType>& input, const LayerType& layer)
-        : BaseType(input, layer)
+    GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRULayerNode(const model::PortElements<ValueType>& input, const LayerType& layer, size_t numTimesteps)
+        : BaseType(input, layer), _numTimesteps(numTimesteps)
     {
         const auto& layerParameters = layer.GetLayerParameters();
         if (HasPadding(layerParameters.inputPaddingParameters))
@@ -36,6 +35,39 @@ namespace nodes
         {
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "GRULayerNode does not currently support outputs with padding");
         }
+
+        if (numTimesteps == 0 || input.Size() != numTimesteps * layer.GetInputShape().Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GRULayerNode input must hold the layer input of each timestep");
+        }
+        this->_output.SetSize(numTimesteps * layer.GetOutput().Size());
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(this->_input.GetPortElements());
+        auto newNode = transformer.AddNode<GRULayerNode>(newPortElements, this->_layer, _numTimesteps);
+        transformer.MapNodeOutput(this->_output, newNode->output);
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compute() const
+    {
+        // Run the layer once per timestep
+        auto inputVector = this->_input.GetValue();
+        const auto timestepSize = this->_inputTensor.Size();
+        std::vector<ValueType> output;
+        output.reserve(this->_output.Size());
+        for (size_t timestep = 0; timestep < _numTimesteps; ++timestep)
+        {
+            auto inputTensor = typename LayerType::ConstTensorReferenceType{ inputVector.data() + timestep * timestepSize, this->_inputTensor.GetShape() };
+            this->_inputTensor.CopyFrom(inputTensor);
+            this->_layer.Compute();
+            auto timestepOutput = this->_layer.GetOutput().ToArray();
+            output.insert(output.end(), timestepOutput.begin(), timestepOutput.end());
+        }
+        this->_output.SetOutput(output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
@@ -43,186 +75,311 @@ namespace nodes
     {
         auto newInput = transformer.TransformPortElements(this->input.GetPortElements());
 
-        // Transform weights and bias members into constant nodes
-        const auto& updateWeights = this->_layer.GetUpdateWeights();
-        const auto& resetWeights = this->_layer.GetResetWeights();
-        const auto& hiddenWeights = this->_layer.GetHiddenWeights();
-        const auto& updateBias = this->_layer.GetUpdateBias();
-        const auto& resetBias = this->_layer.GetResetBias();
-        const auto& hiddenBias = this->_layer.GetHiddenBias();
-
-        auto updateWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(updateWeights.ToArray());
-        auto resetWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(resetWeights.ToArray());
-        auto hiddenWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(hiddenWeights.ToArray());
-        auto updateBiasNode = transformer.AddNode<ConstantNode<ValueType>>(updateBias.ToArray());
-        auto resetBiasNode = transformer.AddNode<ConstantNode<ValueType>>(resetBias.ToArray());
-        auto hiddenBiasNode = transformer.AddNode<ConstantNode<ValueType>>(hiddenBias.ToArray());
+        // Stack the weights and biases of the gates (in the order update, reset, hidden) into constant nodes
+        const size_t inputSize = this->GetInputMemoryLayout().NumEntries();
+        const auto& layer = this->_layer;
+        std::vector<math::ConstRowMatrixReference<ValueType>> gateWeights = { layer.GetUpdateWeights(), layer.GetResetWeights(), layer.GetHiddenWeights() };
+        std::vector<math::ConstColumnVectorReference<ValueType>> gateBiases = { layer.GetUpdateBias(), layer.GetResetBias(), layer.GetHiddenBias() };
+
+        auto inputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateInputWeights(gateWeights, inputSize));
+        auto recurrentWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateRecurrentWeights(gateWeights, inputSize));
+        auto biasNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateBiases(gateBiases));
 
         auto gruNode = transformer.AddNode<GRUNode<ValueType,
                                                    ActivationFunctionType,
                                                    RecurrentActivationFunctionType>>(newInput,
-                                                                                     updateWeightsNode->output,
-                                                                                     resetWeightsNode->output,
-                                                                                     hiddenWeightsNode->output,
-                                                                                     updateBiasNode->output,
-                                                                                     resetBiasNode->output,
-                                                                                     hiddenBiasNode->output,
-                                                                                     this->GetInputMemoryLayout(),
-                                                                                     this->GetOutputMemoryLayout());
+                                                                                     inputWeightsNode->output,
+                                                                                     recurrentWeightsNode->output,
+                                                                                     biasNode->output,
+                                                                                     GetWindowMemoryLayout(this->GetInputMemoryLayout(), _numTimesteps),
+                                                                                     GetWindowMemoryLayout(this->GetOutputMemoryLayout(), _numTimesteps),
+                                                                                     _numTimesteps);
 
         transformer.MapNodeOutput(this->output, gruNode->output);
         return true;
     }
 
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        BaseType::WriteToArchive(archiver);
+        archiver["numTimesteps"] << _numTimesteps;
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRULayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        BaseType::ReadFromArchive(archiver);
+        archiver.OptionalProperty("numTimesteps", size_t{ 1 }) >> _numTimesteps;
+        this->_output.SetSize(_numTimesteps * this->_layer.GetOutput().Size());
+    }
+
     //
     // GRUNode
     //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRUNode()
-        : GRUNode({}, {}, {}, {}, {}, {}, {}, {}, {})
+        : CompilableNode({ &_input, &_inputWeights, &_recurrentWeights, &_bias }, { &_output }),
+            _input(this, {}, defaultInputPortName),
+            _inputWeights(this, {}, inputWeightsPortName),
+            _recurrentWeights(this, {}, recurrentWeightsPortName),
+            _bias(this, {}, biasPortName),
+            _output(this, defaultOutputPortName, 0)
     {
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GRUNode(const model::PortElements<ValueType>& input,
-                                                                                         const model::PortElements<ValueType>& updateWeights,
-                                                                                         const model::PortElements<ValueType>& resetWeights,
-                                                                                         const model::PortElements<ValueType>& hiddenWeights,
-                                                                                         const model::PortElements<ValueType>& updateBias,
-                                                                                         const model::PortElements<ValueType>& resetBias,
-                                                                                         const model::PortElements<ValueType>& hiddenBias,
+                                                                                         const model::PortElements<ValueType>& inputWeights,
+                                                                                         const model::PortElements<ValueType>& recurrentWeights,
+                                                                                         const model::PortElements<ValueType>& bias,
                                                                                          const model::PortMemoryLayout& inputMemoryLayout,
-                                                                                         const model::PortMemoryLayout& outputMemoryLayout)
-        : CompilableNode({ &_input, &_updateWeights, &_resetWeights, &_hiddenWeights, &_updateBias, &_resetBias, &_hiddenBias },
-                         { &_output }),
+                                                                                         const model::PortMemoryLayout& outputMemoryLayout,
+                                                                                         size_t numTimesteps)
+        : CompilableNode({ &_input, &_inputWeights, &_recurrentWeights, &_bias }, { &_output }),
             _input(this, input, defaultInputPortName),
-            _updateWeights(this, updateWeights, updateWeightsPortName),
-            _resetWeights(this, resetWeights, resetWeightsPortName),
-            _hiddenWeights(this, hiddenWeights, hiddenWeightsPortName),
-            _updateBias(this, updateBias, updateBiasPortName),
-            _resetBias(this, resetBias, resetBiasPortName),
-            _hiddenBias(this, hiddenBias, hiddenBiasPortName),
-            _output(this, defaultOutputPortName, updateBias.Size())
+            _inputWeights(this, inputWeights, inputWeightsPortName),
+            _recurrentWeights(this, recurrentWeights, recurrentWeightsPortName),
+            _bias(this, bias, biasPortName),
+            _output(this, defaultOutputPortName, numTimesteps * (bias.Size() / 3)),
+            _inputMemoryLayout(inputMemoryLayout),
+            _outputMemoryLayout(outputMemoryLayout),
+            _numTimesteps(numTimesteps),
+            _hiddenState(bias.Size() / 3)
     {
+        const auto hiddenSize = GetHiddenSize();
+        if (numTimesteps == 0 || hiddenSize == 0 || bias.Size() != 3 * hiddenSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "GRUNode needs at least one timestep and a bias for each of its 3 gates");
+        }
+
+        VerifyLayouts();
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::VerifyLayouts() const
+    {
+        const auto hiddenSize = GetHiddenSize();
+        const auto numInputEntries = _inputMemoryLayout.NumEntries();
+        if (_numTimesteps == 0 || numInputEntries % _numTimesteps != 0 || _recurrentWeights.Size() != 3 * hiddenSize * hiddenSize || _inputWeights.Size() != 3 * hiddenSize * (numInputEntries / _numTimesteps))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GRUNode weights don't match the input and hidden sizes");
+        }
+
+        if (_input.Size() != _inputMemoryLayout.GetMemorySize() || _output.Size() != _outputMemoryLayout.NumEntries())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "GRUNode memory layouts don't match its input and output");
+        }
+
+        if (_outputMemoryLayout.GetMemorySize() != _outputMemoryLayout.NumEntries())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "GRUNode does not currently support outputs with padding");
+        }
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
     {
         auto newInput = transformer.TransformPortElements(_input.GetPortElements());
-        auto newUpdateWeights = transformer.TransformPortElements(_updateWeights.GetPortElements());
-        auto newResetWeights = transformer.TransformPortElements(_resetWeights.GetPortElements());
-        auto newHiddenWeights = transformer.TransformPortElements(_hiddenWeights.GetPortElements());
-        auto newUpdateBias = transformer.TransformPortElements(_updateBias.GetPortElements());
-        auto newResetBias = transformer.TransformPortElements(_resetBias.GetPortElements());
-        auto newHiddenBias = transformer.TransformPortElements(_hiddenBias.GetPortElements());
-        auto newNode = transformer.AddNode<GRUNode>(newInput, newUpdateWeights, newResetWeights, newHiddenWeights, newUpdateBias, newResetBias, newHiddenBias, _inputMemoryLayout, _outputMemoryLayout);
+        auto newInputWeights = transformer.TransformPortElements(_inputWeights.GetPortElements());
+        auto newRecurrentWeights = transformer.TransformPortElements(_recurrentWeights.GetPortElements());
+        auto newBias = transformer.TransformPortElements(_bias.GetPortElements());
+        auto newNode = transformer.AddNode<GRUNode>(newInput, newInputWeights, newRecurrentWeights, newBias, _inputMemoryLayout, _outputMemoryLayout, _numTimesteps);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compute() const
     {
-        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "GRUNode does not currently compute");
+        const auto hiddenSize = GetHiddenSize();
+        const auto gatesSize = 3 * hiddenSize;
+        const auto input = GetActiveEntries(_input.GetValue(), _inputMemoryLayout);
+        const auto inputSize = input.size() / _numTimesteps;
+        const auto inputWeights = _inputWeights.GetValue();
+        const auto recurrentWeights = _recurrentWeights.GetValue();
+        const auto bias = _bias.GetValue();
+
+        ActivationFunctionType<ValueType> activationFunction;
+        RecurrentActivationFunctionType<ValueType> recurrentActivationFunction;
+
+        std::vector<ValueType> output;
+        output.reserve(_numTimesteps * hiddenSize);
+        std::vector<ValueType> gates(gatesSize);
+        std::vector<ValueType> resetHiddenState(hiddenSize);
+        for (size_t timestep = 0; timestep < _numTimesteps; ++timestep)
+        {
+            // G = Xt * W + B
+            for (size_t gate = 0; gate < gatesSize; ++gate)
+            {
+                auto value = bias[gate];
+                for (size_t index = 0; index < inputSize; ++index)
+                {
+                    value += input[timestep * inputSize + index] * inputWeights[index * gatesSize + gate];
+                }
+                gates[gate] = value;
+            }
+
+            // Zt = recurrentFunction(Gu + Uu * Ht-1), Rt = recurrentFunction(Gr + Ur * Ht-1)
+            for (size_t gate = 0; gate < 2 * hiddenSize; ++gate)
+            {
+                for (size_t index = 0; index < hiddenSize; ++index)
+                {
+                    gates[gate] += recurrentWeights[gate * hiddenSize + index] * _hiddenState[index];
+                }
+                gates[gate] = recurrentActivationFunction.Apply(gates[gate]);
+            }
+            for (size_t index = 0; index < hiddenSize; ++index)
+            {
+                resetHiddenState[index] = gates[index + hiddenSize] * _hiddenState[index];
+            }
+
+            // Ht~ = activationFunction(Gh + Uh * (Rt .* Ht-1))
+            // Ht = (1-Zt) .* Ht~ + Zt .* Ht-1
+            for (size_t row = 0; row < hiddenSize; ++row)
+            {
+                const auto gate = 2 * hiddenSize + row;
+                for (size_t index = 0; index < hiddenSize; ++index)
+                {
+                    gates[gate] += recurrentWeights[gate * hiddenSize + index] * resetHiddenState[index];
+                }
+            }
+            for (size_t index = 0; index < hiddenSize; ++index)
+            {
+                auto newHiddenState = activationFunction.Apply(gates[index + 2 * hiddenSize]);
+                auto zt = gates[index];
+                _hiddenState[index] = ((1 - zt) * newHiddenState) + (zt * _hiddenState[index]);
+            }
+            output.insert(output.end(), _hiddenState.begin(), _hiddenState.end());
+        }
+        _output.SetOutput(output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    template <typename ActivationType>
-    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength)
+    utilities::ArchiveVersion GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GetArchiveVersion() const
     {
-        function.For(dataLength, [activationFunction, data](emitters::IRFunctionEmitter& function, llvm::Value* index) {
-            auto dataArray = function.LocalArray(data);
-            dataArray[index] = activationFunction.Compile(function, static_cast<emitters::IRLocalScalar>(dataArray[index]));
-        });
+        constexpr utilities::ArchiveVersion archiveVersion = { utilities::ArchiveVersionNumbers::v8_stacked_recurrent_gates };
+
+        return archiveVersion;
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    bool GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::CanReadArchiveVersion(const utilities::ArchiveVersion& version) const
+    {
+        constexpr utilities::ArchiveVersion archiveVersion = { utilities::ArchiveVersionNumbers::v8_stacked_recurrent_gates };
+
+        return version >= archiveVersion;
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        CompilableNode::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[inputWeightsPortName] << _inputWeights;
+        archiver[recurrentWeightsPortName] << _recurrentWeights;
+        archiver[biasPortName] << _bias;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << _outputMemoryLayout;
+        archiver["numTimesteps"] << _numTimesteps;
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        CompilableNode::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[inputWeightsPortName] >> _inputWeights;
+        archiver[recurrentWeightsPortName] >> _recurrentWeights;
+        archiver[biasPortName] >> _bias;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        archiver["outputLayout"] >> _outputMemoryLayout;
+        archiver["numTimesteps"] >> _numTimesteps;
+        _output.SetSize(_numTimesteps * GetHiddenSize());
+        _hiddenState.assign(GetHiddenSize(), 0);
+        VerifyLayouts();
     }
 
     // Notation:
     // The notation in the comments is adapted from the explanation at http://colah.github.io/posts/2015-08-Understanding-LSTMs/
+    // The gates are stacked in the order update, reset, hidden.
     //
-    // Wu == updateWeights
-    // Wr == resetWeights
-    // Wh == hiddenWeights (aka output weights)
-    // Bu == updateBias
-    // Br == resetBias
-    // Bh == hiddenBias
+    // W == inputWeights, an inputSize x (3 * hiddenSize) matrix
+    // U == recurrentWeights, a (3 * hiddenSize) x hiddenSize matrix; Uu, Ur, Uh are its blocks of hiddenSize rows
+    // B == bias
+    // Gt == gate preactivations (one row of the gates buffer per timestep)
     //
     // Zt == updateGateActivation
     // Rt == resetGateActivation
-    // 
-    // [Xt, Ht-1] == inputPlusHidden
+    //
     // Ht~ == newHiddenState
     // Ht == hiddenState (aka, output)
     //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void GRUNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        const size_t inputSize = this->input.Size();
-        const size_t outputSize = this->updateBias.Size();
+        const int numTimesteps = static_cast<int>(_numTimesteps);
+        const int hiddenSize = static_cast<int>(GetHiddenSize());
+        const int gatesSize = 3 * hiddenSize;
+        const int inputSize = static_cast<int>(_inputMemoryLayout.NumEntries() / _numTimesteps);
 
         ActivationFunctionType<ValueType> layerActivationFunction;
         auto activationFunction = GetNodeActivationFunction(layerActivationFunction);
         RecurrentActivationFunctionType<ValueType> recurrentLayerActivationFunction;
         auto recurrentActivationFunction = GetNodeActivationFunction(recurrentLayerActivationFunction);
 
-        // Get LLVM references for all node inputs
-        llvm::Value* input = compiler.EnsurePortEmitted(this->input);
-        llvm::Value* updateWeights = compiler.EnsurePortEmitted(this->updateWeights);
-        llvm::Value* resetWeights = compiler.EnsurePortEmitted(this->resetWeights);
-        llvm::Value* hiddenWeights = compiler.EnsurePortEmitted(this->hiddenWeights);
-        llvm::Value* updateBias = compiler.EnsurePortEmitted(this->updateBias);
-        llvm::Value* resetBias = compiler.EnsurePortEmitted(this->resetBias);
-        llvm::Value* hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
+        // Get LLVM references for all node inputs, with the active region of the input packed into one row per timestep
+        llvm::Value* input = EmitActiveEntries<ValueType>(function, compiler.EnsurePortEmitted(this->input), _inputMemoryLayout);
+        llvm::Value* inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
+        llvm::Value* recurrentWeights = compiler.EnsurePortEmitted(this->recurrentWeights);
+        llvm::Value* hiddenRecurrentWeights = function.PointerOffset(recurrentWeights, 2 * hiddenSize * hiddenSize);
+        auto bias = function.LocalArray(compiler.EnsurePortEmitted(this->bias));
 
-        // Get LLVM reference for node output
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
-
-        // The node's output is the same as the hidden state --- just make an alias so the code looks nicer
-        // Same goes for prevHiddenState
-        auto& hiddenState = output;
-        auto& prevHiddenState = output;
+        // Get LLVM reference for node output, which holds the hidden state of each timestep
+        llvm::Value* output = compiler.EnsurePortEmitted(this->output);
 
         // Allocate local variables
-        auto inputPlusHidden = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), inputSize + outputSize));
-        auto updateGateActivation = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), outputSize));
-        auto resetGateActivation = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), outputSize));
-        auto newHiddenState = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), outputSize));
-
-        // Concatenate input and hidden state into inputPlusHidden: [Xt, Ht-1]
-        function.MemoryCopy<ValueType>(input, inputPlusHidden, inputSize);
-        function.MemoryCopy<ValueType>(hiddenState, 0, inputPlusHidden, inputSize, outputSize);
-        // Now, inputPlusHidden = [Xt, Ht-1]
-
-        // Zt = recurrentFunction(Wu * [Xt, Ht-1] + Bu)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(updateBias, updateGateActivation, outputSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(outputSize, inputSize + outputSize, static_cast<ValueType>(1.0), updateWeights, inputSize + outputSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), updateGateActivation, 1);
-        ApplyActivation(function, recurrentActivationFunction, updateGateActivation, outputSize);
-
-        // Rt = recurrentFunction(Wr * [Xt, Ht-1] + Br)   (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(resetBias, resetGateActivation, outputSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(outputSize, inputSize + outputSize, static_cast<ValueType>(1.0), resetWeights, inputSize + outputSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), resetGateActivation, 1);
-        ApplyActivation(function, recurrentActivationFunction, resetGateActivation, outputSize);
-
-        // Ht~ = activationFunction(Wh * [Xt, (Rt .* Ht-1)] + Bh)   (where activationFunction is typically tanh)
-
-        // in-place modify inputPlusHidden by scaling hidden part by resetGateActivation
-        auto hiddenPart = function.LocalArray(function.PointerOffset(inputPlusHidden, inputSize));
-        function.For(outputSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* index) {
-            hiddenPart[index] = resetGateActivation[index] * hiddenPart[index];
-        });
-
-        // Now, inputPlusHidden == Rt . * [Xt, Ht-1]
-        // newHiddenState = Ht~ = activationFunction(Wh * inputPlusHidden + b_h)  (where activationFunction is usually tanh)
-        function.MemoryCopy<ValueType>(hiddenBias, newHiddenState, outputSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(outputSize, inputSize + outputSize, static_cast<ValueType>(1.0), hiddenWeights, inputSize + outputSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), newHiddenState, 1);
-        ApplyActivation(function, activationFunction, newHiddenState, outputSize);
-
-        // Compute Ht = (1-Zt) .* Ht~ + Zt * Ht-1,
-        function.For(outputSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* index) {
-            auto z_i = updateGateActivation[index];
-
-            // Note: Keep the static cast here -- using 1.0 directly results in NaN
-            auto newValue = ((static_cast<ValueType>(1.0) - z_i) * newHiddenState[index]) + (z_i * prevHiddenState[index]);
-            output[index] = newValue;
+        llvm::Value* gates = function.Variable(emitters::GetVariableType<ValueType>(), numTimesteps * gatesSize);
+        llvm::Value* resetHiddenStateVariable = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
+        auto resetHiddenState = function.LocalArray(resetHiddenStateVariable);
+
+        // The input projection doesn't depend on the hidden state, so compute it for the whole window at once: G = X * W
+        function.CallGEMM<ValueType>(numTimesteps, gatesSize, inputSize, input, inputSize, inputWeights, gatesSize, gates, gatesSize);
+
+        function.For(numTimesteps, [=](emitters::IRFunctionEmitter& function, llvm::Value* timestep) {
+            // Ht-1 is the previous row of the output. For the first timestep, it's the last row left by the previous call.
+            auto t = function.LocalScalar(timestep);
+            auto previousRow = (t + (numTimesteps - 1)) % numTimesteps;
+            llvm::Value* prevHiddenStateRow = function.PointerOffset(output, previousRow * hiddenSize);
+            auto prevHiddenState = function.LocalArray(prevHiddenStateRow);
+            auto hiddenState = function.LocalArray(function.PointerOffset(output, t * hiddenSize));
+            llvm::Value* gatesRow = function.PointerOffset(gates, t * gatesSize);
+            auto g = function.LocalArray(gatesRow);
+
+            // [Gu, Gr] += [Uu, Ur] * Ht-1
+            function.CallGEMV<ValueType>(2 * hiddenSize, hiddenSize, static_cast<ValueType>(1.0), recurrentWeights, hiddenSize, prevHiddenStateRow, 1, static_cast<ValueType>(1.0), gatesRow, 1);
+
+            // Zt = recurrentFunction(Gu + Bu), Rt = recurrentFunction(Gr + Br)    (where recurrentFunction is usually sigmoid)
+            // Zt is stored back into the gates buffer, and only Rt .* Ht-1 is kept from the reset gate
+            function.For(hiddenSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                auto i = function.LocalScalar(index);
+                g[i] = recurrentActivationFunction.Compile(function, g[i] + bias[i]);
+                auto rt = function.LocalScalar(recurrentActivationFunction.Compile(function, g[i + hiddenSize] + bias[i + hiddenSize]));
+                resetHiddenState[i] = rt * prevHiddenState[i];
+            });
+
+            // Gh += Uh * (Rt .* Ht-1)
+            function.CallGEMV<ValueType>(hiddenSize, hiddenSize, static_cast<ValueType>(1.0), hiddenRecurrentWeights, hiddenSize, resetHiddenStateVariable, 1, static_cast<ValueType>(1.0), function.PointerOffset(gatesRow, 2 * hiddenSize), 1);
+
+            // Ht~ = activationFunction(Gh + Bh)   (where activationFunction is usually tanh)
+            // Ht = (1-Zt) .* Ht~ + Zt .* Ht-1
+            function.For(hiddenSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                auto i = function.LocalScalar(index);
+                auto newHiddenState = function.LocalScalar(activationFunction.Compile(function, g[i + 2 * hiddenSize] + bias[i + 2 * hiddenSize]));
+                emitters::IRLocalScalar z_i = g[i];
+
+                // Note: Keep the static cast here -- using 1.0 directly results in NaN
+                hiddenState[i] = ((static_cast<ValueType>(1.0) - z_i) * newHiddenState) + (z_i * prevHiddenState[i]);
+            });
         });
     }
 
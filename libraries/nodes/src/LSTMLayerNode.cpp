@@ -7,10 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "LSTMLayerNode.h"
-#include "BroadcastFunctionNode.h"
 #include "CompiledActivationFunctions.h" // For sigmoid and tanh
 #include "ConstantNode.h"
-#include "MatrixVectorMultiplyNode.h"
+#include "StackedGateWeights.h"
 
 // utilities
 #include "Exception.h"
@@ -20,8 +19,8 @@ namespace ell
 namespace nodes
 {
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMLayerNode(const model::PortElements<ValueType>& input, const LayerType& layer)
-        : BaseType(input, layer)
+    LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMLayerNode(const model::PortElements<ValueType>& input, const LayerType& layer, size_t numTimesteps)
+        : BaseType(input, layer), _numTimesteps(numTimesteps)
     {
         const auto& layerParameters = layer.GetLayerParameters();
         if (HasPadding(layerParameters.inputPaddingParameters))
@@ -33,6 +32,39 @@ namespace nodes
         {
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "LSTMLayerNode does not currently support outputs with padding");
         }
+
+        if (numTimesteps == 0 || input.Size() != numTimesteps * layer.GetInputShape().Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "LSTMLayerNode input must hold the layer input of each timestep");
+        }
+        this->_output.SetSize(numTimesteps * layer.GetOutput().Size());
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(this->_input.GetPortElements());
+        auto newNode = transformer.AddNode<LSTMLayerNode>(newPortElements, this->_layer, _numTimesteps);
+        transformer.MapNodeOutput(this->_output, newNode->output);
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compute() const
+    {
+        // Run the layer once per timestep
+        auto inputVector = this->_input.GetValue();
+        const auto timestepSize = this->_inputTensor.Size();
+        std::vector<ValueType> output;
+        output.reserve(this->_output.Size());
+        for (size_t timestep = 0; timestep < _numTimesteps; ++timestep)
+        {
+            auto inputTensor = typename LayerType::ConstTensorReferenceType{ inputVector.data() + timestep * timestepSize, this->_inputTensor.GetShape() };
+            this->_inputTensor.CopyFrom(inputTensor);
+            this->_layer.Compute();
+            auto timestepOutput = this->_layer.GetOutput().ToArray();
+            output.insert(output.end(), timestepOutput.begin(), timestepOutput.end());
+        }
+        this->_output.SetOutput(output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
@@ -40,59 +72,54 @@ namespace nodes
     {
         auto newInput = transformer.TransformPortElements(this->input.GetPortElements());
 
-        // Transform weights and bias members into constant nodes
-        const auto& inputWeights = this->_layer.GetInputWeights();
-        const auto& forgetMeWeights = this->_layer.GetForgetMeWeights();
-        const auto& candidateWeights = this->_layer.GetCandidateWeights();
-        const auto& outputWeights = this->_layer.GetOutputWeights();
-        const auto& inputBias = this->_layer.GetInputBias();
-        const auto& forgetMeBias = this->_layer.GetForgetMeBias();
-        const auto& candidateBias = this->_layer.GetCandidateBias();
-        const auto& outputBias = this->_layer.GetOutputBias();
-
-        auto inputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(inputWeights.ToArray());
-        auto forgetMeWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(forgetMeWeights.ToArray());
-        auto candidateWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(candidateWeights.ToArray());
-        auto outputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(outputWeights.ToArray());
-
-        auto inputBiasNode = transformer.AddNode<ConstantNode<ValueType>>(inputBias.ToArray());
-        auto forgetMeBiasNode = transformer.AddNode<ConstantNode<ValueType>>(forgetMeBias.ToArray());
-        auto candidateBiasNode = transformer.AddNode<ConstantNode<ValueType>>(candidateBias.ToArray());
-        auto outputBiasNode = transformer.AddNode<ConstantNode<ValueType>>(outputBias.ToArray());
+        // Stack the weights and biases of the gates (in the order input, forget, candidate, output) into constant nodes
+        const size_t inputSize = this->GetInputMemoryLayout().NumEntries();
+        const auto& layer = this->_layer;
+        std::vector<math::ConstRowMatrixReference<ValueType>> gateWeights = { layer.GetInputWeights(), layer.GetForgetMeWeights(), layer.GetCandidateWeights(), layer.GetOutputWeights() };
+        std::vector<math::ConstColumnVectorReference<ValueType>> gateBiases = { layer.GetInputBias(), layer.GetForgetMeBias(), layer.GetCandidateBias(), layer.GetOutputBias() };
+
+        auto inputWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateInputWeights(gateWeights, inputSize));
+        auto recurrentWeightsNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateRecurrentWeights(gateWeights, inputSize));
+        auto biasNode = transformer.AddNode<ConstantNode<ValueType>>(StackGateBiases(gateBiases));
 
         using ComputeNodeType = LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>;
         auto lstmNode = transformer.AddNode<ComputeNodeType>(newInput,
                                                              inputWeightsNode->output,
-                                                             forgetMeWeightsNode->output,
-                                                             candidateWeightsNode->output,
-                                                             outputWeightsNode->output,
-                                                             inputBiasNode->output,
-                                                             forgetMeBiasNode->output,
-                                                             candidateBiasNode->output,
-                                                             outputBiasNode->output,
-                                                             this->GetInputMemoryLayout(),
-                                                             this->GetOutputMemoryLayout());
+                                                             recurrentWeightsNode->output,
+                                                             biasNode->output,
+                                                             GetWindowMemoryLayout(this->GetInputMemoryLayout(), _numTimesteps),
+                                                             GetWindowMemoryLayout(this->GetOutputMemoryLayout(), _numTimesteps),
+                                                             _numTimesteps);
 
         transformer.MapNodeOutput(this->output, lstmNode->output);
         return true;
     }
 
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        BaseType::WriteToArchive(archiver);
+        archiver["numTimesteps"] << _numTimesteps;
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMLayerNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        BaseType::ReadFromArchive(archiver);
+        archiver.OptionalProperty("numTimesteps", size_t{ 1 }) >> _numTimesteps;
+        this->_output.SetSize(_numTimesteps * this->_layer.GetOutput().Size());
+    }
+
     //
     // LSTMNode
     //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMNode()
-        : CompilableNode({ &_input, &_inputWeights, &_forgetMeWeights, &_candidateWeights, &_outputWeights, &_inputBias, &_forgetMeBias, &_candidateBias, &_outputBias },
-                         { &_output })
+        : CompilableNode({ &_input, &_inputWeights, &_recurrentWeights, &_bias }, { &_output })
         , _input(this, {}, defaultInputPortName)
         , _inputWeights(this, {}, inputWeightsPortName)
-        , _forgetMeWeights(this, {}, forgetMeWeightsPortName)
-        , _candidateWeights(this, {}, candidateWeightsPortName)
-        , _outputWeights(this, {}, outputWeightsPortName)
-        , _inputBias(this, {}, inputBiasPortName)
-        , _forgetMeBias(this, {}, forgetMeBiasPortName)
-        , _candidateBias(this, {}, candidateBiasPortName)
-        , _outputBias(this, {}, outputBiasPortName)
+        , _recurrentWeights(this, {}, recurrentWeightsPortName)
+        , _bias(this, {}, biasPortName)
         , _output(this, defaultOutputPortName, 0)
     {
     }
@@ -100,28 +127,51 @@ namespace nodes
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::LSTMNode(const model::PortElements<ValueType>& input,
                                                                                            const model::PortElements<ValueType>& inputWeights,
-                                                                                           const model::PortElements<ValueType>& forgetMeWeights,
-                                                                                           const model::PortElements<ValueType>& candidateWeights,
-                                                                                           const model::PortElements<ValueType>& outputWeights,
-                                                                                           const model::PortElements<ValueType>& inputBias,
-                                                                                           const model::PortElements<ValueType>& forgetMeBias,
-                                                                                           const model::PortElements<ValueType>& candidateBias,
-                                                                                           const model::PortElements<ValueType>& outputBias,
+                                                                                           const model::PortElements<ValueType>& recurrentWeights,
+                                                                                           const model::PortElements<ValueType>& bias,
                                                                                            const model::PortMemoryLayout& inputMemoryLayout,
-                                                                                           const model::PortMemoryLayout& outputMemoryLayout)
-        : CompilableNode({ &_input, &_inputWeights, &_forgetMeWeights, &_candidateWeights, &_outputWeights, &_inputBias, &_forgetMeBias, &_candidateBias, &_outputBias },
-                         { &_output })
+                                                                                           const model::PortMemoryLayout& outputMemoryLayout,
+                                                                                           size_t numTimesteps)
+        : CompilableNode({ &_input, &_inputWeights, &_recurrentWeights, &_bias }, { &_output })
         , _input(this, input, defaultInputPortName)
         , _inputWeights(this, inputWeights, inputWeightsPortName)
-        , _forgetMeWeights(this, forgetMeWeights, forgetMeWeightsPortName)
-        , _candidateWeights(this, candidateWeights, candidateWeightsPortName)
-        , _outputWeights(this, outputWeights, outputWeightsPortName)
-        , _inputBias(this, inputBias, inputBiasPortName)
-        , _forgetMeBias(this, forgetMeBias, forgetMeBiasPortName)
-        , _candidateBias(this, candidateBias, candidateBiasPortName)
-        , _outputBias(this, outputBias, outputBiasPortName)
-        , _output(this, defaultOutputPortName, inputBias.Size())
+        , _recurrentWeights(this, recurrentWeights, recurrentWeightsPortName)
+        , _bias(this, bias, biasPortName)
+        , _output(this, defaultOutputPortName, numTimesteps * (bias.Size() / 4))
+        , _inputMemoryLayout(inputMemoryLayout)
+        , _outputMemoryLayout(outputMemoryLayout)
+        , _numTimesteps(numTimesteps)
+        , _hiddenState(bias.Size() / 4)
+        , _cellState(bias.Size() / 4)
+    {
+        const auto hiddenSize = GetHiddenSize();
+        if (numTimesteps == 0 || hiddenSize == 0 || bias.Size() != 4 * hiddenSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "LSTMNode needs at least one timestep and a bias for each of its 4 gates");
+        }
+
+        VerifyLayouts();
+    }
+
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::VerifyLayouts() const
     {
+        const auto hiddenSize = GetHiddenSize();
+        const auto numInputEntries = _inputMemoryLayout.NumEntries();
+        if (_numTimesteps == 0 || numInputEntries % _numTimesteps != 0 || _recurrentWeights.Size() != 4 * hiddenSize * hiddenSize || _inputWeights.Size() != 4 * hiddenSize * (numInputEntries / _numTimesteps))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "LSTMNode weights don't match the input and hidden sizes");
+        }
+
+        if (_input.Size() != _inputMemoryLayout.GetMemorySize() || _output.Size() != _outputMemoryLayout.NumEntries())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "LSTMNode memory layouts don't match its input and output");
+        }
+
+        if (_outputMemoryLayout.GetMemorySize() != _outputMemoryLayout.NumEntries())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "LSTMNode does not currently support outputs with padding");
+        }
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
@@ -129,80 +179,125 @@ namespace nodes
     {
         auto newInput = transformer.TransformPortElements(_input.GetPortElements());
         auto newInputWeights = transformer.TransformPortElements(_inputWeights.GetPortElements());
-        auto newForgetMeWeights = transformer.TransformPortElements(_forgetMeWeights.GetPortElements());
-        auto newCandidateWeights = transformer.TransformPortElements(_candidateWeights.GetPortElements());
-        auto newOutputWeights = transformer.TransformPortElements(_outputWeights.GetPortElements());
-        auto newInputBias = transformer.TransformPortElements(_inputBias.GetPortElements());
-        auto newForgetMeBias = transformer.TransformPortElements(_forgetMeBias.GetPortElements());
-        auto newCandidateBias = transformer.TransformPortElements(_candidateBias.GetPortElements());
-        auto newOutputBias = transformer.TransformPortElements(_outputBias.GetPortElements());
-        auto newNode = transformer.AddNode<LSTMNode>(newInput, newInputWeights, newForgetMeWeights, newCandidateWeights, newOutputWeights, newInputBias, newForgetMeBias, newCandidateBias, newOutputBias, _inputMemoryLayout, _outputMemoryLayout);
+        auto newRecurrentWeights = transformer.TransformPortElements(_recurrentWeights.GetPortElements());
+        auto newBias = transformer.TransformPortElements(_bias.GetPortElements());
+        auto newNode = transformer.AddNode<LSTMNode>(newInput, newInputWeights, newRecurrentWeights, newBias, _inputMemoryLayout, _outputMemoryLayout, _numTimesteps);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compute() const
     {
-        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "LSTMNode does not currently compute");
+        const auto hiddenSize = GetHiddenSize();
+        const auto gatesSize = 4 * hiddenSize;
+        const auto input = GetActiveEntries(_input.GetValue(), _inputMemoryLayout);
+        const auto inputSize = input.size() / _numTimesteps;
+        const auto inputWeights = _inputWeights.GetValue();
+        const auto recurrentWeights = _recurrentWeights.GetValue();
+        const auto bias = _bias.GetValue();
+
+        ActivationFunctionType<ValueType> activationFunction;
+        RecurrentActivationFunctionType<ValueType> recurrentActivationFunction;
+
+        std::vector<ValueType> output;
+        output.reserve(_numTimesteps * hiddenSize);
+        std::vector<ValueType> gates(gatesSize);
+        for (size_t timestep = 0; timestep < _numTimesteps; ++timestep)
+        {
+            // Gt = Xt * W + U * Ht-1 + B
+            for (size_t gate = 0; gate < gatesSize; ++gate)
+            {
+                auto value = bias[gate];
+                for (size_t index = 0; index < inputSize; ++index)
+                {
+                    value += input[timestep * inputSize + index] * inputWeights[index * gatesSize + gate];
+                }
+                for (size_t index = 0; index < hiddenSize; ++index)
+                {
+                    value += recurrentWeights[gate * hiddenSize + index] * _hiddenState[index];
+                }
+                gates[gate] = value;
+            }
+
+            // Ct = Ft * Ct-1 + It * Ct~
+            // Ht = Ot * activationFunction(Ct)
+            for (size_t index = 0; index < hiddenSize; ++index)
+            {
+                auto it = recurrentActivationFunction.Apply(gates[index]);
+                auto ft = recurrentActivationFunction.Apply(gates[index + hiddenSize]);
+                auto ctNew = activationFunction.Apply(gates[index + 2 * hiddenSize]);
+                auto ot = recurrentActivationFunction.Apply(gates[index + 3 * hiddenSize]);
+                _cellState[index] = ft * _cellState[index] + it * ctNew;
+                _hiddenState[index] = ot * activationFunction.Apply(_cellState[index]);
+            }
+            output.insert(output.end(), _hiddenState.begin(), _hiddenState.end());
+        }
+        _output.SetOutput(output);
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplySoftmax(emitters::IRFunctionEmitter& function, llvm::Value* data, size_t dataLength)
+    utilities::ArchiveVersion LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::GetArchiveVersion() const
     {
-        const auto plusFloat = emitters::TypedOperator::addFloat;
-        const auto divideFloat = emitters::TypedOperator::divideFloat;
-        auto expFunc = function.GetModule().GetRuntime().GetExpFunction<ValueType>();
+        constexpr utilities::ArchiveVersion archiveVersion = { utilities::ArchiveVersionNumbers::v8_stacked_recurrent_gates };
 
-        llvm::AllocaInst* sum = function.Variable(emitters::GetVariableType<ValueType>(), 1);
-        function.SetValueAt(sum, 0, function.Literal<ValueType>(0.0));
+        return archiveVersion;
+    }
 
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    bool LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::CanReadArchiveVersion(const utilities::ArchiveVersion& version) const
+    {
+        constexpr utilities::ArchiveVersion archiveVersion = { utilities::ArchiveVersionNumbers::v8_stacked_recurrent_gates };
 
-            auto expInput = function.Call(expFunc, { inputValue });
-            auto addToSum = function.Operator(plusFloat, function.ValueAt(sum, 0), expInput);
-            function.SetValueAt(sum, 0, addToSum);
-            function.SetValueAt(data, i, expInput);
-        }
-        forLoop.End();
+        return version >= archiveVersion;
+    }
 
-        auto forLoop2 = function.ForLoop();
-        forLoop2.Begin(dataLength);
-        {
-            auto i = forLoop2.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            auto expDivSum = function.Operator(divideFloat, inputValue, function.ValueAt(sum, 0));
-            function.SetValueAt(data, i, expDivSum);
-        }
-        forLoop2.End();
+    template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
+    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        CompilableNode::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[inputWeightsPortName] << _inputWeights;
+        archiver[recurrentWeightsPortName] << _recurrentWeights;
+        archiver[biasPortName] << _bias;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << _outputMemoryLayout;
+        archiver["numTimesteps"] << _numTimesteps;
     }
 
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
-    template <typename ActivationType>
-    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ApplyActivation(emitters::IRFunctionEmitter& function, ActivationType& activationFunction, llvm::Value* data, size_t dataLength)
+    void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::ReadFromArchive(utilities::Unarchiver& archiver)
     {
-        auto forLoop = function.ForLoop();
-        forLoop.Begin(dataLength);
-        {
-            auto i = forLoop.LoadIterationVariable();
-            llvm::Value* inputValue = function.ValueAt(data, i);
-            llvm::Value* x = activationFunction.Compile(function, inputValue);
-            function.SetValueAt(data, i, x);
-        }
-        forLoop.End();
+        CompilableNode::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[inputWeightsPortName] >> _inputWeights;
+        archiver[recurrentWeightsPortName] >> _recurrentWeights;
+        archiver[biasPortName] >> _bias;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        archiver["outputLayout"] >> _outputMemoryLayout;
+        archiver["numTimesteps"] >> _numTimesteps;
+        _output.SetSize(_numTimesteps * GetHiddenSize());
+        _hiddenState.assign(GetHiddenSize(), 0);
+        _cellState.assign(GetHiddenSize(), 0);
+        VerifyLayouts();
     }
 
+    // Notation:
+    // The gates are stacked in the order input (It), forget (Ft), candidate (Ct~), output (Ot).
+    //
+    // W == inputWeights, an inputSize x (4 * hiddenSize) matrix
+    // U == recurrentWeights, a (4 * hiddenSize) x hiddenSize matrix
+    // B == bias
+    // Gt == gate preactivations, Xt * W + U * Ht-1 (one row of the gates buffer per timestep)
+    // Ct == cell state
+    // Ht == hidden state (aka, output)
+    //
     template <typename ValueType, template <typename> class ActivationFunctionType, template <typename> class RecurrentActivationFunctionType>
     void LSTMNode<ValueType, ActivationFunctionType, RecurrentActivationFunctionType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        const auto plusFloat = emitters::TypedOperator::addFloat;
-        const auto timesFloat = emitters::TypedOperator::multiplyFloat;
-
-        const size_t inputSize = this->input.Size();
-        const size_t hiddenSize = this->inputBias.Size();
+        const int numTimesteps = static_cast<int>(_numTimesteps);
+        const int hiddenSize = static_cast<int>(GetHiddenSize());
+        const int gatesSize = 4 * hiddenSize;
+        const int inputSize = static_cast<int>(_inputMemoryLayout.NumEntries() / _numTimesteps);
 
         ActivationFunctionType<ValueType> layerActivationFunction;
         auto activationFunction = GetNodeActivationFunction(layerActivationFunction);
@@ -210,90 +305,48 @@ namespace nodes
         auto recurrentActivationFunction = GetNodeActivationFunction(recurrentLayerActivationFunction);
 
         // Global state (in addition to output)
-        llvm::GlobalVariable* ctActual = function.GetModule().GlobalArray(emitters::GetVariableType<ValueType>(), "ctActual", hiddenSize);
+        auto cellState = function.LocalArray(function.GetModule().GlobalArray(emitters::GetVariableType<ValueType>(), "ctActual", hiddenSize));
 
-        // Get LLVM references for all node inputs
-        llvm::Value* input = compiler.EnsurePortEmitted(this->input);
+        // Get LLVM references for all node inputs, with the active region of the input packed into one row per timestep
+        llvm::Value* input = EmitActiveEntries<ValueType>(function, compiler.EnsurePortEmitted(this->input), _inputMemoryLayout);
         llvm::Value* inputWeights = compiler.EnsurePortEmitted(this->inputWeights);
-        llvm::Value* forgetMeWeights = compiler.EnsurePortEmitted(this->forgetMeWeights);
-        llvm::Value* candidateWeights = compiler.EnsurePortEmitted(this->candidateWeights);
-        llvm::Value* outputWeights = compiler.EnsurePortEmitted(this->outputWeights);
+        llvm::Value* recurrentWeights = compiler.EnsurePortEmitted(this->recurrentWeights);
+        auto bias = function.LocalArray(compiler.EnsurePortEmitted(this->bias));
 
-        llvm::Value* inputBias = compiler.EnsurePortEmitted(this->inputBias);
-        llvm::Value* forgetMeBias = compiler.EnsurePortEmitted(this->forgetMeBias);
-        llvm::Value* candidateBias = compiler.EnsurePortEmitted(this->candidateBias);
-        llvm::Value* outputBias = compiler.EnsurePortEmitted(this->outputBias);
-
-        // Get LLVM reference for node output
+        // Get LLVM reference for node output, which holds the hidden state of each timestep
         llvm::Value* output = compiler.EnsurePortEmitted(this->output);
 
-        // The node's output is the same as the hidden state --- just make an alias so the code looks nicer
-        auto& hiddenState = output;
-
-        // Allocate local variables
-        llvm::AllocaInst* inputPlusHidden = function.Variable(emitters::GetVariableType<ValueType>(), inputSize + hiddenSize);
-        llvm::AllocaInst* ft = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* it = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* ctNew = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-        llvm::AllocaInst* ot = function.Variable(emitters::GetVariableType<ValueType>(), hiddenSize);
-
-        // Concatenate input and hidden state into combined [Xt, Ht-1]
-        function.MemoryCopy<ValueType>(input, inputPlusHidden, inputSize);
-        function.MemoryCopy<ValueType>(hiddenState, 0, inputPlusHidden, inputSize, hiddenSize);
-
-        // ft = recurrentFunction(Wf * [Xt, Ht-1] + Bf)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(forgetMeBias, ft, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), forgetMeWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ft, 1);
-        ApplyActivation(function, recurrentActivationFunction, ft, hiddenSize);
-
-        // it = recurrentFunction(Wi * [Xt, Ht-1] + Bi)    (where recurrentFunction is usually sigmoid)
-        function.MemoryCopy<ValueType>(inputBias, it, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), inputWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), it, 1);
-        ApplyActivation(function, recurrentActivationFunction, it, hiddenSize);
-
-        // Ct~ = activationFunction(Wc * [Xt, Ht-1] + Bc)  (where activationFunction is usually tanh)
-        function.MemoryCopy<ValueType>(candidateBias, ctNew, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), candidateWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ctNew, 1);
-        ApplyActivation(function, activationFunction, ctNew, hiddenSize);
-
-        // Ct = ft * Ct-1 + it * Ct~
-        auto ctActualLoop = function.ForLoop();
-        ctActualLoop.Begin(hiddenSize);
-        {
-            auto index = ctActualLoop.LoadIterationVariable();
-            auto ctActualVal = function.ValueAt(ctActual, index);
-            auto ftVal = function.ValueAt(ft, index);
-            auto itVal = function.ValueAt(it, index);
-            auto ctNewVal = function.ValueAt(ctNew, index);
-
-            auto ftCt = function.Operator(timesFloat, ftVal, ctActualVal);
-            auto itctNew = function.Operator(timesFloat, itVal, ctNewVal);
-
-            auto result = function.Operator(plusFloat, ftCt, itctNew);
-            function.SetValueAt(ctActual, index, result);
-        }
-        ctActualLoop.End();
-
-        // ot = recurrentFunction(Wo * [Xt, Ht-1] + Bo)
-        function.MemoryCopy<ValueType>(outputBias, ot, hiddenSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenSize, inputSize + hiddenSize, static_cast<ValueType>(1.0), outputWeights, inputSize + hiddenSize, inputPlusHidden, 1, static_cast<ValueType>(1.0), ot, 1);
-        ApplyActivation(function, recurrentActivationFunction, ot, hiddenSize);
-
-        // compute the hidden layer and copy into state vector
-        // ht = ot * activationFunction(Ct)  (where activationFunction is usually tanh)
-        ApplyActivation(function, activationFunction, ctActual, hiddenSize);
-
-        auto outputLoop = function.ForLoop();
-        outputLoop.Begin(hiddenSize);
-        {
-            auto index = outputLoop.LoadIterationVariable();
-            auto otVal = function.ValueAt(ot, index);
-            auto ctVal = function.ValueAt(ctActual, index);
-            auto result = function.Operator(timesFloat, ctVal, otVal);
-            function.SetValueAt(hiddenState, index, result);
-        }
-        outputLoop.End();
-        // output <- hiddenState (no-op, since output and hidden state are aliases)
+        // The input projection doesn't depend on the hidden state, so compute it for the whole window at once: G = X * W
+        llvm::Value* gates = function.Variable(emitters::GetVariableType<ValueType>(), numTimesteps * gatesSize);
+        function.CallGEMM<ValueType>(numTimesteps, gatesSize, inputSize, input, inputSize, inputWeights, gatesSize, gates, gatesSize);
+
+        function.For(numTimesteps, [=](emitters::IRFunctionEmitter& function, llvm::Value* timestep) {
+            // Ht-1 is the previous row of the output. For the first timestep, it's the last row left by the previous call.
+            auto t = function.LocalScalar(timestep);
+            auto previousRow = (t + (numTimesteps - 1)) % numTimesteps;
+            llvm::Value* prevHiddenState = function.PointerOffset(output, previousRow * hiddenSize);
+            auto hiddenState = function.LocalArray(function.PointerOffset(output, t * hiddenSize));
+            llvm::Value* gatesRow = function.PointerOffset(gates, t * gatesSize);
+
+            // Gt += U * Ht-1, the only matrix product on the sequential path
+            function.CallGEMV<ValueType>(gatesSize, hiddenSize, static_cast<ValueType>(1.0), recurrentWeights, hiddenSize, prevHiddenState, 1, static_cast<ValueType>(1.0), gatesRow, 1);
+
+            // Apply the gate activations, update the cell and compute the new hidden state in a single pass:
+            // Ct = Ft * Ct-1 + It * Ct~
+            // Ht = Ot * activationFunction(Ct)
+            auto g = function.LocalArray(gatesRow);
+            function.For(hiddenSize, [=](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+                auto i = function.LocalScalar(index);
+                auto it = function.LocalScalar(recurrentActivationFunction.Compile(function, g[i] + bias[i]));
+                auto ft = function.LocalScalar(recurrentActivationFunction.Compile(function, g[i + hiddenSize] + bias[i + hiddenSize]));
+                auto ctNew = function.LocalScalar(activationFunction.Compile(function, g[i + 2 * hiddenSize] + bias[i + 2 * hiddenSize]));
+                auto ot = function.LocalScalar(recurrentActivationFunction.Compile(function, g[i + 3 * hiddenSize] + bias[i + 3 * hiddenSize]));
+
+                auto ct = ft * cellState[i] + it * ctNew;
+                cellState[i] = ct;
+                hiddenState[i] = ot * function.LocalScalar(activationFunction.Compile(function, ct));
+            });
+        });
     }
 
     // Explicit specialization
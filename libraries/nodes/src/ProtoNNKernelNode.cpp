@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ProtoNNKernelNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ProtoNNKernelNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <cmath>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    ProtoNNKernelNode<ValueType>::ProtoNNKernelNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    ProtoNNKernelNode<ValueType>::ProtoNNKernelNode(const model::PortElements<ValueType>& input, const predictors::ProtoNNPredictor& predictor, ProtoNNProjectionFormat projectionFormat)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, predictor.GetNumLabels()), _predictor(predictor), _projectionFormat(projectionFormat)
+    {
+        if (input.Size() != predictor.GetDimension())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "ProtoNNKernelNode input size must match the predictor's dimension");
+        }
+        SetParameters();
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::SetParameters()
+    {
+        const auto& projection = _predictor.GetProjectionMatrix();
+        const auto& prototypes = _predictor.GetPrototypes();
+        const auto& labelEmbeddings = _predictor.GetLabelEmbeddings();
+        _dimension = _predictor.GetDimension();
+        _projectedDimension = _predictor.GetProjectedDimension();
+        _numPrototypes = _predictor.GetNumPrototypes();
+        _numLabels = _predictor.GetNumLabels();
+        _negativeGammaSquared = static_cast<ValueType>(-_predictor.GetGamma() * _predictor.GetGamma());
+
+        size_t numNonzeros = 0;
+        for (size_t j = 0; j < _dimension; ++j)
+        {
+            for (size_t r = 0; r < _projectedDimension; ++r)
+            {
+                numNonzeros += projection(r, j) != 0 ? 1 : 0;
+            }
+        }
+        switch (_projectionFormat)
+        {
+        case ProtoNNProjectionFormat::automatic:
+            _isProjectionSparse = 2 * numNonzeros <= _dimension * _projectedDimension;
+            break;
+        case ProtoNNProjectionFormat::dense:
+            _isProjectionSparse = false;
+            break;
+        case ProtoNNProjectionFormat::sparse:
+            _isProjectionSparse = true;
+            break;
+        }
+
+        _projection.clear();
+        _projectionColumnStarts.clear();
+        _projectionRows.clear();
+        if (_isProjectionSparse)
+        {
+            _projectionColumnStarts.push_back(0);
+            for (size_t j = 0; j < _dimension; ++j)
+            {
+                for (size_t r = 0; r < _projectedDimension; ++r)
+                {
+                    if (projection(r, j) != 0)
+                    {
+                        _projection.push_back(static_cast<ValueType>(projection(r, j)));
+                        _projectionRows.push_back(static_cast<int>(r));
+                    }
+                }
+                _projectionColumnStarts.push_back(static_cast<int>(_projection.size()));
+            }
+        }
+        else
+        {
+            _projection.reserve(_dimension * _projectedDimension);
+            for (size_t j = 0; j < _dimension; ++j)
+            {
+                for (size_t r = 0; r < _projectedDimension; ++r)
+                {
+                    _projection.push_back(static_cast<ValueType>(projection(r, j)));
+                }
+            }
+        }
+
+        _prototypes.resize(_numPrototypes * _projectedDimension);
+        _labelEmbeddings.resize(_numPrototypes * _numLabels);
+        for (size_t k = 0; k < _numPrototypes; ++k)
+        {
+            for (size_t r = 0; r < _projectedDimension; ++r)
+            {
+                _prototypes[k * _projectedDimension + r] = static_cast<ValueType>(prototypes(r, k));
+            }
+            for (size_t l = 0; l < _numLabels; ++l)
+            {
+                _labelEmbeddings[k * _numLabels + l] = static_cast<ValueType>(labelEmbeddings(l, k));
+            }
+        }
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::Compute() const
+    {
+        auto input = _input.GetValue();
+
+        // Projection
+        std::vector<ValueType> projected(_projectedDimension, 0);
+        for (size_t j = 0; j < _dimension; ++j)
+        {
+            auto x = input[j];
+            if (_isProjectionSparse)
+            {
+                for (auto entry = _projectionColumnStarts[j]; entry < _projectionColumnStarts[j + 1]; ++entry)
+                {
+                    projected[_projectionRows[entry]] += _projection[entry] * x;
+                }
+            }
+            else
+            {
+                for (size_t r = 0; r < _projectedDimension; ++r)
+                {
+                    projected[r] += _projection[j * _projectedDimension + r] * x;
+                }
+            }
+        }
+
+        // Distance, similarity and label scores, one prototype at a time
+        std::vector<ValueType> scores(_numLabels, 0);
+        for (size_t k = 0; k < _numPrototypes; ++k)
+        {
+            ValueType distance = 0;
+            for (size_t r = 0; r < _projectedDimension; ++r)
+            {
+                auto diff = projected[r] - _prototypes[k * _projectedDimension + r];
+                distance += diff * diff;
+            }
+            auto similarity = std::exp(_negativeGammaSquared * distance);
+            for (size_t l = 0; l < _numLabels; ++l)
+            {
+                scores[l] += _labelEmbeddings[k * _numLabels + l] * similarity;
+            }
+        }
+
+        _output.SetOutput(scores);
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<ProtoNNKernelNode<ValueType>>(newPortElements, _predictor, _projectionFormat);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        auto& module = function.GetModule();
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        const auto projectedDimension = static_cast<int>(_projectedDimension);
+        const auto numLabels = static_cast<int>(_numLabels);
+        const auto stateIdentifier = GetInternalStateIdentifier();
+
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+
+        auto prototypes = function.LocalArray(module.ConstantArray("prototypes_"s + stateIdentifier, _prototypes));
+        auto labelEmbeddings = function.LocalArray(module.ConstantArray("labelEmbeddings_"s + stateIdentifier, _labelEmbeddings));
+
+        // The projected input lives on the stack, and the label scores are accumulated directly in the output
+        auto projected = function.LocalArray(function.Variable(valueType, projectedDimension));
+        auto scores = function.LocalArray(numLabels == 1 ? function.Variable(valueType, 1) : pOutput);
+        llvm::Value* distanceVar = function.Variable(valueType, "distance");
+
+        function.For(_projectedDimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* r) {
+            projected[r] = function.Literal(static_cast<ValueType>(0));
+        });
+        function.For(_numLabels, [&](emitters::IRFunctionEmitter& function, llvm::Value* l) {
+            scores[l] = function.Literal(static_cast<ValueType>(0));
+        });
+
+        // Projection. An all-zero sparse projection has no entries, so there's no array to emit, and the projected
+        // input stays zero.
+        if (_isProjectionSparse && !_projection.empty())
+        {
+            auto projection = function.LocalArray(module.ConstantArray("projection_"s + stateIdentifier, _projection));
+            auto columnStarts = function.LocalArray(module.ConstantArray("projectionColumnStarts_"s + stateIdentifier, _projectionColumnStarts));
+            auto rows = function.LocalArray(module.ConstantArray("projectionRows_"s + stateIdentifier, _projectionRows));
+            function.For(_dimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* jVar) {
+                auto j = function.LocalScalar(jVar);
+                auto x = function.LocalScalar(_dimension == 1 ? pInput : function.ValueAt(pInput, j));
+                emitters::IRLocalScalar begin = columnStarts[j];
+                emitters::IRLocalScalar end = columnStarts[j + 1];
+                function.For(begin, end, [&](emitters::IRFunctionEmitter& function, llvm::Value* entry) {
+                    emitters::IRLocalScalar r = rows[entry];
+                    emitters::IRLocalScalar value = projection[entry];
+                    emitters::IRLocalScalar sum = projected[r];
+                    projected[r] = sum + value * x;
+                });
+            });
+        }
+        else if (!_isProjectionSparse)
+        {
+            auto projection = function.LocalArray(module.ConstantArray("projection_"s + stateIdentifier, _projection));
+            function.For(_dimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* jVar) {
+                auto j = function.LocalScalar(jVar);
+                auto x = function.LocalScalar(_dimension == 1 ? pInput : function.ValueAt(pInput, j));
+                auto columnOffset = j * projectedDimension;
+                function.For(_projectedDimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* rVar) {
+                    auto r = function.LocalScalar(rVar);
+                    emitters::IRLocalScalar value = projection[columnOffset + r];
+                    emitters::IRLocalScalar sum = projected[r];
+                    projected[r] = sum + value * x;
+                });
+            });
+        }
+
+        // Distance, similarity and label scores, one prototype at a time
+        function.For(_numPrototypes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+            auto k = function.LocalScalar(kVar);
+            auto prototypeOffset = k * projectedDimension;
+            function.StoreZero(distanceVar);
+            function.For(_projectedDimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* rVar) {
+                auto r = function.LocalScalar(rVar);
+                emitters::IRLocalScalar projectedValue = projected[r];
+                emitters::IRLocalScalar prototypeValue = prototypes[prototypeOffset + r];
+                auto diff = projectedValue - prototypeValue;
+                function.Store(distanceVar, function.LocalScalar(function.Load(distanceVar)) + diff * diff);
+            });
+
+            auto similarity = Exp(function.LocalScalar(function.Load(distanceVar)) * _negativeGammaSquared);
+            auto labelOffset = k * numLabels;
+            function.For(_numLabels, [&](emitters::IRFunctionEmitter& function, llvm::Value* lVar) {
+                auto l = function.LocalScalar(lVar);
+                emitters::IRLocalScalar embedding = labelEmbeddings[labelOffset + l];
+                emitters::IRLocalScalar score = scores[l];
+                scores[l] = score + embedding * similarity;
+            });
+        });
+
+        if (numLabels == 1)
+        {
+            emitters::IRLocalScalar score = scores[0];
+            function.Store(pOutput, score);
+        }
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["predictor"] << _predictor;
+        archiver["projectionFormat"] << static_cast<int>(_projectionFormat);
+    }
+
+    template <typename ValueType>
+    void ProtoNNKernelNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["predictor"] >> _predictor;
+        int projectionFormat = 0;
+        archiver["projectionFormat"] >> projectionFormat;
+        _projectionFormat = static_cast<ProtoNNProjectionFormat>(projectionFormat);
+        SetParameters();
+        _output.SetSize(_numLabels);
+    }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class ProtoNNKernelNode<float>;
+    template class ProtoNNKernelNode<double>;
+} // nodes
+} // ell
@@ -1,7 +1,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //  Project:  Embedded Learning Library (ELL)
-//  File:     ProjectionPredictorNode.cpp (nodes)
+//  File:     ProtoNNPredictorNode.cpp (nodes)
 //  Authors:  Suresh Iyengar
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,14 +9,7 @@
 #include "ProtoNNPredictorNode.h"
 
 // nodes
-#include "BinaryOperationNode.h"
-#include "ConstantNode.h"
-#include "DotProductNode.h"
-#include "L2NormSquaredNode.h"
-#include "UnaryOperationNode.h"
-#include "MatrixVectorProductNode.h"
-#include "SquaredEuclideanDistanceNode.h"
-#include "ExtremalValueNode.h"
+#include "ProtoNNKernelNode.h"
 
 // utilities
 #include "Exception.h"
@@ -33,18 +26,21 @@ namespace ell
 {
 namespace nodes
 {
-    ProtoNNPredictorNode::ProtoNNPredictorNode()
+    template <typename ValueType>
+    ProtoNNPredictorNode<ValueType>::ProtoNNPredictorNode()
         : Node({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
     {
     }
 
-    ProtoNNPredictorNode::ProtoNNPredictorNode(const model::PortElements<double>& input, const predictors::ProtoNNPredictor& predictor)
+    template <typename ValueType>
+    ProtoNNPredictorNode<ValueType>::ProtoNNPredictorNode(const model::PortElements<ValueType>& input, const predictors::ProtoNNPredictor& predictor)
         : Node({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, predictor.GetNumLabels()), _predictor(predictor)
     {
         assert(input.Size() == predictor.GetDimension());
     }
 
-    void ProtoNNPredictorNode::WriteToArchive(utilities::Archiver& archiver) const
+    template <typename ValueType>
+    void ProtoNNPredictorNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
         Node::WriteToArchive(archiver);
         archiver[defaultInputPortName] << _input;
@@ -52,7 +48,8 @@ namespace nodes
         archiver["predictor"] << _predictor;
     }
 
-    void ProtoNNPredictorNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    template <typename ValueType>
+    void ProtoNNPredictorNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
     {
         Node::ReadFromArchive(archiver);
         archiver[defaultInputPortName] >> _input;
@@ -60,46 +57,26 @@ namespace nodes
         archiver["predictor"] >> _predictor;
     }
 
-    void ProtoNNPredictorNode::Copy(model::ModelTransformer& transformer) const
+    template <typename ValueType>
+    void ProtoNNPredictorNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
-        auto newNode = transformer.AddNode<ProtoNNPredictorNode>(newPortElements, _predictor);
+        auto newNode = transformer.AddNode<ProtoNNPredictorNode<ValueType>>(newPortElements, _predictor);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
-    bool ProtoNNPredictorNode::Refine(model::ModelTransformer& transformer) const
+    template <typename ValueType>
+    bool ProtoNNPredictorNode<ValueType>::Refine(model::ModelTransformer& transformer) const
     {
+        // The kernel node computes the projection, the similarity to each prototype and the label scores in one pass
         auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
-
-        // Projection
-        auto projectionMatrix = _predictor.GetProjectionMatrix();
-        auto projecedInputNode = transformer.AddNode<MatrixVectorProductNode<double, math::MatrixLayout::columnMajor>>(newPortElements, projectionMatrix);
-
-        auto prototypes = _predictor.GetPrototypes();
-        auto m = _predictor.GetNumPrototypes();
-
-        std::vector<double> multiplier(m, _predictor.GetGamma() * _predictor.GetGamma() * -1);
-        auto gammaNode = transformer.AddNode<ConstantNode<double>>(multiplier);
-
-        // Distance to each prototype
-        math::RowMatrixReference<double> prototypesMatrix = prototypes.Transpose();
-        auto squareDistanceNode = transformer.AddNode<SquaredEuclideanDistanceNode<double, math::MatrixLayout::rowMajor>>(projecedInputNode->output, prototypesMatrix);
-
-        // Similarity to each prototype
-        auto scaledDistanceNode = transformer.AddNode<BinaryOperationNode<double>>(squareDistanceNode->output, gammaNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
-        auto expDistanceNode = transformer.AddNode<UnaryOperationNode<double>>(scaledDistanceNode->output, emitters::UnaryOperationType::exp);
-
-        // Get the prediction label
-        auto labelScoresNode = transformer.AddNode<MatrixVectorProductNode<double, math::MatrixLayout::columnMajor>>(expDistanceNode->output, _predictor.GetLabelEmbeddings());
-
-        auto outNode = transformer.AddNode<model::OutputNode<double>>(labelScoresNode->output);
-
-        transformer.MapNodeOutput(output, outNode->output);
-
+        auto kernelNode = transformer.AddNode<ProtoNNKernelNode<ValueType>>(newPortElements, _predictor);
+        transformer.MapNodeOutput(output, kernelNode->output);
         return true;
     }
 
-    void ProtoNNPredictorNode::Compute() const
+    template <typename ValueType>
+    void ProtoNNPredictorNode<ValueType>::Compute() const
     {
         auto indexValueIterator = _input.GetIterator();
 
@@ -115,14 +92,23 @@ namespace nodes
             indexValueIterator.Next();
         }
 
-        auto prediction = _predictor.Predict(inputData);
+        auto prediction = _predictor.Predict(inputData).ToArray();
 
-        _output.SetOutput(prediction.ToArray());
+        _output.SetOutput(std::vector<ValueType>(prediction.begin(), prediction.end()));
     }
 
-    ProtoNNPredictorNode* AddNodeToModelTransformer(const model::PortElements<double>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer)
+    template <typename ValueType>
+    ProtoNNPredictorNode<ValueType>* AddNodeToModelTransformer(const model::PortElements<ValueType>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer)
     {
-        return transformer.AddNode<ProtoNNPredictorNode>(input, predictor);
+        return transformer.AddNode<ProtoNNPredictorNode<ValueType>>(input, predictor);
     }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class ProtoNNPredictorNode<float>;
+    template class ProtoNNPredictorNode<double>;
+    template ProtoNNPredictorNode<float>* AddNodeToModelTransformer(const model::PortElements<float>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer);
+    template ProtoNNPredictorNode<double>* AddNodeToModelTransformer(const model::PortElements<double>& input, const predictors::ProtoNNPredictor& predictor, model::ModelTransformer& transformer);
 }
 }
@@ -0,0 +1,369 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessingNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RegionDetectionPostProcessingNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    RegionDetectionPostProcessingNode<ValueType>::RegionDetectionPostProcessingNode()
+        : CompilableNode({ &_input }, { &_output, &_count }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0), _count(this, countPortName, 1), _regionDetectionParams{}
+    {
+    }
+
+    template <typename ValueType>
+    RegionDetectionPostProcessingNode<ValueType>::RegionDetectionPostProcessingNode(const model::PortElements<ValueType>& input, const predictors::neural::RegionDetectionParameters& regionDetectionParams, const predictors::neural::RegionDetectionPostProcessingParameters& postProcessingParams)
+        : CompilableNode({ &_input }, { &_output, &_count }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 0), _count(this, countPortName, 1), _regionDetectionParams(regionDetectionParams), _postProcessingParams(postProcessingParams)
+    {
+        SetOutputSizes();
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::SetOutputSizes()
+    {
+        // The post-processor validates the parameters
+        predictors::neural::RegionDetectionPostProcessor<ValueType> postProcessor(_regionDetectionParams, _postProcessingParams);
+        if (_input.Size() != postProcessor.GetInputSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "RegionDetectionPostProcessingNode input size must match the region detection parameters");
+        }
+        _output.SetSize(postProcessor.GetOutputSize());
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::Compute() const
+    {
+        predictors::neural::RegionDetectionPostProcessor<ValueType> postProcessor(_regionDetectionParams, _postProcessingParams);
+        auto input = _input.GetValue();
+        std::vector<ValueType> detections(postProcessor.GetOutputSize());
+        auto numDetections = postProcessor.Compute(input.data(), detections.data());
+        _output.SetOutput(detections);
+        _count.SetOutput({ static_cast<int>(numDetections) });
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<RegionDetectionPostProcessingNode<ValueType>>(newPortElements, _regionDetectionParams, _postProcessingParams);
+        transformer.MapNodeOutput(output, newNode->output);
+        transformer.MapNodeOutput(count, newNode->count);
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        auto& module = function.GetModule();
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        const auto stateIdentifier = GetInternalStateIdentifier();
+
+        // The region detection layer requires the number of rows to equal `width` and the number of columns to equal `height`
+        const int numRows = _regionDetectionParams.width;
+        const int numColumns = _regionDetectionParams.height;
+        const int numBoxes = _regionDetectionParams.numBoxesPerCell;
+        const int numClasses = _regionDetectionParams.numClasses;
+        const int boxStride = _regionDetectionParams.numCoordinates + 1 + numClasses;
+        const int maxDetectionsPerClass = _postProcessingParams.maxDetectionsPerClass;
+        const int maxDetections = _postProcessingParams.maxDetections;
+        const int numEntries = numClasses * maxDetectionsPerClass;
+        const int detectionSize = static_cast<int>(predictors::neural::regionDetectionSize);
+        const auto threshold = static_cast<ValueType>(_postProcessingParams.confidenceThreshold);
+        const auto nmsThreshold = static_cast<ValueType>(_postProcessingParams.nmsThreshold);
+        const auto zero = static_cast<ValueType>(0);
+        const auto half = static_cast<ValueType>(0.5);
+
+        std::vector<ValueType> anchorWidths(numBoxes, 1);
+        std::vector<ValueType> anchorHeights(numBoxes, 1);
+        const auto& anchorScales = _postProcessingParams.anchorScales;
+        for (size_t k = 0; k < anchorScales.size() / 2; ++k)
+        {
+            anchorWidths[k] = static_cast<ValueType>(anchorScales[2 * k]);
+            anchorHeights[k] = static_cast<ValueType>(anchorScales[2 * k + 1]);
+        }
+
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        llvm::Value* pCount = compiler.EnsurePortEmitted(count);
+
+        auto anchorWidthsArray = function.LocalArray(module.ConstantArray("anchorWidths_"s + stateIdentifier, anchorWidths));
+        auto anchorHeightsArray = function.LocalArray(module.ConstantArray("anchorHeights_"s + stateIdentifier, anchorHeights));
+
+        // The candidates of class c occupy entries [c * maxDetectionsPerClass, (c + 1) * maxDetectionsPerClass) of these
+        // stack arrays, sorted by decreasing confidence
+        auto numCandidates = function.LocalArray(function.Variable(emitters::VariableType::Int32, numClasses));
+        auto next = function.LocalArray(function.Variable(emitters::VariableType::Int32, numClasses));
+        auto confidence = function.LocalArray(function.Variable(valueType, numEntries));
+        auto left = function.LocalArray(function.Variable(valueType, numEntries));
+        auto top = function.LocalArray(function.Variable(valueType, numEntries));
+        auto right = function.LocalArray(function.Variable(valueType, numEntries));
+        auto bottom = function.LocalArray(function.Variable(valueType, numEntries));
+
+        llvm::Value* maxScoreVar = function.Variable(valueType, "maxScore");
+        llvm::Value* sumVar = function.Variable(valueType, "sum");
+        llvm::Value* positionVar = function.Variable(emitters::VariableType::Int32, "position");
+        llvm::Value* numKeptVar = function.Variable(emitters::VariableType::Int32, "numKept");
+        llvm::Value* bestClassVar = function.Variable(emitters::VariableType::Int32, "bestClass");
+        llvm::Value* bestConfidenceVar = function.Variable(valueType, "bestConfidence");
+        llvm::Value* numDetectionsVar = function.Variable(emitters::VariableType::Int32, "numDetections");
+
+        function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* c) {
+            numCandidates[c] = function.Literal<int>(0);
+        });
+
+        // Inserts a candidate into the sorted top-K list of its class, and drops the least confident one if the list is full
+        auto insert = [&](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar c, emitters::IRLocalScalar candidateConfidence, emitters::IRLocalScalar candidateLeft, emitters::IRLocalScalar candidateTop, emitters::IRLocalScalar candidateRight, emitters::IRLocalScalar candidateBottom) {
+            auto begin = c * maxDetectionsPerClass;
+            emitters::IRLocalScalar n = numCandidates[c];
+
+            // Candidates with equal confidence stay in the order they were found
+            function.StoreZero(positionVar);
+            function.For(n, [&](emitters::IRFunctionEmitter& function, llvm::Value* r) {
+                emitters::IRLocalScalar other = confidence[begin + function.LocalScalar(r)];
+                auto position = function.LocalScalar(function.Load(positionVar));
+                function.Store(positionVar, function.Select(candidateConfidence <= other, position + 1, position));
+            });
+            auto position = function.LocalScalar(function.Load(positionVar));
+            function.If(position < maxDetectionsPerClass, [&](emitters::IRFunctionEmitter& function) {
+                auto last = function.LocalScalar(function.Select(n < maxDetectionsPerClass - 1, n, function.LocalScalar(maxDetectionsPerClass - 1)));
+                function.For(position, last, [&](emitters::IRFunctionEmitter& function, llvm::Value* t) {
+                    auto destination = begin + last + position - function.LocalScalar(t);
+                    auto source = destination - 1;
+                    confidence[destination] = static_cast<emitters::IRLocalScalar>(confidence[source]);
+                    left[destination] = static_cast<emitters::IRLocalScalar>(left[source]);
+                    top[destination] = static_cast<emitters::IRLocalScalar>(top[source]);
+                    right[destination] = static_cast<emitters::IRLocalScalar>(right[source]);
+                    bottom[destination] = static_cast<emitters::IRLocalScalar>(bottom[source]);
+                });
+                auto entry = begin + position;
+                confidence[entry] = candidateConfidence;
+                left[entry] = candidateLeft;
+                top[entry] = candidateTop;
+                right[entry] = candidateRight;
+                bottom[entry] = candidateBottom;
+                auto newCount = n + 1;
+                numCandidates[c] = function.Select(newCount < maxDetectionsPerClass, newCount, function.LocalScalar(maxDetectionsPerClass));
+            });
+        };
+
+        // Decode the boxes, and keep the most confident ones of each class
+        function.For(numRows, [&](emitters::IRFunctionEmitter& function, llvm::Value* iVar) {
+            auto i = function.LocalScalar(iVar);
+            function.For(numColumns, [&](emitters::IRFunctionEmitter& function, llvm::Value* jVar) {
+                auto j = function.LocalScalar(jVar);
+                function.For(numBoxes, [&](emitters::IRFunctionEmitter& function, llvm::Value* kVar) {
+                    auto k = function.LocalScalar(kVar);
+                    auto boxOffset = ((i * numColumns + j) * numBoxes + k) * boxStride;
+                    auto classOffset = boxOffset + 5;
+
+                    // The class probabilities are at most 1, so the objectness bounds the confidence of every class
+                    auto objectness = emitters::Sigmoid<ValueType>(input[boxOffset + 4]);
+                    function.If(objectness > threshold, [&](emitters::IRFunctionEmitter& function) {
+                        function.Store(maxScoreVar, static_cast<emitters::IRLocalScalar>(input[classOffset]));
+                        function.For(1, numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* c) {
+                            emitters::IRLocalScalar score = input[classOffset + function.LocalScalar(c)];
+                            auto maxScore = function.LocalScalar(function.Load(maxScoreVar));
+                            function.Store(maxScoreVar, function.Select(score > maxScore, score, maxScore));
+                        });
+                        auto maxScore = function.LocalScalar(function.Load(maxScoreVar));
+                        function.StoreZero(sumVar);
+                        function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* c) {
+                            emitters::IRLocalScalar score = input[classOffset + function.LocalScalar(c)];
+                            function.Store(sumVar, function.LocalScalar(function.Load(sumVar)) + Exp(score - maxScore));
+                        });
+
+                        // The most probable class has probability 1 / sum
+                        auto scale = objectness / function.LocalScalar(function.Load(sumVar));
+                        function.If(scale > threshold, [&](emitters::IRFunctionEmitter& function) {
+                            auto column = function.LocalScalar(function.CastValue<int, ValueType>(j));
+                            auto row = function.LocalScalar(function.CastValue<int, ValueType>(i));
+                            emitters::IRLocalScalar anchorWidth = anchorWidthsArray[k];
+                            emitters::IRLocalScalar anchorHeight = anchorHeightsArray[k];
+                            auto x = (column + emitters::Sigmoid<ValueType>(input[boxOffset])) / static_cast<ValueType>(numColumns);
+                            auto y = (row + emitters::Sigmoid<ValueType>(input[boxOffset + 1])) / static_cast<ValueType>(numRows);
+                            auto halfWidth = anchorWidth * Exp(input[boxOffset + 2]) * (half / static_cast<ValueType>(numColumns));
+                            auto halfHeight = anchorHeight * Exp(input[boxOffset + 3]) * (half / static_cast<ValueType>(numRows));
+                            auto boxLeft = x - halfWidth;
+                            auto boxTop = y - halfHeight;
+                            auto boxRight = x + halfWidth;
+                            auto boxBottom = y + halfHeight;
+                            function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* cVar) {
+                                auto c = function.LocalScalar(cVar);
+                                emitters::IRLocalScalar score = input[classOffset + c];
+                                auto classConfidence = scale * Exp(score - maxScore);
+                                function.If(classConfidence > threshold, [&](emitters::IRFunctionEmitter& function) {
+                                    insert(function, c, classConfidence, boxLeft, boxTop, boxRight, boxBottom);
+                                });
+                            });
+                        });
+                    });
+                });
+            });
+        });
+
+        // Non-maximum suppression within each class, which sets the confidence of the suppressed boxes to zero, and
+        // then removes them from the list. The inner loops are branch-free, so that they're vectorized.
+        function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* cVar) {
+            auto c = function.LocalScalar(cVar);
+            auto begin = c * maxDetectionsPerClass;
+            auto end = begin + static_cast<emitters::IRLocalScalar>(numCandidates[c]);
+            function.For(begin, end, [&](emitters::IRFunctionEmitter& function, llvm::Value* aVar) {
+                auto a = function.LocalScalar(aVar);
+                emitters::IRLocalScalar confidenceA = confidence[a];
+                function.If(confidenceA != zero, [&](emitters::IRFunctionEmitter& function) {
+                    emitters::IRLocalScalar leftA = left[a];
+                    emitters::IRLocalScalar topA = top[a];
+                    emitters::IRLocalScalar rightA = right[a];
+                    emitters::IRLocalScalar bottomA = bottom[a];
+                    auto areaA = (rightA - leftA) * (bottomA - topA);
+                    function.For(a + 1, end, [&](emitters::IRFunctionEmitter& function, llvm::Value* bVar) {
+                        auto b = function.LocalScalar(bVar);
+                        emitters::IRLocalScalar leftB = left[b];
+                        emitters::IRLocalScalar topB = top[b];
+                        emitters::IRLocalScalar rightB = right[b];
+                        emitters::IRLocalScalar bottomB = bottom[b];
+                        emitters::IRLocalScalar confidenceB = confidence[b];
+                        auto minRight = function.LocalScalar(function.Select(rightA < rightB, rightA, rightB));
+                        auto maxLeft = function.LocalScalar(function.Select(leftA > leftB, leftA, leftB));
+                        auto minBottom = function.LocalScalar(function.Select(bottomA < bottomB, bottomA, bottomB));
+                        auto maxTop = function.LocalScalar(function.Select(topA > topB, topA, topB));
+                        auto intersectionWidth = minRight - maxLeft;
+                        auto intersectionHeight = minBottom - maxTop;
+                        intersectionWidth = function.LocalScalar(function.Select(intersectionWidth > zero, intersectionWidth, function.LocalScalar(zero)));
+                        intersectionHeight = function.LocalScalar(function.Select(intersectionHeight > zero, intersectionHeight, function.LocalScalar(zero)));
+                        auto intersection = intersectionWidth * intersectionHeight;
+                        auto areaB = (rightB - leftB) * (bottomB - topB);
+                        auto isSuppressed = intersection > (areaA + areaB - intersection) * nmsThreshold;
+                        confidence[b] = function.Select(isSuppressed, function.LocalScalar(zero), confidenceB);
+                    });
+                });
+            });
+
+            function.StoreZero(numKeptVar);
+            function.For(begin, end, [&](emitters::IRFunctionEmitter& function, llvm::Value* aVar) {
+                auto a = function.LocalScalar(aVar);
+                auto numKept = function.LocalScalar(function.Load(numKeptVar));
+                auto destination = begin + numKept;
+                emitters::IRLocalScalar confidenceA = confidence[a];
+                confidence[destination] = confidenceA;
+                left[destination] = static_cast<emitters::IRLocalScalar>(left[a]);
+                top[destination] = static_cast<emitters::IRLocalScalar>(top[a]);
+                right[destination] = static_cast<emitters::IRLocalScalar>(right[a]);
+                bottom[destination] = static_cast<emitters::IRLocalScalar>(bottom[a]);
+                function.Store(numKeptVar, function.Select(confidenceA != zero, numKept + 1, numKept));
+            });
+            numCandidates[c] = function.Load(numKeptVar);
+        });
+
+        // Fill the list with the most confident detections that survived, by merging the sorted lists of the classes
+        function.For(maxDetections * detectionSize, [&](emitters::IRFunctionEmitter& function, llvm::Value* index) {
+            output[index] = function.Literal(zero);
+        });
+        function.For(maxDetections, [&](emitters::IRFunctionEmitter& function, llvm::Value* d) {
+            output[function.LocalScalar(d) * detectionSize] = function.Literal(static_cast<ValueType>(-1));
+        });
+        function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* c) {
+            next[c] = function.Literal<int>(0);
+        });
+        function.StoreZero(numDetectionsVar);
+        function.For(maxDetections, [&](emitters::IRFunctionEmitter& function, llvm::Value*) {
+            function.Store(bestClassVar, function.Literal<int>(-1));
+            function.StoreZero(bestConfidenceVar);
+            function.For(numClasses, [&](emitters::IRFunctionEmitter& function, llvm::Value* cVar) {
+                auto c = function.LocalScalar(cVar);
+                emitters::IRLocalScalar classNext = next[c];
+                emitters::IRLocalScalar classCount = numCandidates[c];
+
+                // The index is clamped so that the load stays inside the class's list even when the list is exhausted
+                auto isValid = classNext < classCount;
+                auto index = c * maxDetectionsPerClass + function.LocalScalar(function.Select(classNext < maxDetectionsPerClass - 1, classNext, function.LocalScalar(maxDetectionsPerClass - 1)));
+                emitters::IRLocalScalar entryConfidence = confidence[index];
+                auto classConfidence = function.LocalScalar(function.Select(isValid, entryConfidence, function.LocalScalar(zero)));
+                auto bestConfidence = function.LocalScalar(function.Load(bestConfidenceVar));
+                auto isBest = classConfidence > bestConfidence;
+                function.Store(bestClassVar, function.Select(isBest, c, function.LocalScalar(function.Load(bestClassVar))));
+                function.Store(bestConfidenceVar, function.Select(isBest, classConfidence, bestConfidence));
+            });
+            auto bestClass = function.LocalScalar(function.Load(bestClassVar));
+            function.If(bestClass >= 0, [&](emitters::IRFunctionEmitter& function) {
+                emitters::IRLocalScalar classNext = next[bestClass];
+                auto best = bestClass * maxDetectionsPerClass + classNext;
+                auto numDetections = function.LocalScalar(function.Load(numDetectionsVar));
+                auto offset = numDetections * detectionSize;
+                emitters::IRLocalScalar bestLeft = left[best];
+                emitters::IRLocalScalar bestTop = top[best];
+                emitters::IRLocalScalar bestRight = right[best];
+                emitters::IRLocalScalar bestBottom = bottom[best];
+                output[offset] = function.CastValue<int, ValueType>(bestClass);
+                output[offset + 1] = function.Load(bestConfidenceVar);
+                output[offset + 2] = (bestLeft + bestRight) * half;
+                output[offset + 3] = (bestTop + bestBottom) * half;
+                output[offset + 4] = bestRight - bestLeft;
+                output[offset + 5] = bestBottom - bestTop;
+                next[bestClass] = classNext + 1;
+                function.Store(numDetectionsVar, numDetections + 1);
+            });
+        });
+        function.Store(pCount, function.Load(numDetectionsVar));
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["width"] << _regionDetectionParams.width;
+        archiver["height"] << _regionDetectionParams.height;
+        archiver["numBoxesPerCell"] << _regionDetectionParams.numBoxesPerCell;
+        archiver["numClasses"] << _regionDetectionParams.numClasses;
+        archiver["numCoordinates"] << _regionDetectionParams.numCoordinates;
+        archiver["confidenceThreshold"] << _postProcessingParams.confidenceThreshold;
+        archiver["nmsThreshold"] << _postProcessingParams.nmsThreshold;
+        archiver["maxDetectionsPerClass"] << _postProcessingParams.maxDetectionsPerClass;
+        archiver["maxDetections"] << _postProcessingParams.maxDetections;
+        archiver["anchorScales"] << _postProcessingParams.anchorScales;
+    }
+
+    template <typename ValueType>
+    void RegionDetectionPostProcessingNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["width"] >> _regionDetectionParams.width;
+        archiver["height"] >> _regionDetectionParams.height;
+        archiver["numBoxesPerCell"] >> _regionDetectionParams.numBoxesPerCell;
+        archiver["numClasses"] >> _regionDetectionParams.numClasses;
+        archiver["numCoordinates"] >> _regionDetectionParams.numCoordinates;
+        archiver["confidenceThreshold"] >> _postProcessingParams.confidenceThreshold;
+        archiver["nmsThreshold"] >> _postProcessingParams.nmsThreshold;
+        archiver["maxDetectionsPerClass"] >> _postProcessingParams.maxDetectionsPerClass;
+        archiver["maxDetections"] >> _postProcessingParams.maxDetections;
+        archiver["anchorScales"] >> _postProcessingParams.anchorScales;
+        SetOutputSizes();
+    }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class RegionDetectionPostProcessingNode<float>;
+    template class RegionDetectionPostProcessingNode<double>;
+} // nodes
+} // ell
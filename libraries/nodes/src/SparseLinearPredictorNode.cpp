@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseLinearPredictorNode.cpp (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseLinearPredictorNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalValue.h"
+
+// utilities
+#include "Exception.h"
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    SparseLinearPredictorNode<ValueType>::SparseLinearPredictorNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1)
+    {
+    }
+
+    template <typename ValueType>
+    SparseLinearPredictorNode<ValueType>::SparseLinearPredictorNode(const model::PortElements<ValueType>& input, const LinearPredictorType& predictor)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _predictor(predictor)
+    {
+        if (input.Size() != predictor.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "SparseLinearPredictorNode input size must match the predictor size");
+        }
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Compute() const
+    {
+        using DataVectorType = typename LinearPredictorType::DataVectorType;
+        auto inputDataVector = DataVectorType(_input.GetIterator());
+        _output.SetOutput({ _predictor.Predict(inputDataVector) });
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<SparseLinearPredictorNode<ValueType>>(newPortElements, _predictor);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        auto& module = function.GetModule();
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        const auto dimension = _predictor.Size();
+
+        auto pWeights = module.ConstantArray("weights_"s + GetInternalStateIdentifier(), _predictor.GetWeights().ToArray());
+
+        // The dense prediction, for the map's predict function
+        llvm::Value* pInput = compiler.EnsurePortEmitted(input);
+        llvm::Value* pOutput = compiler.EnsurePortEmitted(output);
+        auto weights = function.LocalArray(pWeights);
+        llvm::Value* sumVar = function.Variable(valueType, "sum");
+        function.Store(sumVar, function.Literal(_predictor.GetBias()));
+        function.For(dimension, [&](emitters::IRFunctionEmitter& function, llvm::Value* iVar) {
+            auto i = function.LocalScalar(iVar);
+            auto x = function.LocalScalar(dimension == 1 ? pInput : function.ValueAt(pInput, i));
+            emitters::IRLocalScalar w = weights[i];
+            function.Store(sumVar, function.LocalScalar(function.Load(sumVar)) + w * x);
+        });
+        function.Store(pOutput, function.Load(sumVar));
+
+        // The sparse predictions, as separate functions of the module
+        EmitPredictSparseFunction(compiler, module, pWeights, true);
+        EmitPredictSparseFunction(compiler, module, pWeights, false);
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::EmitPredictSparseFunction(model::IRMapCompiler& compiler, emitters::IRModuleEmitter& module, llvm::GlobalVariable* pWeights, bool hasValues)
+    {
+        const auto valueType = emitters::GetVariableType<ValueType>();
+        const auto dimension = static_cast<int>(_predictor.Size());
+        const auto functionName = compiler.GetNamespacePrefix() + (hasValues ? GetPredictSparseFunctionSuffix() : GetPredictSparseBinaryFunctionSuffix());
+        if (module.HasFunction(functionName))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A map can contain at most one SparseLinearPredictorNode");
+        }
+
+        emitters::NamedVariableTypeList parameters = { { "indices", emitters::VariableType::Int32Pointer } };
+        if (hasValues)
+        {
+            parameters.push_back({ "values", emitters::GetPointerType(valueType) });
+        }
+        parameters.push_back({ "count", emitters::VariableType::Int32 });
+
+        emitters::IRFunctionEmitter function = module.BeginFunction(functionName, valueType, parameters);
+        module.DeclareFunction(functionName, valueType, parameters);
+        function.IncludeInHeader();
+
+        auto arguments = function.Arguments().begin();
+        llvm::Value* pIndices = &(*arguments++);
+        llvm::Value* pValues = hasValues ? &(*arguments++) : nullptr;
+        llvm::Value* count = &(*arguments++);
+
+        // Gather the weights of the given indices
+        llvm::Value* sumVar = function.Variable(valueType, "sum");
+        function.Store(sumVar, function.Literal(_predictor.GetBias()));
+        function.For(count, [&](emitters::IRFunctionEmitter& function, llvm::Value* i) {
+            auto index = function.LocalScalar(function.ValueAt(pIndices, i));
+            function.If(index >= 0 && index < dimension, [&](emitters::IRFunctionEmitter& function) {
+                auto w = function.LocalScalar(function.ValueAt(pWeights, index));
+                auto sum = function.LocalScalar(function.Load(sumVar));
+                function.Store(sumVar, hasValues ? sum + w * function.LocalScalar(function.ValueAt(pValues, i)) : sum + w);
+            });
+        });
+
+        function.Return(function.Load(sumVar));
+        module.EndFunction();
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["predictor"] << _predictor;
+    }
+
+    template <typename ValueType>
+    void SparseLinearPredictorNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["predictor"] >> _predictor;
+    }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class SparseLinearPredictorNode<float>;
+    template class SparseLinearPredictorNode<double>;
+}
+}
@@ -426,25 +426,29 @@ namespace nodes
             const int numTasks = std::min(CeilDiv(primaryInputSize, taskSize), compilerSettings.maxThreads);
             taskSize = CeilDiv(numOuterIterations, numTasks);
 
-            // Ugly type-getting code to get around the type of the emitted port variables being different depending
-            // on whether the node is inlined (or something).
-            emitters::LLVMTypeList taskFunctionArgTypes{ pPrimaryInput->getType() };
+            // The task function indexes its arguments as plain pointers, so ports emitted as global arrays
+            // are passed as pointers to their first element
+            auto getTaskArgument = [&function](llvm::Value* port) -> llvm::Value* {
+                auto global = llvm::dyn_cast<llvm::GlobalVariable>(port);
+                return global != nullptr ? function.PointerOffset(global, 0) : port;
+            };
+            std::vector<llvm::Value*> portArgs{ getTaskArgument(pPrimaryInput) };
             for (auto& secondaryInput : secondaryInputs)
             {
-                taskFunctionArgTypes.push_back(secondaryInput->getType());
+                portArgs.push_back(getTaskArgument(secondaryInput));
             }
-            taskFunctionArgTypes.push_back(pOutput->getType());
+            portArgs.push_back(getTaskArgument(pOutput));
 
-            auto taskFunction = this->GetTaskFunction(compiler, function, taskFunctionArgTypes);
+            auto taskFunction = this->GetTaskFunction(compiler, function, emitters::GetLLVMTypes(portArgs));
             std::vector<std::vector<llvm::Value*>> taskArgs;
             for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
             {
                 auto begin = function.Literal<int>(taskIndex * taskSize);
                 auto end = function.Literal<int>(std::min((taskIndex + 1) * taskSize, numOuterIterations));
 
-                std::vector<llvm::Value*> args{ pPrimaryInput };
-                args.insert(args.end(), secondaryInputs.begin(), secondaryInputs.end());
-                args.insert(args.end(), { pOutput, begin, end });
+                std::vector<llvm::Value*> args = portArgs;
+                args.insert(args.end(), { begin, end });
+                taskArgs.push_back(args);
             }
             auto tasks = function.StartTasks(taskFunction, taskArgs);
             tasks.WaitAll(function);
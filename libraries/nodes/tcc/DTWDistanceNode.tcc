@@ -108,6 +108,8 @@ namespace nodes
 
             _d[index] = bestDist;
             _s[index] = bestStart;
+            dLast = dPrev_i;
+            sLast = sPrev_i;
         }
         assert(bestDist == _d[_prototypeLength]);
         assert(bestStart == _s[_prototypeLength]);
@@ -159,8 +161,10 @@ namespace nodes
         // The prototype (constant)
         emitters::Variable* pVarPrototype = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetPrototypeData());
 
-        // Global variables for the dynamic programming memory
-        emitters::Variable* pVarD = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, _prototypeLength + 1);
+        // Global variables for the dynamic programming memory, initialized the same way as in `Reset`
+        std::vector<ValueType> initialD(_prototypeLength + 1, std::numeric_limits<ValueType>::max());
+        initialD[0] = 0;
+        emitters::Variable* pVarD = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, initialD);
 
         // get global state vars
         llvm::Value* pPrototypeVector = function.GetModule().EnsureEmitted(*pVarPrototype);
@@ -216,6 +220,7 @@ namespace nodes
 
             function.OperationAndUpdate(bestDist, emitters::GetAddForValueType<ValueType>(), function.Load(dist)); // x += dist;
             function.SetValueAt(pD, i, function.Load(bestDist)); // d[i] = x;
+            function.Store(dLast, dPrev_i);
         }
         forLoop.End();
 
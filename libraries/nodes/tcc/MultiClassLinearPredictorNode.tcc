@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassLinearPredictorNode.tcc (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MultiClassLinearPredictorNode.h"
+#include "BinaryOperationNode.h"
+#include "ConstantNode.h"
+#include "MatrixVectorProductNode.h"
+
+// utilities
+#include "Exception.h"
+
+// data
+#include "DenseDataVector.h"
+
+// stl
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ElementType>
+    MultiClassLinearPredictorNode<ElementType>::MultiClassLinearPredictorNode()
+        : Node({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ElementType>
+    MultiClassLinearPredictorNode<ElementType>::MultiClassLinearPredictorNode(const model::PortElements<ElementType>& input, const MultiClassLinearPredictorType& predictor)
+        : Node({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, predictor.NumClasses()), _predictor(predictor)
+    {
+        if (input.Size() != predictor.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "input size doesn't match the predictor size");
+        }
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictorNode<ElementType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["predictor"] << _predictor;
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictorNode<ElementType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["predictor"] >> _predictor;
+        _output.SetSize(_predictor.NumClasses());
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictorNode<ElementType>::Copy(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+        auto newNode = transformer.AddNode<MultiClassLinearPredictorNode>(newPortElements, _predictor);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ElementType>
+    bool MultiClassLinearPredictorNode<ElementType>::Refine(model::ModelTransformer& transformer) const
+    {
+        auto newPortElements = transformer.TransformPortElements(_input.GetPortElements());
+
+        // the weights have one row per input element and one column per class, which is the same memory as a column-major
+        // matrix with one row per class, so the whole predictor is a single matrix-vector product
+        const auto& weights = _predictor.GetWeights();
+        const auto* pWeights = weights.GetConstDataPointer();
+        std::vector<ElementType> weightValues(pWeights, pWeights + weights.Size());
+        math::ColumnMatrix<ElementType> classWeights(_predictor.NumClasses(), _predictor.Size(), std::move(weightValues));
+
+        auto productNode = transformer.AddNode<MatrixVectorProductNode<ElementType, math::MatrixLayout::columnMajor>>(newPortElements, classWeights);
+        auto biasNode = transformer.AddNode<ConstantNode<ElementType>>(_predictor.GetBias().ToArray());
+        auto addNode = transformer.AddNode<BinaryOperationNode<ElementType>>(productNode->output, biasNode->output, emitters::BinaryOperationType::add);
+
+        transformer.MapNodeOutput(output, addNode->output);
+        return true;
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictorNode<ElementType>::Compute() const
+    {
+        using DataVectorType = typename MultiClassLinearPredictorType::DataVectorType;
+        auto inputDataVector = DataVectorType(_input.GetIterator());
+        _output.SetOutput(_predictor.Predict(inputDataVector).ToArray());
+    }
+
+    template <typename ElementType>
+    MultiClassLinearPredictorNode<ElementType>* AddNodeToModelTransformer(const model::PortElements<ElementType>& input, const predictors::MultiClassLinearPredictor<ElementType>& predictor, model::ModelTransformer& transformer)
+    {
+        return transformer.AddNode<MultiClassLinearPredictorNode<ElementType>>(input, predictor);
+    }
+}
+}
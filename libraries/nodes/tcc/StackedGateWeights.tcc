@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StackedGateWeights.tcc (nodes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// emitters
+#include "IRLocalValueOperations.h"
+
+// utilities
+#include "Exception.h"
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        template <typename ValueType>
+        size_t GetGateHiddenSize(const std::vector<math::ConstRowMatrixReference<ValueType>>& gateWeights, size_t inputSize)
+        {
+            if (gateWeights.empty())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "recurrent layer must have at least one gate");
+            }
+
+            auto hiddenSize = gateWeights[0].NumRows();
+            for (const auto& weights : gateWeights)
+            {
+                if (weights.NumRows() != hiddenSize || weights.NumColumns() != inputSize + hiddenSize)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "gate weights must be hiddenSize x (inputSize + hiddenSize) matrices");
+                }
+            }
+            return hiddenSize;
+        }
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> StackGateInputWeights(const std::vector<math::ConstRowMatrixReference<ValueType>>& gateWeights, size_t inputSize)
+    {
+        const auto hiddenSize = GetGateHiddenSize(gateWeights, inputSize);
+        const auto gatesSize = gateWeights.size() * hiddenSize;
+
+        std::vector<ValueType> result(inputSize * gatesSize);
+        for (size_t gate = 0; gate < gateWeights.size(); ++gate)
+        {
+            for (size_t row = 0; row < hiddenSize; ++row)
+            {
+                for (size_t column = 0; column < inputSize; ++column)
+                {
+                    result[column * gatesSize + gate * hiddenSize + row] = gateWeights[gate](row, column);
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> StackGateRecurrentWeights(const std::vector<math::ConstRowMatrixReference<ValueType>>& gateWeights, size_t inputSize)
+    {
+        const auto hiddenSize = GetGateHiddenSize(gateWeights, inputSize);
+
+        std::vector<ValueType> result;
+        result.reserve(gateWeights.size() * hiddenSize * hiddenSize);
+        for (const auto& weights : gateWeights)
+        {
+            for (size_t row = 0; row < hiddenSize; ++row)
+            {
+                for (size_t column = 0; column < hiddenSize; ++column)
+                {
+                    result.push_back(weights(row, inputSize + column));
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> StackGateBiases(const std::vector<math::ConstColumnVectorReference<ValueType>>& gateBiases)
+    {
+        std::vector<ValueType> result;
+        for (const auto& bias : gateBiases)
+        {
+            for (size_t index = 0; index < bias.Size(); ++index)
+            {
+                result.push_back(bias[index]);
+            }
+        }
+        return result;
+    }
+
+    inline model::PortMemoryLayout GetWindowMemoryLayout(const model::PortMemoryLayout& timestepLayout, size_t numTimesteps)
+    {
+        model::Shape size = { static_cast<int>(numTimesteps) };
+        model::Shape stride = { static_cast<int>(numTimesteps) };
+        model::Shape offset = { 0 };
+        size.insert(size.end(), timestepLayout.GetActiveSize().begin(), timestepLayout.GetActiveSize().end());
+        stride.insert(stride.end(), timestepLayout.GetStride().begin(), timestepLayout.GetStride().end());
+        offset.insert(offset.end(), timestepLayout.GetOffset().begin(), timestepLayout.GetOffset().end());
+        return { size, stride, offset };
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> GetActiveEntries(const std::vector<ValueType>& data, const model::PortMemoryLayout& layout)
+    {
+        const auto numDimensions = layout.NumDimensions();
+        const auto numEntries = layout.NumEntries();
+        std::vector<ValueType> result;
+        result.reserve(numEntries);
+
+        // Walk the active region in row-major order
+        model::Shape location(numDimensions, 0);
+        for (size_t entry = 0; entry < numEntries; ++entry)
+        {
+            result.push_back(data[layout.GetEntryOffset(location)]);
+            for (int dimension = static_cast<int>(numDimensions) - 1; dimension >= 0; --dimension)
+            {
+                if (++location[dimension] < layout.GetActiveSize(dimension))
+                {
+                    break;
+                }
+                location[dimension] = 0;
+            }
+        }
+        return result;
+    }
+
+    template <typename ValueType>
+    llvm::Value* EmitActiveEntries(emitters::IRFunctionEmitter& function, llvm::Value* data, const model::PortMemoryLayout& layout)
+    {
+        const int numEntries = static_cast<int>(layout.NumEntries());
+        if (numEntries == static_cast<int>(layout.GetMemorySize()))
+        {
+            return data;
+        }
+
+        const int numDimensions = static_cast<int>(layout.NumDimensions());
+        llvm::Value* result = function.Variable(emitters::GetVariableType<ValueType>(), numEntries);
+        auto input = function.LocalArray(data);
+        auto output = function.LocalArray(result);
+        function.For(numEntries, [=](emitters::IRFunctionEmitter& function, llvm::Value* entryIndex) {
+            // Turn the logical index of the entry into a location in the active region
+            auto remainder = function.LocalScalar(entryIndex);
+            std::vector<llvm::Value*> location(numDimensions);
+            for (int dimension = numDimensions - 1; dimension >= 0; --dimension)
+            {
+                const int size = layout.GetActiveSize(dimension);
+                location[dimension] = remainder % size;
+                remainder = remainder / size;
+            }
+            output[entryIndex] = input[layout.EmitGetEntryOffset(function, location)];
+        });
+        return result;
+    }
+}
+}
@@ -28,6 +28,7 @@
 
 // nodes
 #include "BufferNode.h"
+#include "DTWBankNode.h"
 #include "DTWDistanceNode.h"
 #include "DelayNode.h"
 #include "DiagonalConvolutionNode.h"
@@ -50,10 +51,13 @@
 // utilities
 #include "Exception.h"
 #include "RandomEngines.h"
+#include "TypeName.h"
 
 // stl
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -236,6 +240,169 @@ static void TestDTWDistanceNodeCompute()
     }
 }
 
+template <typename ValueType>
+static void TestDTWDistanceNode()
+{
+    using namespace std::string_literals;
+    const double epsilon = 1e-4;
+    std::vector<std::vector<ValueType>> prototype;
+    for (const auto& entry : GetNextSlidePrototype())
+    {
+        prototype.emplace_back(entry.begin(), entry.end());
+    }
+    const auto dimension = prototype[0].size();
+    const auto prototypeLength = prototype.size();
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dimension);
+    auto dtwNode = model.AddNode<nodes::DTWDistanceNode<ValueType>>(inputNode->output, prototype);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dtwNode->output } });
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+
+    // The reference is the textbook open-begin DTW recurrence, d(t, i) = |x(t) - p(i)| + min(d(t, i-1), d(t-1, i), d(t-1, i-1)),
+    // normalized by the variance of the prototype
+    double mean = 0;
+    for (const auto& entry : prototype)
+    {
+        mean += std::accumulate(entry.begin(), entry.end(), 0.0);
+    }
+    mean /= prototypeLength * dimension;
+    double variance = 0;
+    for (const auto& entry : prototype)
+    {
+        for (auto x : entry)
+        {
+            variance += (x - mean) * (x - mean);
+        }
+    }
+    variance /= prototypeLength * dimension;
+    std::vector<double> previousRow(prototypeLength + 1, std::numeric_limits<double>::max());
+    previousRow[0] = 0;
+
+    // Play the prototype at a varying speed
+    bool computeOk = true;
+    bool compileOk = true;
+    const size_t numSamples = 200;
+    for (size_t index = 0; index < numSamples; ++index)
+    {
+        auto input = prototype[((index * (2 + index / 50)) / 2) % prototypeLength];
+        std::vector<double> row(prototypeLength + 1, 0.0);
+        for (size_t i = 1; i <= prototypeLength; ++i)
+        {
+            double distance = 0;
+            for (size_t j = 0; j < dimension; ++j)
+            {
+                distance += std::abs(static_cast<double>(input[j]) - prototype[i - 1][j]);
+            }
+            row[i] = distance + std::min({ row[i - 1], previousRow[i], previousRow[i - 1] });
+        }
+        previousRow = row;
+        auto expected = row[prototypeLength] / variance;
+
+        map.SetInputValue(0, input);
+        compiledMap.SetInputValue(0, input);
+        auto computed = map.ComputeOutput<ValueType>(0)[0];
+        auto compiled = compiledMap.ComputeOutput<ValueType>(0)[0];
+        computeOk = computeOk && std::abs(computed - expected) <= epsilon * std::max(1.0, expected);
+        compileOk = compileOk && std::abs(compiled - expected) <= epsilon * std::max(1.0, expected);
+    }
+
+    testing::ProcessTest("Testing DTWDistanceNode<"s + utilities::TypeName<ValueType>::GetName() + "> compute", computeOk);
+    testing::ProcessTest("Testing DTWDistanceNode<"s + utilities::TypeName<ValueType>::GetName() + "> compile", compileOk);
+}
+
+template <typename ValueType>
+static std::vector<std::vector<std::vector<ValueType>>> GetDTWBankPrototypes()
+{
+    // The next-slide prototype, a subsampled version of it, and a reversed version of its first half
+    auto prototype = GetNextSlidePrototype();
+    std::vector<std::vector<std::vector<ValueType>>> prototypes(3);
+    for (size_t index = 0; index < prototype.size(); ++index)
+    {
+        std::vector<ValueType> entry(prototype[index].begin(), prototype[index].end());
+        prototypes[0].push_back(entry);
+        if (index % 2 == 0)
+        {
+            prototypes[1].push_back(entry);
+        }
+        if (index < prototype.size() / 2)
+        {
+            prototypes[2].insert(prototypes[2].begin(), entry);
+        }
+    }
+    return prototypes;
+}
+
+template <typename ValueType>
+static void TestDTWBankNode(size_t bandWidth, double abandonThreshold)
+{
+    using namespace std::string_literals;
+    const double epsilon = 1e-4;
+    const auto maxValue = std::numeric_limits<ValueType>::max();
+    auto prototypes = GetDTWBankPrototypes<ValueType>();
+    const auto dimension = prototypes[0][0].size();
+    const nodes::DTWBankParameters parameters{ bandWidth, abandonThreshold };
+
+    // One map for each output of the bank node, and a model with one DTWDistanceNode per prototype for reference
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dimension);
+    auto bankNode = model.AddNode<nodes::DTWBankNode<ValueType>>(inputNode->output, prototypes, parameters);
+    auto distancesMap = model::Map(model, { { "input", inputNode } }, { { "output", bankNode->output } });
+    auto argMinMap = model::Map(model, { { "input", inputNode } }, { { "output", bankNode->argMin } });
+
+    model::Model referenceModel;
+    auto referenceInputNode = referenceModel.AddNode<model::InputNode<ValueType>>(dimension);
+    model::PortElements<ValueType> referenceOutputs;
+    for (const auto& prototype : prototypes)
+    {
+        auto dtwNode = referenceModel.AddNode<nodes::DTWDistanceNode<ValueType>>(referenceInputNode->output, prototype);
+        referenceOutputs.Append(dtwNode->output);
+    }
+
+    model::IRMapCompiler compiler;
+    auto compiledDistancesMap = compiler.Compile(distancesMap);
+    auto compiledArgMinMap = compiler.Compile(argMinMap);
+
+    // Play the first prototype at a varying speed
+    bool computeOk = true;
+    bool compileOk = true;
+    const size_t numSamples = 200;
+    for (size_t index = 0; index < numSamples; ++index)
+    {
+        auto sampleIndex = ((index * (2 + index / 50)) / 2) % prototypes[0].size();
+        auto input = prototypes[0][sampleIndex];
+
+        distancesMap.SetInputValue(0, input);
+        argMinMap.SetInputValue(0, input);
+        compiledDistancesMap.SetInputValue(0, input);
+        compiledArgMinMap.SetInputValue(0, input);
+        referenceInputNode->SetInput(input);
+
+        auto distances = distancesMap.ComputeOutput<ValueType>(0);
+        auto argMin = argMinMap.ComputeOutput<int>(0);
+        auto compiledDistances = compiledDistancesMap.ComputeOutput<ValueType>(0);
+        auto compiledArgMin = compiledArgMinMap.ComputeOutput<int>(0);
+        auto referenceDistances = referenceModel.ComputeOutput(referenceOutputs);
+
+        compileOk = compileOk && testing::IsEqual(distances, compiledDistances, static_cast<ValueType>(epsilon)) && argMin == compiledArgMin;
+        for (size_t k = 0; k < distances.size(); ++k)
+        {
+            // Without constraints the distances are the same as the reference's, and constraints can only make a
+            // distance unreachable
+            auto isReferenceDistance = std::abs(distances[k] - referenceDistances[k]) <= epsilon * std::max<ValueType>(1, std::abs(referenceDistances[k]));
+            auto isConstrained = bandWidth > 0 || abandonThreshold > 0;
+            computeOk = computeOk && (isReferenceDistance || (isConstrained && distances[k] == maxValue));
+        }
+        auto minElement = std::min_element(distances.begin(), distances.end());
+        computeOk = computeOk && argMin[0] == static_cast<int>(minElement - distances.begin());
+    }
+
+    auto parametersName = "(bandWidth = "s + std::to_string(bandWidth) + ", abandonThreshold = " + std::to_string(abandonThreshold) + ")";
+    testing::ProcessTest("Testing DTWBankNode<"s + utilities::TypeName<ValueType>::GetName() + "> compute " + parametersName, computeOk);
+    testing::ProcessTest("Testing DTWBankNode<"s + utilities::TypeName<ValueType>::GetName() + "> compile " + parametersName, compileOk);
+}
+
 //
 // Combined tests
 //
@@ -662,6 +829,15 @@ void TestDSPNodes()
 
     TestBufferNode<float>();
 
+    TestDTWDistanceNode<double>();
+    TestDTWDistanceNode<float>();
+
+    TestDTWBankNode<double>(0, 0);
+    TestDTWBankNode<float>(0, 0);
+    TestDTWBankNode<double>(4, 0);
+    TestDTWBankNode<double>(0, 2);
+    TestDTWBankNode<float>(4, 2);
+
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::simple);
     // TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::diagonal); // ERROR: diagonal test currently broken
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::unrolled);
@@ -23,7 +23,10 @@
 #include "Node.h"
 
 // nodes
+#include "DTWBankNode.h"
+#include "DTWDistanceNode.h"
 #include "DiagonalConvolutionNode.h"
+#include "ExtremalValueNode.h"
 #include "SimpleConvolutionNode.h"
 #include "UnrolledConvolutionNode.h"
 #include "WinogradConvolutionNode.h"
@@ -40,9 +43,11 @@
 #include "RandomEngines.h"
 
 // stl
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -242,11 +247,83 @@ static void TimeConvolutionNode(int inputRows, int inputColumns, int numChannels
     std::cout << "Total time for " << numIterations << " iterations of " << inputRows << " x " << inputColumns << " x " << numChannels << " -> " << numFilters << " " << algName << " convolutions: " << compiledTime << " ms\t" << "(reference: " << referenceTime << " ms)\n";
 }
 
+template <typename ValueType>
+static void TimeDTWBankNode(int numPrototypes, int prototypeLength, int sampleDimension, int numSamples, const nodes::DTWBankParameters& parameters)
+{
+    auto randomEngine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<ValueType> uniform(-1, 1);
+    auto fillRandom = [&randomEngine, &uniform](std::vector<ValueType>& vector) {
+        std::generate(vector.begin(), vector.end(), [&randomEngine, &uniform]() { return uniform(randomEngine); });
+    };
+
+    std::vector<std::vector<std::vector<ValueType>>> prototypes(numPrototypes, std::vector<std::vector<ValueType>>(prototypeLength, std::vector<ValueType>(sampleDimension)));
+    for (auto& prototype : prototypes)
+    {
+        for (auto& entry : prototype)
+        {
+            fillRandom(entry);
+        }
+    }
+    std::vector<std::vector<ValueType>> signal(numSamples, std::vector<ValueType>(sampleDimension));
+    for (auto& sample : signal)
+    {
+        fillRandom(sample);
+    }
+
+    // A bank node vs. one DTWDistanceNode per prototype, both followed by an argmin
+    model::Model bankModel;
+    auto bankInputNode = bankModel.AddNode<model::InputNode<ValueType>>(sampleDimension);
+    auto bankNode = bankModel.AddNode<nodes::DTWBankNode<ValueType>>(bankInputNode->output, prototypes, parameters);
+    auto bankMap = model::Map(bankModel, { { "input", bankInputNode } }, { { "output", bankNode->argMin } });
+
+    model::Model separateModel;
+    auto separateInputNode = separateModel.AddNode<model::InputNode<ValueType>>(sampleDimension);
+    model::PortElements<ValueType> distances;
+    for (const auto& prototype : prototypes)
+    {
+        auto dtwNode = separateModel.AddNode<nodes::DTWDistanceNode<ValueType>>(separateInputNode->output, prototype);
+        distances.Append(dtwNode->output);
+    }
+    auto argMinNode = separateModel.AddNode<nodes::ArgMinNode<ValueType>>(distances);
+    auto separateMap = model::Map(separateModel, { { "input", separateInputNode } }, { { "output", argMinNode->argVal } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    model::IRMapCompiler bankCompiler(settings);
+    auto compiledBankMap = bankCompiler.Compile(bankMap);
+    model::IRMapCompiler separateCompiler(settings);
+    auto compiledSeparateMap = separateCompiler.Compile(separateMap);
+
+    auto timeMap = [&signal](model::IRCompiledMap& compiledMap) {
+        utilities::MillisecondTimer timer;
+        for (const auto& sample : signal)
+        {
+            compiledMap.SetInputValue(0, sample);
+            volatile auto result = compiledMap.ComputeOutput<int>(0);
+        }
+        return timer.Elapsed();
+    };
+    auto bankTime = timeMap(compiledBankMap);
+    auto separateTime = timeMap(compiledSeparateMap);
+
+    std::cout << "Total time for " << numSamples << " samples of DTW against " << numPrototypes << " prototypes of length " << prototypeLength << " x " << sampleDimension;
+    std::cout << " (bandWidth " << parameters.bandWidth << ", abandonThreshold " << parameters.abandonThreshold << "): " << bankTime << " ms\t(separate nodes: " << separateTime << " ms)\n";
+}
+
 //
 // Main driver function to call all the timing functions
 //
 void TimeDSPNodes()
 {
+    //
+    // DTW prototype bank vs. separate DTW nodes
+    //
+    TimeDTWBankNode<float>(16, 64, 3, 10000, {});
+    TimeDTWBankNode<float>(16, 64, 3, 10000, { 8, 0 });
+    TimeDTWBankNode<float>(64, 64, 3, 10000, {});
+    TimeDTWBankNode<float>(64, 64, 3, 10000, { 8, 1 });
+    std::cout << std::endl;
+
     //
     // Timings on jitted models 
     //
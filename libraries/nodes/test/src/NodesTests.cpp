@@ -817,7 +817,7 @@ static void TestProtoNNPredictorNode()
 
     inputNode->SetInput(input);
 
-    auto protonnPredictorNode = model.AddNode<nodes::ProtoNNPredictorNode>(inputNode->output, protonnPredictor);
+    auto protonnPredictorNode = model.AddNode<nodes::ProtoNNPredictorNode<double>>(inputNode->output, protonnPredictor);
 
     model::TransformContext context;
     model::ModelTransformer transformer;
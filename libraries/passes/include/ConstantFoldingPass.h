@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConstantFoldingPass.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Model.h"
+
+// model/optimizer
+#include "ModelOptimizer.h"
+#include "OptimizationPass.h"
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that evaluates pure nodes whose inputs are all constant at compile time, and replaces
+    /// them with `ConstantNode`s holding the result. The constant inputs are left for `DeadNodeEliminationPass` to remove.
+    /// </summary>
+    class ConstantFoldingPass : public model::OptimizationPass
+    {
+    public:
+        /// <summary> Run this pass. </summary>
+        ///
+        /// <param name="model"> The model being optimized. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        model::Model Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+}
+}
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DeadNodeEliminationPass.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Model.h"
+
+// model/optimizer
+#include "ModelOptimizer.h"
+#include "OptimizationPass.h"
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that removes nodes that don't contribute to any of the model's outputs. The outputs are
+    /// the elements marked on the optimizer context (e.g., a map's outputs), plus any output, sink, and debug sink nodes.
+    /// Input nodes are always kept.
+    /// </summary>
+    class DeadNodeEliminationPass : public model::OptimizationPass
+    {
+    public:
+        /// <summary> Run this pass. </summary>
+        ///
+        /// <param name="model"> The model being optimized. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        model::Model Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+}
+}
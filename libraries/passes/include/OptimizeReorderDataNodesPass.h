@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OptimizeReorderDataNodesPass.h (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Model.h"
+
+// model/optimizer
+#include "ModelOptimizer.h"
+#include "OptimizationPass.h"
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that removes redundant `ReorderDataNode` copies. Chains of reorders whose intermediate
+    /// results aren't used elsewhere are fused into a single reorder straight from the source layout to the final
+    /// layout, and reorders that don't change the layout or order of unpadded data are removed entirely.
+    ///
+    /// This pass doesn't choose layouts for the layer nodes: it keeps the input and output memory layouts each layer
+    /// node was built with, and it doesn't fuse reorders into the kernels of neighbouring layers.
+    /// </summary>
+    class OptimizeReorderDataNodesPass : public model::OptimizationPass
+    {
+    public:
+        /// <summary> Run this pass. </summary>
+        ///
+        /// <param name="model"> The model being optimized. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        model::Model Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Gets the number of bytes written by the `ReorderDataNode`s in a model during one evaluation. </summary>
+        ///
+        /// <param name="model"> The model to examine. </param>
+        ///
+        /// <returns> The total size, in bytes, of the outputs of all the reorder nodes in the model. </returns>
+        static size_t GetNumBytesReordered(const model::Model& model);
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+}
+}
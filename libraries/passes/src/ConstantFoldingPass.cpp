@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConstantFoldingPass.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConstantFoldingPass.h"
+
+// model
+#include "ModelTransformer.h"
+#include "OptimizationPassRegistry.h"
+#include "OutputPort.h"
+
+// nodes
+#include "ConstantNode.h"
+
+// utilities
+#include "Exception.h"
+#include "Logger.h"
+
+// stl
+#include <unordered_set>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    namespace
+    {
+        template <typename ValueType>
+        bool IsConstantNodeOfType(const model::Node& node)
+        {
+            return dynamic_cast<const nodes::ConstantNode<ValueType>*>(&node) != nullptr;
+        }
+
+        bool IsConstantNode(const model::Node& node)
+        {
+            return IsConstantNodeOfType<bool>(node) || IsConstantNodeOfType<int>(node) || IsConstantNodeOfType<int64_t>(node) || IsConstantNodeOfType<float>(node) || IsConstantNodeOfType<double>(node);
+        }
+
+        // returns 'true' if we handled the port, else 'false'. If we return 'false', keep trying other ValueTypes
+        template <typename ValueType>
+        bool TryReplaceWithConstant(const model::OutputPortBase& port, model::ModelTransformer& transformer)
+        {
+            auto typedPort = dynamic_cast<const model::OutputPort<ValueType>*>(&port);
+            if (typedPort == nullptr)
+            {
+                return false;
+            }
+
+            auto constantNode = transformer.AddNode<nodes::ConstantNode<ValueType>>(typedPort->GetOutput());
+            transformer.MapNodeOutput(*typedPort, constantNode->output);
+            return true;
+        }
+
+        void ReplaceWithConstant(const model::OutputPortBase& port, model::ModelTransformer& transformer)
+        {
+            if (TryReplaceWithConstant<bool>(port, transformer) ||
+                TryReplaceWithConstant<int>(port, transformer) ||
+                TryReplaceWithConstant<int64_t>(port, transformer) ||
+                TryReplaceWithConstant<float>(port, transformer) ||
+                TryReplaceWithConstant<double>(port, transformer))
+            {
+                return;
+            }
+
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "Unsupported port type for constant folding");
+        }
+    }
+
+    //
+    // ConstantFoldingPass methods
+    //
+    model::Model ConstantFoldingPass::Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        // The nodes on the original model that have been evaluated. Nodes are visited in dependency order,
+        // so a node's parents have always been considered before the node itself.
+        std::unordered_set<const model::Node*> foldedNodes;
+
+        auto isFoldable = [&foldedNodes](const model::Node& node) {
+            if (!node.IsPure() || node.NumInputPorts() == 0)
+            {
+                return false;
+            }
+
+            for (auto parent : node.GetParentNodes())
+            {
+                if (foldedNodes.find(parent) == foldedNodes.end() && !IsConstantNode(*parent))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        model::TransformContext transformContext;
+        auto result = context.GetTransformer().TransformModel(model, transformContext, [&foldedNodes, &isFoldable](const model::Node& node, model::ModelTransformer& transformer) {
+            if (!isFoldable(node))
+            {
+                node.Copy(transformer);
+                return;
+            }
+
+            // Make sure all the constant inputs have their values, then evaluate the node itself
+            for (auto parent : node.GetParentNodes())
+            {
+                if (foldedNodes.find(parent) == foldedNodes.end())
+                {
+                    parent->Compute();
+                }
+            }
+            node.Compute();
+
+            for (auto port : node.GetOutputPorts())
+            {
+                ReplaceWithConstant(*port, transformer);
+            }
+            foldedNodes.insert(&node);
+        });
+
+        // Each output of a folded node becomes a new constant node, so count the nodes that were actually removed
+        auto numEliminated = model.Size() > result.Size() ? model.Size() - result.Size() : 0;
+        if (!foldedNodes.empty())
+        {
+            Log() << "ConstantFoldingPass: folded " << foldedNodes.size() << " nodes, removed " << numEliminated << " nodes" << EOL;
+        }
+        context.AddNodesEliminated(numEliminated);
+        return result;
+    }
+
+    void ConstantFoldingPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "ConstantFoldingPass",
+            [](const model::ModelOptimizerOptions& settings) { return settings.foldConstantNodes; },
+            []() { return std::make_unique<ConstantFoldingPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+}
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DeadNodeEliminationPass.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DeadNodeEliminationPass.h"
+
+// model
+#include "InputNodeBase.h"
+#include "ModelTransformer.h"
+#include "OptimizationPassRegistry.h"
+#include "OutputNodeBase.h"
+#include "PortElements.h"
+
+// utilities
+#include "Logger.h"
+
+// stl
+#include <unordered_set>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    namespace
+    {
+        bool IsRootNode(const model::Node& node)
+        {
+            return dynamic_cast<const model::InputNodeBase*>(&node) != nullptr ||
+                   dynamic_cast<const model::OutputNodeBase*>(&node) != nullptr ||
+                   node.HasSideEffects();
+        }
+
+        std::vector<const model::Node*> GetRootNodes(const model::Model& model, model::ModelOptimizerContext& context)
+        {
+            std::vector<const model::Node*> roots;
+            for (const auto& outputs : context.GetOutputs())
+            {
+                auto currentOutputs = context.GetCorrespondingOutputs(outputs);
+                for (const auto& range : currentOutputs.GetRanges())
+                {
+                    roots.push_back(range.ReferencedPort()->GetNode());
+                }
+            }
+
+            model.Visit([&roots](const model::Node& node) {
+                if (IsRootNode(node))
+                {
+                    roots.push_back(&node);
+                }
+            });
+            return roots;
+        }
+    }
+
+    //
+    // DeadNodeEliminationPass methods
+    //
+    model::Model DeadNodeEliminationPass::Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        std::unordered_set<const model::Node*> liveNodes;
+        auto roots = GetRootNodes(model, context);
+        if (roots.empty())
+        {
+            // Nothing tells us what the model computes, so everything is potentially live
+            model.Visit([&liveNodes](const model::Node& node) { liveNodes.insert(&node); });
+        }
+        else
+        {
+            model.VisitSubset(roots, [&liveNodes](const model::Node& node) { liveNodes.insert(&node); });
+        }
+
+        model::TransformContext transformContext;
+        auto result = context.GetTransformer().TransformModel(model, transformContext, [&liveNodes](const model::Node& node, model::ModelTransformer& transformer) {
+            if (liveNodes.find(&node) != liveNodes.end())
+            {
+                node.Copy(transformer);
+            }
+        });
+
+        auto numEliminated = model.Size() - liveNodes.size();
+        if (numEliminated > 0)
+        {
+            Log() << "DeadNodeEliminationPass: removed " << numEliminated << " nodes" << EOL;
+        }
+        context.AddNodesEliminated(numEliminated);
+        return result;
+    }
+
+    void DeadNodeEliminationPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "DeadNodeEliminationPass",
+            [](const model::ModelOptimizerOptions& settings) { return true; },
+            []() { return std::make_unique<DeadNodeEliminationPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+}
+}
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OptimizeReorderDataNodesPass.cpp (passes)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OptimizeReorderDataNodesPass.h"
+
+// model
+#include "ModelTransformer.h"
+#include "OptimizationPassRegistry.h"
+#include "PortElements.h"
+#include "PortMemoryLayout.h"
+
+// nodes
+#include "ReorderDataNode.h"
+
+// utilities
+#include "Logger.h"
+
+// stl
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+
+    //
+    // Implementation
+    //
+    namespace
+    {
+        // The data a (possibly fused) reorder node reads from, in terms of the original model
+        template <typename ValueType>
+        struct ReorderSource
+        {
+            model::PortElements<ValueType> input;
+            model::PortMemoryLayout inputLayout;
+            std::vector<int> order;
+        };
+
+        template <typename ValueType>
+        using ReorderSourceMap = std::unordered_map<const model::Node*, ReorderSource<ValueType>>;
+
+        std::vector<int> GetOrder(const std::vector<int>& order, size_t numDimensions)
+        {
+            if (!order.empty())
+            {
+                return order;
+            }
+
+            std::vector<int> identity(numDimensions);
+            for (size_t index = 0; index < numDimensions; ++index)
+            {
+                identity[index] = static_cast<int>(index);
+            }
+            return identity;
+        }
+
+        // Output dimension `i` of a reorder node is read from input dimension `order[i]`, so reading through
+        // two reorders gives output dimension `i` from source dimension `firstOrder[secondOrder[i]]`
+        std::vector<int> ComposeOrders(const std::vector<int>& firstOrder, const std::vector<int>& secondOrder)
+        {
+            std::vector<int> result(secondOrder.size());
+            for (size_t index = 0; index < secondOrder.size(); ++index)
+            {
+                result[index] = firstOrder[secondOrder[index]];
+            }
+            return result;
+        }
+
+        bool IsIdentityOrder(const std::vector<int>& order)
+        {
+            for (size_t index = 0; index < order.size(); ++index)
+            {
+                if (order[index] != static_cast<int>(index))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool HasPadding(const model::PortMemoryLayout& layout)
+        {
+            return layout.GetMemorySize() != model::NumElements(layout.GetActiveSize());
+        }
+
+        bool IsSameLayout(const model::PortMemoryLayout& a, const model::PortMemoryLayout& b)
+        {
+            return a.GetActiveSize() == b.GetActiveSize() && a.GetStride() == b.GetStride() && a.GetOffset() == b.GetOffset();
+        }
+
+        // A reorder can be removed only if it's a plain copy: if there is padding, the padding value written by
+        // the reorder may differ from what the producer left in its padding, so we keep it
+        bool IsNoOp(const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout, const std::vector<int>& order)
+        {
+            return IsIdentityOrder(order) && IsSameLayout(inputLayout, outputLayout) && !HasPadding(outputLayout);
+        }
+
+        template <typename ValueType>
+        const nodes::ReorderDataNode<ValueType>* GetUpstreamReorderNode(const nodes::ReorderDataNode<ValueType>& node)
+        {
+            auto elements = node.input.GetPortElements();
+            if (!elements.IsFullPortOutput())
+            {
+                return nullptr;
+            }
+            return dynamic_cast<const nodes::ReorderDataNode<ValueType>*>(elements.GetRanges()[0].ReferencedPort()->GetNode());
+        }
+
+        std::unordered_set<const model::Node*> GetOutputNodes(const model::Model& model, model::ModelOptimizerContext& context)
+        {
+            std::unordered_set<const model::Node*> result;
+            for (const auto& outputs : context.GetOutputs())
+            {
+                auto currentOutputs = context.GetCorrespondingOutputs(outputs);
+                for (const auto& range : currentOutputs.GetRanges())
+                {
+                    result.insert(range.ReferencedPort()->GetNode());
+                }
+            }
+            return result;
+        }
+
+        // Returns true if a reorder node's output is used only by a single downstream reorder node, which can read
+        // straight from this node's source instead. The downstream node has to read exactly the active area this node
+        // writes: if it also read this node's padding, or saw the memory with a different shape, then reading through
+        // to the source would land outside the source's active area.
+        template <typename ValueType>
+        bool CanFuseIntoDependent(const nodes::ReorderDataNode<ValueType>& node, const std::unordered_set<const model::Node*>& outputNodes)
+        {
+            if (outputNodes.find(&node) != outputNodes.end())
+            {
+                return false;
+            }
+
+            const auto& dependents = node.GetDependentNodes();
+            if (dependents.size() != 1)
+            {
+                return false;
+            }
+
+            auto dependent = dynamic_cast<const nodes::ReorderDataNode<ValueType>*>(dependents[0]);
+            return dependent != nullptr && GetUpstreamReorderNode(*dependent) == &node && IsSameLayout(node.GetOutputMemoryLayout(), dependent->GetInputMemoryLayout());
+        }
+
+        template <typename ValueType>
+        bool TryOptimizeReorderNode(const model::Node& node, model::ModelTransformer& transformer, const std::unordered_set<const model::Node*>& outputNodes, ReorderSourceMap<ValueType>& fusedNodes)
+        {
+            auto thisNode = dynamic_cast<const nodes::ReorderDataNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& outputLayout = thisNode->GetOutputMemoryLayout();
+            auto order = GetOrder(thisNode->GetDimensionOrder(), outputLayout.NumDimensions());
+            ReorderSource<ValueType> source{ thisNode->input.GetPortElements(), thisNode->GetInputMemoryLayout(), order };
+
+            // If the upstream reorder was deferred, read from its source directly
+            auto upstreamNode = GetUpstreamReorderNode(*thisNode);
+            auto upstreamSource = fusedNodes.find(upstreamNode);
+            if (upstreamNode != nullptr && upstreamSource != fusedNodes.end())
+            {
+                source.input = upstreamSource->second.input;
+                source.inputLayout = upstreamSource->second.inputLayout;
+                source.order = ComposeOrders(upstreamSource->second.order, order);
+            }
+
+            if (CanFuseIntoDependent(*thisNode, outputNodes))
+            {
+                // Defer this node: the downstream reorder will do its work
+                fusedNodes[thisNode] = source;
+                return true;
+            }
+
+            auto newInput = transformer.GetCorrespondingOutputs(source.input);
+            if (IsNoOp(source.inputLayout, outputLayout, source.order))
+            {
+                transformer.MapNodeOutput(thisNode->output, newInput);
+            }
+            else
+            {
+                auto newNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(newInput, source.inputLayout, outputLayout, source.order, thisNode->GetPaddingValue());
+                transformer.MapNodeOutput(thisNode->output, newNode->output);
+            }
+            return true;
+        }
+
+        template <typename ValueType>
+        size_t GetNodeBytesReordered(const model::Node& node)
+        {
+            auto reorderNode = dynamic_cast<const nodes::ReorderDataNode<ValueType>*>(&node);
+            return reorderNode == nullptr ? 0 : reorderNode->GetOutputMemoryLayout().GetMemorySize() * sizeof(ValueType);
+        }
+    }
+
+    //
+    // OptimizeReorderDataNodesPass methods
+    //
+    model::Model OptimizeReorderDataNodesPass::Run(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        auto outputNodes = GetOutputNodes(model, context);
+        ReorderSourceMap<float> fusedFloatNodes;
+        ReorderSourceMap<double> fusedDoubleNodes;
+
+        model::TransformContext transformContext;
+        auto result = context.GetTransformer().TransformModel(model, transformContext, [&](const model::Node& node, model::ModelTransformer& transformer) {
+            if (TryOptimizeReorderNode<float>(node, transformer, outputNodes, fusedFloatNodes) ||
+                TryOptimizeReorderNode<double>(node, transformer, outputNodes, fusedDoubleNodes))
+            {
+                return;
+            }
+            node.Copy(transformer);
+        });
+
+        auto oldBytes = GetNumBytesReordered(model);
+        auto newBytes = GetNumBytesReordered(result);
+        Log() << "OptimizeReorderDataNodesPass: bytes reordered per evaluation: " << oldBytes << " before, " << newBytes << " after" << EOL;
+        context.AddNodesEliminated(model.Size() - result.Size());
+        return result;
+    }
+
+    size_t OptimizeReorderDataNodesPass::GetNumBytesReordered(const model::Model& model)
+    {
+        size_t result = 0;
+        model.Visit([&result](const model::Node& node) {
+            result += GetNodeBytesReordered<float>(node) + GetNodeBytesReordered<double>(node);
+        });
+        return result;
+    }
+
+    void OptimizeReorderDataNodesPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "OptimizeReorderDataNodesPass",
+            [](const model::ModelOptimizerOptions& settings) { return settings.optimizeReorderDataNodes; },
+            []() { return std::make_unique<OptimizeReorderDataNodesPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+}
+}
@@ -6,7 +6,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "ConstantFoldingPass.h"
+#include "DeadNodeEliminationPass.h"
 #include "FuseLinearOperationsPass.h"
+#include "OptimizeReorderDataNodesPass.h"
 #include "SetConvolutionMethodPass.h"
 
 // utilities
@@ -20,6 +23,9 @@ namespace passes
     {
         SetConvolutionMethodPass::AddToRegistry();
         FuseLinearOperationsPass::AddToRegistry();
+        OptimizeReorderDataNodesPass::AddToRegistry();
+        ConstantFoldingPass::AddToRegistry();
+        DeadNodeEliminationPass::AddToRegistry();
     }
 
     void AddFuseOperationsPass(model::ModelOptimizer& optimizer)
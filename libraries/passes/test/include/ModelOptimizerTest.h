@@ -10,3 +10,7 @@
 
 void TestModelOptimizer();
 void TestModelCompilePlusOptimize();
+void TestConstantFoldingAndDeadNodeElimination();
+void TestDeadNodeEliminationKeepsSideEffects();
+void TestOptimizeReorderDataNodes();
+void TestOptimizeReorderDataNodesWithPaddedIntermediate();
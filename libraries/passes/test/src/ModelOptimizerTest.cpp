@@ -17,11 +17,17 @@
 #include "PortMemoryLayout.h"
 
 // nodes
+#include "BinaryOperationNode.h"
 #include "BroadcastFunctionNode.h"
 #include "ConstantNode.h"
+#include "DebugSinkNode.h"
+#include "ReorderDataNode.h"
 
 // passes
+#include "ConstantFoldingPass.h"
+#include "DeadNodeEliminationPass.h"
 #include "FuseLinearOperationsPass.h"
+#include "OptimizeReorderDataNodesPass.h"
 #include "StandardPasses.h"
 
 // testing
@@ -29,6 +35,8 @@
 
 // stl
 #include <iostream>
+#include <numeric>
+#include <string>
 
 using namespace ell;
 
@@ -118,3 +126,149 @@ void TestModelCompilePlusOptimize()
 
     testing::ProcessTest("Testing compiled model optimizer", oldSize == 6 || newSize == 4);
 }
+
+void TestConstantFoldingAndDeadNodeElimination()
+{
+    using ValueType = float;
+
+    // Create a model where part of the computation depends only on constants, and part of it isn't used
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(4);
+    auto constantNode1 = model.AddNode<nodes::ConstantNode<ValueType>>(std::vector<ValueType>{ 1, 2, 3, 4 });
+    auto constantNode2 = model.AddNode<nodes::ConstantNode<ValueType>>(std::vector<ValueType>{ 10, 20, 30, 40 });
+    auto constantSumNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(constantNode1->output, constantNode2->output, emitters::BinaryOperationType::add);
+    auto productNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(inputNode->output, constantSumNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    model.AddNode<nodes::BinaryOperationNode<ValueType>>(inputNode->output, constantNode1->output, emitters::BinaryOperationType::subtract); // unused
+
+    // Make a map from it
+    model::Map map(model, { { "input", inputNode } }, { { "output", productNode->output } });
+    model::Map optimizedMap(map);
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::ConstantFoldingPass>());
+    optimizer.AddPass(std::make_unique<passes::DeadNodeEliminationPass>());
+    model::ModelOptimizerContext context;
+    optimizedMap.Optimize(optimizer, context);
+
+    std::vector<ValueType> input = { 1, -1, 0.5, 2 };
+    map.SetInputValue(0, input);
+    optimizedMap.SetInputValue(0, input);
+    auto expected = map.ComputeOutput<ValueType>(0);
+    auto actual = optimizedMap.ComputeOutput<ValueType>(0);
+
+    // input, folded constant, product
+    testing::ProcessTest("Testing constant folding and dead node elimination model size", optimizedMap.GetModel().Size() == 3);
+    testing::ProcessTest("Testing constant folding and dead node elimination node count", context.GetNumNodesEliminated() == map.GetModel().Size() - optimizedMap.GetModel().Size());
+    testing::ProcessTest("Testing constant folding and dead node elimination output", testing::IsEqual(actual, expected));
+}
+
+void TestDeadNodeEliminationKeepsSideEffects()
+{
+    using ValueType = float;
+
+    // The debug sink's output isn't used, but it calls user code, so it has to stay
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(4);
+    auto sumNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(inputNode->output, inputNode->output, emitters::BinaryOperationType::add);
+    model.AddNode<nodes::DebugSinkNode<ValueType>>(sumNode->output, [](const std::string&, const std::vector<ValueType>&, void*) {}, "sum", nullptr, "DebugSinkTest");
+    model::Map map(model, { { "input", inputNode } }, { { "output", inputNode->output } });
+    auto oldSize = map.GetModel().Size();
+
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::DeadNodeEliminationPass>());
+    model::ModelOptimizerContext context;
+    map.Optimize(optimizer, context);
+
+    testing::ProcessTest("Testing dead node elimination keeps nodes with side effects", map.GetModel().Size() == oldSize && context.GetNumNodesEliminated() == 0);
+}
+
+void TestOptimizeReorderDataNodes()
+{
+    using ValueType = float;
+
+    // Create a model that transposes its input to channel-major order, then back to interleaved and padded
+    model::Model model;
+    int numRows = 2;
+    int numColumns = 3;
+    int numChannels = 4;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(numRows * numColumns * numChannels);
+    model::PortMemoryLayout inputLayout({ numRows, numColumns, numChannels });
+    model::PortMemoryLayout planarLayout({ numChannels, numRows, numColumns });
+    model::PortMemoryLayout interleavedLayout({ numRows, numColumns, numChannels });
+    model::PortMemoryLayout paddedLayout({ numRows, numColumns, numChannels }, { 1, 1, 0 });
+    auto toPlanarNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(inputNode->output, inputLayout, planarLayout, std::vector<int>{ 2, 0, 1 });
+    auto toInterleavedNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(toPlanarNode->output, planarLayout, interleavedLayout, std::vector<int>{ 1, 2, 0 });
+    auto toPaddedNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(toInterleavedNode->output, interleavedLayout, paddedLayout);
+
+    // Make a map from it
+    model::Map map(model, { { "input", inputNode } }, { { "output", toPaddedNode->output } });
+    model::Map optimizedMap(map);
+    auto oldBytes = passes::OptimizeReorderDataNodesPass::GetNumBytesReordered(map.GetModel());
+
+    // Optimize it
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::OptimizeReorderDataNodesPass>());
+    optimizedMap.Optimize(optimizer);
+    auto newBytes = passes::OptimizeReorderDataNodesPass::GetNumBytesReordered(optimizedMap.GetModel());
+
+    std::vector<ValueType> input(numRows * numColumns * numChannels);
+    std::iota(input.begin(), input.end(), 1);
+    map.SetInputValue(0, input);
+    optimizedMap.SetInputValue(0, input);
+    auto expected = map.ComputeOutput<ValueType>(0);
+    auto actual = optimizedMap.ComputeOutput<ValueType>(0);
+
+    // input, fused reorder
+    testing::ProcessTest("Testing reorder data node optimization model size", optimizedMap.GetModel().Size() == 2);
+    testing::ProcessTest("Testing reorder data node optimization bytes copied", newBytes == paddedLayout.GetMemorySize() * sizeof(ValueType) && newBytes < oldBytes);
+    testing::ProcessTest("Testing reorder data node optimization output", testing::IsEqual(actual, expected));
+}
+
+void TestOptimizeReorderDataNodesWithPaddedIntermediate()
+{
+    using ValueType = float;
+
+    int numRows = 2;
+    int numColumns = 3;
+    int numChannels = 4;
+    model::PortMemoryLayout inputLayout({ numRows, numColumns, numChannels });
+    model::PortMemoryLayout paddedLayout({ numRows, numColumns, numChannels }, { 1, 1, 0 });
+    model::PortMemoryLayout wholeMemoryLayout({ numRows + 2, numColumns + 2, numChannels });
+    model::PortMemoryLayout planarLayout({ numChannels, numRows, numColumns });
+    const ValueType paddingValue = 7;
+    std::vector<ValueType> input(numRows * numColumns * numChannels);
+    std::iota(input.begin(), input.end(), 1);
+
+    // Pads the input, then transposes the padded result read with the given layout
+    auto testPaddedIntermediate = [&](const model::PortMemoryLayout& readLayout, const model::PortMemoryLayout& outputLayout, size_t expectedSize, const std::string& name) {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(numRows * numColumns * numChannels);
+        auto toPaddedNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(inputNode->output, inputLayout, paddedLayout, paddingValue);
+        auto transposeNode = model.AddNode<nodes::ReorderDataNode<ValueType>>(toPaddedNode->output, readLayout, outputLayout, std::vector<int>{ 2, 0, 1 });
+
+        model::Map map(model, { { "input", inputNode } }, { { "output", transposeNode->output } });
+        model::Map optimizedMap(map);
+        model::MapCompilerOptions settings;
+        model::ModelOptimizer optimizer(settings);
+        optimizer.AddPass(std::make_unique<passes::OptimizeReorderDataNodesPass>());
+        optimizedMap.Optimize(optimizer);
+
+        map.SetInputValue(0, input);
+        optimizedMap.SetInputValue(0, input);
+        auto expected = map.ComputeOutput<ValueType>(0);
+        auto actual = optimizedMap.ComputeOutput<ValueType>(0);
+        testing::ProcessTest("Testing reorder data node optimization model size, " + name, optimizedMap.GetModel().Size() == expectedSize);
+        testing::ProcessTest("Testing reorder data node optimization output, " + name, testing::IsEqual(actual, expected));
+    };
+
+    // Reading only the active area, the two reorders fuse into one (plus the input node)
+    testPaddedIntermediate(paddedLayout, planarLayout, 2, "reading the active area of a padded intermediate");
+
+    // Reading the padding too, the transpose has to see the padding values, so the padding reorder stays
+    model::PortMemoryLayout wholeMemoryPlanarLayout({ numChannels, numRows + 2, numColumns + 2 });
+    testPaddedIntermediate(wholeMemoryLayout, wholeMemoryPlanarLayout, 3, "reading the padding of a padded intermediate");
+}
@@ -29,6 +29,10 @@ int main()
     {
         TestModelOptimizer();
         TestModelCompilePlusOptimize();
+        TestConstantFoldingAndDeadNodeElimination();
+        TestDeadNodeEliminationKeepsSideEffects();
+        TestOptimizeReorderDataNodes();
+        TestOptimizeReorderDataNodesWithPaddedIntermediate();
     }
     catch (const utilities::Exception& exception)
     {
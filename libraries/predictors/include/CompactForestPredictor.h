@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompactForestPredictor.h (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ForestPredictor.h"
+#include "IPredictor.h"
+
+// data
+#include "DenseDataVector.h"
+
+// math
+#include "Matrix.h"
+
+// stl
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+    /// <summary>
+    /// A frozen, inference-only copy of a SimpleForestPredictor, stored as a struct of flat arrays. The interior nodes of
+    /// each tree are numbered breadth-first, so the top levels of a tree share a few cache lines, and each interior node
+    /// is described by a feature index, a threshold, and the indices of its two children. The constant outputs along each
+    /// root-to-leaf path are summed ahead of time into a single value per leaf. A child index that is negative refers to a
+    /// leaf, and its bitwise complement is the leaf's position in the leaf value array.
+    /// </summary>
+    class CompactForestPredictor : public IPredictor<double>
+    {
+    public:
+        using DataVectorType = data::FloatDataVector;
+
+        /// <summary> Constructs an empty forest, which always outputs zero. </summary>
+        CompactForestPredictor() = default;
+
+        /// <summary> Constructs a compact copy of a forest. </summary>
+        ///
+        /// <param name="forest"> The forest to copy. Every interior node must have exactly two outgoing edges. </param>
+        CompactForestPredictor(const SimpleForestPredictor& forest);
+
+        /// <summary> Returns the number of trees in the forest. </summary>
+        ///
+        /// <returns> The number of trees. </returns>
+        size_t NumTrees() const { return _treeRoots.size(); }
+
+        /// <summary> Returns the number of interior nodes in the forest. </summary>
+        ///
+        /// <returns> The number of interior nodes. </returns>
+        size_t NumInteriorNodes() const { return _featureIndices.size(); }
+
+        /// <summary> Returns the number of leaves in the forest. </summary>
+        ///
+        /// <returns> The number of leaves. </returns>
+        size_t NumLeaves() const { return _leafValues.size(); }
+
+        /// <summary> Returns one plus the largest feature index used by a split rule. </summary>
+        ///
+        /// <returns> The number of features an input needs to have. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Returns the bias term of the forest. </summary>
+        ///
+        /// <returns> The bias. </returns>
+        double GetBias() const { return _bias; }
+
+        /// <summary> Returns the output of the forest for a given input. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const DataVectorType& input) const;
+
+        /// <summary>
+        /// Returns the output of the forest for each row of a matrix. The rows are processed in blocks, and all the rows of
+        /// a block descend each tree together, one level at a time, so that the memory accesses of different rows overlap.
+        /// </summary>
+        ///
+        /// <param name="inputs"> The inputs, one per row. Must have at least NumFeatures() columns. </param>
+        ///
+        /// <returns> The predictions, one per row. </returns>
+        std::vector<double> Predict(math::ConstRowMatrixReference<float> inputs) const;
+
+    private:
+        void PredictBlock(const float* inputs, size_t increment, size_t numRows, double* outputs) const;
+
+        // the split rule and children of each interior node
+        std::vector<uint32_t> _featureIndices;
+        std::vector<float> _thresholds;
+        std::vector<int32_t> _children; // two entries per interior node
+
+        // the sum of the edge outputs along the path to each leaf
+        std::vector<double> _leafValues;
+
+        // the root of each tree, and the number of interior nodes on the longest path from that root
+        std::vector<int32_t> _treeRoots;
+        std::vector<uint32_t> _treeDepths;
+
+        double _bias = 0.0;
+        size_t _numFeatures = 0;
+    };
+}
+}
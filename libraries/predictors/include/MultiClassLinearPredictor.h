@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassLinearPredictor.h (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IPredictor.h"
+
+// math
+#include "Matrix.h"
+#include "Vector.h"
+
+// datasets
+#include "AutoDataVector.h"
+
+// utilities
+#include "IArchivable.h"
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace predictors
+{
+    /// <summary>
+    /// A linear predictor with one output per class. The weights are stored as a matrix with one row per input element
+    /// and one column per class, so the weights that an input element contributes to all the classes are contiguous.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The fundamental type used by this predictor. </typeparam>
+    template <typename ElementType>
+    class MultiClassLinearPredictor : public IPredictor<math::ColumnVector<ElementType>>, public utilities::IArchivable
+    {
+    public:
+        /// <summary> Type of the data vector expected by this predictor type. </summary>
+        using DataVectorType = data::AutoDataVector;
+
+        /// <summary> Default Constructor. </summary>
+        MultiClassLinearPredictor();
+
+        /// <summary> Constructs a zero predictor. </summary>
+        ///
+        /// <param name="inputSize"> The input dimension. </param>
+        /// <param name="numClasses"> The number of classes. </param>
+        MultiClassLinearPredictor(size_t inputSize, size_t numClasses);
+
+        /// <summary> Constructs an instance of MultiClassLinearPredictor. </summary>
+        ///
+        /// <param name="weights"> The weights, with one row per input element and one column per class. </param>
+        /// <param name="bias"> The bias of each class. </param>
+        MultiClassLinearPredictor(math::RowMatrix<ElementType> weights, math::ColumnVector<ElementType> bias);
+
+        /// <summary> Constructs an instance of a MultiClassLinearPredictor from one with a different fundamental type. </summary>
+        ///
+        /// <typeparam name="OtherElementType"> The fundamental type used by the other predictor. </typeparam>
+        /// <param name="other"> The other predictor. </param>
+        template <typename OtherElementType>
+        MultiClassLinearPredictor(const MultiClassLinearPredictor<OtherElementType>& other);
+
+        /// <summary> Returns the weights, with one row per input element and one column per class. </summary>
+        ///
+        /// <returns> The weights matrix. </returns>
+        math::RowMatrix<ElementType>& GetWeights() { return _w; }
+
+        /// <summary> Returns the weights, with one row per input element and one column per class. </summary>
+        ///
+        /// <returns> The weights matrix. </returns>
+        const math::RowMatrix<ElementType>& GetWeights() const { return _w; }
+
+        /// <summary> Returns the bias of each class. </summary>
+        ///
+        /// <returns> The bias vector. </returns>
+        math::ColumnVector<ElementType>& GetBias() { return _b; }
+
+        /// <summary> Returns the bias of each class. </summary>
+        ///
+        /// <returns> The bias vector. </returns>
+        const math::ColumnVector<ElementType>& GetBias() const { return _b; }
+
+        /// <summary> Gets the input dimension of the predictor. </summary>
+        ///
+        /// <returns> The input dimension. </returns>
+        size_t Size() const { return _w.NumRows(); }
+
+        /// <summary> Gets the number of classes. </summary>
+        ///
+        /// <returns> The number of classes. </returns>
+        size_t NumClasses() const { return _b.Size(); }
+
+        /// <summary> Resizes the input dimension of the predictor, keeping the weights of the first input elements. </summary>
+        ///
+        /// <param name="size"> The new input dimension. </param>
+        void Resize(size_t size);
+
+        /// <summary> Returns the output of the predictor for a given example. </summary>
+        ///
+        /// <param name="dataVector"> The data vector. </param>
+        ///
+        /// <returns> The score of each class. </returns>
+        math::ColumnVector<ElementType> Predict(const DataVectorType& dataVector) const;
+
+        /// <summary> Returns the class with the highest score for a given example. </summary>
+        ///
+        /// <param name="dataVector"> The data vector. </param>
+        ///
+        /// <returns> The index of the predicted class. </returns>
+        size_t PredictClass(const DataVectorType& dataVector) const;
+
+        /// <summary> Resets the predictor to zero weights and biases. </summary>
+        void Reset();
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ElementType>("MultiClassLinearPredictor"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        math::RowMatrix<ElementType> _w;
+        math::ColumnVector<ElementType> _b;
+    };
+}
+}
+
+#include "../tcc/MultiClassLinearPredictor.tcc"
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessing.h (neural)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RegionDetectionLayer.h"
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+namespace neural
+{
+    /// <summary> Specifies how the raw output of a region detection network is turned into a list of detections. </summary>
+    struct RegionDetectionPostProcessingParameters
+    {
+        /// <summary> A box is detected as a class only if its objectness times its class probability exceeds this threshold. </summary>
+        double confidenceThreshold = 0.25;
+
+        /// <summary> Of two boxes of the same class whose intersection over union exceeds this threshold, only the more confident one is kept. </summary>
+        double nmsThreshold = 0.45;
+
+        /// <summary> The number of most confident boxes of each class that non-maximum suppression considers. </summary>
+        int maxDetectionsPerClass = 16;
+
+        /// <summary> The capacity of the list of detections. </summary>
+        int maxDetections = 32;
+
+        /// <summary> The width and height of each anchor box, in cells, one pair per box in a cell. If empty, all the anchor
+        /// boxes are one cell wide and one cell high. </summary>
+        std::vector<double> anchorScales;
+    };
+
+    /// <summary> A single detection, with the box given by its center, width and height, as fractions of the image size. </summary>
+    template <typename ElementType>
+    struct RegionDetection
+    {
+        int classIndex;
+        ElementType confidence;
+        ElementType x;
+        ElementType y;
+        ElementType width;
+        ElementType height;
+    };
+
+    /// <summary> The number of values that describe a detection in a list of detections: the class index, the
+    /// confidence, and the box's center x, center y, width and height. </summary>
+    constexpr size_t regionDetectionSize = 6;
+
+    /// <summary>
+    /// Turns the raw input of a region detection layer into a fixed-capacity list of detections, in a single pass. The
+    /// objectness of each box is decoded first, and the box is rejected before its class scores are even decoded if no
+    /// class can pass the confidence threshold. The confident boxes of each class are kept in a sorted list of the
+    /// top-K, and non-maximum suppression is then run within each of these short lists, on structure-of-arrays box
+    /// coordinates. The lists are merged into the list of detections, in decreasing order of confidence.
+    /// </summary>
+    template <typename ElementType>
+    class RegionDetectionPostProcessor
+    {
+    public:
+        /// <summary> Constructor. Throws an exception if the parameters are invalid. </summary>
+        ///
+        /// <param name="regionDetectionParams"> The parameters of the region detection layer. </param>
+        /// <param name="postProcessingParams"> The post-processing parameters. </param>
+        RegionDetectionPostProcessor(const RegionDetectionParameters& regionDetectionParams, const RegionDetectionPostProcessingParameters& postProcessingParams);
+
+        /// <summary> Gets the number of values in the raw region tensor. </summary>
+        ///
+        /// <returns> The size of the input. </returns>
+        size_t GetInputSize() const;
+
+        /// <summary> Gets the number of values in the list of detections, `regionDetectionSize` per detection. </summary>
+        ///
+        /// <returns> The size of the output. </returns>
+        size_t GetOutputSize() const { return static_cast<size_t>(_postProcessingParams.maxDetections) * regionDetectionSize; }
+
+        /// <summary> Computes the list of detections. </summary>
+        ///
+        /// <param name="regions"> The raw region tensor, in row, column, channel order and without padding: the input
+        /// of the region detection layer, before its sigmoid, exp and softmax functions are applied. </param>
+        /// <param name="detections"> The list of detections, of size `GetOutputSize()`. The entries past the number of
+        /// detections have a class index of -1 and zeros elsewhere. </param>
+        ///
+        /// <returns> The number of detections. </returns>
+        size_t Compute(const ElementType* regions, ElementType* detections);
+
+        /// <summary> Gets the parameters of the region detection layer. </summary>
+        ///
+        /// <returns> The region detection parameters. </returns>
+        const RegionDetectionParameters& GetRegionDetectionParameters() const { return _regionDetectionParams; }
+
+        /// <summary> Gets the post-processing parameters. </summary>
+        ///
+        /// <returns> The post-processing parameters. </returns>
+        const RegionDetectionPostProcessingParameters& GetPostProcessingParameters() const { return _postProcessingParams; }
+
+    private:
+        void Insert(int classIndex, ElementType confidence, ElementType left, ElementType top, ElementType right, ElementType bottom);
+
+        RegionDetectionParameters _regionDetectionParams;
+        RegionDetectionPostProcessingParameters _postProcessingParams;
+
+        // the candidates of class c occupy entries [c * maxDetectionsPerClass, (c + 1) * maxDetectionsPerClass), sorted by decreasing confidence
+        std::vector<int> _numCandidates;
+        std::vector<ElementType> _confidence;
+        std::vector<ElementType> _left;
+        std::vector<ElementType> _top;
+        std::vector<ElementType> _right;
+        std::vector<ElementType> _bottom;
+
+        // the position of the next detection of each class while the lists are merged
+        std::vector<int> _next;
+    };
+
+    /// <summary> Unpacks a list of detections. </summary>
+    ///
+    /// <param name="detections"> The list of detections. </param>
+    /// <param name="numDetections"> The number of detections in the list. </param>
+    ///
+    /// <returns> The detections. </returns>
+    template <typename ElementType>
+    std::vector<RegionDetection<ElementType>> GetRegionDetections(const ElementType* detections, size_t numDetections);
+}
+}
+}
+
+#include "../tcc/RegionDetectionPostProcessing.tcc"
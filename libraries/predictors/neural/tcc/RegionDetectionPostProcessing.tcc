@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessing.tcc (neural)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace predictors
+{
+namespace neural
+{
+    template <typename ElementType>
+    RegionDetectionPostProcessor<ElementType>::RegionDetectionPostProcessor(const RegionDetectionParameters& regionDetectionParams, const RegionDetectionPostProcessingParameters& postProcessingParams)
+        : _regionDetectionParams(regionDetectionParams), _postProcessingParams(postProcessingParams)
+    {
+        if (_regionDetectionParams.width <= 0 || _regionDetectionParams.height <= 0 || _regionDetectionParams.numBoxesPerCell <= 0 || _regionDetectionParams.numClasses <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Region detection parameters must be positive");
+        }
+        if (_regionDetectionParams.numCoordinates != 4)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Region detection post-processing requires 4 coordinates per box");
+        }
+        if (_postProcessingParams.confidenceThreshold < 0 || _postProcessingParams.nmsThreshold < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Region detection thresholds must be nonnegative");
+        }
+        if (_postProcessingParams.maxDetectionsPerClass <= 0 || _postProcessingParams.maxDetections <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The number of detections must be positive");
+        }
+        if (!_postProcessingParams.anchorScales.empty() && _postProcessingParams.anchorScales.size() != 2 * static_cast<size_t>(_regionDetectionParams.numBoxesPerCell))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "There must be two anchor scales per box in a cell");
+        }
+
+        auto numEntries = static_cast<size_t>(_regionDetectionParams.numClasses * _postProcessingParams.maxDetectionsPerClass);
+        _numCandidates.resize(_regionDetectionParams.numClasses);
+        _next.resize(_regionDetectionParams.numClasses);
+        _confidence.resize(numEntries);
+        _left.resize(numEntries);
+        _top.resize(numEntries);
+        _right.resize(numEntries);
+        _bottom.resize(numEntries);
+    }
+
+    template <typename ElementType>
+    size_t RegionDetectionPostProcessor<ElementType>::GetInputSize() const
+    {
+        const auto& params = _regionDetectionParams;
+        return static_cast<size_t>(params.width * params.height * params.numBoxesPerCell * (params.numCoordinates + 1 + params.numClasses));
+    }
+
+    template <typename ElementType>
+    size_t RegionDetectionPostProcessor<ElementType>::Compute(const ElementType* regions, ElementType* detections)
+    {
+        // The region detection layer requires the number of rows to equal `width` and the number of columns to equal `height`
+        const int numRows = _regionDetectionParams.width;
+        const int numColumns = _regionDetectionParams.height;
+        const int numBoxes = _regionDetectionParams.numBoxesPerCell;
+        const int numClasses = _regionDetectionParams.numClasses;
+        const int boxStride = _regionDetectionParams.numCoordinates + 1 + numClasses;
+        const int maxDetectionsPerClass = _postProcessingParams.maxDetectionsPerClass;
+        const auto threshold = static_cast<ElementType>(_postProcessingParams.confidenceThreshold);
+        const auto& anchorScales = _postProcessingParams.anchorScales;
+
+        std::fill(_numCandidates.begin(), _numCandidates.end(), 0);
+
+        // Decode the boxes, and keep the most confident ones of each class
+        for (int i = 0; i < numRows; ++i)
+        {
+            for (int j = 0; j < numColumns; ++j)
+            {
+                for (int k = 0; k < numBoxes; ++k)
+                {
+                    const ElementType* box = regions + (i * numColumns + j) * numBoxes * boxStride + k * boxStride;
+                    const ElementType* classScores = box + 5;
+
+                    // The class probabilities are at most 1, so the objectness bounds the confidence of every class
+                    auto objectness = 1 / (1 + std::exp(-box[4]));
+                    if (objectness <= threshold)
+                    {
+                        continue;
+                    }
+
+                    // The most probable class has probability 1 / sum
+                    auto maxScore = *std::max_element(classScores, classScores + numClasses);
+                    ElementType sum = 0;
+                    for (int c = 0; c < numClasses; ++c)
+                    {
+                        sum += std::exp(classScores[c] - maxScore);
+                    }
+                    auto scale = objectness / sum;
+                    if (scale <= threshold)
+                    {
+                        continue;
+                    }
+
+                    auto anchorWidth = anchorScales.empty() ? ElementType{ 1 } : static_cast<ElementType>(anchorScales[2 * k]);
+                    auto anchorHeight = anchorScales.empty() ? ElementType{ 1 } : static_cast<ElementType>(anchorScales[2 * k + 1]);
+                    auto x = (j + 1 / (1 + std::exp(-box[0]))) / numColumns;
+                    auto y = (i + 1 / (1 + std::exp(-box[1]))) / numRows;
+                    auto halfWidth = anchorWidth * std::exp(box[2]) / (2 * numColumns);
+                    auto halfHeight = anchorHeight * std::exp(box[3]) / (2 * numRows);
+                    for (int c = 0; c < numClasses; ++c)
+                    {
+                        auto confidence = scale * std::exp(classScores[c] - maxScore);
+                        if (confidence > threshold)
+                        {
+                            Insert(c, confidence, x - halfWidth, y - halfHeight, x + halfWidth, y + halfHeight);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Non-maximum suppression within each class, which sets the confidence of the suppressed boxes to zero, and
+        // then removes them from the list. The inner loops are branch-free, so that they're vectorized.
+        const auto nmsThreshold = static_cast<ElementType>(_postProcessingParams.nmsThreshold);
+        for (int c = 0; c < numClasses; ++c)
+        {
+            const int begin = c * maxDetectionsPerClass;
+            const int end = begin + _numCandidates[c];
+            for (int a = begin; a < end; ++a)
+            {
+                if (_confidence[a] == 0)
+                {
+                    continue;
+                }
+                auto area = (_right[a] - _left[a]) * (_bottom[a] - _top[a]);
+                for (int b = a + 1; b < end; ++b)
+                {
+                    auto intersectionWidth = std::max(ElementType{ 0 }, std::min(_right[a], _right[b]) - std::max(_left[a], _left[b]));
+                    auto intersectionHeight = std::max(ElementType{ 0 }, std::min(_bottom[a], _bottom[b]) - std::max(_top[a], _top[b]));
+                    auto intersection = intersectionWidth * intersectionHeight;
+                    auto otherArea = (_right[b] - _left[b]) * (_bottom[b] - _top[b]);
+                    auto isSuppressed = intersection > nmsThreshold * (area + otherArea - intersection);
+                    _confidence[b] = isSuppressed ? ElementType{ 0 } : _confidence[b];
+                }
+            }
+
+            int numKept = 0;
+            for (int a = begin; a < end; ++a)
+            {
+                _confidence[begin + numKept] = _confidence[a];
+                _left[begin + numKept] = _left[a];
+                _top[begin + numKept] = _top[a];
+                _right[begin + numKept] = _right[a];
+                _bottom[begin + numKept] = _bottom[a];
+                numKept += _confidence[a] != 0 ? 1 : 0;
+            }
+            _numCandidates[c] = numKept;
+        }
+
+        // Fill the list with the most confident detections that survived, by merging the sorted lists of the classes
+        const int maxDetections = _postProcessingParams.maxDetections;
+        std::fill(_next.begin(), _next.end(), 0);
+        std::fill(detections, detections + GetOutputSize(), ElementType{ 0 });
+        int numDetections = 0;
+        for (; numDetections < maxDetections; ++numDetections)
+        {
+            int bestClass = -1;
+            ElementType bestConfidence = 0;
+            for (int c = 0; c < numClasses; ++c)
+            {
+                auto confidence = _next[c] < _numCandidates[c] ? _confidence[c * maxDetectionsPerClass + _next[c]] : ElementType{ 0 };
+                bestClass = confidence > bestConfidence ? c : bestClass;
+                bestConfidence = confidence > bestConfidence ? confidence : bestConfidence;
+            }
+            if (bestClass < 0)
+            {
+                break;
+            }
+
+            auto best = bestClass * maxDetectionsPerClass + _next[bestClass];
+            auto detection = detections + numDetections * regionDetectionSize;
+            detection[0] = static_cast<ElementType>(bestClass);
+            detection[1] = bestConfidence;
+            detection[2] = (_left[best] + _right[best]) / 2;
+            detection[3] = (_top[best] + _bottom[best]) / 2;
+            detection[4] = _right[best] - _left[best];
+            detection[5] = _bottom[best] - _top[best];
+            ++_next[bestClass];
+        }
+        for (int index = numDetections; index < maxDetections; ++index)
+        {
+            detections[index * regionDetectionSize] = -1;
+        }
+
+        return static_cast<size_t>(numDetections);
+    }
+
+    template <typename ElementType>
+    void RegionDetectionPostProcessor<ElementType>::Insert(int classIndex, ElementType confidence, ElementType left, ElementType top, ElementType right, ElementType bottom)
+    {
+        const int maxDetectionsPerClass = _postProcessingParams.maxDetectionsPerClass;
+        const int begin = classIndex * maxDetectionsPerClass;
+        const int numCandidates = _numCandidates[classIndex];
+
+        // Candidates with equal confidence stay in the order they were found
+        int position = 0;
+        for (int r = 0; r < numCandidates; ++r)
+        {
+            position += confidence <= _confidence[begin + r] ? 1 : 0;
+        }
+        if (position == maxDetectionsPerClass)
+        {
+            return;
+        }
+
+        for (int r = std::min(numCandidates, maxDetectionsPerClass - 1); r > position; --r)
+        {
+            _confidence[begin + r] = _confidence[begin + r - 1];
+            _left[begin + r] = _left[begin + r - 1];
+            _top[begin + r] = _top[begin + r - 1];
+            _right[begin + r] = _right[begin + r - 1];
+            _bottom[begin + r] = _bottom[begin + r - 1];
+        }
+        _confidence[begin + position] = confidence;
+        _left[begin + position] = left;
+        _top[begin + position] = top;
+        _right[begin + position] = right;
+        _bottom[begin + position] = bottom;
+        _numCandidates[classIndex] = std::min(numCandidates + 1, maxDetectionsPerClass);
+    }
+
+    template <typename ElementType>
+    std::vector<RegionDetection<ElementType>> GetRegionDetections(const ElementType* detections, size_t numDetections)
+    {
+        std::vector<RegionDetection<ElementType>> result;
+        result.reserve(numDetections);
+        for (size_t index = 0; index < numDetections; ++index)
+        {
+            auto detection = detections + index * regionDetectionSize;
+            result.push_back({ static_cast<int>(detection[0]), detection[1], detection[2], detection[3], detection[4], detection[5] });
+        }
+        return result;
+    }
+}
+}
+}
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompactForestPredictor.cpp (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompactForestPredictor.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace ell
+{
+namespace predictors
+{
+    namespace
+    {
+        // the number of rows that descend a tree together in the batch Predict
+        const size_t blockSize = 16;
+
+        // returns the largest float that isn't bigger than the threshold, so that for every float value, value > threshold
+        // exactly when value > the returned float
+        float RoundThresholdDown(double threshold)
+        {
+            auto rounded = static_cast<float>(threshold);
+            if (static_cast<double>(rounded) > threshold)
+            {
+                rounded = std::nextafter(rounded, -std::numeric_limits<float>::infinity());
+            }
+            return rounded;
+        }
+
+        struct PendingNode
+        {
+            size_t forestIndex;
+            double pathOutput;
+            uint32_t depth;
+        };
+    }
+
+    CompactForestPredictor::CompactForestPredictor(const SimpleForestPredictor& forest)
+        : _bias(forest.GetBias())
+    {
+        const auto& interiorNodes = forest.GetInteriorNodes();
+        if (interiorNodes.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "forest has too many interior nodes");
+        }
+
+        _featureIndices.reserve(interiorNodes.size());
+        _thresholds.reserve(interiorNodes.size());
+        _children.reserve(2 * interiorNodes.size());
+        _leafValues.reserve(interiorNodes.size() + forest.NumTrees());
+
+        for (auto rootIndex : forest.GetRootIndices())
+        {
+            // number the nodes of the tree breadth-first. A node gets its compact index when it's queued, so the children
+            // of a node are known before the node is written out.
+            _treeRoots.push_back(static_cast<int32_t>(_featureIndices.size()));
+            int32_t nextIndex = _treeRoots.back() + 1;
+            uint32_t depth = 0;
+
+            std::deque<PendingNode> pendingNodes{ { rootIndex, 0.0, 1 } };
+            while (!pendingNodes.empty())
+            {
+                auto node = pendingNodes.front();
+                pendingNodes.pop_front();
+                depth = std::max(depth, node.depth);
+
+                const auto& interiorNode = interiorNodes[node.forestIndex];
+                const auto& edges = interiorNode.GetOutgoingEdges();
+                if (edges.size() != 2)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "every interior node must have two outgoing edges");
+                }
+
+                const auto& splitRule = interiorNode.GetSplitRule();
+                if (splitRule.GetElementIndex() > static_cast<size_t>(std::numeric_limits<uint32_t>::max() - 1))
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "split rule feature index is too big");
+                }
+                _featureIndices.push_back(static_cast<uint32_t>(splitRule.GetElementIndex()));
+                _thresholds.push_back(RoundThresholdDown(splitRule.GetThreshold()));
+                _numFeatures = std::max(_numFeatures, splitRule.GetElementIndex() + 1);
+
+                for (const auto& edge : edges)
+                {
+                    // sum the outputs in the same order as ForestPredictor, so the results are identical
+                    double pathOutput = node.pathOutput + edge.GetPredictor().GetValue();
+                    if (edge.IsTargetInterior())
+                    {
+                        pendingNodes.push_back({ edge.GetTargetNodeIndex(), pathOutput, node.depth + 1 });
+                        _children.push_back(nextIndex++);
+                    }
+                    else
+                    {
+                        _children.push_back(~static_cast<int32_t>(_leafValues.size()));
+                        _leafValues.push_back(pathOutput);
+                    }
+                }
+            }
+            _treeDepths.push_back(depth);
+        }
+    }
+
+    double CompactForestPredictor::Predict(const DataVectorType& input) const
+    {
+        double output = _bias;
+        for (auto root : _treeRoots)
+        {
+            auto nodeIndex = root;
+            do
+            {
+                auto value = static_cast<float>(input[_featureIndices[nodeIndex]]);
+                nodeIndex = _children[2 * nodeIndex + (value > _thresholds[nodeIndex] ? 1 : 0)];
+            } while (nodeIndex >= 0);
+            output += _leafValues[~nodeIndex];
+        }
+        return output;
+    }
+
+    std::vector<double> CompactForestPredictor::Predict(math::ConstRowMatrixReference<float> inputs) const
+    {
+        if (inputs.NumRows() > 0 && inputs.NumColumns() < _numFeatures)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "inputs have fewer columns than the number of features the forest uses");
+        }
+
+        std::vector<double> outputs(inputs.NumRows());
+        const auto increment = inputs.GetIncrement();
+        for (size_t firstRow = 0; firstRow < inputs.NumRows(); firstRow += blockSize)
+        {
+            auto numRows = std::min(blockSize, inputs.NumRows() - firstRow);
+            PredictBlock(inputs.GetConstDataPointer() + firstRow * increment, increment, numRows, outputs.data() + firstRow);
+        }
+        return outputs;
+    }
+
+    void CompactForestPredictor::PredictBlock(const float* inputs, size_t increment, size_t numRows, double* outputs) const
+    {
+        std::fill(outputs, outputs + numRows, _bias);
+
+        int32_t nodeIndices[blockSize];
+        for (size_t treeIndex = 0; treeIndex < _treeRoots.size(); ++treeIndex)
+        {
+            std::fill(nodeIndices, nodeIndices + numRows, _treeRoots[treeIndex]);
+
+            // advance every row by one level per pass; the loads of different rows are independent, so they're in flight
+            // at the same time. Rows that already reached a leaf keep their (negative) leaf index.
+            for (uint32_t level = 0; level < _treeDepths[treeIndex]; ++level)
+            {
+                for (size_t row = 0; row < numRows; ++row)
+                {
+                    auto nodeIndex = nodeIndices[row];
+                    if (nodeIndex >= 0)
+                    {
+                        auto value = inputs[row * increment + _featureIndices[nodeIndex]];
+                        nodeIndices[row] = _children[2 * nodeIndex + (value > _thresholds[nodeIndex] ? 1 : 0)];
+                    }
+                }
+            }
+
+            for (size_t row = 0; row < numRows; ++row)
+            {
+                outputs[row] += _leafValues[~nodeIndices[row]];
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassLinearPredictor.tcc (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MultiClassLinearPredictor.h"
+
+// data
+#include "SparseDataVector.h"
+
+// math
+#include "VectorOperations.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+    template <typename ElementType>
+    MultiClassLinearPredictor<ElementType>::MultiClassLinearPredictor()
+        : _w(0, 0)
+    {
+    }
+
+    template <typename ElementType>
+    MultiClassLinearPredictor<ElementType>::MultiClassLinearPredictor(size_t inputSize, size_t numClasses)
+        : _w(inputSize, numClasses), _b(numClasses)
+    {
+    }
+
+    template <typename ElementType>
+    MultiClassLinearPredictor<ElementType>::MultiClassLinearPredictor(math::RowMatrix<ElementType> weights, math::ColumnVector<ElementType> bias)
+        : _w(std::move(weights)), _b(std::move(bias))
+    {
+        if (_w.NumColumns() != _b.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "weights must have one column per class");
+        }
+    }
+
+    template <typename ElementType>
+    template <typename OtherElementType>
+    MultiClassLinearPredictor<ElementType>::MultiClassLinearPredictor(const MultiClassLinearPredictor<OtherElementType>& other)
+        : _w(other.Size(), other.NumClasses()), _b(other.NumClasses())
+    {
+        const auto& weights = other.GetWeights();
+        for (size_t i = 0; i < _w.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < _w.NumColumns(); ++j)
+            {
+                _w(i, j) = static_cast<ElementType>(weights(i, j));
+            }
+        }
+
+        const auto& bias = other.GetBias();
+        for (size_t j = 0; j < _b.Size(); ++j)
+        {
+            _b[j] = static_cast<ElementType>(bias[j]);
+        }
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictor<ElementType>::Resize(size_t size)
+    {
+        math::RowMatrix<ElementType> w(size, NumClasses());
+        auto numRows = std::min(size, _w.NumRows());
+        if (numRows > 0)
+        {
+            w.GetSubMatrix(0, 0, numRows, NumClasses()).CopyFrom(_w.GetSubMatrix(0, 0, numRows, NumClasses()));
+        }
+        _w = std::move(w);
+    }
+
+    template <typename ElementType>
+    math::ColumnVector<ElementType> MultiClassLinearPredictor<ElementType>::Predict(const DataVectorType& dataVector) const
+    {
+        // each nonzero input element adds a scaled row of the weights to the output
+        math::ColumnVector<ElementType> output(_b);
+        auto sparseVector = dataVector.CopyAs<data::SparseDoubleDataVector>();
+        auto iterator = sparseVector.GetIterator<data::IterationPolicy::skipZeros>();
+        while (iterator.IsValid() && iterator.Get().index < _w.NumRows())
+        {
+            auto entry = iterator.Get();
+            math::ScaleAddUpdate(static_cast<ElementType>(entry.value), _w.GetRow(entry.index).Transpose(), math::One(), output);
+            iterator.Next();
+        }
+        return output;
+    }
+
+    template <typename ElementType>
+    size_t MultiClassLinearPredictor<ElementType>::PredictClass(const DataVectorType& dataVector) const
+    {
+        auto scores = Predict(dataVector);
+        if (scores.Size() == 0)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "predictor has no classes");
+        }
+        size_t bestClass = 0;
+        for (size_t j = 1; j < scores.Size(); ++j)
+        {
+            if (scores[j] > scores[bestClass])
+            {
+                bestClass = j;
+            }
+        }
+        return bestClass;
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictor<ElementType>::Reset()
+    {
+        _w.Reset();
+        _b.Reset();
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictor<ElementType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        math::MatrixArchiver::Write(_w, "w", archiver);
+        archiver["b"] << _b.ToArray();
+    }
+
+    template <typename ElementType>
+    void MultiClassLinearPredictor<ElementType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        math::MatrixArchiver::Read(_w, "w", archiver);
+        std::vector<ElementType> b;
+        archiver["b"] >> b;
+        _b = math::ColumnVector<ElementType>(std::move(b));
+    }
+}
+}
@@ -8,7 +8,17 @@
 
 #pragma once
 
+// predictors
+#include "ForestPredictor.h"
+
+// math
+#include "Matrix.h"
+
 // testing
 #include "testing.h"
 
+ell::predictors::SimpleForestPredictor GetRandomForest(size_t numTrees, size_t numInteriorNodesPerTree, size_t numFeatures, unsigned seed);
+ell::math::RowMatrix<float> GetRandomForestInputs(size_t numRows, size_t numFeatures, unsigned seed);
+
 void ForestPredictorTest();
+void CompactForestPredictorTest();
@@ -0,0 +1,15 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestPredictorTiming.h (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+// Prediction on a batch of inputs with ForestPredictor and with CompactForestPredictor
+void TimeForestPredict(size_t numTrees, size_t numInteriorNodesPerTree, size_t numFeatures, size_t numRows, size_t numIterations);
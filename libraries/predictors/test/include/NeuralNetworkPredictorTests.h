@@ -47,6 +47,9 @@ void BinaryConvolutionalLayerBitwiseTest();
 template <typename ElementType>
 void SoftmaxLayerTest();
 
+template <typename ElementType>
+void RegionDetectionPostProcessingTest();
+
 template <typename ElementType>
 void NeuralNetworkPredictorTest();
 
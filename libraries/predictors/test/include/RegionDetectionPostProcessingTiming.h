@@ -0,0 +1,16 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessingTiming.h (predictors)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+// Turning a raw region tensor into a list of detections: with RegionDetectionLayer, a copy of its output and a
+// scripted-style sort and non-maximum suppression, and with RegionDetectionPostProcessor
+void TimeRegionDetectionPostProcessing(int gridSize, int numBoxesPerCell, int numClasses, size_t numIterations);
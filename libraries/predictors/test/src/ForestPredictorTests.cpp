@@ -6,13 +6,67 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "ForestPredictorTests.h"
+
+// predictors
+#include "CompactForestPredictor.h"
 #include "ForestPredictor.h"
 
+// math
+#include "Matrix.h"
+
 // testing
 #include "testing.h"
 
+// stl
+#include <random>
+#include <utility>
+#include <vector>
+
 using namespace ell;
 
+predictors::SimpleForestPredictor GetRandomForest(size_t numTrees, size_t numInteriorNodesPerTree, size_t numFeatures, unsigned seed)
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    std::default_random_engine engine(seed);
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    std::uniform_real_distribution<double> valueDistribution(-1.0, 1.0);
+    auto getSplitRule = [&]() { return SplitRule{ featureDistribution(engine), valueDistribution(engine) }; };
+    auto getEdgePredictors = [&]() { return EdgePredictorVector{ valueDistribution(engine), valueDistribution(engine) }; };
+
+    predictors::SimpleForestPredictor forest;
+    forest.AddToBias(valueDistribution(engine));
+    for (size_t tree = 0; tree < numTrees; ++tree)
+    {
+        // grow the tree by splitting randomly chosen leaves
+        auto root = forest.Split(SplitAction{ forest.GetNewRootId(), getSplitRule(), getEdgePredictors() });
+        std::vector<std::pair<size_t, size_t>> leaves{ { root, 0 }, { root, 1 } };
+        for (size_t node = 1; node < numInteriorNodesPerTree; ++node)
+        {
+            auto leafPosition = std::uniform_int_distribution<size_t>(0, leaves.size() - 1)(engine);
+            auto leaf = leaves[leafPosition];
+            leaves.erase(leaves.begin() + leafPosition);
+
+            auto nodeIndex = forest.Split(SplitAction{ forest.GetChildId(leaf.first, leaf.second), getSplitRule(), getEdgePredictors() });
+            leaves.push_back({ nodeIndex, 0 });
+            leaves.push_back({ nodeIndex, 1 });
+        }
+    }
+    return forest;
+}
+
+math::RowMatrix<float> GetRandomForestInputs(size_t numRows, size_t numFeatures, unsigned seed)
+{
+    std::default_random_engine engine(seed);
+    std::uniform_real_distribution<float> valueDistribution(-1.0f, 1.0f);
+    math::RowMatrix<float> inputs(numRows, numFeatures);
+    inputs.Generate([&]() { return valueDistribution(engine); });
+    return inputs;
+}
+
 void ForestPredictorTest()
 {
     // define some abbreviations
@@ -66,3 +120,54 @@ void ForestPredictorTest()
     auto edgeIndicator = forest.GetEdgeIndicatorVector(ExampleType{ 0.25, 0.7, 0.0 });
     testing::ProcessTest("Testing ForestPredictor, SetEdgeIndicatorVector()", testing::IsEqual(edgeIndicator, std::vector<bool>{ 1, 0, 0, 1, 0, 0, 0, 1 }));
 }
+
+void CompactForestPredictorTest()
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+    using ExampleType = predictors::SimpleForestPredictor::DataVectorType;
+
+    // the same forest as in ForestPredictorTest
+    predictors::SimpleForestPredictor forest;
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(0, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(0, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.2 }, EdgePredictorVector{ -3.0, 3.0 } });
+
+    predictors::CompactForestPredictor compactForest(forest);
+    testing::ProcessTest("Testing CompactForestPredictor, NumTrees()", compactForest.NumTrees() == 2);
+    testing::ProcessTest("Testing CompactForestPredictor, NumInteriorNodes()", compactForest.NumInteriorNodes() == 4);
+    testing::ProcessTest("Testing CompactForestPredictor, NumLeaves()", compactForest.NumLeaves() == 6);
+    testing::ProcessTest("Testing CompactForestPredictor, NumFeatures()", compactForest.NumFeatures() == 3);
+
+    testing::ProcessTest("Testing CompactForestPredictor, Predict()", testing::IsEqual(compactForest.Predict(ExampleType{ 0.18, 0.5, 0.0 }), -6.0, 1.0e-8));
+    testing::ProcessTest("Testing CompactForestPredictor, Predict()", testing::IsEqual(compactForest.Predict(ExampleType{ 0.25, 0.7, 0.0 }), 4.0, 1.0e-8));
+    testing::ProcessTest("Testing CompactForestPredictor, Predict()", testing::IsEqual(compactForest.Predict(ExampleType{ 0.5, 0.7, 1.0 }), 8.0, 1.0e-8));
+
+    // compare to the original forest on random forests, including inputs that lie exactly on a threshold
+    bool singleMatches = true;
+    bool batchMatches = true;
+    for (unsigned seed = 0; seed < 4; ++seed)
+    {
+        const size_t numFeatures = 20;
+        auto randomForest = GetRandomForest(10, 1 + 20 * seed, numFeatures, seed);
+        predictors::CompactForestPredictor randomCompactForest(randomForest);
+
+        auto inputs = GetRandomForestInputs(100, numFeatures, seed);
+        const auto& rootNode = randomForest.GetInteriorNodes()[randomForest.GetRootIndices()[0]];
+        inputs(0, rootNode.GetSplitRule().GetElementIndex()) = static_cast<float>(rootNode.GetSplitRule().GetThreshold());
+
+        auto batchOutputs = randomCompactForest.Predict(inputs);
+        for (size_t row = 0; row < inputs.NumRows(); ++row)
+        {
+            auto rowVector = inputs.GetRow(row);
+            ExampleType example(std::vector<float>(rowVector.GetConstDataPointer(), rowVector.GetConstDataPointer() + numFeatures));
+            auto expected = randomForest.Predict(example);
+            singleMatches = singleMatches && randomCompactForest.Predict(example) == expected;
+            batchMatches = batchMatches && batchOutputs[row] == expected;
+        }
+    }
+    testing::ProcessTest("Testing CompactForestPredictor, Predict() matches ForestPredictor", singleMatches);
+    testing::ProcessTest("Testing CompactForestPredictor, batch Predict() matches ForestPredictor", batchMatches);
+}
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestPredictorTiming.cpp (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ForestPredictorTiming.h"
+#include "ForestPredictorTests.h"
+
+// predictors
+#include "CompactForestPredictor.h"
+#include "ForestPredictor.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <iostream>
+#include <vector>
+
+using namespace ell;
+
+void TimeForestPredict(size_t numTrees, size_t numInteriorNodesPerTree, size_t numFeatures, size_t numRows, size_t numIterations)
+{
+    auto forest = GetRandomForest(numTrees, numInteriorNodesPerTree, numFeatures, 0);
+    predictors::CompactForestPredictor compactForest(forest);
+    auto inputs = GetRandomForestInputs(numRows, numFeatures, 1);
+
+    std::vector<predictors::SimpleForestPredictor::DataVectorType> examples;
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        auto rowVector = inputs.GetRow(row);
+        examples.emplace_back(std::vector<float>(rowVector.GetConstDataPointer(), rowVector.GetConstDataPointer() + numFeatures));
+    }
+
+    std::vector<double> outputs(numRows);
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            outputs[row] = forest.Predict(examples[row]);
+        }
+    }
+    auto forestDuration = timer.Elapsed();
+
+    timer.Reset();
+    std::vector<double> compactOutputs(numRows);
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            compactOutputs[row] = compactForest.Predict(examples[row]);
+        }
+    }
+    auto compactDuration = timer.Elapsed();
+
+    timer.Reset();
+    std::vector<double> batchOutputs;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        batchOutputs = compactForest.Predict(inputs);
+    }
+    auto batchDuration = timer.Elapsed();
+
+    testing::ProcessTest("Compact forest outputs match", compactOutputs == outputs && batchOutputs == outputs);
+
+    std::cout << "Time to predict " << numRows << " inputs with " << numTrees << " trees of " << numInteriorNodesPerTree << " interior nodes, "
+              << numIterations << " times: ForestPredictor " << forestDuration << " ms, CompactForestPredictor " << compactDuration
+              << " ms, CompactForestPredictor batch " << batchDuration << " ms" << std::endl;
+}
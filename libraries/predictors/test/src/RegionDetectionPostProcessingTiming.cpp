@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     RegionDetectionPostProcessingTiming.cpp (predictors)
+//  Authors:  Byron Changuion
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RegionDetectionPostProcessingTiming.h"
+
+// predictors
+#include "RegionDetectionLayer.h"
+#include "RegionDetectionPostProcessing.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+using ElementType = float;
+
+struct Candidate
+{
+    int classIndex;
+    double confidence;
+    double x;
+    double y;
+    double width;
+    double height;
+};
+
+double IntersectionOverUnion(const Candidate& a, const Candidate& b)
+{
+    auto intersectionWidth = std::max(0.0, std::min(a.x + a.width / 2, b.x + b.width / 2) - std::max(a.x - a.width / 2, b.x - b.width / 2));
+    auto intersectionHeight = std::max(0.0, std::min(a.y + a.height / 2, b.y + b.height / 2) - std::max(a.y - a.height / 2, b.y - b.height / 2));
+    auto intersection = intersectionWidth * intersectionHeight;
+    return intersection / (a.width * a.height + b.width * b.height - intersection);
+}
+
+// The way a host application post-processes the output of the region detection layer: score every class of every
+// box, sort all the candidates, and then run non-maximum suppression on the whole list
+std::vector<Candidate> PostProcessOnHost(const std::vector<ElementType>& regions, const predictors::neural::RegionDetectionParameters& regionParams, const predictors::neural::RegionDetectionPostProcessingParameters& postProcessingParams)
+{
+    const int boxStride = regionParams.numCoordinates + 1 + regionParams.numClasses;
+    std::vector<Candidate> candidates;
+    for (int i = 0; i < regionParams.width; ++i)
+    {
+        for (int j = 0; j < regionParams.height; ++j)
+        {
+            for (int k = 0; k < regionParams.numBoxesPerCell; ++k)
+            {
+                auto box = regions.data() + ((i * regionParams.height + j) * regionParams.numBoxesPerCell + k) * boxStride;
+                for (int c = 0; c < regionParams.numClasses; ++c)
+                {
+                    auto confidence = static_cast<double>(box[4]) * box[5 + c];
+                    if (confidence > postProcessingParams.confidenceThreshold)
+                    {
+                        candidates.push_back({ c, confidence, (j + box[0]) / regionParams.height, (i + box[1]) / regionParams.width, postProcessingParams.anchorScales[2 * k] * box[2] / regionParams.height, postProcessingParams.anchorScales[2 * k + 1] * box[3] / regionParams.width });
+                    }
+                }
+            }
+        }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.confidence > b.confidence; });
+    std::vector<bool> isSuppressed(candidates.size(), false);
+    std::vector<Candidate> detections;
+    for (size_t a = 0; a < candidates.size() && detections.size() < static_cast<size_t>(postProcessingParams.maxDetections); ++a)
+    {
+        if (isSuppressed[a])
+        {
+            continue;
+        }
+        detections.push_back(candidates[a]);
+        for (size_t b = a + 1; b < candidates.size(); ++b)
+        {
+            if (candidates[b].classIndex == candidates[a].classIndex && IntersectionOverUnion(candidates[a], candidates[b]) > postProcessingParams.nmsThreshold)
+            {
+                isSuppressed[b] = true;
+            }
+        }
+    }
+    return detections;
+}
+}
+
+void TimeRegionDetectionPostProcessing(int gridSize, int numBoxesPerCell, int numClasses, size_t numIterations)
+{
+    using namespace predictors::neural;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+
+    // A random region tensor where, as in a trained network, most of the boxes have a low objectness
+    const int boxStride = 5 + numClasses;
+    TensorType input(gridSize, gridSize, numBoxesPerCell * boxStride);
+    std::default_random_engine engine(1234);
+    std::normal_distribution<ElementType> coordinates(0, 1);
+    std::normal_distribution<ElementType> objectness(-4, 2);
+    std::normal_distribution<ElementType> classScores(0, 2);
+    auto data = input.GetDataPointer();
+    for (size_t index = 0; index < input.Size(); ++index)
+    {
+        auto channel = static_cast<int>(index % boxStride);
+        data[index] = channel < 4 ? coordinates(engine) : (channel == 4 ? objectness(engine) : classScores(engine));
+    }
+
+    RegionDetectionParameters regionParams{ gridSize, gridSize, numBoxesPerCell, numClasses, 4 };
+    RegionDetectionPostProcessingParameters postProcessingParams;
+    postProcessingParams.confidenceThreshold = 0.25;
+    postProcessingParams.nmsThreshold = 0.45;
+    postProcessingParams.maxDetections = 32;
+    for (int k = 0; k < numBoxesPerCell; ++k)
+    {
+        postProcessingParams.anchorScales.push_back(1.0 + k);
+        postProcessingParams.anchorScales.push_back(1.5 + k);
+    }
+
+    // Host-side path: the region detection layer decodes the boxes, and the host post-processes a copy of its output.
+    // The two steps are timed separately, because the decoding isn't part of a post-processing step on the host.
+    RegionDetectionLayer<ElementType> layer(LayerParameters{ input, NoPadding(), { static_cast<size_t>(gridSize), static_cast<size_t>(gridSize), input.NumChannels() }, NoPadding() }, regionParams);
+    std::vector<ElementType> regions;
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        layer.Compute();
+        regions = layer.GetOutput().ToArray();
+    }
+    auto decodeDuration = timer.Elapsed();
+
+    std::vector<Candidate> hostDetections;
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        hostDetections = PostProcessOnHost(regions, regionParams, postProcessingParams);
+    }
+    auto hostDuration = timer.Elapsed();
+
+    // Fused path, which decodes the boxes as it post-processes them, with the top-K lists long enough to hold every box so that both paths find the same detections
+    postProcessingParams.maxDetectionsPerClass = gridSize * gridSize * numBoxesPerCell;
+    RegionDetectionPostProcessor<ElementType> postProcessor(regionParams, postProcessingParams);
+    std::vector<ElementType> detections(postProcessor.GetOutputSize());
+    size_t numDetections = 0;
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        numDetections = postProcessor.Compute(input.GetConstDataPointer(), detections.data());
+    }
+    auto fusedDuration = timer.Elapsed();
+
+    // Fused path with the default top-K
+    postProcessingParams.maxDetectionsPerClass = RegionDetectionPostProcessingParameters().maxDetectionsPerClass;
+    RegionDetectionPostProcessor<ElementType> topKPostProcessor(regionParams, postProcessingParams);
+    std::vector<ElementType> topKDetections(topKPostProcessor.GetOutputSize());
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        topKPostProcessor.Compute(input.GetConstDataPointer(), topKDetections.data());
+    }
+    auto topKDuration = timer.Elapsed();
+
+    auto fusedDetections = GetRegionDetections(detections.data(), numDetections);
+    bool ok = fusedDetections.size() == hostDetections.size();
+    for (size_t index = 0; ok && index < fusedDetections.size(); ++index)
+    {
+        const auto& fused = fusedDetections[index];
+        const auto& host = hostDetections[index];
+        ok = fused.classIndex == host.classIndex && testing::IsEqual(static_cast<double>(fused.confidence), host.confidence, 1e-4) && testing::IsEqual(static_cast<double>(fused.x), host.x, 1e-4) && testing::IsEqual(static_cast<double>(fused.width), host.width, 1e-4);
+    }
+    testing::ProcessTest("Fused region detection post-processing matches the host-side path", ok);
+
+    std::cout << "Time to post-process a " << gridSize << "x" << gridSize << " grid with " << numBoxesPerCell << " boxes per cell and " << numClasses << " classes ("
+              << numDetections << " detections), " << numIterations << " times: region layer decoding " << decodeDuration << " ms, host-side post-processing "
+              << hostDuration << " ms, fused decoding and post-processing " << fusedDuration << " ms, fused with top-" << postProcessingParams.maxDetectionsPerClass << " "
+              << topKDuration << " ms" << std::endl;
+}
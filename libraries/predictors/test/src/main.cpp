@@ -20,6 +20,7 @@ int main()
 {
     // ForestPredictor
     ForestPredictorTest();
+    CompactForestPredictorTest();
 
     // LinearPredictor
     LinearPredictorTest<double>();
@@ -39,6 +40,7 @@ int main()
     BinaryConvolutionalLayerBitwiseTest<float>();
     BinaryConvolutionalLayerGemmTest<float>();
     SoftmaxLayerTest<float>();
+    RegionDetectionPostProcessingTest<float>();
     NeuralNetworkPredictorTest<float>();
     RecurrentLayerTest<float>();
     LSTMLayerTest<float>();
@@ -57,6 +59,7 @@ int main()
     BinaryConvolutionalLayerBitwiseTest<double>();
     BinaryConvolutionalLayerGemmTest<double>();
     SoftmaxLayerTest<double>();
+    RegionDetectionPostProcessingTest<double>();
     NeuralNetworkPredictorTest<double>();
     RecurrentLayerTest<double>();
     LSTMLayerTest<double>();
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (predictors)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ForestPredictorTiming.h"
+#include "RegionDetectionPostProcessingTiming.h"
+
+// testing
+#include "testing.h"
+
+using namespace ell;
+
+int main()
+{
+    // void TimeForestPredict(size_t numTrees, size_t numInteriorNodesPerTree, size_t numFeatures, size_t numRows, size_t numIterations);
+    TimeForestPredict(10, 15, 20, 10000, 10);
+    TimeForestPredict(100, 31, 100, 10000, 5);
+    TimeForestPredict(100, 255, 100, 10000, 2);
+    TimeForestPredict(1000, 63, 500, 10000, 1);
+
+    // void TimeRegionDetectionPostProcessing(int gridSize, int numBoxesPerCell, int numClasses, size_t numIterations);
+    TimeRegionDetectionPostProcessing(13, 5, 20, 200);
+    TimeRegionDetectionPostProcessing(19, 5, 80, 50);
+
+    return testing::DidTestFail() ? 1 : 0;
+}
@@ -15,6 +15,7 @@
 #include "ParametricReLUActivation.h"
 #include "ReLUActivation.h"
 #include "RecurrentLayer.h"
+#include "RegionDetectionPostProcessing.h"
 #include "SigmoidActivation.h"
 #include "SoftMaxActivation.h"
 #include "TanhActivation.h"
@@ -653,6 +654,67 @@ void SoftmaxLayerTest()
     testing::ProcessTest("Testing SoftmaxLayer, padding", output(0, 0, 0) == 0 && output(0, 1, 0) == 0 && output(2, 2, 0) == 0 && output(2, 2, 1) == 0);
 }
 
+template <typename ElementType>
+void RegionDetectionPostProcessingTest()
+{
+    using namespace ell::predictors;
+    using namespace ell::predictors::neural;
+
+    // A 2 x 2 grid with 2 boxes per cell and 3 classes. Each box is [tx, ty, tw, th, tc, class scores...], and every
+    // box starts out with a very low objectness.
+    RegionDetectionParameters regionParams{ 2, 2, 2, 3, 4 };
+    const int boxStride = 8;
+    std::vector<ElementType> regions(2 * 2 * 2 * boxStride, 0);
+    auto setBox = [&](int row, int column, int box, ElementType objectness, std::vector<ElementType> classScores) {
+        auto offset = ((row * 2 + column) * 2 + box) * boxStride;
+        regions[offset + 4] = objectness;
+        std::copy(classScores.begin(), classScores.end(), regions.begin() + offset + 5);
+    };
+    for (int index = 0; index < 8; ++index)
+    {
+        setBox(index / 4, (index / 2) % 2, index % 2, -5, { 0, 0, 0 });
+    }
+    setBox(0, 0, 0, 4, { 5, 0, 0 }); // class 0
+    setBox(0, 0, 1, 3, { 5, 0, 0 }); // class 0, overlaps the box above with IoU 0.69
+    setBox(1, 1, 0, 2, { 0, 5, 0 }); // class 1
+    setBox(1, 0, 0, 1, { 5, 0, 0 }); // class 0, doesn't overlap
+    setBox(0, 1, 0, 4, { 0, 0, 0 }); // no class is confident
+
+    auto confidence = [](double objectness, double classScore) { return 1 / (1 + std::exp(-objectness)) * std::exp(classScore) / (std::exp(5.0) + 2); };
+    std::vector<double> expected = {
+        0, confidence(4, 5), 0.25, 0.25, 0.5, 0.5,
+        1, confidence(2, 5), 0.75, 0.75, 0.5, 0.5,
+        0, confidence(1, 5), 0.25, 0.75, 0.5, 0.5,
+        -1, 0, 0, 0, 0, 0
+    };
+
+    RegionDetectionPostProcessingParameters postProcessingParams;
+    postProcessingParams.confidenceThreshold = 0.5;
+    postProcessingParams.nmsThreshold = 0.45;
+    postProcessingParams.maxDetectionsPerClass = 4;
+    postProcessingParams.maxDetections = 4;
+    postProcessingParams.anchorScales = { 1, 1, 1.2, 1.2 };
+    RegionDetectionPostProcessor<ElementType> postProcessor(regionParams, postProcessingParams);
+    std::vector<ElementType> detections(postProcessor.GetOutputSize());
+    auto numDetections = postProcessor.Compute(regions.data(), detections.data());
+    testing::ProcessTest("Testing RegionDetectionPostProcessor, detections", numDetections == 3 && testing::IsEqual(std::vector<double>(detections.begin(), detections.end()), expected, 1e-5));
+
+    auto unpacked = GetRegionDetections(detections.data(), numDetections);
+    testing::ProcessTest("Testing GetRegionDetections", unpacked.size() == 3 && unpacked[1].classIndex == 1 && Equals(unpacked[1].x, 0.75) && Equals(unpacked[2].confidence, expected[13]));
+
+    // Only the most confident box of each class is considered, and the list holds two detections
+    postProcessingParams.maxDetectionsPerClass = 1;
+    postProcessingParams.maxDetections = 2;
+    RegionDetectionPostProcessor<ElementType> topOnePostProcessor(regionParams, postProcessingParams);
+    detections.resize(topOnePostProcessor.GetOutputSize());
+    numDetections = topOnePostProcessor.Compute(regions.data(), detections.data());
+    testing::ProcessTest("Testing RegionDetectionPostProcessor, top-K", numDetections == 2 && testing::IsEqual(std::vector<double>(detections.begin(), detections.end()), std::vector<double>(expected.begin(), expected.begin() + 12), 1e-5));
+
+    // Computing again gives the same result
+    numDetections = topOnePostProcessor.Compute(regions.data(), detections.data());
+    testing::ProcessTest("Testing RegionDetectionPostProcessor, repeated", numDetections == 2 && testing::IsEqual(std::vector<double>(detections.begin(), detections.end()), std::vector<double>(expected.begin(), expected.begin() + 12), 1e-5));
+}
+
 template <typename ElementType>
 void NeuralNetworkPredictorTest()
 {
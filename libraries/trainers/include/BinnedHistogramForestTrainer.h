@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedHistogramForestTrainer.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ForestTrainer.h"
+#include "LogitBooster.h"
+
+// predictors
+#include "ConstantPredictor.h"
+#include "SingleElementThresholdPredictor.h"
+
+// stl
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Parameters for the binned histogram forest trainer. </summary>
+    struct BinnedHistogramForestTrainerParameters : public virtual ForestTrainerParameters
+    {
+        size_t maxBinsPerFeature = 255;
+    };
+
+    /// <summary>
+    /// A trainer for binary decision forests with threshold split rules and constant outputs. Before training, each feature
+    /// is quantized into at most `maxBinsPerFeature` bins, which are stored column-major as 8 or 16 bit integers. The best
+    /// split at each node is found by building a histogram of the weak weights and labels in each bin, and scanning the bins.
+    /// The histogram of one of the children of a split node is computed from the examples, and the histogram of its sibling
+    /// is computed by subtracting it from the histogram of the parent.
+    /// </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> The loss function type. </typeparam>
+    /// <typeparam name="BoosterType"> The booster type. </typeparam>
+    template <typename LossFunctionType, typename BoosterType>
+    class BinnedHistogramForestTrainer : public ForestTrainer<predictors::SingleElementThresholdPredictor, predictors::ConstantPredictor, BoosterType>
+    {
+    public:
+        /// <summary> Constructs an instance of BinnedHistogramForestTrainer. </summary>
+        ///
+        /// <param name="lossFunction"> The loss function. </param>
+        /// <param name="booster"> The booster. </param>
+        /// <param name="parameters"> Training Parameters. </param>
+        BinnedHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedHistogramForestTrainerParameters& parameters);
+
+        /// <summary> Sets the trainer's dataset, and quantizes its features. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+        using SplitRuleType = predictors::SingleElementThresholdPredictor;
+        using EdgePredictorType = predictors::ConstantPredictor;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplitCandidate;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SplittableNodeId;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NodeStats;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
+        using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
+
+    protected:
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_parameters;
+        SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
+
+    private:
+        // the statistics of the examples that fall in one bin
+        struct BinStats
+        {
+            double sumWeights = 0;
+            double sumWeightedLabels = 0;
+            size_t count = 0;
+        };
+
+        // the bins of all the features at a node, feature after feature
+        using Histogram = std::vector<BinStats>;
+
+        struct CachedHistogram
+        {
+            Range range;
+            Histogram histogram;
+        };
+
+        void QuantizeFeatures();
+        Histogram GetNodeHistogram(Range range);
+        Histogram BuildHistogram(Range range) const;
+        Histogram SubtractHistograms(const Histogram& histogram, const Histogram& other) const;
+        template <typename BinType>
+        void AccumulateHistogram(const std::vector<BinType>& bins, Range range, Histogram& histogram) const;
+        double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
+
+        // member variables
+        LossFunctionType _lossFunction;
+        size_t _maxBinsPerFeature;
+
+        // the split thresholds between consecutive bins of each feature
+        std::vector<std::vector<double>> _thresholds;
+
+        // the offset of each feature's bins in a histogram
+        std::vector<size_t> _histogramOffsets;
+
+        // the bin of each feature of each example, column-major; only one of these is used, depending on the number of bins
+        std::vector<uint8_t> _bins8;
+        std::vector<uint16_t> _bins16;
+
+        // histograms kept for nodes that may be split, keyed by the first index of their range
+        std::map<size_t, CachedHistogram> _histogramCache;
+    };
+
+    /// <summary> Makes a binned histogram forest trainer. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Type of loss function to use. </typeparam>
+    /// <typeparam name="BoosterType"> Type of booster to use. </typeparam>
+    /// <param name="lossFunction"> The loss function. </param>
+    /// <param name="booster"> The booster. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a binned histogram forest trainer. </returns>
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedHistogramForestTrainerParameters& parameters);
+}
+}
+
+#include "../tcc/BinnedHistogramForestTrainer.tcc"
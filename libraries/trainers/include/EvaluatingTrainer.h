@@ -42,6 +42,11 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
+        /// <summary> Sets the trainer's dataset, which the internal trainer may read in place rather than copy. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset, which must outlive the trainer's updates. </param>
+        void SetSharedDataset(const data::AnyDataset& anyDataset) override;
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         void Update() override;
 
@@ -88,6 +88,9 @@ namespace trainers
 
             // the output of the forest on this example
             double currentOutput = 0;
+
+            // the position of this example in the dataset given to SetDataset, which doesn't change when the trainer reorders the examples
+            size_t exampleIndex = 0;
         };
 
         // keeps statistics about tree nodes
@@ -35,6 +35,12 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         virtual void SetDataset(const data::AnyDataset& anyDataset) = 0;
 
+        /// <summary> Sets the trainer's dataset, which trainers that support it read in place rather than copy. The
+        /// dataset must then outlive the trainer's updates. By default, this is the same as SetDataset. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        virtual void SetSharedDataset(const data::AnyDataset& anyDataset) { SetDataset(anyDataset); }
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         virtual void Update() = 0;
 
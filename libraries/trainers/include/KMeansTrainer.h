@@ -8,10 +8,16 @@
 
 #pragma once
 
+// utilities
+#include "ThreadPool.h"
+
 // stl
 #include <cstddef>
 #include <memory>
 #include <map>
+#include <random>
+#include <string>
+#include <vector>
 
 // Matrix
 #include <Matrix.h>
@@ -20,6 +26,38 @@ namespace ell
 {
 namespace trainers
 {
+    /// <summary> Strategies for choosing the initial cluster means. </summary>
+    enum class KMeansInitialization
+    {
+        /// <summary> Sequential k-means++ seeding, which makes one pass over the data per cluster. </summary>
+        kMeansPlusPlus,
+
+        /// <summary> k-means|| seeding, which oversamples candidates in a few parallel passes and reclusters them. </summary>
+        kMeansParallel
+    };
+
+    /// <summary> Optional parameters for the KMeansTrainer. </summary>
+    struct KMeansTrainerParameters
+    {
+        /// <summary> If nonzero, run mini-batch k-means over blocks of this many points instead of full-batch Lloyd iterations. </summary>
+        size_t miniBatchSize = 0;
+
+        /// <summary> The initialization strategy. </summary>
+        KMeansInitialization initialization = KMeansInitialization::kMeansPlusPlus;
+
+        /// <summary> The number of sampling rounds used by k-means|| initialization. </summary>
+        size_t numInitializationRounds = 5;
+
+        /// <summary> The expected number of candidates sampled per k-means|| round, as a multiple of the number of clusters. </summary>
+        double oversamplingFactor = 2.0;
+
+        /// <summary> The number of threads used to compute distances (0 means one per hardware thread). </summary>
+        size_t numThreads = 1;
+
+        /// <summary> The random seed string used by mini-batch k-means and k-means|| initialization. </summary>
+        std::string randomSeedString = "KMeans";
+    };
+
     /// <summary> Impements KMeansTrainer++ algorithm </summary>
     ///
     class KMeansTrainer
@@ -45,6 +83,15 @@ namespace trainers
         ///
         KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means);
 
+        /// <summary> Constructs an instance of KMeansTrainer trainer </summary>
+        ///
+        /// <param name="dimension"> The input dimension. </param>
+        /// <param name="numClusters"> The number of clusters. </param>
+        /// <param name="iterations"> The number of iterations. In mini-batch mode, each iteration is one pass over the data. </param>
+        /// <param name="parameters"> Additional parameters. </param>
+        ///
+        KMeansTrainer(size_t dimension, size_t numClusters, size_t iterations, const KMeansTrainerParameters& parameters);
+
         /// <summary> Runs the KMeansTrainer algorithm. </summary>
         ///
         /// <param name="X"> The input matrix. </param>
@@ -77,6 +124,32 @@ namespace trainers
         // Weighted sampling.
         size_t weightedSample(math::ColumnVector<double> weights);
 
+        // Initializes the cluster means using the k-means|| strategy.
+        void initializeMeansParallel(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X);
+
+        // Runs mini-batch k-means over blocks of columns of X.
+        void runMiniBatchKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X);
+
+        // Assigns each point in a block of columns to the closest of the given means, without forming an n x k distance matrix.
+        // Returns the sum of squared distances to the closest means.
+        double assignBlock(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, size_t begin, size_t end, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means, const std::vector<double>& meanSquaredNorms, size_t* assignment, double* distance) const;
+
+        // Assigns every point to the closest mean, one block of columns at a time (in parallel if there's a thread pool).
+        double assignAll(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means, std::vector<size_t>& assignment, std::vector<double>& distance);
+
+        // Calls blockFunction(begin, end) for consecutive blocks of [0, numColumns), in parallel if there's a thread pool.
+        template <typename FunctionType>
+        void forEachBlock(size_t numColumns, size_t blockSize, FunctionType&& blockFunction);
+
+        // Additional parameters.
+        KMeansTrainerParameters _parameters;
+
+        // Random engine for mini-batch k-means and k-means|| initialization.
+        std::default_random_engine _random;
+
+        // Thread pool used to compute distances.
+        std::shared_ptr<utilities::ThreadPool> _threadPool;
+
         // Cluster means.
         math::ColumnMatrix<double> _means;
 
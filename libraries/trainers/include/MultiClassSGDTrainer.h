@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassSGDTrainer.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ITrainer.h"
+#include "SGDTrainer.h"
+
+// predictors
+#include "MultiClassLinearPredictor.h"
+
+// data
+#include "Dataset.h"
+#include "IndexValue.h"
+
+// math
+#include "Matrix.h"
+#include "Vector.h"
+
+// stl
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// Trains a one-versus-rest multiclass linear predictor with the same averaged stochastic gradient descent algorithm as
+    /// SparseDataSGDTrainer. The K binary problems are trained together, in a single pass over the data per epoch: the
+    /// nonzeros of each example are extracted once, and the predictions of all the classes come from a single product of
+    /// the example with a weight matrix that has one column per class. The binary label of class k is +1 for examples of
+    /// class k and -1 for the others.
+    /// </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
+    template <typename LossFunctionType>
+    class MultiClassSGDTrainer : public ITrainer<predictors::MultiClassLinearPredictor<double>>
+    {
+    public:
+        using PredictorType = predictors::MultiClassLinearPredictor<double>;
+
+        /// <summary> Constructs a multiclass SGD trainer. </summary>
+        ///
+        /// <param name="lossFunction"> The binary loss function applied to each class. </param>
+        /// <param name="parameters"> The training parameters. </param>
+        MultiClassSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters);
+
+        /// <summary>
+        /// Sets the trainer's dataset. As in ProtoNNTrainer, the label of each example is its (zero-based) class index. The
+        /// number of classes is one plus the largest class index in the dataset. The examples are not copied: a dataset
+        /// of `AutoSupervisedExample`s held in memory is read in place and a memory-mapped dataset is streamed from its
+        /// file, so the dataset must outlive the trainer's updates. Throws if the dataset is of any other kind.
+        /// </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+        /// <summary>
+        /// Sets the trainer's dataset from a multiclass dataset, which is read in place and must outlive the trainer's
+        /// updates. The number of classes is one plus the largest class index in the dataset.
+        /// </summary>
+        ///
+        /// <param name="dataset"> A multiclass dataset. </param>
+        void SetDataset(const data::AutoSupervisedMultiClassDataset& dataset);
+
+        /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
+        void Update() override;
+
+        /// <summary> Returns the averaged predictor. </summary>
+        ///
+        /// <returns> A const reference to the averaged predictor. </returns>
+        const PredictorType& GetPredictor() const override;
+
+        /// <summary> Returns the last predictor. </summary>
+        ///
+        /// <returns> A const reference to the last predictor. </returns>
+        const PredictorType& GetLastPredictor() const;
+
+        /// <summary> Returns the number of classes in the dataset. </summary>
+        ///
+        /// <returns> The number of classes. </returns>
+        size_t NumClasses() const { return _a.Size(); }
+
+    private:
+        void ResetDataset();
+        void AddExample(const data::AutoDataVector& x, size_t classIndex);
+        void Resize(size_t numFeatures, size_t numClasses);
+        void DoStep(const data::AutoDataVector& x, size_t classIndex, double weight);
+
+        LossFunctionType _lossFunction;
+        SGDTrainerParameters _parameters;
+        std::default_random_engine _random;
+
+        // the dataset is read in place, in the order given by a permutation of its example indices, or streamed from a file
+        const data::AutoSupervisedDataset* _dataset = nullptr;
+        const data::AutoSupervisedMultiClassDataset* _multiClassDataset = nullptr;
+        std::vector<size_t> _order;
+        const data::MappedDataset* _mappedDataset = nullptr;
+        size_t _mappedFromIndex = 0;
+        size_t _mappedSize = 0;
+
+        // the same variables as in SparseDataSGDTrainer, with one column per class
+        math::RowMatrix<double> _v; // gradient sum - weights
+        math::RowMatrix<double> _u; // harmonic-weighted gradient sum - weights
+        math::RowVector<double> _a; // gradient sum - bias
+        math::RowVector<double> _c; // 1/t-weighted sum of _a
+        double _t = 0;              // step counter
+        double _h = 0;              // harmonic number
+
+        // scratch space for the nonzeros, predictions and loss derivatives of an example
+        std::vector<data::IndexValue> _entries;
+        math::RowVector<double> _d;
+        math::RowVector<double> _g;
+
+        // these variables are mutable because we calculate them in a lazy manner (only when `GetPredictor() const` is called)
+        mutable PredictorType _lastPredictor;
+        mutable PredictorType _averagedPredictor;
+    };
+
+    /// <summary> Makes a multiclass SGD linear trainer. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Type of loss function to use. </typeparam>
+    /// <param name="lossFunction"> The loss function. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a multiclass SGD trainer. </returns>
+    template <typename LossFunctionType>
+    std::unique_ptr<trainers::ITrainer<predictors::MultiClassLinearPredictor<double>>> MakeMultiClassSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters);
+}
+}
+
+#include "../tcc/MultiClassSGDTrainer.tcc"
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "KMeansTrainer.h"
+
 // stl
 #include <cstddef>
 #include <map>
@@ -26,7 +28,7 @@ namespace trainers
         /// <summary> Returns the underlying projection matrix. </summary>
         ///
         /// <returns> The underlying projection matrix. </returns>
-        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel);
+        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel, const KMeansTrainerParameters& kMeansParameters = {});
 
         /// <summary> Returns the underlying projection matrix. </summary>
         ///
@@ -53,6 +55,8 @@ namespace trainers
 
         size_t _numPrototypesPerLabel;
 
+        KMeansTrainerParameters _kMeansParameters;
+
         // Returns the underlying projection matrix.
         math::ColumnMatrix<double> _B;
 
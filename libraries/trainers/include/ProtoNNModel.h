@@ -65,6 +65,12 @@ namespace trainers
 
         ///<summary>Whether to output diagnostic information to std::cout.</summary>
         bool verbose;
+
+        ///<summary>If nonzero, initialize the prototypes with mini-batch k-means over batches of this many points</summary>
+        size_t kMeansMiniBatchSize = 0;
+
+        ///<summary>Whether to seed the prototype k-means with the parallel k-means|| strategy instead of k-means++</summary>
+        bool kMeansParallelInitialization = false;
     };
 
 }
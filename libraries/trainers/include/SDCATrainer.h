@@ -20,7 +20,11 @@
 // math
 #include "Vector.h"
 
+// utilities
+#include "ThreadPool.h"
+
 // stl
+#include <memory>
 #include <random>
 
 namespace ell
@@ -35,6 +39,7 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+        size_t numThreads = 1; // number of threads used in each epoch (0 means one per hardware thread)
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -65,7 +70,12 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
-        /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
+        /// <summary>
+        /// Updates the state of the trainer by performing a learning epoch. If the trainer was constructed with more than one
+        /// thread, each thread runs coordinate ascent on its own partition of the examples, starting from the same solution,
+        /// and the epoch ends by averaging the partition solutions. The result depends on the number of threads, but not on
+        /// the order in which the threads run.
+        /// </summary>
         void Update() override;
 
         /// <summary> Gets the trained predictor. </summary>
@@ -97,6 +107,8 @@ namespace trainers
         using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
         void Step(TrainerExampleType& x);
+        double Step(const TrainerExampleType& example, double dual, math::ColumnVector<double>& v, double& d, predictors::LinearPredictor<double>& predictor) const;
+        void UpdateParallel();
         void ComputeObjectives();
         void ResizeTo(const data::AutoDataVector& x);
 
@@ -114,6 +126,8 @@ namespace trainers
         math::ColumnVector<double> _v;
         double _d = 0;
         math::RowVector<double> _a;
+
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
     };
 
     //
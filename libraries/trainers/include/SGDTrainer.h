@@ -16,12 +16,18 @@
 // data
 #include "Dataset.h"
 #include "Example.h"
+#include "IndexValue.h"
+
+// utilities
+#include "ThreadPool.h"
 
 // stl
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace ell
 {
@@ -32,6 +38,8 @@ namespace trainers
     {
         double regularization;
         std::string randomSeedString;
+        size_t numThreads = 1; // number of threads used by multithreaded epochs (0 means one per hardware thread); only SparseDataSGDTrainer supports values other than 1
+        size_t miniBatchSize = 0; // if nonzero, multithreaded epochs use deterministic synchronous mini-batches of this size instead of lock-free updates
     };
 
     /// <summary>
@@ -48,6 +56,12 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
+        /// <summary> Sets the trainer's dataset. A dataset of `AutoSupervisedExample`s held in memory is read in place,
+        /// through a permutation of the indices of its examples, rather than copied. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset, which must outlive the trainer's updates. </param>
+        void SetSharedDataset(const data::AnyDataset& anyDataset) override;
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         void Update() override;
 
@@ -63,9 +77,36 @@ namespace trainers
         virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
+        // visits the examples of a shared dataset in the order given by a list of their indices
+        class SharedExampleIterator
+        {
+        public:
+            SharedExampleIterator(const data::AutoSupervisedDataset& dataset, const std::vector<size_t>& order) : _dataset(dataset), _order(order) {}
+            bool IsValid() const { return _position < _order.size(); }
+            void Next() { ++_position; }
+            const data::AutoSupervisedExample& Get() const { return _dataset.GetExample(_order[_position]); }
+
+        private:
+            const data::AutoSupervisedDataset& _dataset;
+            const std::vector<size_t>& _order;
+            size_t _position = 0;
+        };
+
+        // permutes the examples of the shared dataset in the same way that Dataset::RandomPermute permutes a copy of it
+        SharedExampleIterator GetShuffledSharedExampleIterator();
+
         data::AutoSupervisedDataset _dataset;
+        const data::AutoSupervisedDataset* _sharedDataset = nullptr;
+        std::vector<size_t> _sharedOrder;
+        const data::MappedDataset* _mappedDataset = nullptr;
+        size_t _mappedFromIndex = 0;
+        size_t _mappedSize = 0;
         std::default_random_engine _random;
         bool _firstIteration = true;
+
+    private:
+        template <typename ExampleIteratorType>
+        void UpdateFromExamples(ExampleIteratorType& exampleIterator);
     };
 
     //
@@ -81,7 +122,7 @@ namespace trainers
     public:
         using SGDTrainerBase::PredictorType;
 
-        /// <summary> Constructs an SGD linear trainer. </summary>
+        /// <summary> Constructs an SGD linear trainer. Throws an exception if the parameters ask for more than one thread. </summary>
         ///
         /// <param name="lossFunction"> The loss function. </param>
         /// <param name="parameters"> The training parameters. </param>
@@ -131,6 +172,16 @@ namespace trainers
         /// <param name="parameters"> The training parameters. </param>
         SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters);
 
+        /// <summary>
+        /// Updates the state of the trainer by performing a learning epoch. If the trainer was constructed with more than one
+        /// thread, each thread processes its own partition of the (permuted) examples. By default the threads update the shared
+        /// weights without locking; if `miniBatchSize` is nonzero, the gradients of each mini-batch are instead computed in
+        /// parallel against the same weights and then applied in order, which makes the result independent of the thread count.
+        /// The threads work on one block of examples at a time, so only that block is held in sparse form; the lock-free
+        /// updates share one copy of the weights for the whole epoch.
+        /// </summary>
+        void Update() override;
+
         /// <summary> Returns a const reference to the last predictor. </summary>
         ///
         /// <returns> A const reference to the last predictor. </returns>
@@ -161,7 +212,36 @@ namespace trainers
         mutable PredictorType _lastPredictor;
         mutable PredictorType _averagedPredictor;
 
+        // nonzero entries of the block of training examples that a multithreaded epoch is working on
+        struct SparseExample
+        {
+            std::vector<data::IndexValue> entries;
+            double label;
+            double weight;
+        };
+        static constexpr size_t sparseExampleBlockSize = 1 << 16;
+        std::vector<SparseExample> _sparseExamples;
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
+
+        // the variables that the threads of a lock-free epoch update without locking
+        struct LockFreeState
+        {
+            LockFreeState(size_t numFeatures) : v(numFeatures), u(numFeatures) {}
+            std::vector<std::atomic<double>> v;
+            std::vector<std::atomic<double>> u;
+            std::atomic<double> a;
+            std::atomic<double> c;
+        };
+
         void ResizeTo(const data::AutoDataVector& x);
+        template <typename ExampleIteratorType>
+        void UpdateInBlocks(ExampleIteratorType& exampleIterator);
+        template <typename ExampleIteratorType>
+        void ReadSparseExamples(ExampleIteratorType& exampleIterator);
+        std::unique_ptr<LockFreeState> LoadLockFreeState() const;
+        void StoreLockFreeState(const LockFreeState& state);
+        void UpdateLockFree(LockFreeState& state);
+        void UpdateMiniBatch();
     };
 
     //
@@ -177,7 +257,7 @@ namespace trainers
     public:
         using SGDTrainerBase::PredictorType;
 
-        /// <summary> Constructs an instance of SparseDataCenteredSGDTrainer. </summary>
+        /// <summary> Constructs an instance of SparseDataCenteredSGDTrainer. Throws an exception if the parameters ask for more than one thread. </summary>
         ///
         /// <param name="lossFunction"> The loss function. </param>
         /// <param name="center"> The center (mean) of the training set. </param>
@@ -17,6 +17,9 @@
 // evaluators
 #include "Evaluator.h"
 
+// utilities
+#include "ThreadPool.h"
+
 //stl
 #include <memory>
 #include <random>
@@ -28,6 +31,19 @@ namespace ell
 {
 namespace trainers
 {
+    /// <summary> Statistics about one of the internal trainers of a SweepingTrainer. </summary>
+    struct SweepingTrainerRunStatistics
+    {
+        /// <summary> The time, in milliseconds, that the most recent update (training epoch plus evaluation) took. </summary>
+        double lastUpdateTime = 0;
+
+        /// <summary> The best goodness reported by the trainer's evaluator so far. </summary>
+        double bestGoodness = 0;
+
+        /// <summary> The number of updates performed so far. </summary>
+        size_t numUpdates = 0;
+    };
+
     /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
@@ -41,9 +57,12 @@ namespace trainers
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="numThreads"> The number of threads used to update the internal trainers concurrently. If 1, the
+        /// trainers are updated one after the other on the calling thread. If 0, uses the number of hardware threads. </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads = 1);
 
-        /// <summary> Sets the trainer's dataset. </summary>
+        /// <summary> Sets the trainer's dataset. The sweeping trainer keeps one copy of the dataset, which the internal
+        /// trainers share. </summary>
         ///
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
@@ -56,19 +75,29 @@ namespace trainers
         /// <returns> A const reference to the current predictor. </returns>
         const PredictorType& GetPredictor() const override;
 
+        /// <summary> Gets the statistics of each internal trainer, in the order the trainers were given. </summary>
+        ///
+        /// <returns> A vector of statistics, one per internal trainer. </returns>
+        const std::vector<SweepingTrainerRunStatistics>& GetRunStatistics() const { return _runStatistics; }
+
     private:
-        data::Dataset<ExampleType> _dataset;
+        void UpdateTrainer(size_t index);
+
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        std::vector<SweepingTrainerRunStatistics> _runStatistics;
+        data::Dataset<ExampleType> _dataset;
+        std::unique_ptr<utilities::ThreadPool> _threadPool;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="numThreads"> The number of threads used to update the internal trainers concurrently (0 means one per hardware thread). </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<SweepingTrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads = 1);
 }
 }
 
@@ -8,12 +8,20 @@
 #include "KMeansTrainer.h"
 
 // math
+#include "ElementwiseExpressions.h"
 #include "MatrixOperations.h"
 #include "VectorOperations.h"
 
+// utilities
+#include "Exception.h"
+#include "RandomEngines.h"
+
 // stl
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
+#include <numeric>
 
 namespace ell
 {
@@ -22,13 +30,89 @@ namespace trainers
     KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations)
         : _means(dim, numClusters), _isInitialized(false), _iterations(iterations), _numClusters(numClusters)  {}
 
+    namespace
+    {
+        // number of points whose distances are computed together when assigning points to means
+        const size_t assignmentBlockSize = 1024;
+
+        // samples an index with probability proportional to its weight, or uniformly if all the weights are zero
+        size_t SampleIndex(const std::vector<double>& weights, std::default_random_engine& random)
+        {
+            double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+            if (sum <= 0)
+            {
+                return std::uniform_int_distribution<size_t>(0, weights.size() - 1)(random);
+            }
+
+            double threshold = std::uniform_real_distribution<double>(0, sum)(random);
+            double cumulativeSum = 0;
+            for (size_t i = 0; i < weights.size(); ++i)
+            {
+                cumulativeSum += weights[i];
+                if (cumulativeSum >= threshold && weights[i] > 0)
+                {
+                    return i;
+                }
+            }
+            return weights.size() - 1;
+        }
+
+        std::vector<double> GetSquaredNorms(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means)
+        {
+            std::vector<double> norms(means.NumColumns());
+            for (size_t j = 0; j < means.NumColumns(); ++j)
+            {
+                norms[j] = means.GetColumn(j).Norm2Squared();
+            }
+            return norms;
+        }
+
+        double GetSquaredDistance(math::ConstColumnVectorReference<double> a, math::ConstColumnVectorReference<double> b)
+        {
+            double result = 0;
+            for (size_t i = 0; i < a.Size(); ++i)
+            {
+                double diff = a[i] - b[i];
+                result += diff * diff;
+            }
+            return result;
+        }
+    }
+
     KMeansTrainer::KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means)
         : _means(means), _isInitialized(true), _iterations(iters), _numClusters(numClusters) {}
 
+    KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations, const KMeansTrainerParameters& parameters)
+        : _parameters(parameters), _means(dim, numClusters), _isInitialized(false), _iterations(iterations), _numClusters(numClusters)
+    {
+        _random = utilities::GetRandomEngine(parameters.randomSeedString);
+        if (parameters.numThreads != 1)
+        {
+            _threadPool = std::make_shared<utilities::ThreadPool>(parameters.numThreads);
+        }
+    }
+
     void KMeansTrainer::RunKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
     {
+        if (X.NumColumns() == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "KMeans requires at least one point");
+        }
+
         if (false == _isInitialized)
-            initializeMeans(X);
+        {
+            if (_parameters.initialization == KMeansInitialization::kMeansParallel)
+                initializeMeansParallel(X);
+            else
+                initializeMeans(X);
+            _isInitialized = true;
+        }
+
+        if (_parameters.miniBatchSize > 0)
+        {
+            runMiniBatchKMeans(X);
+            return;
+        }
 
         math::ColumnVector<size_t> clusterAssignment(X.NumColumns());
         double prevDistance = 0.0;
@@ -40,6 +124,294 @@ namespace trainers
             recomputeMeans(X, clusterAssignment);
             prevDistance = totalDistance;
         }
+
+        _clusterAssignment.Resize(X.NumColumns());
+        for (size_t i = 0; i < X.NumColumns(); ++i)
+        {
+            _clusterAssignment[i] = static_cast<double>(clusterAssignment[i]);
+        }
+    }
+
+    void KMeansTrainer::runMiniBatchKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
+    {
+        // mini-batch k-means (Sculley, 2010): each mean moves toward the points assigned to it with a per-mean learning
+        // rate of 1/(number of points assigned to it so far)
+        // RunKMeans ensures there's at least one point, and mini-batch k-means only runs with a positive batch size
+        const size_t numPoints = X.NumColumns();
+        const size_t batchSize = std::min(_parameters.miniBatchSize, numPoints);
+        assert(batchSize > 0);
+        const size_t numBatches = (numPoints + batchSize - 1) / batchSize;
+
+        std::vector<size_t> batchOrder(numBatches);
+        std::iota(batchOrder.begin(), batchOrder.end(), 0);
+        std::vector<double> counts(_numClusters, 0.0);
+        std::vector<size_t> assignment(batchSize);
+        std::vector<double> distance(batchSize);
+
+        const size_t numThreads = _threadPool ? _threadPool->NumThreads() : 1;
+        const size_t subBlockSize = (batchSize + numThreads - 1) / numThreads;
+
+        double prevDistance = 0.0;
+        for (size_t iteration = 0; iteration < _iterations; ++iteration)
+        {
+            std::shuffle(batchOrder.begin(), batchOrder.end(), _random);
+
+            double totalDistance = 0;
+            for (auto batch : batchOrder)
+            {
+                const size_t begin = batch * batchSize;
+                const size_t end = std::min(begin + batchSize, numPoints);
+
+                // assign the batch to the current means
+                auto meanSquaredNorms = GetSquaredNorms(_means);
+                forEachBlock(end - begin, subBlockSize, [&](size_t blockBegin, size_t blockEnd) {
+                    assignBlock(X, begin + blockBegin, begin + blockEnd, _means, meanSquaredNorms, assignment.data() + blockBegin, distance.data() + blockBegin);
+                });
+
+                // move the means
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto cluster = assignment[i - begin];
+                    totalDistance += distance[i - begin];
+                    counts[cluster] += 1;
+                    double eta = 1.0 / counts[cluster];
+                    auto mean = _means.GetColumn(cluster);
+                    mean *= (1.0 - eta);
+                    mean += eta * X.GetColumn(i);
+                }
+            }
+
+            if (totalDistance == prevDistance)
+                break;
+            prevDistance = totalDistance;
+        }
+
+        // final assignment
+        std::vector<size_t> finalAssignment;
+        std::vector<double> finalDistance;
+        assignAll(X, _means, finalAssignment, finalDistance);
+        _clusterAssignment.Resize(numPoints);
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            _clusterAssignment[i] = static_cast<double>(finalAssignment[i]);
+        }
+    }
+
+    void KMeansTrainer::initializeMeansParallel(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
+    {
+        // k-means|| (Bahmani et al., 2012): oversample candidates in a few passes over the data, weight each candidate by
+        // the number of points closest to it, and then recluster the weighted candidates with k-means++
+        const size_t numPoints = X.NumColumns();
+        const size_t dim = X.NumRows();
+
+        std::vector<size_t> candidates{ std::uniform_int_distribution<size_t>(0, numPoints - 1)(_random) };
+        std::vector<double> distance(numPoints, std::numeric_limits<double>::max());
+        std::vector<size_t> closestCandidate(numPoints, 0);
+
+        // updates the distance from each point to its closest candidate, given candidates added from firstNew onward
+        auto updateDistances = [&](size_t firstNew) {
+            math::ColumnMatrix<double> newMeans(dim, candidates.size() - firstNew);
+            for (size_t j = firstNew; j < candidates.size(); ++j)
+            {
+                newMeans.GetColumn(j - firstNew).CopyFrom(X.GetColumn(candidates[j]));
+            }
+            auto newMeanSquaredNorms = GetSquaredNorms(newMeans);
+
+            forEachBlock(numPoints, assignmentBlockSize, [&](size_t begin, size_t end) {
+                std::vector<size_t> blockAssignment(end - begin);
+                std::vector<double> blockDistance(end - begin);
+                assignBlock(X, begin, end, newMeans, newMeanSquaredNorms, blockAssignment.data(), blockDistance.data());
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (blockDistance[i - begin] < distance[i])
+                    {
+                        distance[i] = blockDistance[i - begin];
+                        closestCandidate[i] = firstNew + blockAssignment[i - begin];
+                    }
+                }
+            });
+        };
+        updateDistances(0);
+
+        const double oversampling = _parameters.oversamplingFactor * _numClusters;
+        const size_t numBlocks = (numPoints + assignmentBlockSize - 1) / assignmentBlockSize;
+        for (size_t round = 0; round < _parameters.numInitializationRounds; ++round)
+        {
+            double cost = std::accumulate(distance.begin(), distance.end(), 0.0);
+            if (cost <= 0)
+                break;
+
+            // sample each point independently with probability proportional to its distance; each block gets its own
+            // random engine so that the result doesn't depend on the number of threads
+            std::vector<std::default_random_engine::result_type> seeds(numBlocks);
+            for (auto& seed : seeds)
+            {
+                seed = _random();
+            }
+            std::vector<std::vector<size_t>> blockSamples(numBlocks);
+            forEachBlock(numPoints, assignmentBlockSize, [&](size_t begin, size_t end) {
+                auto blockIndex = begin / assignmentBlockSize;
+                std::default_random_engine blockRandom(seeds[blockIndex]);
+                std::uniform_real_distribution<double> uniform(0, 1);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (uniform(blockRandom) < oversampling * distance[i] / cost)
+                    {
+                        blockSamples[blockIndex].push_back(i);
+                    }
+                }
+            });
+
+            auto firstNew = candidates.size();
+            for (const auto& samples : blockSamples)
+            {
+                candidates.insert(candidates.end(), samples.begin(), samples.end());
+            }
+            if (candidates.size() == firstNew)
+                break;
+            updateDistances(firstNew);
+        }
+
+        // weight each candidate by the number of points closest to it
+        const size_t numCandidates = candidates.size();
+        std::vector<double> weights(numCandidates, 0.0);
+        for (auto candidate : closestCandidate)
+        {
+            weights[candidate] += 1;
+        }
+
+        // recluster the weighted candidates with k-means++ seeding followed by a few weighted Lloyd iterations
+        std::vector<size_t> chosen;
+        std::vector<double> minimumDistance(numCandidates, std::numeric_limits<double>::max());
+        std::vector<double> sampleWeights(numCandidates);
+        for (size_t k = 0; k < _numClusters; ++k)
+        {
+            size_t choice;
+            if (k < numCandidates)
+            {
+                for (size_t c = 0; c < numCandidates; ++c)
+                {
+                    sampleWeights[c] = k == 0 ? weights[c] : weights[c] * minimumDistance[c];
+                }
+                choice = candidates[SampleIndex(sampleWeights, _random)];
+            }
+            else
+            {
+                // fewer candidates than clusters, so fill in with random points
+                choice = std::uniform_int_distribution<size_t>(0, numPoints - 1)(_random);
+            }
+            _means.GetColumn(k).CopyFrom(X.GetColumn(choice));
+
+            for (size_t c = 0; c < numCandidates; ++c)
+            {
+                minimumDistance[c] = std::min(minimumDistance[c], GetSquaredDistance(X.GetColumn(candidates[c]), _means.GetColumn(k)));
+            }
+        }
+
+        const size_t numReclusterIterations = 10;
+        math::ColumnMatrix<double> clusterSum(dim, _numClusters);
+        std::vector<double> clusterWeight(_numClusters);
+        for (size_t iteration = 0; iteration < numReclusterIterations && numCandidates > _numClusters; ++iteration)
+        {
+            clusterSum.Reset();
+            std::fill(clusterWeight.begin(), clusterWeight.end(), 0.0);
+            for (size_t c = 0; c < numCandidates; ++c)
+            {
+                auto x = X.GetColumn(candidates[c]);
+                size_t closest = 0;
+                double closestDistance = std::numeric_limits<double>::max();
+                for (size_t k = 0; k < _numClusters; ++k)
+                {
+                    double d = GetSquaredDistance(x, _means.GetColumn(k));
+                    if (d < closestDistance)
+                    {
+                        closestDistance = d;
+                        closest = k;
+                    }
+                }
+                clusterSum.GetColumn(closest) += weights[c] * x;
+                clusterWeight[closest] += weights[c];
+            }
+
+            for (size_t k = 0; k < _numClusters; ++k)
+            {
+                if (clusterWeight[k] > 0)
+                {
+                    clusterSum.GetColumn(k) /= clusterWeight[k];
+                    _means.GetColumn(k).CopyFrom(clusterSum.GetColumn(k));
+                }
+            }
+        }
+    }
+
+    double KMeansTrainer::assignBlock(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, size_t begin, size_t end, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means, const std::vector<double>& meanSquaredNorms, size_t* assignment, double* distance) const
+    {
+        // ||x - mu||^2 = ||x||^2 + ||mu||^2 - 2 * x'mu, with the inner products for the whole block computed at once
+        const size_t blockSize = end - begin;
+        const size_t k = means.NumColumns();
+        auto block = X.GetSubMatrix(0, begin, X.NumRows(), blockSize);
+        math::RowMatrix<double> innerProducts(blockSize, k);
+        math::MultiplyScaleAddUpdate(1.0, block.Transpose(), means, 0.0, innerProducts);
+
+        double totalDistance = 0;
+        for (size_t i = 0; i < blockSize; ++i)
+        {
+            size_t closest = 0;
+            double closestValue = std::numeric_limits<double>::max();
+            for (size_t j = 0; j < k; ++j)
+            {
+                double value = meanSquaredNorms[j] - 2.0 * innerProducts(i, j);
+                if (value < closestValue)
+                {
+                    closestValue = value;
+                    closest = j;
+                }
+            }
+
+            double d = std::max(0.0, block.GetColumn(i).Norm2Squared() + closestValue);
+            assignment[i] = closest;
+            distance[i] = d;
+            totalDistance += d;
+        }
+        return totalDistance;
+    }
+
+    double KMeansTrainer::assignAll(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means, std::vector<size_t>& assignment, std::vector<double>& distance)
+    {
+        const size_t numPoints = X.NumColumns();
+        assignment.resize(numPoints);
+        distance.resize(numPoints);
+        auto meanSquaredNorms = GetSquaredNorms(means);
+
+        std::vector<double> blockTotals((numPoints + assignmentBlockSize - 1) / assignmentBlockSize);
+        forEachBlock(numPoints, assignmentBlockSize, [&](size_t begin, size_t end) {
+            blockTotals[begin / assignmentBlockSize] = assignBlock(X, begin, end, means, meanSquaredNorms, assignment.data() + begin, distance.data() + begin);
+        });
+
+        // sum in a fixed order, so the result doesn't depend on the number of threads
+        return std::accumulate(blockTotals.begin(), blockTotals.end(), 0.0);
+    }
+
+    template <typename FunctionType>
+    void KMeansTrainer::forEachBlock(size_t numColumns, size_t blockSize, FunctionType&& blockFunction)
+    {
+        const size_t numBlocks = (numColumns + blockSize - 1) / blockSize;
+        auto runBlock = [&](size_t blockIndex) {
+            auto begin = blockIndex * blockSize;
+            blockFunction(begin, std::min(begin + blockSize, numColumns));
+        };
+
+        if (_threadPool && numBlocks > 1)
+        {
+            _threadPool->ParallelFor(numBlocks, runBlock);
+        }
+        else
+        {
+            for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                runBlock(blockIndex);
+            }
+        }
     }
 
     void KMeansTrainer::initializeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
@@ -81,51 +453,31 @@ namespace trainers
         auto n = X.NumColumns();
         auto k = means.NumColumns();
 
-        math::ColumnMatrix<double> xSq(X.NumRows(), n);
-        math::ElementwiseMultiplySet(X, X, xSq);
-
-        math::ColumnMatrix<double> muSq(means.NumRows(), k);
-        math::ElementwiseMultiplySet(means, means, muSq);
-
-        math::ColumnMatrix<double> xSqNorm(1, xSq.NumColumns());
-        math::ColumnwiseSum(xSq, xSqNorm.GetRow(0));
-
-        math::ColumnMatrix<double> muSqNorm(1, muSq.NumColumns());
-        math::ColumnwiseSum(muSq, muSqNorm.GetRow(0));
-
-        math::RowMatrix<double> onesMultiplier(k, 1);
-        onesMultiplier.Fill(1.0);
-        math::RowMatrix<double> distFactor1(k, n);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier, xSqNorm, 0.0, distFactor1);
-
-        math::ColumnMatrix<double> onesMultiplier1 = math::ColumnMatrix<double>(n, 1);
-        onesMultiplier1.Fill(1.0);
-        math::ColumnMatrix<double> distFactor2(n, k);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier1, muSqNorm, 0.0, distFactor2);
-
-        math::RowMatrix<double> muX(n, k);
-        math::MultiplyScaleAddUpdate(1.0, X.Transpose(), means, 1.0, muX);
-
-        math::ColumnMatrix<double> tempD(n, k);
-        math::ScaleAddSet(1.0, distFactor1.Transpose(), -2.0, muX, tempD);
+        math::RowVector<double> meanSquaredNorms(k);
+        for (size_t j = 0; j < k; ++j)
+        {
+            meanSquaredNorms[j] = means.GetColumn(j).Norm2Squared();
+        }
 
-        math::ColumnMatrix<double> distance(n, k);
-        math::ScaleAddSet(1.0, tempD, 1.0, distFactor2, distance);
+        // distance = -2 * X' * means, followed by a single fused pass that adds the squared norms to each row
+        math::RowMatrix<double> distance(n, k);
+        math::MultiplyScaleAddUpdate(-2.0, X.Transpose(), means, 0.0, distance);
+        for (size_t i = 0; i < n; ++i)
+        {
+            distance.GetRow(i) += meanSquaredNorms + X.GetColumn(i).Norm2Squared();
+        }
 
         return distance;
     }
 
     double KMeansTrainer::assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment)
     {
-        auto D = pairwiseDistance(X, _means);
-
-        double totalDist = 0;
-        for (size_t i = 0; i < D.NumRows(); ++i)
+        std::vector<size_t> assignment;
+        std::vector<double> distance;
+        auto totalDist = assignAll(X, _means, assignment, distance);
+        for (size_t i = 0; i < assignment.size(); ++i)
         {
-            auto dist = D.GetRow(i);
-            auto minElement = std::min_element(dist.GetDataPointer(), dist.GetDataPointer() + dist.Size());
-            clusterAssignment[i] = minElement - dist.GetDataPointer();
-            totalDist += *minElement;
+            clusterAssignment[i] = assignment[i];
         }
 
         return totalDist;
@@ -144,10 +496,13 @@ namespace trainers
 
         for (size_t i = 0; i < _numClusters; i++)
         {
-            clusterSum.GetColumn(i) /= numPointsPerCluster[i];
+            // keep the previous mean of an empty cluster
+            if (numPointsPerCluster[i] > 0)
+            {
+                clusterSum.GetColumn(i) /= numPointsPerCluster[i];
+                _means.GetColumn(i).CopyFrom(clusterSum.GetColumn(i));
+            }
         }
-
-        _means.CopyFrom(clusterSum);
     }
 
     size_t KMeansTrainer::weightedSample(math::ColumnVector<double> weights)
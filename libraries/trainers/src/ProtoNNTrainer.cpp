@@ -11,7 +11,9 @@
 #include "ProtoNNTrainerUtils.h"
 
 // math
+#include "ElementwiseExpressions.h"
 #include "MatrixOperations.h"
+#include "Transformations.h"
 #include "Vector.h"
 
 // data
@@ -94,7 +96,15 @@ void ProtoNNTrainer::Initialize()
     math::ColumnMatrix<double> WX(W.NumRows(), n);
     math::MultiplyScaleAddUpdate(1.0, W, _X, 0.0, WX);
 
-    ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel);
+    KMeansTrainerParameters kMeansParameters;
+    kMeansParameters.miniBatchSize = _parameters.kMeansMiniBatchSize;
+    if (_parameters.kMeansParallelInitialization)
+    {
+        kMeansParameters.initialization = KMeansInitialization::kMeansParallel;
+        kMeansParameters.numThreads = 0;
+    }
+
+    ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel, kMeansParameters);
     protonnInit.Initialize(WX, _Y);
 
     math::ColumnMatrix<double> B = protonnInit.GetPrototypeMatrix();
@@ -155,47 +165,24 @@ math::ColumnMatrix<double> ProtoNNTrainer::SimilarityKernel(ConstColumnMatrixRef
     }
 
     // full(sum(B. ^ 2, 1));
-    math::ColumnMatrix<double> bSquare(B.NumRows(), B.NumColumns());
-    math::ElementwiseMultiplySet(B, B, bSquare);
-
-    math::ColumnMatrix<double> bColNormSquare(1, bSquare.NumColumns());
-    math::ColumnwiseSum(bSquare, bColNormSquare.GetRow(0));
-
-    // full(sum(WX. ^ 2, 1));
-    math::ColumnMatrix<double> wxSquare(wx.NumRows(), wx.NumColumns());
-    math::ElementwiseMultiplySet(wx, wx, wxSquare);
-
-    math::ColumnMatrix<double> wxColNormSquare(1, wxSquare.NumColumns());
-    math::ColumnwiseSum(wxSquare, wxColNormSquare.GetRow(0));
-
-    // wxb = (2.0 * gamma * gamma) * WX.transpose() * B;
-    math::RowMatrix<double> wxb(wx.NumColumns(), B.NumColumns());
-    math::MultiplyScaleAddUpdate(2 * gamma * gamma, wx.Transpose(), B, 0.0, wxb);
-
-    // repmat of bColNormSquare and scaling by -gamma * gamma
-    math::RowMatrix<double> gammaSquareCol(end - begin, 1);
-    gammaSquareCol.Fill(-gamma * gamma);
-    math::RowMatrix<double> bColNormSquareResized(gammaSquareCol.NumRows(), bColNormSquare.NumColumns());
-    // S1 = gammaSquareCol * bColSum;
-    math::MultiplyScaleAddUpdate(1.0, gammaSquareCol, bColNormSquare, 0.0, bColNormSquareResized);
-
-    // repmat of wxColNormSquare and scaling by -gamma * gamma
-    math::RowMatrix<double> gammaSquareRow(B.NumColumns(), 1);
-    gammaSquareRow.Fill(-gamma * gamma);
-    math::RowMatrix<double> wxColNormSquareResized(gammaSquareRow.NumRows(), wxColNormSquare.NumColumns());
-    // S2 = gammaSquareRow * wxColSum;
-    math::MultiplyScaleAddUpdate(1.0, gammaSquareRow, wxColNormSquare, 0.0, wxColNormSquareResized);
-
-    // D = wxb + bColNormSquareResized
-    math::RowMatrix<double> similarityMatrix(wxb.NumRows(), wxb.NumColumns());
-    math::ScaleAddSet(1.0, wxb, 1.0, bColNormSquareResized, similarityMatrix);
+    math::RowVector<double> bColNormSquare(B.NumColumns());
+    for (size_t j = 0; j < B.NumColumns(); j++)
+    {
+        bColNormSquare[j] = B.GetColumn(j).Norm2Squared();
+    }
 
-    // D = D + wxColNormSquareResized'
-    math::RowMatrix<double> distance(similarityMatrix.NumRows(), similarityMatrix.NumColumns());
-    math::ScaleAddSet(1.0, similarityMatrix, 1.0, wxColNormSquareResized.Transpose(), distance);
+    // similarityMatrix = (2.0 * gamma * gamma) * WX.transpose() * B;
+    math::RowMatrix<double> similarityMatrix(wx.NumColumns(), B.NumColumns());
+    math::MultiplyScaleAddUpdate(2 * gamma * gamma, wx.Transpose(), B, 0.0, similarityMatrix);
 
-    // similarityMatrix = exp(D)
-    similarityMatrix = ProtoNNTrainerUtils::MatrixExp(distance);
+    // similarityMatrix = exp(similarityMatrix - gamma * gamma * (||B||^2 + ||WX||^2)), one fused pass per row
+    const double gammaSquare = gamma * gamma;
+    for (size_t i = 0; i < similarityMatrix.NumRows(); i++)
+    {
+        auto row = similarityMatrix.GetRow(i);
+        auto distance = row - gammaSquare * (bColNormSquare + wx.GetColumn(i).Norm2Squared());
+        math::Evaluate(math::ElementwiseTransform(distance, math::ExponentTransformation<double>), row);
+    }
 
     return similarityMatrix;
 }
@@ -211,28 +198,20 @@ double ProtoNNTrainer::Loss(ConstColumnMatrixReference Y, ConstColumnMatrixRefer
 
     auto Z = (_modelMap[ProtoNNParameterIndex::Z])->GetData();
 
-    // residual = y - ZD'
-    math::ColumnMatrix<double> ZD(Z.NumRows(), D.NumRows());
-    math::MultiplyScaleAddUpdate(1.0, Z, D.Transpose(), 0.0, ZD);
+    // residual = y - ZD', computed in place of ZD
+    math::ColumnMatrix<double> residual(Z.NumRows(), D.NumRows());
+    math::MultiplyScaleAddUpdate(1.0, Z, D.Transpose(), 0.0, residual);
     auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin);
-    math::ColumnMatrix<double> residual(y.NumRows(), y.NumColumns());
-    math::ScaleAddSet(1.0, y, -1.0, ZD, residual);
 
     switch (_parameters.lossFunction)
     {
     case ProtoNNLossFunction::L2:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // diff .* 2
-            residual.GetColumn(j).Transform([](double x) { return x * x; });
-        }
+        // diff .^ 2
+        math::Evaluate(math::ElementwiseTransform(y - residual, [](double x) { return x * x; }), residual);
         break;
     case ProtoNNLossFunction::L4:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // diff .* 4
-            residual.GetColumn(j).Transform([](double x) { return x * x * x * x; });
-        }
+        // diff .^ 4
+        math::Evaluate(math::ElementwiseTransform(y - residual, [](double x) { return x * x * x * x; }), residual);
         break;
     }
 
@@ -305,6 +284,7 @@ void ProtoNNTrainer::AcceleratedProximalGradient(
     math::ColumnMatrix<double> gradient_paramS(param.NumRows(), param.NumColumns());
     math::ColumnMatrix<double> paramQ(param.NumRows(), param.NumColumns());
 
+    math::ColumnMatrix<double> paramQ_new(param.NumRows(), param.NumColumns());
     math::ColumnMatrix<double> paramS(param.NumRows(), param.NumColumns());
 
     paramQ.CopyFrom(param);
@@ -346,30 +326,22 @@ void ProtoNNTrainer::AcceleratedProximalGradient(
 
         gradient_paramS = gradf(paramS, idx1, idx2);
 
-        math::ColumnMatrix<double> paramQ_new(paramS.NumRows(), paramS.NumColumns());
-        math::ScaleAddSet(1.0, paramS, -stepSize, gradient_paramS, paramQ_new); //paramQ_new=paramS-stepSize*grad(paramS)
+        math::Evaluate(paramS - stepSize * gradient_paramS, paramQ_new); //paramQ_new=paramS-stepSize*grad(paramS)
 
         prox(paramQ_new); //paramQ_new = HardThresholding(paramQ_new)
 
-        math::ColumnMatrix<double> paramS_new(paramQ_new.NumRows(), paramQ_new.NumColumns());
-        math::ScaleAddSet(1 - alpha, paramQ_new, alpha, paramQ, paramS_new);
-
         // paramS_new = (1-alpha)*paramQ_new+alpha*paramQ; paramS=paramS_new
-        paramS.CopyFrom(paramS_new);
+        math::Evaluate((1 - alpha) * paramQ_new + alpha * paramQ, paramS);
 
         double runningAvgWeight = ((t - burn_period) > 1) ? (t - burn_period) : 1.0; //runningAvgWeight
         assert(runningAvgWeight >= 0.999999);
 
         //Running average of all but first burn_period paramS's; paramAvg_new=(1-1/runningAvgWeight)*paramAvg+ 1/runningAvgWeight*paramS_new
-        math::ColumnMatrix<double> paramAvg_new(paramS_new.NumRows(), paramS_new.NumColumns());
-        math::ScaleAddSet(safe_div(1.0, runningAvgWeight), paramS_new, safe_div(runningAvgWeight - 1.0, runningAvgWeight), paramAvg, paramAvg_new);
+        math::Evaluate(safe_div(1.0, runningAvgWeight) * paramS + safe_div(runningAvgWeight - 1.0, runningAvgWeight) * paramAvg, paramAvg);
 
         //Initializing parameters for next iteration
         lambda = lambda_new;
-        paramQ = paramQ_new;
-
-        paramS.CopyFrom(paramS_new);
-        paramAvg.CopyFrom(paramAvg_new);
+        paramQ.CopyFrom(paramQ_new);
     }
 
     param.CopyFrom(paramAvg);
@@ -526,30 +498,19 @@ math::ColumnMatrix<double> Param_W::gradient(ProtoNNModelMap& modelMap, ConstCol
 
     auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
 
-    math::ColumnMatrix<double> DZ(D.NumRows(), Z.NumRows());
-    math::MultiplyScaleAddUpdate(1.0, D, Z.Transpose(), 0.0, DZ);
-
-    //diff = Y - D*Z';
-    math::RowMatrix<double> residual(y.NumRows(), y.NumColumns());
-    math::ScaleAddSet(1.0, y, -1.0, DZ, residual);
+    //diff = Y - D*Z', computed in place of D*Z' = (Z*D')'
+    math::RowMatrix<double> residual(D.NumRows(), Z.NumRows());
+    math::MultiplyScaleAddUpdate(1.0, Z, D.Transpose(), 0.0, residual.Transpose());
 
     switch (lossType)
     {
     case ProtoNNLossFunction::L2:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // 4 * gamma * gamma * diff
-            double multiplication_scalar = 4.0 * gamma * gamma;
-            residual.GetColumn(j).Transform([multiplication_scalar](double x) { return multiplication_scalar * x; });
-        }
+        // 4 * gamma * gamma * diff
+        math::Evaluate((4.0 * gamma * gamma) * (y - residual), residual);
         break;
     case ProtoNNLossFunction::L4:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // 8 * gamma * gamma * diff
-            double multiplication_scalar = 8.0 * gamma * gamma;
-            residual.GetColumn(j).Transform([multiplication_scalar](double x) { return multiplication_scalar * x * x * x; });
-        }
+        // 8 * gamma * gamma * diff .^ 3
+        math::Evaluate((8.0 * gamma * gamma) * math::ElementwiseTransform(y - residual, [](double x) { return x * x * x; }), residual);
         break;
     }
 
@@ -604,26 +565,24 @@ math::ColumnMatrix<double> Param_Z::gradient(ProtoNNModelMap& modelMap, ConstCol
     auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin);
 
     // ZD = Z * D'
-    math::ColumnMatrix<double> ZD(Z.NumRows(), Similarity.NumRows());
-    math::MultiplyScaleAddUpdate(1.0, Z, Similarity.Transpose(), 0.0, ZD);
-
-    // yMinusZD = y - ZD'
-    math::ColumnMatrix<double> residual(y.NumRows(), y.NumColumns());
-    math::ScaleAddSet(1.0, y, -1.0, ZD, residual);
+    math::ColumnMatrix<double> residual(Z.NumRows(), Similarity.NumRows());
+    math::MultiplyScaleAddUpdate(1.0, Z, Similarity.Transpose(), 0.0, residual);
 
     math::ColumnMatrix<double> gradient(residual.NumRows(), Similarity.NumColumns());
     switch (lossType)
     {
     case ProtoNNLossFunction::L2:
+        // yMinusZD = y - ZD'
+        math::Evaluate(y - residual, residual);
+
         // gradient_paramS = -2 * yMinusZD * D
         math::MultiplyScaleAddUpdate(-2.0, residual, Similarity, 0.0, gradient);
         break;
 
     case ProtoNNLossFunction::L4:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            residual.GetColumn(j).Transform([](double x) { return x * x * x; });
-        }
+        // yMinusZD .^ 3
+        math::Evaluate(math::ElementwiseTransform(y - residual, [](double x) { return x * x * x; }), residual);
+
         // gradient_paramS = -4 * (yMinusZD .^ 3) * D
         math::MultiplyScaleAddUpdate(-4.0, residual, Similarity, 0.0, gradient);
         break;
@@ -652,31 +611,19 @@ math::ColumnMatrix<double> Param_B::gradient(ProtoNNModelMap& modelMap, ConstCol
 
     auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
     auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), end - begin);
-    math::ColumnMatrix<double> DZ(Similarity.NumRows(), Z.NumRows());
-    math::MultiplyScaleAddUpdate(1.0, Similarity, Z.Transpose(), 0.0, DZ);
-
-    // residual = y - D*Z';
-    math::RowMatrix<double> residual(y.NumRows(), y.NumColumns());
-    math::ScaleAddSet(1.0, y, -1.0, DZ, residual);
+    // residual = y - D*Z', computed in place of D*Z' = (Z*D')'
+    math::RowMatrix<double> residual(Similarity.NumRows(), Z.NumRows());
+    math::MultiplyScaleAddUpdate(1.0, Z, Similarity.Transpose(), 0.0, residual.Transpose());
 
     switch (lossType)
     {
     case ProtoNNLossFunction::L2:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // 4 * gamma * gamma * diff
-            double multScalar = 4.0 * gamma * gamma;
-            residual.GetColumn(j).Transform([multScalar](double x) { return multScalar * x; });
-        }
+        // 4 * gamma * gamma * diff
+        math::Evaluate((4.0 * gamma * gamma) * (y - residual), residual);
         break;
     case ProtoNNLossFunction::L4:
-        for (size_t j = 0; j < residual.NumColumns(); j++)
-        {
-            // 8 * gamma * gamma * diff
-            double multScalar = 8.0 * gamma * gamma;
-            residual.GetColumn(j).Transform([multScalar](double x) { return multScalar * x * x * x; });
-        }
-
+        // 8 * gamma * gamma * diff .^ 3
+        math::Evaluate((8.0 * gamma * gamma) * math::ElementwiseTransform(y - residual, [](double x) { return x * x * x; }), residual);
         break;
     }
 
@@ -8,6 +8,11 @@
 
 #include "SGDTrainer.h"
 
+// stl
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
 namespace ell
 {
 namespace trainers
@@ -15,17 +20,83 @@ namespace trainers
 
     void SGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
     {
+        _sharedDataset = nullptr;
+        _sharedOrder.clear();
+
+        // a memory-mapped dataset is streamed from its file in each epoch, rather than copied into memory
+        _mappedDataset = anyDataset.GetMappedDataset();
+        if (_mappedDataset != nullptr)
+        {
+            _mappedFromIndex = anyDataset.FromIndex();
+            _mappedSize = anyDataset.NumExamples();
+            _dataset.Reset();
+            return;
+        }
         _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
     }
 
+    void SGDTrainerBase::SetSharedDataset(const data::AnyDataset& anyDataset)
+    {
+        auto sharedDataset = anyDataset.GetInMemoryDataset<data::AutoSupervisedExample>();
+        if (sharedDataset == nullptr)
+        {
+            SetDataset(anyDataset);
+            return;
+        }
+
+        _mappedDataset = nullptr;
+        _dataset.Reset();
+        _sharedDataset = sharedDataset;
+
+        // a size of zero means all the examples to the end of the dataset
+        auto fromIndex = std::min(anyDataset.FromIndex(), sharedDataset->NumExamples());
+        auto size = anyDataset.NumExamples();
+        if (size == 0 || fromIndex + size > sharedDataset->NumExamples())
+        {
+            size = sharedDataset->NumExamples() - fromIndex;
+        }
+        _sharedOrder.resize(size);
+        std::iota(_sharedOrder.begin(), _sharedOrder.end(), fromIndex);
+    }
+
     void SGDTrainerBase::Update()
     {
+        if (_mappedDataset != nullptr)
+        {
+            // visit the examples in a random order, reading the file one block of examples at a time
+            auto exampleIterator = _mappedDataset->GetShuffledExampleIterator(_random, _mappedFromIndex, _mappedSize);
+            UpdateFromExamples(exampleIterator);
+            return;
+        }
+
+        if (_sharedDataset != nullptr)
+        {
+            auto exampleIterator = GetShuffledSharedExampleIterator();
+            UpdateFromExamples(exampleIterator);
+            return;
+        }
+
         // permute the data
         _dataset.RandomPermute(_random);
 
         // get example iterator
         auto exampleIterator = _dataset.GetExampleReferenceIterator();
+        UpdateFromExamples(exampleIterator);
+    }
 
+    SGDTrainerBase::SharedExampleIterator SGDTrainerBase::GetShuffledSharedExampleIterator()
+    {
+        for (size_t i = 0; i < _sharedOrder.size(); ++i)
+        {
+            std::uniform_int_distribution<size_t> dist(i, _sharedOrder.size() - 1);
+            std::swap(_sharedOrder[i], _sharedOrder[dist(_random)]);
+        }
+        return SharedExampleIterator(*_sharedDataset, _sharedOrder);
+    }
+
+    template <typename ExampleIteratorType>
+    void SGDTrainerBase::UpdateFromExamples(ExampleIteratorType& exampleIterator)
+    {
         // first iteration handled separately
         if (_firstIteration && exampleIterator.IsValid())
         {
@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedHistogramForestTrainer.tcc (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <limits>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename LossFunctionType, typename BoosterType>
+    BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::BinnedHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedHistogramForestTrainerParameters& parameters)
+        : ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>(booster, parameters), _lossFunction(lossFunction), _maxBinsPerFeature(parameters.maxBinsPerFeature)
+    {
+        if (_maxBinsPerFeature < 2 || _maxBinsPerFeature > static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "maxBinsPerFeature must be between 2 and 65536");
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetDataset(anyDataset);
+        QuantizeFeatures();
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    {
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+
+        auto histogram = GetNodeHistogram(range);
+
+        // scan the bins of each feature, moving one bin at a time from the right child to the left child
+        size_t bestSize0 = 0;
+        Sums bestSums0;
+        for (size_t featureIndex = 0; featureIndex < _thresholds.size(); ++featureIndex)
+        {
+            const auto& thresholds = _thresholds[featureIndex];
+            const auto* featureHistogram = histogram.data() + _histogramOffsets[featureIndex];
+
+            Sums sums0;
+            size_t size0 = 0;
+            for (size_t binIndex = 0; binIndex < thresholds.size(); ++binIndex)
+            {
+                const auto& binStats = featureHistogram[binIndex];
+                sums0.sumWeights += binStats.sumWeights;
+                sums0.sumWeightedLabels += binStats.sumWeightedLabels;
+                size0 += binStats.count;
+
+                if (size0 == 0 || size0 == range.size || binStats.count == 0)
+                {
+                    continue;
+                }
+
+                Sums sums1 = sums - sums0;
+                double gain = CalculateGain(sums, sums0, sums1);
+
+                // find gain maximizer
+                if (gain > bestSplitCandidate.gain)
+                {
+                    bestSplitCandidate.gain = gain;
+                    bestSplitCandidate.splitRule = SplitRuleType{ featureIndex, thresholds[binIndex] };
+                    bestSums0 = sums0;
+                    bestSize0 = size0;
+                }
+            }
+        }
+
+        if (bestSplitCandidate.gain > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+            bestSplitCandidate.stats.SetChildSums({ bestSums0, sums - bestSums0 });
+
+            // keep the histogram if the node may be split, so that its children can use it
+            if (bestSplitCandidate.gain >= _parameters.minSplitGain)
+            {
+                _histogramCache[range.firstIndex] = CachedHistogram{ range, std::move(histogram) };
+            }
+        }
+
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::GetEdgePredictors(const NodeStats& nodeStats) -> std::vector<EdgePredictorType>
+    {
+        double output = nodeStats.GetTotalSums().GetMeanLabel();
+        double output0 = nodeStats.GetChildSums(0).GetMeanLabel() - output;
+        double output1 = nodeStats.GetChildSums(1).GetMeanLabel() - output;
+        return std::vector<EdgePredictorType>{ output0, output1 };
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::QuantizeFeatures()
+    {
+        auto numExamples = _dataset.NumExamples();
+        size_t numFeatures = 0;
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            numFeatures = std::max(numFeatures, _dataset[rowIndex].GetDataVector().PrefixLength());
+        }
+
+        bool useBins8 = _maxBinsPerFeature <= static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1;
+        _bins8.assign(useBins8 ? numFeatures * numExamples : 0, 0);
+        _bins16.assign(useBins8 ? 0 : numFeatures * numExamples, 0);
+        _thresholds.assign(numFeatures, {});
+        _histogramOffsets.assign(numFeatures + 1, 0);
+        _histogramCache.clear();
+
+        std::vector<float> values(numExamples);
+        std::vector<float> sortedValues;
+        for (size_t featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+        {
+            // gather the feature's values, in the order of the examples' original indices
+            for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+            {
+                const auto& example = _dataset[rowIndex];
+                const auto& dataVector = example.GetDataVector();
+                values[example.GetMetadata().exampleIndex] = featureIndex < dataVector.PrefixLength() ? dataVector[featureIndex] : 0.0f;
+            }
+
+            sortedValues = values;
+            std::sort(sortedValues.begin(), sortedValues.end());
+
+            // place the thresholds between distinct values, so that each bin holds about the same number of examples. If
+            // there are few enough distinct values, each one gets its own bin.
+            auto& thresholds = _thresholds[featureIndex];
+            size_t numDistinctValues = numExamples > 0 ? 1 : 0;
+            for (size_t index = 1; index < numExamples; ++index)
+            {
+                numDistinctValues += sortedValues[index] != sortedValues[index - 1] ? 1 : 0;
+            }
+            double examplesPerBin = numDistinctValues <= _maxBinsPerFeature ? 0.0 : static_cast<double>(numExamples) / _maxBinsPerFeature;
+            for (size_t index = 0; index + 1 < numExamples && thresholds.size() + 1 < _maxBinsPerFeature; ++index)
+            {
+                if (sortedValues[index] != sortedValues[index + 1] && index + 1 >= examplesPerBin * (thresholds.size() + 1))
+                {
+                    thresholds.push_back(0.5 * (static_cast<double>(sortedValues[index]) + static_cast<double>(sortedValues[index + 1])));
+                }
+            }
+            _histogramOffsets[featureIndex + 1] = _histogramOffsets[featureIndex] + thresholds.size() + 1;
+
+            // an example goes to the bin after the last threshold below its value, which matches SingleElementThresholdPredictor
+            for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+            {
+                auto bin = std::lower_bound(thresholds.begin(), thresholds.end(), static_cast<double>(values[exampleIndex])) - thresholds.begin();
+                auto binIndex = featureIndex * numExamples + exampleIndex;
+                if (useBins8)
+                {
+                    _bins8[binIndex] = static_cast<uint8_t>(bin);
+                }
+                else
+                {
+                    _bins16[binIndex] = static_cast<uint16_t>(bin);
+                }
+            }
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::GetNodeHistogram(Range range) -> Histogram
+    {
+        // a new boosting round starts at the root, and the histograms of the previous round are stale
+        if (range.firstIndex == 0 && range.size == _dataset.NumExamples())
+        {
+            _histogramCache.clear();
+            return BuildHistogram(range);
+        }
+
+        // the children of a split node are visited in order, so the first child shares its first index with its parent
+        auto iter = _histogramCache.find(range.firstIndex);
+        if (iter == _histogramCache.end() || iter->second.range.size < range.size)
+        {
+            return BuildHistogram(range);
+        }
+
+        auto cached = std::move(iter->second);
+        _histogramCache.erase(iter);
+        if (cached.range.size == range.size)
+        {
+            return std::move(cached.histogram);
+        }
+
+        // build the histogram of the smaller child from its examples, and get the other one by subtraction
+        Range siblingRange{ range.firstIndex + range.size, cached.range.size - range.size };
+        Histogram histogram;
+        Histogram siblingHistogram;
+        if (range.size <= siblingRange.size)
+        {
+            histogram = BuildHistogram(range);
+            siblingHistogram = SubtractHistograms(cached.histogram, histogram);
+        }
+        else
+        {
+            siblingHistogram = BuildHistogram(siblingRange);
+            histogram = SubtractHistograms(cached.histogram, siblingHistogram);
+        }
+        _histogramCache[siblingRange.firstIndex] = CachedHistogram{ siblingRange, std::move(siblingHistogram) };
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::BuildHistogram(Range range) const -> Histogram
+    {
+        Histogram histogram(_histogramOffsets.back());
+        if (_bins16.empty())
+        {
+            AccumulateHistogram(_bins8, range, histogram);
+        }
+        else
+        {
+            AccumulateHistogram(_bins16, range, histogram);
+        }
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::SubtractHistograms(const Histogram& histogram, const Histogram& other) const -> Histogram
+    {
+        Histogram difference(histogram.size());
+        for (size_t index = 0; index < histogram.size(); ++index)
+        {
+            difference[index].sumWeights = histogram[index].sumWeights - other[index].sumWeights;
+            difference[index].sumWeightedLabels = histogram[index].sumWeightedLabels - other[index].sumWeightedLabels;
+            difference[index].count = histogram[index].count - other[index].count;
+        }
+        return difference;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    template <typename BinType>
+    void BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::AccumulateHistogram(const std::vector<BinType>& bins, Range range, Histogram& histogram) const
+    {
+        // gather the weak weights and labels of the node's examples once, then stream through the bins of each feature
+        std::vector<size_t> exampleIndices(range.size);
+        std::vector<double> weights(range.size);
+        std::vector<double> weightedLabels(range.size);
+        for (size_t index = 0; index < range.size; ++index)
+        {
+            const auto& metadata = _dataset[range.firstIndex + index].GetMetadata();
+            exampleIndices[index] = metadata.exampleIndex;
+            weights[index] = metadata.weak.weight;
+            weightedLabels[index] = metadata.weak.weight * metadata.weak.label;
+        }
+
+        auto numExamples = _dataset.NumExamples();
+        for (size_t featureIndex = 0; featureIndex < _thresholds.size(); ++featureIndex)
+        {
+            const auto* featureBins = bins.data() + featureIndex * numExamples;
+            auto* featureHistogram = histogram.data() + _histogramOffsets[featureIndex];
+            for (size_t index = 0; index < range.size; ++index)
+            {
+                auto& binStats = featureHistogram[featureBins[exampleIndices[index]]];
+                binStats.sumWeights += weights[index];
+                binStats.sumWeightedLabels += weightedLabels[index];
+                ++binStats.count;
+            }
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    double BinnedHistogramForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
+    {
+        if (sums0.sumWeights <= 0 || sums1.sumWeights <= 0)
+        {
+            return 0;
+        }
+
+        return sums0.sumWeights * _lossFunction.BregmanGenerator(sums0.sumWeightedLabels / sums0.sumWeights) +
+               sums1.sumWeights * _lossFunction.BregmanGenerator(sums1.sumWeightedLabels / sums1.sumWeights) -
+               sums.sumWeights * _lossFunction.BregmanGenerator(sums.sumWeightedLabels / sums.sumWeights);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedHistogramForestTrainerParameters& parameters)
+    {
+        return std::make_unique<BinnedHistogramForestTrainer<LossFunctionType, BoosterType>>(lossFunction, booster, parameters);
+    }
+}
+}
@@ -29,6 +29,12 @@ namespace trainers
         _internalTrainer->SetDataset(anyDataset);
     }
 
+    template <typename PredictorType>
+    void EvaluatingTrainer<PredictorType>::SetSharedDataset(const data::AnyDataset& anyDataset)
+    {
+        _internalTrainer->SetSharedDataset(anyDataset);
+    }
+
     template <typename PredictorType>
     void EvaluatingTrainer<PredictorType>::Update()
     {
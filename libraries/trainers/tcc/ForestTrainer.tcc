@@ -33,6 +33,7 @@ namespace trainers
             auto& metadata = example.GetMetadata();
             metadata.currentOutput = prediction;
             metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, prediction);
+            metadata.exampleIndex = rowIndex;
         }
     }
 
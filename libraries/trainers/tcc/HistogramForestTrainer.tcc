@@ -41,6 +41,7 @@ namespace trainers
             {
                 bestSplitCandidate.gain = gain;
                 bestSplitCandidate.splitRule = splitRuleCandidate;
+                bestSplitCandidate.ranges = ForestTrainerBase::NodeRanges(range);
                 bestSplitCandidate.ranges.SplitChildRange(0, size0);
                 bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
             }
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MultiClassSGDTrainer.tcc (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// data
+#include "MappedDataset.h"
+#include "SparseDataVector.h"
+
+// math
+#include "MatrixOperations.h"
+#include "VectorOperations.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+
+namespace ell
+{
+namespace trainers
+{
+    // the code in this file follows the notation and pseudocode in https://arxiv.org/abs/1612.09147, applied to all the
+    // classes at once
+
+    template <typename LossFunctionType>
+    MultiClassSGDTrainer<LossFunctionType>::MultiClassSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
+        : _lossFunction(lossFunction), _parameters(parameters), _v(0, 0), _u(0, 0)
+    {
+        std::seed_seq seed(parameters.randomSeedString.begin(), parameters.randomSeedString.end());
+        _random = std::default_random_engine(seed);
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        ResetDataset();
+        _mappedDataset = anyDataset.GetMappedDataset();
+        if (_mappedDataset != nullptr)
+        {
+            _mappedFromIndex = anyDataset.FromIndex();
+            _mappedSize = anyDataset.NumExamples();
+        }
+        else
+        {
+            _dataset = anyDataset.GetInMemoryDataset<data::AutoSupervisedExample>();
+            if (_dataset == nullptr)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "MultiClassSGDTrainer reads its dataset in place, so it must be a memory-mapped dataset or an in-memory dataset of AutoSupervisedExamples");
+            }
+
+            // a size of zero means all the examples to the end of the dataset
+            auto fromIndex = std::min(anyDataset.FromIndex(), _dataset->NumExamples());
+            auto size = anyDataset.NumExamples();
+            if (size == 0 || fromIndex + size > _dataset->NumExamples())
+            {
+                size = _dataset->NumExamples() - fromIndex;
+            }
+            _order.resize(size);
+            std::iota(_order.begin(), _order.end(), fromIndex);
+        }
+
+        // validate the labels and size the weights in a single pass over the examples
+        auto exampleIterator = anyDataset.GetExampleIterator<data::AutoSupervisedExample>();
+        while (exampleIterator.IsValid())
+        {
+            const auto& example = exampleIterator.Get();
+            auto label = example.GetMetadata().label;
+            if (label < 0 || label != std::floor(label))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "the label of each example must be a class index");
+            }
+            AddExample(example.GetDataVector(), static_cast<size_t>(label));
+            exampleIterator.Next();
+        }
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::SetDataset(const data::AutoSupervisedMultiClassDataset& dataset)
+    {
+        ResetDataset();
+        _multiClassDataset = &dataset;
+        _order.resize(dataset.NumExamples());
+        std::iota(_order.begin(), _order.end(), 0);
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            const auto& example = dataset[i];
+            AddExample(example.GetDataVector(), example.GetMetadata().classIndex);
+        }
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::ResetDataset()
+    {
+        _dataset = nullptr;
+        _multiClassDataset = nullptr;
+        _mappedDataset = nullptr;
+        _order.clear();
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::AddExample(const data::AutoDataVector& x, size_t classIndex)
+    {
+        // the weights only grow, so that calling SetDataset again continues training
+        Resize(std::max(x.PrefixLength(), _v.NumRows()), std::max(classIndex + 1, NumClasses()));
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::Resize(size_t numFeatures, size_t numClasses)
+    {
+        if (numFeatures == _v.NumRows() && numClasses == NumClasses())
+        {
+            return;
+        }
+
+        auto resize = [numFeatures, numClasses](math::RowMatrix<double>& matrix) {
+            math::RowMatrix<double> resized(numFeatures, numClasses);
+            if (matrix.NumRows() > 0 && matrix.NumColumns() > 0)
+            {
+                resized.GetSubMatrix(0, 0, matrix.NumRows(), matrix.NumColumns()).CopyFrom(matrix);
+            }
+            matrix = std::move(resized);
+        };
+        resize(_v);
+        resize(_u);
+
+        _a.Resize(numClasses);
+        _c.Resize(numClasses);
+        _d.Resize(numClasses);
+        _g.Resize(numClasses);
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::Update()
+    {
+        if (_mappedDataset != nullptr)
+        {
+            // visit the examples in a random order, reading the file one block of examples at a time
+            auto exampleIterator = _mappedDataset->GetShuffledExampleIterator(_random, _mappedFromIndex, _mappedSize);
+            while (exampleIterator.IsValid())
+            {
+                const auto& example = exampleIterator.Get();
+                DoStep(example.GetDataVector(), static_cast<size_t>(example.GetMetadata().label), example.GetMetadata().weight);
+                exampleIterator.Next();
+            }
+            return;
+        }
+
+        // permute the example order rather than the examples themselves
+        std::shuffle(_order.begin(), _order.end(), _random);
+        for (auto index : _order)
+        {
+            if (_multiClassDataset != nullptr)
+            {
+                const auto& example = (*_multiClassDataset)[index];
+                DoStep(example.GetDataVector(), example.GetMetadata().classIndex, example.GetMetadata().weight);
+            }
+            else
+            {
+                const auto& example = _dataset->GetExample(index);
+                DoStep(example.GetDataVector(), static_cast<size_t>(example.GetMetadata().label), example.GetMetadata().weight);
+            }
+        }
+    }
+
+    template <typename LossFunctionType>
+    void MultiClassSGDTrainer<LossFunctionType>::DoStep(const data::AutoDataVector& x, size_t classIndex, double weight)
+    {
+        // extract the nonzeros of the example once, they are shared by all the classes
+        _entries.clear();
+        auto sparseVector = x.CopyAs<data::SparseDoubleDataVector>();
+        auto iterator = sparseVector.GetIterator<data::IterationPolicy::skipZeros>();
+        while (iterator.IsValid())
+        {
+            _entries.push_back(iterator.Get());
+            iterator.Next();
+        }
+
+        const double lambda = _parameters.regularization;
+        const size_t numClasses = NumClasses();
+
+        // apply all the predictors at once: d = x * V, one row of V per nonzero of x
+        _d.Reset();
+        if (_t > 0)
+        {
+            for (const auto& entry : _entries)
+            {
+                math::ScaleAddUpdate(entry.value, _v.GetRow(entry.index), math::One(), _d);
+            }
+        }
+
+        // get the derivative of each binary loss; the first step predicts zero for every class
+        for (size_t k = 0; k < numClasses; ++k)
+        {
+            double p = _t > 0 ? -(_d[k] + _a[k]) / (lambda * _t) : 0.0;
+            double y = k == classIndex ? 1.0 : -1.0;
+            _g[k] = weight * _lossFunction.GetDerivative(p, y);
+        }
+        ++_t;
+
+        // update: V += x' * g, U += h * x' * g
+        for (const auto& entry : _entries)
+        {
+            math::ScaleAddUpdate(entry.value, _g, math::One(), _v.GetRow(entry.index));
+            math::ScaleAddUpdate(_h * entry.value, _g, math::One(), _u.GetRow(entry.index));
+        }
+        _a += _g;
+        math::ScaleAddUpdate(1.0 / _t, _a, math::One(), _c);
+        _h += 1.0 / _t;
+    }
+
+    template <typename LossFunctionType>
+    auto MultiClassSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
+    {
+        const double lambda = _parameters.regularization;
+        _lastPredictor = PredictorType(_v.NumRows(), NumClasses());
+        if (_t == 0)
+        {
+            return _lastPredictor;
+        }
+
+        // define last predictor based on _v, _a, _t
+        math::ScaleSet(-1 / (lambda * _t), _v, _lastPredictor.GetWeights());
+        math::ScaleSet(-1 / (lambda * _t), _a.Transpose(), _lastPredictor.GetBias());
+        return _lastPredictor;
+    }
+
+    template <typename LossFunctionType>
+    auto MultiClassSGDTrainer<LossFunctionType>::GetPredictor() const -> const PredictorType&
+    {
+        const double lambda = _parameters.regularization;
+        _averagedPredictor = PredictorType(_v.NumRows(), NumClasses());
+        if (_t == 0)
+        {
+            return _averagedPredictor;
+        }
+
+        // define averaged predictor based on _v, _h, _u, _t
+        math::ScaleAddSet(-_h / (lambda * _t), _v, 1 / (lambda * _t), _u, _averagedPredictor.GetWeights());
+        math::ScaleSet(-1 / (lambda * _t), _c.Transpose(), _averagedPredictor.GetBias());
+        return _averagedPredictor;
+    }
+
+    template <typename LossFunctionType>
+    std::unique_ptr<trainers::ITrainer<predictors::MultiClassLinearPredictor<double>>> MakeMultiClassSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
+    {
+        return std::make_unique<MultiClassSGDTrainer<LossFunctionType>>(lossFunction, parameters);
+    }
+}
+}
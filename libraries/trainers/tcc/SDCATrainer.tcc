@@ -20,6 +20,10 @@ namespace trainers
     : _lossFunction(lossFunction), _regularizer(regularizer), _parameters(parameters)
     {
         _random = utilities::GetRandomEngine(parameters.randomSeedString);
+        if (parameters.numThreads != 1)
+        {
+            _threadPool = std::make_unique<utilities::ThreadPool>(parameters.numThreads);
+        }
     }
 
     template<typename LossFunctionType, typename RegularizerType>
@@ -42,6 +46,12 @@ namespace trainers
 
             auto label = example.GetMetadata().weightLabel.label;
             _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
+
+            // the threads of a parallel epoch share the predictor, so it must be large enough up front
+            if (_threadPool)
+            {
+                ResizeTo(example.GetDataVector());
+            }
         }
     }
 
@@ -54,9 +64,16 @@ namespace trainers
         }
 
         // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        if (_threadPool)
         {
-            Step(_dataset[i]);
+            UpdateParallel();
+        }
+        else
+        {
+            for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+            {
+                Step(_dataset[i]);
+            }
         }
 
         // Finish
@@ -69,30 +86,82 @@ namespace trainers
 
     template<typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::Step(TrainerExampleType& example)
+    {
+        ResizeTo(example.GetDataVector());
+        auto& dualVariable = example.GetMetadata().dualVariable;
+        dualVariable = Step(example, dualVariable, _v, _d, _predictor);
+    }
+
+    template<typename LossFunctionType, typename RegularizerType>
+    double SDCATrainer<LossFunctionType, RegularizerType>::Step(const TrainerExampleType& example, double dual, math::ColumnVector<double>& v, double& d, predictors::LinearPredictor<double>& predictor) const
     {
         const auto& dataVector = example.GetDataVector();
-        ResizeTo(dataVector);
 
         auto weightLabel = example.GetMetadata().weightLabel;
         auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
         auto lipschitz = norm2Squared * _inverseScaledRegularization;
-        auto dual = example.GetMetadata().dualVariable; 
 
         if (lipschitz > 0)
         {
-            auto prediction = _predictor.Predict(dataVector);
+            auto prediction = predictor.Predict(dataVector);
             
             auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
             auto dualDiff = newDual - dual;
             
             if (dualDiff != 0)
             {
-                _v.Transpose() += (-dualDiff * _inverseScaledRegularization) * dataVector;
-                _d += (-dualDiff * _inverseScaledRegularization);
-                _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
-                example.GetMetadata().dualVariable = newDual;
+                v.Transpose() += (-dualDiff * _inverseScaledRegularization) * dataVector;
+                d += (-dualDiff * _inverseScaledRegularization);
+                _regularizer.ConjugateGradient(v, d, predictor.GetWeights(), predictor.GetBias());
+                return newDual;
             }
         }
+        return dual;
+    }
+
+    template<typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::UpdateParallel()
+    {
+        const size_t numExamples = _dataset.NumExamples();
+        const size_t numPartitions = _threadPool->NumThreads();
+
+        // each partition runs a local pass starting from the current solution
+        std::vector<math::ColumnVector<double>> partitionV(numPartitions);
+        std::vector<double> partitionD(numPartitions);
+        std::vector<double> newDuals(numExamples);
+        _threadPool->ParallelFor(numPartitions, [&](size_t partition) {
+            math::ColumnVector<double> v(_v);
+            double d = _d;
+            auto predictor = _predictor;
+
+            const size_t begin = numExamples * partition / numPartitions;
+            const size_t end = numExamples * (partition + 1) / numPartitions;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& example = _dataset.GetExample(i);
+                newDuals[i] = Step(example, example.GetMetadata().dualVariable, v, d, predictor);
+            }
+
+            partitionV[partition] = std::move(v);
+            partitionD[partition] = d;
+        });
+
+        // average the local solutions; since v and d are linear in the dual variables, this is the same as averaging
+        // the dual updates, and it keeps the dual feasible
+        const double scale = 1.0 / numPartitions;
+        _v.Reset();
+        _d = 0;
+        for (size_t partition = 0; partition < numPartitions; ++partition)
+        {
+            _v += scale * partitionV[partition];
+            _d += scale * partitionD[partition];
+        }
+        for (size_t i = 0; i < numExamples; ++i)
+        {
+            auto& dualVariable = _dataset[i].GetMetadata().dualVariable;
+            dualVariable += scale * (newDuals[i] - dualVariable);
+        }
+        _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
     }
 
     template<typename LossFunctionType, typename RegularizerType>
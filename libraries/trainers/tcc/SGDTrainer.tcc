@@ -7,6 +7,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // stl
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 
@@ -14,16 +16,63 @@
 #include "DataVector.h"
 #include "Dataset.h"
 #include "DataVectorOperations.h"
+#include "SparseDataVector.h"
 
 // math
 #include "VectorOperations.h"
 
+// utilities
+#include "Exception.h"
+
 namespace ell
 {
 namespace trainers
 {
     // the code in this file follows the notation and pseudocode in https://arxiv.org/abs/1612.09147
 
+    namespace SGDTrainerImpl
+    {
+        // atomically adds a value to a shared double and returns the new value
+        inline double AtomicAdd(std::atomic<double>& target, double value)
+        {
+            auto current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+            {
+            }
+            return current + value;
+        }
+
+        template <typename VectorType>
+        double Dot(const std::vector<data::IndexValue>& entries, const VectorType& v)
+        {
+            double result = 0;
+            for (const auto& entry : entries)
+            {
+                result += entry.value * v[entry.index];
+            }
+            return result;
+        }
+
+        inline double Dot(const std::vector<data::IndexValue>& entries, const std::vector<std::atomic<double>>& v)
+        {
+            double result = 0;
+            for (const auto& entry : entries)
+            {
+                result += entry.value * v[entry.index].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        // the trainers that only run single-threaded epochs reject the multithreading parameters rather than ignore them
+        inline void VerifySingleThreaded(const SGDTrainerParameters& parameters, const std::string& trainerName)
+        {
+            if (parameters.numThreads != 1 || parameters.miniBatchSize != 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, trainerName + " only supports numThreads = 1 and miniBatchSize = 0");
+            }
+        }
+    }
+
     //
     // SGDTrainer
     //
@@ -32,6 +81,7 @@ namespace trainers
     SGDTrainer<LossFunctionType>::SGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
         : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters)
     {
+        SGDTrainerImpl::VerifySingleThreaded(parameters, "SGDTrainer");
     }
 
     template<typename LossFunctionType>
@@ -97,6 +147,235 @@ namespace trainers
     SparseDataSGDTrainer<LossFunctionType>::SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
         : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters)
     {
+        if (parameters.numThreads != 1)
+        {
+            _threadPool = std::make_unique<utilities::ThreadPool>(parameters.numThreads);
+        }
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::Update()
+    {
+        if (!_threadPool)
+        {
+            SGDTrainerBase::Update();
+            return;
+        }
+
+        if (_mappedDataset != nullptr)
+        {
+            // a memory-mapped dataset is streamed from its file, in the same random order as in a single-threaded epoch
+            auto exampleIterator = _mappedDataset->GetShuffledExampleIterator(_random, _mappedFromIndex, _mappedSize);
+            UpdateInBlocks(exampleIterator);
+            return;
+        }
+
+        if (_sharedDataset != nullptr)
+        {
+            auto exampleIterator = GetShuffledSharedExampleIterator();
+            UpdateInBlocks(exampleIterator);
+            return;
+        }
+
+        // permute the data
+        _dataset.RandomPermute(_random);
+
+        auto exampleIterator = _dataset.GetExampleReferenceIterator();
+        UpdateInBlocks(exampleIterator);
+    }
+
+    template <typename LossFunctionType>
+    template <typename ExampleIteratorType>
+    void SparseDataSGDTrainer<LossFunctionType>::UpdateInBlocks(ExampleIteratorType& exampleIterator)
+    {
+        std::unique_ptr<LockFreeState> lockFreeState;
+        while (exampleIterator.IsValid())
+        {
+            ReadSparseExamples(exampleIterator);
+            if (_parameters.miniBatchSize == 0)
+            {
+                // the shared state is only reloaded when a block brings in new features
+                if (lockFreeState == nullptr || lockFreeState->v.size() < _v.Size())
+                {
+                    if (lockFreeState != nullptr)
+                    {
+                        StoreLockFreeState(*lockFreeState);
+                    }
+                    lockFreeState = LoadLockFreeState();
+                }
+                UpdateLockFree(*lockFreeState);
+            }
+            else
+            {
+                UpdateMiniBatch();
+            }
+        }
+        if (lockFreeState != nullptr)
+        {
+            StoreLockFreeState(*lockFreeState);
+        }
+        _firstIteration = false;
+
+        // the sparse examples aren't kept between epochs, so that the trainer doesn't hold a second copy of the data
+        _sparseExamples.clear();
+        _sparseExamples.shrink_to_fit();
+    }
+
+    template <typename LossFunctionType>
+    template <typename ExampleIteratorType>
+    void SparseDataSGDTrainer<LossFunctionType>::ReadSparseExamples(ExampleIteratorType& exampleIterator)
+    {
+        // the entries of the previous block are reused, to avoid reallocating them
+        size_t numExamples = 0;
+        for (; numExamples < sparseExampleBlockSize && exampleIterator.IsValid(); ++numExamples)
+        {
+            if (numExamples == _sparseExamples.size())
+            {
+                _sparseExamples.emplace_back();
+            }
+
+            const auto& example = exampleIterator.Get();
+            const auto& x = example.GetDataVector();
+            ResizeTo(x);
+
+            auto& sparseExample = _sparseExamples[numExamples];
+            sparseExample.label = example.GetMetadata().label;
+            sparseExample.weight = example.GetMetadata().weight;
+            sparseExample.entries.clear();
+            auto sparseVector = x.template CopyAs<data::SparseDoubleDataVector>();
+            auto iterator = sparseVector.template GetIterator<data::IterationPolicy::skipZeros>();
+            while (iterator.IsValid())
+            {
+                sparseExample.entries.push_back(iterator.Get());
+                iterator.Next();
+            }
+            exampleIterator.Next();
+        }
+        _sparseExamples.resize(numExamples);
+    }
+
+    template <typename LossFunctionType>
+    auto SparseDataSGDTrainer<LossFunctionType>::LoadLockFreeState() const -> std::unique_ptr<LockFreeState>
+    {
+        const size_t numFeatures = _v.Size();
+        auto state = std::make_unique<LockFreeState>(numFeatures);
+        for (size_t j = 0; j < numFeatures; ++j)
+        {
+            state->v[j].store(_v[j], std::memory_order_relaxed);
+            state->u[j].store(_u[j], std::memory_order_relaxed);
+        }
+        state->a.store(_a);
+        state->c.store(_c);
+        return state;
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::StoreLockFreeState(const LockFreeState& state)
+    {
+        const size_t numFeatures = state.v.size();
+        for (size_t j = 0; j < numFeatures; ++j)
+        {
+            _v[j] = state.v[j].load();
+            _u[j] = state.u[j].load();
+        }
+        _a = state.a.load();
+        _c = state.c.load();
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::UpdateLockFree(LockFreeState& state)
+    {
+        const double lambda = _parameters.regularization;
+        const size_t numExamples = _sparseExamples.size();
+        const size_t firstStep = static_cast<size_t>(_t);
+        auto& v = state.v;
+        auto& u = state.u;
+        auto& a = state.a;
+        auto& c = state.c;
+        std::atomic<size_t> t(firstStep);
+
+        // harmonic[k] is the harmonic number of step (firstStep + k)
+        std::vector<double> harmonic(numExamples + 1);
+        harmonic[0] = _h;
+        for (size_t k = 0; k < numExamples; ++k)
+        {
+            harmonic[k + 1] = harmonic[k] + 1.0 / static_cast<double>(firstStep + k + 1);
+        }
+
+        const size_t numThreads = _threadPool->NumThreads();
+        _threadPool->ParallelFor(numThreads, [&](size_t threadIndex) {
+            const size_t begin = numExamples * threadIndex / numThreads;
+            const size_t end = numExamples * (threadIndex + 1) / numThreads;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& example = _sparseExamples[i];
+
+                // apply the predictor, using whatever state the other threads have written so far
+                double d = SGDTrainerImpl::Dot(example.entries, v);
+                size_t step = t.fetch_add(1, std::memory_order_relaxed) + 1;
+                double p = step > 1 ? -(d + a.load(std::memory_order_relaxed)) / (lambda * (step - 1)) : 0.0;
+
+                // get the derivative
+                double g = example.weight * _lossFunction.GetDerivative(p, example.label);
+
+                // update
+                double h = harmonic[step - 1 - firstStep];
+                for (const auto& entry : example.entries)
+                {
+                    SGDTrainerImpl::AtomicAdd(v[entry.index], g * entry.value);
+                    SGDTrainerImpl::AtomicAdd(u[entry.index], h * g * entry.value);
+                }
+                double newA = SGDTrainerImpl::AtomicAdd(a, g);
+                SGDTrainerImpl::AtomicAdd(c, newA / step);
+            }
+        });
+
+        _t = static_cast<double>(firstStep + numExamples);
+        _h = harmonic[numExamples];
+    }
+
+    template <typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::UpdateMiniBatch()
+    {
+        const double lambda = _parameters.regularization;
+        const size_t numExamples = _sparseExamples.size();
+        const size_t numThreads = _threadPool->NumThreads();
+        std::vector<double> derivatives;
+
+        for (size_t batchBegin = 0; batchBegin < numExamples; batchBegin += _parameters.miniBatchSize)
+        {
+            const size_t batchSize = std::min(_parameters.miniBatchSize, numExamples - batchBegin);
+            derivatives.resize(batchSize);
+
+            // compute the loss derivatives of the batch in parallel, all against the state at the start of the batch
+            _threadPool->ParallelFor(numThreads, [&](size_t threadIndex) {
+                const size_t begin = batchSize * threadIndex / numThreads;
+                const size_t end = batchSize * (threadIndex + 1) / numThreads;
+                for (size_t k = begin; k < end; ++k)
+                {
+                    const auto& example = _sparseExamples[batchBegin + k];
+                    double d = SGDTrainerImpl::Dot(example.entries, _v);
+                    double p = _t > 0 ? -(d + _a) / (lambda * _t) : 0.0;
+                    derivatives[k] = example.weight * _lossFunction.GetDerivative(p, example.label);
+                }
+            });
+
+            // apply the updates in order
+            for (size_t k = 0; k < batchSize; ++k)
+            {
+                const auto& example = _sparseExamples[batchBegin + k];
+                double g = derivatives[k];
+                ++_t;
+                for (const auto& entry : example.entries)
+                {
+                    _v[entry.index] += g * entry.value;
+                    _u[entry.index] += _h * g * entry.value;
+                }
+                _a += g;
+                _c += _a / _t;
+                _h += 1.0 / _t;
+            }
+        }
     }
 
     template<typename LossFunctionType>
@@ -182,6 +461,7 @@ namespace trainers
     SparseDataCenteredSGDTrainer<LossFunctionType>::SparseDataCenteredSGDTrainer(const LossFunctionType& lossFunction, math::RowVector<double> center, const SGDTrainerParameters& parameters)
         : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters), _center(std::move(center))
     {
+        SGDTrainerImpl::VerifySingleThreaded(parameters, "SparseDataCenteredSGDTrainer");
         _theta = 1 + _center.Norm2Squared();
     }
 
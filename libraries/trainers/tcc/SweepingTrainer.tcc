@@ -6,30 +6,77 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// utilities
+#include "MillisecondTimer.h"
+
 namespace ell
 {
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers)
-        : _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads)
+        : _evaluatingTrainers(std::move(evaluatingTrainers)), _runStatistics(_evaluatingTrainers.size())
     {
         assert(_evaluatingTrainers.size() > 0);
+        if (numThreads != 1)
+        {
+            _threadPool = std::make_unique<utilities::ThreadPool>(numThreads);
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
+        // The trainers share one copy of the dataset, and the ones that support it read it in place rather than
+        // copying it again. A memory-mapped dataset is already shared, since the trainers stream it from its file.
+        if (anyDataset.GetMappedDataset() != nullptr)
+        {
+            _dataset.Reset();
+            for (auto& evaluatingTrainer : _evaluatingTrainers)
+            {
+                evaluatingTrainer.SetSharedDataset(anyDataset);
+            }
+            return;
+        }
+
         _dataset = data::Dataset<ExampleType>(anyDataset);
+        for (auto& evaluatingTrainer : _evaluatingTrainers)
+        {
+            evaluatingTrainer.SetSharedDataset(_dataset.GetAnyDataset());
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        if (_threadPool == nullptr)
+        {
+            for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+            {
+                UpdateTrainer(i);
+            }
+        }
+        else
+        {
+            // The trainers own their predictors, evaluators and random engines, so they can be updated independently
+            _threadPool->ParallelFor(_evaluatingTrainers.size(), [this](size_t i) { UpdateTrainer(i); });
+        }
+    }
+
+    template <typename PredictorType>
+    void SweepingTrainer<PredictorType>::UpdateTrainer(size_t index)
+    {
+        utilities::MillisecondTimer timer;
+        _evaluatingTrainers[index].Update();
+
+        auto& statistics = _runStatistics[index];
+        statistics.lastUpdateTime = static_cast<double>(timer.Elapsed());
+        double goodness = _evaluatingTrainers[index].GetEvaluator()->GetGoodness();
+        if (statistics.numUpdates == 0 || goodness > statistics.bestGoodness)
         {
-            _evaluatingTrainers[i].Update();
+            statistics.bestGoodness = goodness;
         }
+        ++statistics.numUpdates;
     }
 
     template <typename PredictorType>
@@ -51,9 +98,9 @@ namespace trainers
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    std::unique_ptr<SweepingTrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), numThreads);
     }
 }
 }
@@ -0,0 +1,22 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OutOfCoreTrainingTiming.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <string>
+
+// Returns the approximate size of a binary dataset file, in bytes, of examples with the given number of nonzero entries
+size_t GetBinaryDatasetExampleSize(size_t numActiveFeatures);
+
+void TimeMappedDatasetSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs, bool compareInMemory);
+
+void TimeBinaryDatasetReload(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numIterations);
+
+void TimePrefetchedTextSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numParserThreads);
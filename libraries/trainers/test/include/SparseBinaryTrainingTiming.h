@@ -0,0 +1,15 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseBinaryTrainingTiming.h (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+void TimeCompressedIntegerListDecode(size_t numEntries, size_t maxGap, size_t numIterations);
+void TimeSparseBinarySGDEpoch(size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs);
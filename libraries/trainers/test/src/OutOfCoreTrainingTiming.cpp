@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OutOfCoreTrainingTiming.cpp (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OutOfCoreTrainingTiming.h"
+
+// data
+#include "AutoDataVector.h"
+#include "Dataset.h"
+#include "Example.h"
+#include "GeneralizedSparseParsingIterator.h"
+#include "MappedDataset.h"
+#include "PrefetchingExampleIterator.h"
+#include "SequentialLineIterator.h"
+#include "SingleLineParsingExampleIterator.h"
+#include "WeightLabel.h"
+
+// functions
+#include "SquaredLoss.h"
+
+// predictors
+#include "LinearPredictor.h"
+
+// trainers
+#include "SGDTrainer.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+    // writes random examples in the sparse text format that the trainers parse
+    void WriteRandomTextDataset(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures)
+    {
+        std::default_random_engine engine(123);
+        std::uniform_int_distribution<size_t> strideDistribution(1, 2 * numFeatures / numActiveFeatures - 1);
+        std::normal_distribution<double> valueDistribution(0, 1);
+        std::ofstream textStream(filename);
+        textStream.precision(17);
+        for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+        {
+            textStream << (exampleIndex % 2 == 0 ? 1 : -1);
+            for (size_t feature = strideDistribution(engine); feature < numFeatures; feature += strideDistribution(engine))
+            {
+                textStream << '\t' << feature << ':' << valueDistribution(engine);
+            }
+            textStream << '\n';
+        }
+    }
+}
+
+size_t GetBinaryDatasetExampleSize(size_t numActiveFeatures)
+{
+    // an index and a value per entry, and a weight, a label and a row offset per example
+    return numActiveFeatures * (sizeof(uint32_t) + sizeof(double)) + 3 * sizeof(double);
+}
+
+void TimeMappedDatasetSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs, bool compareInMemory)
+{
+    // Stream random examples straight into the binary file, so that it can be larger than the physical memory. The
+    // label is a noisy linear function of the features.
+    {
+        std::default_random_engine engine(123);
+        std::uniform_int_distribution<size_t> strideDistribution(1, 2 * numFeatures / numActiveFeatures - 1);
+        std::normal_distribution<double> valueDistribution(0, 1);
+        std::ofstream stream(filename, std::ios::binary);
+        data::BinaryDatasetWriter writer(stream);
+        for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+        {
+            std::vector<data::IndexValue> entries;
+            double label = valueDistribution(engine) / 10;
+            for (size_t feature = strideDistribution(engine); feature < numFeatures; feature += strideDistribution(engine))
+            {
+                auto value = valueDistribution(engine);
+                entries.push_back({ feature, value });
+                label += (feature % 2 == 0 ? value : -value) / numActiveFeatures;
+            }
+            writer.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::move(entries)), data::WeightLabel{ 1.0, label }));
+        }
+        writer.Finish();
+    }
+
+    trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+    double fileSizeMB = 0;
+    double mappedDuration = 0;
+    {
+        data::MappedDataset dataset(filename);
+        fileSizeMB = static_cast<double>(dataset.NumExamples() * 3 * sizeof(double) + dataset.NumEntries() * (sizeof(uint32_t) + sizeof(double))) / (1 << 20);
+
+        auto trainer = trainers::MakeSGDTrainer(functions::SquaredLoss(), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        utilities::MillisecondTimer timer;
+        for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
+        mappedDuration = static_cast<double>(timer.Elapsed()) / numEpochs;
+
+        std::cout << "Out-of-core SGD, " << numExamples << " examples (" << fileSizeMB << " MB): " << mappedDuration << " ms per epoch";
+        if (mappedDuration > 0)
+        {
+            std::cout << ", " << 1000.0 * numExamples / mappedDuration << " examples/s, " << 1000.0 * fileSizeMB / mappedDuration << " MB/s";
+        }
+        std::cout << std::endl;
+
+        // the same epochs, with the whole dataset copied into memory first
+        if (compareInMemory)
+        {
+            data::AutoSupervisedDataset inMemoryDataset(dataset.GetAnyDataset());
+            auto inMemoryTrainer = trainers::MakeSGDTrainer(functions::SquaredLoss(), parameters);
+            inMemoryTrainer->SetDataset(inMemoryDataset.GetAnyDataset());
+            timer.Reset();
+            for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+            {
+                inMemoryTrainer->Update();
+            }
+            auto inMemoryDuration = static_cast<double>(timer.Elapsed()) / numEpochs;
+            std::cout << "In-memory SGD, same examples: " << inMemoryDuration << " ms per epoch" << std::endl;
+        }
+    }
+    std::remove(filename.c_str());
+}
+
+void TimeBinaryDatasetReload(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numIterations)
+{
+    // the same random examples, as a text file in the sparse format that the trainers parse, and as a binary dataset
+    const std::string textFilename = filename + ".txt";
+    WriteRandomTextDataset(textFilename, numExamples, numFeatures, numActiveFeatures);
+
+    auto parseTextFile = [&textFilename]() {
+        std::ifstream stream(textFilename);
+        data::SequentialLineIterator lineIterator(stream);
+        auto exampleIterator = data::MakeSingleLineParsingExampleIterator(std::move(lineIterator), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>());
+        return data::AutoSupervisedDataset(std::move(exampleIterator));
+    };
+
+    {
+        auto dataset = parseTextFile();
+        std::ofstream stream(filename, std::ios::binary);
+        auto exampleIterator = dataset.GetExampleIterator();
+        data::WriteBinaryDataset(exampleIterator, stream);
+    }
+
+    size_t numTextExamples = 0;
+    utilities::MillisecondTimer timer;
+    for (size_t iteration = 0; iteration < numIterations; ++iteration)
+    {
+        numTextExamples += parseTextFile().NumExamples();
+    }
+    auto textDuration = static_cast<double>(timer.Elapsed()) / numIterations;
+
+    size_t numBinaryExamples = 0;
+    timer.Reset();
+    for (size_t iteration = 0; iteration < numIterations; ++iteration)
+    {
+        numBinaryExamples += data::LoadBinaryDataset(filename).NumExamples();
+    }
+    auto binaryDuration = static_cast<double>(timer.Elapsed()) / numIterations;
+
+    testing::ProcessTest("TimeBinaryDatasetReload: same number of examples", numTextExamples == numBinaryExamples);
+    std::cout << "Dataset load, " << numExamples << " examples with " << numActiveFeatures << " nonzeros: text " << textDuration << " ms, binary " << binaryDuration << " ms";
+    if (binaryDuration > 0)
+    {
+        std::cout << " (" << textDuration / binaryDuration << "x)";
+    }
+    std::cout << std::endl;
+
+    std::remove(textFilename.c_str());
+    std::remove(filename.c_str());
+}
+
+void TimePrefetchedTextSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numParserThreads)
+{
+    WriteRandomTextDataset(filename, numExamples, numFeatures, numActiveFeatures);
+
+    // one pass of plain SGD with the squared loss, streaming the examples from the text file
+    auto runEpoch = [numFeatures](auto& exampleIterator) {
+        predictors::LinearPredictor<double> predictor(numFeatures);
+        const double learningRate = 1.0e-3;
+        for (; exampleIterator.IsValid(); exampleIterator.Next())
+        {
+            auto example = exampleIterator.Get();
+            const auto& x = example.GetDataVector();
+            double g = predictor.Predict(x) - example.GetMetadata().label;
+            predictor.GetWeights().Transpose() += (-learningRate * g) * x;
+            predictor.GetBias() -= learningRate * g;
+        }
+        return predictor.GetBias();
+    };
+
+    double inlineDuration = 0;
+    double inlineBias = 0;
+    {
+        std::ifstream stream(filename);
+        data::SequentialLineIterator lineIterator(stream);
+        auto exampleIterator = data::MakeSingleLineParsingExampleIterator(std::move(lineIterator), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>());
+        utilities::MillisecondTimer timer;
+        inlineBias = runEpoch(exampleIterator);
+        inlineDuration = static_cast<double>(timer.Elapsed());
+    }
+
+    std::cout << "Streaming SGD, " << numExamples << " text examples with " << numActiveFeatures << " nonzeros: inline parsing " << inlineDuration << " ms" << std::endl;
+    for (size_t numThreads = 0; numThreads <= numParserThreads; ++numThreads)
+    {
+        std::ifstream stream(filename);
+        data::SequentialLineIterator lineIterator(stream);
+        utilities::MillisecondTimer timer;
+        data::PrefetchingExampleIterator<data::AutoSupervisedExample> exampleIterator(std::move(lineIterator), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), 256, numThreads);
+        auto bias = runEpoch(exampleIterator);
+        auto duration = static_cast<double>(timer.Elapsed());
+        auto statistics = exampleIterator.GetStallStatistics();
+
+        testing::ProcessTest("TimePrefetchedTextSGDEpoch: same model", bias == inlineBias);
+        std::cout << "  prefetching with " << numThreads << " parser threads: " << duration << " ms, trainer waited " << statistics.consumerStallTime << " ms, readers and parsers waited " << statistics.producerStallTime << " ms" << std::endl;
+    }
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseBinaryTrainingTiming.cpp (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseBinaryTrainingTiming.h"
+
+// data
+#include "Dataset.h"
+#include "Example.h"
+
+// functions
+#include "LogLoss.h"
+
+// trainers
+#include "SGDTrainer.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "CompressedIntegerList.h"
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace ell;
+
+void TimeCompressedIntegerListDecode(size_t numEntries, size_t maxGap, size_t numIterations)
+{
+    std::default_random_engine engine(123);
+    std::uniform_int_distribution<size_t> gapDistribution(1, maxGap);
+    utilities::CompressedIntegerList list;
+    size_t value = 0;
+    for (size_t index = 0; index < numEntries; ++index)
+    {
+        value += gapDistribution(engine);
+        list.Append(value);
+    }
+
+    // decode one entry at a time through the iterator
+    utilities::MillisecondTimer timer;
+    size_t iteratorSum = 0;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        auto iterator = list.GetIterator();
+        while (iterator.IsValid())
+        {
+            iteratorSum += iterator.Get();
+            iterator.Next();
+        }
+    }
+    auto iteratorDuration = timer.Elapsed();
+
+    // decode a block at a time
+    timer.Reset();
+    size_t blockSum = 0;
+    size_t block[utilities::CompressedIntegerList::blockSize];
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        for (size_t blockIndex = 0; blockIndex < list.NumBlocks(); ++blockIndex)
+        {
+            auto count = list.DecodeBlock(blockIndex, block);
+            for (size_t i = 0; i < count; ++i)
+            {
+                blockSum += block[i];
+            }
+        }
+    }
+    auto blockDuration = timer.Elapsed();
+
+    auto millionsPerSecond = [&](double duration) { return duration > 0 ? (numEntries * numIterations) / (1000.0 * duration) : 0.0; };
+    std::cout << "CompressedIntegerList decode, " << numEntries << " entries with gaps up to " << maxGap << ": iterator " << millionsPerSecond(iteratorDuration)
+              << " M entries/s, blocks " << millionsPerSecond(blockDuration) << " M entries/s" << std::endl;
+    testing::ProcessTest("CompressedIntegerList block decoding matches the iterator", iteratorSum == blockSum);
+}
+
+void TimeSparseBinarySGDEpoch(size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs)
+{
+    // Each example has `numActiveFeatures` features equal to 1 (so that it's stored as a SparseBinaryDataVector), and a
+    // label that depends on the parity of the number of active features in the first half of the feature space
+    std::default_random_engine engine(123);
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+    data::AutoSupervisedDataset dataset;
+    for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+    {
+        std::set<size_t> features;
+        while (features.size() < numActiveFeatures)
+        {
+            features.insert(featureDistribution(engine));
+        }
+        std::vector<data::IndexValue> entries;
+        for (auto feature : features)
+        {
+            entries.push_back({ feature, 1.0 });
+        }
+        auto numLowFeatures = std::count_if(features.begin(), features.end(), [numFeatures](size_t feature) { return feature < numFeatures / 2; });
+        double label = numLowFeatures % 2 == 0 ? 1.0 : -1.0;
+        dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::move(entries)), data::WeightLabel{ 1.0, label }));
+    }
+
+    trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+    auto trainer = trainers::MakeSGDTrainer(functions::LogLoss(), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+
+    utilities::MillisecondTimer timer;
+    for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    {
+        trainer->Update();
+    }
+    auto duration = timer.Elapsed();
+
+    std::cout << "Sparse binary SGD, " << numExamples << " examples with " << numActiveFeatures << " of " << numFeatures << " features: "
+              << static_cast<double>(duration) / numEpochs << " ms per epoch" << std::endl;
+}
@@ -8,6 +8,11 @@
 
 // data
 #include "Dataset.h"
+#include "MappedDataset.h"
+
+// evaluators
+#include "BinaryErrorAggregator.h"
+#include "Evaluator.h"
 
 // functions
 #include "L2Regularizer.h"
@@ -16,14 +21,27 @@
 
 
 // trainers
+#include "BinnedHistogramForestTrainer.h"
+#include "HistogramForestTrainer.h"
+#include "KMeansTrainer.h"
 #include "MeanCalculator.h"
+#include "MultiClassSGDTrainer.h"
 #include "SDCATrainer.h"
 #include "SGDTrainer.h"
 #include "SquaredLoss.h"
+#include "SweepingTrainer.h"
+#include "ThresholdFinder.h"
 
 // utilities
+#include "Exception.h"
+#include "Files.h"
 #include "testing.h"
 
+// stl
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
 using namespace ell;
 
 /// Runs all tests
@@ -123,6 +141,289 @@ void TestSGDTrainer()
     return;
 }
 
+template <typename PredictorType>
+double GetLogLoss(const PredictorType& predictor, const data::AutoSupervisedDataset& dataset)
+{
+    functions::LogLoss lossFunction;
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        loss += lossFunction(predictor.Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    return loss;
+}
+
+data::AutoSupervisedDataset GetParallelTrainerTestDataset()
+{
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        dataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+        dataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+        dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+        dataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+    }
+    return dataset;
+}
+
+void TestParallelSparseDataSGDTrainer()
+{
+    auto dataset = GetParallelTrainerTestDataset();
+    auto train = [&](size_t numThreads, size_t miniBatchSize) {
+        trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+        parameters.numThreads = numThreads;
+        parameters.miniBatchSize = miniBatchSize;
+        auto trainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 10; ++epoch)
+        {
+            trainer->Update();
+        }
+        return trainer->GetPredictor();
+    };
+
+    auto serialPredictor = train(1, 0);
+    auto lockFreePredictor = train(4, 0);
+    auto miniBatchPredictor2 = train(2, 8);
+    auto miniBatchPredictor4 = train(4, 8);
+
+    double serialLoss = GetLogLoss(serialPredictor, dataset);
+    double lockFreeLoss = GetLogLoss(lockFreePredictor, dataset);
+    double miniBatchLoss = GetLogLoss(miniBatchPredictor4, dataset);
+    bool sameMiniBatchPredictor = miniBatchPredictor2.GetWeights() == miniBatchPredictor4.GetWeights() && miniBatchPredictor2.GetBias() == miniBatchPredictor4.GetBias();
+
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, lock-free", lockFreeLoss < 1.1 * serialLoss + 1.0);
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, mini-batch", miniBatchLoss < 1.1 * serialLoss + 1.0);
+    testing::ProcessTest("TestParallelSparseDataSGDTrainer, mini-batch is deterministic", sameMiniBatchPredictor);
+}
+
+void TestSingleThreadedSGDTrainers()
+{
+    trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+    parameters.numThreads = 4;
+    auto throwsException = [](std::function<void()> makeTrainer) {
+        try
+        {
+            makeTrainer();
+        }
+        catch (const utilities::InputException&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    bool sgdThrows = throwsException([&]() { trainers::MakeSGDTrainer(functions::LogLoss(), parameters); });
+    bool centeredSGDThrows = throwsException([&]() { trainers::MakeSparseDataCenteredSGDTrainer(functions::LogLoss(), math::RowVector<double>{ 0.0, 0.0 }, parameters); });
+
+    testing::ProcessTest("TestSingleThreadedSGDTrainers, SGDTrainer rejects numThreads", sgdThrows);
+    testing::ProcessTest("TestSingleThreadedSGDTrainers, SparseDataCenteredSGDTrainer rejects numThreads", centeredSGDThrows);
+}
+
+void TestMappedDatasetParallelSparseDataSGDTrainer()
+{
+    auto dataset = GetParallelTrainerTestDataset();
+    const std::string filename = utilities::JoinPaths(utilities::GetTempDirectory(), "ParallelSparseDataSGDTrainer_test.bin");
+    {
+        std::ofstream stream(filename, std::ios::binary);
+        auto exampleIterator = dataset.GetExampleIterator();
+        data::WriteBinaryDataset(exampleIterator, stream);
+    }
+    {
+        data::MappedDataset mappedDataset(filename);
+
+        auto train = [&](const data::AnyDataset& anyDataset, size_t numThreads, size_t miniBatchSize) {
+            trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+            parameters.numThreads = numThreads;
+            parameters.miniBatchSize = miniBatchSize;
+            auto trainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), parameters);
+            trainer->SetDataset(anyDataset);
+            for (size_t epoch = 0; epoch < 10; ++epoch)
+            {
+                trainer->Update();
+            }
+            return trainer->GetPredictor();
+        };
+
+        // the multithreaded epochs stream the examples from the file, so they have to match training on the examples in memory
+        auto serialPredictor = train(dataset.GetAnyDataset(), 1, 0);
+        auto lockFreePredictor = train(mappedDataset.GetAnyDataset(), 4, 0);
+        auto miniBatchPredictor = train(mappedDataset.GetAnyDataset(), 4, 8);
+
+        double serialLoss = GetLogLoss(serialPredictor, dataset);
+        double lockFreeLoss = GetLogLoss(lockFreePredictor, dataset);
+        double miniBatchLoss = GetLogLoss(miniBatchPredictor, dataset);
+
+        testing::ProcessTest("TestMappedDatasetParallelSparseDataSGDTrainer, lock-free", lockFreeLoss < 1.1 * serialLoss + 1.0);
+        testing::ProcessTest("TestMappedDatasetParallelSparseDataSGDTrainer, mini-batch", miniBatchLoss < 1.1 * serialLoss + 1.0);
+    }
+
+    // the mapped dataset has to be closed before the file can be removed
+    std::remove(filename.c_str());
+}
+
+void TestParallelSDCATrainer()
+{
+    auto dataset = GetParallelTrainerTestDataset();
+    auto train = [&](size_t numThreads) {
+        trainers::SDCATrainerParameters parameters{ 1.0e-4, 1.0e-8, 20, false, "XYZ" };
+        parameters.numThreads = numThreads;
+        auto trainer = trainers::MakeSDCATrainer(functions::LogLoss(), functions::L2Regularizer(), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 20; ++epoch)
+        {
+            trainer->Update();
+        }
+        return trainer->GetPredictor();
+    };
+
+    auto parallelPredictor = train(4);
+    auto parallelPredictorAgain = train(4);
+    bool samePredictor = parallelPredictor.GetWeights() == parallelPredictorAgain.GetWeights() && parallelPredictor.GetBias() == parallelPredictorAgain.GetBias();
+
+    testing::ProcessTest("TestParallelSDCATrainer, convergence", GetLogLoss(parallelPredictor, dataset) < 0.01 * dataset.NumExamples());
+    testing::ProcessTest("TestParallelSDCATrainer, deterministic", samePredictor);
+}
+
+void TestMultiClassSGDTrainer()
+{
+    // each class is marked by a large value in its own coordinate, on top of a shared noisy coordinate
+    data::AutoSupervisedMultiClassDataset dataset;
+    std::default_random_engine engine(123);
+    std::normal_distribution<double> noise(0.0, 0.3);
+    const size_t numClasses = 4;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        size_t classIndex = i % numClasses;
+        std::vector<double> x(numClasses + 1, 0.0);
+        x[classIndex] = 2.0 + noise(engine);
+        x[numClasses] = noise(engine);
+        dataset.AddExample({ x, { 1.0, classIndex } });
+    }
+
+    trainers::SGDTrainerParameters parameters{ 1.0e-2, "XYZ" };
+    trainers::MultiClassSGDTrainer<functions::LogLoss> trainer(functions::LogLoss(), parameters);
+    trainer.SetDataset(dataset);
+    for (size_t epoch = 0; epoch < 10; ++epoch)
+    {
+        trainer.Update();
+    }
+    const auto& predictor = trainer.GetPredictor();
+
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        const auto& example = dataset[i];
+        if (predictor.PredictClass(example.GetDataVector()) != example.GetMetadata().classIndex)
+        {
+            ++numErrors;
+        }
+    }
+
+    // the scores of the first example match an explicit one-vs-rest evaluation of the weight columns
+    auto x = dataset[0].GetDataVector().ToArray();
+    auto scores = predictor.Predict(dataset[0].GetDataVector());
+    bool scoresMatch = scores.Size() == numClasses;
+    for (size_t k = 0; scoresMatch && k < numClasses; ++k)
+    {
+        double score = predictor.GetBias()[k];
+        for (size_t j = 0; j < predictor.Size(); ++j)
+        {
+            score += x[j] * predictor.GetWeights()(j, k);
+        }
+        scoresMatch = testing::IsEqual(scores[k], score, 1.0e-8);
+    }
+
+    // a supervised dataset whose labels are the class indices trains the same predictor
+    auto labeledDataset = dataset.Transform<data::AutoSupervisedExample>([](const auto& example) {
+        return data::AutoSupervisedExample(example.GetSharedDataVector(), data::WeightLabel{ example.GetMetadata().weight, static_cast<double>(example.GetMetadata().classIndex) });
+    });
+    auto labeledTrainer = trainers::MakeMultiClassSGDTrainer(functions::LogLoss(), parameters);
+    labeledTrainer->SetDataset(labeledDataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < 10; ++epoch)
+    {
+        labeledTrainer->Update();
+    }
+    const auto& labeledPredictor = labeledTrainer->GetPredictor();
+    bool samePredictor = labeledPredictor.GetWeights() == predictor.GetWeights() && labeledPredictor.GetBias() == predictor.GetBias();
+
+    testing::ProcessTest("TestMultiClassSGDTrainer, number of classes", predictor.NumClasses() == numClasses && predictor.Size() == numClasses + 1);
+    testing::ProcessTest("TestMultiClassSGDTrainer, training error", numErrors == 0);
+    testing::ProcessTest("TestMultiClassSGDTrainer, class scores", scoresMatch);
+    testing::ProcessTest("TestMultiClassSGDTrainer, class index labels", samePredictor);
+}
+
+void TestKMeansTrainer()
+{
+    // three well-separated clusters of 200 points each
+    const size_t dim = 2;
+    const size_t numPointsPerCluster = 200;
+    std::vector<std::vector<double>> centers{ { 0.0, 0.0 }, { 10.0, 0.0 }, { 0.0, 10.0 } };
+    math::ColumnMatrix<double> X(dim, centers.size() * numPointsPerCluster);
+    std::default_random_engine random(1234);
+    std::normal_distribution<double> normal(0, 0.5);
+    for (size_t i = 0; i < X.NumColumns(); ++i)
+    {
+        // interleave the clusters so that every mini-batch sees all of them
+        const auto& center = centers[i % centers.size()];
+        for (size_t j = 0; j < dim; ++j)
+        {
+            X(j, i) = center[j] + normal(random);
+        }
+    }
+
+    auto foundAllCenters = [&](const trainers::KMeansTrainer& kMeans) {
+        const auto& means = kMeans.GetClusterMeans();
+        for (const auto& center : centers)
+        {
+            bool found = false;
+            for (size_t k = 0; k < means.NumColumns(); ++k)
+            {
+                found = found || (std::abs(means(0, k) - center[0]) < 0.5 && std::abs(means(1, k) - center[1]) < 0.5);
+            }
+            if (!found)
+            {
+                return false;
+            }
+        }
+        return kMeans.GetClusterAssignment().Size() == X.NumColumns();
+    };
+
+    trainers::KMeansTrainerParameters miniBatchParameters;
+    miniBatchParameters.miniBatchSize = 64;
+    miniBatchParameters.initialization = trainers::KMeansInitialization::kMeansParallel;
+    trainers::KMeansTrainer miniBatchKMeans(dim, centers.size(), 10, miniBatchParameters);
+    miniBatchKMeans.RunKMeans(X);
+
+    trainers::KMeansTrainerParameters parallelParameters;
+    parallelParameters.initialization = trainers::KMeansInitialization::kMeansParallel;
+    parallelParameters.numThreads = 4;
+    trainers::KMeansTrainer parallelKMeans(dim, centers.size(), 10, parallelParameters);
+    parallelKMeans.RunKMeans(X);
+
+    // k-means|| samples with per-block random engines, so the result doesn't depend on the number of threads
+    parallelParameters.numThreads = 1;
+    trainers::KMeansTrainer serialKMeans(dim, centers.size(), 10, parallelParameters);
+    serialKMeans.RunKMeans(X);
+
+    testing::ProcessTest("TestKMeansTrainer, mini-batch", foundAllCenters(miniBatchKMeans));
+    testing::ProcessTest("TestKMeansTrainer, k-means|| initialization", foundAllCenters(parallelKMeans));
+    testing::ProcessTest("TestKMeansTrainer, k-means|| is deterministic", parallelKMeans.GetClusterMeans() == serialKMeans.GetClusterMeans());
+
+    bool threwOnEmptyData = false;
+    try
+    {
+        trainers::KMeansTrainer emptyKMeans(dim, centers.size(), 10, miniBatchParameters);
+        emptyKMeans.RunKMeans(math::ColumnMatrix<double>(dim, 0));
+    }
+    catch (const utilities::InputException&)
+    {
+        threwOnEmptyData = true;
+    }
+    testing::ProcessTest("TestKMeansTrainer, empty data", threwOnEmptyData);
+}
+
 void TestMeanCalculator()
 {
     data::AutoSupervisedDataset dataset;
@@ -137,9 +438,155 @@ void TestMeanCalculator()
     testing::ProcessTest("TestMeanCalculator", mean == r);
 }
 
+std::unique_ptr<trainers::SweepingTrainer<predictors::LinearPredictor<double>>> MakeTestSweepingTrainer(const data::AnyDataset& anyDataset, size_t numThreads)
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+    std::vector<double> regularization{ 1.0e-1, 1.0e-2, 1.0e-3, 1.0e-4 };
+    std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+    for (size_t i = 0; i < regularization.size(); ++i)
+    {
+        auto sgdTrainer = trainers::MakeSGDTrainer(functions::LogLoss(), { regularization[i], "XYZ" + std::to_string(i) });
+        auto evaluator = evaluators::MakeEvaluator<PredictorType>(anyDataset, { 1, false }, evaluators::BinaryErrorAggregator());
+        evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(sgdTrainer), evaluator));
+    }
+    return trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), numThreads);
+}
+
+void TestSweepingTrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+
+    auto serialTrainer = MakeTestSweepingTrainer(dataset.GetAnyDataset(), 1);
+    auto parallelTrainer = MakeTestSweepingTrainer(dataset.GetAnyDataset(), 4);
+    serialTrainer->SetDataset(dataset.GetAnyDataset());
+    parallelTrainer->SetDataset(dataset.GetAnyDataset());
+
+    const size_t numEpochs = 3;
+    for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    {
+        serialTrainer->Update();
+        parallelTrainer->Update();
+    }
+
+    // each configuration has its own random engine, so running them concurrently gives the same result
+    const auto& serialPredictor = serialTrainer->GetPredictor();
+    const auto& parallelPredictor = parallelTrainer->GetPredictor();
+    bool samePredictor = serialPredictor.GetWeights() == parallelPredictor.GetWeights() && serialPredictor.GetBias() == parallelPredictor.GetBias();
+
+    bool statisticsOk = true;
+    for (const auto& statistics : parallelTrainer->GetRunStatistics())
+    {
+        statisticsOk = statisticsOk && statistics.numUpdates == numEpochs && statistics.lastUpdateTime >= 0;
+    }
+
+    // the internal trainers read the sweeping trainer's copy of the dataset in place, which must give the same result as copying it
+    using PredictorType = predictors::LinearPredictor<double>;
+    std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+    auto evaluator = evaluators::MakeEvaluator<PredictorType>(dataset.GetAnyDataset(), { 1, false }, evaluators::BinaryErrorAggregator());
+    evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(trainers::MakeSGDTrainer(functions::LogLoss(), { 1.0e-2, "XYZ" }), evaluator));
+    auto sharingTrainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+    sharingTrainer->SetDataset(dataset.GetAnyDataset());
+    auto copyingTrainer = trainers::MakeSGDTrainer(functions::LogLoss(), { 1.0e-2, "XYZ" });
+    copyingTrainer->SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    {
+        sharingTrainer->Update();
+        copyingTrainer->Update();
+    }
+    const auto& sharingPredictor = sharingTrainer->GetPredictor();
+    const auto& copyingPredictor = copyingTrainer->GetPredictor();
+    bool sharedDatasetOk = sharingPredictor.GetWeights() == copyingPredictor.GetWeights() && sharingPredictor.GetBias() == copyingPredictor.GetBias();
+
+    testing::ProcessTest("TestSweepingTrainer, parallel matches serial", samePredictor);
+    testing::ProcessTest("TestSweepingTrainer, run statistics", statisticsOk);
+    testing::ProcessTest("TestSweepingTrainer, shared dataset", sharedDatasetOk);
+}
+
+void TestBinnedHistogramForestTrainer()
+{
+    // random features, and a label that depends on two of them
+    data::AutoSupervisedDataset dataset;
+    std::default_random_engine random(1234);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (size_t i = 0; i < 400; ++i)
+    {
+        std::vector<double> features{ uniform(random), uniform(random), uniform(random), uniform(random) };
+        double label = (features[0] > 0.2) != (features[2] < -0.3) ? 1.0 : -1.0;
+        dataset.AddExample({ features, { 1.0, label } });
+    }
+
+    auto getPredictions = [&](const predictors::SimpleForestPredictor& forest) {
+        std::vector<double> predictions;
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            predictions.push_back(forest.Predict(dataset[i].GetDataVector().CopyAs<data::FloatDataVector>()));
+        }
+        return predictions;
+    };
+
+    auto getErrorRate = [&](const std::vector<double>& predictions) {
+        size_t numErrors = 0;
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            numErrors += (predictions[i] > 0) != (dataset[i].GetMetadata().label > 0) ? 1 : 0;
+        }
+        return static_cast<double>(numErrors) / dataset.NumExamples();
+    };
+
+    trainers::HistogramForestTrainerParameters histogramParameters;
+    histogramParameters.minSplitGain = 0.0;
+    histogramParameters.maxSplitsPerRound = 4;
+    histogramParameters.numRounds = 3;
+    histogramParameters.randomSeed = "XYZ";
+    histogramParameters.thresholdFinderSampleSize = dataset.NumExamples();
+    histogramParameters.candidatesPerInput = 0;
+    auto histogramTrainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), histogramParameters);
+    histogramTrainer->SetDataset(dataset.GetAnyDataset());
+    histogramTrainer->Update();
+    auto histogramPredictions = getPredictions(histogramTrainer->GetPredictor());
+
+    auto trainBinned = [&](size_t maxBinsPerFeature) {
+        trainers::BinnedHistogramForestTrainerParameters binnedParameters;
+        binnedParameters.minSplitGain = 0.0;
+        binnedParameters.maxSplitsPerRound = 4;
+        binnedParameters.numRounds = 3;
+        binnedParameters.maxBinsPerFeature = maxBinsPerFeature;
+        auto binnedTrainer = trainers::MakeBinnedHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), binnedParameters);
+        binnedTrainer->SetDataset(dataset.GetAnyDataset());
+        binnedTrainer->Update();
+        return getPredictions(binnedTrainer->GetPredictor());
+    };
+
+    // with a bin for every distinct value, the binned trainer considers the same splits as the exhaustive histogram trainer
+    auto exactPredictions = trainBinned(1024);
+    bool sameAsHistogram = true;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        sameAsHistogram = sameAsHistogram && std::abs(exactPredictions[i] - histogramPredictions[i]) < 1.0e-8;
+    }
+
+    // with few bins, the forest should still fit the data
+    auto binnedErrorRate = getErrorRate(trainBinned(16));
+
+    testing::ProcessTest("TestBinnedHistogramForestTrainer, matches exhaustive histogram trainer", sameAsHistogram);
+    testing::ProcessTest("TestBinnedHistogramForestTrainer, quantized features", binnedErrorRate < 0.1);
+}
+
 int main()
 {
     TestSDCATrainer();
     TestSGDTrainer();
+    TestParallelSparseDataSGDTrainer();
+    TestSingleThreadedSGDTrainers();
+    TestMappedDatasetParallelSparseDataSGDTrainer();
+    TestParallelSDCATrainer();
+    TestMultiClassSGDTrainer();
+    TestKMeansTrainer();
     TestMeanCalculator();
+    TestSweepingTrainer();
+    TestBinnedHistogramForestTrainer();
 }
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (trainers)
+//  Authors:  Ofer Dekel
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OutOfCoreTrainingTiming.h"
+#include "SparseBinaryTrainingTiming.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <iostream>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    // With a file size argument, in GB, only runs the out-of-core benchmark on a dataset of that size (for example, 5
+    // times the size of the physical memory), in the current directory
+    if (argc > 1)
+    {
+        auto fileSize = static_cast<size_t>(std::stod(argv[1]) * (1 << 30));
+        const size_t numFeatures = 100000, numActiveFeatures = 200;
+        auto numExamples = fileSize / GetBinaryDatasetExampleSize(numActiveFeatures);
+        TimeMappedDatasetSGDEpoch("trainers_timing.elldata", numExamples, numFeatures, numActiveFeatures, 1, false);
+        return testing::DidTestFail() ? 1 : 0;
+    }
+
+    // void TimeCompressedIntegerListDecode(size_t numEntries, size_t maxGap, size_t numIterations);
+    TimeCompressedIntegerListDecode(1000, 100, 10000);
+    TimeCompressedIntegerListDecode(1000000, 100, 20);
+    TimeCompressedIntegerListDecode(1000000, 100000, 20);
+
+    // void TimeSparseBinarySGDEpoch(size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs);
+    TimeSparseBinarySGDEpoch(10000, 1000, 20, 5);
+    TimeSparseBinarySGDEpoch(10000, 10000, 100, 2);
+    TimeSparseBinarySGDEpoch(1000, 100000, 1000, 2);
+
+    // void TimeMappedDatasetSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numEpochs, bool compareInMemory);
+    TimeMappedDatasetSGDEpoch("trainers_timing.elldata", 20000, 10000, 100, 2, true);
+
+    // void TimeBinaryDatasetReload(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numIterations);
+    TimeBinaryDatasetReload("trainers_timing.elldata", 20000, 10000, 100, 3);
+
+    // void TimePrefetchedTextSGDEpoch(const std::string& filename, size_t numExamples, size_t numFeatures, size_t numActiveFeatures, size_t numParserThreads);
+    TimePrefetchedTextSGDEpoch("trainers_timing.txt", 20000, 10000, 100, 2);
+
+    return testing::DidTestFail() ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BoundedQueue.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A fixed-capacity, lock-free queue between one producer thread and one consumer thread. Neither side ever blocks:
+    /// pushing to a full queue or popping from an empty one fails, and the caller decides how to wait.
+    /// </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the values in the queue. Must be default-constructible and movable. </typeparam>
+    template <typename ValueType>
+    class BoundedQueue
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="capacity"> The maximum number of values in the queue. Must be positive. </param>
+        BoundedQueue(size_t capacity);
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /// <summary> Returns the maximum number of values in the queue. </summary>
+        ///
+        /// <returns> The capacity of the queue. </returns>
+        size_t Capacity() const { return _buffer.size(); }
+
+        /// <summary> Adds a value at the back of the queue, if there's room for it. Only called by the producer thread. </summary>
+        ///
+        /// <param name="value"> The value, which is moved into the queue on success, and left unchanged otherwise. </param>
+        ///
+        /// <returns> true if the value was added, false if the queue is full. </returns>
+        bool TryPush(ValueType&& value);
+
+        /// <summary> Removes the value at the front of the queue, if there is one. Only called by the consumer thread. </summary>
+        ///
+        /// <param name="value"> [out] The value removed from the queue. Unchanged if the queue is empty. </param>
+        ///
+        /// <returns> true if a value was removed, false if the queue is empty. </returns>
+        bool TryPop(ValueType& value);
+
+    private:
+        // the head is only written by the consumer and the tail only by the producer; the padding keeps them on
+        // separate cache lines, so the two threads don't invalidate each other's cached copy on every operation
+        std::vector<ValueType> _buffer;
+        std::atomic<size_t> _head;
+        char _headPadding[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> _tail;
+        char _tailPadding[64 - sizeof(std::atomic<size_t>)];
+    };
+}
+}
+
+#include "../tcc/BoundedQueue.tcc"
@@ -18,10 +18,25 @@ namespace ell
 namespace utilities
 {
     /// <summary> A non-decreasing list of nonegative integers, with a forward Iterator, stored in a
-    /// compressed delta enconding. </summary>
+    /// compressed delta enconding.
+    ///
+    /// The deltas between consecutive entries are stored in groups of 4, in group varint format: each group starts with
+    /// a control byte, which holds the number of bytes (1 to 4) of each delta in the group, followed by the bytes of the
+    /// deltas. The groups form blocks of `blockSize` entries, and the list keeps a skip entry for each block, so that
+    /// blocks can be decoded independently of each other (and, where the CPU supports it, with SIMD shuffles).
+    /// Consecutive entries may differ by at most 2^32 - 1. </summary>
     class CompressedIntegerList
     {
+        struct BlockEntry
+        {
+            size_t base; // the last entry of the previous block
+            size_t offset; // the position of the block's first control byte in the encoded data
+        };
+
     public:
+        /// <summary> The number of entries in a block. </summary>
+        static constexpr size_t blockSize = 128;
+
         /// <summary> A read-only forward iterator for the CompressedIntegerList. </summary>
         class Iterator
         {
@@ -35,26 +50,44 @@ namespace utilities
             /// <summary> Query if this object input stream valid. </summary>
             ///
             /// <returns> true if it succeeds, false if it fails. </returns>
-            bool IsValid() const { return _iter < _end; }
+            bool IsValid() const { return _index < _size; }
 
             /// <summary> Proceeds to the Next iterate. </summary>
-            void Next();
+            void Next()
+            {
+                if ((++_index & 3) == 0 && _index < _size)
+                {
+                    DecodeNextGroup();
+                }
+            }
 
             /// <summary> Returns the value of the current iterate. </summary>
             ///
             /// <returns> An size_t. </returns>
-            size_t Get() const { return _value; }
+            size_t Get() const { return _values[_index & 3]; }
+
+            /// <summary> Proceeds to the first iterate whose value is greater than or equal to a given value, using
+            /// the list's skip entries to jump over whole blocks. Does nothing if the current value is already greater
+            /// than or equal to the given value. </summary>
+            ///
+            /// <param name="value"> The value to skip to. </param>
+            void SkipTo(size_t value);
 
         private:
             // private ctor, can only be called from CompressedIntegerList class
-            Iterator(const uint8_t* iter, const uint8_t* end);
+            Iterator(const CompressedIntegerList& list);
             friend class CompressedIntegerList;
 
+            void DecodeNextGroup();
+
             // members
-            const uint8_t* _iter;
-            const uint8_t* _end;
-            size_t _value;
-            size_t _iter_increment;
+            const uint8_t* _begin = nullptr;
+            const uint8_t* _iter = nullptr;
+            const BlockEntry* _blocks = nullptr;
+            size_t _numBlockEntries = 0;
+            size_t _index = 0;
+            size_t _size = 0;
+            size_t _values[4] = { 0, 0, 0, 0 };
         };
 
         /// <summary> Default Constructor. Constructs an empty list. </summary>
@@ -94,10 +127,25 @@ namespace utilities
         /// <summary> Returns an `Iterator` that points to the beginning of the list. </summary>
         ///
         /// <returns> The iterator. </returns>
-        Iterator GetIterator() const { return Iterator(_data.data(), _data.data() + _data.size()); }
+        Iterator GetIterator() const { return Iterator(*this); }
+
+        /// <summary> Returns the number of blocks in the list. Every block but the last one holds `blockSize` entries. </summary>
+        ///
+        /// <returns> The number of blocks. </returns>
+        size_t NumBlocks() const { return (_size + blockSize - 1) / blockSize; }
+
+        /// <summary> Decodes all the entries of a block at once. </summary>
+        ///
+        /// <param name="blockIndex"> The zero-based index of the block. </param>
+        /// <param name="values"> Pointer to an array of at least `blockSize` elements, which receives the entries. </param>
+        ///
+        /// <returns> The number of entries in the block. </returns>
+        size_t DecodeBlock(size_t blockIndex, size_t* values) const;
 
     private:
         std::vector<uint8_t> _data;
+        std::vector<BlockEntry> _blocks; // the entry of block b is at _blocks[b - 1], since the first block needs none
+        size_t _groupStart;
         size_t _last;
         size_t _size;
     };
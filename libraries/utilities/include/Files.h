@@ -134,6 +134,11 @@ namespace utilities
     /// <returns> The path. </returns>
     std::string GetWorkingDirectory();
 
+    /// <summary> Returns the directory to use for temporary files, from the TMPDIR, TMP or TEMP environment variables if they are set. </summary>
+    ///
+    /// <returns> The path. </returns>
+    std::string GetTempDirectory();
+
     /// <summary> Find a program using the current user PATH environment. </summary>
     ///
     /// <param name="name"> The name of the executable to find. </param>
@@ -20,6 +20,9 @@ namespace utilities
     class IntegerList
     {
     public:
+        /// <summary> The number of entries in a block. </summary>
+        static constexpr size_t blockSize = 128;
+
         /// <summary> Defines an alias representing the vector iterator. </summary>
         typedef std::vector<size_t>::const_iterator vector_iterator;
 
@@ -92,6 +95,19 @@ namespace utilities
         /// <returns> The iterator. </returns>
         Iterator GetIterator() const;
 
+        /// <summary> Returns the number of blocks in the list. Every block but the last one holds `blockSize` entries. </summary>
+        ///
+        /// <returns> The number of blocks. </returns>
+        size_t NumBlocks() const { return (_list.size() + blockSize - 1) / blockSize; }
+
+        /// <summary> Copies all the entries of a block at once. </summary>
+        ///
+        /// <param name="blockIndex"> The zero-based index of the block. </param>
+        /// <param name="values"> Pointer to an array of at least `blockSize` elements, which receives the entries. </param>
+        ///
+        /// <returns> The number of entries in the block. </returns>
+        size_t DecodeBlock(size_t blockIndex, size_t* values) const;
+
     private:
         // The list
         std::vector<size_t> _list;
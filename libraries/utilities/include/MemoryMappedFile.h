@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> A read-only view of a file, mapped into memory. Pages of the file are read by the OS when they are
+    /// first accessed, and can be evicted under memory pressure, so the file can be larger than the physical memory. </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Hints about the order in which the mapped file will be accessed. </summary>
+        enum class AccessPattern
+        {
+            normal,
+            sequential,
+            random
+        };
+
+        /// <summary> Maps a file into memory, and throws an exception if a problem occurs. </summary>
+        ///
+        /// <param name="filepath"> The path. </param>
+        MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(MemoryMappedFile&& other);
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+
+        ~MemoryMappedFile();
+
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// <summary> Returns a pointer to the first byte of the file. </summary>
+        ///
+        /// <returns> Pointer to the mapped data, or nullptr if the file is empty. </returns>
+        const uint8_t* GetData() const { return _data; }
+
+        /// <summary> Returns the size of the file. </summary>
+        ///
+        /// <returns> The size of the file, in bytes. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Tells the OS how the whole file will be accessed, which affects how much it reads ahead. </summary>
+        ///
+        /// <param name="accessPattern"> The access pattern. </param>
+        void SetAccessPattern(AccessPattern accessPattern) const;
+
+        /// <summary> Asks the OS to start reading a range of the file into memory, without waiting for it. Does
+        /// nothing on platforms that don't support it. </summary>
+        ///
+        /// <param name="offset"> Offset of the first byte of the range. </param>
+        /// <param name="size"> Size of the range, in bytes. </param>
+        void Prefetch(size_t offset, size_t size) const;
+
+    private:
+        void Unmap();
+
+        uint8_t* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+}
+}
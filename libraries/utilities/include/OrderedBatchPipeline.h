@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OrderedBatchPipeline.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A three-stage pipeline that processes a stream of batches: a reader thread produces input batches, a set of worker
+    /// threads turn them into output batches, and the calling thread consumes the output batches in the order they were read.
+    /// The number of batches in flight is bounded, so memory use doesn't depend on the length of the stream.
+    /// </summary>
+    ///
+    /// <typeparam name="InputBatchType"> The type of batch produced by the reader. Must be default-constructible and movable. </typeparam>
+    /// <typeparam name="OutputBatchType"> The type of batch produced by the workers. Must be default-constructible and movable. </typeparam>
+    template <typename InputBatchType, typename OutputBatchType>
+    class OrderedBatchPipeline
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="numWorkers"> The number of worker threads. If zero, uses the number of hardware threads. </param>
+        /// <param name="maxBatchesInFlight"> The maximum number of batches that have been read but not yet written. If zero, uses twice the number of workers. </param>
+        OrderedBatchPipeline(size_t numWorkers = 0, size_t maxBatchesInFlight = 0);
+
+        /// <summary> Returns the number of worker threads the pipeline uses. </summary>
+        ///
+        /// <returns> The number of worker threads. </returns>
+        size_t NumWorkers() const { return _numWorkers; }
+
+        /// <summary>
+        /// Runs the pipeline until the read function reports the end of the stream, and all the batches read have been written.
+        /// If any of the functions throws, the pipeline stops and the first exception is rethrown on the calling thread.
+        /// </summary>
+        ///
+        /// <param name="readFunction"> Function that fills in the next input batch, called on the reader thread. The type
+        /// signature should be of the form `bool readFunction(InputBatchType& batch)`, and it returns false at the end of the stream. </param>
+        /// <param name="processFunctionFactory"> Function that creates the process function for a worker, called once per worker on the calling
+        /// thread before the pipeline starts. The type signature should be of the form `ProcessFunctionType processFunctionFactory(size_t workerIndex)`,
+        /// where the process function has the form `void processFunction(const InputBatchType& input, OutputBatchType& output)`. Each
+        /// process function is only ever called from its own worker thread, so it can hold state that isn't thread-safe. </param>
+        /// <param name="writeFunction"> Function that consumes an output batch, called on the calling thread in the order the batches were
+        /// read. The type signature should be of the form `void writeFunction(const OutputBatchType& batch)`. </param>
+        ///
+        /// <returns> The number of batches processed. </returns>
+        template <typename ReadFunctionType, typename ProcessFunctionFactoryType, typename WriteFunctionType>
+        size_t Run(ReadFunctionType&& readFunction, ProcessFunctionFactoryType&& processFunctionFactory, WriteFunctionType&& writeFunction);
+
+    private:
+        size_t _numWorkers;
+        size_t _maxBatchesInFlight;
+    };
+}
+}
+
+#include "../tcc/OrderedBatchPipeline.tcc"
@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include "StallStatistics.h"
+#include "ThreadPool.h"
+
 // stl
+#include <chrono>
 #include <future>
+#include <memory>
 #include <vector>
 
 namespace ell
@@ -27,6 +32,18 @@ namespace utilities
         /// <param name="transformFunction"> The function to apply to transform the input items</param>
         ParallelTransformIterator(InputIteratorType& inIter, FuncType transformFunction);
 
+        /// <summary> Constructor that runs the transformations on an existing thread pool, which can be shared with other iterators </summary>
+        ///
+        /// <param name="inIter"> An iterator for the input collection </param>
+        /// <param name="transformFunction"> The function to apply to transform the input items</param>
+        /// <param name="threadPool"> The thread pool that runs the transform function </param>
+        ParallelTransformIterator(InputIteratorType& inIter, FuncType transformFunction, std::shared_ptr<ThreadPool> threadPool);
+
+        ParallelTransformIterator(ParallelTransformIterator&&) = default;
+
+        /// <summary> Destructor. Waits for the outstanding transformations to finish. </summary>
+        ~ParallelTransformIterator();
+
         /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
         ///
         /// <returns> true if it succeeds, false if it fails. </returns>
@@ -40,11 +57,26 @@ namespace utilities
         /// <returns> The result of applying the transformFunction on the current item in the input iterator </returns>
         OutType Get() const;
 
+        /// <summary> Returns the time spent waiting so far: the producer stall time is the time finished results waited for
+        /// the consumer to make room for more work, and the consumer stall time is the time Get waited for a result. </summary>
+        ///
+        /// <returns> The stall statistics. </returns>
+        StallStatistics GetStallStatistics() const;
+
     private:
+        using ClockType = std::chrono::steady_clock;
+
+        void StartTask(size_t index);
+
         InputIteratorType& _inIter;
         FuncType _transformFunction;
+        std::shared_ptr<ThreadPool> _threadPool; // persistent, so that the worker threads aren't created per item
 
         mutable std::vector<std::future<OutType>> _futures; // mutable because future::get() isn't const
+        std::vector<ClockType::time_point> _completionTimes; // written by the task before its future is ready
+        mutable ClockType::duration _consumerStallTime = ClockType::duration::zero();
+        ClockType::duration _producerStallTime = ClockType::duration::zero();
+        mutable size_t _numItems = 0;
         mutable OutType _currentOutput;
         mutable bool _currentOutputValid;
         int _currentIndex = 0;
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PrefetchingIterator.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BoundedQueue.h"
+#include "StallStatistics.h"
+
+// stl
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A read-only forward iterator that reads and transforms the items of an input iterator ahead of the consumer, on
+    /// background threads. A reader thread is the only thread that touches the input iterator, and either transforms the
+    /// items itself or hands them out round-robin to a set of transform threads. The items are passed on through bounded
+    /// lock-free queues, and the consumer receives them in the order they were read. The consumer and the background
+    /// threads therefore overlap, for example parsing the next examples while a trainer learns from the current one.
+    /// A thread that finds its queue empty or full spins briefly and then blocks on a condition variable, so that on a
+    /// machine with few cores it doesn't take processor time from the thread it is waiting for.
+    /// </summary>
+    ///
+    /// <typeparam name="ValueType"> The type of the transformed items. Must be default-constructible and movable. </typeparam>
+    template <typename ValueType>
+    class PrefetchingIterator
+    {
+    public:
+        /// <summary> Constructor. Starts the background threads, and waits for the first item. </summary>
+        ///
+        /// <typeparam name="InputIteratorType"> The input iterator type, with IsValid, Next and Get functions. </typeparam>
+        /// <typeparam name="TransformFunctionType"> The transform function type. </typeparam>
+        /// <param name="inputIterator"> The input iterator, which is moved to the reader thread. </param>
+        /// <param name="transformFunction"> Function that transforms an input item, of the form `ValueType transformFunction(InputType item)`.
+        /// Each transform thread calls its own copy, so it can hold state that isn't thread-safe. </param>
+        /// <param name="queueDepth"> The capacity of each queue between the threads, which bounds how far the background threads read ahead. </param>
+        /// <param name="numTransformThreads"> The number of transform threads. If zero, the reader thread transforms the items itself. </param>
+        template <typename InputIteratorType, typename TransformFunctionType>
+        PrefetchingIterator(InputIteratorType inputIterator, TransformFunctionType transformFunction, size_t queueDepth, size_t numTransformThreads = 0);
+
+        PrefetchingIterator(const PrefetchingIterator&) = delete;
+        PrefetchingIterator& operator=(const PrefetchingIterator&) = delete;
+
+        /// <summary> Destructor. Stops the background threads and waits for them to finish. </summary>
+        ~PrefetchingIterator();
+
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if the iterator is currently pointing to a valid iterate. </returns>
+        bool IsValid() const { return _isValid; }
+
+        /// <summary> Proceeds to the Next iterate, waiting for it if it isn't ready yet. If a background thread threw an
+        /// exception, the exception is rethrown here. </summary>
+        void Next();
+
+        /// <summary> Returns the value of the current iterate. </summary>
+        ///
+        /// <returns> The current transformed item. </returns>
+        const ValueType& Get() const { return _current; }
+
+        /// <summary> Returns the time the background threads and the consumer have spent waiting for each other so far. </summary>
+        ///
+        /// <returns> The stall statistics. </returns>
+        StallStatistics GetStallStatistics() const;
+
+    private:
+        using ClockType = std::chrono::steady_clock;
+
+        template <typename InputIteratorType, typename TransformFunctionType>
+        void StartThreads(InputIteratorType inputIterator, TransformFunctionType transformFunction, size_t numTransformThreads);
+
+        void Stop();
+
+        template <typename QueueValueType>
+        bool Push(BoundedQueue<QueueValueType>& queue, QueueValueType&& value);
+
+        template <typename FunctionType>
+        void RunBackgroundThread(FunctionType&& function);
+
+        void AddProducerStallTime(ClockType::time_point start);
+
+        // spins and then blocks until isReady returns true; every change that can make a wait end is followed by Notify
+        template <typename PredicateType>
+        void WaitUntil(PredicateType&& isReady);
+        void Notify();
+
+        static constexpr size_t numSpinsBeforeBlocking = 64;
+
+        std::vector<std::unique_ptr<BoundedQueue<ValueType>>> _outputQueues;
+        std::vector<std::thread> _threads;
+
+        // state shared with the background threads
+        std::atomic<bool> _stopping;
+        std::atomic<bool> _isReaderDone;
+        std::atomic<size_t> _numRead;
+        std::atomic<bool> _isErrorClaimed;
+        std::atomic<bool> _hasError;
+        std::exception_ptr _error;
+        std::atomic<int64_t> _producerStallNanoseconds;
+        std::mutex _waitMutex;
+        std::condition_variable _waitCondition;
+        std::atomic<size_t> _numBlocked;
+
+        // consumer state
+        ValueType _current;
+        bool _isValid = true;
+        size_t _numConsumed = 0;
+        ClockType::duration _consumerStallTime = ClockType::duration::zero();
+    };
+}
+}
+
+#include "../tcc/PrefetchingIterator.tcc"
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     StallStatistics.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> The time that the two sides of a producer/consumer pipeline spent waiting for each other. A large
+    /// consumer stall time means the producers can't keep up, and a large producer stall time means the consumer
+    /// can't keep up. </summary>
+    struct StallStatistics
+    {
+        /// <summary> Total time, in milliseconds, that the producers spent waiting for room to pass on their output. </summary>
+        double producerStallTime = 0;
+
+        /// <summary> Total time, in milliseconds, that the consumer spent waiting for an item. </summary>
+        double consumerStallTime = 0;
+
+        /// <summary> The number of items the consumer received. </summary>
+        size_t numItems = 0;
+    };
+}
+}
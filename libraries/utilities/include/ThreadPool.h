@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> A fixed-size pool of worker threads that run tasks in the order they're submitted. </summary>
+    class ThreadPool
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="numThreads"> The number of worker threads. If zero, uses the number of hardware threads. </param>
+        ThreadPool(size_t numThreads = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// <summary> Destructor. Finishes the tasks already queued, then joins the worker threads. </summary>
+        ~ThreadPool();
+
+        /// <summary> Returns the number of worker threads in the pool. </summary>
+        ///
+        /// <returns> The number of worker threads. </returns>
+        size_t NumThreads() const { return _threads.size(); }
+
+        /// <summary> Queues a task to be run on one of the worker threads. </summary>
+        ///
+        /// <param name="task"> The task to run. The type signature should be of the form `ResultType task()`. </param>
+        ///
+        /// <returns> A future holding the result of the task, or the exception it threw. </returns>
+        template <typename FunctionType>
+        auto Run(FunctionType&& task) -> std::future<decltype(task())>;
+
+        /// <summary> Calls a function for each index in [0, count) on the worker threads, and waits for all the calls to finish. </summary>
+        ///
+        /// <param name="count"> The number of times to call the function. </param>
+        /// <param name="function"> The function to call. The type signature should be of the form `void function(size_t index)`. </param>
+        template <typename FunctionType>
+        void ParallelFor(size_t count, FunctionType&& function);
+
+        /// <summary> Returns the number of threads to use when a thread count of zero is requested. </summary>
+        ///
+        /// <returns> The number of hardware threads, or 1 if that can't be determined. </returns>
+        static size_t GetDefaultNumThreads();
+
+    private:
+        void Enqueue(std::function<void()> task);
+        void WorkerThread();
+
+        std::vector<std::thread> _threads;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _taskAvailable;
+        bool _stopping = false;
+    };
+}
+}
+
+#include "../tcc/ThreadPool.tcc"
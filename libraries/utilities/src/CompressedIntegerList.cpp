@@ -10,52 +10,135 @@
 #include "Exception.h"
 
 // stl
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <limits>
 
+#if defined(USE_SSSE3_DECODER) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace ell
 {
 namespace utilities
 {
-    void CompressedIntegerList::Iterator::Next()
-    {
-        size_t delta;
-        _iter += _iter_increment;
-        uint8_t first_val = *_iter;
+#if defined(USE_SSSE3_DECODER)
+    // Defined in CompressedIntegerListSsse3.cpp, which is compiled with SSSE3 code generation enabled
+    size_t DecodeGroupsSsse3(const uint8_t*& data, const uint8_t* end, size_t numGroups, uint32_t* deltas);
+#endif
 
-        // chop off top 2 bits --- they encode the # of bytes needed for this delta
-        // 00 = 1 byte, 01 = 2 bytes, 10 = 4 bytes, 11 = 8 bytes
-        int total_bytes = 1 << ((first_val >> 6) & 0x03);
-        assert(total_bytes <= 8);
-        if (total_bytes == 1)
+    namespace
+    {
+        // Decodes the first `count` deltas of the group that starts at `data`, and returns the start of the next group
+        inline const uint8_t* DecodeGroup(const uint8_t* data, size_t count, uint32_t* deltas)
         {
-            // first_val &= 0x3f; // this is commented out because we don't need to strip off the top 2 bits of first_val in this case, because they're always zero
-            delta = first_val;
+            // each pair of bits of the control byte holds the number of bytes of a delta, minus one
+            auto control = *data++;
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto numBytes = ((control >> (2 * i)) & 0x03) + 1;
+                uint32_t delta = 0;
+                std::memcpy(&delta, data, numBytes);
+                deltas[i] = delta;
+                data += numBytes;
+            }
+            return data;
         }
-        else
+
+#if defined(USE_SSSE3_DECODER)
+        bool CpuSupportsSsse3()
         {
-            // read in the Next bytes, shift them over to fit the 6 bits of first_val we're using, and Add first_val
-            delta = 0;
-            std::memcpy(&delta, _iter + 1, total_bytes - 1);
-            delta = (delta << 6) | (first_val & 0x3f);
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[2] & (1 << 9)) != 0;
+#else
+            return __builtin_cpu_supports("ssse3");
+#endif
         }
+#endif
 
-        _iter_increment = total_bytes;
-        _value += delta;
+        // Decodes `numGroups` groups of 4 deltas, as many as possible with SIMD shuffles, and returns the start of the next group
+        const uint8_t* DecodeGroups(const uint8_t* data, const uint8_t* end, size_t numGroups, uint32_t* deltas)
+        {
+            size_t group = 0;
+#if defined(USE_SSSE3_DECODER)
+            static const bool useSsse3 = CpuSupportsSsse3();
+            if (useSsse3)
+            {
+                group = DecodeGroupsSsse3(data, end, numGroups, deltas);
+            }
+#endif
+            for (; group < numGroups; ++group)
+            {
+                data = DecodeGroup(data, 4, deltas + 4 * group);
+            }
+            return data;
+        }
     }
 
-    CompressedIntegerList::Iterator::Iterator(const uint8_t* iter, const uint8_t* end)
-        : _iter(iter), _end(end), _value(0), _iter_increment(0)
+    constexpr size_t CompressedIntegerList::blockSize;
+
+    //
+    // Iterator
+    //
+    CompressedIntegerList::Iterator::Iterator(const CompressedIntegerList& list)
+        : _begin(list._data.data()), _iter(list._data.data()), _blocks(list._blocks.data()), _numBlockEntries(list._blocks.size()), _size(list._size)
     {
         if (IsValid())
+        {
+            DecodeNextGroup();
+        }
+    }
+
+    void CompressedIntegerList::Iterator::DecodeNextGroup()
+    {
+        uint32_t deltas[4];
+        auto count = std::min(_size - _index, static_cast<size_t>(4));
+        _iter = DecodeGroup(_iter, count, deltas);
+
+        // the last value of the previous group is the base of this one
+        auto value = _values[3];
+        for (size_t i = 0; i < count; ++i)
+        {
+            value += deltas[i];
+            _values[i] = value;
+        }
+    }
+
+    void CompressedIntegerList::Iterator::SkipTo(size_t value)
+    {
+        if (!IsValid() || Get() >= value)
+        {
+            return;
+        }
+
+        // The last entry of block b is the base of block b + 1, so the first entry greater than or equal to `value` is in
+        // the first block whose last entry is greater than or equal to `value`
+        auto currentBlock = _index / blockSize;
+        auto blocksEnd = _blocks + _numBlockEntries;
+        auto entry = std::lower_bound(_blocks + currentBlock, blocksEnd, value, [](const BlockEntry& blockEntry, size_t value) { return blockEntry.base < value; });
+        auto block = static_cast<size_t>(entry - _blocks);
+        if (block > currentBlock)
+        {
+            _index = block * blockSize;
+            _iter = _begin + _blocks[block - 1].offset;
+            _values[3] = _blocks[block - 1].base;
+            DecodeNextGroup();
+        }
+
+        while (IsValid() && Get() < value)
         {
             Next();
         }
     }
 
+    //
+    // CompressedIntegerList
+    //
     CompressedIntegerList::CompressedIntegerList()
-        : _last(std::numeric_limits<size_t>::max()), _size(0)
+        : _groupStart(0), _last(std::numeric_limits<size_t>::max()), _size(0)
     {
     }
 
@@ -84,59 +167,94 @@ namespace utilities
     {
         assert(value != std::numeric_limits<size_t>::max()); // special value reserved for initialization
 
-        // calculate the delta from the previous number pushed
-        size_t delta = 0;
-
         // allow the first Append to have a value of zero, but subsequently require an increasing value
+        size_t previous = 0;
         if (_last < std::numeric_limits<size_t>::max())
         {
             assert(value > _last);
+            previous = _last;
         }
-        else
+
+        // compute the delta from the previous number pushed
+        size_t delta = value - previous;
+        if (delta > std::numeric_limits<uint32_t>::max())
         {
-            _last = 0;
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "CompressedIntegerList entries must differ from the previous entry by less than 2^32");
         }
 
-        // compute the delta
-        delta = value - _last;
+        // start a new group, and a new block, if needed
+        auto positionInGroup = _size % 4;
+        if (positionInGroup == 0)
+        {
+            if (_size > 0 && _size % blockSize == 0)
+            {
+                _blocks.push_back({ _last, _data.size() });
+            }
+            _groupStart = _data.size();
+            _data.push_back(0);
+        }
         _last = value;
 
-        // figure out how many bits we need to represent this value
-        int log2bytes = 0;
-        if ((delta & 0xffffffffffffffc0) == 0)
+        // figure out how many bytes we need to represent this delta
+        int numBytes = 1;
+        if (delta > 0xffffff)
         {
-            log2bytes = 0; // just need 1 byte
+            numBytes = 4;
         }
-        else if ((delta & 0xffffffffffffc000) == 0)
+        else if (delta > 0xffff)
         {
-            log2bytes = 1; // two bytes
+            numBytes = 3;
         }
-        else if ((delta & 0xffffffffc0000000) == 0)
+        else if (delta > 0xff)
         {
-            log2bytes = 2; // four bytes
+            numBytes = 2;
         }
-        else
+
+        // record the length in the group's control byte, and write the low-order bytes of the delta first
+        _data[_groupStart] |= static_cast<uint8_t>((numBytes - 1) << (2 * positionInGroup));
+        for (int byteIndex = 0; byteIndex < numBytes; ++byteIndex)
         {
-            log2bytes = 3; // 8 bytes
+            _data.push_back(static_cast<uint8_t>(delta >> (8 * byteIndex)));
         }
 
-        int total_bytes = 1 << log2bytes;
-        _data.resize(_data.size() + total_bytes); // make room for new data
-        uint8_t* buf = _data.data() + _data.size() - total_bytes; // get pointer to correct place in array
-        unsigned int mask = log2bytes << 6; // mask == log2(# bytes) shifted to be high-order 2 bits of a byte
-        // splice the data length encoding in as the top 2 bits of the first byte
-        // So, move all high-order bits of the delta over by 2 to make room, Add the mask, and Add the residual low-order bits of the delta
-        size_t write_val = ((delta << 2) & 0xffffffffffffff00) | mask | (delta & 0x3f);
-        std::memcpy(buf, &write_val, total_bytes);
-
         ++_size;
     }
 
     void CompressedIntegerList::Reset()
     {
         _data.resize(0);
+        _blocks.resize(0);
+        _groupStart = 0;
         _last = std::numeric_limits<size_t>::max();
         _size = 0;
     }
+
+    size_t CompressedIntegerList::DecodeBlock(size_t blockIndex, size_t* values) const
+    {
+        if (blockIndex >= NumBlocks())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Block index exceeds the number of blocks in the list");
+        }
+
+        size_t value = blockIndex == 0 ? 0 : _blocks[blockIndex - 1].base;
+        const uint8_t* data = _data.data() + (blockIndex == 0 ? 0 : _blocks[blockIndex - 1].offset);
+        const uint8_t* end = _data.data() + _data.size();
+        auto count = std::min(_size - blockIndex * blockSize, blockSize);
+
+        uint32_t deltas[blockSize];
+        auto numFullGroups = count / 4;
+        data = DecodeGroups(data, end, numFullGroups, deltas);
+        if (count % 4 != 0)
+        {
+            DecodeGroup(data, count % 4, deltas + 4 * numFullGroups);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            value += deltas[i];
+            values[i] = value;
+        }
+        return count;
+    }
 }
 }
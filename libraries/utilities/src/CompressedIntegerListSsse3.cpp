@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompressedIntegerListSsse3.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// This file is compiled with SSSE3 code generation enabled. Its decoder is only called after checking that the CPU
+// supports those instructions.
+
+// stl
+#include <cstddef>
+#include <cstdint>
+
+#include <tmmintrin.h>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // For each possible control byte, the shuffle that moves the bytes of the group's 4 deltas into 4 32-bit lanes,
+        // and the total number of bytes of the deltas
+        struct GroupShuffleTable
+        {
+            GroupShuffleTable()
+            {
+                for (int control = 0; control < 256; ++control)
+                {
+                    uint8_t sourceByte = 0;
+                    for (int lane = 0; lane < 4; ++lane)
+                    {
+                        int numBytes = ((control >> (2 * lane)) & 0x03) + 1;
+                        for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+                        {
+                            // a shuffle index with its high bit set zeroes the output byte
+                            shuffles[control][4 * lane + byteIndex] = byteIndex < numBytes ? sourceByte++ : 0x80;
+                        }
+                    }
+                    lengths[control] = sourceByte;
+                }
+            }
+
+            alignas(16) uint8_t shuffles[256][16];
+            uint8_t lengths[256];
+        };
+
+        const GroupShuffleTable& GetGroupShuffleTable()
+        {
+            static const GroupShuffleTable table;
+            return table;
+        }
+    }
+
+    // Decodes up to `numGroups` full groups, stopping early if fewer than 16 bytes follow a group's control byte (a
+    // group's deltas take at most 16 bytes, and all of them are loaded at once). Returns the number of groups decoded,
+    // and advances `data` past them.
+    size_t DecodeGroupsSsse3(const uint8_t*& data, const uint8_t* end, size_t numGroups, uint32_t* deltas)
+    {
+        const auto& table = GetGroupShuffleTable();
+        const uint8_t* groupStart = data;
+        size_t group = 0;
+        for (; group < numGroups && end - groupStart > 16; ++group)
+        {
+            auto control = *groupStart;
+            auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(groupStart + 1));
+            auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(table.shuffles[control]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(deltas + 4 * group), _mm_shuffle_epi8(bytes, shuffle));
+            groupStart += 1 + table.lengths[control];
+        }
+        data = groupStart;
+        return group;
+    }
+}
+}
@@ -327,6 +327,25 @@ namespace utilities
         return utf8wd;
     }
 
+    std::string GetTempDirectory()
+    {
+#ifdef WIN32
+#pragma warning(disable : 4996)
+#endif
+        for (auto name : { "TMPDIR", "TMP", "TEMP" })
+        {
+            auto path = getenv(name);
+            if (path != nullptr && DirectoryExists(path))
+            {
+                return path;
+            }
+        }
+#ifdef WIN32
+        return GetWorkingDirectory();
+#else
+        return "/tmp";
+#endif
+    }
 
     std::string FindExecutable(const std::string& name)
     {
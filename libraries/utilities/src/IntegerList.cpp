@@ -10,12 +10,15 @@
 #include "Exception.h"
 
 // stl
+#include <algorithm>
 #include <stdexcept>
 
 namespace ell
 {
 namespace utilities
 {
+    constexpr size_t IntegerList::blockSize;
+
     IntegerList::Iterator::Iterator(const vector_iterator& begin, const vector_iterator& end)
         : _begin(begin), _end(end)
     {
@@ -45,5 +48,18 @@ namespace utilities
     {
         return Iterator(_list.cbegin(), _list.cend());
     }
+
+    size_t IntegerList::DecodeBlock(size_t blockIndex, size_t* values) const
+    {
+        if (blockIndex >= NumBlocks())
+        {
+            throw InputException(InputExceptionErrors::indexOutOfRange, "Block index exceeds the number of blocks in the list");
+        }
+
+        auto begin = _list.begin() + blockIndex * blockSize;
+        auto count = std::min(blockSize, static_cast<size_t>(_list.end() - begin));
+        std::copy(begin, begin + count, values);
+        return count;
+    }
 }
 }
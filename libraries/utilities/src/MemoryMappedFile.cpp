@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <utility>
+
+#ifdef WIN32
+#include <codecvt>
+#include <locale>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ell
+{
+namespace utilities
+{
+#ifdef WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
+        std::wstring wide_path = converter.from_bytes(filepath);
+        HANDLE file = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't open " + filepath);
+        }
+        _fileHandle = file;
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(file, &size);
+        _size = static_cast<size_t>(size.QuadPart);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        _mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        _data = _mappingHandle == nullptr ? nullptr : static_cast<uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr)
+        {
+            Unmap();
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't map " + filepath + " into memory");
+        }
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mappingHandle != nullptr)
+        {
+            CloseHandle(_mappingHandle);
+        }
+        if (_fileHandle != nullptr)
+        {
+            CloseHandle(_fileHandle);
+        }
+        _data = nullptr;
+        _mappingHandle = nullptr;
+        _fileHandle = nullptr;
+        _size = 0;
+    }
+
+    // PORTABILITY the access hints are ignored on Windows, which has no equivalent of madvise on all supported versions
+    void MemoryMappedFile::SetAccessPattern(AccessPattern /*accessPattern*/) const
+    {
+    }
+
+    void MemoryMappedFile::Prefetch(size_t /*offset*/, size_t /*size*/) const
+    {
+    }
+#else
+    namespace
+    {
+        size_t GetPageSize()
+        {
+            static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return pageSize;
+        }
+    }
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        int file = open(filepath.c_str(), O_RDONLY);
+        if (file == -1)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't open " + filepath);
+        }
+
+        struct stat buf;
+        if (fstat(file, &buf) == -1)
+        {
+            close(file);
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't get the size of " + filepath);
+        }
+        _size = static_cast<size_t>(buf.st_size);
+
+        // the mapping stays valid after the file is closed
+        if (_size > 0)
+        {
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, file, 0);
+            if (data == MAP_FAILED)
+            {
+                close(file);
+                throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "Can't map " + filepath + " into memory");
+            }
+            _data = static_cast<uint8_t*>(data);
+        }
+        close(file);
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            munmap(_data, _size);
+        }
+        _data = nullptr;
+        _size = 0;
+    }
+
+    void MemoryMappedFile::SetAccessPattern(AccessPattern accessPattern) const
+    {
+        if (_data == nullptr)
+        {
+            return;
+        }
+
+        int advice = MADV_NORMAL;
+        switch (accessPattern)
+        {
+        case AccessPattern::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessPattern::random:
+            advice = MADV_RANDOM;
+            break;
+        default:
+            break;
+        }
+        madvise(_data, _size, advice);
+    }
+
+    void MemoryMappedFile::Prefetch(size_t offset, size_t size) const
+    {
+        if (_data == nullptr || offset >= _size || size == 0)
+        {
+            return;
+        }
+
+        // madvise needs a page-aligned address
+        auto pageSize = GetPageSize();
+        auto begin = offset - offset % pageSize;
+        auto end = std::min(offset + size, _size);
+        madvise(_data + begin, end - begin, MADV_WILLNEED);
+    }
+#endif
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other)
+        : _data(other._data), _size(other._size)
+    {
+#ifdef WIN32
+        _fileHandle = other._fileHandle;
+        _mappingHandle = other._mappingHandle;
+        other._fileHandle = nullptr;
+        other._mappingHandle = nullptr;
+#endif
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+}
+}
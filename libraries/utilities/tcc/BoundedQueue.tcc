@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BoundedQueue.tcc (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <utility>
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename ValueType>
+    BoundedQueue<ValueType>::BoundedQueue(size_t capacity)
+        : _buffer(capacity), _head(0), _tail(0)
+    {
+        if (capacity == 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Queue capacity must be positive.");
+        }
+    }
+
+    template <typename ValueType>
+    bool BoundedQueue<ValueType>::TryPush(ValueType&& value)
+    {
+        // head and tail count the values popped and pushed so far, and the difference is the number of values in the queue
+        auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _buffer.size())
+        {
+            return false;
+        }
+
+        _buffer[tail % _buffer.size()] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename ValueType>
+    bool BoundedQueue<ValueType>::TryPop(ValueType& value)
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        value = std::move(_buffer[head % _buffer.size()]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+}
+}
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OrderedBatchPipeline.tcc (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "ThreadPool.h"
+
+// stl
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename InputBatchType, typename OutputBatchType>
+    OrderedBatchPipeline<InputBatchType, OutputBatchType>::OrderedBatchPipeline(size_t numWorkers, size_t maxBatchesInFlight)
+        : _numWorkers(numWorkers == 0 ? ThreadPool::GetDefaultNumThreads() : numWorkers)
+    {
+        _maxBatchesInFlight = maxBatchesInFlight == 0 ? 2 * _numWorkers : maxBatchesInFlight;
+    }
+
+    template <typename InputBatchType, typename OutputBatchType>
+    template <typename ReadFunctionType, typename ProcessFunctionFactoryType, typename WriteFunctionType>
+    size_t OrderedBatchPipeline<InputBatchType, OutputBatchType>::Run(ReadFunctionType&& readFunction, ProcessFunctionFactoryType&& processFunctionFactory, WriteFunctionType&& writeFunction)
+    {
+        // create the per-worker state up front, so an exception here doesn't leave any threads behind
+        using ProcessFunctionType = std::decay_t<decltype(processFunctionFactory(size_t{ 0 }))>;
+        std::vector<ProcessFunctionType> processFunctions;
+        processFunctions.reserve(_numWorkers);
+        for (size_t workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+        {
+            processFunctions.push_back(processFunctionFactory(workerIndex));
+        }
+
+        // state shared by all the stages, guarded by `mutex`. A single condition variable is enough, because the
+        // stages only wait on it once per batch.
+        std::mutex mutex;
+        std::condition_variable stateChanged;
+        std::deque<std::pair<size_t, InputBatchType>> inputBatches;
+        std::map<size_t, OutputBatchType> outputBatches;
+        size_t numRead = 0;
+        size_t numInFlight = 0;
+        bool readerDone = false;
+        bool stopping = false;
+        std::exception_ptr error;
+
+        auto stop = [&](std::exception_ptr exception) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+            {
+                error = exception;
+            }
+            stopping = true;
+            stateChanged.notify_all();
+        };
+
+        std::thread reader([&]() {
+            try
+            {
+                while (true)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        stateChanged.wait(lock, [&]() { return stopping || numInFlight < _maxBatchesInFlight; });
+                        if (stopping)
+                        {
+                            break;
+                        }
+                    }
+
+                    InputBatchType batch;
+                    if (!readFunction(batch))
+                    {
+                        break;
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    inputBatches.emplace_back(numRead, std::move(batch));
+                    ++numRead;
+                    ++numInFlight;
+                    stateChanged.notify_all();
+                }
+            }
+            catch (...)
+            {
+                stop(std::current_exception());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            readerDone = true;
+            stateChanged.notify_all();
+        });
+
+        std::vector<std::thread> workers;
+        workers.reserve(_numWorkers);
+        for (size_t workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+        {
+            workers.emplace_back([&, workerIndex]() {
+                auto& processFunction = processFunctions[workerIndex];
+                try
+                {
+                    while (true)
+                    {
+                        std::pair<size_t, InputBatchType> input;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            stateChanged.wait(lock, [&]() { return stopping || readerDone || !inputBatches.empty(); });
+                            if (stopping || inputBatches.empty())
+                            {
+                                break;
+                            }
+                            input = std::move(inputBatches.front());
+                            inputBatches.pop_front();
+                        }
+
+                        OutputBatchType output;
+                        processFunction(static_cast<const InputBatchType&>(input.second), output);
+
+                        std::lock_guard<std::mutex> lock(mutex);
+                        outputBatches.emplace(input.first, std::move(output));
+                        stateChanged.notify_all();
+                    }
+                }
+                catch (...)
+                {
+                    stop(std::current_exception());
+                }
+            });
+        }
+
+        // write the batches on this thread, in the order they were read
+        size_t numWritten = 0;
+        try
+        {
+            while (true)
+            {
+                OutputBatchType output;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    stateChanged.wait(lock, [&]() { return stopping || outputBatches.count(numWritten) != 0 || (readerDone && numWritten == numRead); });
+                    auto iter = outputBatches.find(numWritten);
+                    if (stopping || iter == outputBatches.end())
+                    {
+                        break;
+                    }
+                    output = std::move(iter->second);
+                    outputBatches.erase(iter);
+                }
+
+                writeFunction(static_cast<const OutputBatchType&>(output));
+
+                std::lock_guard<std::mutex> lock(mutex);
+                ++numWritten;
+                --numInFlight;
+                stateChanged.notify_all();
+            }
+        }
+        catch (...)
+        {
+            stop(std::current_exception());
+        }
+
+        reader.join();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return numWritten;
+    }
+}
+}
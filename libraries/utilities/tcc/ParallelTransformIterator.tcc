@@ -7,7 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // stl
+#include <algorithm>
 #include <thread>
+#include <utility>
 
 #define DEFAULT_MAX_TASKS 8
 
@@ -21,16 +23,28 @@ namespace utilities
 
     template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
     ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::ParallelTransformIterator(InputIteratorType& inIter, FuncType transformFunction)
-        : _inIter(inIter), _transformFunction(transformFunction), _currentOutputValid(false), _currentIndex(0), _endIndex(-1)
+        : ParallelTransformIterator(inIter, transformFunction, nullptr)
     {
-        // Fill the buffer with futures that are the result of calling std::async(transformFunction) on inIter
+    }
+
+    template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
+    ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::ParallelTransformIterator(InputIteratorType& inIter, FuncType transformFunction, std::shared_ptr<ThreadPool> threadPool)
+        : _inIter(inIter), _transformFunction(transformFunction), _threadPool(std::move(threadPool)), _currentOutputValid(false), _currentIndex(0), _endIndex(-1)
+    {
+        // Fill the buffer with futures that are the result of running transformFunction on the thread pool
         int maxTasks = MaxTasks == 0 ? std::thread::hardware_concurrency() : MaxTasks;
         if (maxTasks == 0) // if std::thread::hardware_concurrency isn't implemented, use DEFAULT_MAX_TASKS tasks (maybe this should be 1)
         {
             maxTasks = DEFAULT_MAX_TASKS;
         }
 
+        if (_threadPool == nullptr)
+        {
+            _threadPool = std::make_shared<ThreadPool>(maxTasks);
+        }
+
         _futures.reserve(maxTasks);
+        _completionTimes.resize(maxTasks);
         for (int index = 0; index < maxTasks; index++)
         {
             if (!_inIter.IsValid())
@@ -38,11 +52,26 @@ namespace utilities
                 break;
             }
 
-            _futures.emplace_back(std::async(std::launch::async, _transformFunction, _inIter.Get()));
+            _futures.emplace_back();
+            StartTask(index);
             _inIter.Next();
         }
     }
 
+    template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
+    ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::~ParallelTransformIterator()
+    {
+        // unlike the futures returned by std::async, these don't wait for their task when destroyed, and the tasks
+        // write to _completionTimes
+        for (auto& future : _futures)
+        {
+            if (future.valid())
+            {
+                future.wait();
+            }
+        }
+    }
+
     template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
     void ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::Next()
     {
@@ -50,12 +79,21 @@ namespace utilities
         {
             return;
         }
-        _currentOutputValid = false;
 
-        // If necessary, create new std::future to handle next input
+        // If necessary, start a new task to handle next input
         if (_inIter.IsValid())
         {
-            _futures[_currentIndex] = std::async(std::launch::async, _transformFunction, _inIter.Get());
+            // the worker that finished the current result had to wait for it to be consumed before getting this task
+            if (_currentOutputValid)
+            {
+                _producerStallTime += std::max(ClockType::now() - _completionTimes[_currentIndex], ClockType::duration::zero());
+            }
+            else
+            {
+                _futures[_currentIndex].wait();
+            }
+
+            StartTask(_currentIndex);
             _inIter.Next();
         }
         else
@@ -65,6 +103,7 @@ namespace utilities
                 _endIndex = _currentIndex;
             }
         }
+        _currentOutputValid = false;
         _currentIndex = (_currentIndex + 1) % _futures.size();
     };
 
@@ -74,13 +113,43 @@ namespace utilities
         // Need to cache output of current std::future, because calling std::future::get() twice is an error
         if (!_currentOutputValid)
         {
-            _currentOutput = _futures[_currentIndex].get();
+            auto& future = _futures[_currentIndex];
+            if (future.wait_for(ClockType::duration::zero()) != std::future_status::ready)
+            {
+                auto start = ClockType::now();
+                future.wait();
+                _consumerStallTime += ClockType::now() - start;
+            }
+
+            _currentOutput = future.get();
             _currentOutputValid = true;
+            ++_numItems;
         }
 
         return _currentOutput;
     }
 
+    template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
+    StallStatistics ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::GetStallStatistics() const
+    {
+        StallStatistics statistics;
+        statistics.producerStallTime = std::chrono::duration<double, std::milli>(_producerStallTime).count();
+        statistics.consumerStallTime = std::chrono::duration<double, std::milli>(_consumerStallTime).count();
+        statistics.numItems = _numItems;
+        return statistics;
+    }
+
+    template <typename InputIteratorType, typename OutType, typename FuncType, int MaxTasks>
+    void ParallelTransformIterator<InputIteratorType, OutType, FuncType, MaxTasks>::StartTask(size_t index)
+    {
+        auto completionTime = &_completionTimes[index];
+        _futures[index] = _threadPool->Run([transformFunction = _transformFunction, input = _inIter.Get(), completionTime]() mutable {
+            auto output = transformFunction(input);
+            *completionTime = ClockType::now();
+            return output;
+        });
+    }
+
     template <typename InputIteratorType, typename FuncType>
     auto MakeParallelTransformIterator(InputIteratorType& inIterator, FuncType transformFunction) -> ParallelTransformIterator<InputIteratorType, decltype(transformFunction(inIterator.Get())), FuncType>
     {
@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PrefetchingIterator.tcc (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename ValueType>
+    template <typename InputIteratorType, typename TransformFunctionType>
+    PrefetchingIterator<ValueType>::PrefetchingIterator(InputIteratorType inputIterator, TransformFunctionType transformFunction, size_t queueDepth, size_t numTransformThreads)
+        : _stopping(false), _isReaderDone(false), _numRead(0), _isErrorClaimed(false), _hasError(false), _producerStallNanoseconds(0), _numBlocked(0)
+    {
+        if (queueDepth == 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Queue depth must be positive.");
+        }
+
+        // item i is always passed through queue i % numQueues, which is how the consumer restores the order
+        auto numQueues = std::max(numTransformThreads, size_t{ 1 });
+        for (size_t queueIndex = 0; queueIndex < numQueues; ++queueIndex)
+        {
+            _outputQueues.push_back(std::make_unique<BoundedQueue<ValueType>>(queueDepth));
+        }
+
+        // the destructor doesn't run if the constructor throws, so stop the threads that have started here
+        try
+        {
+            StartThreads(std::move(inputIterator), std::move(transformFunction), numTransformThreads);
+            Next();
+        }
+        catch (...)
+        {
+            Stop();
+            throw;
+        }
+    }
+
+    template <typename ValueType>
+    template <typename InputIteratorType, typename TransformFunctionType>
+    void PrefetchingIterator<ValueType>::StartThreads(InputIteratorType inputIterator, TransformFunctionType transformFunction, size_t numTransformThreads)
+    {
+        auto numQueues = _outputQueues.size();
+        auto queueDepth = _outputQueues[0]->Capacity();
+        if (numTransformThreads == 0)
+        {
+            _threads.emplace_back([this, inputIterator = std::move(inputIterator), transformFunction]() mutable {
+                RunBackgroundThread([&]() {
+                    size_t numRead = 0;
+                    for (; inputIterator.IsValid(); inputIterator.Next(), ++numRead)
+                    {
+                        ValueType value = transformFunction(inputIterator.Get());
+                        if (!Push(*_outputQueues[0], std::move(value)))
+                        {
+                            return;
+                        }
+                    }
+                    _numRead.store(numRead, std::memory_order_release);
+                    _isReaderDone.store(true, std::memory_order_release);
+                    Notify();
+                });
+            });
+        }
+        else
+        {
+            using InputValueType = std::decay_t<decltype(inputIterator.Get())>;
+            auto inputQueues = std::make_shared<std::vector<std::unique_ptr<BoundedQueue<InputValueType>>>>();
+            for (size_t queueIndex = 0; queueIndex < numQueues; ++queueIndex)
+            {
+                inputQueues->push_back(std::make_unique<BoundedQueue<InputValueType>>(queueDepth));
+            }
+
+            _threads.emplace_back([this, inputIterator = std::move(inputIterator), inputQueues, numQueues]() mutable {
+                RunBackgroundThread([&]() {
+                    size_t numRead = 0;
+                    for (; inputIterator.IsValid(); inputIterator.Next(), ++numRead)
+                    {
+                        InputValueType item = inputIterator.Get();
+                        if (!Push(*(*inputQueues)[numRead % numQueues], std::move(item)))
+                        {
+                            return;
+                        }
+                    }
+                    _numRead.store(numRead, std::memory_order_release);
+                    _isReaderDone.store(true, std::memory_order_release);
+                    Notify();
+                });
+            });
+
+            for (size_t threadIndex = 0; threadIndex < numTransformThreads; ++threadIndex)
+            {
+                _threads.emplace_back([this, inputQueues, transformFunction, threadIndex, numQueues]() mutable {
+                    RunBackgroundThread([&]() {
+                        auto& inputQueue = *(*inputQueues)[threadIndex];
+                        auto& outputQueue = *_outputQueues[threadIndex];
+                        InputValueType item;
+                        size_t numTransformed = 0;
+                        while (true)
+                        {
+                            bool isPopped = false;
+                            WaitUntil([&]() {
+                                isPopped = inputQueue.TryPop(item);
+                                return isPopped || _stopping.load(std::memory_order_relaxed) || _isReaderDone.load(std::memory_order_acquire);
+                            });
+
+                            if (isPopped)
+                            {
+                                // the reader may be waiting for the slot this item has freed
+                                Notify();
+                                ValueType value = transformFunction(std::move(item));
+                                if (!Push(outputQueue, std::move(value)))
+                                {
+                                    return;
+                                }
+                                ++numTransformed;
+                            }
+                            else if (_stopping.load(std::memory_order_relaxed))
+                            {
+                                return;
+                            }
+                            else
+                            {
+                                // the reader has finished, so this thread is done once it has transformed its share of the items
+                                auto numRead = _numRead.load(std::memory_order_acquire);
+                                if (numTransformed == numRead / numQueues + (threadIndex < numRead % numQueues ? 1 : 0))
+                                {
+                                    return;
+                                }
+                            }
+                        }
+                    });
+                });
+            }
+        }
+    }
+
+    template <typename ValueType>
+    PrefetchingIterator<ValueType>::~PrefetchingIterator()
+    {
+        Stop();
+    }
+
+    template <typename ValueType>
+    void PrefetchingIterator<ValueType>::Stop()
+    {
+        _stopping.store(true);
+        Notify();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+        _threads.clear();
+    }
+
+    template <typename ValueType>
+    void PrefetchingIterator<ValueType>::Next()
+    {
+        if (!_isValid)
+        {
+            return;
+        }
+
+        auto& queue = *_outputQueues[_numConsumed % _outputQueues.size()];
+        if (queue.TryPop(_current))
+        {
+            ++_numConsumed;
+            Notify();
+            return;
+        }
+
+        auto start = ClockType::now();
+        bool isPopped = false;
+        WaitUntil([&]() {
+            isPopped = queue.TryPop(_current);
+            return isPopped || _hasError.load(std::memory_order_acquire) || (_isReaderDone.load(std::memory_order_acquire) && _numConsumed == _numRead.load(std::memory_order_acquire));
+        });
+        _consumerStallTime += ClockType::now() - start;
+
+        if (isPopped)
+        {
+            ++_numConsumed;
+            Notify();
+            return;
+        }
+
+        _isValid = false;
+        if (_hasError.load(std::memory_order_acquire))
+        {
+            std::rethrow_exception(_error);
+        }
+    }
+
+    template <typename ValueType>
+    StallStatistics PrefetchingIterator<ValueType>::GetStallStatistics() const
+    {
+        StallStatistics statistics;
+        statistics.producerStallTime = static_cast<double>(_producerStallNanoseconds.load(std::memory_order_relaxed)) / 1.0e6;
+        statistics.consumerStallTime = std::chrono::duration<double, std::milli>(_consumerStallTime).count();
+        statistics.numItems = _numConsumed;
+        return statistics;
+    }
+
+    template <typename ValueType>
+    template <typename QueueValueType>
+    bool PrefetchingIterator<ValueType>::Push(BoundedQueue<QueueValueType>& queue, QueueValueType&& value)
+    {
+        if (queue.TryPush(std::move(value)))
+        {
+            Notify();
+            return true;
+        }
+
+        auto start = ClockType::now();
+        bool isPushed = false;
+        WaitUntil([&]() {
+            isPushed = queue.TryPush(std::move(value));
+            return isPushed || _stopping.load(std::memory_order_relaxed);
+        });
+        AddProducerStallTime(start);
+
+        if (isPushed)
+        {
+            Notify();
+        }
+        return isPushed;
+    }
+
+    template <typename ValueType>
+    template <typename FunctionType>
+    void PrefetchingIterator<ValueType>::RunBackgroundThread(FunctionType&& function)
+    {
+        try
+        {
+            function();
+        }
+        catch (...)
+        {
+            // keep the first exception, and stop the other threads
+            if (!_isErrorClaimed.exchange(true))
+            {
+                _error = std::current_exception();
+                _hasError.store(true, std::memory_order_release);
+            }
+            _stopping.store(true);
+            Notify();
+        }
+    }
+
+    template <typename ValueType>
+    void PrefetchingIterator<ValueType>::AddProducerStallTime(ClockType::time_point start)
+    {
+        auto stallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(ClockType::now() - start);
+        _producerStallNanoseconds.fetch_add(static_cast<int64_t>(stallTime.count()), std::memory_order_relaxed);
+    }
+    template <typename ValueType>
+    template <typename PredicateType>
+    void PrefetchingIterator<ValueType>::WaitUntil(PredicateType&& isReady)
+    {
+        // a short wait is cheaper to spin through than to sleep through
+        for (size_t spin = 0; spin < numSpinsBeforeBlocking; ++spin)
+        {
+            if (isReady())
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        // announce the wait before checking again, so that a change made after the check finds a blocked thread to wake
+        std::unique_lock<std::mutex> lock(_waitMutex);
+        _numBlocked.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        _waitCondition.wait(lock, isReady);
+        _numBlocked.fetch_sub(1);
+    }
+
+    template <typename ValueType>
+    void PrefetchingIterator<ValueType>::Notify()
+    {
+        // the fence pairs with the one in WaitUntil: either this thread sees the blocked thread, or that thread sees the change
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_numBlocked.load(std::memory_order_relaxed) > 0)
+        {
+            // taking the lock makes sure that a thread that has announced its wait is inside wait() before it is woken
+            {
+                std::lock_guard<std::mutex> lock(_waitMutex);
+            }
+            _waitCondition.notify_all();
+        }
+    }
+}
+}
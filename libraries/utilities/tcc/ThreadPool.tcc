@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.tcc (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// stl
+#include <memory>
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename FunctionType>
+    auto ThreadPool::Run(FunctionType&& task) -> std::future<decltype(task())>
+    {
+        using ResultType = decltype(task());
+
+        // std::function requires a copyable target, so hold the packaged_task through a shared_ptr
+        auto packagedTask = std::make_shared<std::packaged_task<ResultType()>>(std::forward<FunctionType>(task));
+        auto result = packagedTask->get_future();
+        Enqueue([packagedTask]() { (*packagedTask)(); });
+        return result;
+    }
+
+    template <typename FunctionType>
+    void ThreadPool::ParallelFor(size_t count, FunctionType&& function)
+    {
+        std::vector<std::future<void>> results;
+        results.reserve(count);
+        for (size_t index = 0; index < count; ++index)
+        {
+            results.push_back(Run([&function, index]() { function(index); }));
+        }
+
+        // Wait for all the tasks before rethrowing, so none of them outlive `function`
+        for (auto& result : results)
+        {
+            result.wait();
+        }
+        for (auto& result : results)
+        {
+            result.get();
+        }
+    }
+}
+}
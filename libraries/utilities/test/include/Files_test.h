@@ -11,5 +11,6 @@ namespace ell
 {
     void TestStringf();
     void TestJoinPaths(const std::string& basePath);
+    void TestGetTempDirectory();
     void TestUnicodePaths(const std::string& basePath);
 }
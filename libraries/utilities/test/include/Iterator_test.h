@@ -11,6 +11,10 @@ namespace ell
 void TestIteratorAdapter();
 void TestTransformIterator();
 void TestParallelTransformIterator();
+void TestParallelTransformIteratorThreadPool();
+void TestBoundedQueue();
+void TestPrefetchingIterator();
+void TestPrefetchingIteratorException();
 
 void TestStlStridedIterator();
 }
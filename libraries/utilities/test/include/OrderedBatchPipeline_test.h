@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OrderedBatchPipeline_test.h (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace ell
+{
+void TestOrderedBatchPipelineOrder();
+void TestOrderedBatchPipelineWorkerState();
+void TestOrderedBatchPipelineException();
+}
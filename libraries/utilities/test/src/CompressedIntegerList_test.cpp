@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompressedIntegerList_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompressedIntegerList_test.h"
+
+// utilities
+#include "CompressedIntegerList.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+namespace
+{
+    // An increasing list whose gaps need 1, 2, 3 and 4 bytes, long enough to span several blocks and end with a partial group
+    std::vector<size_t> GetIncreasingValues(size_t count)
+    {
+        std::default_random_engine engine(1234);
+        std::uniform_int_distribution<int> numBytesDistribution(0, 3);
+        std::vector<size_t> values;
+        size_t value = 0;
+        for (size_t index = 0; index < count; ++index)
+        {
+            const size_t maxGaps[] = { 0xff, 0xffff, 0xffffff, 0xffffffff };
+            std::uniform_int_distribution<size_t> gapDistribution(1, maxGaps[numBytesDistribution(engine)]);
+            value += index == 0 ? 0 : gapDistribution(engine);
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    utilities::CompressedIntegerList GetCompressedIntegerList(const std::vector<size_t>& values)
+    {
+        utilities::CompressedIntegerList list;
+        for (auto value : values)
+        {
+            list.Append(value);
+        }
+        return list;
+    }
+}
+
+void TestCompressedIntegerListIterator()
+{
+    bool passed = true;
+    for (size_t count : { 0, 1, 4, 7, 128, 1000 })
+    {
+        auto values = GetIncreasingValues(count);
+        auto list = GetCompressedIntegerList(values);
+
+        std::vector<size_t> decoded;
+        auto iterator = list.GetIterator();
+        while (iterator.IsValid())
+        {
+            decoded.push_back(iterator.Get());
+            iterator.Next();
+        }
+        passed = passed && list.Size() == count && decoded == values && (count == 0 || list.Max() == values.back());
+    }
+    testing::ProcessTest("CompressedIntegerList::Iterator", passed);
+}
+
+void TestCompressedIntegerListDecodeBlock()
+{
+    bool passed = true;
+    for (size_t count : { 1, 5, 128, 129, 1000 })
+    {
+        auto values = GetIncreasingValues(count);
+        auto list = GetCompressedIntegerList(values);
+
+        std::vector<size_t> decoded;
+        size_t block[utilities::CompressedIntegerList::blockSize];
+        for (size_t blockIndex = 0; blockIndex < list.NumBlocks(); ++blockIndex)
+        {
+            auto blockCount = list.DecodeBlock(blockIndex, block);
+            decoded.insert(decoded.end(), block, block + blockCount);
+        }
+        passed = passed && list.NumBlocks() == (count + 127) / 128 && decoded == values;
+    }
+    testing::ProcessTest("CompressedIntegerList::DecodeBlock", passed);
+}
+
+void TestCompressedIntegerListSkipTo()
+{
+    auto values = GetIncreasingValues(1000);
+    auto list = GetCompressedIntegerList(values);
+
+    // skip to every entry, and to the values between entries, from the start and from the previous position
+    bool passed = true;
+    auto forwardIterator = list.GetIterator();
+    for (size_t index = 0; index < values.size(); ++index)
+    {
+        auto iterator = list.GetIterator();
+        iterator.SkipTo(values[index]);
+        passed = passed && iterator.IsValid() && iterator.Get() == values[index];
+
+        forwardIterator.SkipTo(values[index] - (index == 0 ? 0 : 1));
+        passed = passed && forwardIterator.IsValid() && forwardIterator.Get() == values[index];
+    }
+
+    auto iterator = list.GetIterator();
+    iterator.SkipTo(values.back() + 1);
+    passed = passed && !iterator.IsValid();
+    testing::ProcessTest("CompressedIntegerList::Iterator::SkipTo", passed);
+}
+}
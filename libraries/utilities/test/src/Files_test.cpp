@@ -63,6 +63,11 @@ namespace ell
         return testdir;
     }
 
+    void TestGetTempDirectory()
+    {
+        testing::ProcessTest("GetTempDirectory", ell::utilities::DirectoryExists(ell::utilities::GetTempDirectory()));
+    }
+
     void TestUnicodePaths(const std::string& basePath)
     {
         auto testdir = GetUnicodeTestPath(basePath);
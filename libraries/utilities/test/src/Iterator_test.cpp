@@ -10,10 +10,13 @@
 #include "Iterator_test.h"
 
 // utilities
+#include "BoundedQueue.h"
 #include "IIterator.h"
 #include "ParallelTransformIterator.h"
+#include "PrefetchingIterator.h"
 #include "StlContainerIterator.h"
 #include "StlStridedIterator.h"
+#include "ThreadPool.h"
 #include "TransformIterator.h"
 
 // testing
@@ -22,7 +25,10 @@
 // stl
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 namespace ell
@@ -139,6 +145,149 @@ void TestParallelTransformIterator()
     std::cout << "Elapsed time: " << elapsed << " ms" << std::endl;
 }
 
+void TestParallelTransformIteratorThreadPool()
+{
+    std::vector<int> vec(64);
+    std::iota(vec.begin(), vec.end(), 5);
+
+    // two iterators in a row, on the same persistent pool
+    auto threadPool = std::make_shared<utilities::ThreadPool>(2);
+    bool passed = true;
+    size_t numItems = 0;
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        auto srcIt = utilities::MakeStlContainerReferenceIterator(vec.begin(), vec.end());
+        utilities::ParallelTransformIterator<decltype(srcIt), float, decltype(&twoPointFiveTimes), 4> transIt(srcIt, twoPointFiveTimes, threadPool);
+        int index = 0;
+        while (transIt.IsValid())
+        {
+            passed = passed && transIt.Get() == float(2.5 * vec[index]);
+            transIt.Next();
+            index++;
+        }
+        numItems += transIt.GetStallStatistics().numItems;
+    }
+    testing::ProcessTest("utilities::ParallelTransformIterator with thread pool", passed && numItems == 2 * vec.size());
+}
+
+void TestBoundedQueue()
+{
+    utilities::BoundedQueue<std::unique_ptr<int>> queue(3);
+    bool passed = true;
+    int next = 0;
+    int expected = 0;
+
+    // fill and drain the queue several times, so that it wraps around
+    for (int round = 0; round < 4; ++round)
+    {
+        auto value = std::make_unique<int>(next);
+        while (queue.TryPush(std::move(value)))
+        {
+            value = std::make_unique<int>(++next);
+        }
+        passed = passed && value != nullptr && *value == next; // a failed push leaves the value alone
+
+        std::unique_ptr<int> poppedValue;
+        while (queue.TryPop(poppedValue))
+        {
+            passed = passed && *poppedValue == expected++;
+        }
+    }
+    testing::ProcessTest("utilities::BoundedQueue", passed && expected == next && queue.Capacity() == 3);
+}
+
+void TestPrefetchingIterator()
+{
+    std::vector<int> vec(1000);
+    std::iota(vec.begin(), vec.end(), 0);
+
+    for (size_t numTransformThreads : { 0, 1, 4 })
+    {
+        for (size_t queueDepth : { 1, 8 })
+        {
+            auto srcIt = utilities::MakeStlContainerReferenceIterator(vec.begin(), vec.end());
+            utilities::PrefetchingIterator<std::string> prefetchingIterator(srcIt, [](int value) { return std::to_string(value); }, queueDepth, numTransformThreads);
+            bool passed = true;
+            int index = 0;
+            for (; prefetchingIterator.IsValid(); prefetchingIterator.Next())
+            {
+                passed = passed && prefetchingIterator.Get() == std::to_string(vec[index++]);
+            }
+            passed = passed && index == static_cast<int>(vec.size()) && prefetchingIterator.GetStallStatistics().numItems == vec.size();
+            testing::ProcessTest("utilities::PrefetchingIterator with " + std::to_string(numTransformThreads) + " transform threads and queue depth " + std::to_string(queueDepth), passed);
+        }
+    }
+
+    // a slow transform and a slow consumer make both sides wait long enough to block rather than spin
+    for (size_t numTransformThreads : { 0, 2 })
+    {
+        auto srcIt = utilities::MakeStlContainerReferenceIterator(vec.begin(), vec.begin() + 20);
+        auto slowTransform = [](int value) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return value;
+        };
+        utilities::PrefetchingIterator<int> prefetchingIterator(srcIt, slowTransform, 1, numTransformThreads);
+        bool passed = true;
+        int index = 0;
+        for (; prefetchingIterator.IsValid(); prefetchingIterator.Next())
+        {
+            passed = passed && prefetchingIterator.Get() == index++;
+            if (index % 2 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(3));
+            }
+        }
+        testing::ProcessTest("utilities::PrefetchingIterator blocking waits with " + std::to_string(numTransformThreads) + " transform threads", passed && index == 20);
+    }
+
+    // stopping early doesn't wait for the rest of the input
+    auto srcIt = utilities::MakeStlContainerReferenceIterator(vec.begin(), vec.end());
+    {
+        utilities::PrefetchingIterator<int> prefetchingIterator(srcIt, [](int value) { return value; }, 2, 2);
+        prefetchingIterator.Next();
+        testing::ProcessTest("utilities::PrefetchingIterator partial iteration", prefetchingIterator.Get() == 1);
+    }
+
+    // empty input
+    std::vector<int> empty;
+    utilities::PrefetchingIterator<int> emptyIterator(utilities::MakeStlContainerReferenceIterator(empty.begin(), empty.end()), [](int value) { return value; }, 2, 2);
+    testing::ProcessTest("utilities::PrefetchingIterator empty input", !emptyIterator.IsValid());
+}
+
+void TestPrefetchingIteratorException()
+{
+    std::vector<int> vec(100);
+    std::iota(vec.begin(), vec.end(), 0);
+
+    for (size_t numTransformThreads : { 0, 3 })
+    {
+        auto srcIt = utilities::MakeStlContainerReferenceIterator(vec.begin(), vec.end());
+        auto transformFunction = [](int value) {
+            if (value == 50)
+            {
+                throw std::runtime_error("bad value");
+            }
+            return value;
+        };
+        utilities::PrefetchingIterator<int> prefetchingIterator(srcIt, transformFunction, 4, numTransformThreads);
+
+        bool caught = false;
+        int numValues = 0;
+        try
+        {
+            for (; prefetchingIterator.IsValid(); prefetchingIterator.Next())
+            {
+                ++numValues;
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        testing::ProcessTest("utilities::PrefetchingIterator exception with " + std::to_string(numTransformThreads) + " transform threads", caught && numValues <= 50);
+    }
+}
+
 void TestStlStridedIterator()
 {
     std::vector<double> vec(20);
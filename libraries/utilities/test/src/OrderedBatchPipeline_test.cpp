@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     OrderedBatchPipeline_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OrderedBatchPipeline_test.h"
+
+// utilities
+#include "OrderedBatchPipeline.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+void TestOrderedBatchPipelineOrder()
+{
+    const int numBatches = 50;
+    const int batchSize = 10;
+    int nextValue = 0;
+    auto read = [&](std::vector<int>& batch) {
+        if (nextValue >= numBatches * batchSize)
+        {
+            return false;
+        }
+        for (int index = 0; index < batchSize; ++index)
+        {
+            batch.push_back(nextValue++);
+        }
+        return true;
+    };
+
+    // batches take different amounts of time to process, so they finish out of order
+    auto makeProcessFunction = [](size_t) {
+        return [](const std::vector<int>& input, std::vector<int>& output) {
+            std::this_thread::sleep_for(std::chrono::microseconds((input[0] * 7919) % 500));
+            for (auto value : input)
+            {
+                output.push_back(value * value);
+            }
+        };
+    };
+
+    std::vector<int> result;
+    auto write = [&](const std::vector<int>& batch) { result.insert(result.end(), batch.begin(), batch.end()); };
+
+    utilities::OrderedBatchPipeline<std::vector<int>, std::vector<int>> pipeline(4, 3);
+    auto count = pipeline.Run(read, makeProcessFunction, write);
+
+    bool passed = count == numBatches && result.size() == numBatches * batchSize;
+    for (size_t index = 0; passed && index < result.size(); ++index)
+    {
+        passed = result[index] == static_cast<int>(index * index);
+    }
+    testing::ProcessTest("OrderedBatchPipeline preserves batch order", passed);
+}
+
+void TestOrderedBatchPipelineWorkerState()
+{
+    int numBatchesRead = 0;
+    auto read = [&](int& batch) {
+        batch = numBatchesRead;
+        return numBatchesRead++ < 100;
+    };
+
+    // each worker tags its output with its own index, and keeps a count that isn't guarded by a lock
+    std::vector<int> numProcessed(3, 0);
+    auto makeProcessFunction = [&](size_t workerIndex) {
+        return [&numProcessed, workerIndex](const int&, size_t& output) {
+            ++numProcessed[workerIndex];
+            output = workerIndex;
+        };
+    };
+
+    std::set<size_t> workersSeen;
+    auto write = [&](const size_t& workerIndex) { workersSeen.insert(workerIndex); };
+
+    utilities::OrderedBatchPipeline<int, size_t> pipeline(3);
+    auto count = pipeline.Run(read, makeProcessFunction, write);
+
+    bool passed = pipeline.NumWorkers() == 3 && count == 100 && numProcessed[0] + numProcessed[1] + numProcessed[2] == 100;
+    for (auto workerIndex : workersSeen)
+    {
+        passed = passed && workerIndex < 3;
+    }
+    testing::ProcessTest("OrderedBatchPipeline per-worker state", passed);
+}
+
+void TestOrderedBatchPipelineException()
+{
+    int numBatchesRead = 0;
+    auto read = [&](int& batch) {
+        batch = numBatchesRead++;
+        return true; // never ends on its own
+    };
+
+    auto makeProcessFunction = [](size_t) {
+        return [](const int& input, int& output) {
+            if (input == 20)
+            {
+                throw std::runtime_error("batch failed");
+            }
+            output = input;
+        };
+    };
+
+    int numWritten = 0;
+    bool inOrder = true;
+    auto write = [&](const int& batch) {
+        inOrder = inOrder && batch == numWritten;
+        ++numWritten;
+    };
+
+    bool threw = false;
+    try
+    {
+        utilities::OrderedBatchPipeline<int, int> pipeline(2);
+        pipeline.Run(read, makeProcessFunction, write);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("OrderedBatchPipeline exception propagation", threw && inOrder && numWritten <= 20);
+}
+}
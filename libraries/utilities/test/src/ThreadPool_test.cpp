@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool_test.cpp (utilities)
+//  Authors:  Chuck Jacobs
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool_test.h"
+
+// utilities
+#include "ThreadPool.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace ell
+{
+void TestThreadPoolRun()
+{
+    utilities::ThreadPool pool(4);
+    std::vector<std::future<int>> results;
+    for (int index = 0; index < 100; ++index)
+    {
+        results.push_back(pool.Run([index]() { return index * index; }));
+    }
+
+    bool passed = pool.NumThreads() == 4;
+    for (int index = 0; index < 100; ++index)
+    {
+        passed = passed && results[index].get() == index * index;
+    }
+    testing::ProcessTest("ThreadPool::Run", passed);
+}
+
+void TestThreadPoolParallelFor()
+{
+    utilities::ThreadPool pool;
+    std::vector<int> values(1000, 0);
+    std::atomic<int> numCalls(0);
+    pool.ParallelFor(values.size(), [&](size_t index) {
+        values[index] = static_cast<int>(index);
+        ++numCalls;
+    });
+
+    std::vector<int> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    testing::ProcessTest("ThreadPool::ParallelFor", numCalls == static_cast<int>(values.size()) && values == expected);
+}
+
+void TestThreadPoolException()
+{
+    utilities::ThreadPool pool(2);
+    auto result = pool.Run([]() -> int { throw std::runtime_error("task failed"); });
+
+    bool threw = false;
+    try
+    {
+        result.get();
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    // The pool should still be usable after a task throws
+    auto nextResult = pool.Run([]() { return 42; });
+    testing::ProcessTest("ThreadPool exception propagation", threw && nextResult.get() == 42);
+}
+}
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "CompressedIntegerList_test.h"
 #include "Format_test.h"
 #include "FunctionUtils_test.h"
 #include "Archiver_test.h"
@@ -16,6 +17,8 @@
 #include "TypeName_test.h"
 #include "Variant_test.h"
 #include "Files_test.h"
+#include "ThreadPool_test.h"
+#include "OrderedBatchPipeline_test.h"
 #include "Files.h"
 
 // testing
@@ -50,6 +53,10 @@ int main(int argc, char* argv[])
         TestIteratorAdapter();
         TestTransformIterator();
         TestParallelTransformIterator();
+        TestParallelTransformIteratorThreadPool();
+        TestBoundedQueue();
+        TestPrefetchingIterator();
+        TestPrefetchingIteratorException();
         TestStlStridedIterator();
 
         // TypeFactory tests
@@ -96,10 +103,26 @@ int main(int argc, char* argv[])
         // File system tests
         TestStringf();
         TestJoinPaths(basePath);
+        TestGetTempDirectory();
         TestUnicodePaths(basePath);
 
         // PropertyBag tests
         TestPropertyBag();
+
+        // ThreadPool tests
+        TestThreadPoolRun();
+        TestThreadPoolParallelFor();
+        TestThreadPoolException();
+
+        // CompressedIntegerList tests
+        TestCompressedIntegerListIterator();
+        TestCompressedIntegerListDecodeBlock();
+        TestCompressedIntegerListSkipTo();
+
+        // OrderedBatchPipeline tests
+        TestOrderedBatchPipelineOrder();
+        TestOrderedBatchPipelineWorkerState();
+        TestOrderedBatchPipelineException();
     }
     catch (const utilities::Exception& exception)
     {
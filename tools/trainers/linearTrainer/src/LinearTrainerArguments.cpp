@@ -55,5 +55,11 @@ namespace ell
             "seed",
             "The random seed string",
             "ABCDEFG");
+
+        parser.AddOption(miniBatchSize,
+            "miniBatchSize",
+            "mb",
+            "If nonzero, multithreaded SparseDataSGD uses deterministic synchronous mini-batches of this size instead of lock-free updates",
+            0);
     }
 }
@@ -12,6 +12,7 @@
 #include "CommandLineParser.h"
 #include "Exception.h"
 #include "Files.h"
+#include "MillisecondTimer.h"
 #include "OutputStreamImpostor.h"
 
 // data
@@ -106,8 +107,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -134,24 +134,30 @@ int main(int argc, char* argv[])
         using PredictorType = predictors::LinearPredictor<double>;
 
         // create linear trainer
+        trainers::SGDTrainerParameters sgdParameters{ linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString };
+        sgdParameters.numThreads = trainerArguments.numThreads;
+        sgdParameters.miniBatchSize = linearTrainerArguments.miniBatchSize;
+
         std::unique_ptr<trainers::ITrainer<PredictorType>> trainer;
         switch (linearTrainerArguments.algorithm)
         {
         case LinearTrainerArguments::Algorithm::SGD:
-            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, sgdParameters);
             break;
         case LinearTrainerArguments::Algorithm::SparseDataSGD:
-            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSparseDataSGDTrainer(trainerArguments.lossFunctionArguments, sgdParameters);
             break;
         case LinearTrainerArguments::Algorithm::SparseDataCenteredSGD:
             {
                 auto mean = trainers::CalculateMean(mappedDataset.GetAnyDataset());
-                trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
+                trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, sgdParameters);
                 break;
             }
         case LinearTrainerArguments::Algorithm::SDCA:
             {
-                trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString });
+                trainers::SDCATrainerParameters sdcaParameters{ linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString };
+                sdcaParameters.numThreads = trainerArguments.numThreads;
+                trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, sdcaParameters);
                 break;
             }
         default:
@@ -167,10 +173,17 @@ int main(int argc, char* argv[])
         
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
+            utilities::MillisecondTimer timer;
             trainer->Update();
+            auto epochTime = timer.Elapsed();
             evaluator->Evaluate(trainer->GetPredictor());
+
+            if (trainerArguments.verbose)
+            {
+                std::cout << "Epoch " << epoch << " (" << trainerArguments.numThreads << " threads): " << epochTime << " ms, training goodness " << evaluator->GetGoodness() << std::endl;
+            }
         }
-        
+
         // Print loss and errors
         if (trainerArguments.verbose)
         {
@@ -65,7 +65,7 @@ void CreateMap(predictors::ProtoNNPredictor& predictor, ell::model::Map& map)
 
     // add the predictor node, taking input from the input node
     model::PortElements<double> inputElements(inputNode->output);
-    auto predictorNode = model.AddNode<nodes::ProtoNNPredictorNode>(inputElements, predictor);
+    auto predictorNode = model.AddNode<nodes::ProtoNNPredictorNode<double>>(inputElements, predictor);
 
     // add an output node taking input from the predictor node.
     auto outputNode = model.AddNode<model::OutputNode<double>>(predictorNode->output);
@@ -112,8 +112,7 @@ int main(int argc, char* argv[])
 
         mapLoadArguments.defaultInputSize = dataLoadArguments.parsedDataDimension;
         auto map = common::LoadMap(mapLoadArguments);
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
 
         // The problem is NumFeatures returns a random number from sparse dataset depending on the number of trailing zeros it
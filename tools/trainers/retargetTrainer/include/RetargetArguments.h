@@ -33,6 +33,7 @@ namespace ell
         double regularization;
         bool verbose;
         bool multiClass;
+        bool multiClassSGD;
         common::LossFunctionArguments lossFunctionArguments;
         bool useBlas;
     };
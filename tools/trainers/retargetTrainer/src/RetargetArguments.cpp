@@ -58,6 +58,13 @@ namespace ell
             "Indicates whether the input dataset is multi-class or binary.",
             false);
 
+        parser.AddOption(
+            multiClassSGD,
+            "multiClassSGD",
+            "mcsgd",
+            "For a multi-class dataset, train all the one-versus-rest classifiers together with SGD, in a single pass over the data per epoch, instead of training one classifier per class with SDCA. The classes aren't reweighted, and maxEpochs epochs are run.",
+            false);
+
         parser.AddOption(normalize,
             "normalize",
             "n",
@@ -42,10 +42,12 @@
 #include "ConstantNode.h"
 #include "LinearPredictorNode.h"
 #include "MatrixVectorProductNode.h"
+#include "MultiClassLinearPredictorNode.h"
 #include "NeuralNetworkPredictorNode.h"
 #include "SinkNode.h"
 
 // predictors
+#include "MultiClassLinearPredictor.h"
 #include "Normalizer.h"
 
 // stl
@@ -54,8 +56,9 @@
 
 using namespace ell;
 
-// predictor type
+// predictor types
 using PredictorType = predictors::LinearPredictor<double>;
+using MultiClassPredictorType = predictors::MultiClassLinearPredictor<double>;
 
 template <typename ElementType>
 nodes::SinkNode<ElementType>* AppendSinkNodeToMap(model::Map& map, const model::OutputPort<ElementType>& sinkOutput)
@@ -229,6 +232,38 @@ PredictorType RetargetModelUsingLinearPredictor(ParsedRetargetArguments& retarge
     return trainedPredictor;
 }
 
+MultiClassPredictorType RetargetModelUsingMultiClassSGD(ParsedRetargetArguments& retargetArguments, data::AutoSupervisedMultiClassDataset& multiclassDataset)
+{
+    trainers::SGDTrainerParameters trainerParameters{ retargetArguments.regularization, retargetArguments.randomSeedString };
+    auto trainer = common::MakeMultiClassSGDTrainer(retargetArguments.lossFunctionArguments, trainerParameters);
+    if (retargetArguments.verbose) std::cout << "Created multi-class trainer ..." << std::endl;
+
+    // The multi-class trainer reads the class index of each example from its label
+    auto dataset = multiclassDataset.Transform<data::AutoSupervisedExample>([](const auto& example) {
+        return data::AutoSupervisedExample(example.GetSharedDataVector(), data::WeightLabel{ example.GetMetadata().weight, static_cast<double>(example.GetMetadata().classIndex) });
+    });
+
+    // Train the predictor
+    std::cout << "Training ..." << std::endl;
+    trainer->SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < retargetArguments.maxEpochs; ++epoch)
+    {
+        trainer->Update();
+    }
+
+    // Print the training error
+    const auto& predictor = trainer->GetPredictor();
+    size_t numErrors = 0;
+    for (size_t i = 0; i < multiclassDataset.NumExamples(); ++i)
+    {
+        const auto& example = multiclassDataset.GetExample(i);
+        numErrors += predictor.PredictClass(example.GetDataVector()) != example.GetMetadata().classIndex ? 1 : 0;
+    }
+    std::cout << "Training error: " << static_cast<double>(numErrors) / std::max(multiclassDataset.NumExamples(), size_t{ 1 }) << std::endl;
+
+    return predictor;
+}
+
 std::vector<data::AutoSupervisedDataset> CreateDatasetsForOneVersusRest(data::AutoSupervisedMultiClassDataset& multiclassDataset)
 {
     std::vector<data::AutoSupervisedDataset> datasets;
@@ -326,6 +361,54 @@ model::Map GetMultiClassMapFromBinaryPredictors(std::vector<PredictorType>& bina
     return outputMap;
 }
 
+template <typename ElementType>
+model::Map GetMultiClassMapFromMultiClassPredictor(const MultiClassPredictorType& trainedPredictor, model::Map& map)
+{
+    predictors::MultiClassLinearPredictor<ElementType> predictor(trainedPredictor);
+    predictor.Resize(map.GetOutput(0).Size());
+
+    model::Model& model = map.GetModel();
+    auto mapOutput = map.GetOutputElements<ElementType>(0);
+    auto predictorNode = model.AddNode<nodes::MultiClassLinearPredictorNode<ElementType>>(mapOutput, predictor);
+
+    // Apply a sigmoid function so that output can be treated as a probability or
+    // confidence score, as for the binary predictors.
+    auto sigmoidNode = model.AddNode<nodes::BroadcastUnaryFunctionNode<ElementType,nodes::SigmoidActivationFunction<ElementType>>>(
+        predictorNode->output,
+        model::PortMemoryLayout({ static_cast<int>(predictorNode->output.Size()), 1, 1 }),
+        model::PortMemoryLayout({ static_cast<int>(predictorNode->output.Size()), 1, 1 }));
+    auto sinkNode = AppendSinkNodeToMap<ElementType>(map, sigmoidNode->output);
+    auto outputNode = model.AddNode<model::OutputNode<ElementType>>(sinkNode->output);
+
+    auto& output = outputNode->output;
+    auto outputMap = model::Map(model, { { "input", map.GetInput() } }, { { "output", output } });
+
+    return outputMap;
+}
+
+model::Map GetRetargetedModel(const MultiClassPredictorType& trainedPredictor, model::Map& map)
+{
+    model::Map result;
+    // Create a new map with the output of the multi-class predictor appended.
+    switch (map.GetOutputType())
+    {
+    case model::Port::PortType::smallReal:
+    {
+        result = GetMultiClassMapFromMultiClassPredictor<float>(trainedPredictor, map);
+        break;
+    }
+    case model::Port::PortType::real:
+    {
+        result = GetMultiClassMapFromMultiClassPredictor<double>(trainedPredictor, map);
+        break;
+    }
+    default:
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected output type for model. Should be double or float.");
+        break;
+    };
+    return result;
+}
+
 model::Map GetRetargetedModel(std::vector<PredictorType>& binaryPredictors, model::Map& map)
 {
     model::Map result;
@@ -449,26 +532,39 @@ int main(int argc, char* argv[])
             auto dataset = common::TransformDatasetWithCompiledMap(multiclassDataset, map, retargetArguments.useBlas);
             if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
 
-            // Create binary classification datasets for each one versus rest (OVR) case
-            if (retargetArguments.verbose) std::cout << std::endl << "Creating datasets for One vs Rest...";
-            _timer.Start();            
-            auto datasets = CreateDatasetsForOneVersusRest(dataset);
-            if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
-
-            // Next, train a binary classifier for each case and combine into a
-            // single model.
-            _timer.Start();            
-            std::vector<PredictorType> predictors(datasets.size());
-            for (size_t i = 0; i < datasets.size(); ++i)
+            if (retargetArguments.multiClassSGD)
             {
-                std::cout << std::endl << "=== Training binary classifier for class " << i << " vs Rest ===" << std::endl;
+                // Train all the one versus rest (OVR) classifiers together, in one pass over the data per epoch
+                _timer.Start();
+                auto predictor = RetargetModelUsingMultiClassSGD(retargetArguments, dataset);
+                if (retargetArguments.verbose) std::cout << "Training completed ...(" << _timer.Elapsed() << " ms)" << std::endl;
 
-                predictors[i] = RetargetModelUsingLinearPredictor(retargetArguments, datasets[i]);
+                // Save the newly spliced model
+                result = GetRetargetedModel(predictor, map);
+            }
+            else
+            {
+                // Create binary classification datasets for each one versus rest (OVR) case
+                if (retargetArguments.verbose) std::cout << std::endl << "Creating datasets for One vs Rest...";
+                _timer.Start();            
+                auto datasets = CreateDatasetsForOneVersusRest(dataset);
+                if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
+
+                // Next, train a binary classifier for each case and combine into a
+                // single model.
+                _timer.Start();            
+                std::vector<PredictorType> predictors(datasets.size());
+                for (size_t i = 0; i < datasets.size(); ++i)
+                {
+                    std::cout << std::endl << "=== Training binary classifier for class " << i << " vs Rest ===" << std::endl;
+
+                    predictors[i] = RetargetModelUsingLinearPredictor(retargetArguments, datasets[i]);
+                }
+                if (retargetArguments.verbose) std::cout << "Training completed ...(" << _timer.Elapsed() << " ms)" << std::endl;
+
+                // Save the newly spliced model
+                result = GetRetargetedModel(predictors, map);
             }
-            if (retargetArguments.verbose) std::cout << "Training completed ...(" << _timer.Elapsed() << " ms)" << std::endl;
-
-            // Save the newly spliced model
-            result = GetRetargetedModel(predictors, map);
         }
         else
         {
@@ -46,6 +46,7 @@
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 using namespace ell;
 
@@ -75,7 +76,7 @@ int main(int argc, char* argv[])
 
         // manually define regularization parameters to sweep over
         std::vector<double> regularization{ 1.0e-0, 1.0e-1, 1.0e-2, 1.0e-3, 1.0e-4, 1.0e-5, 1.0e-6 };
-        std::vector<std::string> randomSeeds(regularization.size(), defaultRandomSeed);
+        std::vector<std::string> randomSeeds{ defaultRandomSeed };
 
         if (trainerArguments.verbose)
         {
@@ -89,8 +90,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -107,18 +107,33 @@ int main(int argc, char* argv[])
         std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>> evaluators;
         for (size_t i = 0; i < regularization.size(); ++i)
         {
-            auto SGDTrainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, generator.GenerateParameters(i));
+            // each configuration gets its own random seed, so that the configurations shuffle the data independently
+            auto parameters = generator.GenerateParameters(i);
+            parameters.randomSeedString = defaultRandomSeed + std::to_string(i);
+            auto SGDTrainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, parameters);
             evaluators.push_back(common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorParameters, trainerArguments.lossFunctionArguments));
             evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(SGDTrainer), evaluators.back()));
         }
 
         // create meta trainer
-        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), trainerArguments.numThreads);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
         trainer->SetDataset(mappedDataset.GetAnyDataset());
-        trainer->Update();
+        for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
+        {
+            trainer->Update();
+            if (trainerArguments.verbose)
+            {
+                const auto& runStatistics = trainer->GetRunStatistics();
+                std::cout << "Epoch " << epoch << ":\n";
+                for (size_t i = 0; i < runStatistics.size(); ++i)
+                {
+                    std::cout << "  Trainer " << i << ": epoch time " << runStatistics[i].lastUpdateTime << " ms, best goodness " << runStatistics[i].bestGoodness << "\n";
+                }
+            }
+        }
         PredictorType predictor(trainer->GetPredictor());
         predictor.Resize(mappedDatasetDimension);
 
@@ -12,6 +12,7 @@
 #include "CommandLineParser.h"
 
 // stl
+#include <cstddef>
 #include <string>
 
 namespace ell
@@ -24,6 +25,12 @@ struct ApplyArguments
 
     /// <summary> Instead of raw output, report a summary. </summary>
     bool summarize = false;
+
+    /// <summary> Number of threads that run the map (0 means one per hardware thread). </summary>
+    size_t numThreads = 0;
+
+    /// <summary> Number of examples the threads process at a time. </summary>
+    size_t batchSize = 256;
 };
 
 /// <summary> Parsed command line arguments for the apply executable. </summary>
@@ -25,11 +25,29 @@ void ParsedApplyArguments::AddArgs(utilities::CommandLineParser& parser)
         "s",
         "Aggregate and summarize map output.",
         false);
+
+    parser.AddOption(
+        numThreads,
+        "numThreads",
+        "nt",
+        "The number of threads that run the map (0 = one per hardware thread). Not used in summarization mode.",
+        0);
+
+    parser.AddOption(
+        batchSize,
+        "batchSize",
+        "bs",
+        "The number of examples each thread processes at a time. Not used in summarization mode.",
+        256);
 }
 
 utilities::CommandLineParseResult ParsedApplyArguments::PostProcess(const utilities::CommandLineParser& parser)
 {
     std::vector<std::string> errors;
+    if (batchSize == 0)
+    {
+        errors.push_back("batchSize must be positive");
+    }
     return errors;
 }
 }
@@ -12,6 +12,7 @@
 #include "CommandLineParser.h"
 #include "Exception.h"
 #include "Files.h"
+#include "MillisecondTimer.h"
 #include "OutputStreamImpostor.h"
 
 // data
@@ -40,6 +41,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace ell;
 
@@ -121,15 +123,26 @@ int main(int argc, char* argv[])
         // output new dataset mode
         else
         {
-            while (exampleIterator.IsValid())
+            utilities::MillisecondTimer timer;
+            auto writeBatch = [&outputStream](const auto& batch) {
+                for (size_t rowIndex = 0; rowIndex < batch.NumRows(); ++rowIndex)
+                {
+                    auto row = batch.GetRow(rowIndex);
+                    auto mappedExample = data::DenseSupervisedExample(data::FloatDataVector(std::vector<float>(row, row + batch.rowSize)), batch.metadata[rowIndex]);
+                    mappedExample.Print(outputStream);
+                    outputStream << '\n';
+                }
+            };
+            auto numExamples = common::TransformExamples<float>(exampleIterator, map, writeBatch, applyArguments.numThreads, applyArguments.batchSize);
+
+            // report throughput on stderr, since the dataset may be written to stdout
+            auto elapsed = timer.Elapsed();
+            std::cerr << "Transformed " << numExamples << " examples in " << elapsed << " ms";
+            if (elapsed > 0)
             {
-                auto example = exampleIterator.Get();
-                auto mappedDataVector = map.Compute<data::FloatDataVector>(example.GetDataVector());
-                auto mappedExample = data::DenseSupervisedExample(std::move(mappedDataVector), example.GetMetadata());
-                mappedExample.Print(outputStream);
-                outputStream << '\n';
-                exampleIterator.Next();
+                std::cerr << " (" << static_cast<size_t>(1000.0 * numExamples / elapsed) << " rows/sec)";
             }
+            std::cerr << std::endl;
         }
     }
     catch (const utilities::CommandLineParserPrintHelpException& exception)
@@ -119,6 +119,15 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
     TimingOutputCollector timer(timingOutput, "Time to compile map", compileArguments.verbose);
     auto compiledMap = compiler.Compile(map);
     timer.Stop();
+    if (compileArguments.verbose)
+    {
+        const auto& phaseTimings = compiler.GetPhaseTimings();
+        timingOutput << "  Time to refine map: " << phaseTimings.refineTime << " ms\n";
+        timingOutput << "  Time to optimize model: " << phaseTimings.modelOptimizationTime << " ms\n";
+        timingOutput << "  Time to emit IR: " << phaseTimings.codeEmissionTime << " ms\n";
+        timingOutput << "  Time to optimize IR: " << phaseTimings.irOptimizationTime << " ms\n";
+        timingOutput << "  Nodes eliminated by model optimizer: " << compiler.GetNumNodesEliminated() << "\n";
+    }
 
     if (compileArguments.outputCompiledMap)
     {
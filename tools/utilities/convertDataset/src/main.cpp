@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (convertDataset)
+//  Authors:  Chris Lovett
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+// utilities
+#include "CommandLineParser.h"
+#include "Exception.h"
+#include "Files.h"
+#include "MillisecondTimer.h"
+
+// data
+#include "MappedDataset.h"
+
+// common
+#include "DataLoadArguments.h"
+#include "DataLoaders.h"
+
+// stl
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        ParsedConvertDatasetArguments convertDatasetArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(convertDatasetArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+        if (dataLoadArguments.isBinaryDataset)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, dataLoadArguments.inputDataFilename + " is already a binary dataset");
+        }
+
+        // stream the text dataset into the binary file, one example at a time
+        utilities::MillisecondTimer timer;
+        auto inputStream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
+        auto exampleIterator = common::GetAutoSupervisedExampleIterator(inputStream);
+        std::ofstream outputStream(convertDatasetArguments.outputFilename, std::ios::binary);
+        if (!outputStream.is_open())
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Can't open " + convertDatasetArguments.outputFilename);
+        }
+        auto numExamples = data::WriteBinaryDataset(exampleIterator, outputStream);
+        outputStream.close();
+
+        // read the file back, to check it and report its size
+        data::MappedDataset dataset(convertDatasetArguments.outputFilename);
+        std::cout << "Converted " << numExamples << " examples in " << timer.Elapsed() << " ms" << std::endl;
+        std::cout << "Features: " << dataset.NumFeatures() << ", nonzero entries: " << dataset.NumEntries() << std::endl;
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -160,6 +160,48 @@ void WriteRegionStatistics(model::IRCompiledMap& map, ProfileOutputFormat format
     WriteRegionStatistics(regions, format, out);
 }
 
+void WriteCompileTimings(const model::MapCompilerPhaseTimings& phaseTimings, double jitTime, ProfileOutputFormat format, std::ostream& out)
+{
+    if (format == ProfileOutputFormat::text)
+    {
+        out << "\nCompile statistics" << std::endl;
+        out << "Refine time: " << phaseTimings.refineTime << " ms" << std::endl;
+        out << "Model optimization time: " << phaseTimings.modelOptimizationTime << " ms" << std::endl;
+        out << "IR emission time: " << phaseTimings.codeEmissionTime << " ms" << std::endl;
+        out << "IR optimization time: " << phaseTimings.irOptimizationTime << " ms" << std::endl;
+        out << "Code generation time: " << jitTime << " ms" << std::endl;
+    }
+    else // json
+    {
+        out << "\"compile_statistics\": {\n";
+        out << "  \"refine_time\": " << phaseTimings.refineTime << ",\n";
+        out << "  \"model_optimization_time\": " << phaseTimings.modelOptimizationTime << ",\n";
+        out << "  \"ir_emission_time\": " << phaseTimings.codeEmissionTime << ",\n";
+        out << "  \"ir_optimization_time\": " << phaseTimings.irOptimizationTime << ",\n";
+        out << "  \"code_generation_time\": " << jitTime << "\n";
+        out << "}\n";
+    }
+}
+
+void WriteTieredCompilationTimings(const model::TieredCompilationTimings& timings, ProfileOutputFormat format, std::ostream& out)
+{
+    if (format == ProfileOutputFormat::text)
+    {
+        out << "\nTiered compilation statistics" << std::endl;
+        out << "Unoptimized tier time: " << timings.unoptimizedTierTime << " ms" << std::endl;
+        out << "Optimized tier time: " << timings.optimizedTierTime << " ms" << std::endl;
+        out << "Swap time: " << timings.swapTime << " ms" << std::endl;
+    }
+    else // json
+    {
+        out << "\"tiered_compilation_statistics\": {\n";
+        out << "  \"unoptimized_tier_time\": " << timings.unoptimizedTierTime << ",\n";
+        out << "  \"optimized_tier_time\": " << timings.optimizedTierTime << ",\n";
+        out << "  \"swap_time\": " << timings.swapTime << "\n";
+        out << "}\n";
+    }
+}
+
 void WriteTimingDetail(std::ostream& timingOutputStream, ProfileOutputFormat format, const std::vector<std::vector<double>>& nodeTimings)
 {
     std::string beginArray = "";
@@ -241,6 +283,9 @@ void TimeModel(model::Map& map, const std::vector<InputType>& input, const Profi
 
     std::cout << "Compiling model" << std::endl;
     auto compiledMap = compiler.Compile(map);
+    utilities::MillisecondTimer jitTimer;
+    compiledMap.FinishJitting();
+    double jitTime = static_cast<double>(jitTimer.Elapsed());
 
     // Warm up the system by evaluating the model some number of times
     WarmUpModel<InputType, OutputType>(compiledMap, input, profileArguments.numBurnInIterations, false);
@@ -258,13 +303,24 @@ void TimeModel(model::Map& map, const std::vector<InputType>& input, const Profi
         outputStream << "Num iterations: " << profileArguments.numIterations << std::endl;
         outputStream << "Total time: " << totalTime << " ms" << std::endl;
         outputStream << "Average time: " << totalTime / profileArguments.numIterations << " ms" << std::endl;
+        WriteCompileTimings(compiler.GetPhaseTimings(), jitTime, profileArguments.outputFormat, outputStream);
+        if (settings.tieredCompilation)
+        {
+            WriteTieredCompilationTimings(compiledMap.GetTieredCompilationTimings(), profileArguments.outputFormat, outputStream);
+        }
     }
     else // json
     {
         outputStream << "{\n";
         outputStream << "\"total_time\": " << totalTime << ",\n";
         outputStream << "\"average_time\": " << totalTime / profileArguments.numIterations << ",\n";
-        outputStream << "\"count\": " << profileArguments.numIterations << "\n";
+        outputStream << "\"count\": " << profileArguments.numIterations << ",\n";
+        WriteCompileTimings(compiler.GetPhaseTimings(), jitTime, profileArguments.outputFormat, outputStream);
+        if (settings.tieredCompilation)
+        {
+            outputStream << ",\n";
+            WriteTieredCompilationTimings(compiledMap.GetTieredCompilationTimings(), profileArguments.outputFormat, outputStream);
+        }
         outputStream << "}\n";
     }
 }
@@ -300,6 +356,9 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
 
     std::cout << "Compiling model" << std::endl;
     auto compiledMap = compiler.Compile(map);
+    utilities::MillisecondTimer jitTimer;
+    compiledMap.FinishJitting();
+    double jitTime = static_cast<double>(jitTimer.Elapsed());
 
     auto numNodes = compiledMap.GetNumProfiledNodes();
     std::vector<std::vector<double>> nodeTimings(profileArguments.numIterations); // per-node timing
@@ -344,6 +403,7 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteNodeStatistics(compiledMap, format, profileOutputStream);
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         WriteModelStatistics(compiledMap, format, profileOutputStream);
+        WriteCompileTimings(compiler.GetPhaseTimings(), jitTime, format, profileOutputStream);
     }
     else
     {
@@ -358,6 +418,8 @@ void ProfileModel(model::Map& map, const ProfileArguments& profileArguments, con
         WriteRegionStatistics(compiledMap, format, profileOutputStream);
         profileOutputStream << ",\n";
         WriteModelStatistics(compiledMap, format, profileOutputStream);
+        profileOutputStream << ",\n";
+        WriteCompileTimings(compiler.GetPhaseTimings(), jitTime, format, profileOutputStream);
         profileOutputStream << "}\n";
     }
 }